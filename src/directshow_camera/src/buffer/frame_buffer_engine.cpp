@@ -0,0 +1,552 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "buffer/frame_buffer_engine.h"
+
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <utility>
+
+namespace DirectShowCamera
+{
+#pragma region Constructor and Destructor
+
+    FrameBufferEngine::FrameBufferEngine(const FrameBufferMode mode)
+    {
+        setMode(mode);
+    }
+
+    void FrameBufferEngine::setMode(const FrameBufferMode mode)
+    {
+        std::lock_guard<std::mutex> consumerLock(m_consumerMutex);
+        std::lock_guard<std::mutex> bufferLock(m_bufferMutex);
+
+        m_mode = mode;
+
+        // Discard all frames
+        m_tripleBuffer.Reset();
+        m_ringBuffer.Reset();
+        m_leaseManager.Reset();
+        m_mutexBuffer.reset();
+        if (m_mode == FrameBufferMode::Mutex)
+        {
+            // Allocate buffer, all bytes are set as 0 so a read before the first frame returns a black frame
+            const int bufferSize = m_bufferSize.load();
+            m_mutexBuffer = FramePool::Allocate(bufferSize);
+            if (m_mutexBuffer) memset(m_mutexBuffer.get(), 0, bufferSize);
+            m_allocations++;
+        }
+    }
+
+    FrameBufferMode FrameBufferEngine::getMode() const
+    {
+        return m_mode;
+    }
+
+#pragma endregion Constructor and Destructor
+
+#pragma region Buffer Size
+
+    void FrameBufferEngine::setBufferSize(const int numOfBytes)
+    {
+        if (m_mode == FrameBufferMode::Mutex)
+        {
+            // Lock buffer
+            LockBufferMutex(m_producerContention, m_producerWaitTime);
+
+            // Reallocate buffer, all bytes are set as 0
+            m_bufferSize.store(numOfBytes);
+            m_mutexBuffer.reset();
+            m_mutexBuffer = FramePool::Allocate(numOfBytes);
+            if (m_mutexBuffer) memset(m_mutexBuffer.get(), 0, numOfBytes);
+            m_allocations++;
+
+            // Release lock
+            m_bufferMutex.unlock();
+        }
+        else
+        {
+            // Triple buffer and ring buffer slots are reallocated lazily. Frames in the old size will be ignored by the consumer.
+            m_bufferSize.store(numOfBytes);
+        }
+    }
+
+    int FrameBufferEngine::getBufferSize() const
+    {
+        return m_bufferSize.load();
+    }
+
+#pragma endregion Buffer Size
+
+#pragma region Ring Buffer
+
+    void FrameBufferEngine::setRingBufferCapacity(const int capacity)
+    {
+        std::lock_guard<std::mutex> lock(m_consumerMutex);
+        m_ringBuffer.setCapacity(capacity);
+    }
+
+    int FrameBufferEngine::getRingBufferCapacity() const
+    {
+        return m_ringBuffer.getCapacity();
+    }
+
+    void FrameBufferEngine::setOverflowPolicy(const FrameOverflowPolicy overflowPolicy)
+    {
+        m_ringBuffer.setOverflowPolicy(overflowPolicy);
+    }
+
+    FrameOverflowPolicy FrameBufferEngine::getOverflowPolicy() const
+    {
+        return m_ringBuffer.getOverflowPolicy();
+    }
+
+    int FrameBufferEngine::getNumOfQueuedFrames() const
+    {
+        if (m_mode == FrameBufferMode::Ring)
+        {
+            return m_ringBuffer.getNumOfFrames();
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+#pragma endregion Ring Buffer
+
+#pragma region Frame Lease
+
+    void FrameBufferEngine::setMaxOutstandingLeases(const int maxOutstandingLeases)
+    {
+        m_leaseManager.setMaxOutstandingLeases(maxOutstandingLeases);
+    }
+
+    int FrameBufferEngine::getMaxOutstandingLeases() const
+    {
+        return m_leaseManager.getMaxOutstandingLeases();
+    }
+
+    int FrameBufferEngine::getNumOfOutstandingLeases() const
+    {
+        return m_leaseManager.getNumOfOutstandingLeases();
+    }
+
+#pragma endregion Frame Lease
+
+#pragma region Producer
+
+    unsigned char* FrameBufferEngine::BeginWrite(const int numOfBytes)
+    {
+        // Check
+        if (numOfBytes <= 0 || numOfBytes != m_bufferSize.load()) return nullptr;
+
+        if (m_mode == FrameBufferMode::Mutex)
+        {
+            // Keep locked until EndWrite()
+            LockBufferMutex(m_producerContention, m_producerWaitTime);
+            return m_mutexBuffer.get();
+        }
+        else if (m_mode == FrameBufferMode::Ring)
+        {
+            // Return nullptr if the frame is dropped
+            return m_ringBuffer.BeginWrite(numOfBytes);
+        }
+        else if (m_mode == FrameBufferMode::Lease)
+        {
+            // Producer frames are published by WriteLease()
+            return nullptr;
+        }
+        else
+        {
+            if (m_tripleBuffer.getWriteBufferCapacity() != numOfBytes) m_allocations++;
+            return m_tripleBuffer.getWriteBuffer(numOfBytes);
+        }
+    }
+
+    unsigned long FrameBufferEngine::EndWrite(const FrameTimestamp timestamp)
+    {
+        return EndWrite(NextFrameIndex(), timestamp);
+    }
+
+    unsigned long FrameBufferEngine::EndWrite(const unsigned long frameIndex, const FrameTimestamp timestamp)
+    {
+        const FrameTimestamp frameTimestamp = StampArrivalTime(timestamp);
+
+        if (m_mode == FrameBufferMode::Mutex)
+        {
+            m_mutexTimestamp = frameTimestamp;
+            m_frameIndex.store(frameIndex, std::memory_order_release);
+            m_bufferMutex.unlock();
+        }
+        else if (m_mode == FrameBufferMode::Ring)
+        {
+            m_ringBuffer.EndWrite(frameIndex, frameTimestamp);
+            m_frameIndex.store(frameIndex, std::memory_order_release);
+        }
+        else
+        {
+            m_tripleBuffer.Publish(frameIndex, frameTimestamp);
+            m_frameIndex.store(frameIndex, std::memory_order_release);
+        }
+
+        m_produced++;
+        NotifyFrameArrived();
+
+        return frameIndex;
+    }
+
+    bool FrameBufferEngine::Write(const unsigned char* data, const int numOfBytes, const FrameTimestamp timestamp)
+    {
+        // Check
+        if (data == nullptr) return false;
+
+        if (m_mode == FrameBufferMode::Lease)
+        {
+            // The data is only valid in this call, lease a copy of it
+            if (numOfBytes <= 0 || numOfBytes != m_bufferSize.load()) return false;
+            std::shared_ptr<unsigned char[]> copiedData(new unsigned char[numOfBytes]);
+            memcpy(copiedData.get(), data, numOfBytes);
+            m_allocations++;
+
+            return WriteLease(copiedData.get(), numOfBytes, nullptr, [copiedData]() {}, timestamp);
+        }
+
+        unsigned char* buffer = BeginWrite(numOfBytes);
+        if (buffer == nullptr) return false;
+
+        // Copy to buffer
+        memcpy(buffer, data, numOfBytes);
+
+        // Publish
+        EndWrite(timestamp);
+
+        return true;
+    }
+
+    bool FrameBufferEngine::WriteLease(
+        const unsigned char* data,
+        const int numOfBytes,
+        const FrameLeaseManager::LeaseFunc& holdFunc,
+        FrameLeaseManager::LeaseFunc releaseFunc,
+        const FrameTimestamp timestamp
+    )
+    {
+        return WriteLease(data, numOfBytes, NextFrameIndex(), holdFunc, std::move(releaseFunc), timestamp);
+    }
+
+    bool FrameBufferEngine::WriteLease(
+        const unsigned char* data,
+        const int numOfBytes,
+        const unsigned long frameIndex,
+        const FrameLeaseManager::LeaseFunc& holdFunc,
+        FrameLeaseManager::LeaseFunc releaseFunc,
+        const FrameTimestamp timestamp
+    )
+    {
+        // Check
+        if (m_mode != FrameBufferMode::Lease) return false;
+        if (data == nullptr || numOfBytes <= 0 || numOfBytes != m_bufferSize.load()) return false;
+
+        // Hold and publish
+        if (!m_leaseManager.Publish(data, numOfBytes, frameIndex, StampArrivalTime(timestamp), holdFunc, std::move(releaseFunc))) return false;
+        m_frameIndex.store(frameIndex, std::memory_order_release);
+
+        m_produced++;
+        NotifyFrameArrived();
+
+        return true;
+    }
+
+#pragma endregion Producer
+
+#pragma region Consumer
+
+    bool FrameBufferEngine::Read(
+        unsigned char* frame,
+        int& numOfBytes,
+        unsigned long& frameIndex,
+        FrameTimestamp* timestamp
+    )
+    {
+        // Check
+        if (frame == nullptr) return false;
+
+        FrameTimestamp frameTimestamp;
+
+        if (m_mode == FrameBufferMode::Mutex)
+        {
+            // Lock buffer
+            LockBufferMutex(m_consumerContention, m_consumerWaitTime);
+
+            // Copy
+            numOfBytes = m_bufferSize.load();
+            memcpy(frame, m_mutexBuffer.get(), numOfBytes);
+            frameIndex = m_frameIndex.load(std::memory_order_relaxed);
+            frameTimestamp = m_mutexTimestamp;
+            m_copies++;
+
+            // Release lock
+            m_bufferMutex.unlock();
+        }
+        else if (m_mode == FrameBufferMode::Ring)
+        {
+            std::lock_guard<std::mutex> lock(m_consumerMutex);
+
+            // Frames in the old size can't be returned
+            numOfBytes = m_bufferSize.load();
+            m_ringBuffer.DiscardFramesNotInSize(numOfBytes);
+
+            // Copy the oldest frame
+            if (!m_ringBuffer.Pop(frame, numOfBytes, frameIndex, frameTimestamp)) return false;
+            m_copies++;
+        }
+        else if (m_mode == FrameBufferMode::Lease)
+        {
+            std::lock_guard<std::mutex> lock(m_consumerMutex);
+
+            // Copy from the newest producer frame. The lease is released after copying.
+            FrameLease lease;
+            numOfBytes = m_bufferSize.load();
+            if (m_leaseManager.Acquire(lease) && lease.getNumOfBytes() == numOfBytes)
+            {
+                memcpy(frame, lease.getData(), numOfBytes);
+                frameIndex = lease.getFrameIndex();
+                frameTimestamp = lease.getTimestamp();
+                m_copies++;
+            }
+            else
+            {
+                // No frame in the current size has been published yet
+                memset(frame, 0, numOfBytes);
+                frameIndex = m_frameIndex.load(std::memory_order_acquire);
+            }
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_consumerMutex);
+
+            // Get the newest frame
+            const bool isNewFrame = m_tripleBuffer.Acquire();
+
+            // The newest frame has been handed over by Exchange()
+            if (!isNewFrame && m_tripleBuffer.isReadBufferExchanged()) return false;
+
+            int slotNumOfBytes = 0;
+            unsigned long slotFrameIndex = 0;
+            FrameTimestamp slotTimestamp;
+            const unsigned char* slot = m_tripleBuffer.getReadBuffer(slotNumOfBytes, slotFrameIndex, slotTimestamp);
+
+            // Copy
+            numOfBytes = m_bufferSize.load();
+            if (slot != nullptr && slotNumOfBytes == numOfBytes)
+            {
+                memcpy(frame, slot, numOfBytes);
+                frameIndex = slotFrameIndex;
+                frameTimestamp = slotTimestamp;
+                m_copies++;
+            }
+            else
+            {
+                // No frame in the current size has been published yet
+                memset(frame, 0, numOfBytes);
+                frameIndex = m_frameIndex.load(std::memory_order_acquire);
+            }
+        }
+
+        if (timestamp != nullptr) *timestamp = frameTimestamp;
+        m_consumed++;
+
+        return true;
+    }
+
+    bool FrameBufferEngine::Exchange(
+        FrameBuffer& frame,
+        int& numOfBytes,
+        unsigned long& frameIndex,
+        FrameTimestamp* timestamp
+    )
+    {
+        // Check
+        if (m_mode == FrameBufferMode::Mutex || m_mode == FrameBufferMode::Lease) return false;
+
+        std::lock_guard<std::mutex> lock(m_consumerMutex);
+
+        FrameTimestamp frameTimestamp;
+        if (m_mode == FrameBufferMode::Ring)
+        {
+            // Hand the oldest frame over
+            m_ringBuffer.DiscardFramesNotInSize(m_bufferSize.load());
+            if (!m_ringBuffer.Exchange(frame, numOfBytes, frameIndex, frameTimestamp)) return false;
+
+            if (timestamp != nullptr) *timestamp = frameTimestamp;
+            m_consumed++;
+            m_exchanges++;
+
+            return true;
+        }
+
+        // Get the newest frame
+        m_tripleBuffer.Acquire();
+
+        // Check size
+        int slotNumOfBytes = 0;
+        unsigned long slotFrameIndex = 0;
+        m_tripleBuffer.getReadBuffer(slotNumOfBytes, slotFrameIndex, frameTimestamp);
+        if (slotNumOfBytes != m_bufferSize.load()) return false;
+
+        // Exchange
+        if (!m_tripleBuffer.ExchangeReadBuffer(frame, numOfBytes, frameIndex, frameTimestamp)) return false;
+
+        if (timestamp != nullptr) *timestamp = frameTimestamp;
+        m_consumed++;
+        m_exchanges++;
+
+        return true;
+    }
+
+    bool FrameBufferEngine::Lease(FrameLease& lease)
+    {
+        // Check
+        if (m_mode != FrameBufferMode::Lease) return false;
+
+        std::lock_guard<std::mutex> lock(m_consumerMutex);
+
+        // Lease the newest frame
+        FrameLease newLease;
+        if (!m_leaseManager.Acquire(newLease)) return false;
+
+        // Frames in the old size can't be returned
+        if (newLease.getNumOfBytes() != m_bufferSize.load()) return false;
+
+        lease = std::move(newLease);
+        m_consumed++;
+        m_leases++;
+
+        return true;
+    }
+
+    unsigned long FrameBufferEngine::getLastFrameIndex() const
+    {
+        return m_frameIndex.load(std::memory_order_acquire);
+    }
+
+    bool FrameBufferEngine::WaitForFrame(
+        const unsigned long afterFrameIndex,
+        const std::chrono::steady_clock::time_point deadline
+    )
+    {
+        // The producer only takes the lock to notify if somebody is waiting
+        m_numOfWaiters.fetch_add(1, std::memory_order_seq_cst);
+
+        bool hasNewFrame = false;
+        {
+            std::unique_lock<std::mutex> lock(m_waitMutex);
+            hasNewFrame = m_frameArrived.wait_until(
+                lock,
+                deadline,
+                [this, afterFrameIndex]()
+                {
+                    return m_frameIndex.load(std::memory_order_seq_cst) != afterFrameIndex;
+                }
+            );
+        }
+
+        m_numOfWaiters.fetch_sub(1, std::memory_order_relaxed);
+
+        return hasNewFrame;
+    }
+
+#pragma endregion Consumer
+
+#pragma region Statistics
+
+    FrameBufferStatistics FrameBufferEngine::getStatistics() const
+    {
+        FrameBufferStatistics statistics;
+        statistics.Produced = m_produced.load();
+        statistics.Consumed = m_consumed.load();
+        statistics.ProducerContention = m_producerContention.load() + m_ringBuffer.getNumOfBlocks();
+        statistics.ConsumerContention = m_consumerContention.load();
+        statistics.ProducerWaitTime = m_producerWaitTime.load() + m_ringBuffer.getBlockedTime();
+        statistics.ConsumerWaitTime = m_consumerWaitTime.load();
+        statistics.Allocations = m_allocations.load() + m_ringBuffer.getNumOfAllocations();
+        statistics.Copies = m_copies.load();
+        statistics.Exchanges = m_exchanges.load();
+        statistics.Dropped = m_ringBuffer.getNumOfDroppedFrames() + m_leaseManager.getNumOfDroppedFrames();
+        statistics.Leases = m_leases.load();
+        return statistics;
+    }
+
+    void FrameBufferEngine::ResetStatistics()
+    {
+        m_produced = 0;
+        m_consumed = 0;
+        m_producerContention = 0;
+        m_consumerContention = 0;
+        m_producerWaitTime = 0;
+        m_consumerWaitTime = 0;
+        m_allocations = 0;
+        m_copies = 0;
+        m_exchanges = 0;
+        m_leases = 0;
+        m_ringBuffer.ResetStatistics();
+        m_leaseManager.ResetStatistics();
+    }
+
+#pragma endregion Statistics
+
+    void FrameBufferEngine::LockBufferMutex(
+        std::atomic<unsigned long long>& contention,
+        std::atomic<unsigned long long>& waitTime
+    )
+    {
+        if (!m_bufferMutex.try_lock())
+        {
+            // Locked by the other side, measure how long we wait
+            const auto startTime = std::chrono::steady_clock::now();
+            m_bufferMutex.lock();
+            const auto endTime = std::chrono::steady_clock::now();
+
+            contention++;
+            waitTime += std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+        }
+    }
+
+    unsigned long FrameBufferEngine::NextFrameIndex() const
+    {
+        const unsigned long frameIndex = m_frameIndex.load(std::memory_order_relaxed);
+        if (frameIndex >= ULONG_MAX - 1)
+        {
+            return 1;
+        }
+        else
+        {
+            return frameIndex + 1;
+        }
+    }
+
+    void FrameBufferEngine::NotifyFrameArrived()
+    {
+        // Pairs with the waiter which registers itself before checking the frame index, so either the waiter sees the new index or we see the waiter.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_numOfWaiters.load(std::memory_order_relaxed) > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_waitMutex);
+            }
+            m_frameArrived.notify_all();
+        }
+    }
+
+    FrameTimestamp FrameBufferEngine::StampArrivalTime(const FrameTimestamp timestamp)
+    {
+        FrameTimestamp result = timestamp;
+        if (result.ArrivalTime == 0) result.ArrivalTime = FrameTimestamp::Now();
+        return result;
+    }
+}
@@ -0,0 +1,438 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__BUFFER__FRAME_BUFFER_ENGINE_H
+#define DIRECTSHOW_CAMERA__BUFFER__FRAME_BUFFER_ENGINE_H
+
+//************Content************
+
+#include "buffer/frame_pool.h"
+#include "buffer/frame_timestamp.h"
+#include "buffer/triple_frame_buffer.h"
+#include "buffer/frame_ring_buffer.h"
+#include "buffer/frame_lease_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Frame buffer mode
+     */
+    enum class FrameBufferMode
+    {
+        /**
+         * @brief A single buffer protected by a mutex. The producer and the consumer block each other while copying.
+        */
+        Mutex,
+
+        /**
+         * @brief A lock-free triple buffer. The consumer always gets the newest completed frame without blocking the producer.
+        */
+        TripleBuffer,
+
+        /**
+         * @brief A N-slot queue. The consumer gets every frame in order. Frames are dropped according to the FrameOverflowPolicy when the queue is full.
+        */
+        Ring,
+
+        /**
+         * @brief Hold the producer frame (e.g. IMediaSample) instead of copying it. The consumer reads the producer memory through FrameLease.
+         *        Frames are dropped when too many frames are held.
+        */
+        Lease
+    };
+
+    /**
+     * @brief Frame buffer statistics
+     */
+    struct FrameBufferStatistics
+    {
+        /**
+         * @brief Number of frames written by the producer
+        */
+        unsigned long long Produced = 0;
+
+        /**
+         * @brief Number of frames read by the consumer
+        */
+        unsigned long long Consumed = 0;
+
+        /**
+         * @brief Number of times the producer had to wait for the consumer
+        */
+        unsigned long long ProducerContention = 0;
+
+        /**
+         * @brief Number of times the consumer had to wait for the producer
+        */
+        unsigned long long ConsumerContention = 0;
+
+        /**
+         * @brief Total time in nanosecond the producer spent on waiting for the consumer
+        */
+        unsigned long long ProducerWaitTime = 0;
+
+        /**
+         * @brief Total time in nanosecond the consumer spent on waiting for the producer
+        */
+        unsigned long long ConsumerWaitTime = 0;
+
+        /**
+         * @brief Number of frame buffers allocated by the frame buffer
+        */
+        unsigned long long Allocations = 0;
+
+        /**
+         * @brief Number of frames copied to the consumer
+        */
+        unsigned long long Copies = 0;
+
+        /**
+         * @brief Number of frames handed over to the consumer without copying
+        */
+        unsigned long long Exchanges = 0;
+
+        /**
+         * @brief Number of frames dropped before the consumer read them. Only counted in FrameBufferMode::Ring and FrameBufferMode::Lease.
+        */
+        unsigned long long Dropped = 0;
+
+        /**
+         * @brief Number of leases handed out to the consumer
+        */
+        unsigned long long Leases = 0;
+    };
+
+    /**
+     * @brief A portable frame buffer which hands frames from a producer (e.g. DirectShow streaming thread) to a consumer.
+     *
+     * It doesn't depend on DirectShow so that it can be tested and benchmarked on its own.
+     */
+    class FrameBufferEngine
+    {
+    public:
+
+#pragma region Constructor and Destructor
+
+        /**
+         * @brief Constructor
+         * @param[in] mode (Optional) Buffer mode. Default as FrameBufferMode::TripleBuffer
+        */
+        FrameBufferEngine(const FrameBufferMode mode = FrameBufferMode::TripleBuffer);
+
+        /**
+         * @brief Set the buffer mode. All frames in the buffer will be discarded. It should not be called while streaming.
+         * @param[in] mode Buffer mode
+        */
+        void setMode(const FrameBufferMode mode);
+
+        /**
+         * @brief Get the buffer mode
+         * @return Return the buffer mode
+        */
+        FrameBufferMode getMode() const;
+
+#pragma endregion Constructor and Destructor
+
+#pragma region Buffer Size
+
+        /**
+         * @brief Set the buffer size.
+         * @param[in] numOfBytes Number of bytes of a frame
+        */
+        void setBufferSize(const int numOfBytes);
+
+        /**
+         * @brief Get the buffer size.
+         * @return The buffer size
+        */
+        int getBufferSize() const;
+
+#pragma endregion Buffer Size
+
+#pragma region Ring Buffer
+
+        /**
+         * @brief Set the maximum number of queued frames in FrameBufferMode::Ring. All queued frames will be discarded. It should not be called while streaming.
+         * @param[in] capacity Maximum number of queued frames. Default as 8
+        */
+        void setRingBufferCapacity(const int capacity);
+
+        /**
+         * @brief Get the maximum number of queued frames in FrameBufferMode::Ring
+         * @return Return the maximum number of queued frames
+        */
+        int getRingBufferCapacity() const;
+
+        /**
+         * @brief Set what to do when a frame arrives and the ring buffer is full.
+         * @param[in] overflowPolicy Overflow policy. Default as FrameOverflowPolicy::DropOldest
+        */
+        void setOverflowPolicy(const FrameOverflowPolicy overflowPolicy);
+
+        /**
+         * @brief Get the overflow policy of the ring buffer
+         * @return Return the overflow policy
+        */
+        FrameOverflowPolicy getOverflowPolicy() const;
+
+        /**
+         * @brief Get the number of frames queued in FrameBufferMode::Ring
+         * @return Return the number of queued frames. Return 0 in other modes.
+        */
+        int getNumOfQueuedFrames() const;
+
+#pragma endregion Ring Buffer
+
+#pragma region Frame Lease
+
+        /**
+         * @brief Set the maximum number of producer frames held in FrameBufferMode::Lease, including the newest frame kept by the frame buffer.
+         *        It should be less than the number of producer buffers, otherwise the producer may stall.
+         * @param[in] maxOutstandingLeases Maximum number of held frames. Default as 2
+        */
+        void setMaxOutstandingLeases(const int maxOutstandingLeases);
+
+        /**
+         * @brief Get the maximum number of producer frames held in FrameBufferMode::Lease
+         * @return Return the maximum number of held frames
+        */
+        int getMaxOutstandingLeases() const;
+
+        /**
+         * @brief Get the number of producer frames held in FrameBufferMode::Lease
+         * @return Return the number of held frames
+        */
+        int getNumOfOutstandingLeases() const;
+
+#pragma endregion Frame Lease
+
+#pragma region Producer
+
+        /**
+         * @brief Begin to write a frame. Call EndWrite() after the frame has been written into the returned pointer.
+         * @param[in] numOfBytes Number of bytes to be written. It should be equal to the buffer size.
+         * @return Return the buffer to be written. Return nullptr if numOfBytes doesn't match the buffer size or the frame is dropped by the ring buffer.
+        */
+        unsigned char* BeginWrite(const int numOfBytes);
+
+        /**
+         * @brief Publish the frame written after BeginWrite().
+         * @param[in] timestamp (Optional) Capture timestamps of the written frame. If the arrival time is 0, it is set as the current time.
+         * @return Return the frame index of the published frame.
+        */
+        unsigned long EndWrite(const FrameTimestamp timestamp = FrameTimestamp());
+
+        /**
+         * @brief Publish the frame written after BeginWrite() with a frame index given by the producer.
+         * @param[in] frameIndex Frame index of the written frame.
+         * @param[in] timestamp (Optional) Capture timestamps of the written frame. If the arrival time is 0, it is set as the current time.
+         * @return Return the frame index of the published frame.
+        */
+        unsigned long EndWrite(const unsigned long frameIndex, const FrameTimestamp timestamp = FrameTimestamp());
+
+        /**
+         * @brief Copy a frame into the buffer.
+         * @param[in] data Frame in bytes
+         * @param[in] numOfBytes Number of bytes of the frame. It should be equal to the buffer size.
+         * @param[in] timestamp (Optional) Capture timestamps of the frame. If the arrival time is 0, it is set as the current time.
+         * @return Return true if the frame is written. Return false if the size doesn't match or the frame is dropped.
+        */
+        bool Write(const unsigned char* data, const int numOfBytes, const FrameTimestamp timestamp = FrameTimestamp());
+
+        /**
+         * @brief Publish a producer frame without copying in FrameBufferMode::Lease.
+         * @param[in] data Frame in bytes. It must stay valid until releaseFunc is called.
+         * @param[in] numOfBytes Number of bytes of the frame. It should be equal to the buffer size.
+         * @param[in] holdFunc Function to hold the frame, e.g. IMediaSample::AddRef. It is only called if the frame is accepted.
+         * @param[in] releaseFunc Function to release the frame, e.g. IMediaSample::Release.
+         * @param[in] timestamp (Optional) Capture timestamps of the frame. If the arrival time is 0, it is set as the current time.
+         * @return Return true if the frame is published. Return false if it is not in FrameBufferMode::Lease, the size doesn't match or the frame is dropped.
+        */
+        bool WriteLease(
+            const unsigned char* data,
+            const int numOfBytes,
+            const FrameLeaseManager::LeaseFunc& holdFunc,
+            FrameLeaseManager::LeaseFunc releaseFunc,
+            const FrameTimestamp timestamp = FrameTimestamp()
+        );
+
+        /**
+         * @brief Publish a producer frame without copying in FrameBufferMode::Lease with a frame index given by the producer.
+         * @param[in] data Frame in bytes. It must stay valid until releaseFunc is called.
+         * @param[in] numOfBytes Number of bytes of the frame. It should be equal to the buffer size.
+         * @param[in] frameIndex Frame index of the frame.
+         * @param[in] holdFunc Function to hold the frame. It is only called if the frame is accepted.
+         * @param[in] releaseFunc Function to release the frame.
+         * @param[in] timestamp (Optional) Capture timestamps of the frame. If the arrival time is 0, it is set as the current time.
+         * @return Return true if the frame is published. Return false if it is not in FrameBufferMode::Lease, the size doesn't match or the frame is dropped.
+        */
+        bool WriteLease(
+            const unsigned char* data,
+            const int numOfBytes,
+            const unsigned long frameIndex,
+            const FrameLeaseManager::LeaseFunc& holdFunc,
+            FrameLeaseManager::LeaseFunc releaseFunc,
+            const FrameTimestamp timestamp = FrameTimestamp()
+        );
+
+#pragma endregion Producer
+
+#pragma region Consumer
+
+        /**
+         * @brief Copy the newest frame. In FrameBufferMode::Ring, copy the oldest queued frame and remove it from the queue. In FrameBufferMode::Lease, copy from the leased producer frame.
+         * @param[out] frame Frame in bytes. It should be at least getBufferSize() bytes.
+         * @param[out] numOfBytes Number of bytes of the frame.
+         * @param[out] frameIndex Frame index.
+         * @param[out] timestamp (Optional) Capture timestamps. Default as nullptr
+         * @return Return true if the frame is copied. Return false if the newest frame has been handed over by Exchange() or no frame is queued in FrameBufferMode::Ring.
+        */
+        bool Read(
+            unsigned char* frame,
+            int& numOfBytes,
+            unsigned long& frameIndex,
+            FrameTimestamp* timestamp = nullptr
+        );
+
+        /**
+         * @brief   Hand the newest frame over to the consumer by exchanging buffers, no copy is made.
+         *          The consumer buffer will be reused by the producer. In FrameBufferMode::Ring, the oldest queued frame is handed over.
+         *          Not supported in FrameBufferMode::Mutex and FrameBufferMode::Lease.
+         * @param[in,out] frame In: the consumer buffer, can be nullptr. Out: the newest frame.
+         * @param[in,out] numOfBytes In: size of the consumer buffer. Out: Number of bytes of the frame.
+         * @param[out] frameIndex Frame index.
+         * @param[out] timestamp (Optional) Capture timestamps. Default as nullptr
+         * @return Return false if the buffer can't be exchanged (e.g. mutex mode, or the newest frame has already been handed over). In this case, nothing is changed.
+        */
+        bool Exchange(
+            FrameBuffer& frame,
+            int& numOfBytes,
+            unsigned long& frameIndex,
+            FrameTimestamp* timestamp = nullptr
+        );
+
+        /**
+         * @brief Lease the newest frame in FrameBufferMode::Lease. No copy is made.
+         * @param[out] lease Lease of the newest frame. The previous frame in the lease is released.
+         * @return Return false if it is not in FrameBufferMode::Lease or no frame in the buffer size has been published.
+        */
+        bool Lease(FrameLease& lease);
+
+        /**
+         * @brief Get the index of the newest published frame.
+         * @return Return the index of the newest published frame.
+        */
+        unsigned long getLastFrameIndex() const;
+
+        /**
+         * @brief Block until a frame newer than afterFrameIndex is published or the deadline is reached. It wakes up as soon as the producer publishes.
+         * @param[in] afterFrameIndex Frame index which has been seen by the consumer, e.g. getLastFrameIndex().
+         * @param[in] deadline Time to give up waiting
+         * @return Return true if the newest published frame index is not afterFrameIndex. Return false if timeout.
+        */
+        bool WaitForFrame(
+            const unsigned long afterFrameIndex,
+            const std::chrono::steady_clock::time_point deadline
+        );
+
+#pragma endregion Consumer
+
+#pragma region Statistics
+
+        /**
+         * @brief Get the statistics
+         * @return Return the statistics
+        */
+        FrameBufferStatistics getStatistics() const;
+
+        /**
+         * @brief Reset the statistics
+        */
+        void ResetStatistics();
+
+#pragma endregion Statistics
+
+    private:
+
+        /**
+         * @brief Lock the mutex buffer and record the contention if it is locked by the other side.
+         * @param[in,out] contention Contention counter
+         * @param[in,out] waitTime Wait time counter in nanosecond
+        */
+        void LockBufferMutex(
+            std::atomic<unsigned long long>& contention,
+            std::atomic<unsigned long long>& waitTime
+        );
+
+        /**
+         * @brief Get the next frame index
+         * @return Return the next frame index
+        */
+        unsigned long NextFrameIndex() const;
+
+        /**
+         * @brief Set the arrival time as the current time if it is not given by the producer
+         * @param[in] timestamp Capture timestamps given by the producer
+         * @return Return the capture timestamps with the arrival time
+        */
+        static FrameTimestamp StampArrivalTime(const FrameTimestamp timestamp);
+
+        /**
+         * @brief Wake up the consumers blocked in WaitForFrame(). The lock is only taken if somebody is waiting.
+        */
+        void NotifyFrameArrived();
+
+    private:
+        FrameBufferMode m_mode = FrameBufferMode::TripleBuffer;
+        std::atomic<int> m_bufferSize = 0;
+
+        // Frame index of the newest published frame
+        std::atomic<unsigned long> m_frameIndex = 1;
+
+        // Mutex mode
+        std::mutex m_bufferMutex;
+        FrameBuffer m_mutexBuffer = nullptr;
+        FrameTimestamp m_mutexTimestamp;
+
+        // Triple buffer mode
+        TripleFrameBuffer m_tripleBuffer;
+        std::mutex m_consumerMutex; // Serialize consumers only. The producer never takes it.
+
+        // Ring mode
+        FrameRingBuffer m_ringBuffer;
+
+        // Lease mode
+        FrameLeaseManager m_leaseManager;
+
+        // Consumers blocked in WaitForFrame()
+        std::mutex m_waitMutex;
+        std::condition_variable m_frameArrived;
+        std::atomic<int> m_numOfWaiters = 0;
+
+        // Statistics
+        std::atomic<unsigned long long> m_produced = 0;
+        std::atomic<unsigned long long> m_consumed = 0;
+        std::atomic<unsigned long long> m_producerContention = 0;
+        std::atomic<unsigned long long> m_consumerContention = 0;
+        std::atomic<unsigned long long> m_producerWaitTime = 0;
+        std::atomic<unsigned long long> m_consumerWaitTime = 0;
+        std::atomic<unsigned long long> m_allocations = 0;
+        std::atomic<unsigned long long> m_copies = 0;
+        std::atomic<unsigned long long> m_exchanges = 0;
+        std::atomic<unsigned long long> m_leases = 0;
+    };
+}
+
+//*******************************
+
+#endif
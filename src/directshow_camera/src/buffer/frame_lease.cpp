@@ -0,0 +1,107 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "buffer/frame_lease.h"
+
+#include <utility>
+
+namespace DirectShowCamera
+{
+#pragma region Constructor and Destructor
+
+    FrameLease::FrameLease()
+    {
+    }
+
+    FrameLease::FrameLease(
+        const unsigned char* data,
+        const int numOfBytes,
+        const unsigned long frameIndex,
+        const FrameTimestamp timestamp,
+        std::shared_ptr<void> holder
+    ) :
+        m_data(data),
+        m_numOfBytes(numOfBytes),
+        m_frameIndex(frameIndex),
+        m_timestamp(timestamp),
+        m_holder(std::move(holder))
+    {
+    }
+
+    FrameLease::~FrameLease()
+    {
+        Release();
+    }
+
+    FrameLease::FrameLease(FrameLease&& other) noexcept :
+        m_data(other.m_data),
+        m_numOfBytes(other.m_numOfBytes),
+        m_frameIndex(other.m_frameIndex),
+        m_timestamp(other.m_timestamp),
+        m_holder(std::move(other.m_holder))
+    {
+        other.Release();
+    }
+
+    FrameLease& FrameLease::operator=(FrameLease&& other) noexcept
+    {
+        if (this != &other)
+        {
+            // Return the current frame first
+            Release();
+
+            m_data = other.m_data;
+            m_numOfBytes = other.m_numOfBytes;
+            m_frameIndex = other.m_frameIndex;
+            m_timestamp = other.m_timestamp;
+            m_holder = std::move(other.m_holder);
+
+            other.Release();
+        }
+
+        return *this;
+    }
+
+    void FrameLease::Release()
+    {
+        m_data = nullptr;
+        m_numOfBytes = 0;
+        m_frameIndex = 0;
+        m_timestamp = FrameTimestamp();
+        m_holder.reset();
+    }
+
+#pragma endregion Constructor and Destructor
+
+#pragma region Getter
+
+    bool FrameLease::isValid() const
+    {
+        return m_holder != nullptr && m_data != nullptr;
+    }
+
+    const unsigned char* FrameLease::getData() const
+    {
+        return m_data;
+    }
+
+    int FrameLease::getNumOfBytes() const
+    {
+        return m_numOfBytes;
+    }
+
+    unsigned long FrameLease::getFrameIndex() const
+    {
+        return m_frameIndex;
+    }
+
+    FrameTimestamp FrameLease::getTimestamp() const
+    {
+        return m_timestamp;
+    }
+
+#pragma endregion Getter
+}
@@ -0,0 +1,125 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__BUFFER__FRAME_LEASE_H
+#define DIRECTSHOW_CAMERA__BUFFER__FRAME_LEASE_H
+
+//************Content************
+
+#include "buffer/frame_timestamp.h"
+
+#include <memory>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief A read-only view of a frame owned by the producer (e.g. a DirectShow media sample).
+     *
+     * The frame is held until the lease is released or destroyed, so the data can be read without copying.
+     * Leases are move-only. Release them as soon as possible, the producer may run out of buffers while they are held.
+     */
+    class FrameLease
+    {
+    public:
+
+#pragma region Constructor and Destructor
+
+        /**
+         * @brief Constructor of an empty lease
+        */
+        FrameLease();
+
+        /**
+         * @brief Constructor
+         * @param[in] data Frame in bytes
+         * @param[in] numOfBytes Number of bytes of the frame
+         * @param[in] frameIndex Frame index
+         * @param[in] timestamp Capture timestamps
+         * @param[in] holder Holder of the frame. The frame is returned to the producer when the last holder is destroyed.
+        */
+        FrameLease(
+            const unsigned char* data,
+            const int numOfBytes,
+            const unsigned long frameIndex,
+            const FrameTimestamp timestamp,
+            std::shared_ptr<void> holder
+        );
+
+        /**
+         * @brief Destructor. The frame is returned to the producer.
+        */
+        ~FrameLease();
+
+        FrameLease(const FrameLease&) = delete;
+        FrameLease& operator=(const FrameLease&) = delete;
+
+        /**
+         * @brief Move constructor. The other lease will be empty.
+         * @param[in,out] other Lease to be moved
+        */
+        FrameLease(FrameLease&& other) noexcept;
+
+        /**
+         * @brief Move assignment. The current frame is released and the other lease will be empty.
+         * @param[in,out] other Lease to be moved
+         * @return Return this lease
+        */
+        FrameLease& operator=(FrameLease&& other) noexcept;
+
+        /**
+         * @brief Return the frame to the producer. The lease will be empty.
+        */
+        void Release();
+
+#pragma endregion Constructor and Destructor
+
+#pragma region Getter
+
+        /**
+         * @brief Return true if the lease holds a frame
+         * @return Return true if the lease holds a frame
+        */
+        bool isValid() const;
+
+        /**
+         * @brief Get the frame data. It is only valid while the lease is held.
+         * @return Return the frame in bytes. Return nullptr if the lease is empty.
+        */
+        const unsigned char* getData() const;
+
+        /**
+         * @brief Get the number of bytes of the frame
+         * @return Return the number of bytes. Return 0 if the lease is empty.
+        */
+        int getNumOfBytes() const;
+
+        /**
+         * @brief Get the frame index
+         * @return Return the frame index. Return 0 if the lease is empty.
+        */
+        unsigned long getFrameIndex() const;
+
+        /**
+         * @brief Get the capture timestamps of the frame
+         * @return Return the capture timestamps. Return the default timestamps if the lease is empty.
+        */
+        FrameTimestamp getTimestamp() const;
+
+#pragma endregion Getter
+
+    private:
+        const unsigned char* m_data = nullptr;
+        int m_numOfBytes = 0;
+        unsigned long m_frameIndex = 0;
+        FrameTimestamp m_timestamp;
+        std::shared_ptr<void> m_holder = nullptr;
+    };
+}
+
+//*******************************
+
+#endif
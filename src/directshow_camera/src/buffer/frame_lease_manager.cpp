@@ -0,0 +1,157 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "buffer/frame_lease_manager.h"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace DirectShowCamera
+{
+#pragma region Constructor and Destructor
+
+    FrameLeaseManager::FrameLeaseManager(const int maxOutstandingLeases)
+    {
+        m_numOfHeldFrames = std::make_shared<std::atomic<int>>(0);
+        setMaxOutstandingLeases(maxOutstandingLeases);
+    }
+
+    FrameLeaseManager::~FrameLeaseManager()
+    {
+        Reset();
+    }
+
+    void FrameLeaseManager::Reset()
+    {
+        std::shared_ptr<Holder> holder = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            holder.swap(m_holder);
+            m_data = nullptr;
+            m_numOfBytes = 0;
+            m_frameIndex = 0;
+            m_timestamp = FrameTimestamp();
+        }
+
+        // Release outside the lock
+        holder.reset();
+    }
+
+    FrameLeaseManager::Holder::~Holder()
+    {
+        if (ReleaseFunc) ReleaseFunc();
+        NumOfHeldFrames->fetch_sub(1);
+    }
+
+#pragma endregion Constructor and Destructor
+
+#pragma region Settings
+
+    void FrameLeaseManager::setMaxOutstandingLeases(const int maxOutstandingLeases)
+    {
+        // Check
+        if (maxOutstandingLeases <= 0) throw std::invalid_argument("Maximum number of outstanding leases(" + std::to_string(maxOutstandingLeases) + ") can't be <= 0.");
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxOutstandingLeases = maxOutstandingLeases;
+    }
+
+    int FrameLeaseManager::getMaxOutstandingLeases() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_maxOutstandingLeases;
+    }
+
+#pragma endregion Settings
+
+#pragma region Producer
+
+    bool FrameLeaseManager::Publish(
+        const unsigned char* data,
+        const int numOfBytes,
+        const unsigned long frameIndex,
+        const FrameTimestamp timestamp,
+        const LeaseFunc& holdFunc,
+        LeaseFunc releaseFunc
+    )
+    {
+        // Check
+        if (data == nullptr || numOfBytes <= 0) return false;
+
+        std::shared_ptr<Holder> previousHolder = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // The newest frame will be released by this frame if nobody leases it.
+            // Leases released concurrently only make the count smaller, so it never exceeds the cap.
+            int numOfHeldFrames = m_numOfHeldFrames->load();
+            if (m_holder != nullptr && m_holder.use_count() == 1) numOfHeldFrames--;
+            if (numOfHeldFrames >= m_maxOutstandingLeases)
+            {
+                m_dropped++;
+                return false;
+            }
+
+            // Hold
+            if (holdFunc) holdFunc();
+            m_numOfHeldFrames->fetch_add(1);
+            auto holder = std::make_shared<Holder>();
+            holder->ReleaseFunc = std::move(releaseFunc);
+            holder->NumOfHeldFrames = m_numOfHeldFrames;
+
+            // Replace the newest frame
+            previousHolder.swap(m_holder);
+            m_holder = holder;
+            m_data = data;
+            m_numOfBytes = numOfBytes;
+            m_frameIndex = frameIndex;
+            m_timestamp = timestamp;
+        }
+
+        // Release outside the lock
+        previousHolder.reset();
+
+        return true;
+    }
+
+#pragma endregion Producer
+
+#pragma region Consumer
+
+    bool FrameLeaseManager::Acquire(FrameLease& lease)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Check
+        if (m_holder == nullptr) return false;
+
+        lease = FrameLease(m_data, m_numOfBytes, m_frameIndex, m_timestamp, m_holder);
+
+        return true;
+    }
+
+    int FrameLeaseManager::getNumOfOutstandingLeases() const
+    {
+        return m_numOfHeldFrames->load();
+    }
+
+#pragma endregion Consumer
+
+#pragma region Statistics
+
+    unsigned long long FrameLeaseManager::getNumOfDroppedFrames() const
+    {
+        return m_dropped.load();
+    }
+
+    void FrameLeaseManager::ResetStatistics()
+    {
+        m_dropped = 0;
+    }
+
+#pragma endregion Statistics
+}
@@ -0,0 +1,164 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__BUFFER__FRAME_LEASE_MANAGER_H
+#define DIRECTSHOW_CAMERA__BUFFER__FRAME_LEASE_MANAGER_H
+
+//************Content************
+
+#include "buffer/frame_lease.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Keep the newest frame owned by the producer and hand it out as FrameLease.
+     *
+     * The producer frame is held through a hold function (e.g. IMediaSample::AddRef) and returned through a release function (e.g. IMediaSample::Release)
+     * once the manager and all leases let it go. The number of held frames is capped so that the producer never runs out of buffers.
+     */
+    class FrameLeaseManager
+    {
+    public:
+
+        /**
+         * @brief void() Function to hold or release a producer frame.
+        */
+        typedef std::function<void()> LeaseFunc;
+
+#pragma region Constructor and Destructor
+
+        /**
+         * @brief Constructor
+         * @param[in] maxOutstandingLeases (Optional) Maximum number of held frames, including the newest frame kept by the manager. Default as 2
+        */
+        FrameLeaseManager(const int maxOutstandingLeases = 2);
+
+        /**
+         * @brief Destructor. The newest frame is released, leased frames are released by their leases.
+        */
+        ~FrameLeaseManager();
+
+        /**
+         * @brief Release the newest frame. Leased frames are kept until their leases are released.
+        */
+        void Reset();
+
+#pragma endregion Constructor and Destructor
+
+#pragma region Settings
+
+        /**
+         * @brief Set the maximum number of held frames, including the newest frame kept by the manager.
+         *        It should be less than the number of buffers of the producer.
+         * @param[in] maxOutstandingLeases Maximum number of held frames. It must be > 0.
+        */
+        void setMaxOutstandingLeases(const int maxOutstandingLeases);
+
+        /**
+         * @brief Get the maximum number of held frames
+         * @return Return the maximum number of held frames
+        */
+        int getMaxOutstandingLeases() const;
+
+#pragma endregion Settings
+
+#pragma region Producer
+
+        /**
+         * @brief Publish a producer frame as the newest frame. The previous newest frame is released if it isn't leased.
+         * @param[in] data Frame in bytes. It must stay valid until releaseFunc is called.
+         * @param[in] numOfBytes Number of bytes of the frame
+         * @param[in] frameIndex Frame index
+         * @param[in] timestamp Capture timestamps
+         * @param[in] holdFunc Function to hold the frame. It is only called if the frame is accepted.
+         * @param[in] releaseFunc Function to release the frame. It is called once after holdFunc when the frame is no longer used.
+         * @return Return false if the frame is dropped because too many frames are held.
+        */
+        bool Publish(
+            const unsigned char* data,
+            const int numOfBytes,
+            const unsigned long frameIndex,
+            const FrameTimestamp timestamp,
+            const LeaseFunc& holdFunc,
+            LeaseFunc releaseFunc
+        );
+
+#pragma endregion Producer
+
+#pragma region Consumer
+
+        /**
+         * @brief Lease the newest frame. The same frame can be leased more than once.
+         * @param[out] lease Lease of the newest frame. The previous frame in the lease is released.
+         * @return Return false if no frame has been published.
+        */
+        bool Acquire(FrameLease& lease);
+
+        /**
+         * @brief Get the number of held frames, including the newest frame kept by the manager.
+         * @return Return the number of held frames
+        */
+        int getNumOfOutstandingLeases() const;
+
+#pragma endregion Consumer
+
+#pragma region Statistics
+
+        /**
+         * @brief Get the number of frames dropped because too many frames were held
+         * @return Return the number of dropped frames
+        */
+        unsigned long long getNumOfDroppedFrames() const;
+
+        /**
+         * @brief Reset the statistics
+        */
+        void ResetStatistics();
+
+#pragma endregion Statistics
+
+    private:
+
+        /**
+         * @brief Hold a producer frame. The frame is released when the holder is destroyed.
+        */
+        struct Holder
+        {
+            LeaseFunc ReleaseFunc;
+            std::shared_ptr<std::atomic<int>> NumOfHeldFrames;
+
+            ~Holder();
+        };
+
+    private:
+        int m_maxOutstandingLeases = 2;
+
+        // Newest frame
+        const unsigned char* m_data = nullptr;
+        int m_numOfBytes = 0;
+        unsigned long m_frameIndex = 0;
+        FrameTimestamp m_timestamp;
+        std::shared_ptr<Holder> m_holder = nullptr;
+
+        // Shared with the holders because leases can outlive the manager
+        std::shared_ptr<std::atomic<int>> m_numOfHeldFrames;
+
+        mutable std::mutex m_mutex;
+
+        // Statistics
+        std::atomic<unsigned long long> m_dropped = 0;
+    };
+}
+
+//*******************************
+
+#endif
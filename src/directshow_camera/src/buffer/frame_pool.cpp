@@ -0,0 +1,282 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "buffer/frame_pool.h"
+
+#include <new>
+#include <stdexcept>
+#include <string>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Allocator of std::allocate_shared() taking the memory of the storage from a pool. The allocator copy in the storage keeps the pool alive.
+    */
+    template <typename T>
+    struct FramePool::SharedBufferAllocator
+    {
+        typedef T value_type;
+
+        std::shared_ptr<FramePool> Pool;
+
+        SharedBufferAllocator(std::shared_ptr<FramePool> framePool) : Pool(std::move(framePool))
+        {
+        }
+
+        template <typename U>
+        SharedBufferAllocator(const SharedBufferAllocator<U>& other) : Pool(other.Pool)
+        {
+        }
+
+        T* allocate(const std::size_t n)
+        {
+            return static_cast<T*>(Pool->AcquireSharedBlock(n * sizeof(T)));
+        }
+
+        void deallocate(T* block, const std::size_t n)
+        {
+            Pool->ReleaseSharedBlock(block, n * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const SharedBufferAllocator<U>& other) const
+        {
+            return Pool == other.Pool;
+        }
+
+        template <typename U>
+        bool operator!=(const SharedBufferAllocator<U>& other) const
+        {
+            return Pool != other.Pool;
+        }
+    };
+
+    void FrameBufferDeleter::operator()(unsigned char* data)
+    {
+        if (data == nullptr) return;
+
+        if (Pool)
+        {
+            const auto framePool = std::move(Pool);
+            framePool->Release(data, NumOfBytes);
+        }
+        else
+        {
+            FramePool::FreeMemory(data);
+        }
+    }
+
+#pragma region Constructor and Destructor
+
+    FramePool::FramePool(const int maxNumOfBuffers)
+    {
+        setMaxNumOfBuffers(maxNumOfBuffers);
+    }
+
+    FramePool::~FramePool()
+    {
+        Reset();
+    }
+
+    void FramePool::Reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto data : m_freeBuffers) FreeMemory(data);
+        m_freeBuffers.clear();
+        for (auto block : m_freeSharedBlocks) ::operator delete(block);
+        m_freeSharedBlocks.clear();
+    }
+
+#pragma endregion Constructor and Destructor
+
+#pragma region Buffer
+
+    FrameBuffer FramePool::Allocate(const int numOfBytes)
+    {
+        // Check
+        if (numOfBytes <= 0) return nullptr;
+
+        return FrameBuffer(AllocateMemory(numOfBytes), FrameBufferDeleter{ nullptr, numOfBytes });
+    }
+
+    FrameBuffer FramePool::Acquire(const int numOfBytes)
+    {
+        // Check
+        if (numOfBytes <= 0) return nullptr;
+
+        unsigned char* data = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // Frame size changed, release the buffers in the old size
+            if (numOfBytes != m_bufferSize)
+            {
+                for (auto freeBuffer : m_freeBuffers) FreeMemory(freeBuffer);
+                m_freeBuffers.clear();
+                m_bufferSize = numOfBytes;
+            }
+
+            // Reuse
+            if (!m_freeBuffers.empty())
+            {
+                data = m_freeBuffers.back();
+                m_freeBuffers.pop_back();
+            }
+        }
+
+        if (data)
+        {
+            m_reuses++;
+        }
+        else
+        {
+            data = AllocateMemory(numOfBytes);
+            m_allocations++;
+        }
+
+        return FrameBuffer(data, FrameBufferDeleter{ shared_from_this(), numOfBytes });
+    }
+
+    std::shared_ptr<FrameBuffer> FramePool::MakeShared(FrameBuffer buffer)
+    {
+        return std::allocate_shared<FrameBuffer>(SharedBufferAllocator<FrameBuffer>(shared_from_this()), std::move(buffer));
+    }
+
+    void FramePool::Release(unsigned char* data, const int numOfBytes)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // The free list never grows beyond the reserved capacity, so no allocation is made here
+            if (numOfBytes == m_bufferSize && (int)m_freeBuffers.size() < m_maxNumOfBuffers)
+            {
+                m_freeBuffers.push_back(data);
+                return;
+            }
+        }
+
+        FreeMemory(data);
+    }
+
+    unsigned char* FramePool::AllocateMemory(const int numOfBytes)
+    {
+        return static_cast<unsigned char*>(::operator new[](numOfBytes, std::align_val_t(ALIGNMENT)));
+    }
+
+    void FramePool::FreeMemory(unsigned char* data)
+    {
+        ::operator delete[](data, std::align_val_t(ALIGNMENT));
+    }
+
+    void* FramePool::AcquireSharedBlock(const std::size_t numOfBytes)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_sharedBlockSize == 0) m_sharedBlockSize = numOfBytes;
+
+            // Reuse
+            if (numOfBytes == m_sharedBlockSize && !m_freeSharedBlocks.empty())
+            {
+                void* block = m_freeSharedBlocks.back();
+                m_freeSharedBlocks.pop_back();
+                return block;
+            }
+        }
+
+        m_sharedAllocations++;
+        return ::operator new(numOfBytes);
+    }
+
+    void FramePool::ReleaseSharedBlock(void* block, const std::size_t numOfBytes)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // The free list never grows beyond the reserved capacity, so no allocation is made here
+            if (numOfBytes == m_sharedBlockSize && (int)m_freeSharedBlocks.size() < m_maxNumOfBuffers)
+            {
+                m_freeSharedBlocks.push_back(block);
+                return;
+            }
+        }
+
+        ::operator delete(block);
+    }
+
+#pragma endregion Buffer
+
+#pragma region Settings
+
+    void FramePool::setMaxNumOfBuffers(const int maxNumOfBuffers)
+    {
+        // Check
+        if (maxNumOfBuffers < 0) throw std::invalid_argument("Maximum number of buffers(" + std::to_string(maxNumOfBuffers) + ") can't be < 0.");
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxNumOfBuffers = maxNumOfBuffers;
+
+        // Release extra buffers
+        while ((int)m_freeBuffers.size() > m_maxNumOfBuffers)
+        {
+            FreeMemory(m_freeBuffers.back());
+            m_freeBuffers.pop_back();
+        }
+        while ((int)m_freeSharedBlocks.size() > m_maxNumOfBuffers)
+        {
+            ::operator delete(m_freeSharedBlocks.back());
+            m_freeSharedBlocks.pop_back();
+        }
+
+        m_freeBuffers.reserve(m_maxNumOfBuffers);
+        m_freeSharedBlocks.reserve(m_maxNumOfBuffers);
+    }
+
+    int FramePool::getMaxNumOfBuffers() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_maxNumOfBuffers;
+    }
+
+    int FramePool::getBufferSize() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_bufferSize;
+    }
+
+    int FramePool::getNumOfFreeBuffers() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return (int)m_freeBuffers.size();
+    }
+
+#pragma endregion Settings
+
+#pragma region Statistics
+
+    unsigned long long FramePool::getNumOfAllocations() const
+    {
+        return m_allocations.load();
+    }
+
+    unsigned long long FramePool::getNumOfReuses() const
+    {
+        return m_reuses.load();
+    }
+
+    unsigned long long FramePool::getNumOfSharedAllocations() const
+    {
+        return m_sharedAllocations.load();
+    }
+
+    void FramePool::ResetStatistics()
+    {
+        m_allocations = 0;
+        m_reuses = 0;
+        m_sharedAllocations = 0;
+    }
+
+#pragma endregion Statistics
+}
@@ -0,0 +1,230 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__BUFFER__FRAME_POOL_H
+#define DIRECTSHOW_CAMERA__BUFFER__FRAME_POOL_H
+
+//************Content************
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace DirectShowCamera
+{
+    class FramePool;
+
+    /**
+     * @brief Deleter of FrameBuffer. The buffer is returned to the pool if it comes from a pool, otherwise it is freed.
+    */
+    struct FrameBufferDeleter
+    {
+        /**
+         * @brief Pool which the buffer comes from. nullptr if the buffer is not pooled.
+        */
+        std::shared_ptr<FramePool> Pool = nullptr;
+
+        /**
+         * @brief Size of the buffer in bytes
+        */
+        int NumOfBytes = 0;
+
+        /**
+         * @brief Return the buffer to the pool or free it. The pool is detached so that an empty FrameBuffer doesn't keep the pool alive.
+         * @param[in] data Buffer
+        */
+        void operator()(unsigned char* data);
+    };
+
+    /**
+     * @brief A frame buffer which is 64-byte aligned and not value-initialized.
+    */
+    typedef std::unique_ptr<unsigned char[], FrameBufferDeleter> FrameBuffer;
+
+    /**
+     * @brief A pool recycling frame buffers in a fixed size.
+     *
+     * Buffers are allocated without value-initialization and aligned to FramePool::ALIGNMENT bytes for SIMD kernels.
+     * A buffer goes back to the pool when its FrameBuffer is destroyed, so a steady stream of frames in the same size doesn't allocate.
+     * The pool is kept alive by the buffers taken from it. Use std::make_shared to create it.
+     */
+    class FramePool : public std::enable_shared_from_this<FramePool>
+    {
+    public:
+
+        /**
+         * @brief Alignment of the buffers in bytes
+        */
+        static constexpr std::size_t ALIGNMENT = 64;
+
+#pragma region Constructor and Destructor
+
+        /**
+         * @brief Constructor
+         * @param[in] maxNumOfBuffers (Optional) Maximum number of free buffers kept by the pool. Default as 4
+        */
+        FramePool(const int maxNumOfBuffers = 4);
+
+        /**
+         * @brief Destructor. Free buffers are released.
+        */
+        ~FramePool();
+
+        /**
+         * @brief Release all free buffers
+        */
+        void Reset();
+
+#pragma endregion Constructor and Destructor
+
+#pragma region Buffer
+
+        /**
+         * @brief Allocate an aligned and uninitialized buffer which is not pooled.
+         * @param[in] numOfBytes Number of bytes
+         * @return Return the buffer. Return nullptr if numOfBytes <= 0.
+        */
+        static FrameBuffer Allocate(const int numOfBytes);
+
+        /**
+         * @brief Take a buffer from the pool. A new buffer is allocated if no free buffer is available.
+         *        Free buffers in another size are released, the pool keeps the size of the last request.
+         * @param[in] numOfBytes Number of bytes
+         * @return Return the buffer. It is uninitialized. Return nullptr if numOfBytes <= 0.
+        */
+        FrameBuffer Acquire(const int numOfBytes);
+
+        /**
+         * @brief Move a buffer into a storage shared by the frames, e.g. the copy-on-write storage of Frame.
+         *        The memory of the storage is recycled by the pool as the buffers, so a steady stream of frames doesn't allocate.
+         * @param[in] buffer Buffer. It can come from any pool or be nullptr.
+         * @return Return the storage
+        */
+        std::shared_ptr<FrameBuffer> MakeShared(FrameBuffer buffer);
+
+#pragma endregion Buffer
+
+#pragma region Settings
+
+        /**
+         * @brief Set the maximum number of free buffers kept by the pool. Extra buffers are released.
+         * @param[in] maxNumOfBuffers Maximum number of free buffers. It must be >= 0.
+        */
+        void setMaxNumOfBuffers(const int maxNumOfBuffers);
+
+        /**
+         * @brief Get the maximum number of free buffers kept by the pool
+         * @return Return the maximum number of free buffers
+        */
+        int getMaxNumOfBuffers() const;
+
+        /**
+         * @brief Get the buffer size of the pool
+         * @return Return the buffer size in bytes. Return 0 if no buffer has been requested.
+        */
+        int getBufferSize() const;
+
+        /**
+         * @brief Get the number of free buffers in the pool
+         * @return Return the number of free buffers
+        */
+        int getNumOfFreeBuffers() const;
+
+#pragma endregion Settings
+
+#pragma region Statistics
+
+        /**
+         * @brief Get the number of buffers allocated by Acquire()
+         * @return Return the number of allocations
+        */
+        unsigned long long getNumOfAllocations() const;
+
+        /**
+         * @brief Get the number of buffers reused by Acquire()
+         * @return Return the number of reuses
+        */
+        unsigned long long getNumOfReuses() const;
+
+        /**
+         * @brief Get the number of shared storages allocated by MakeShared(). A storage reusing a freed storage is not counted.
+         * @return Return the number of allocations
+        */
+        unsigned long long getNumOfSharedAllocations() const;
+
+        /**
+         * @brief Reset the statistics
+        */
+        void ResetStatistics();
+
+#pragma endregion Statistics
+
+    private:
+        friend struct FrameBufferDeleter;
+
+        /**
+         * @brief Allocator of the shared storages, see MakeShared()
+        */
+        template <typename T>
+        struct SharedBufferAllocator;
+
+        /**
+         * @brief Return a buffer to the pool. It is freed if it is not in the pool size or the pool is full.
+         * @param[in] data Buffer
+         * @param[in] numOfBytes Size of the buffer in bytes
+        */
+        void Release(unsigned char* data, const int numOfBytes);
+
+        /**
+         * @brief Allocate an aligned and uninitialized memory block
+         * @param[in] numOfBytes Number of bytes
+         * @return Return the memory block
+        */
+        static unsigned char* AllocateMemory(const int numOfBytes);
+
+        /**
+         * @brief Free a memory block allocated by AllocateMemory()
+         * @param[in] data Memory block
+        */
+        static void FreeMemory(unsigned char* data);
+
+        /**
+         * @brief Take a memory block of a shared storage from the pool. A new block is allocated if no free block is available.
+         * @param[in] numOfBytes Size of the block in bytes
+         * @return Return the memory block
+        */
+        void* AcquireSharedBlock(const std::size_t numOfBytes);
+
+        /**
+         * @brief Return a memory block of a shared storage to the pool. It is freed if it is not in the block size or the pool is full.
+         * @param[in] block Memory block
+         * @param[in] numOfBytes Size of the block in bytes
+        */
+        void ReleaseSharedBlock(void* block, const std::size_t numOfBytes);
+
+    private:
+        mutable std::mutex m_mutex;
+        std::vector<unsigned char*> m_freeBuffers;
+        int m_bufferSize = 0;
+        int m_maxNumOfBuffers = 4;
+
+        // Memory blocks of the shared storages. All blocks are in the same size as they hold the same type.
+        std::vector<void*> m_freeSharedBlocks;
+        std::size_t m_sharedBlockSize = 0;
+
+        // Statistics
+        std::atomic<unsigned long long> m_allocations = 0;
+        std::atomic<unsigned long long> m_reuses = 0;
+        std::atomic<unsigned long long> m_sharedAllocations = 0;
+    };
+}
+
+//*******************************
+
+#endif
@@ -0,0 +1,348 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "buffer/frame_ring_buffer.h"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace DirectShowCamera
+{
+#pragma region Constructor and Destructor
+
+    FrameRingBuffer::FrameRingBuffer(
+        const int capacity,
+        const FrameOverflowPolicy overflowPolicy
+    )
+    {
+        m_overflowPolicy = overflowPolicy;
+        setCapacity(capacity);
+    }
+
+    void FrameRingBuffer::Reset()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ResetSlots();
+            m_resetCount++;
+        }
+
+        // Wake up the blocked producer
+        m_slotFreed.notify_all();
+    }
+
+    void FrameRingBuffer::ResetSlots()
+    {
+        // Slot buffers are kept so that they can be reused
+        m_freeSlots.clear();
+        for (int i = 0; i < (int)m_slots.size(); i++)
+        {
+            m_slots[i].NumOfBytes = 0;
+            m_slots[i].FrameIndex = 0;
+            m_slots[i].Timestamp = FrameTimestamp();
+            m_freeSlots.push_back(i);
+        }
+
+        m_queuedSlots.assign(m_slots.size(), -1);
+        m_queueHead = 0;
+        m_numOfQueuedSlots = 0;
+        m_writeSlot = -1;
+    }
+
+#pragma endregion Constructor and Destructor
+
+#pragma region Settings
+
+    void FrameRingBuffer::setCapacity(const int capacity)
+    {
+        // Check
+        if (capacity <= 0) throw std::invalid_argument("Ring buffer capacity(" + std::to_string(capacity) + ") can't be <= 0.");
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // One more slot for the producer and one more slot for the consumer
+            m_capacity = capacity;
+            m_slots.clear();
+            m_slots.resize(capacity + 2);
+            ResetSlots();
+            m_resetCount++;
+        }
+
+        m_slotFreed.notify_all();
+    }
+
+    int FrameRingBuffer::getCapacity() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_capacity;
+    }
+
+    void FrameRingBuffer::setOverflowPolicy(const FrameOverflowPolicy overflowPolicy)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_overflowPolicy = overflowPolicy;
+        }
+
+        // Release the blocked producer if it is no longer blocking
+        m_slotFreed.notify_all();
+    }
+
+    FrameOverflowPolicy FrameRingBuffer::getOverflowPolicy() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_overflowPolicy;
+    }
+
+    void FrameRingBuffer::setBlockTimeout(const int timeout)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_blockTimeout = timeout < 0 ? 0 : timeout;
+    }
+
+    int FrameRingBuffer::getBlockTimeout() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_blockTimeout;
+    }
+
+#pragma endregion Settings
+
+#pragma region Producer
+
+    unsigned char* FrameRingBuffer::BeginWrite(const int numOfBytes)
+    {
+        // Check
+        if (numOfBytes <= 0) return nullptr;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        // Queue is full
+        if (m_numOfQueuedSlots >= m_capacity)
+        {
+            if (m_overflowPolicy == FrameOverflowPolicy::DropOldest)
+            {
+                m_freeSlots.push_back(PopQueuedSlot());
+                m_dropped++;
+            }
+            else if (m_overflowPolicy == FrameOverflowPolicy::DropNewest)
+            {
+                m_dropped++;
+                return nullptr;
+            }
+            else
+            {
+                // Wait for the consumer
+                const unsigned long long resetCount = m_resetCount;
+                const auto startTime = std::chrono::steady_clock::now();
+                const bool hasFreeSlot = m_slotFreed.wait_for(
+                    lock,
+                    std::chrono::milliseconds(m_blockTimeout),
+                    [this, resetCount]()
+                    {
+                        return m_numOfQueuedSlots < m_capacity ||
+                            m_resetCount != resetCount ||
+                            m_overflowPolicy != FrameOverflowPolicy::Block;
+                    }
+                );
+                const auto endTime = std::chrono::steady_clock::now();
+
+                m_blocks++;
+                m_blockedTime += std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+
+                // Timeout or reset
+                if (!hasFreeSlot || m_resetCount != resetCount)
+                {
+                    m_dropped++;
+                    return nullptr;
+                }
+
+                // Policy changed while waiting
+                if (m_numOfQueuedSlots >= m_capacity)
+                {
+                    m_freeSlots.push_back(PopQueuedSlot());
+                    m_dropped++;
+                }
+            }
+        }
+
+        // Take a free slot
+        const int slotIndex = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_writeSlot = slotIndex;
+        Slot& slot = m_slots[slotIndex];
+
+        lock.unlock();
+
+        // Reallocate slot if the size changed. The slot is owned by the producer until EndWrite().
+        if (slot.Capacity != numOfBytes)
+        {
+            slot.Data = FramePool::Allocate(numOfBytes);
+            slot.Capacity = numOfBytes;
+            m_allocations++;
+        }
+        slot.NumOfBytes = numOfBytes;
+
+        return slot.Data.get();
+    }
+
+    void FrameRingBuffer::EndWrite(const unsigned long frameIndex, const FrameTimestamp timestamp)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Check
+        if (m_writeSlot < 0) return;
+
+        // Queue
+        m_slots[m_writeSlot].FrameIndex = frameIndex;
+        m_slots[m_writeSlot].Timestamp = timestamp;
+        const int tail = (m_queueHead + m_numOfQueuedSlots) % (int)m_queuedSlots.size();
+        m_queuedSlots[tail] = m_writeSlot;
+        m_numOfQueuedSlots++;
+        m_writeSlot = -1;
+    }
+
+#pragma endregion Producer
+
+#pragma region Consumer
+
+    bool FrameRingBuffer::Pop(
+        unsigned char* frame,
+        int& numOfBytes,
+        unsigned long& frameIndex,
+        FrameTimestamp& timestamp
+    )
+    {
+        // Check
+        if (frame == nullptr) return false;
+
+        // Take the oldest slot. It is owned by the consumer until it goes back to the free list.
+        int slotIndex = -1;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_numOfQueuedSlots == 0) return false;
+            slotIndex = PopQueuedSlot();
+        }
+        m_slotFreed.notify_one();
+
+        // Copy
+        Slot& slot = m_slots[slotIndex];
+        memcpy(frame, slot.Data.get(), slot.NumOfBytes);
+        numOfBytes = slot.NumOfBytes;
+        frameIndex = slot.FrameIndex;
+        timestamp = slot.Timestamp;
+
+        // Release slot
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_freeSlots.push_back(slotIndex);
+        }
+
+        return true;
+    }
+
+    bool FrameRingBuffer::Exchange(
+        FrameBuffer& frame,
+        int& numOfBytes,
+        unsigned long& frameIndex,
+        FrameTimestamp& timestamp
+    )
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_numOfQueuedSlots == 0) return false;
+
+            // Swap buffer. The consumer buffer will be reused by the producer.
+            const int slotIndex = PopQueuedSlot();
+            Slot& slot = m_slots[slotIndex];
+            const int frameNumOfBytes = slot.NumOfBytes;
+            slot.Data.swap(frame);
+            slot.Capacity = slot.Data == nullptr ? 0 : numOfBytes;
+            slot.NumOfBytes = 0;
+
+            numOfBytes = frameNumOfBytes;
+            frameIndex = slot.FrameIndex;
+            timestamp = slot.Timestamp;
+
+            m_freeSlots.push_back(slotIndex);
+        }
+        m_slotFreed.notify_one();
+
+        return true;
+    }
+
+    int FrameRingBuffer::DiscardFramesNotInSize(const int numOfBytes)
+    {
+        int numOfDiscardedFrames = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            while (m_numOfQueuedSlots > 0 && m_slots[m_queuedSlots[m_queueHead]].NumOfBytes != numOfBytes)
+            {
+                m_freeSlots.push_back(PopQueuedSlot());
+                numOfDiscardedFrames++;
+            }
+        }
+
+        if (numOfDiscardedFrames > 0)
+        {
+            m_dropped += numOfDiscardedFrames;
+            m_slotFreed.notify_one();
+        }
+
+        return numOfDiscardedFrames;
+    }
+
+    int FrameRingBuffer::getNumOfFrames() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_numOfQueuedSlots;
+    }
+
+    int FrameRingBuffer::PopQueuedSlot()
+    {
+        const int slotIndex = m_queuedSlots[m_queueHead];
+        m_queueHead = (m_queueHead + 1) % (int)m_queuedSlots.size();
+        m_numOfQueuedSlots--;
+        return slotIndex;
+    }
+
+#pragma endregion Consumer
+
+#pragma region Statistics
+
+    unsigned long long FrameRingBuffer::getNumOfDroppedFrames() const
+    {
+        return m_dropped.load();
+    }
+
+    unsigned long long FrameRingBuffer::getNumOfAllocations() const
+    {
+        return m_allocations.load();
+    }
+
+    unsigned long long FrameRingBuffer::getNumOfBlocks() const
+    {
+        return m_blocks.load();
+    }
+
+    unsigned long long FrameRingBuffer::getBlockedTime() const
+    {
+        return m_blockedTime.load();
+    }
+
+    void FrameRingBuffer::ResetStatistics()
+    {
+        m_dropped = 0;
+        m_allocations = 0;
+        m_blocks = 0;
+        m_blockedTime = 0;
+    }
+
+#pragma endregion Statistics
+}
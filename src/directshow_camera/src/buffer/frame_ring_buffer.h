@@ -0,0 +1,268 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__BUFFER__FRAME_RING_BUFFER_H
+#define DIRECTSHOW_CAMERA__BUFFER__FRAME_RING_BUFFER_H
+
+//************Content************
+
+#include "buffer/frame_pool.h"
+#include "buffer/frame_timestamp.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief What to do when a frame arrives and the ring buffer is full
+     */
+    enum class FrameOverflowPolicy
+    {
+        /**
+         * @brief Drop the oldest queued frame to make room for the new frame
+        */
+        DropOldest,
+
+        /**
+         * @brief Drop the new frame and keep the queued frames
+        */
+        DropNewest,
+
+        /**
+         * @brief Block the producer until the consumer frees a slot. The new frame is dropped if it times out.
+        */
+        Block
+    };
+
+    /**
+     * @brief A N-slot frame queue which keeps every frame in order until the consumer takes it.
+     *
+     * Frames are written and read outside the lock, the lock only protects the slot bookkeeping.
+     * Two extra slots are allocated so that the producer and the consumer always have a slot to work on
+     * while the queue holds capacity frames.
+     */
+    class FrameRingBuffer
+    {
+    public:
+
+#pragma region Constructor and Destructor
+
+        /**
+         * @brief Constructor
+         * @param[in] capacity (Optional) Maximum number of queued frames. Default as 8
+         * @param[in] overflowPolicy (Optional) Overflow policy. Default as FrameOverflowPolicy::DropOldest
+        */
+        FrameRingBuffer(
+            const int capacity = 8,
+            const FrameOverflowPolicy overflowPolicy = FrameOverflowPolicy::DropOldest
+        );
+
+        /**
+         * @brief Discard all queued frames and wake up the blocked producer. It should not be called while writing or reading.
+        */
+        void Reset();
+
+#pragma endregion Constructor and Destructor
+
+#pragma region Settings
+
+        /**
+         * @brief Set the maximum number of queued frames. All queued frames will be discarded. It should not be called while writing or reading.
+         * @param[in] capacity Maximum number of queued frames. It must be > 0.
+        */
+        void setCapacity(const int capacity);
+
+        /**
+         * @brief Get the maximum number of queued frames
+         * @return Return the maximum number of queued frames
+        */
+        int getCapacity() const;
+
+        /**
+         * @brief Set the overflow policy
+         * @param[in] overflowPolicy Overflow policy
+        */
+        void setOverflowPolicy(const FrameOverflowPolicy overflowPolicy);
+
+        /**
+         * @brief Get the overflow policy
+         * @return Return the overflow policy
+        */
+        FrameOverflowPolicy getOverflowPolicy() const;
+
+        /**
+         * @brief Set the maximum time the producer is blocked in FrameOverflowPolicy::Block
+         * @param[in] timeout Timeout in ms. Default as 1000ms
+        */
+        void setBlockTimeout(const int timeout);
+
+        /**
+         * @brief Get the maximum time the producer is blocked in FrameOverflowPolicy::Block
+         * @return Return the timeout in ms
+        */
+        int getBlockTimeout() const;
+
+#pragma endregion Settings
+
+#pragma region Producer
+
+        /**
+         * @brief Get a slot to write a new frame. Call EndWrite() after the frame has been written into the returned pointer.
+         * @param[in] numOfBytes Number of bytes to be written
+         * @return Return the slot to be written. Return nullptr if the new frame is dropped by the overflow policy.
+        */
+        unsigned char* BeginWrite(const int numOfBytes);
+
+        /**
+         * @brief Queue the frame written after BeginWrite()
+         * @param[in] frameIndex Frame index of the written frame
+         * @param[in] timestamp Capture timestamps of the written frame
+        */
+        void EndWrite(const unsigned long frameIndex, const FrameTimestamp timestamp);
+
+#pragma endregion Producer
+
+#pragma region Consumer
+
+        /**
+         * @brief Copy the oldest queued frame and remove it from the queue.
+         * @param[out] frame Frame in bytes. It should be large enough to hold the frame.
+         * @param[out] numOfBytes Number of bytes of the frame.
+         * @param[out] frameIndex Frame index.
+         * @param[out] timestamp Capture timestamps.
+         * @return Return false if no frame is queued.
+        */
+        bool Pop(
+            unsigned char* frame,
+            int& numOfBytes,
+            unsigned long& frameIndex,
+            FrameTimestamp& timestamp
+        );
+
+        /**
+         * @brief Hand the oldest queued frame over by exchanging buffers and remove it from the queue. No copy is made.
+         * @param[in,out] frame In: the consumer buffer which will be reused by the producer, can be nullptr. Out: the oldest frame.
+         * @param[in,out] numOfBytes In: size of the consumer buffer. Out: Number of bytes of the frame.
+         * @param[out] frameIndex Frame index.
+         * @param[out] timestamp Capture timestamps.
+         * @return Return false if no frame is queued. In this case, nothing is changed.
+        */
+        bool Exchange(
+            FrameBuffer& frame,
+            int& numOfBytes,
+            unsigned long& frameIndex,
+            FrameTimestamp& timestamp
+        );
+
+        /**
+         * @brief Discard queued frames until the oldest frame is in the given size.
+         * @param[in] numOfBytes Frame size in bytes to be kept
+         * @return Return the number of discarded frames
+        */
+        int DiscardFramesNotInSize(const int numOfBytes);
+
+        /**
+         * @brief Get the number of queued frames
+         * @return Return the number of queued frames
+        */
+        int getNumOfFrames() const;
+
+#pragma endregion Consumer
+
+#pragma region Statistics
+
+        /**
+         * @brief Get the number of frames dropped by the overflow policy
+         * @return Return the number of dropped frames
+        */
+        unsigned long long getNumOfDroppedFrames() const;
+
+        /**
+         * @brief Get the number of slot buffers allocated
+         * @return Return the number of allocations
+        */
+        unsigned long long getNumOfAllocations() const;
+
+        /**
+         * @brief Get the number of times the producer was blocked by a full queue
+         * @return Return the number of times the producer was blocked
+        */
+        unsigned long long getNumOfBlocks() const;
+
+        /**
+         * @brief Get the total time the producer was blocked by a full queue
+         * @return Return the total blocked time in nanosecond
+        */
+        unsigned long long getBlockedTime() const;
+
+        /**
+         * @brief Reset the statistics
+        */
+        void ResetStatistics();
+
+#pragma endregion Statistics
+
+    private:
+
+        /**
+         * @brief A frame slot
+        */
+        struct Slot
+        {
+            FrameBuffer Data = nullptr;
+            int Capacity = 0;
+            int NumOfBytes = 0;
+            unsigned long FrameIndex = 0;
+            FrameTimestamp Timestamp;
+        };
+
+        /**
+         * @brief Discard all queued frames and rebuild the free list. The lock must be held.
+        */
+        void ResetSlots();
+
+        /**
+         * @brief Remove the oldest queued slot. The lock must be held and the queue must not be empty.
+         * @return Return the slot index
+        */
+        int PopQueuedSlot();
+
+    private:
+        int m_capacity = 8;
+        FrameOverflowPolicy m_overflowPolicy = FrameOverflowPolicy::DropOldest;
+        int m_blockTimeout = 1000;
+
+        std::vector<Slot> m_slots;
+        std::vector<int> m_freeSlots;
+
+        // Queued slot indexes in a circular array
+        std::vector<int> m_queuedSlots;
+        int m_queueHead = 0;
+        int m_numOfQueuedSlots = 0;
+
+        // Slot being written by the producer
+        int m_writeSlot = -1;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_slotFreed;
+        unsigned long long m_resetCount = 0;
+
+        // Statistics
+        std::atomic<unsigned long long> m_dropped = 0;
+        std::atomic<unsigned long long> m_allocations = 0;
+        std::atomic<unsigned long long> m_blocks = 0;
+        std::atomic<unsigned long long> m_blockedTime = 0;
+    };
+}
+
+//*******************************
+
+#endif
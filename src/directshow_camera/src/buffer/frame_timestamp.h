@@ -0,0 +1,61 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__BUFFER__FRAME_TIMESTAMP_H
+#define DIRECTSHOW_CAMERA__BUFFER__FRAME_TIMESTAMP_H
+
+//************Content************
+
+#include <chrono>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Capture timestamps of a frame
+     */
+    struct FrameTimestamp
+    {
+        /**
+         * @brief Presentation time given by the device in nanosecond, relative to the start of the stream. It is -1 if the device doesn't provide it.
+        */
+        long long DeviceTime = -1;
+
+        /**
+         * @brief Time in nanosecond when the frame arrived from the device, measured by std::chrono::steady_clock. It is 0 if unknown.
+        */
+        long long ArrivalTime = 0;
+
+        /**
+         * @brief Get the current std::chrono::steady_clock time which can be compared with ArrivalTime
+         * @return Return the current time in nanosecond
+        */
+        static long long Now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        /**
+         * @brief equal operator
+        */
+        bool operator==(const FrameTimestamp& other) const
+        {
+            return DeviceTime == other.DeviceTime && ArrivalTime == other.ArrivalTime;
+        }
+
+        /**
+        * @brief not equal operator
+        */
+        bool operator!=(const FrameTimestamp& other) const
+        {
+            return !(*this == other);
+        }
+    };
+}
+
+//*******************************
+
+#endif
@@ -0,0 +1,126 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "buffer/triple_frame_buffer.h"
+
+namespace DirectShowCamera
+{
+#pragma region Constructor and Destructor
+
+    TripleFrameBuffer::TripleFrameBuffer()
+    {
+        Reset();
+    }
+
+    void TripleFrameBuffer::Reset()
+    {
+        for (auto& slot : m_slots)
+        {
+            slot.Data.reset();
+            slot.Capacity = 0;
+            slot.NumOfBytes = 0;
+            slot.FrameIndex = 0;
+            slot.Timestamp = FrameTimestamp();
+            slot.Exchanged = false;
+        }
+
+        m_writeIndex = 0;
+        m_sharedIndex.store(1, std::memory_order_release);
+        m_readIndex = 2;
+    }
+
+#pragma endregion Constructor and Destructor
+
+#pragma region Producer
+
+    int TripleFrameBuffer::getWriteBufferCapacity() const
+    {
+        return m_slots[m_writeIndex].Capacity;
+    }
+
+    unsigned char* TripleFrameBuffer::getWriteBuffer(const int numOfBytes)
+    {
+        Slot& slot = m_slots[m_writeIndex];
+
+        // Reallocate slot if the size changed. Keep the exact size so that the slot can be exchanged with a Frame.
+        if (slot.Capacity != numOfBytes)
+        {
+            slot.Data = FramePool::Allocate(numOfBytes);
+            slot.Capacity = numOfBytes;
+        }
+        slot.NumOfBytes = numOfBytes;
+        slot.Exchanged = false;
+
+        return slot.Data.get();
+    }
+
+    void TripleFrameBuffer::Publish(const unsigned long frameIndex, const FrameTimestamp timestamp)
+    {
+        m_slots[m_writeIndex].FrameIndex = frameIndex;
+        m_slots[m_writeIndex].Timestamp = timestamp;
+
+        // Swap write slot and shared slot. Release makes the frame visible to the consumer.
+        const int previousSharedIndex = m_sharedIndex.exchange(m_writeIndex | NEW_FRAME_FLAG, std::memory_order_acq_rel);
+        m_writeIndex = previousSharedIndex & SLOT_INDEX_MASK;
+    }
+
+#pragma endregion Producer
+
+#pragma region Consumer
+
+    bool TripleFrameBuffer::Acquire()
+    {
+        // Nothing new
+        if ((m_sharedIndex.load(std::memory_order_relaxed) & NEW_FRAME_FLAG) == 0) return false;
+
+        // Swap read slot and shared slot. Acquire makes the frame written by the producer visible.
+        const int previousSharedIndex = m_sharedIndex.exchange(m_readIndex, std::memory_order_acq_rel);
+        m_readIndex = previousSharedIndex & SLOT_INDEX_MASK;
+
+        return true;
+    }
+
+    const unsigned char* TripleFrameBuffer::getReadBuffer(int& numOfBytes, unsigned long& frameIndex, FrameTimestamp& timestamp) const
+    {
+        const Slot& slot = m_slots[m_readIndex];
+        numOfBytes = slot.NumOfBytes;
+        frameIndex = slot.FrameIndex;
+        timestamp = slot.Timestamp;
+        return slot.Data.get();
+    }
+
+    bool TripleFrameBuffer::ExchangeReadBuffer(
+        FrameBuffer& buffer,
+        int& numOfBytes,
+        unsigned long& frameIndex,
+        FrameTimestamp& timestamp
+    )
+    {
+        Slot& slot = m_slots[m_readIndex];
+
+        // Check
+        if (slot.Data == nullptr || slot.NumOfBytes <= 0 || slot.Exchanged) return false;
+
+        // Swap buffer. The consumer buffer will be reused by the producer once the slot goes back to it.
+        const int frameNumOfBytes = slot.NumOfBytes;
+        slot.Data.swap(buffer);
+        slot.Capacity = slot.Data == nullptr ? 0 : numOfBytes;
+        slot.Exchanged = true;
+
+        numOfBytes = frameNumOfBytes;
+        frameIndex = slot.FrameIndex;
+        timestamp = slot.Timestamp;
+
+        return true;
+    }
+
+    bool TripleFrameBuffer::isReadBufferExchanged() const
+    {
+        return m_slots[m_readIndex].Exchanged;
+    }
+
+#pragma endregion Consumer
+}
@@ -0,0 +1,153 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__BUFFER__TRIPLE_FRAME_BUFFER_H
+#define DIRECTSHOW_CAMERA__BUFFER__TRIPLE_FRAME_BUFFER_H
+
+//************Content************
+
+#include "buffer/frame_pool.h"
+#include "buffer/frame_timestamp.h"
+
+#include <atomic>
+#include <memory>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief A lock-free single producer, single consumer triple buffer.
+     *
+     * The producer owns the write slot, the consumer owns the read slot and the third slot is shared.
+     * The producer publishes a frame by atomically swapping its write slot with the shared slot.
+     * The consumer picks up the newest published frame by swapping its read slot with the shared slot.
+     * Neither side ever waits for the other.
+     *
+     * Slots are (re)allocated lazily on the side which owns them, so no global resize is required when the frame size changes.
+     *
+     * The consumer can also exchange the read slot with its own buffer so that the newest frame is handed over without copying.
+     */
+    class TripleFrameBuffer
+    {
+    public:
+
+#pragma region Constructor and Destructor
+
+        /**
+         * @brief Constructor
+        */
+        TripleFrameBuffer();
+
+        /**
+         * @brief Reset all slots. It must only be called when neither the producer nor the consumer is running.
+        */
+        void Reset();
+
+#pragma endregion Constructor and Destructor
+
+#pragma region Producer
+
+        /**
+         * @brief Get the capacity of the write slot in bytes. Producer only.
+         * @return Return the capacity of the write slot. getWriteBuffer() allocates a new buffer if it is not equal to the number of bytes to be written.
+        */
+        int getWriteBufferCapacity() const;
+
+        /**
+         * @brief Get the write slot. The slot will be reallocated if its capacity is not equal to numOfBytes. Producer only.
+         * @param[in] numOfBytes Number of bytes to be written
+         * @return Return the write slot pointer
+        */
+        unsigned char* getWriteBuffer(const int numOfBytes);
+
+        /**
+         * @brief Publish the write slot as the newest frame. Producer only.
+         * @param[in] frameIndex Frame index of the written frame
+         * @param[in] timestamp Capture timestamps of the written frame
+        */
+        void Publish(const unsigned long frameIndex, const FrameTimestamp timestamp);
+
+#pragma endregion Producer
+
+#pragma region Consumer
+
+        /**
+         * @brief Swap the newest published frame into the read slot. Consumer only.
+         * @return Return true if a new frame has been swapped in. Return false if no frame was published since the last Acquire().
+        */
+        bool Acquire();
+
+        /**
+         * @brief Get the read slot. Consumer only.
+         * @param[out] numOfBytes Number of bytes in the read slot. It is 0 if no frame has been acquired.
+         * @param[out] frameIndex Frame index of the read slot
+         * @param[out] timestamp Capture timestamps of the read slot
+         * @return Return the read slot pointer
+        */
+        const unsigned char* getReadBuffer(int& numOfBytes, unsigned long& frameIndex, FrameTimestamp& timestamp) const;
+
+        /**
+         * @brief Exchange the read slot with the consumer buffer. Consumer only.
+         *        After the exchange, the read slot is marked as exchanged until a new frame is acquired.
+         * @param[in,out] buffer In: the consumer buffer which will be reused by the producer, can be nullptr. Out: the frame in the read slot.
+         * @param[in,out] numOfBytes In: size of the consumer buffer. Out: Number of bytes of the frame.
+         * @param[out] frameIndex Frame index of the frame
+         * @param[out] timestamp Capture timestamps of the frame
+         * @return Return false if the read slot is empty or has been exchanged. In this case, nothing is changed.
+        */
+        bool ExchangeReadBuffer(
+            FrameBuffer& buffer,
+            int& numOfBytes,
+            unsigned long& frameIndex,
+            FrameTimestamp& timestamp
+        );
+
+        /**
+         * @brief Return true if the frame in the read slot has been handed over by ExchangeReadBuffer(). Consumer only.
+         * @return Return true if the read slot has been exchanged.
+        */
+        bool isReadBufferExchanged() const;
+
+#pragma endregion Consumer
+
+    private:
+
+        /**
+         * @brief A frame slot
+        */
+        struct Slot
+        {
+            FrameBuffer Data = nullptr;
+            int Capacity = 0;
+            int NumOfBytes = 0;
+            unsigned long FrameIndex = 0;
+            FrameTimestamp Timestamp;
+            bool Exchanged = false;
+        };
+
+        /**
+         * @brief Bit set on the shared index when the shared slot holds a frame which has not been acquired.
+        */
+        static const int NEW_FRAME_FLAG = 4;
+        static const int SLOT_INDEX_MASK = 3;
+
+    private:
+        Slot m_slots[3];
+
+        // Producer owned. Keep producer and consumer states in different cache lines to avoid false sharing.
+        alignas(64) int m_writeIndex = 0;
+
+        // Shared
+        alignas(64) std::atomic<int> m_sharedIndex = 1;
+
+        // Consumer owned
+        alignas(64) int m_readIndex = 2;
+    };
+}
+
+//*******************************
+
+#endif
@@ -302,6 +302,12 @@ namespace DirectShowCamera
         {
             const auto result = m_directShowCamera->Stop();
 
+            // Release the buffer of the last exchanged frame
+            {
+                std::lock_guard<std::mutex> lock(m_exchangedFrameMutex);
+                m_exchangedFrame.Clear();
+            }
+
             // Throw DirectShow Camera Exception
             if (!result) ThrowDirectShowException();
 
@@ -536,6 +542,36 @@ namespace DirectShowCamera
         return m_directShowCamera->getCurrentGrabberFormat();
     }
 
+    void Camera::setRawYUVCapture(const bool rawYUVCapture)
+    {
+        m_directShowCamera->setRawYUVCapture(rawYUVCapture);
+    }
+
+    bool Camera::isRawYUVCapture() const
+    {
+        return m_directShowCamera->isRawYUVCapture();
+    }
+
+    void Camera::setRawMJPGCapture(const bool rawMJPGCapture)
+    {
+        m_directShowCamera->setRawMJPGCapture(rawMJPGCapture);
+    }
+
+    bool Camera::isRawMJPGCapture() const
+    {
+        return m_directShowCamera->isRawMJPGCapture();
+    }
+
+    void Camera::setRawRGBCapture(const bool rawRGBCapture)
+    {
+        m_directShowCamera->setRawRGBCapture(rawRGBCapture);
+    }
+
+    bool Camera::isRawRGBCapture() const
+    {
+        return m_directShowCamera->isRawRGBCapture();
+    }
+
 #pragma endregion DirectShow Video Format
 
 #pragma region Frame
@@ -561,30 +597,113 @@ namespace DirectShowCamera
         const long bufferSize = m_directShowCamera->getFrameTotalSize();
         const auto frameType = m_directShowCamera->getFrameType();
 
-        // Get frame
-        frame.ImportData(
+        // The palette of the RGB8 frame comes with the video format
+        FrameSettings frameSettings = m_frameSettings;
+        const auto palette = m_directShowCamera->getPalette();
+        if (palette) frameSettings.Palette = palette;
+
+        // Get frame by exchanging buffer, no copy. The exchanged frame is kept for the other Frames in the same lock.
+        std::lock_guard<std::mutex> lock(m_exchangedFrameMutex);
+        const bool isTripleBuffer = m_directShowCamera->getFrameBufferMode() == FrameBufferMode::TripleBuffer;
+        bool success = frame.ExchangeData(
             bufferSize,
             width,
             height,
             frameType,
-            m_frameSettings,
-            [this, onlyGetNewFrame](unsigned char* data, unsigned long& frameIndex)
-            {   
-                int numOfBytes;
-                bool success = m_directShowCamera->getFrame(
-                    data, 
+            frameSettings,
+            [this](FrameBuffer& data, int& numOfBytes, unsigned long& frameIndex, FrameTimestamp& timestamp)
+            {
+                return m_directShowCamera->exchangeFrame(
+                    data,
                     numOfBytes,
-                    frameIndex
+                    frameIndex,
+                    &timestamp
                 );
-            }
+            },
+            m_framePool
         );
 
+        if (success)
+        {
+            if (isTripleBuffer) m_exchangedFrame = frame;
+        }
+        else
+        {
+            // The newest frame has already been handed over to this frame
+            if (isTripleBuffer &&
+                !frame.isEmpty() &&
+                frame.getFrameIndex() == m_directShowCamera->getLastFrameIndex() &&
+                frame.getFrameSize() == bufferSize
+            )
+            {
+                return true;
+            }
+
+            // The newest frame has already been handed over to another frame, share its data
+            if (isTripleBuffer &&
+                !m_exchangedFrame.isEmpty() &&
+                m_exchangedFrame.getFrameIndex() == m_directShowCamera->getLastFrameIndex() &&
+                m_exchangedFrame.getFrameSize() == bufferSize
+            )
+            {
+                frame = m_exchangedFrame;
+                frame.getFrameSettings() = frameSettings;
+                m_lastFrameIndex = frame.getFrameIndex();
+                return true;
+            }
+
+            // Get frame by copying
+            frame.ImportData(
+                bufferSize,
+                width,
+                height,
+                frameType,
+                frameSettings,
+                [this, &success](unsigned char* data, unsigned long& frameIndex, FrameTimestamp& timestamp)
+                {
+                    int numOfBytes;
+                    success = m_directShowCamera->getFrame(
+                        data,
+                        numOfBytes,
+                        frameIndex,
+                        &timestamp
+                    );
+                },
+                m_framePool
+            );
+            if (!success) return false;
+        }
+
         // Update frame index
         m_lastFrameIndex = frame.getFrameIndex();
 
         return true;
     }
 
+    bool Camera::getFrameLease(FrameLease& lease, const bool onlyGetNewFrame)
+    {
+        // Check
+        if (!m_directShowCamera->isCapturing()) return false;
+
+        // Check frame index if user only want a new Frame
+        if (onlyGetNewFrame)
+        {
+            if (m_lastFrameIndex == m_directShowCamera->getLastFrameIndex())
+            {
+                // No new frame
+                return false;
+            }
+        }
+
+        // Lease frame
+        if (!m_directShowCamera->leaseFrame(lease)) return false;
+
+        // Update frame index
+        m_lastFrameIndex = lease.getFrameIndex();
+
+        return true;
+    }
+
     bool Camera::getNewFrame(Frame& frame, const int step, const int timeout, const int skip)
     {
         const unsigned long lastFrameIndex = m_lastFrameIndex;
@@ -596,36 +715,48 @@ namespace DirectShowCamera
             expectedFrameIndexOverFlow = true;
         }
 
-        int pastTime = 0;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+        unsigned long waitAfterFrameIndex = lastFrameIndex;
 
         // Wait for new frame
         while (
-            (
-                (expectedFrameIndexOverFlow && m_lastFrameIndex > 2147483647) ||
-                (m_lastFrameIndex < expectedFrameIndex)
-            ) &&
-            pastTime <= timeout
+            (expectedFrameIndexOverFlow && m_lastFrameIndex > 2147483647) ||
+            (m_lastFrameIndex < expectedFrameIndex)
         )
         {
-            // Sleep
-            std::this_thread::sleep_for(std::chrono::milliseconds(step));
+            // Timeout
+            const auto now = std::chrono::steady_clock::now();
+            if (now > deadline) return false;
 
-            // Get frame and update the last frame index
-            const auto success = getFrame(frame, true);
+            // Wait until the next frame is published. Wake up at least every step to recheck.
+            const auto stepDeadline = now + std::chrono::milliseconds(step);
+            if (!waitForFrame(waitAfterFrameIndex, stepDeadline < deadline ? stepDeadline : deadline))
+            {
+                if (!m_directShowCamera->isCapturing()) return false;
+                continue;
+            }
 
-            // Update past time
-            pastTime += step;
+            // Get frame and update the last frame index
+            if (getFrame(frame, true))
+            {
+                waitAfterFrameIndex = m_lastFrameIndex;
+            }
+            else
+            {
+                // The frame can't be taken (e.g. it has been handed over). Wait for the next one.
+                waitAfterFrameIndex = m_directShowCamera->getLastFrameIndex();
+            }
         }
 
-        // Return
-        if (pastTime > timeout)
-        {
-            return false;
-        }
-        else
-        {
-            return true;
-        }
+        return true;
+    }
+
+    bool Camera::waitForFrame(const unsigned long afterFrameIndex, const std::chrono::steady_clock::time_point deadline)
+    {
+        // Check
+        if (!m_directShowCamera->isCapturing()) return false;
+
+        return m_directShowCamera->waitForFrame(afterFrameIndex, deadline);
     }
 
     long Camera::getLastFrameIndex() const
@@ -638,6 +769,57 @@ namespace DirectShowCamera
         return m_directShowCamera->getFPS();
     }
 
+    void Camera::setFrameBufferMode(const FrameBufferMode mode)
+    {
+        m_directShowCamera->setFrameBufferMode(mode);
+    }
+
+    FrameBufferMode Camera::getFrameBufferMode() const
+    {
+        return m_directShowCamera->getFrameBufferMode();
+    }
+
+    void Camera::setFrameRingBuffer(const int capacity, const FrameOverflowPolicy overflowPolicy)
+    {
+        // Check
+        if (capacity <= 0) throw std::invalid_argument("Ring buffer capacity(" + std::to_string(capacity) + ") can't be <= 0.");
+
+        m_directShowCamera->setFrameRingBuffer(capacity, overflowPolicy);
+    }
+
+    int Camera::getFrameRingBufferCapacity() const
+    {
+        return m_directShowCamera->getFrameRingBufferCapacity();
+    }
+
+    FrameOverflowPolicy Camera::getFrameOverflowPolicy() const
+    {
+        return m_directShowCamera->getFrameOverflowPolicy();
+    }
+
+    void Camera::setMaxFrameLeases(const int maxFrameLeases)
+    {
+        // Check
+        if (maxFrameLeases <= 0) throw std::invalid_argument("Maximum number of frame leases(" + std::to_string(maxFrameLeases) + ") can't be <= 0.");
+
+        m_directShowCamera->setMaxFrameLeases(maxFrameLeases);
+    }
+
+    int Camera::getMaxFrameLeases() const
+    {
+        return m_directShowCamera->getMaxFrameLeases();
+    }
+
+    FrameBufferStatistics Camera::getFrameBufferStatistics() const
+    {
+        return m_directShowCamera->getFrameBufferStatistics();
+    }
+
+    std::shared_ptr<FramePool> Camera::getFramePool() const
+    {
+        return m_framePool;
+    }
+
 #pragma region Opencv Function
 
 #ifdef WITH_OPENCV2
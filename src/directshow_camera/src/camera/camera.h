@@ -39,9 +39,11 @@
 
 #include "directshow_camera/camera/ds_camera.h"
 
+#include <chrono>
 #include <functional>
 #include <optional>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 // Include Opencv
@@ -195,24 +197,85 @@ namespace DirectShowCamera
         */
         bool setDirectShowVideoFormat(const DirectShowVideoFormat videoFormat);
 
+        /**
+         * @brief   Capture the YUV video formats (e.g. YUY2, UYVY) without converting them to RGB24 in the DirectShow graph. The frames are converted
+         *          by FrameDecoder when they are used, e.g. Frame::getMat(), in the color space of FrameSettings::ColorSpace. Default as false.
+         * @param[in] rawYUVCapture Set as true to capture the raw YUV frames. It is applied when the capture is started or the video format is set.
+        */
+        void setRawYUVCapture(const bool rawYUVCapture);
+
+        /**
+         * @brief Return true if the YUV video formats are captured without conversion
+         * @return Return true if the YUV video formats are captured without conversion
+        */
+        bool isRawYUVCapture() const;
+
+        /**
+         * @brief   Capture the MJPEG video format without decoding it in the DirectShow graph. The frames are decoded by FrameDecoder when they are used,
+         *          e.g. Frame::getMat(), and the restart interval segments are decoded in parallel. Default as false.
+         * @param[in] rawMJPGCapture Set as true to capture the compressed MJPEG frames. It is applied when the capture is started or the video format is set.
+        */
+        void setRawMJPGCapture(const bool rawMJPGCapture);
+
+        /**
+         * @brief Return true if the MJPEG video format is captured without decoding
+         * @return Return true if the MJPEG video format is captured without decoding
+        */
+        bool isRawMJPGCapture() const;
+
+        /**
+         * @brief   Capture the RGB8, RGB565 and RGB555 video formats without converting them to RGB24 in the DirectShow graph. The frames are expanded
+         *          by FrameDecoder when they are used, e.g. Frame::getMat(). The palette of RGB8 is read from the video format. Default as false.
+         * @param[in] rawRGBCapture Set as true to capture the raw RGB frames. It is applied when the capture is started or the video format is set.
+        */
+        void setRawRGBCapture(const bool rawRGBCapture);
+
+        /**
+         * @brief Return true if the RGB8, RGB565 and RGB555 video formats are captured without conversion
+         * @return Return true if the RGB8, RGB565 and RGB555 video formats are captured without conversion
+        */
+        bool isRawRGBCapture() const;
+
 #pragma endregion DirectShow Video Format
 
 #pragma region Frame
 
         /**
-         * @brief Get frame
+         * @brief   Get frame. If the frame buffer supports it (FrameBufferMode::TripleBuffer or FrameBufferMode::Ring), the frame buffer is exchanged
+         *          with the frame in the grabber so that no copy is made. In FrameBufferMode::TripleBuffer, getting the same frame again into another Frame object
+         *          shares the data of the frame which it was handed over to, see Frame copy-on-write, so any Frame can always get the latest frame.
+         *          In FrameBufferMode::Ring, the oldest queued frame is returned and it returns false if no frame is queued.
+         *          In FrameBufferMode::Lease, the frame is copied from the held media sample. Use getFrameLease() to read it without copying.
          * @param[out] frame Frame
-         * @param[out] numOfBytes Number of bytes of the frame.
          * @param[in] onlyGetNewFrame (Optional) Set it as true if you only want to get the new frame which has not been get by getFrame. Default as false
          * @return Return true if success. If the frame is a old frame and onlyGetNewFrame is true, it will return false.
         */
         bool getFrame(Frame& frame, const bool onlyGetNewFrame = false);
 
+        /**
+         * @brief   Lease the current frame in FrameBufferMode::Lease. The lease reads the DirectShow media sample directly, no copy is made.
+         *          The sample is held until the lease is released or destroyed, release it as soon as possible so that the camera doesn't run out of buffers.
+         *          The frame is in the format of getFrameType() and in the size of getFrameSize().
+         * @param[out] lease Lease of the current frame. The previous frame in the lease is released.
+         * @param[in] onlyGetNewFrame (Optional) Set it as true if you only want to lease the new frame which has not been get by getFrame or getFrameLease. Default as false
+         * @return Return true if success. Return false if it is not in FrameBufferMode::Lease, or the frame is a old frame and onlyGetNewFrame is true.
+        */
+        bool getFrameLease(FrameLease& lease, const bool onlyGetNewFrame = false);
+
+        /**
+         * @brief   Block until a frame newer than afterFrameIndex is captured or the deadline is reached.
+         *          It wakes up as soon as the frame is published by the camera, no polling is involved.
+         * @param[in] afterFrameIndex Frame index which has been seen, e.g. getLastFrameIndex()
+         * @param[in] deadline Time to give up waiting
+         * @return Return true if a new frame is available. Return false if timeout or the camera is not capturing.
+        */
+        bool waitForFrame(const unsigned long afterFrameIndex, const std::chrono::steady_clock::time_point deadline);
+
         /**
          * @brief   Try to get a new Frame in sync mode. It will return the new frame if existed.
          *          Otherwise, it will wait for the new frame and then return. If timeout, it will return false
          * @param[out] frame Frame
-         * @param[in] step (Optional) Step for checking new frame in ms. Default as 50ms
+         * @param[in] step (Optional) Maximum interval between checks of the new frame in ms. The wait wakes up as soon as a new frame arrives. Default as 50ms
          * @param[in] timeout (Optional) Timeout in ms. Default as 3000ms
          * @param[in] skip (Optional) Number of new Frame to be skipped. For example, if skip = 3, the fourth new frame will be returned. Default as 0.
          * @return Return true if success. If timeout, it will return false.
@@ -267,6 +330,64 @@ namespace DirectShowCamera
         */
         FrameSettings& getFrameSettings();
 
+        /**
+         * @brief Set the frame buffer mode which hands frames from the DirectShow streaming thread to getFrame(). Default as FrameBufferMode::TripleBuffer.
+         * @param[in] mode Frame buffer mode. If the camera is capturing, it will be applied after the capture is stopped.
+        */
+        void setFrameBufferMode(const FrameBufferMode mode);
+
+        /**
+         * @brief Get the frame buffer mode
+         * @return Return the frame buffer mode
+        */
+        FrameBufferMode getFrameBufferMode() const;
+
+        /**
+         * @brief   Set the ring buffer used in FrameBufferMode::Ring. In ring mode, getFrame() returns every frame in order
+         *          and frames are only dropped by the overflow policy when the consumer falls behind.
+         * @param[in] capacity Maximum number of queued frames. Default as 8. If the camera is capturing, it will be applied after the capture is stopped.
+         * @param[in] overflowPolicy What to do when a frame arrives and the ring buffer is full. Default as FrameOverflowPolicy::DropOldest
+        */
+        void setFrameRingBuffer(const int capacity, const FrameOverflowPolicy overflowPolicy = FrameOverflowPolicy::DropOldest);
+
+        /**
+         * @brief Get the maximum number of queued frames in FrameBufferMode::Ring
+         * @return Return the maximum number of queued frames
+        */
+        int getFrameRingBufferCapacity() const;
+
+        /**
+         * @brief Get the overflow policy of the ring buffer
+         * @return Return the overflow policy
+        */
+        FrameOverflowPolicy getFrameOverflowPolicy() const;
+
+        /**
+         * @brief   Set the maximum number of frames held in FrameBufferMode::Lease, including the newest frame kept by the frame buffer.
+         *          New frames are dropped when the cap is reached so that the DirectShow allocator never runs out of buffers.
+         * @param[in] maxFrameLeases Maximum number of held frames. Default as 2
+        */
+        void setMaxFrameLeases(const int maxFrameLeases);
+
+        /**
+         * @brief Get the maximum number of frames held in FrameBufferMode::Lease
+         * @return Return the maximum number of held frames
+        */
+        int getMaxFrameLeases() const;
+
+        /**
+         * @brief Get the frame buffer statistics, such as the number of frames produced, consumed and dropped and the contention between the streaming thread and getFrame().
+         * @return Return the frame buffer statistics
+        */
+        FrameBufferStatistics getFrameBufferStatistics() const;
+
+        /**
+         * @brief Get the pool recycling the frame buffers of this camera. A Frame returns its buffer to the pool when it is destroyed,
+         *        so that getFrame() doesn't allocate in the steady state.
+         * @return Return the frame pool
+        */
+        std::shared_ptr<FramePool> getFramePool() const;
+
 #ifdef WITH_OPENCV2
 
         /**
@@ -379,6 +500,14 @@ namespace DirectShowCamera
         bool m_isInitialized = false;
 
         unsigned long m_lastFrameIndex = 0;
+        std::shared_ptr<FramePool> m_framePool = std::make_shared<FramePool>();
+
+        /**
+        * Last frame handed over by the exchange in FrameBufferMode::TripleBuffer. It shares the data with the Frame it was handed over to,
+        * so that another Frame can get the same frame after the grabber has given it away.
+        */
+        Frame m_exchangedFrame;
+        std::mutex m_exchangedFrameMutex;
 
         std::shared_ptr<CameraPropertyBrightness> m_brightness;
         std::shared_ptr<CameraPropertyContrast> m_contrast;
@@ -35,6 +35,7 @@ namespace DirectShowCamera
         m_stopThread = false;
         m_stopCapture = false;
         m_waitForStopTimeout = 3000;
+        m_pacingFPS = 0;
         m_capturedFrame.Clear();
     }
 
@@ -52,6 +53,7 @@ namespace DirectShowCamera
 
             // Start the thread
             m_stopThread = false;
+            m_numOfWakeUps = 0;
             m_thread = std::thread(&CameraThread::Run, this);
             m_thread.detach();
 
@@ -105,13 +107,41 @@ namespace DirectShowCamera
         // Set as running
         m_isRunning = true;
 
+        auto nextFrameTime = std::chrono::steady_clock::now();
+
         while (!m_stopThread)
         {
+            m_numOfWakeUps++;
+
             if (m_camera)
             {
                 // Open camera
                 if (m_camera->isOpened())
                 {
+                    // Pacing
+                    if (m_pacingFPS > 0)
+                    {
+                        const auto now = std::chrono::steady_clock::now();
+                        if (nextFrameTime > now)
+                        {
+                            // Sleep in short intervals so that the stop request is not delayed
+                            const auto maxSleepTime = now + std::chrono::milliseconds(WAIT_FOR_FRAME_INTERVAL);
+                            std::this_thread::sleep_until(nextFrameTime < maxSleepTime ? nextFrameTime : maxSleepTime);
+                            continue;
+                        }
+                    }
+
+                    // Wait for a new frame. Wake up regularly to check the stop request.
+                    const bool hasNewFrame = m_camera->waitForFrame(
+                        m_camera->getLastFrameIndex(),
+                        std::chrono::steady_clock::now() + std::chrono::milliseconds(WAIT_FOR_FRAME_INTERVAL)
+                    );
+                    if (!hasNewFrame)
+                    {
+                        // Not capturing, wait until the capture is started
+                        if (!m_camera->isCapturing()) std::this_thread::sleep_for(std::chrono::milliseconds(WAIT_FOR_FRAME_INTERVAL));
+                        continue;
+                    }
 
                     // Get Image
                     bool success = m_camera->getFrame(m_capturedFrame, true);
@@ -131,9 +161,9 @@ namespace DirectShowCamera
                             // Save
                             if (m_saveImageInAsync)
                             {
-                                // Save image in async mode
-                                std::thread t([this, imagePath]() {
-                                    m_capturedFrame.Save(imagePath);
+                                // Save image in async mode. The frame copy shares the data, so the next frame can be captured while saving.
+                                std::thread t([frame = m_capturedFrame, imagePath]() mutable {
+                                    frame.Save(imagePath);
                                 }
                                 );
                                 t.detach();
@@ -150,6 +180,14 @@ namespace DirectShowCamera
                         {
                             m_capturedProcess(m_capturedFrame);
                         }
+
+                        // Schedule the next frame. Don't catch up on the frames missed by a slow process.
+                        if (m_pacingFPS > 0)
+                        {
+                            const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / m_pacingFPS));
+                            const auto now = std::chrono::steady_clock::now();
+                            nextFrameTime = nextFrameTime + interval > now ? nextFrameTime + interval : now;
+                        }
                     }
                 }
                 else
@@ -195,6 +233,25 @@ namespace DirectShowCamera
         return m_waitForStopTimeout;
     }
 
+    void CameraThread::setPacingFPS(const double fps)
+    {
+        // Exception
+        if (fps < 0)
+            throw std::invalid_argument("fps(" + std::to_string(fps) + ") must be >= 0.");
+
+        m_pacingFPS = fps;
+    }
+
+    double CameraThread::getPacingFPS() const
+    {
+        return m_pacingFPS;
+    }
+
+    unsigned long long CameraThread::getNumOfWakeUps() const
+    {
+        return m_numOfWakeUps.load();
+    }
+
 #pragma endregion Thread control
 
 #pragma region Save Image
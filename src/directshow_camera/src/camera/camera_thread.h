@@ -17,6 +17,8 @@
 #include <opencv2/opencv.hpp>
 #endif
 
+#include <atomic>
+#include <chrono>
 #include <thread>
 #include <string>
 #include <functional>
@@ -26,6 +28,7 @@ namespace DirectShowCamera
 {
     /**
      * @brief A Thread for Camera to continuously capture images.
+     *        The thread sleeps until the camera publishes a new frame, so it doesn't consume CPU between frames.
      * 
      */
     class CameraThread {
@@ -99,6 +102,28 @@ namespace DirectShowCamera
          */
         int getWaitForStopTimeout() const;
 
+        /**
+         * @brief Limit the rate of processing frames. Frames arrived in between are skipped and only the newest frame is processed.
+         *
+         * @param[in] fps Maximum number of processed frames per second. Set as 0 to process every new frame. Default as 0.
+         */
+        void setPacingFPS(const double fps);
+
+        /**
+         * @brief Get the maximum number of processed frames per second
+         *
+         * @return Return the maximum number of processed frames per second. Return 0 if every new frame is processed.
+         */
+        double getPacingFPS() const;
+
+        /**
+         * @brief Get the number of times the thread has woken up since Start(), by a new frame, the wait interval or the pacing.
+         *        The thread blocks between frames, so it is about the number of frames arrived.
+         *
+         * @return Return the number of wake-ups
+         */
+        unsigned long long getNumOfWakeUps() const;
+
 #pragma endregion Thread control
 
 #pragma region Save Image
@@ -147,11 +172,16 @@ namespace DirectShowCamera
         void Reset();
 
     private:
+        // Maximum time to wait for a new frame before checking the stop request again
+        static constexpr int WAIT_FOR_FRAME_INTERVAL = 100;
+
         bool m_stopThread = false;
         bool m_stopCapture = false;
         bool m_isRunning = false;
         std::thread m_thread;
         int m_waitForStopTimeout = 3000;
+        double m_pacingFPS = 0;
+        std::atomic<unsigned long long> m_numOfWakeUps = 0;
 
         std::string m_saveImagePath;
         bool m_saveImage = false;
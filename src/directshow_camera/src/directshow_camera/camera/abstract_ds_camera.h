@@ -15,6 +15,11 @@
 
 #include "directshow_camera/device/ds_camera_device.h"
 
+#include "buffer/frame_buffer_engine.h"
+#include "frame/frame_settings.h"
+
+#include <chrono>
+#include <memory>
 #include <optional>
 
 namespace DirectShowCamera
@@ -47,17 +52,45 @@ namespace DirectShowCamera
         (
             unsigned char* pixels,
             int& numOfBytes,
-            unsigned long& frameIndex
+            unsigned long& frameIndex,
+            FrameTimestamp* timestamp = nullptr
         ) {
             numOfBytes = 0;
             frameIndex = 0;
             return false;
         }
+        virtual bool exchangeFrame
+        (
+            FrameBuffer& pixels,
+            int& numOfBytes,
+            unsigned long& frameIndex,
+            FrameTimestamp* timestamp = nullptr
+        ) {
+            return false;
+        }
+        virtual bool leaseFrame(FrameLease& lease) {
+            return false;
+        }
+        virtual bool waitForFrame(
+            const unsigned long afterFrameIndex,
+            const std::chrono::steady_clock::time_point deadline
+        ) = 0;
         virtual unsigned long getLastFrameIndex() const = 0;
         virtual void setMinimumFPS(const double minimumFPS) = 0;
         virtual double getFPS() const = 0;
         virtual long getFrameTotalSize() const = 0;
         virtual GUID getFrameType() const = 0;
+        virtual std::shared_ptr<const RGBPalette> getPalette() const = 0;
+
+        // Frame buffer
+        virtual void setFrameBufferMode(const FrameBufferMode mode) = 0;
+        virtual FrameBufferMode getFrameBufferMode() const = 0;
+        virtual void setFrameRingBuffer(const int capacity, const FrameOverflowPolicy overflowPolicy) = 0;
+        virtual int getFrameRingBufferCapacity() const = 0;
+        virtual FrameOverflowPolicy getFrameOverflowPolicy() const = 0;
+        virtual void setMaxFrameLeases(const int maxFrameLeases) = 0;
+        virtual int getMaxFrameLeases() const = 0;
+        virtual FrameBufferStatistics getFrameBufferStatistics() const = 0;
 
         // Video Format
         virtual std::vector<DirectShowVideoFormat> getVideoFormatList() const = 0;
@@ -68,6 +101,13 @@ namespace DirectShowCamera
         virtual bool setVideoFormat(const DirectShowVideoFormat videoFormat) = 0;
         virtual bool setVideoFormat(const int videoFormatIndex) = 0;
 
+        virtual void setRawYUVCapture(const bool rawYUVCapture) = 0;
+        virtual bool isRawYUVCapture() const = 0;
+        virtual void setRawMJPGCapture(const bool rawMJPGCapture) = 0;
+        virtual bool isRawMJPGCapture() const = 0;
+        virtual void setRawRGBCapture(const bool rawRGBCapture) = 0;
+        virtual bool isRawRGBCapture() const = 0;
+
         // Property
         virtual void RefreshProperties() = 0;
         virtual std::shared_ptr<DirectShowCameraProperties> getProperties() const = 0;
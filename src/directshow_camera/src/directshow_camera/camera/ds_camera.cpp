@@ -11,6 +11,12 @@
 #include "directshow_camera/utils/ds_camera_utils.h"
 #include "directshow_camera/utils/com_lib_utils.h"
 
+#include "frame/frame_decoder.h"
+#include "frame/frame_subtype_registry.h"
+
+#include <algorithm>
+#include <cstring>
+
 namespace DirectShowCamera
 {
     
@@ -107,6 +113,10 @@ namespace DirectShowCamera
             m_directShowFilter = *directShowFilter;
 
             m_sampleGrabberCallback = new SampleGrabberCallback();
+            m_sampleGrabberCallback->setBufferMode(m_frameBufferMode);
+            m_sampleGrabberCallback->setRingBuffer(m_frameRingBufferCapacity, m_frameOverflowPolicy);
+            m_sampleGrabberCallback->setMaxOutstandingLeases(m_maxFrameLeases);
+
             // Create the capture graph builder
             if (result)
             {
@@ -372,7 +382,7 @@ namespace DirectShowCamera
                             
                             // Check last frame time
                             auto lastFrameTime = m_sampleGrabberCallback->getLastFrameCaptureTime();
-                            auto timeDiff = (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - lastFrameTime)).count(); // in ms
+                            auto timeDiff = (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - lastFrameTime)).count(); // in ms
                             double fps = m_sampleGrabberCallback->getFPS();
                             double fpsInTime = 1.0 / fps * 1000;
 
@@ -461,6 +471,18 @@ namespace DirectShowCamera
 
                     // Stop the check disconnection thread
                     m_stopCheckConnectionThread = true;
+
+                    // Apply the frame buffer settings which were set while capturing. In lease mode, it also returns the held media sample to the allocator.
+                    if (m_sampleGrabberCallback &&
+                        (m_sampleGrabberCallback->getBufferMode() != m_frameBufferMode || m_frameBufferMode == FrameBufferMode::Lease)
+                    )
+                    {
+                        m_sampleGrabberCallback->setBufferMode(m_frameBufferMode);
+                    }
+                    if (m_sampleGrabberCallback && m_sampleGrabberCallback->getRingBufferCapacity() != m_frameRingBufferCapacity)
+                    {
+                        m_sampleGrabberCallback->setRingBuffer(m_frameRingBufferCapacity, m_frameOverflowPolicy);
+                    }
                 }
             }
             else
@@ -487,7 +509,8 @@ namespace DirectShowCamera
     (
         unsigned char* frame,
         int& numOfBytes,
-        unsigned long& frameIndex
+        unsigned long& frameIndex,
+        FrameTimestamp* timestamp
     )
     {
         // Check
@@ -495,9 +518,42 @@ namespace DirectShowCamera
         if (frame == nullptr) return false;
 
         // Get frame
-        m_sampleGrabberCallback->getFrame(frame, numOfBytes, frameIndex);
+        return m_sampleGrabberCallback->getFrame(frame, numOfBytes, frameIndex, timestamp);
+    }
+
+    bool DirectShowCamera::exchangeFrame
+    (
+        FrameBuffer& pixels,
+        int& numOfBytes,
+        unsigned long& frameIndex,
+        FrameTimestamp* timestamp
+    )
+    {
+        // Check
+        if (!m_isCapturing) return false;
+
+        // Exchange frame
+        return m_sampleGrabberCallback->exchangeFrame(pixels, numOfBytes, frameIndex, timestamp);
+    }
+
+    bool DirectShowCamera::leaseFrame(FrameLease& lease)
+    {
+        // Check
+        if (!m_isCapturing) return false;
+
+        // Lease frame
+        return m_sampleGrabberCallback->leaseFrame(lease);
+    }
+
+    bool DirectShowCamera::waitForFrame(
+        const unsigned long afterFrameIndex,
+        const std::chrono::steady_clock::time_point deadline
+    )
+    {
+        // Check
+        if (!m_isCapturing) return false;
 
-        return true;
+        return m_sampleGrabberCallback->waitForFrame(afterFrameIndex, deadline);
     }
 
     unsigned long DirectShowCamera::getLastFrameIndex() const
@@ -554,8 +610,91 @@ namespace DirectShowCamera
         return m_grabberMediaSubType;
     }
 
+    std::shared_ptr<const RGBPalette> DirectShowCamera::getPalette() const
+    {
+        return m_palette;
+    }
+
 #pragma endregion Frame
 
+#pragma region Frame Buffer
+
+    void DirectShowCamera::setFrameBufferMode(const FrameBufferMode mode)
+    {
+        m_frameBufferMode = mode;
+
+        // Apply now if the streaming thread is not running
+        if (m_sampleGrabberCallback && !m_isCapturing)
+        {
+            m_sampleGrabberCallback->setBufferMode(m_frameBufferMode);
+        }
+    }
+
+    FrameBufferMode DirectShowCamera::getFrameBufferMode() const
+    {
+        return m_frameBufferMode;
+    }
+
+    void DirectShowCamera::setFrameRingBuffer(const int capacity, const FrameOverflowPolicy overflowPolicy)
+    {
+        m_frameRingBufferCapacity = capacity;
+        m_frameOverflowPolicy = overflowPolicy;
+
+        if (m_sampleGrabberCallback)
+        {
+            if (!m_isCapturing)
+            {
+                // Apply now if the streaming thread is not running
+                m_sampleGrabberCallback->setRingBuffer(m_frameRingBufferCapacity, m_frameOverflowPolicy);
+            }
+            else if (m_sampleGrabberCallback->getRingBufferCapacity() == m_frameRingBufferCapacity)
+            {
+                // Overflow policy can be changed while streaming
+                m_sampleGrabberCallback->setRingBuffer(m_frameRingBufferCapacity, m_frameOverflowPolicy);
+            }
+        }
+    }
+
+    int DirectShowCamera::getFrameRingBufferCapacity() const
+    {
+        return m_frameRingBufferCapacity;
+    }
+
+    FrameOverflowPolicy DirectShowCamera::getFrameOverflowPolicy() const
+    {
+        return m_frameOverflowPolicy;
+    }
+
+    void DirectShowCamera::setMaxFrameLeases(const int maxFrameLeases)
+    {
+        m_maxFrameLeases = maxFrameLeases;
+
+        // The lease cap can be changed while streaming
+        if (m_sampleGrabberCallback)
+        {
+            m_sampleGrabberCallback->setMaxOutstandingLeases(m_maxFrameLeases);
+        }
+    }
+
+    int DirectShowCamera::getMaxFrameLeases() const
+    {
+        return m_maxFrameLeases;
+    }
+
+    FrameBufferStatistics DirectShowCamera::getFrameBufferStatistics() const
+    {
+        if (m_sampleGrabberCallback)
+        {
+            return m_sampleGrabberCallback->getBufferStatistics();
+        }
+        else
+        {
+            return FrameBufferStatistics();
+        }
+    }
+
+#pragma endregion Frame Buffer
+
 #pragma region Video Format
 
     void DirectShowCamera::UpdateGrabberFilterVideoFormat()
@@ -565,14 +704,36 @@ namespace DirectShowCamera
             // Get frame size
             int frameTotalSize = 0;
             GUID mediaSubType;
+            bool variableFrameSize = false;
+            std::shared_ptr<const RGBPalette> palette = nullptr;
             DirectShowCameraUtils::AmMediaTypeDecorator(m_amStreamConfig,
-                [this, &frameTotalSize, &mediaSubType](AM_MEDIA_TYPE* mediaType)
+                [this, &frameTotalSize, &mediaSubType, &variableFrameSize, &palette](AM_MEDIA_TYPE* mediaType)
                 {
                     VIDEOINFOHEADER* videoInfoHeader = reinterpret_cast<VIDEOINFOHEADER*>(mediaType->pbFormat);
                     int width = videoInfoHeader->bmiHeader.biWidth;
                     int height = videoInfoHeader->bmiHeader.biHeight;
 
-                    if (DirectShowVideoFormatUtils::isSupportRGBConvertion(mediaType->subtype))
+                    if (m_rawYUVCapture && FrameDecoder::isYUVFrameType(mediaType->subtype))
+                    {
+                        // Keep the YUV frame, it is converted by FrameDecoder when it is used. The planes of a YUV 4:2:0 frame are packed without padding.
+                        frameTotalSize = width * height * FrameSubtypeRegistry::Find(mediaType->subtype)->BitsPerPixel / 8;
+                        mediaSubType = mediaType->subtype;
+                    }
+                    else if (m_rawRGBCapture && mediaType->subtype != MEDIASUBTYPE_RGB24 && FrameDecoder::isRGBFrameType(mediaType->subtype))
+                    {
+                        // Keep the 8 and 16 bits RGB frame, it is expanded by FrameDecoder when it is used.
+                        frameTotalSize = width * height * FrameSubtypeRegistry::Find(mediaType->subtype)->BitsPerPixel / 8;
+                        mediaSubType = mediaType->subtype;
+                        if (mediaType->subtype == MEDIASUBTYPE_RGB8) palette = ReadPalette(mediaType);
+                    }
+                    else if (m_rawMJPGCapture && FrameDecoder::isMJPGFrameType(mediaType->subtype))
+                    {
+                        // Keep the compressed frame, it is decoded by FrameDecoder when it is used. The frame size varies, so it is stored in a RGB24 sized buffer.
+                        frameTotalSize = width * height * 3;
+                        mediaSubType = mediaType->subtype;
+                        variableFrameSize = true;
+                    }
+                    else if (DirectShowVideoFormatUtils::isSupportRGBConvertion(mediaType->subtype))
                     {
                         // Todo: Now we focus SampleGrabber to convert Frame into RGB24. We should change it to change it support other format.
                         
@@ -603,6 +764,7 @@ namespace DirectShowCamera
             if (hr == S_OK)
             {
                 m_grabberMediaSubType = mediaSubType;
+                m_palette = palette;
 
                 // get video format of grabber filter - this can fail if the graph is not yet connected
                 hr = m_sampleGrabber->GetConnectedMediaType(&grabberMediaType);
@@ -613,10 +775,11 @@ namespace DirectShowCamera
 
                 // Set buffer size
                 m_sampleGrabberCallback->setBufferSize(frameTotalSize);
+                m_sampleGrabberCallback->setVariableFrameSize(variableFrameSize);
             }
             else
             {
-                m_errorString = "Could not set media type to RGB24.(hr = " + std::to_string(hr) + ").";
+                m_errorString = "Could not set media type to " + DirectShowVideoFormatUtils::ToString(mediaSubType) + ".(hr = " + std::to_string(hr) + ").";
             }
 
             DirectShowCameraUtils::FreeMediaType(grabberMediaType);
@@ -772,6 +935,54 @@ namespace DirectShowCamera
         return result;
     }
 
+    void DirectShowCamera::setRawYUVCapture(const bool rawYUVCapture)
+    {
+        m_rawYUVCapture = rawYUVCapture;
+    }
+
+    bool DirectShowCamera::isRawYUVCapture() const
+    {
+        return m_rawYUVCapture;
+    }
+
+    void DirectShowCamera::setRawMJPGCapture(const bool rawMJPGCapture)
+    {
+        m_rawMJPGCapture = rawMJPGCapture;
+    }
+
+    bool DirectShowCamera::isRawMJPGCapture() const
+    {
+        return m_rawMJPGCapture;
+    }
+
+    void DirectShowCamera::setRawRGBCapture(const bool rawRGBCapture)
+    {
+        m_rawRGBCapture = rawRGBCapture;
+    }
+
+    bool DirectShowCamera::isRawRGBCapture() const
+    {
+        return m_rawRGBCapture;
+    }
+
+    std::shared_ptr<const RGBPalette> DirectShowCamera::ReadPalette(const AM_MEDIA_TYPE* mediaType)
+    {
+        // The palette follows the VIDEOINFOHEADER, biClrUsed is 0 if all 256 colors are used
+        if (mediaType->formattype != FORMAT_VideoInfo || mediaType->pbFormat == NULL || mediaType->cbFormat < SIZE_VIDEOHEADER) return nullptr;
+
+        const VIDEOINFO* videoInfo = reinterpret_cast<const VIDEOINFO*>(mediaType->pbFormat);
+        int numOfColors = videoInfo->bmiHeader.biClrUsed == 0 ? 256 : (int)std::min(videoInfo->bmiHeader.biClrUsed, (DWORD)256);
+        numOfColors = std::min(numOfColors, (int)((mediaType->cbFormat - SIZE_VIDEOHEADER) / sizeof(RGBQUAD)));
+        if (numOfColors <= 0) return nullptr;
+
+        // Unused entries are black
+        auto palette = std::make_shared<RGBPalette>();
+        palette->fill(0);
+        memcpy(palette->data(), videoInfo->bmiColors, numOfColors * sizeof(RGBQUAD));
+
+        return palette;
+    }
+
 #pragma endregion Video Format
 
 #pragma region Properties
@@ -136,13 +136,50 @@ namespace DirectShowCamera
          * @param[out] frame Frame bytes
          * @param[out] numOfBytes Number of bytes of the frames.
          * @param[out] frameIndex Index of frame, use to indicate whether a new frame.
+         * @param[out] timestamp (Optional) Capture timestamps of the frame. Default as nullptr
          * @return Return true if success.
         */
         bool getFrame
         (
             unsigned char* pixels,
             int& numOfBytes,
-            unsigned long& frameIndex
+            unsigned long& frameIndex,
+            FrameTimestamp* timestamp = nullptr
+        ) override;
+
+        /**
+         * @brief Hand the current frame over by exchanging buffers with the grabber. No copy is made.
+         * @param[in,out] pixels In: a buffer to be reused by the grabber, can be nullptr. Out: the current frame.
+         * @param[in,out] numOfBytes In: size of the input buffer. Out: Number of bytes of the frame.
+         * @param[out] frameIndex Index of frame, use to indicate whether a new frame.
+         * @param[out] timestamp (Optional) Capture timestamps of the frame. Default as nullptr
+         * @return Return true if success. Return false if the buffer can't be exchanged (e.g. FrameBufferMode::Mutex). In this case, nothing is changed.
+        */
+        bool exchangeFrame
+        (
+            FrameBuffer& pixels,
+            int& numOfBytes,
+            unsigned long& frameIndex,
+            FrameTimestamp* timestamp = nullptr
+        ) override;
+
+        /**
+         * @brief Lease the media sample of the current frame in FrameBufferMode::Lease. No copy is made.
+         *        The sample is held until the lease is released, release it as soon as possible.
+         * @param[out] lease Lease of the current frame
+         * @return Return true if success. Return false if it is not in FrameBufferMode::Lease or the camera is not capturing.
+        */
+        bool leaseFrame(FrameLease& lease) override;
+
+        /**
+         * @brief Block until a frame newer than afterFrameIndex is captured or the deadline is reached. It wakes up as soon as the frame is published by the sample grabber.
+         * @param[in] afterFrameIndex Frame index which has been seen by the consumer, e.g. getLastFrameIndex()
+         * @param[in] deadline Time to give up waiting
+         * @return Return true if a new frame is available. Return false if timeout or the camera is not capturing.
+        */
+        bool waitForFrame(
+            const unsigned long afterFrameIndex,
+            const std::chrono::steady_clock::time_point deadline
         ) override;
 
         /**
@@ -175,8 +212,67 @@ namespace DirectShowCamera
         */
         GUID getFrameType() const override;
 
+        /**
+         * @brief Get the palette of the current frame type. It is read from the video format if the frame type is MEDIASUBTYPE_RGB8.
+         * @return Return the palette. Return nullptr if the frame type has no palette.
+        */
+        std::shared_ptr<const RGBPalette> getPalette() const override;
+
 #pragma endregion Frame
 
+#pragma region Frame Buffer
+
+        /**
+         * @brief Set the frame buffer mode. It will be applied when the camera is opened or the capture is stopped.
+         * @param[in] mode Frame buffer mode. Default as FrameBufferMode::TripleBuffer
+        */
+        void setFrameBufferMode(const FrameBufferMode mode) override;
+
+        /**
+         * @brief Get the frame buffer mode
+         * @return Return the frame buffer mode
+        */
+        FrameBufferMode getFrameBufferMode() const override;
+
+        /**
+         * @brief Set the ring buffer used in FrameBufferMode::Ring. It will be applied when the camera is opened or the capture is stopped.
+         * @param[in] capacity Maximum number of queued frames. Default as 8
+         * @param[in] overflowPolicy What to do when a frame arrives and the ring buffer is full. Default as FrameOverflowPolicy::DropOldest
+        */
+        void setFrameRingBuffer(const int capacity, const FrameOverflowPolicy overflowPolicy) override;
+
+        /**
+         * @brief Get the maximum number of queued frames in FrameBufferMode::Ring
+         * @return Return the maximum number of queued frames
+        */
+        int getFrameRingBufferCapacity() const override;
+
+        /**
+         * @brief Get the overflow policy of the ring buffer
+         * @return Return the overflow policy
+        */
+        FrameOverflowPolicy getFrameOverflowPolicy() const override;
+
+        /**
+         * @brief Set the maximum number of frames held in FrameBufferMode::Lease, including the newest frame kept by the frame buffer. The media samples go back to the allocator once released, keep it less than the number of allocator buffers.
+         * @param[in] maxFrameLeases Maximum number of held frames. Default as 2
+        */
+        void setMaxFrameLeases(const int maxFrameLeases) override;
+
+        /**
+         * @brief Get the maximum number of frames held in FrameBufferMode::Lease
+         * @return Return the maximum number of held frames
+        */
+        int getMaxFrameLeases() const override;
+
+        /**
+         * @brief Get the frame buffer statistics. Return empty statistics if camera is not opened.
+         * @return Return the frame buffer statistics
+        */
+        FrameBufferStatistics getFrameBufferStatistics() const override;
+
+#pragma endregion Frame Buffer
+
 #pragma region Video Format
 
         /**
@@ -217,6 +313,45 @@ namespace DirectShowCamera
         */
         bool setVideoFormat(const int videoFormatIndex) override;
 
+        /**
+         * @brief Keep the YUV frames (See FrameDecoder::SupportYUVVideoType()) in YUV instead of converting them to RGB24 in the graph.
+         *        The frames are converted by FrameDecoder when they are used, so the streaming thread only copies the raw data. Default as false.
+         * @param[in] rawYUVCapture Set as true to capture the raw YUV frames. It is applied when the capture is started or the video format is set.
+        */
+        void setRawYUVCapture(const bool rawYUVCapture) override;
+
+        /**
+         * @brief Return true if the YUV frames are captured in YUV
+         * @return Return true if the YUV frames are captured in YUV
+        */
+        bool isRawYUVCapture() const override;
+
+        /**
+         * @brief Keep the MJPEG frames (See FrameDecoder::SupportMJPGVideoType()) compressed instead of decoding them in the graph.
+         *        The frames are decoded by FrameDecoder when they are used, the restart interval segments are decoded in parallel. Default as false.
+         * @param[in] rawMJPGCapture Set as true to capture the compressed MJPEG frames. It is applied when the capture is started or the video format is set.
+        */
+        void setRawMJPGCapture(const bool rawMJPGCapture) override;
+
+        /**
+         * @brief Return true if the MJPEG frames are captured compressed
+         * @return Return true if the MJPEG frames are captured compressed
+        */
+        bool isRawMJPGCapture() const override;
+
+        /**
+         * @brief Keep the RGB8, RGB565 and RGB555 frames in the capture format instead of converting them to RGB24 in the graph.
+         *        The frames are expanded by FrameDecoder when they are used, so the streaming thread copies less data. Default as false.
+         * @param[in] rawRGBCapture Set as true to capture the raw RGB frames. It is applied when the capture is started or the video format is set.
+        */
+        void setRawRGBCapture(const bool rawRGBCapture) override;
+
+        /**
+         * @brief Return true if the RGB8, RGB565 and RGB555 frames are captured in the capture format
+         * @return Return true if the RGB8, RGB565 and RGB555 frames are captured in the capture format
+        */
+        bool isRawRGBCapture() const override;
+
 #pragma endregion Video Format
 
 #pragma region Properties
@@ -316,6 +451,13 @@ namespace DirectShowCamera
         */
         void UpdateGrabberFilterVideoFormat();
 
+        /**
+         * @brief Read the palette of a RGB8 media type
+         * @param[in] mediaType Media type
+         * @return Return the palette. Return nullptr if the media type has no palette.
+        */
+        static std::shared_ptr<const RGBPalette> ReadPalette(const AM_MEDIA_TYPE* mediaType);
+
         /**
          * @brief Update video formats
         */
@@ -355,10 +497,18 @@ namespace DirectShowCamera
 
         DirectShowVideoFormatList m_videoFormats = DirectShowVideoFormatList();
         int m_currentVideoFormatIndex = -1;
+        bool m_rawYUVCapture = false;
+        bool m_rawMJPGCapture = false;
+        bool m_rawRGBCapture = false;
+        std::shared_ptr<const RGBPalette> m_palette = nullptr;
 
         // Callback
         ISampleGrabber* m_sampleGrabber = NULL;
         SampleGrabberCallback* m_sampleGrabberCallback = NULL;
+        FrameBufferMode m_frameBufferMode = FrameBufferMode::TripleBuffer;
+        int m_frameRingBufferCapacity = 8;
+        FrameOverflowPolicy m_frameOverflowPolicy = FrameOverflowPolicy::DropOldest;
+        int m_maxFrameLeases = 2;
         GUID m_grabberMediaSubType = MEDIASUBTYPE_None;
         DirectShowVideoFormat m_sampleGrabberVideoFormat;
 
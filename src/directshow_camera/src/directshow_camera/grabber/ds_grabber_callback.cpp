@@ -6,14 +6,15 @@
 
 #include "directshow_camera/grabber/ds_grabber_callback.h"
 
+#include <cmath>
+#include <cstring>
+
 namespace DirectShowCamera
 {
 
 #pragma region Constructor and Destructor
     SampleGrabberCallback::SampleGrabberCallback()
     {
-        // initialize buffer
-        m_pixelsBuffer = std::make_unique<unsigned char[]>(m_bufferSize);
         AddRef();
     }
 
@@ -28,24 +29,63 @@ namespace DirectShowCamera
 
     void SampleGrabberCallback::setBufferSize(const int numOfBytes)
     {
-        // Lock all buffer
-        m_bufferMutex.lock();
+        m_frameBufferEngine.setBufferSize(numOfBytes);
+    }
 
-        // Reallocate buffer
-        m_bufferSize = numOfBytes;
-        m_pixelsBuffer.reset();
-        m_pixelsBuffer = std::make_unique<unsigned char[]>(m_bufferSize);
+    int SampleGrabberCallback::getBufferSize() const
+    {
+        return m_frameBufferEngine.getBufferSize();
+    }
 
-        // Set all bytes as 0
-        memset(m_pixelsBuffer.get(), 0, m_bufferSize);
+    void SampleGrabberCallback::setVariableFrameSize(const bool variableFrameSize)
+    {
+        m_variableFrameSize = variableFrameSize;
+    }
 
-        // Release all lock
-        m_bufferMutex.unlock();
+    bool SampleGrabberCallback::isVariableFrameSize() const
+    {
+        return m_variableFrameSize;
     }
 
-    int SampleGrabberCallback::getBufferSize() const
+    void SampleGrabberCallback::setBufferMode(const FrameBufferMode mode)
+    {
+        m_frameBufferEngine.setMode(mode);
+    }
+
+    FrameBufferMode SampleGrabberCallback::getBufferMode() const
+    {
+        return m_frameBufferEngine.getMode();
+    }
+
+    void SampleGrabberCallback::setRingBuffer(const int capacity, const FrameOverflowPolicy overflowPolicy)
+    {
+        if (capacity != m_frameBufferEngine.getRingBufferCapacity()) m_frameBufferEngine.setRingBufferCapacity(capacity);
+        m_frameBufferEngine.setOverflowPolicy(overflowPolicy);
+    }
+
+    int SampleGrabberCallback::getRingBufferCapacity() const
     {
-        return m_bufferSize;
+        return m_frameBufferEngine.getRingBufferCapacity();
+    }
+
+    FrameOverflowPolicy SampleGrabberCallback::getOverflowPolicy() const
+    {
+        return m_frameBufferEngine.getOverflowPolicy();
+    }
+
+    void SampleGrabberCallback::setMaxOutstandingLeases(const int maxOutstandingLeases)
+    {
+        m_frameBufferEngine.setMaxOutstandingLeases(maxOutstandingLeases);
+    }
+
+    int SampleGrabberCallback::getMaxOutstandingLeases() const
+    {
+        return m_frameBufferEngine.getMaxOutstandingLeases();
+    }
+
+    FrameBufferStatistics SampleGrabberCallback::getBufferStatistics() const
+    {
+        return m_frameBufferEngine.getStatistics();
     }
 
 #pragma endregion Buffer Size
@@ -55,49 +95,45 @@ namespace DirectShowCamera
     bool SampleGrabberCallback::getFrame(
         unsigned char* frame,
         int& numOfBytes,
-        unsigned long& frameIndex
+        unsigned long& frameIndex,
+        FrameTimestamp* timestamp
     )
     {
-        // Check
-        if (frame == nullptr)  return false;
-
-        // Copy frame
-        try
-        {
-            //     Lock mutex
-            m_bufferMutex.lock();
-
-            //     Copy
-            memcpy(frame, m_pixelsBuffer.get(), m_bufferSize);
-
-            //     Return frame size
-            numOfBytes = m_bufferSize;
+        return m_frameBufferEngine.Read(frame, numOfBytes, frameIndex, timestamp);
+    }
 
-            //     Return frame index
-            frameIndex = m_frameIndex;
+    bool SampleGrabberCallback::exchangeFrame(
+        FrameBuffer& frame,
+        int& numOfBytes,
+        unsigned long& frameIndex,
+        FrameTimestamp* timestamp
+    )
+    {
+        return m_frameBufferEngine.Exchange(frame, numOfBytes, frameIndex, timestamp);
+    }
 
-            //     Unlock mutex
-            m_bufferMutex.unlock();
-        }
-        catch (...)
-        {
-            // Unlock mutex
-            m_bufferMutex.unlock();
-            return false;
-        }
+    bool SampleGrabberCallback::leaseFrame(FrameLease& lease)
+    {
+        return m_frameBufferEngine.Lease(lease);
+    }
 
-        return true;
+    bool SampleGrabberCallback::waitForFrame(
+        const unsigned long afterFrameIndex,
+        const std::chrono::steady_clock::time_point deadline
+    )
+    {
+        return m_frameBufferEngine.WaitForFrame(afterFrameIndex, deadline);
     }
 
     unsigned long SampleGrabberCallback::getLastFrameIndex() const
     {
-        return m_frameIndex;
+        return m_frameBufferEngine.getLastFrameIndex();
     }
 
     double SampleGrabberCallback::getFPS() const
     {
-        auto nowTime = std::chrono::system_clock::now();
-        double timeDiff = (std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - m_lastFrameTime)).count() / 1000.0;
+        auto nowTime = std::chrono::steady_clock::now();
+        double timeDiff = std::chrono::duration<double>(nowTime - m_lastFrameTime).count();
         if (1/ timeDiff < m_minimumFPS)
         {
             return 0;
@@ -116,7 +152,7 @@ namespace DirectShowCamera
         }
     }
 
-    std::chrono::system_clock::time_point SampleGrabberCallback::getLastFrameCaptureTime() const
+    std::chrono::steady_clock::time_point SampleGrabberCallback::getLastFrameCaptureTime() const
     {
         return m_lastFrameTime;
     }
@@ -162,7 +198,13 @@ namespace DirectShowCamera
         return S_OK;
     }
 
-    STDMETHODIMP SampleGrabberCallback::SampleCB(double, IMediaSample* pSample) {
+    STDMETHODIMP SampleGrabberCallback::SampleCB(double sampleTime, IMediaSample* pSample) {
+
+        // Stamp the arrival time before anything else. The sample time is the presentation time in second relative to the stream start.
+        const auto arrivalTime = std::chrono::steady_clock::now();
+        FrameTimestamp timestamp;
+        timestamp.DeviceTime = (long long)std::llround(sampleTime * 1e9);
+        timestamp.ArrivalTime = std::chrono::duration_cast<std::chrono::nanoseconds>(arrivalTime.time_since_epoch()).count();
 
         // Get data
         unsigned char* directShowBufferPointer;
@@ -173,32 +215,37 @@ namespace DirectShowCamera
             // Get frame data size
             int currentPixelSize = pSample->GetActualDataLength();
 
-            if (currentPixelSize == m_bufferSize) {
-                
-                // Lock
-                m_bufferMutex.lock();
+            const int bufferSize = m_frameBufferEngine.getBufferSize();
+            const bool isVariableSizeFrame = m_variableFrameSize && currentPixelSize > 0 && currentPixelSize < bufferSize;
 
-                // Copy to buffer
-                memcpy(m_pixelsBuffer.get(), directShowBufferPointer, m_bufferSize);
-
-                // Update frame index
-                if (m_frameIndex >= ULONG_MAX - 1)
+            if (currentPixelSize == bufferSize || isVariableSizeFrame) {
+                
+                if (isVariableSizeFrame)
+                {
+                    // Compressed frame, keep the payload in a frame of the buffer size
+                    WriteVariableSizeFrame(directShowBufferPointer, currentPixelSize, pSample, timestamp);
+                }
+                else if (m_frameBufferEngine.getMode() == FrameBufferMode::Lease)
                 {
-                    m_frameIndex = 1;
-                }				
+                    // Hold the media sample instead of copying. It goes back to the allocator when the last lease is released.
+                    m_frameBufferEngine.WriteLease(
+                        directShowBufferPointer,
+                        currentPixelSize,
+                        [pSample]() { pSample->AddRef(); },
+                        [pSample]() { pSample->Release(); },
+                        timestamp
+                    );
+                }
                 else
                 {
-                    m_frameIndex++;
+                    // Copy to buffer and publish
+                    m_frameBufferEngine.Write(directShowBufferPointer, currentPixelSize, timestamp);
                 }
 
-                // Release Lock
-                m_bufferMutex.unlock();
-
                 // Update fps
-                auto nowTime = std::chrono::system_clock::now();
-                double timeDiff = (std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - m_lastFrameTime)).count() / 1000.0;
+                double timeDiff = std::chrono::duration<double>(arrivalTime - m_lastFrameTime).count();
                 m_fps = 1 / timeDiff;
-                m_lastFrameTime = nowTime;
+                m_lastFrameTime = arrivalTime;
 
                 // Reset variable
                 m_numOfRepeatPixelCount = 0;
@@ -231,6 +278,46 @@ namespace DirectShowCamera
         return S_OK;
     }
 
+    bool SampleGrabberCallback::WriteVariableSizeFrame(
+        unsigned char* data,
+        const int numOfBytes,
+        IMediaSample* pSample,
+        const FrameTimestamp timestamp
+    )
+    {
+        const int bufferSize = m_frameBufferEngine.getBufferSize();
+
+        if (m_frameBufferEngine.getMode() == FrameBufferMode::Lease)
+        {
+            if (pSample->GetSize() >= bufferSize)
+            {
+                // The sample buffer is large enough, hold it
+                return m_frameBufferEngine.WriteLease(
+                    data,
+                    bufferSize,
+                    [pSample]() { pSample->AddRef(); },
+                    [pSample]() { pSample->Release(); },
+                    timestamp
+                );
+            }
+            else
+            {
+                // Lease a copy of the payload in a buffer of the buffer size
+                std::shared_ptr<unsigned char[]> copiedData(new unsigned char[bufferSize]);
+                memcpy(copiedData.get(), data, numOfBytes);
+                return m_frameBufferEngine.WriteLease(copiedData.get(), bufferSize, nullptr, [copiedData]() {}, timestamp);
+            }
+        }
+
+        // Copy the payload only, bytes after it are ignored by the decoder
+        unsigned char* buffer = m_frameBufferEngine.BeginWrite(bufferSize);
+        if (buffer == nullptr) return false;
+        memcpy(buffer, data, numOfBytes);
+        m_frameBufferEngine.EndWrite(timestamp);
+
+        return true;
+    }
+
     STDMETHODIMP SampleGrabberCallback::BufferCB(double, BYTE*, long) {
         // prevent nodiscard warning by casting to void
         static_cast<void>(std::chrono::system_clock::now());
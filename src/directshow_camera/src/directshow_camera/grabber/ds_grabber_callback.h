@@ -16,7 +16,8 @@
 
 #include "directshow_camera/video_format/ds_guid.h"
 
-#include <mutex>
+#include "buffer/frame_buffer_engine.h"
+
 #include <chrono>
 #include <memory>
 
@@ -58,6 +59,68 @@ namespace DirectShowCamera
         */
         int getBufferSize() const;
 
+        /**
+         * @brief Accept frames shorter than the buffer size, such as compressed frames. The payload is stored at the start of a frame of the buffer size.
+         *        It should not be called while streaming. Default as false.
+         * @param[in] variableFrameSize Set as true to accept frames shorter than the buffer size
+        */
+        void setVariableFrameSize(const bool variableFrameSize);
+
+        /**
+         * @brief Return true if frames shorter than the buffer size are accepted
+         * @return Return true if frames shorter than the buffer size are accepted
+        */
+        bool isVariableFrameSize() const;
+
+        /**
+         * @brief Set the buffer mode. It should not be called while streaming.
+         * @param[in] mode Buffer mode
+        */
+        void setBufferMode(const FrameBufferMode mode);
+
+        /**
+         * @brief Get the buffer mode
+         * @return Return the buffer mode
+        */
+        FrameBufferMode getBufferMode() const;
+
+        /**
+         * @brief Set the ring buffer used in FrameBufferMode::Ring. Queued frames will be discarded. It should not be called while streaming.
+         * @param[in] capacity Maximum number of queued frames
+         * @param[in] overflowPolicy What to do when a frame arrives and the ring buffer is full
+        */
+        void setRingBuffer(const int capacity, const FrameOverflowPolicy overflowPolicy);
+
+        /**
+         * @brief Get the maximum number of queued frames in FrameBufferMode::Ring
+         * @return Return the maximum number of queued frames
+        */
+        int getRingBufferCapacity() const;
+
+        /**
+         * @brief Get the overflow policy of the ring buffer
+         * @return Return the overflow policy
+        */
+        FrameOverflowPolicy getOverflowPolicy() const;
+
+        /**
+         * @brief Set the maximum number of media samples held in FrameBufferMode::Lease, including the newest sample kept by the grabber.
+         * @param[in] maxOutstandingLeases Maximum number of held media samples
+        */
+        void setMaxOutstandingLeases(const int maxOutstandingLeases);
+
+        /**
+         * @brief Get the maximum number of media samples held in FrameBufferMode::Lease
+         * @return Return the maximum number of held media samples
+        */
+        int getMaxOutstandingLeases() const;
+
+        /**
+         * @brief Get the buffer statistics
+         * @return Return the buffer statistics
+        */
+        FrameBufferStatistics getBufferStatistics() const;
+
 #pragma endregion Buffer Size
 
 #pragma region Frame
@@ -67,12 +130,47 @@ namespace DirectShowCamera
          * @param[out] frame Frame in bytes
          * @param[out] numOfBytes Number of the byte of the frame. It will change if the size is change in 5 frame.
          * @param[out] frameIndex (Optional) A frame index,such as a frame id. It can be use to identify whether it is a new frame.
+         * @param[out] timestamp (Optional) Capture timestamps of the frame. Default as nullptr
          * @return Return true if the current is copied. If error occurred, it return false.
         */
         bool getFrame(
             unsigned char* frame,
             int& numOfBytes,
-            unsigned long& frameIndex
+            unsigned long& frameIndex,
+            FrameTimestamp* timestamp = nullptr
+        );
+
+        /**
+         * @brief Hand the current frame over by exchanging buffers. No copy is made.
+         * @param[in,out] frame In: a buffer to be reused by the grabber, can be nullptr. Out: the current frame.
+         * @param[in,out] numOfBytes In: size of the input buffer. Out: Number of the byte of the frame.
+         * @param[out] frameIndex A frame index,such as a frame id. It can be use to identify whether it is a new frame.
+         * @param[out] timestamp (Optional) Capture timestamps of the frame. Default as nullptr
+         * @return Return false if the buffer can't be exchanged. In this case, nothing is changed.
+        */
+        bool exchangeFrame(
+            FrameBuffer& frame,
+            int& numOfBytes,
+            unsigned long& frameIndex,
+            FrameTimestamp* timestamp = nullptr
+        );
+
+        /**
+         * @brief Lease the media sample of the current frame in FrameBufferMode::Lease. No copy is made. The sample is returned to the allocator when the lease is released.
+         * @param[out] lease Lease of the current frame
+         * @return Return false if it is not in FrameBufferMode::Lease or no frame has been captured.
+        */
+        bool leaseFrame(FrameLease& lease);
+
+        /**
+         * @brief Block until a frame newer than afterFrameIndex is captured or the deadline is reached. It wakes up as soon as SampleCB() publishes.
+         * @param[in] afterFrameIndex Frame index which has been seen by the consumer
+         * @param[in] deadline Time to give up waiting
+         * @return Return true if a new frame is available. Return false if timeout.
+        */
+        bool waitForFrame(
+            const unsigned long afterFrameIndex,
+            const std::chrono::steady_clock::time_point deadline
         );
 
         /**
@@ -89,9 +187,9 @@ namespace DirectShowCamera
 
         /**
         * @brief Get the last frame capture time
-        * @return Return the last frame capture time
+        * @return Return the last frame capture time in std::chrono::steady_clock
         */
-        std::chrono::system_clock::time_point getLastFrameCaptureTime() const;
+        std::chrono::steady_clock::time_point getLastFrameCaptureTime() const;
 
         /**
         * @brief Set the minimum FPS. FPS below this value will be identified as 0.
@@ -118,37 +216,39 @@ namespace DirectShowCamera
         STDMETHODIMP QueryInterface(REFIID, void** ppvObject) override;
 
         //------------------------------------------------
-        STDMETHODIMP SampleCB(double, IMediaSample* pSample) override;
+        STDMETHODIMP SampleCB(double sampleTime, IMediaSample* pSample) override;
 
         // Not implemented
         STDMETHODIMP BufferCB(double, BYTE*, long) override;
     private:
 
         /**
-         * @brief A mutex for the rame copying.
+         * @brief Publish a frame which is shorter than the buffer size. See setVariableFrameSize().
+         * @param[in] data Frame data
+         * @param[in] numOfBytes Number of bytes of the frame data
+         * @param[in] pSample Media sample of the frame data
+         * @param[in] timestamp Capture timestamps of the frame
+         * @return Return true if the frame is published
         */
-        std::mutex m_bufferMutex;
-
-        /**
-         * @brief Current frame data.
-        */
-        std::unique_ptr<unsigned char[]> m_pixelsBuffer;
+        bool WriteVariableSizeFrame(
+            unsigned char* data,
+            const int numOfBytes,
+            IMediaSample* pSample,
+            const FrameTimestamp timestamp
+        );
 
         /**
-         * @brief The current frame size in bytes.
+         * @brief Frame buffer. It hands the frame from the DirectShow streaming thread to the consumer.
         */
-        int m_bufferSize = 0;
+        FrameBufferEngine m_frameBufferEngine;
 
-        /**
-         * @brief Current Frame index. Such as ID of the current frame. It use to identify whether a new frame.
-        */
-        unsigned long m_frameIndex = 1;
+        bool m_variableFrameSize = false;
 
         int m_latestPixelCount = 0;
         int m_numOfRepeatPixelCount = 0;
         static const int m_resetBufferCount = 5;
 
-        std::chrono::system_clock::time_point m_lastFrameTime;
+        std::chrono::steady_clock::time_point m_lastFrameTime;
         double m_fps = 0;
 
         double m_minimumFPS = 0.5;
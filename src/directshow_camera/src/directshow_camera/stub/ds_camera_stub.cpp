@@ -154,9 +154,13 @@ namespace DirectShowCamera
         if (m_isOpening)
         {
             m_isCapturing = true;
+            m_captureStartTime = std::chrono::steady_clock::now();
 
             // Start check disconnection thread
             StartCheckConnectionThread();
+
+            // Start pushing frames as the DirectShow streaming thread does
+            if (m_pushFrameMode) StartPushFrameThread();
         }
         else
         {
@@ -178,6 +182,9 @@ namespace DirectShowCamera
             {
                 if (m_isCapturing)
                 {
+                    // Stop pushing frames before the capture is stopped
+                    StopPushFrameThread();
+
                     // Reset isCapturing
                     m_isCapturing = false;
 
@@ -209,52 +216,234 @@ namespace DirectShowCamera
         m_getFrameFunc = func;
     }
 
+    void DirectShowCameraStub::setPushFrameMode(const bool enable, const double fps)
+    {
+        // Check
+        if (fps <= 0) throw std::invalid_argument("Push frame fps(" + std::to_string(fps) + ") can't be <= 0.");
+
+        m_pushFrameMode = enable;
+        m_pushFrameFPS = fps;
+    }
+
+    bool DirectShowCameraStub::isPushFrameMode() const
+    {
+        return m_pushFrameMode;
+    }
+
+    void DirectShowCameraStub::StartPushFrameThread()
+    {
+        StopPushFrameThread();
+
+        m_stopPushFrameThread = false;
+        m_pushFrameThread = std::thread(
+            [this]()
+            {
+                const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / m_pushFrameFPS));
+                auto nextFrameTime = std::chrono::steady_clock::now();
+                while (!m_stopPushFrameThread)
+                {
+                    // Keep the frame rate without drifting
+                    nextFrameTime += interval;
+                    std::this_thread::sleep_until(nextFrameTime);
+                    if (m_stopPushFrameThread) break;
+
+                    GenerateFrame();
+                }
+            }
+        );
+    }
+
+    void DirectShowCameraStub::StopPushFrameThread()
+    {
+        m_stopPushFrameThread = true;
+        if (m_pushFrameThread.joinable()) m_pushFrameThread.join();
+    }
+
     bool DirectShowCameraStub::getFrame(
         unsigned char* frame,
         int& numOfBytes,
-        unsigned long& frameIndex
+        unsigned long& frameIndex,
+        FrameTimestamp* timestamp
     )
     {
-        if (m_isCapturing && frame)
+        // In push frame mode, frames are generated by the push frame thread
+        if (m_pushFrameMode && m_isCapturing)
+        {
+            return frame && m_frameBufferEngine.Read(frame, numOfBytes, frameIndex, timestamp);
+        }
+
+        if (frame && GenerateFrame())
         {
-            if (m_getFrameFunc)
+            // Read back
+            return m_frameBufferEngine.Read(frame, numOfBytes, frameIndex, timestamp);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    bool DirectShowCameraStub::exchangeFrame(
+        FrameBuffer& pixels,
+        int& numOfBytes,
+        unsigned long& frameIndex,
+        FrameTimestamp* timestamp
+    )
+    {
+        // Exchange is not supported by the mutex buffer. Don't generate a frame which can't be handed over.
+        if (m_frameBufferEngine.getMode() == FrameBufferMode::Mutex) return false;
+
+        // In push frame mode, frames are generated by the push frame thread
+        if (m_pushFrameMode && m_isCapturing) return m_frameBufferEngine.Exchange(pixels, numOfBytes, frameIndex, timestamp);
+
+        if (GenerateFrame())
+        {
+            // Hand over
+            return m_frameBufferEngine.Exchange(pixels, numOfBytes, frameIndex, timestamp);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    bool DirectShowCameraStub::leaseFrame(FrameLease& lease)
+    {
+        // Lease is only supported by the lease mode
+        if (m_frameBufferEngine.getMode() != FrameBufferMode::Lease) return false;
+
+        // In push frame mode, frames are generated by the push frame thread
+        if (m_pushFrameMode && m_isCapturing) return m_frameBufferEngine.Lease(lease);
+
+        if (GenerateFrame())
+        {
+            // Lease
+            return m_frameBufferEngine.Lease(lease);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    bool DirectShowCameraStub::GenerateFrame()
+    {
+        if (!m_isCapturing) return false;
+
+        // Get the buffer to be written
+        const int bufferSize = getFrameTotalSize();
+        if (m_frameBufferEngine.getBufferSize() != bufferSize) m_frameBufferEngine.setBufferSize(bufferSize);
+        const bool isLeaseMode = m_frameBufferEngine.getMode() == FrameBufferMode::Lease;
+        std::shared_ptr<unsigned char[]> leaseBuffer = nullptr;
+        unsigned char* buffer = nullptr;
+        if (isLeaseMode)
+        {
+            // The stub owns the frame like a media sample. It is freed when the last lease is released.
+            leaseBuffer = std::shared_ptr<unsigned char[]>(new unsigned char[bufferSize]);
+            buffer = leaseBuffer.get();
+        }
+        else
+        {
+            buffer = m_frameBufferEngine.BeginWrite(bufferSize);
+        }
+        if (buffer == nullptr) return false;
+
+        if (m_getFrameFunc)
+        {
+            // Return the user define image
+            int numOfBytes = 0;
+            unsigned long frameIndex = 0;
+            m_getFrameFunc(buffer, numOfBytes, frameIndex, m_frameIndex);
+
+            // Update frame index
+            m_frameIndex = frameIndex;
+        }
+        else
+        {
+            // Update frame index
+            if (UpdateFrameIndexAfterGetFrame)
             {
-                // Return the user define image
-                m_getFrameFunc(frame, numOfBytes, frameIndex, m_frameIndex);
+                m_frameIndex = m_frameIndex + 1;
+            }
 
-                // Update frame index
-                m_frameIndex = frameIndex;
+            // Return the default image, image will be generated based on the frame index value
+            int numOfBytes = 0;
+            if (isRawMJPGFrame())
+            {
+                DirectShowCameraStubDefaultSetting::getMJPGFrame(
+                    buffer,
+                    numOfBytes,
+                    m_frameIndex,
+                    m_videoFormats.getVideoFormat(m_currentVideoFormatIndex).getWidth(),
+                    m_videoFormats.getVideoFormat(m_currentVideoFormatIndex).getHeight()
+                );
+            }
+            else if (isRawYUVFrame())
+            {
+                DirectShowCameraStubDefaultSetting::getYUY2Frame(
+                    buffer,
+                    numOfBytes,
+                    m_frameIndex,
+                    m_videoFormats.getVideoFormat(m_currentVideoFormatIndex).getWidth(),
+                    m_videoFormats.getVideoFormat(m_currentVideoFormatIndex).getHeight()
+                );
             }
             else
             {
-                // Update frame index
-                if (UpdateFrameIndexAfterGetFrame)
-                {
-                    m_frameIndex = m_frameIndex + 1;
-                }
-
-                frameIndex = m_frameIndex;
-
-                // Return the default image, image will be generated based on the frame index value
                 DirectShowCameraStubDefaultSetting::getFrame(
-                    frame,
+                    buffer,
                     numOfBytes,
-                    frameIndex,
+                    m_frameIndex,
                     m_videoFormats.getVideoFormat(m_currentVideoFormatIndex).getWidth(),
                     m_videoFormats.getVideoFormat(m_currentVideoFormatIndex).getHeight()
                 );
             }
+        }
 
-            return true;
+        // Stamp the completed frame as the grabber does. The device time is the stream time since Start().
+        const auto arrivalTime = std::chrono::steady_clock::now();
+        FrameTimestamp timestamp;
+        timestamp.DeviceTime = std::chrono::duration_cast<std::chrono::nanoseconds>(arrivalTime - m_captureStartTime).count();
+        timestamp.ArrivalTime = std::chrono::duration_cast<std::chrono::nanoseconds>(arrivalTime.time_since_epoch()).count();
+
+        // Publish
+        if (isLeaseMode)
+        {
+            return m_frameBufferEngine.WriteLease(
+                buffer,
+                bufferSize,
+                m_frameIndex,
+                nullptr,
+                [leaseBuffer]() {},
+                timestamp
+            );
         }
         else
         {
-            return false;
+            m_frameBufferEngine.EndWrite(m_frameIndex, timestamp);
         }
+
+        return true;
+    }
+
+    bool DirectShowCameraStub::waitForFrame(
+        const unsigned long afterFrameIndex,
+        const std::chrono::steady_clock::time_point deadline
+    )
+    {
+        if (!m_isCapturing) return false;
+
+        // Frames are generated on request in the pull mode
+        if (!m_pushFrameMode) return true;
+
+        return m_frameBufferEngine.WaitForFrame(afterFrameIndex, deadline);
     }
 
     unsigned long DirectShowCameraStub::getLastFrameIndex() const
     {
+        // The frame index is updated by the push frame thread
+        if (m_pushFrameMode && m_isCapturing) return m_frameBufferEngine.getLastFrameIndex();
+
         return m_frameIndex;
     }
 
@@ -289,7 +478,7 @@ namespace DirectShowCamera
         {
             const auto heigth = m_videoFormats.getVideoFormat(m_currentVideoFormatIndex).getHeight();
             const auto width = m_videoFormats.getVideoFormat(m_currentVideoFormatIndex).getWidth();
-            const int result = heigth * width * 3;
+            const int result = heigth * width * (isRawYUVFrame() ? 2 : 3);
             return result;
         }
         else
@@ -300,11 +489,78 @@ namespace DirectShowCamera
 
     GUID DirectShowCameraStub::getFrameType() const
     {
-        return MEDIASUBTYPE_RGB24;
+        if (isRawMJPGFrame()) return MEDIASUBTYPE_MJPG;
+        return isRawYUVFrame() ? MEDIASUBTYPE_YUY2 : MEDIASUBTYPE_RGB24;
+    }
+
+    std::shared_ptr<const RGBPalette> DirectShowCameraStub::getPalette() const
+    {
+        return nullptr;
+    }
+
+    bool DirectShowCameraStub::isRawYUVFrame() const
+    {
+        // The stub only emits YUY2 in the raw YUV capture
+        return m_rawYUVCapture &&
+            m_currentVideoFormatIndex >= 0 &&
+            m_videoFormats.getVideoFormat(m_currentVideoFormatIndex).getVideoType() == MEDIASUBTYPE_YUY2;
+    }
+
+    bool DirectShowCameraStub::isRawMJPGFrame() const
+    {
+        // The compressed frame is stored in a RGB24 sized buffer as the grabber does
+        return m_rawMJPGCapture &&
+            m_currentVideoFormatIndex >= 0 &&
+            m_videoFormats.getVideoFormat(m_currentVideoFormatIndex).getVideoType() == MEDIASUBTYPE_MJPG;
     }
 
 #pragma endregion Frame
 
+#pragma region Frame Buffer
+
+    void DirectShowCameraStub::setFrameBufferMode(const FrameBufferMode mode)
+    {
+        m_frameBufferEngine.setMode(mode);
+    }
+
+    FrameBufferMode DirectShowCameraStub::getFrameBufferMode() const
+    {
+        return m_frameBufferEngine.getMode();
+    }
+
+    void DirectShowCameraStub::setFrameRingBuffer(const int capacity, const FrameOverflowPolicy overflowPolicy)
+    {
+        if (capacity != m_frameBufferEngine.getRingBufferCapacity()) m_frameBufferEngine.setRingBufferCapacity(capacity);
+        m_frameBufferEngine.setOverflowPolicy(overflowPolicy);
+    }
+
+    int DirectShowCameraStub::getFrameRingBufferCapacity() const
+    {
+        return m_frameBufferEngine.getRingBufferCapacity();
+    }
+
+    FrameOverflowPolicy DirectShowCameraStub::getFrameOverflowPolicy() const
+    {
+        return m_frameBufferEngine.getOverflowPolicy();
+    }
+
+    void DirectShowCameraStub::setMaxFrameLeases(const int maxFrameLeases)
+    {
+        m_frameBufferEngine.setMaxOutstandingLeases(maxFrameLeases);
+    }
+
+    int DirectShowCameraStub::getMaxFrameLeases() const
+    {
+        return m_frameBufferEngine.getMaxOutstandingLeases();
+    }
+
+    FrameBufferStatistics DirectShowCameraStub::getFrameBufferStatistics() const
+    {
+        return m_frameBufferEngine.getStatistics();
+    }
+
+#pragma endregion Frame Buffer
+
 #pragma region Video Format
 
     bool DirectShowCameraStub::UpdateVideoFormatList()
@@ -398,6 +654,36 @@ namespace DirectShowCamera
         return result;
     }
 
+    void DirectShowCameraStub::setRawYUVCapture(const bool rawYUVCapture)
+    {
+        m_rawYUVCapture = rawYUVCapture;
+    }
+
+    bool DirectShowCameraStub::isRawYUVCapture() const
+    {
+        return m_rawYUVCapture;
+    }
+
+    void DirectShowCameraStub::setRawMJPGCapture(const bool rawMJPGCapture)
+    {
+        m_rawMJPGCapture = rawMJPGCapture;
+    }
+
+    bool DirectShowCameraStub::isRawMJPGCapture() const
+    {
+        return m_rawMJPGCapture;
+    }
+
+    void DirectShowCameraStub::setRawRGBCapture(const bool rawRGBCapture)
+    {
+        m_rawRGBCapture = rawRGBCapture;
+    }
+
+    bool DirectShowCameraStub::isRawRGBCapture() const
+    {
+        return m_rawRGBCapture;
+    }
+
 #pragma endregion Video Format
 
 #pragma region Properties
@@ -15,6 +15,10 @@
 #include "directshow_camera/video_format/ds_video_format_list.h"
 #include "directshow_camera/device/ds_camera_device.h"
 
+#include "buffer/frame_buffer_engine.h"
+
+#include <atomic>
+#include <chrono>
 #include <thread>
 #include <functional>
 #include <optional>
@@ -135,15 +139,66 @@ namespace DirectShowCamera
          * @param[out] frame Frame in bytes
          * @param[out] numOfBytes Number of bytes of the frames.
          * @param[out] frameIndex Index of frame, use to indicate whether a new frame.
+         * @param[out] timestamp (Optional) Capture timestamps of the frame. Default as nullptr
          * @return Return true if success.
         */
         bool getFrame
         (
             unsigned char* frame,
             int& numOfBytes,
-            unsigned long& frameIndex
+            unsigned long& frameIndex,
+            FrameTimestamp* timestamp = nullptr
+        ) override;
+
+        /**
+         * @brief Generate a frame and hand it over by exchanging buffers with the frame buffer. No copy is made.
+         * @param[in,out] pixels In: a buffer to be reused by the frame buffer, can be nullptr. Out: the current frame.
+         * @param[in,out] numOfBytes In: size of the input buffer. Out: Number of bytes of the frame.
+         * @param[out] frameIndex Index of frame, use to indicate whether a new frame.
+         * @param[out] timestamp (Optional) Capture timestamps of the frame. Default as nullptr
+         * @return Return true if success. Return false if the buffer can't be exchanged (e.g. FrameBufferMode::Mutex). In this case, the frame stays in the frame buffer.
+        */
+        bool exchangeFrame
+        (
+            FrameBuffer& pixels,
+            int& numOfBytes,
+            unsigned long& frameIndex,
+            FrameTimestamp* timestamp = nullptr
+        ) override;
+
+        /**
+         * @brief Generate a frame and lease it in FrameBufferMode::Lease. The stub owns the frame as a media sample does. No copy is made.
+         * @param[out] lease Lease of the current frame
+         * @return Return true if success. Return false if it is not in FrameBufferMode::Lease or the frame is dropped because too many frames are held.
+        */
+        bool leaseFrame(FrameLease& lease) override;
+
+        /**
+         * @brief Block until a frame newer than afterFrameIndex is captured or the deadline is reached.
+         * In the push frame mode, it wakes up as soon as the push frame thread publishes. Otherwise, frames are generated on request so it returns immediately.
+         * @param[in] afterFrameIndex Frame index which has been seen by the consumer
+         * @param[in] deadline Time to give up waiting
+         * @return Return true if a new frame is available. Return false if timeout or the camera is not capturing.
+        */
+        bool waitForFrame(
+            const unsigned long afterFrameIndex,
+            const std::chrono::steady_clock::time_point deadline
         ) override;
 
+        /**
+         * @brief Generate frames in a thread at a fixed frame rate as the DirectShow streaming thread does, instead of generating a frame on every request.
+         * It takes effect on the next Start().
+         * @param[in] enable Set as true to enable the push frame mode
+         * @param[in] fps (Optional) Frame rate of the push frame thread. Default as 30
+        */
+        void setPushFrameMode(const bool enable, const double fps = 30);
+
+        /**
+         * @brief Return true if the push frame mode is enabled
+         * @return Return true if the push frame mode is enabled
+        */
+        bool isPushFrameMode() const;
+
         /**
         * @brief Get the last frame index.
         * @return Return the last frame index.
@@ -174,8 +229,67 @@ namespace DirectShowCamera
         */
         GUID getFrameType() const override;
 
+        /**
+         * @brief Get the palette of the current frame type. The stub doesn't emit RGB8 frames.
+         * @return Return nullptr
+        */
+        std::shared_ptr<const RGBPalette> getPalette() const override;
+
 #pragma endregion Frame
 
+#pragma region Frame Buffer
+
+        /**
+         * @brief Set the frame buffer mode. All frames in the buffer will be discarded.
+         * @param[in] mode Frame buffer mode. Default as FrameBufferMode::TripleBuffer
+        */
+        void setFrameBufferMode(const FrameBufferMode mode) override;
+
+        /**
+         * @brief Get the frame buffer mode
+         * @return Return the frame buffer mode
+        */
+        FrameBufferMode getFrameBufferMode() const override;
+
+        /**
+         * @brief Set the ring buffer used in FrameBufferMode::Ring. Queued frames will be discarded.
+         * @param[in] capacity Maximum number of queued frames. Default as 8
+         * @param[in] overflowPolicy What to do when a frame arrives and the ring buffer is full. Default as FrameOverflowPolicy::DropOldest
+        */
+        void setFrameRingBuffer(const int capacity, const FrameOverflowPolicy overflowPolicy) override;
+
+        /**
+         * @brief Get the maximum number of queued frames in FrameBufferMode::Ring
+         * @return Return the maximum number of queued frames
+        */
+        int getFrameRingBufferCapacity() const override;
+
+        /**
+         * @brief Get the overflow policy of the ring buffer
+         * @return Return the overflow policy
+        */
+        FrameOverflowPolicy getFrameOverflowPolicy() const override;
+
+        /**
+         * @brief Set the maximum number of frames held in FrameBufferMode::Lease, including the newest frame kept by the frame buffer. New frames are dropped when the cap is reached.
+         * @param[in] maxFrameLeases Maximum number of held frames. Default as 2
+        */
+        void setMaxFrameLeases(const int maxFrameLeases) override;
+
+        /**
+         * @brief Get the maximum number of frames held in FrameBufferMode::Lease
+         * @return Return the maximum number of held frames
+        */
+        int getMaxFrameLeases() const override;
+
+        /**
+         * @brief Get the frame buffer statistics
+         * @return Return the frame buffer statistics
+        */
+        FrameBufferStatistics getFrameBufferStatistics() const override;
+
+#pragma endregion Frame Buffer
+
 #pragma region Video Format
 
         /**
@@ -216,6 +330,45 @@ namespace DirectShowCamera
         */
         bool setVideoFormat(const int videoFormatIndex) override;
 
+        /**
+         * @brief Keep the YUV frames (See FrameDecoder::SupportYUVVideoType()) in YUV instead of converting them to RGB24 in the graph.
+         *        The frames are converted by FrameDecoder when they are used, so the streaming thread only copies the raw data. Default as false.
+         * @param[in] rawYUVCapture Set as true to capture the raw YUV frames. It is applied when the capture is started or the video format is set.
+        */
+        void setRawYUVCapture(const bool rawYUVCapture) override;
+
+        /**
+         * @brief Return true if the YUV frames are captured in YUV
+         * @return Return true if the YUV frames are captured in YUV
+        */
+        bool isRawYUVCapture() const override;
+
+        /**
+         * @brief Keep the MJPEG frames (See FrameDecoder::SupportMJPGVideoType()) compressed instead of decoding them in the graph.
+         *        The stub emits the default frame encoded in JPEG. Default as false.
+         * @param[in] rawMJPGCapture Set as true to capture the compressed MJPEG frames. It is applied when the capture is started or the video format is set.
+        */
+        void setRawMJPGCapture(const bool rawMJPGCapture) override;
+
+        /**
+         * @brief Return true if the MJPEG frames are captured compressed
+         * @return Return true if the MJPEG frames are captured compressed
+        */
+        bool isRawMJPGCapture() const override;
+
+        /**
+         * @brief Keep the RGB8, RGB565 and RGB555 frames in the capture format instead of converting them to RGB24 in the graph.
+         *        The stub only emits RGB24 and YUY2 frames, so the flag is stored only. Default as false.
+         * @param[in] rawRGBCapture Set as true to capture the raw RGB frames. It is applied when the capture is started or the video format is set.
+        */
+        void setRawRGBCapture(const bool rawRGBCapture) override;
+
+        /**
+         * @brief Return true if the RGB8, RGB565 and RGB555 frames are captured in the capture format
+         * @return Return true if the RGB8, RGB565 and RGB555 frames are captured in the capture format
+        */
+        bool isRawRGBCapture() const override;
+
 #pragma endregion Video Format
 
 #pragma region Properties
@@ -309,9 +462,13 @@ namespace DirectShowCamera
 
         DirectShowVideoFormatList m_videoFormats = DirectShowVideoFormatList();
         int m_currentVideoFormatIndex = -1;
+        bool m_rawYUVCapture = false;
+        bool m_rawMJPGCapture = false;
+        bool m_rawRGBCapture = false;
 
         bool m_isOpening = false;
         bool m_isCapturing = false;
+        std::chrono::steady_clock::time_point m_captureStartTime;
         std::string m_errorString = "";
 
         bool m_disconnectCamera = false;
@@ -342,9 +499,46 @@ namespace DirectShowCamera
         */
         int getVideoFormatIndex(const DirectShowVideoFormat videoFormat) const;
 
+        /**
+         * @brief Generate a frame and publish it to the frame buffer as the grabber does.
+         * @return Return false if the camera is not capturing.
+        */
+        bool GenerateFrame();
+
+        /**
+         * @brief Check if the frames are emitted in YUY2, i.e. the raw YUV capture is enabled and the current video format is YUY2.
+         * @return Return true if the frames are emitted in YUY2
+        */
+        bool isRawYUVFrame() const;
+
+        /**
+         * @brief Check if the frames are emitted in MJPEG, i.e. the raw MJPEG capture is enabled and the current video format is MJPEG.
+         * @return Return true if the frames are emitted in MJPEG
+        */
+        bool isRawMJPGFrame() const;
+
+        /**
+         * @brief Start a thread to generate frames at m_pushFrameFPS
+        */
+        void StartPushFrameThread();
+
+        /**
+         * @brief Stop the push frame thread and wait for it to exit
+        */
+        void StopPushFrameThread();
+
     private:
         unsigned long m_frameIndex = 0;
 
+        // The stub frame is written into the frame buffer and read back as DirectShowCamera does
+        FrameBufferEngine m_frameBufferEngine;
+
+        // Push frame mode
+        bool m_pushFrameMode = false;
+        double m_pushFrameFPS = 30;
+        std::thread m_pushFrameThread;
+        std::atomic<bool> m_stopPushFrameThread = false;
+
     };
 }
 
@@ -13,10 +13,14 @@
 #include "directshow_camera/video_format/ds_video_format.h"
 #include "directshow_camera/device/ds_camera_device.h"
 
+#include "directshow_camera/stub/ds_camera_stub_jpeg_encoder.h"
+
 #include "frame/frame.h"
 
 #include <cstring>
 #include <set>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include <frame/frame_settings.h>
 
@@ -203,6 +207,87 @@ namespace DirectShowCamera
                 }
             }
         }
+
+        /**
+         * @brief Get default frame in YUY2. It is the default frame converted by BT.601 and stored from the top as a YUY2 camera does.
+         * @param[out] frame Frame bytes
+         * @param[out] numOfBytes Number of bytes of this frame
+         * @param[in] frameIndex Frame index
+         * @param[in] width Frame width. It must be even.
+         * @param[in] height Frame height
+        */
+        static void getYUY2Frame(
+            unsigned char* frame,
+            int& numOfBytes,
+            const unsigned long frameIndex,
+            const int width,
+            const int height
+        )
+        {
+            // Draw the default frame
+            std::vector<unsigned char> bgrFrame(width * height * 3);
+            int bgrNumOfBytes = 0;
+            getFrame(bgrFrame.data(), bgrNumOfBytes, frameIndex, width, height);
+
+            // Size
+            numOfBytes = width * height * 2;
+
+            // Convert. The default frame is stored from the bottom.
+            for (int j = 0; j < height; j++)
+            {
+                const unsigned char* bgrRow = bgrFrame.data() + (height - j - 1) * width * 3;
+                unsigned char* yuvRow = frame + j * width * 2;
+                for (int i = 0; i < width; i += 2)
+                {
+                    int u = 0;
+                    int v = 0;
+                    for (int k = 0; k < 2; k++)
+                    {
+                        const int b = bgrRow[(i + k) * 3];
+                        const int g = bgrRow[(i + k) * 3 + 1];
+                        const int r = bgrRow[(i + k) * 3 + 2];
+
+                        // Y
+                        yuvRow[(i + k) * 2] = static_cast<unsigned char>(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+
+                        // U and V are shared by 2 pixels
+                        u += (-38 * r - 74 * g + 112 * b + 128) >> 8;
+                        v += (112 * r - 94 * g - 18 * b + 128) >> 8;
+                    }
+                    yuvRow[i * 2 + 1] = static_cast<unsigned char>(128 + u / 2);
+                    yuvRow[i * 2 + 3] = static_cast<unsigned char>(128 + v / 2);
+                }
+            }
+        }
+
+        /**
+         * @brief Get default frame in MJPEG. It is the default frame encoded in 4:2:2 with a restart marker every MCU row as a MJPEG camera does.
+         * @param[out] frame Frame bytes. It must have width * height * 3 bytes. The JPEG data is stored at the beginning.
+         * @param[out] numOfBytes Number of bytes of the JPEG data
+         * @param[in] frameIndex Frame index
+         * @param[in] width Frame width
+         * @param[in] height Frame height
+        */
+        static void getMJPGFrame(
+            unsigned char* frame,
+            int& numOfBytes,
+            const unsigned long frameIndex,
+            const int width,
+            const int height
+        )
+        {
+            // Draw the default frame
+            std::vector<unsigned char> bgrFrame(width * height * 3);
+            int bgrNumOfBytes = 0;
+            getFrame(bgrFrame.data(), bgrNumOfBytes, frameIndex, width, height);
+
+            // Encode. The default frame is stored from the bottom.
+            const auto jpeg = DirectShowCameraStubJPEGEncoder::Encode(bgrFrame.data(), width, height, true, 90, (width + 15) / 16);
+            if ((int)jpeg.size() > bgrNumOfBytes) throw std::runtime_error("MJPEG frame(" + std::to_string(jpeg.size()) + " bytes) is larger than the buffer.");
+
+            numOfBytes = (int)jpeg.size();
+            memcpy(frame, jpeg.data(), jpeg.size());
+        }
     };
 }
 
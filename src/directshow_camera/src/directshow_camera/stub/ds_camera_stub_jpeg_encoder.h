@@ -0,0 +1,392 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__DIRECTSHOW_CAMERA__DIRECTSHOW_CAMERA_STUB_JPEG_ENCODER_H
+#define DIRECTSHOW_CAMERA__DIRECTSHOW_CAMERA__DIRECTSHOW_CAMERA_STUB_JPEG_ENCODER_H
+
+//************Content************
+#include "frame/jpeg_standard_tables.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief A baseline JPEG encoder to simulate a MJPEG camera. It is written for the stub, not for the speed.
+     *
+     * The image is encoded in YCbCr with the standard tables of ITU T.81 Annex K. The Huffman tables are omitted as most MJPEG cameras do.
+     */
+    class DirectShowCameraStubJPEGEncoder
+    {
+    public:
+
+        /**
+         * @brief Encode a BGR image into JPEG
+         * @param[in] bgr BGR image in 24 bits
+         * @param[in] width Width
+         * @param[in] height Height
+         * @param[in] isBottomUp Set as true if the rows are stored from the bottom as a RGB24 frame
+         * @param[in] quality (Optional) Quality from 1 to 100. Default as 90
+         * @param[in] restartInterval (Optional) Number of MCUs between the restart markers, 0 to disable. Default as 0
+         * @param[in] horizontalSampling (Optional) Horizontal luma sampling factor, 1 or 2. Default as 2, i.e. 4:2:2
+         * @param[in] verticalSampling (Optional) Vertical luma sampling factor, 1 or 2. Default as 1
+         * @return Return the JPEG data
+        */
+        static std::vector<unsigned char> Encode(
+            const unsigned char* bgr,
+            const int width,
+            const int height,
+            const bool isBottomUp,
+            const int quality = 90,
+            const int restartInterval = 0,
+            const int horizontalSampling = 2,
+            const int verticalSampling = 1
+        )
+        {
+            // Check
+            if (width <= 0 || height <= 0 || width > 65535 || height > 65535) throw std::invalid_argument("Size(" + std::to_string(width) + "x" + std::to_string(height) + ") is invalid.");
+            if (quality < 1 || quality > 100) throw std::invalid_argument("Quality(" + std::to_string(quality) + ") must be between 1 and 100.");
+            if (restartInterval < 0 || restartInterval > 65535) throw std::invalid_argument("Restart interval(" + std::to_string(restartInterval) + ") is invalid.");
+            if (horizontalSampling < 1 || horizontalSampling > 2 || verticalSampling < 1 || verticalSampling > 2) throw std::invalid_argument("Sampling factor(" + std::to_string(horizontalSampling) + "x" + std::to_string(verticalSampling) + ") is not supported.");
+
+            // Tables
+            unsigned char quantizationTables[2][64];
+            ScaleQuantizationTable(JPEGStandardTables::LUMINANCE_QUANTIZATION, quality, quantizationTables[0]);
+            ScaleQuantizationTable(JPEGStandardTables::CHROMINANCE_QUANTIZATION, quality, quantizationTables[1]);
+
+            HuffmanCodes dcCodes[2];
+            HuffmanCodes acCodes[2];
+            BuildHuffmanCodes(JPEGStandardTables::DC_LUMINANCE_COUNTS, JPEGStandardTables::DC_LUMINANCE_VALUES, dcCodes[0]);
+            BuildHuffmanCodes(JPEGStandardTables::DC_CHROMINANCE_COUNTS, JPEGStandardTables::DC_CHROMINANCE_VALUES, dcCodes[1]);
+            BuildHuffmanCodes(JPEGStandardTables::AC_LUMINANCE_COUNTS, JPEGStandardTables::AC_LUMINANCE_VALUES, acCodes[0]);
+            BuildHuffmanCodes(JPEGStandardTables::AC_CHROMINANCE_COUNTS, JPEGStandardTables::AC_CHROMINANCE_VALUES, acCodes[1]);
+
+            // Headers
+            std::vector<unsigned char> result;
+            result.reserve((size_t)width * height / 2 + 1024);
+            WriteMarker(result, 0xD8);
+
+            WriteMarker(result, 0xDB);
+            WriteUInt16(result, 2 + 2 * 65);
+            for (int t = 0; t < 2; t++)
+            {
+                result.push_back((unsigned char)t);
+                for (int k = 0; k < 64; k++) result.push_back(quantizationTables[t][JPEGStandardTables::ZIGZAG_TO_NATURAL[k]]);
+            }
+
+            WriteMarker(result, 0xC0);
+            WriteUInt16(result, 8 + 3 * 3);
+            result.push_back(8);
+            WriteUInt16(result, height);
+            WriteUInt16(result, width);
+            result.push_back(3);
+            for (int c = 0; c < 3; c++)
+            {
+                result.push_back((unsigned char)(c + 1));
+                result.push_back(c == 0 ? (unsigned char)((horizontalSampling << 4) | verticalSampling) : 0x11);
+                result.push_back(c == 0 ? 0 : 1);
+            }
+
+            if (restartInterval > 0)
+            {
+                WriteMarker(result, 0xDD);
+                WriteUInt16(result, 4);
+                WriteUInt16(result, restartInterval);
+            }
+
+            WriteMarker(result, 0xDA);
+            WriteUInt16(result, 6 + 2 * 3);
+            result.push_back(3);
+            for (int c = 0; c < 3; c++)
+            {
+                result.push_back((unsigned char)(c + 1));
+                result.push_back(c == 0 ? 0x00 : 0x11);
+            }
+            result.push_back(0);
+            result.push_back(63);
+            result.push_back(0);
+
+            // Scan
+            const int mcuWidth = horizontalSampling * 8;
+            const int mcuHeight = verticalSampling * 8;
+            const int numOfMCUsX = (width + mcuWidth - 1) / mcuWidth;
+            const int numOfMCUsY = (height + mcuHeight - 1) / mcuHeight;
+            const int numOfMCUs = numOfMCUsX * numOfMCUsY;
+
+            BitWriter writer(result);
+            int dcPredictions[3] = { 0, 0, 0 };
+            float planes[3][16 * 16];
+            float block[64];
+            for (int mcu = 0; mcu < numOfMCUs; mcu++)
+            {
+                // Restart marker
+                if (restartInterval > 0 && mcu > 0 && mcu % restartInterval == 0)
+                {
+                    writer.Flush();
+                    WriteMarker(result, (unsigned char)(0xD0 + (mcu / restartInterval - 1) % 8));
+                    dcPredictions[0] = dcPredictions[1] = dcPredictions[2] = 0;
+                }
+
+                // Convert the MCU into YCbCr. The edge pixels are repeated.
+                const int x0 = (mcu % numOfMCUsX) * mcuWidth;
+                const int y0 = (mcu / numOfMCUsX) * mcuHeight;
+                for (int y = 0; y < mcuHeight; y++)
+                {
+                    const int imageY = std::min(y0 + y, height - 1);
+                    const unsigned char* row = bgr + (size_t)(isBottomUp ? height - 1 - imageY : imageY) * width * 3;
+                    for (int x = 0; x < mcuWidth; x++)
+                    {
+                        const unsigned char* pixel = row + std::min(x0 + x, width - 1) * 3;
+                        const float b = pixel[0];
+                        const float g = pixel[1];
+                        const float r = pixel[2];
+                        planes[0][y * 16 + x] = 0.299f * r + 0.587f * g + 0.114f * b;
+                        planes[1][y * 16 + x] = -0.168736f * r - 0.331264f * g + 0.5f * b + 128.0f;
+                        planes[2][y * 16 + x] = 0.5f * r - 0.418688f * g - 0.081312f * b + 128.0f;
+                    }
+                }
+
+                // Luma blocks
+                for (int blockY = 0; blockY < verticalSampling; blockY++)
+                {
+                    for (int blockX = 0; blockX < horizontalSampling; blockX++)
+                    {
+                        for (int y = 0; y < 8; y++)
+                        {
+                            for (int x = 0; x < 8; x++) block[y * 8 + x] = planes[0][(blockY * 8 + y) * 16 + blockX * 8 + x];
+                        }
+                        EncodeBlock(writer, block, quantizationTables[0], dcCodes[0], acCodes[0], dcPredictions[0]);
+                    }
+                }
+
+                // Chroma blocks, average of the subsampled pixels
+                for (int c = 1; c < 3; c++)
+                {
+                    for (int y = 0; y < 8; y++)
+                    {
+                        for (int x = 0; x < 8; x++)
+                        {
+                            float sum = 0;
+                            for (int j = 0; j < verticalSampling; j++)
+                            {
+                                for (int i = 0; i < horizontalSampling; i++) sum += planes[c][(y * verticalSampling + j) * 16 + x * horizontalSampling + i];
+                            }
+                            block[y * 8 + x] = sum / (horizontalSampling * verticalSampling);
+                        }
+                    }
+                    EncodeBlock(writer, block, quantizationTables[1], dcCodes[1], acCodes[1], dcPredictions[c]);
+                }
+            }
+            writer.Flush();
+
+            WriteMarker(result, 0xD9);
+
+            return result;
+        }
+
+    private:
+
+        /**
+         * @brief Huffman code and its length of each symbol
+        */
+        struct HuffmanCodes
+        {
+            unsigned short Codes[256] = {};
+            unsigned char Sizes[256] = {};
+        };
+
+        /**
+         * @brief Write the entropy coded data with the byte stuffing
+        */
+        class BitWriter
+        {
+        public:
+            explicit BitWriter(std::vector<unsigned char>& output) :
+                m_output(output)
+            {
+            }
+
+            void Write(const unsigned int bits, const int size)
+            {
+                for (int i = size - 1; i >= 0; i--)
+                {
+                    m_buffer = (m_buffer << 1) | ((bits >> i) & 1);
+                    if (++m_numOfBits == 8)
+                    {
+                        m_output.push_back((unsigned char)m_buffer);
+                        if (m_buffer == 0xFF) m_output.push_back(0x00);
+                        m_buffer = 0;
+                        m_numOfBits = 0;
+                    }
+                }
+            }
+
+            /**
+             * @brief Pad the last byte with 1 bits
+            */
+            void Flush()
+            {
+                if (m_numOfBits > 0) Write(0x7F, 8 - m_numOfBits);
+            }
+
+        private:
+            std::vector<unsigned char>& m_output;
+            unsigned int m_buffer = 0;
+            int m_numOfBits = 0;
+        };
+
+        static void WriteMarker(std::vector<unsigned char>& output, const unsigned char marker)
+        {
+            output.push_back(0xFF);
+            output.push_back(marker);
+        }
+
+        static void WriteUInt16(std::vector<unsigned char>& output, const int value)
+        {
+            output.push_back((unsigned char)(value >> 8));
+            output.push_back((unsigned char)(value & 0xFF));
+        }
+
+        /**
+         * @brief Scale a quantization table by the quality as libjpeg does
+        */
+        static void ScaleQuantizationTable(const unsigned char* table, const int quality, unsigned char* result)
+        {
+            const int scale = quality < 50 ? 5000 / quality : 200 - quality * 2;
+            for (int i = 0; i < 64; i++)
+            {
+                result[i] = (unsigned char)std::clamp((table[i] * scale + 50) / 100, 1, 255);
+            }
+        }
+
+        static void BuildHuffmanCodes(const unsigned char counts[16], const unsigned char* values, HuffmanCodes& result)
+        {
+            int code = 0;
+            int k = 0;
+            for (int length = 1; length <= 16; length++)
+            {
+                for (int i = 0; i < counts[length - 1]; i++)
+                {
+                    result.Codes[values[k]] = (unsigned short)code++;
+                    result.Sizes[values[k]] = (unsigned char)length;
+                    k++;
+                }
+                code <<= 1;
+            }
+        }
+
+        /**
+         * @brief Get the magnitude category of a coefficient
+        */
+        static int getCategory(int value)
+        {
+            value = std::abs(value);
+            int result = 0;
+            while (value > 0)
+            {
+                value >>= 1;
+                result++;
+            }
+            return result;
+        }
+
+        /**
+         * @brief Forward DCT, quantize and entropy code a block
+        */
+        static void EncodeBlock(
+            BitWriter& writer,
+            const float block[64],
+            const unsigned char quantizationTable[64],
+            const HuffmanCodes& dcCodes,
+            const HuffmanCodes& acCodes,
+            int& dcPrediction
+        )
+        {
+            // cosines[x][u] = C(u) / 2 * cos((2x + 1)u * pi / 16)
+            static const std::array<std::array<float, 8>, 8> cosines = []()
+            {
+                std::array<std::array<float, 8>, 8> result{};
+                for (int x = 0; x < 8; x++)
+                {
+                    for (int u = 0; u < 8; u++)
+                    {
+                        result[x][u] = (float)((u == 0 ? std::sqrt(0.5) : 1.0) / 2 * std::cos((2 * x + 1) * u * 3.14159265358979323846 / 16));
+                    }
+                }
+                return result;
+            }();
+
+            // Separable DCT of the level shifted block
+            float rows[64];
+            for (int y = 0; y < 8; y++)
+            {
+                for (int u = 0; u < 8; u++)
+                {
+                    float sum = 0;
+                    for (int x = 0; x < 8; x++) sum += cosines[x][u] * (block[y * 8 + x] - 128.0f);
+                    rows[y * 8 + u] = sum;
+                }
+            }
+
+            int coefficients[64];
+            for (int v = 0; v < 8; v++)
+            {
+                for (int u = 0; u < 8; u++)
+                {
+                    float sum = 0;
+                    for (int y = 0; y < 8; y++) sum += cosines[y][v] * rows[y * 8 + u];
+                    coefficients[v * 8 + u] = (int)std::lround(sum / quantizationTable[v * 8 + u]);
+                }
+            }
+
+            // DC
+            const int dc = coefficients[0];
+            const int difference = dc - dcPrediction;
+            dcPrediction = dc;
+            const int dcCategory = getCategory(difference);
+            writer.Write(dcCodes.Codes[dcCategory], dcCodes.Sizes[dcCategory]);
+            if (dcCategory > 0) writer.Write(difference < 0 ? difference + (1 << dcCategory) - 1 : difference, dcCategory);
+
+            // AC
+            int run = 0;
+            for (int k = 1; k < 64; k++)
+            {
+                const int value = coefficients[JPEGStandardTables::ZIGZAG_TO_NATURAL[k]];
+                if (value == 0)
+                {
+                    run++;
+                    continue;
+                }
+
+                while (run > 15)
+                {
+                    writer.Write(acCodes.Codes[0xF0], acCodes.Sizes[0xF0]);
+                    run -= 16;
+                }
+
+                const int category = getCategory(value);
+                const int symbol = (run << 4) | category;
+                writer.Write(acCodes.Codes[symbol], acCodes.Sizes[symbol]);
+                writer.Write(value < 0 ? value + (1 << category) - 1 : value, category);
+                run = 0;
+            }
+
+            // End of block
+            if (run > 0) writer.Write(acCodes.Codes[0x00], acCodes.Sizes[0x00]);
+        }
+    };
+}
+
+
+//*******************************
+
+#endif
@@ -17,6 +17,18 @@ static const GUID MEDIASUBTYPE_GREY = { 0x59455247, 0x0000, 0x0010,{ 0x80, 0x00,
 static const GUID MEDIASUBTYPE_Y8 = { 0x20203859, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 } };
 static const GUID MEDIASUBTYPE_Y800 = { 0x30303859, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 } };
 static const GUID MEDIASUBTYPE_Y16 = { 0x20363159, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };
+static const GUID MEDIASUBTYPE_Y10 = { 0x20303159, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };
+static const GUID MEDIASUBTYPE_Y12 = { 0x20323159, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };
+static const GUID MEDIASUBTYPE_Y10P = { 0x50303159, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };
+static const GUID MEDIASUBTYPE_Y12P = { 0x50323159, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };
+static const GUID MEDIASUBTYPE_BA81 = { 0x31384142, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };   // 8bit Bayer BGGR
+static const GUID MEDIASUBTYPE_GBRG = { 0x47524247, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };   // 8bit Bayer GBRG
+static const GUID MEDIASUBTYPE_GRBG = { 0x47425247, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };   // 8bit Bayer GRBG
+static const GUID MEDIASUBTYPE_RGGB = { 0x42474752, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };   // 8bit Bayer RGGB
+static const GUID MEDIASUBTYPE_BYR2 = { 0x32525942, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };   // 16bit Bayer BGGR
+static const GUID MEDIASUBTYPE_GB16 = { 0x36314247, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };   // 16bit Bayer GBRG
+static const GUID MEDIASUBTYPE_GR16 = { 0x36315247, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };   // 16bit Bayer GRBG
+static const GUID MEDIASUBTYPE_RG16 = { 0x36314752, 0x0000, 0x0010,{ 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };   // 16bit Bayer RGGB
 
 // The following has been included in the Windows SDK (uuids.h) so ignore it.
 /*
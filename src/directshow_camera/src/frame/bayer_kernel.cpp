@@ -0,0 +1,760 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "frame/bayer_kernel.h"
+
+#include "frame/simd_pixel_store.h"
+#include "utils/cpu_utils.h"
+
+#ifdef DIRECTSHOW_CAMERA_X86
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace DirectShowCamera
+{
+    namespace
+    {
+        bool isRGBOrder(const YUVOutputFormat outputFormat)
+        {
+            return outputFormat == YUVOutputFormat::RGB24 || outputFormat == YUVOutputFormat::RGBA32;
+        }
+
+        bool isRedRow(const BayerPattern rowPattern)
+        {
+            return rowPattern == BayerPattern::RGGB || rowPattern == BayerPattern::GRBG;
+        }
+
+        void CheckOutputFormat(const YUVOutputFormat outputFormat)
+        {
+            if (outputFormat == YUVOutputFormat::Gray8)
+            {
+                throw std::invalid_argument("Gray8 output is not supported by the Bayer demosaic.");
+            }
+        }
+
+        inline unsigned char Average(const int a, const int b)
+        {
+            return (unsigned char)((a + b + 1) >> 1);
+        }
+
+        inline unsigned char Clamp(const int value)
+        {
+            return (unsigned char)std::clamp(value, 0, 255);
+        }
+
+        inline void StorePixel(unsigned char* outputData, const unsigned char c0, const unsigned char c1, const unsigned char c2, const bool hasAlpha)
+        {
+            outputData[0] = c0;
+            outputData[1] = c1;
+            outputData[2] = c2;
+            if (hasAlpha) outputData[3] = 255;
+        }
+
+        /**
+         * @brief Positions of red and blue in a 2 x 2 block. 0 and 1 are the even and odd samples of the even row, 2 and 3 are of the odd row.
+         *        Green is at the other 2 positions.
+        */
+        struct SuperpixelSites
+        {
+            int Red;
+            int Blue;
+            int Green0;
+            int Green1;
+        };
+
+        constexpr SuperpixelSites getSuperpixelSites(const BayerPattern pattern)
+        {
+            switch (pattern)
+            {
+            case BayerPattern::RGGB:
+                return { 0, 3, 1, 2 };
+            case BayerPattern::BGGR:
+                return { 3, 0, 1, 2 };
+            case BayerPattern::GRBG:
+                return { 1, 2, 0, 3 };
+            default:
+                return { 2, 1, 0, 3 };
+            }
+        }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+        DIRECTSHOW_CAMERA_TARGET("sse2")
+        inline __m128i Blend(const __m128i mask, const __m128i a, const __m128i b)
+        {
+            return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+
+        DIRECTSHOW_CAMERA_TARGET("avx2")
+        inline __m256i Blend(const __m256i mask, const __m256i a, const __m256i b)
+        {
+            return _mm256_or_si256(_mm256_and_si256(mask, a), _mm256_andnot_si256(mask, b));
+        }
+
+        DIRECTSHOW_CAMERA_TARGET("sse2")
+        inline __m128i Load8SSE2(const unsigned char* data)
+        {
+            return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)data), _mm_setzero_si128());
+        }
+
+        DIRECTSHOW_CAMERA_TARGET("avx2")
+        inline __m256i Load16AVX2(const unsigned char* data)
+        {
+            return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)data));
+        }
+
+        /**
+         * @brief Store 16 pixels of the first color, green and the second color
+        */
+        DIRECTSHOW_CAMERA_TARGET("ssse3")
+        inline void StoreColorsSSSE3(const __m128i c, const __m128i g, const __m128i d, unsigned char* outputData, const bool firstColorFirst, const bool hasAlpha)
+        {
+            if (firstColorFirst)
+            {
+                StorePixelsSSSE3(c, g, d, outputData, hasAlpha);
+            }
+            else
+            {
+                StorePixelsSSSE3(d, g, c, outputData, hasAlpha);
+            }
+        }
+
+        /**
+         * @brief Store 32 pixels of the first color, green and the second color
+        */
+        DIRECTSHOW_CAMERA_TARGET("avx2")
+        inline void StoreColorsAVX2(const __m256i c, const __m256i g, const __m256i d, unsigned char* outputData, const bool firstColorFirst, const bool hasAlpha)
+        {
+            const int bytesPerPixel = hasAlpha ? 4 : 3;
+            StoreColorsSSSE3(_mm256_castsi256_si128(c), _mm256_castsi256_si128(g), _mm256_castsi256_si128(d), outputData, firstColorFirst, hasAlpha);
+            StoreColorsSSSE3(_mm256_extracti128_si256(c, 1), _mm256_extracti128_si256(g, 1), _mm256_extracti128_si256(d, 1), outputData + 16 * bytesPerPixel, firstColorFirst, hasAlpha);
+        }
+
+        /**
+         * @brief Edge-aware demosaic of 8 pixels in 16-bit lanes. See BayerKernel::EdgeAwareRowScalar() for the formulas.
+         * @param[in] rows 5 padded rows
+         * @param[in] x First pixel
+         * @param[in] colorMask 16-bit mask of the first color pixels
+         * @param[out] c First color
+         * @param[out] g Green
+         * @param[out] d Second color
+        */
+        DIRECTSHOW_CAMERA_TARGET("ssse3")
+        inline void EdgeAware8SSSE3(const unsigned char* const* rows, const int x, const __m128i colorMask, __m128i& c, __m128i& g, __m128i& d)
+        {
+            const unsigned char* a2 = rows[0] + x;
+            const unsigned char* a1 = rows[1] + x;
+            const unsigned char* r = rows[2] + x;
+            const unsigned char* b1 = rows[3] + x;
+            const unsigned char* b2 = rows[4] + x;
+
+            const __m128i r0 = Load8SSE2(r);
+            const __m128i horizontal1 = _mm_add_epi16(Load8SSE2(r - 1), Load8SSE2(r + 1));
+            const __m128i horizontal2 = _mm_add_epi16(Load8SSE2(r - 2), Load8SSE2(r + 2));
+            const __m128i vertical1 = _mm_add_epi16(Load8SSE2(a1), Load8SSE2(b1));
+            const __m128i vertical2 = _mm_add_epi16(Load8SSE2(a2), Load8SSE2(b2));
+            const __m128i diagonal = _mm_add_epi16(_mm_add_epi16(Load8SSE2(a1 - 1), Load8SSE2(a1 + 1)), _mm_add_epi16(Load8SSE2(b1 - 1), Load8SSE2(b1 + 1)));
+            const __m128i r0x2 = _mm_add_epi16(r0, r0);
+            const __m128i eight = _mm_set1_epi16(8);
+
+            // Green at the color pixels, along the smoother direction
+            const __m128i laplacianH = _mm_sub_epi16(r0x2, horizontal2);
+            const __m128i laplacianV = _mm_sub_epi16(r0x2, vertical2);
+            const __m128i gradientH = _mm_add_epi16(_mm_abs_epi16(_mm_sub_epi16(Load8SSE2(r - 1), Load8SSE2(r + 1))), _mm_abs_epi16(laplacianH));
+            const __m128i gradientV = _mm_add_epi16(_mm_abs_epi16(_mm_sub_epi16(Load8SSE2(a1), Load8SSE2(b1))), _mm_abs_epi16(laplacianV));
+            const __m128i greenH = _mm_add_epi16(_mm_slli_epi16(horizontal1, 1), laplacianH);
+            const __m128i greenV = _mm_add_epi16(_mm_slli_epi16(vertical1, 1), laplacianV);
+            const __m128i greenHV = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(greenH, greenV), _mm_set1_epi16(1)), 1);
+            __m128i green = Blend(_mm_cmplt_epi16(gradientV, gradientH), greenV, greenHV);
+            green = Blend(_mm_cmplt_epi16(gradientH, gradientV), greenH, green);
+            green = _mm_srai_epi16(_mm_add_epi16(green, _mm_set1_epi16(2)), 2);
+
+            // Second color at the color pixels: 4 * diagonal + 12 * r0 - 3 * (horizontal2 + vertical2)
+            const __m128i axial2 = _mm_add_epi16(horizontal2, vertical2);
+            __m128i colorD = _mm_sub_epi16(_mm_add_epi16(_mm_slli_epi16(diagonal, 2), _mm_mullo_epi16(r0, _mm_set1_epi16(12))), _mm_mullo_epi16(axial2, _mm_set1_epi16(3)));
+            colorD = _mm_srai_epi16(_mm_add_epi16(colorD, eight), 4);
+
+            // Colors at the green pixels
+            const __m128i common = _mm_sub_epi16(_mm_mullo_epi16(r0, _mm_set1_epi16(10)), _mm_add_epi16(diagonal, diagonal));
+            __m128i greenC = _mm_add_epi16(_mm_sub_epi16(_mm_add_epi16(_mm_slli_epi16(horizontal1, 3), common), _mm_add_epi16(horizontal2, horizontal2)), vertical2);
+            __m128i greenD = _mm_add_epi16(_mm_sub_epi16(_mm_add_epi16(_mm_slli_epi16(vertical1, 3), common), _mm_add_epi16(vertical2, vertical2)), horizontal2);
+            greenC = _mm_srai_epi16(_mm_add_epi16(greenC, eight), 4);
+            greenD = _mm_srai_epi16(_mm_add_epi16(greenD, eight), 4);
+
+            c = Blend(colorMask, r0, greenC);
+            g = Blend(colorMask, green, r0);
+            d = Blend(colorMask, colorD, greenD);
+        }
+
+        /**
+         * @brief Edge-aware demosaic of 16 pixels in 16-bit lanes. See EdgeAware8SSSE3().
+        */
+        DIRECTSHOW_CAMERA_TARGET("avx2")
+        inline void EdgeAware16AVX2(const unsigned char* const* rows, const int x, const __m256i colorMask, __m256i& c, __m256i& g, __m256i& d)
+        {
+            const unsigned char* a2 = rows[0] + x;
+            const unsigned char* a1 = rows[1] + x;
+            const unsigned char* r = rows[2] + x;
+            const unsigned char* b1 = rows[3] + x;
+            const unsigned char* b2 = rows[4] + x;
+
+            const __m256i r0 = Load16AVX2(r);
+            const __m256i horizontal1 = _mm256_add_epi16(Load16AVX2(r - 1), Load16AVX2(r + 1));
+            const __m256i horizontal2 = _mm256_add_epi16(Load16AVX2(r - 2), Load16AVX2(r + 2));
+            const __m256i vertical1 = _mm256_add_epi16(Load16AVX2(a1), Load16AVX2(b1));
+            const __m256i vertical2 = _mm256_add_epi16(Load16AVX2(a2), Load16AVX2(b2));
+            const __m256i diagonal = _mm256_add_epi16(_mm256_add_epi16(Load16AVX2(a1 - 1), Load16AVX2(a1 + 1)), _mm256_add_epi16(Load16AVX2(b1 - 1), Load16AVX2(b1 + 1)));
+            const __m256i r0x2 = _mm256_add_epi16(r0, r0);
+            const __m256i eight = _mm256_set1_epi16(8);
+
+            // Green at the color pixels, along the smoother direction
+            const __m256i laplacianH = _mm256_sub_epi16(r0x2, horizontal2);
+            const __m256i laplacianV = _mm256_sub_epi16(r0x2, vertical2);
+            const __m256i gradientH = _mm256_add_epi16(_mm256_abs_epi16(_mm256_sub_epi16(Load16AVX2(r - 1), Load16AVX2(r + 1))), _mm256_abs_epi16(laplacianH));
+            const __m256i gradientV = _mm256_add_epi16(_mm256_abs_epi16(_mm256_sub_epi16(Load16AVX2(a1), Load16AVX2(b1))), _mm256_abs_epi16(laplacianV));
+            const __m256i greenH = _mm256_add_epi16(_mm256_slli_epi16(horizontal1, 1), laplacianH);
+            const __m256i greenV = _mm256_add_epi16(_mm256_slli_epi16(vertical1, 1), laplacianV);
+            const __m256i greenHV = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(greenH, greenV), _mm256_set1_epi16(1)), 1);
+            __m256i green = Blend(_mm256_cmpgt_epi16(gradientH, gradientV), greenV, greenHV);
+            green = Blend(_mm256_cmpgt_epi16(gradientV, gradientH), greenH, green);
+            green = _mm256_srai_epi16(_mm256_add_epi16(green, _mm256_set1_epi16(2)), 2);
+
+            // Second color at the color pixels
+            const __m256i axial2 = _mm256_add_epi16(horizontal2, vertical2);
+            __m256i colorD = _mm256_sub_epi16(_mm256_add_epi16(_mm256_slli_epi16(diagonal, 2), _mm256_mullo_epi16(r0, _mm256_set1_epi16(12))), _mm256_mullo_epi16(axial2, _mm256_set1_epi16(3)));
+            colorD = _mm256_srai_epi16(_mm256_add_epi16(colorD, eight), 4);
+
+            // Colors at the green pixels
+            const __m256i common = _mm256_sub_epi16(_mm256_mullo_epi16(r0, _mm256_set1_epi16(10)), _mm256_add_epi16(diagonal, diagonal));
+            __m256i greenC = _mm256_add_epi16(_mm256_sub_epi16(_mm256_add_epi16(_mm256_slli_epi16(horizontal1, 3), common), _mm256_add_epi16(horizontal2, horizontal2)), vertical2);
+            __m256i greenD = _mm256_add_epi16(_mm256_sub_epi16(_mm256_add_epi16(_mm256_slli_epi16(vertical1, 3), common), _mm256_add_epi16(vertical2, vertical2)), horizontal2);
+            greenC = _mm256_srai_epi16(_mm256_add_epi16(greenC, eight), 4);
+            greenD = _mm256_srai_epi16(_mm256_add_epi16(greenD, eight), 4);
+
+            c = Blend(colorMask, r0, greenC);
+            g = Blend(colorMask, green, r0);
+            d = Blend(colorMask, colorD, greenD);
+        }
+
+        /**
+         * @brief Split 32 samples into the 16 even and the 16 odd samples
+        */
+        DIRECTSHOW_CAMERA_TARGET("sse2")
+        inline void Deinterleave32SSE2(const unsigned char* data, __m128i& even, __m128i& odd)
+        {
+            const __m128i lowMask = _mm_set1_epi16(0x00FF);
+            const __m128i v0 = _mm_loadu_si128((const __m128i*)data);
+            const __m128i v1 = _mm_loadu_si128((const __m128i*)(data + 16));
+            even = _mm_packus_epi16(_mm_and_si128(v0, lowMask), _mm_and_si128(v1, lowMask));
+            odd = _mm_packus_epi16(_mm_srli_epi16(v0, 8), _mm_srli_epi16(v1, 8));
+        }
+
+        /**
+         * @brief Split 64 samples into the 32 even and the 32 odd samples
+        */
+        DIRECTSHOW_CAMERA_TARGET("avx2")
+        inline void Deinterleave64AVX2(const unsigned char* data, __m256i& even, __m256i& odd)
+        {
+            const __m256i lowMask = _mm256_set1_epi16(0x00FF);
+            const __m256i v0 = _mm256_loadu_si256((const __m256i*)data);
+            const __m256i v1 = _mm256_loadu_si256((const __m256i*)(data + 32));
+
+            // The byte pack interleaves the lanes of the 2 inputs
+            even = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_and_si256(v0, lowMask), _mm256_and_si256(v1, lowMask)), 0xD8);
+            odd = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_srli_epi16(v0, 8), _mm256_srli_epi16(v1, 8)), 0xD8);
+        }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+    }
+
+#pragma region Padding
+
+    void BayerKernel::PadRow(unsigned char* row, const int width)
+    {
+        for (int i = 1; i <= RowPadding; i++)
+        {
+            row[-i] = row[getReflectedIndex(-i, width)];
+            row[width - 1 + i] = row[getReflectedIndex(width - 1 + i, width)];
+        }
+    }
+
+#pragma endregion Padding
+
+#pragma region Demosaic
+
+    BayerKernel::RowLayout BayerKernel::getRowLayout(const BayerPattern rowPattern, const YUVOutputFormat outputFormat)
+    {
+        RowLayout layout;
+        layout.FirstColorAtEven = rowPattern == BayerPattern::RGGB || rowPattern == BayerPattern::BGGR;
+        layout.FirstColorFirst = isRedRow(rowPattern) == isRGBOrder(outputFormat);
+        layout.HasAlpha = YUVKernel::getBytesPerPixel(outputFormat) == 4;
+        return layout;
+    }
+
+    void BayerKernel::DemosaicRow(
+        const unsigned char* const* rows,
+        unsigned char* outputData,
+        const int width,
+        const BayerPattern rowPattern,
+        const BayerDemosaic demosaic,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        DemosaicRow(rows, outputData, width, rowPattern, demosaic, outputFormat, SwizzleKernel::getSIMDLevel());
+    }
+
+    void BayerKernel::DemosaicRow(
+        const unsigned char* const* rows,
+        unsigned char* outputData,
+        const int width,
+        const BayerPattern rowPattern,
+        const BayerDemosaic demosaic,
+        const YUVOutputFormat outputFormat,
+        const SIMDLevel simdLevel
+    )
+    {
+        CheckOutputFormat(outputFormat);
+        const RowLayout layout = getRowLayout(rowPattern, outputFormat);
+
+        switch (std::min(simdLevel, SwizzleKernel::getSIMDLevel()))
+        {
+        case SIMDLevel::AVX2:
+            if (demosaic == BayerDemosaic::EdgeAware) EdgeAwareRowAVX2(rows, outputData, 0, width, layout);
+            else BilinearRowAVX2(rows, outputData, 0, width, layout);
+            break;
+        case SIMDLevel::SSSE3:
+            if (demosaic == BayerDemosaic::EdgeAware) EdgeAwareRowSSSE3(rows, outputData, 0, width, layout);
+            else BilinearRowSSSE3(rows, outputData, 0, width, layout);
+            break;
+        default:
+            if (demosaic == BayerDemosaic::EdgeAware) EdgeAwareRowScalar(rows, outputData, 0, width, layout);
+            else BilinearRowScalar(rows, outputData, 0, width, layout);
+            break;
+        }
+    }
+
+    void BayerKernel::BilinearRowScalar(
+        const unsigned char* const* rows,
+        unsigned char* outputData,
+        const int startX,
+        const int endX,
+        const RowLayout& layout
+    )
+    {
+        // Nested averages of 2 samples, the same rounding as the SIMD byte average
+        const unsigned char* a = rows[0];
+        const unsigned char* r = rows[1];
+        const unsigned char* b = rows[2];
+        const int bytesPerPixel = layout.HasAlpha ? 4 : 3;
+
+        for (int x = startX; x < endX; x++)
+        {
+            unsigned char c, g, d;
+            if (((x % 2) == 0) == layout.FirstColorAtEven)
+            {
+                c = r[x];
+                g = Average(Average(r[x - 1], r[x + 1]), Average(a[x], b[x]));
+                d = Average(Average(a[x - 1], a[x + 1]), Average(b[x - 1], b[x + 1]));
+            }
+            else
+            {
+                c = Average(r[x - 1], r[x + 1]);
+                g = r[x];
+                d = Average(a[x], b[x]);
+            }
+
+            if (layout.FirstColorFirst)
+            {
+                StorePixel(outputData + x * bytesPerPixel, c, g, d, layout.HasAlpha);
+            }
+            else
+            {
+                StorePixel(outputData + x * bytesPerPixel, d, g, c, layout.HasAlpha);
+            }
+        }
+    }
+
+    void BayerKernel::EdgeAwareRowScalar(
+        const unsigned char* const* rows,
+        unsigned char* outputData,
+        const int startX,
+        const int endX,
+        const RowLayout& layout
+    )
+    {
+        // Green at the color pixels is interpolated along the direction with the smaller gradient, or averaged if both are equal.
+        // The other colors are bilinear corrected by the laplacian of the pixel (Malvar-He-Cutler), in 16 times fixed point.
+        const unsigned char* a2 = rows[0];
+        const unsigned char* a1 = rows[1];
+        const unsigned char* r = rows[2];
+        const unsigned char* b1 = rows[3];
+        const unsigned char* b2 = rows[4];
+        const int bytesPerPixel = layout.HasAlpha ? 4 : 3;
+
+        for (int x = startX; x < endX; x++)
+        {
+            const int r0 = r[x];
+            const int horizontal1 = r[x - 1] + r[x + 1];
+            const int horizontal2 = r[x - 2] + r[x + 2];
+            const int vertical1 = a1[x] + b1[x];
+            const int vertical2 = a2[x] + b2[x];
+            const int diagonal = a1[x - 1] + a1[x + 1] + b1[x - 1] + b1[x + 1];
+
+            unsigned char c, g, d;
+            if (((x % 2) == 0) == layout.FirstColorAtEven)
+            {
+                const int laplacianH = 2 * r0 - horizontal2;
+                const int laplacianV = 2 * r0 - vertical2;
+                const int gradientH = std::abs(r[x - 1] - r[x + 1]) + std::abs(laplacianH);
+                const int gradientV = std::abs(a1[x] - b1[x]) + std::abs(laplacianV);
+                const int greenH = 2 * horizontal1 + laplacianH;
+                const int greenV = 2 * vertical1 + laplacianV;
+
+                int green = (greenH + greenV + 1) >> 1;
+                if (gradientH < gradientV) green = greenH;
+                else if (gradientV < gradientH) green = greenV;
+
+                c = (unsigned char)r0;
+                g = Clamp((green + 2) >> 2);
+                d = Clamp((4 * diagonal + 12 * r0 - 3 * (horizontal2 + vertical2) + 8) >> 4);
+            }
+            else
+            {
+                const int common = 10 * r0 - 2 * diagonal;
+                c = Clamp((8 * horizontal1 + common - 2 * horizontal2 + vertical2 + 8) >> 4);
+                g = (unsigned char)r0;
+                d = Clamp((8 * vertical1 + common - 2 * vertical2 + horizontal2 + 8) >> 4);
+            }
+
+            if (layout.FirstColorFirst)
+            {
+                StorePixel(outputData + x * bytesPerPixel, c, g, d, layout.HasAlpha);
+            }
+            else
+            {
+                StorePixel(outputData + x * bytesPerPixel, d, g, c, layout.HasAlpha);
+            }
+        }
+    }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+    DIRECTSHOW_CAMERA_TARGET("ssse3")
+    void BayerKernel::BilinearRowSSSE3(
+        const unsigned char* const* rows,
+        unsigned char* outputData,
+        const int startX,
+        const int endX,
+        const RowLayout& layout
+    )
+    {
+        // 16 pixels per iteration. startX is even, so the lane parity is the pixel parity.
+        const unsigned char* a = rows[0];
+        const unsigned char* r = rows[1];
+        const unsigned char* b = rows[2];
+        const int bytesPerPixel = layout.HasAlpha ? 4 : 3;
+        const __m128i evenMask = _mm_set1_epi16(0x00FF);
+        const __m128i colorMask = layout.FirstColorAtEven ? evenMask : _mm_xor_si128(evenMask, _mm_set1_epi8(-1));
+
+        int x = startX;
+        for (; x + 16 <= endX; x += 16)
+        {
+            const __m128i r0 = _mm_loadu_si128((const __m128i*)(r + x));
+            const __m128i horizontal = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(r + x - 1)), _mm_loadu_si128((const __m128i*)(r + x + 1)));
+            const __m128i vertical = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(a + x)), _mm_loadu_si128((const __m128i*)(b + x)));
+            const __m128i diagonal = _mm_avg_epu8(
+                _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(a + x - 1)), _mm_loadu_si128((const __m128i*)(a + x + 1))),
+                _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(b + x - 1)), _mm_loadu_si128((const __m128i*)(b + x + 1)))
+            );
+
+            const __m128i c = Blend(colorMask, r0, horizontal);
+            const __m128i g = Blend(colorMask, _mm_avg_epu8(horizontal, vertical), r0);
+            const __m128i d = Blend(colorMask, diagonal, vertical);
+            StoreColorsSSSE3(c, g, d, outputData + x * bytesPerPixel, layout.FirstColorFirst, layout.HasAlpha);
+        }
+
+        // Remaining pixels
+        BilinearRowScalar(rows, outputData, x, endX, layout);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2")
+    void BayerKernel::BilinearRowAVX2(
+        const unsigned char* const* rows,
+        unsigned char* outputData,
+        const int startX,
+        const int endX,
+        const RowLayout& layout
+    )
+    {
+        // 32 pixels per iteration
+        const unsigned char* a = rows[0];
+        const unsigned char* r = rows[1];
+        const unsigned char* b = rows[2];
+        const int bytesPerPixel = layout.HasAlpha ? 4 : 3;
+        const __m256i evenMask = _mm256_set1_epi16(0x00FF);
+        const __m256i colorMask = layout.FirstColorAtEven ? evenMask : _mm256_xor_si256(evenMask, _mm256_set1_epi8(-1));
+
+        int x = startX;
+        for (; x + 32 <= endX; x += 32)
+        {
+            const __m256i r0 = _mm256_loadu_si256((const __m256i*)(r + x));
+            const __m256i horizontal = _mm256_avg_epu8(_mm256_loadu_si256((const __m256i*)(r + x - 1)), _mm256_loadu_si256((const __m256i*)(r + x + 1)));
+            const __m256i vertical = _mm256_avg_epu8(_mm256_loadu_si256((const __m256i*)(a + x)), _mm256_loadu_si256((const __m256i*)(b + x)));
+            const __m256i diagonal = _mm256_avg_epu8(
+                _mm256_avg_epu8(_mm256_loadu_si256((const __m256i*)(a + x - 1)), _mm256_loadu_si256((const __m256i*)(a + x + 1))),
+                _mm256_avg_epu8(_mm256_loadu_si256((const __m256i*)(b + x - 1)), _mm256_loadu_si256((const __m256i*)(b + x + 1)))
+            );
+
+            const __m256i c = Blend(colorMask, r0, horizontal);
+            const __m256i g = Blend(colorMask, _mm256_avg_epu8(horizontal, vertical), r0);
+            const __m256i d = Blend(colorMask, diagonal, vertical);
+            StoreColorsAVX2(c, g, d, outputData + x * bytesPerPixel, layout.FirstColorFirst, layout.HasAlpha);
+        }
+
+        // Remaining pixels
+        BilinearRowSSSE3(rows, outputData, x, endX, layout);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("ssse3")
+    void BayerKernel::EdgeAwareRowSSSE3(
+        const unsigned char* const* rows,
+        unsigned char* outputData,
+        const int startX,
+        const int endX,
+        const RowLayout& layout
+    )
+    {
+        // 16 pixels per iteration in 2 halves of 16-bit lanes. startX is even, so the lane parity is the pixel parity.
+        const int bytesPerPixel = layout.HasAlpha ? 4 : 3;
+        const __m128i colorMask = layout.FirstColorAtEven ? _mm_set1_epi32(0x0000FFFF) : _mm_set1_epi32((int)0xFFFF0000);
+
+        int x = startX;
+        for (; x + 16 <= endX; x += 16)
+        {
+            __m128i c0, g0, d0, c1, g1, d1;
+            EdgeAware8SSSE3(rows, x, colorMask, c0, g0, d0);
+            EdgeAware8SSSE3(rows, x + 8, colorMask, c1, g1, d1);
+            StoreColorsSSSE3(_mm_packus_epi16(c0, c1), _mm_packus_epi16(g0, g1), _mm_packus_epi16(d0, d1), outputData + x * bytesPerPixel, layout.FirstColorFirst, layout.HasAlpha);
+        }
+
+        // Remaining pixels
+        EdgeAwareRowScalar(rows, outputData, x, endX, layout);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2")
+    void BayerKernel::EdgeAwareRowAVX2(
+        const unsigned char* const* rows,
+        unsigned char* outputData,
+        const int startX,
+        const int endX,
+        const RowLayout& layout
+    )
+    {
+        // 32 pixels per iteration in 2 halves of 16-bit lanes
+        const int bytesPerPixel = layout.HasAlpha ? 4 : 3;
+        const __m256i colorMask = layout.FirstColorAtEven ? _mm256_set1_epi32(0x0000FFFF) : _mm256_set1_epi32((int)0xFFFF0000);
+
+        int x = startX;
+        for (; x + 32 <= endX; x += 32)
+        {
+            __m256i c0, g0, d0, c1, g1, d1;
+            EdgeAware16AVX2(rows, x, colorMask, c0, g0, d0);
+            EdgeAware16AVX2(rows, x + 16, colorMask, c1, g1, d1);
+
+            // The byte pack interleaves the lanes of the 2 inputs
+            const __m256i c = _mm256_permute4x64_epi64(_mm256_packus_epi16(c0, c1), 0xD8);
+            const __m256i g = _mm256_permute4x64_epi64(_mm256_packus_epi16(g0, g1), 0xD8);
+            const __m256i d = _mm256_permute4x64_epi64(_mm256_packus_epi16(d0, d1), 0xD8);
+            StoreColorsAVX2(c, g, d, outputData + x * bytesPerPixel, layout.FirstColorFirst, layout.HasAlpha);
+        }
+
+        // Remaining pixels
+        EdgeAwareRowSSSE3(rows, outputData, x, endX, layout);
+    }
+
+#else
+
+    void BayerKernel::BilinearRowSSSE3(const unsigned char* const* rows, unsigned char* outputData, const int startX, const int endX, const RowLayout& layout)
+    {
+        BilinearRowScalar(rows, outputData, startX, endX, layout);
+    }
+
+    void BayerKernel::BilinearRowAVX2(const unsigned char* const* rows, unsigned char* outputData, const int startX, const int endX, const RowLayout& layout)
+    {
+        BilinearRowScalar(rows, outputData, startX, endX, layout);
+    }
+
+    void BayerKernel::EdgeAwareRowSSSE3(const unsigned char* const* rows, unsigned char* outputData, const int startX, const int endX, const RowLayout& layout)
+    {
+        EdgeAwareRowScalar(rows, outputData, startX, endX, layout);
+    }
+
+    void BayerKernel::EdgeAwareRowAVX2(const unsigned char* const* rows, unsigned char* outputData, const int startX, const int endX, const RowLayout& layout)
+    {
+        EdgeAwareRowScalar(rows, outputData, startX, endX, layout);
+    }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+
+#pragma endregion Demosaic
+
+#pragma region Superpixel
+
+    void BayerKernel::SuperpixelRow(
+        const unsigned char* row0,
+        const unsigned char* row1,
+        unsigned char* outputData,
+        const int outputWidth,
+        const BayerPattern pattern,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        SuperpixelRow(row0, row1, outputData, outputWidth, pattern, outputFormat, SwizzleKernel::getSIMDLevel());
+    }
+
+    void BayerKernel::SuperpixelRow(
+        const unsigned char* row0,
+        const unsigned char* row1,
+        unsigned char* outputData,
+        const int outputWidth,
+        const BayerPattern pattern,
+        const YUVOutputFormat outputFormat,
+        const SIMDLevel simdLevel
+    )
+    {
+        CheckOutputFormat(outputFormat);
+
+        switch (std::min(simdLevel, SwizzleKernel::getSIMDLevel()))
+        {
+        case SIMDLevel::AVX2:
+            SuperpixelRowAVX2(row0, row1, outputData, 0, outputWidth, pattern, outputFormat);
+            break;
+        case SIMDLevel::SSSE3:
+            SuperpixelRowSSSE3(row0, row1, outputData, 0, outputWidth, pattern, outputFormat);
+            break;
+        default:
+            SuperpixelRowScalar(row0, row1, outputData, 0, outputWidth, pattern, outputFormat);
+            break;
+        }
+    }
+
+    void BayerKernel::SuperpixelRowScalar(
+        const unsigned char* row0,
+        const unsigned char* row1,
+        unsigned char* outputData,
+        const int startX,
+        const int endX,
+        const BayerPattern pattern,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        const auto sites = getSuperpixelSites(pattern);
+        const bool rgbOrder = isRGBOrder(outputFormat);
+        const bool hasAlpha = YUVKernel::getBytesPerPixel(outputFormat) == 4;
+        const int bytesPerPixel = hasAlpha ? 4 : 3;
+
+        for (int x = startX; x < endX; x++)
+        {
+            const unsigned char samples[4] = { row0[x * 2], row0[x * 2 + 1], row1[x * 2], row1[x * 2 + 1] };
+            const unsigned char red = samples[sites.Red];
+            const unsigned char green = Average(samples[sites.Green0], samples[sites.Green1]);
+            const unsigned char blue = samples[sites.Blue];
+
+            if (rgbOrder)
+            {
+                StorePixel(outputData + x * bytesPerPixel, red, green, blue, hasAlpha);
+            }
+            else
+            {
+                StorePixel(outputData + x * bytesPerPixel, blue, green, red, hasAlpha);
+            }
+        }
+    }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+    DIRECTSHOW_CAMERA_TARGET("ssse3")
+    void BayerKernel::SuperpixelRowSSSE3(
+        const unsigned char* row0,
+        const unsigned char* row1,
+        unsigned char* outputData,
+        const int startX,
+        const int endX,
+        const BayerPattern pattern,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        // 16 pixels per iteration
+        const auto sites = getSuperpixelSites(pattern);
+        const bool hasAlpha = YUVKernel::getBytesPerPixel(outputFormat) == 4;
+        const int bytesPerPixel = hasAlpha ? 4 : 3;
+
+        int x = startX;
+        for (; x + 16 <= endX; x += 16)
+        {
+            __m128i samples[4];
+            Deinterleave32SSE2(row0 + x * 2, samples[0], samples[1]);
+            Deinterleave32SSE2(row1 + x * 2, samples[2], samples[3]);
+            const __m128i green = _mm_avg_epu8(samples[sites.Green0], samples[sites.Green1]);
+
+            // The red pixel is the first color of a red row
+            StoreColorsSSSE3(samples[sites.Red], green, samples[sites.Blue], outputData + x * bytesPerPixel, isRGBOrder(outputFormat), hasAlpha);
+        }
+
+        // Remaining pixels
+        SuperpixelRowScalar(row0, row1, outputData, x, endX, pattern, outputFormat);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2")
+    void BayerKernel::SuperpixelRowAVX2(
+        const unsigned char* row0,
+        const unsigned char* row1,
+        unsigned char* outputData,
+        const int startX,
+        const int endX,
+        const BayerPattern pattern,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        // 32 pixels per iteration
+        const auto sites = getSuperpixelSites(pattern);
+        const bool hasAlpha = YUVKernel::getBytesPerPixel(outputFormat) == 4;
+        const int bytesPerPixel = hasAlpha ? 4 : 3;
+
+        int x = startX;
+        for (; x + 32 <= endX; x += 32)
+        {
+            __m256i samples[4];
+            Deinterleave64AVX2(row0 + x * 2, samples[0], samples[1]);
+            Deinterleave64AVX2(row1 + x * 2, samples[2], samples[3]);
+            const __m256i green = _mm256_avg_epu8(samples[sites.Green0], samples[sites.Green1]);
+            StoreColorsAVX2(samples[sites.Red], green, samples[sites.Blue], outputData + x * bytesPerPixel, isRGBOrder(outputFormat), hasAlpha);
+        }
+
+        // Remaining pixels
+        SuperpixelRowSSSE3(row0, row1, outputData, x, endX, pattern, outputFormat);
+    }
+
+#else
+
+    void BayerKernel::SuperpixelRowSSSE3(const unsigned char* row0, const unsigned char* row1, unsigned char* outputData, const int startX, const int endX, const BayerPattern pattern, const YUVOutputFormat outputFormat)
+    {
+        SuperpixelRowScalar(row0, row1, outputData, startX, endX, pattern, outputFormat);
+    }
+
+    void BayerKernel::SuperpixelRowAVX2(const unsigned char* row0, const unsigned char* row1, unsigned char* outputData, const int startX, const int endX, const BayerPattern pattern, const YUVOutputFormat outputFormat)
+    {
+        SuperpixelRowScalar(row0, row1, outputData, startX, endX, pattern, outputFormat);
+    }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+
+#pragma endregion Superpixel
+}
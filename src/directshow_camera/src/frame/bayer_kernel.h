@@ -0,0 +1,206 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__BAYER_KERNEL_H
+#define DIRECTSHOW_CAMERA__FRAME__BAYER_KERNEL_H
+
+//************Content************
+
+#include "frame/frame_settings.h"
+#include "frame/swizzle_kernel.h"
+#include "frame/yuv_kernel.h"
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Color filter array of a Bayer sensor. It is the colors of the first 2 pixels of the first row followed by the first 2 pixels of the second row.
+    */
+    enum class BayerPattern
+    {
+        RGGB,
+        BGGR,
+        GRBG,
+        GBRG
+    };
+
+    /**
+     * @brief Bayer demosaic kernels. Samples are 8 bit, one per pixel.
+     *
+     * A row is demosaiced from its neighbor rows. The rows are padded by RowPadding samples on both sides, see PadRow().
+     * The kernel is selected at runtime by the instruction sets supported by the CPU. All kernels return the same output.
+     */
+    class BayerKernel
+    {
+    public:
+
+        /**
+         * @brief Number of samples before and after a row read by DemosaicRow()
+        */
+        static constexpr int RowPadding = 2;
+
+        /**
+         * @brief Get the number of rows above and below a row read by DemosaicRow()
+         * @param[in] demosaic Demosaic
+         * @return Return 1 for BayerDemosaic::Bilinear, 2 for BayerDemosaic::EdgeAware.
+        */
+        static constexpr int getRadius(const BayerDemosaic demosaic)
+        {
+            return demosaic == BayerDemosaic::EdgeAware ? 2 : 1;
+        }
+
+        /**
+         * @brief Get the pattern starting at a row, i.e. the pattern of an odd row is the pattern with the 2 rows swapped.
+         * @param[in] pattern Pattern of the frame
+         * @param[in] y Row index
+         * @return Return the pattern starting at the row
+        */
+        static constexpr BayerPattern getRowPattern(const BayerPattern pattern, const int y)
+        {
+            if (y % 2 == 0) return pattern;
+            switch (pattern)
+            {
+            case BayerPattern::RGGB:
+                return BayerPattern::GBRG;
+            case BayerPattern::BGGR:
+                return BayerPattern::GRBG;
+            case BayerPattern::GRBG:
+                return BayerPattern::BGGR;
+            default:
+                return BayerPattern::RGGB;
+            }
+        }
+
+        /**
+         * @brief Reflect an index into 0 to size - 1 without repeating the edge, e.g. -1 is 1 and size is size - 2.
+         * @param[in] index Index
+         * @param[in] size Size. It must be >= 2.
+         * @return Return the reflected index
+        */
+        static constexpr int getReflectedIndex(int index, const int size)
+        {
+            while (index < 0 || index >= size)
+            {
+                if (index < 0) index = -index;
+                if (index >= size) index = 2 * size - 2 - index;
+            }
+            return index;
+        }
+
+        /**
+         * @brief Fill the RowPadding samples before and after a row by reflection. The colors of the padding match the pattern.
+         * @param[in, out] row Row. RowPadding samples before it and after it are written.
+         * @param[in] width Number of samples of the row. It must be >= 2.
+        */
+        static void PadRow(unsigned char* row, const int width);
+
+        /**
+         * @brief Demosaic a row. Alpha is set to 255.
+         * @param[in] rows Padded rows from y - getRadius() to y + getRadius(), the row at the center is demosaiced.
+         * @param[out] outputData Output pixels
+         * @param[in] width Number of pixels
+         * @param[in] rowPattern Pattern starting at the row, see getRowPattern().
+         * @param[in] demosaic Demosaic
+         * @param[in] outputFormat Output format. YUVOutputFormat::Gray8 is not supported.
+        */
+        static void DemosaicRow(
+            const unsigned char* const* rows,
+            unsigned char* outputData,
+            const int width,
+            const BayerPattern rowPattern,
+            const BayerDemosaic demosaic,
+            const YUVOutputFormat outputFormat
+        );
+
+        /**
+         * @brief Demosaic a row by a specific SIMD level. Alpha is set to 255.
+         * @param[in] rows Padded rows from y - getRadius() to y + getRadius(), the row at the center is demosaiced.
+         * @param[out] outputData Output pixels
+         * @param[in] width Number of pixels
+         * @param[in] rowPattern Pattern starting at the row, see getRowPattern().
+         * @param[in] demosaic Demosaic
+         * @param[in] outputFormat Output format. YUVOutputFormat::Gray8 is not supported.
+         * @param[in] simdLevel SIMD level. It is lowered to SwizzleKernel::getSIMDLevel() if the CPU doesn't support it.
+        */
+        static void DemosaicRow(
+            const unsigned char* const* rows,
+            unsigned char* outputData,
+            const int width,
+            const BayerPattern rowPattern,
+            const BayerDemosaic demosaic,
+            const YUVOutputFormat outputFormat,
+            const SIMDLevel simdLevel
+        );
+
+        /**
+         * @brief Merge each 2 x 2 block of 2 rows into a pixel. Green is the average of the 2 green samples. Alpha is set to 255.
+         * @param[in] row0 Even row
+         * @param[in] row1 Odd row below the even row
+         * @param[out] outputData Output pixels
+         * @param[in] outputWidth Number of output pixels, the rows have 2 * outputWidth samples.
+         * @param[in] pattern Pattern of the frame
+         * @param[in] outputFormat Output format. YUVOutputFormat::Gray8 is not supported.
+        */
+        static void SuperpixelRow(
+            const unsigned char* row0,
+            const unsigned char* row1,
+            unsigned char* outputData,
+            const int outputWidth,
+            const BayerPattern pattern,
+            const YUVOutputFormat outputFormat
+        );
+
+        /**
+         * @brief Merge each 2 x 2 block of 2 rows into a pixel by a specific SIMD level. Alpha is set to 255.
+         * @param[in] row0 Even row
+         * @param[in] row1 Odd row below the even row
+         * @param[out] outputData Output pixels
+         * @param[in] outputWidth Number of output pixels, the rows have 2 * outputWidth samples.
+         * @param[in] pattern Pattern of the frame
+         * @param[in] outputFormat Output format. YUVOutputFormat::Gray8 is not supported.
+         * @param[in] simdLevel SIMD level. It is lowered to SwizzleKernel::getSIMDLevel() if the CPU doesn't support it.
+        */
+        static void SuperpixelRow(
+            const unsigned char* row0,
+            const unsigned char* row1,
+            unsigned char* outputData,
+            const int outputWidth,
+            const BayerPattern pattern,
+            const YUVOutputFormat outputFormat,
+            const SIMDLevel simdLevel
+        );
+
+    private:
+
+        /**
+         * @brief Channel layout of a row. The first color is red in a red row and blue in a blue row.
+        */
+        struct RowLayout
+        {
+            bool FirstColorAtEven;  // The first color is at the even pixels, green is at the odd pixels.
+            bool FirstColorFirst;   // The first color is the first byte of a pixel
+            bool HasAlpha;
+        };
+
+        static RowLayout getRowLayout(const BayerPattern rowPattern, const YUVOutputFormat outputFormat);
+
+        static void BilinearRowScalar(const unsigned char* const* rows, unsigned char* outputData, const int startX, const int endX, const RowLayout& layout);
+        static void BilinearRowSSSE3(const unsigned char* const* rows, unsigned char* outputData, const int startX, const int endX, const RowLayout& layout);
+        static void BilinearRowAVX2(const unsigned char* const* rows, unsigned char* outputData, const int startX, const int endX, const RowLayout& layout);
+
+        static void EdgeAwareRowScalar(const unsigned char* const* rows, unsigned char* outputData, const int startX, const int endX, const RowLayout& layout);
+        static void EdgeAwareRowSSSE3(const unsigned char* const* rows, unsigned char* outputData, const int startX, const int endX, const RowLayout& layout);
+        static void EdgeAwareRowAVX2(const unsigned char* const* rows, unsigned char* outputData, const int startX, const int endX, const RowLayout& layout);
+
+        static void SuperpixelRowScalar(const unsigned char* row0, const unsigned char* row1, unsigned char* outputData, const int startX, const int endX, const BayerPattern pattern, const YUVOutputFormat outputFormat);
+        static void SuperpixelRowSSSE3(const unsigned char* row0, const unsigned char* row1, unsigned char* outputData, const int startX, const int endX, const BayerPattern pattern, const YUVOutputFormat outputFormat);
+        static void SuperpixelRowAVX2(const unsigned char* row0, const unsigned char* row1, unsigned char* outputData, const int startX, const int endX, const BayerPattern pattern, const YUVOutputFormat outputFormat);
+    };
+}
+
+//*******************************
+
+#endif
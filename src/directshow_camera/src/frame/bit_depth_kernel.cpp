@@ -0,0 +1,414 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "frame/bit_depth_kernel.h"
+
+#include "utils/cpu_utils.h"
+
+#ifdef DIRECTSHOW_CAMERA_X86
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace DirectShowCamera
+{
+    namespace
+    {
+        /**
+         * @brief Shift counts of a conversion. The output is ((v << LeftShift) | (v >> ReplicateShift)) >> RightShift where v = input >> InputShift.
+        */
+        struct NormalizeShifts
+        {
+            int InputShift;
+            int LeftShift;
+            int ReplicateShift;
+            int RightShift;
+        };
+
+        NormalizeShifts getNormalizeShifts(const BitDepthConversion& conversion)
+        {
+            const int inputBitDepth = conversion.InputBitDepth;
+            const int outputBitDepth = conversion.OutputBitDepth;
+
+            NormalizeShifts shifts;
+            shifts.InputShift = conversion.InputMSBJustified ? 16 - inputBitDepth : 0;
+            if (outputBitDepth >= inputBitDepth)
+            {
+                // Replicate the high bits into the new low bits. A shift of the input bit depth gives 0 as the input is smaller than 2^inputBitDepth.
+                shifts.LeftShift = outputBitDepth - inputBitDepth;
+                shifts.ReplicateShift = 2 * inputBitDepth - outputBitDepth;
+                shifts.RightShift = 0;
+            }
+            else
+            {
+                // Drop the low bits. A shift of 16 gives 0.
+                shifts.LeftShift = 0;
+                shifts.ReplicateShift = 16;
+                shifts.RightShift = inputBitDepth - outputBitDepth;
+            }
+            return shifts;
+        }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+        /**
+         * @brief Shuffle masks and shifts to unpack 8 packed pixels from a 16 bytes load.
+         *        A pixel is (high byte << HighShift) | ((low byte * LowMultiplier >> LowShift) & LowMask), the multiplier moves the bits of the pixel to the same position.
+        */
+        struct UnpackConstants
+        {
+            __m128i HighMask;
+            __m128i LowMask;
+            __m128i LowMultiplier;
+            __m128i LowBitsMask;
+            int HighShift;
+            int LowShift;
+            int BytesPer8Pixels;
+        };
+
+        DIRECTSHOW_CAMERA_TARGET("ssse3")
+        UnpackConstants getUnpackConstants(const PackedMonochromeLayout layout)
+        {
+            UnpackConstants constants;
+            if (layout == PackedMonochromeLayout::Y10P)
+            {
+                constants.HighMask = _mm_setr_epi8(0, -1, 1, -1, 2, -1, 3, -1, 5, -1, 6, -1, 7, -1, 8, -1);
+                constants.LowMask = _mm_setr_epi8(4, -1, 4, -1, 4, -1, 4, -1, 9, -1, 9, -1, 9, -1, 9, -1);
+                constants.LowMultiplier = _mm_setr_epi16(64, 16, 4, 1, 64, 16, 4, 1);
+                constants.LowBitsMask = _mm_set1_epi16(0x3);
+                constants.HighShift = 2;
+                constants.LowShift = 6;
+                constants.BytesPer8Pixels = 10;
+            }
+            else
+            {
+                constants.HighMask = _mm_setr_epi8(0, -1, 1, -1, 3, -1, 4, -1, 6, -1, 7, -1, 9, -1, 10, -1);
+                constants.LowMask = _mm_setr_epi8(2, -1, 2, -1, 5, -1, 5, -1, 8, -1, 8, -1, 11, -1, 11, -1);
+                constants.LowMultiplier = _mm_setr_epi16(16, 1, 16, 1, 16, 1, 16, 1);
+                constants.LowBitsMask = _mm_set1_epi16(0xF);
+                constants.HighShift = 4;
+                constants.LowShift = 4;
+                constants.BytesPer8Pixels = 12;
+            }
+            return constants;
+        }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+    }
+
+    void BitDepthKernel::CheckConversion(const BitDepthConversion& conversion)
+    {
+        if (conversion.InputBitDepth < 8 || conversion.InputBitDepth > 16)
+        {
+            throw std::invalid_argument("Input bit depth(" + std::to_string(conversion.InputBitDepth) + ") should be between 8 and 16.");
+        }
+        if (conversion.OutputBitDepth < 8 || conversion.OutputBitDepth > 16)
+        {
+            throw std::invalid_argument("Output bit depth(" + std::to_string(conversion.OutputBitDepth) + ") should be between 8 and 16.");
+        }
+    }
+
+#pragma region Unpack
+
+    void BitDepthKernel::UnpackToPixels(
+        const unsigned char* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const PackedMonochromeLayout layout
+    )
+    {
+        UnpackToPixels(inputData, outputData, numOfPixels, layout, SwizzleKernel::getSIMDLevel());
+    }
+
+    void BitDepthKernel::UnpackToPixels(
+        const unsigned char* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const PackedMonochromeLayout layout,
+        const SIMDLevel simdLevel
+    )
+    {
+        // Check
+        if (numOfPixels % getPixelsPerGroup(layout) != 0)
+        {
+            throw std::invalid_argument("Number of pixels(" + std::to_string(numOfPixels) + ") should be a multiple of " + std::to_string(getPixelsPerGroup(layout)) + ".");
+        }
+
+        switch (std::min(simdLevel, SwizzleKernel::getSIMDLevel()))
+        {
+        case SIMDLevel::AVX2:
+            UnpackToPixelsAVX2(inputData, outputData, numOfPixels, layout);
+            break;
+        case SIMDLevel::SSSE3:
+            UnpackToPixelsSSSE3(inputData, outputData, numOfPixels, layout);
+            break;
+        default:
+            UnpackToPixelsScalar(inputData, outputData, numOfPixels, layout);
+            break;
+        }
+    }
+
+    void BitDepthKernel::UnpackToPixelsScalar(
+        const unsigned char* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const PackedMonochromeLayout layout
+    )
+    {
+        if (layout == PackedMonochromeLayout::Y10P)
+        {
+            // 4 pixels per 5 bytes
+            for (int x = 0; x < numOfPixels; x += 4)
+            {
+                const unsigned char* group = inputData + x / 4 * 5;
+                for (int i = 0; i < 4; i++)
+                {
+                    outputData[x + i] = (unsigned short)((group[i] << 2) | ((group[4] >> (i * 2)) & 0x3));
+                }
+            }
+        }
+        else
+        {
+            // 2 pixels per 3 bytes
+            for (int x = 0; x < numOfPixels; x += 2)
+            {
+                const unsigned char* group = inputData + x / 2 * 3;
+                outputData[x] = (unsigned short)((group[0] << 4) | (group[2] & 0xF));
+                outputData[x + 1] = (unsigned short)((group[1] << 4) | (group[2] >> 4));
+            }
+        }
+    }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+    DIRECTSHOW_CAMERA_TARGET("ssse3")
+    void BitDepthKernel::UnpackToPixelsSSSE3(
+        const unsigned char* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const PackedMonochromeLayout layout
+    )
+    {
+        // 8 pixels per iteration. The 16 bytes load must not pass the end of the input.
+        const auto constants = getUnpackConstants(layout);
+        const long long numOfInputBytes = (long long)numOfPixels * getBitDepth(layout) / 8;
+        const __m128i highShift = _mm_cvtsi32_si128(constants.HighShift);
+        const __m128i lowShift = _mm_cvtsi32_si128(constants.LowShift);
+
+        int x = 0;
+        long long inputOffset = 0;
+        for (; x + 8 <= numOfPixels && inputOffset + 16 <= numOfInputBytes; x += 8, inputOffset += constants.BytesPer8Pixels)
+        {
+            const __m128i input = _mm_loadu_si128((const __m128i*)(inputData + inputOffset));
+            const __m128i high = _mm_sll_epi16(_mm_shuffle_epi8(input, constants.HighMask), highShift);
+            const __m128i low = _mm_and_si128(_mm_srl_epi16(_mm_mullo_epi16(_mm_shuffle_epi8(input, constants.LowMask), constants.LowMultiplier), lowShift), constants.LowBitsMask);
+            _mm_storeu_si128((__m128i*)(outputData + x), _mm_or_si128(high, low));
+        }
+
+        // Remaining pixels
+        UnpackToPixelsScalar(inputData + inputOffset, outputData + x, numOfPixels - x, layout);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2")
+    void BitDepthKernel::UnpackToPixelsAVX2(
+        const unsigned char* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const PackedMonochromeLayout layout
+    )
+    {
+        // 16 pixels per iteration. The shuffle is in 128-bit lanes, so each lane loads the bytes of 8 pixels.
+        const auto constants = getUnpackConstants(layout);
+        const long long numOfInputBytes = (long long)numOfPixels * getBitDepth(layout) / 8;
+        const __m256i highMask = _mm256_broadcastsi128_si256(constants.HighMask);
+        const __m256i lowMask = _mm256_broadcastsi128_si256(constants.LowMask);
+        const __m256i lowMultiplier = _mm256_broadcastsi128_si256(constants.LowMultiplier);
+        const __m256i lowBitsMask = _mm256_broadcastsi128_si256(constants.LowBitsMask);
+        const __m128i highShift = _mm_cvtsi32_si128(constants.HighShift);
+        const __m128i lowShift = _mm_cvtsi32_si128(constants.LowShift);
+
+        int x = 0;
+        long long inputOffset = 0;
+        for (; x + 16 <= numOfPixels && inputOffset + constants.BytesPer8Pixels + 16 <= numOfInputBytes; x += 16, inputOffset += constants.BytesPer8Pixels * 2)
+        {
+            const __m256i input = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(inputData + inputOffset))),
+                _mm_loadu_si128((const __m128i*)(inputData + inputOffset + constants.BytesPer8Pixels)),
+                1
+            );
+            const __m256i high = _mm256_sll_epi16(_mm256_shuffle_epi8(input, highMask), highShift);
+            const __m256i low = _mm256_and_si256(_mm256_srl_epi16(_mm256_mullo_epi16(_mm256_shuffle_epi8(input, lowMask), lowMultiplier), lowShift), lowBitsMask);
+            _mm256_storeu_si256((__m256i*)(outputData + x), _mm256_or_si256(high, low));
+        }
+
+        // Remaining pixels
+        UnpackToPixelsSSSE3(inputData + inputOffset, outputData + x, numOfPixels - x, layout);
+    }
+
+#else
+
+    void BitDepthKernel::UnpackToPixelsSSSE3(
+        const unsigned char* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const PackedMonochromeLayout layout
+    )
+    {
+        UnpackToPixelsScalar(inputData, outputData, numOfPixels, layout);
+    }
+
+    void BitDepthKernel::UnpackToPixelsAVX2(
+        const unsigned char* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const PackedMonochromeLayout layout
+    )
+    {
+        UnpackToPixelsScalar(inputData, outputData, numOfPixels, layout);
+    }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+
+#pragma endregion Unpack
+
+#pragma region Normalize
+
+    void BitDepthKernel::Normalize(
+        const unsigned short* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const BitDepthConversion& conversion
+    )
+    {
+        Normalize(inputData, outputData, numOfPixels, conversion, SwizzleKernel::getSIMDLevel());
+    }
+
+    void BitDepthKernel::Normalize(
+        const unsigned short* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const BitDepthConversion& conversion,
+        const SIMDLevel simdLevel
+    )
+    {
+        // Check
+        CheckConversion(conversion);
+
+        // SSE2 is enough for the 16-bit shifts, it is used in the SSSE3 level
+        switch (std::min(simdLevel, SwizzleKernel::getSIMDLevel()))
+        {
+        case SIMDLevel::AVX2:
+            NormalizeAVX2(inputData, outputData, numOfPixels, conversion);
+            break;
+        case SIMDLevel::SSSE3:
+            NormalizeSSE2(inputData, outputData, numOfPixels, conversion);
+            break;
+        default:
+            NormalizeScalar(inputData, outputData, numOfPixels, conversion);
+            break;
+        }
+    }
+
+    void BitDepthKernel::NormalizeScalar(
+        const unsigned short* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const BitDepthConversion& conversion
+    )
+    {
+        const auto shifts = getNormalizeShifts(conversion);
+        for (int x = 0; x < numOfPixels; x++)
+        {
+            const int value = inputData[x] >> shifts.InputShift;
+            outputData[x] = (unsigned short)((((value << shifts.LeftShift) | (value >> shifts.ReplicateShift)) >> shifts.RightShift) & 0xFFFF);
+        }
+    }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+    DIRECTSHOW_CAMERA_TARGET("sse2")
+    void BitDepthKernel::NormalizeSSE2(
+        const unsigned short* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const BitDepthConversion& conversion
+    )
+    {
+        // 8 pixels per iteration
+        const auto shifts = getNormalizeShifts(conversion);
+        const __m128i inputShift = _mm_cvtsi32_si128(shifts.InputShift);
+        const __m128i leftShift = _mm_cvtsi32_si128(shifts.LeftShift);
+        const __m128i replicateShift = _mm_cvtsi32_si128(shifts.ReplicateShift);
+        const __m128i rightShift = _mm_cvtsi32_si128(shifts.RightShift);
+
+        int x = 0;
+        for (; x + 8 <= numOfPixels; x += 8)
+        {
+            const __m128i value = _mm_srl_epi16(_mm_loadu_si128((const __m128i*)(inputData + x)), inputShift);
+            const __m128i result = _mm_srl_epi16(_mm_or_si128(_mm_sll_epi16(value, leftShift), _mm_srl_epi16(value, replicateShift)), rightShift);
+            _mm_storeu_si128((__m128i*)(outputData + x), result);
+        }
+
+        // Remaining pixels
+        NormalizeScalar(inputData + x, outputData + x, numOfPixels - x, conversion);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2")
+    void BitDepthKernel::NormalizeAVX2(
+        const unsigned short* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const BitDepthConversion& conversion
+    )
+    {
+        // 16 pixels per iteration
+        const auto shifts = getNormalizeShifts(conversion);
+        const __m128i inputShift = _mm_cvtsi32_si128(shifts.InputShift);
+        const __m128i leftShift = _mm_cvtsi32_si128(shifts.LeftShift);
+        const __m128i replicateShift = _mm_cvtsi32_si128(shifts.ReplicateShift);
+        const __m128i rightShift = _mm_cvtsi32_si128(shifts.RightShift);
+
+        int x = 0;
+        for (; x + 16 <= numOfPixels; x += 16)
+        {
+            const __m256i value = _mm256_srl_epi16(_mm256_loadu_si256((const __m256i*)(inputData + x)), inputShift);
+            const __m256i result = _mm256_srl_epi16(_mm256_or_si256(_mm256_sll_epi16(value, leftShift), _mm256_srl_epi16(value, replicateShift)), rightShift);
+            _mm256_storeu_si256((__m256i*)(outputData + x), result);
+        }
+
+        // Remaining pixels
+        NormalizeSSE2(inputData + x, outputData + x, numOfPixels - x, conversion);
+    }
+
+#else
+
+    void BitDepthKernel::NormalizeSSE2(
+        const unsigned short* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const BitDepthConversion& conversion
+    )
+    {
+        NormalizeScalar(inputData, outputData, numOfPixels, conversion);
+    }
+
+    void BitDepthKernel::NormalizeAVX2(
+        const unsigned short* inputData,
+        unsigned short* outputData,
+        const int numOfPixels,
+        const BitDepthConversion& conversion
+    )
+    {
+        NormalizeScalar(inputData, outputData, numOfPixels, conversion);
+    }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+
+#pragma endregion Normalize
+}
@@ -0,0 +1,166 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__BIT_DEPTH_KERNEL_H
+#define DIRECTSHOW_CAMERA__FRAME__BIT_DEPTH_KERNEL_H
+
+//************Content************
+
+#include "frame/swizzle_kernel.h"
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Bit layout of the packed monochrome pixels. The layouts are the MIPI CSI-2 RAW10 and RAW12 packing.
+    */
+    enum class PackedMonochromeLayout
+    {
+        Y10P,   // 4 pixels in 5 bytes. The first 4 bytes are the high 8 bits of each pixel, the 5th byte is the low 2 bits of the 4 pixels from bit 0.
+        Y12P    // 2 pixels in 3 bytes. The first 2 bytes are the high 8 bits of each pixel, the 3rd byte is the low 4 bits of the 2 pixels from bit 0.
+    };
+
+    /**
+     * @brief Shift and scale of the 16-bit monochrome samples. See BitDepthKernel::Normalize().
+    */
+    struct BitDepthConversion
+    {
+        /**
+         * @brief Significant bits of the input samples, from 8 to 16
+        */
+        int InputBitDepth = 16;
+
+        /**
+         * @brief True if the significant bits are stored in the high bits of the input samples, otherwise they are stored in the low bits
+        */
+        bool InputMSBJustified = false;
+
+        /**
+         * @brief Significant bits of the output samples, from 8 to 16. The output samples are stored in the low bits.
+        */
+        int OutputBitDepth = 16;
+    };
+
+    /**
+     * @brief Unpack and normalize kernels of the 16-bit monochrome samples. Samples are little-endian unsigned short.
+     *
+     * A sample is scaled up by replicating its high bits, so 0 and the maximum map to 0 and the maximum of the output bit depth, and scaled down by dropping the low bits.
+     * The kernel is selected at runtime by the instruction sets supported by the CPU. All kernels return the same output.
+     */
+    class BitDepthKernel
+    {
+    public:
+
+        /**
+         * @brief Get the bit depth of the packed pixels
+         * @param[in] layout Bit layout
+         * @return Return the bit depth
+        */
+        static constexpr int getBitDepth(const PackedMonochromeLayout layout)
+        {
+            return layout == PackedMonochromeLayout::Y10P ? 10 : 12;
+        }
+
+        /**
+         * @brief Get the number of pixels in a packing group. The number of pixels of a row must be a multiple of it.
+         * @param[in] layout Bit layout
+         * @return Return the number of pixels
+        */
+        static constexpr int getPixelsPerGroup(const PackedMonochromeLayout layout)
+        {
+            return layout == PackedMonochromeLayout::Y10P ? 4 : 2;
+        }
+
+        /**
+         * @brief Check whether a conversion changes the samples, i.e. the samples can be copied as they are
+         * @param[in] conversion Conversion
+         * @return Return true if the samples are not changed
+        */
+        static constexpr bool isIdentity(const BitDepthConversion& conversion)
+        {
+            return conversion.InputBitDepth == conversion.OutputBitDepth && (conversion.InputBitDepth == 16 || !conversion.InputMSBJustified);
+        }
+
+        /**
+         * @brief Unpack packed monochrome pixels into 16-bit samples. The samples are stored in the low bits.
+         * @param[in] inputData Input pixels
+         * @param[out] outputData Output samples. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels. It must be a multiple of getPixelsPerGroup().
+         * @param[in] layout Bit layout of the input
+        */
+        static void UnpackToPixels(
+            const unsigned char* inputData,
+            unsigned short* outputData,
+            const int numOfPixels,
+            const PackedMonochromeLayout layout
+        );
+
+        /**
+         * @brief Unpack packed monochrome pixels into 16-bit samples by a specific SIMD level. The samples are stored in the low bits.
+         * @param[in] inputData Input pixels
+         * @param[out] outputData Output samples. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels. It must be a multiple of getPixelsPerGroup().
+         * @param[in] layout Bit layout of the input
+         * @param[in] simdLevel SIMD level. It is lowered to SwizzleKernel::getSIMDLevel() if the CPU doesn't support it.
+        */
+        static void UnpackToPixels(
+            const unsigned char* inputData,
+            unsigned short* outputData,
+            const int numOfPixels,
+            const PackedMonochromeLayout layout,
+            const SIMDLevel simdLevel
+        );
+
+        /**
+         * @brief Shift and scale 16-bit samples to another bit depth. The unused bits of a LSB-justified input must be 0.
+         * @param[in] inputData Input samples
+         * @param[out] outputData Output samples. It can be the input for an in place conversion.
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] conversion Conversion
+        */
+        static void Normalize(
+            const unsigned short* inputData,
+            unsigned short* outputData,
+            const int numOfPixels,
+            const BitDepthConversion& conversion
+        );
+
+        /**
+         * @brief Shift and scale 16-bit samples to another bit depth by a specific SIMD level. The unused bits of a LSB-justified input must be 0.
+         * @param[in] inputData Input samples
+         * @param[out] outputData Output samples. It can be the input for an in place conversion.
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] conversion Conversion
+         * @param[in] simdLevel SIMD level. It is lowered to SwizzleKernel::getSIMDLevel() if the CPU doesn't support it.
+        */
+        static void Normalize(
+            const unsigned short* inputData,
+            unsigned short* outputData,
+            const int numOfPixels,
+            const BitDepthConversion& conversion,
+            const SIMDLevel simdLevel
+        );
+
+        /**
+         * @brief Check a conversion. Throw std::invalid_argument if a bit depth is out of range.
+         * @param[in] conversion Conversion
+        */
+        static void CheckConversion(const BitDepthConversion& conversion);
+
+    private:
+        static void UnpackToPixelsScalar(const unsigned char* inputData, unsigned short* outputData, const int numOfPixels, const PackedMonochromeLayout layout);
+        static void UnpackToPixelsSSSE3(const unsigned char* inputData, unsigned short* outputData, const int numOfPixels, const PackedMonochromeLayout layout);
+        static void UnpackToPixelsAVX2(const unsigned char* inputData, unsigned short* outputData, const int numOfPixels, const PackedMonochromeLayout layout);
+
+        static void NormalizeScalar(const unsigned short* inputData, unsigned short* outputData, const int numOfPixels, const BitDepthConversion& conversion);
+        static void NormalizeSSE2(const unsigned short* inputData, unsigned short* outputData, const int numOfPixels, const BitDepthConversion& conversion);
+        static void NormalizeAVX2(const unsigned short* inputData, unsigned short* outputData, const int numOfPixels, const BitDepthConversion& conversion);
+    };
+}
+
+//*******************************
+
+#endif
@@ -5,12 +5,15 @@
 **/
 
 #include "frame/frame.h"
+#include "frame/frame_subtype_registry.h"
 
 #include "directshow_camera/video_format/ds_guid.h"
 #include "directshow_camera/utils/ds_video_format_utils.h"
 
 #include "utils/path_utils.h"
 
+#include <atomic>
+
 namespace DirectShowCamera
 {
 #pragma region Constructor and Destructor
@@ -30,10 +33,12 @@ namespace DirectShowCamera
         m_height = other.m_height;
         m_frameSize = other.m_frameSize;
         m_frameIndex = other.m_frameIndex;
+        m_timestamp = other.m_timestamp;
         m_frameType = other.m_frameType;
         m_frameSettings = other.m_frameSettings;
-        m_data = std::make_unique<unsigned char[]>(m_frameSize);
-        memcpy(m_data.get(), other.m_data.get(), m_frameSize);
+        m_statistics = other.m_statistics;
+        m_statisticsSettings = other.m_statisticsSettings;
+        m_data = other.m_data;
     }
 
     Frame::Frame(Frame&& other) noexcept
@@ -42,22 +47,63 @@ namespace DirectShowCamera
         m_height = other.m_height;
         m_frameSize = other.m_frameSize;
         m_frameIndex = other.m_frameIndex;
+        m_timestamp = other.m_timestamp;
         m_frameType = other.m_frameType;
         m_frameSettings = other.m_frameSettings;
+        m_statistics = std::move(other.m_statistics);
+        m_statisticsSettings = other.m_statisticsSettings;
         m_data = std::move(other.m_data);
 
         // Reset other after move
         other.Clear();
     }
 
+    const unsigned char* Frame::getData() const
+    {
+        return m_data ? m_data->get() : nullptr;
+    }
+
+    FrameBuffer* Frame::getExclusiveData()
+    {
+        if (m_data == nullptr || m_data.use_count() != 1) return nullptr;
+
+        // The frames which shared the data may have read it in other threads before releasing it
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return m_data.get();
+    }
+
+    void Frame::DetachData()
+    {
+        if (getData() == nullptr || getExclusiveData() != nullptr) return;
+
+        // Copy the shared data. The buffer is taken from the pool of the shared buffer.
+        const FrameBuffer& sharedData = *m_data;
+        const auto& framePool = sharedData.get_deleter().Pool;
+        FrameBuffer data = framePool ? framePool->Acquire(m_frameSize) : FramePool::Allocate(m_frameSize);
+        memcpy(data.get(), sharedData.get(), m_frameSize);
+        m_data = framePool ? framePool->MakeShared(std::move(data)) : std::make_shared<FrameBuffer>(std::move(data));
+    }
+
+    void Frame::UpdateStatistics(const FrameStatistics& statistics)
+    {
+        if (statistics.Channels == 0) return;
+
+        m_statistics = std::make_shared<const FrameStatistics>(statistics);
+        m_statisticsSettings = m_frameSettings;
+    }
+
     void Frame::Clear()
     {
         m_width = -1;
         m_height = -1;
         m_frameSize = 0;
         m_frameIndex = 0;
+        m_timestamp = FrameTimestamp();
+        m_frameType = MEDIASUBTYPE_None;
         m_frameSettings.Reset();
-        if (m_data != nullptr) m_data.reset();
+        m_statistics.reset();
+        m_statisticsBuffer.reset();
+        m_data.reset();
     }
 
 #pragma endregion Constructor and Destructor
@@ -70,7 +116,8 @@ namespace DirectShowCamera
         const int height,
         const GUID frameType,
         const FrameSettings frameSettings,
-        ImportDataFunc importDataFunc
+        ImportDataFunc importDataFunc,
+        std::shared_ptr<FramePool> framePool
     )
     {
         // Check
@@ -78,7 +125,9 @@ namespace DirectShowCamera
         if (width <= 0) throw std::invalid_argument("Width(" + std::to_string(width) + ") can't be <= 0.");
         if (height <= 0) throw std::invalid_argument("Height(" + std::to_string(height) + ") can't be <= 0.");
 
-        // Reset
+        // Reset but keep the storage if it can be reused. The buffer shared with other frames can't be overwritten.
+        std::shared_ptr<FrameBuffer> storage = nullptr;
+        if (getExclusiveData() != nullptr && *m_data != nullptr && m_frameSize == frameSize) storage = std::move(m_data);
         Clear();
 
         // Set
@@ -88,77 +137,265 @@ namespace DirectShowCamera
         m_frameSize = frameSize;
         m_frameSettings = frameSettings;
 
-        // Allocate memory
-        m_data = std::make_unique<unsigned char[]>(frameSize);
+        // Allocate memory. The buffer is not initialized as it will be overwritten.
+        if (storage != nullptr)
+        {
+            m_data = std::move(storage);
+        }
+        else
+        {
+            m_data = framePool ? framePool->MakeShared(framePool->Acquire(frameSize)) : std::make_shared<FrameBuffer>(FramePool::Allocate(frameSize));
+        }
 
         // Import
-        importDataFunc(m_data.get(), m_frameIndex);
+        importDataFunc(m_data->get(), m_frameIndex);
+    }
+
+    void Frame::ImportData(
+        const long frameSize,
+        const int width,
+        const int height,
+        const GUID frameType,
+        const FrameSettings frameSettings,
+        ImportTimestampedDataFunc importDataFunc,
+        std::shared_ptr<FramePool> framePool
+    )
+    {
+        ImportData(
+            frameSize,
+            width,
+            height,
+            frameType,
+            frameSettings,
+            [this, &importDataFunc](unsigned char* data, unsigned long& frameIndex)
+            {
+                importDataFunc(data, frameIndex, m_timestamp);
+            },
+            framePool
+        );
+    }
+
+    bool Frame::ExchangeData(
+        const long frameSize,
+        const int width,
+        const int height,
+        const GUID frameType,
+        const FrameSettings frameSettings,
+        ExchangeDataFunc exchangeDataFunc,
+        std::shared_ptr<FramePool> framePool
+    )
+    {
+        // Check
+        if (frameSize <= 0) throw std::invalid_argument("Frame size(" + std::to_string(frameSize) + ") can't be <= 0.");
+        if (width <= 0) throw std::invalid_argument("Width(" + std::to_string(width) + ") can't be <= 0.");
+        if (height <= 0) throw std::invalid_argument("Height(" + std::to_string(height) + ") can't be <= 0.");
+
+        // The producer will overwrite the buffer handed to it, so the buffer shared with other frames is kept.
+        // Hand a pooled buffer to the producer instead of nothing, so that it can be reused.
+        FrameBuffer pooledBuffer = nullptr;
+        FrameBuffer* exclusiveData = getExclusiveData();
+        FrameBuffer* exchangeBuffer = exclusiveData;
+        if (exclusiveData == nullptr || (framePool && (*exclusiveData == nullptr || m_frameSize != frameSize)))
+        {
+            if (framePool) pooledBuffer = framePool->Acquire(frameSize);
+            exchangeBuffer = &pooledBuffer;
+        }
+
+        // Exchange
+        int numOfBytes = *exchangeBuffer == nullptr ? 0 : (exchangeBuffer == exclusiveData ? m_frameSize : frameSize);
+        unsigned long frameIndex = m_frameIndex;
+        FrameTimestamp timestamp = m_timestamp;
+        if (!exchangeDataFunc(*exchangeBuffer, numOfBytes, frameIndex, timestamp)) return false;
+        if (exchangeBuffer != exclusiveData)
+        {
+            // The storage is reused if it is not shared, otherwise a new storage is taken from the pool, so the exchange doesn't allocate
+            if (exclusiveData != nullptr)
+            {
+                *exclusiveData = std::move(*exchangeBuffer);
+            }
+            else
+            {
+                m_data = framePool ? framePool->MakeShared(std::move(*exchangeBuffer)) : std::make_shared<FrameBuffer>(std::move(*exchangeBuffer));
+            }
+        }
+
+        // Check the exchanged buffer
+        if (getData() == nullptr || numOfBytes != frameSize)
+        {
+            Clear();
+            throw std::runtime_error("Exchanged frame size(" + std::to_string(numOfBytes) + ") is not equal to " + std::to_string(frameSize) + ".");
+        }
+
+        // Set
+        m_width = width;
+        m_height = height;
+        m_frameType = frameType;
+        m_frameSize = frameSize;
+        m_frameSettings = frameSettings;
+        m_statistics.reset();
+        m_frameIndex = frameIndex;
+        m_timestamp = timestamp;
+
+        return true;
     }
 
     unsigned char* Frame::getFrameDataPtr(int& numOfBytes)
     {
+        // The data may be modified
+        DetachData();
+        m_statistics.reset();
+
         numOfBytes = m_frameSize;
-        return m_data.get();
+        return m_data ? m_data->get() : nullptr;
+    }
+
+    const unsigned char* Frame::getFrameDataPtr(int& numOfBytes) const
+    {
+        numOfBytes = m_frameSize;
+        return getData();
     }
 
     std::shared_ptr<unsigned char[]> Frame::getFrameData(int& numOfBytes)
     {
         // Check
-        if (!FrameDecoder::isMonochromeFrameType(m_frameType) &&
-            !FrameDecoder::isRGBFrameType(m_frameType)
+        const auto traits = FrameSubtypeRegistry::Find(m_frameType);
+        if (traits == nullptr ||
+            (traits->Family != FrameSubtypeFamily::Monochrome8bit && traits->Family != FrameSubtypeFamily::RGB && traits->Family != FrameSubtypeFamily::YUV422 && traits->Family != FrameSubtypeFamily::YUV420 && traits->Family != FrameSubtypeFamily::MJPEG && traits->Family != FrameSubtypeFamily::Bayer)
         )
         {
             throw std::runtime_error("Frame type(" + DirectShowVideoFormatUtils::ToString(m_frameType) + ") is not 8 bit.");
         }
 
+        // Initialize result buffer
+        numOfBytes = getDecodedWidth() * getDecodedHeight() * traits->DecodedBytesPerPixel;
+        auto result = std::make_shared<unsigned char[]>(numOfBytes);
+
         // Convert
+        FrameStatistics statistics;
+        FrameDecoder::DecodeFrame(getData(), result.get(), m_frameType, m_width, m_height, m_frameSettings, &statistics);
+        UpdateStatistics(statistics);
+
+        return result;
+    }
+
+    void Frame::getFrameData(const FrameDestination& destination)
+    {
+        // Check and convert
+        FrameStatistics statistics;
+        FrameDecoder::DecodeFrame(getData(), destination, m_frameType, m_width, m_height, m_frameSettings, &statistics);
+        UpdateStatistics(statistics);
+    }
+
+    void Frame::getTensor(const TensorDestination& destination)
+    {
+        // Check and convert
+        FrameDecoder::DecodeFrameToTensor(getData(), destination, m_frameType, m_width, m_height, m_frameSettings);
+    }
+
+    std::shared_ptr<unsigned short[]> Frame::getFrame16bitData(int& numOfBytes)
+    {
+        // Check
+        FrameDecoder::Check16BitMonochromeFrameType(m_frameType);
+
+        // Convert in the bit depth of the frame settings
+        const int numOfPixels = getDecodedWidth() * getDecodedHeight();
+        numOfBytes = numOfPixels * 2;
+        auto result = std::make_shared<unsigned short[]>(numOfPixels);
+        FrameStatistics statistics;
+        FrameDecoder::DecodeFrame(
+            getData(),
+            (unsigned char*)result.get(),
+            m_frameType,
+            m_width,
+            m_height,
+            m_frameSettings,
+            &statistics
+        );
+        UpdateStatistics(statistics);
+
+        return result;
+    }
+
+    std::shared_ptr<unsigned char[]> Frame::getToneMappedFrameData(int& numOfBytes, const ToneMapSettings& toneMapSettings)
+    {
+        numOfBytes = getDecodedWidth() * getDecodedHeight();
+        return FrameDecoder::Decode16BitMonochromeFrameTo8Bit(
+            getData(),
+            m_frameType,
+            m_width,
+            m_height,
+            toneMapSettings,
+            m_frameSettings
+        );
+    }
+
+    std::shared_ptr<unsigned char[]> Frame::getGrayFrameData(int& numOfBytes)
+    {
+        // 8 bit monochrome
         if (FrameDecoder::isMonochromeFrameType(m_frameType))
         {
-            // Monochrome
+            numOfBytes = m_width * m_height;
             return FrameDecoder::DecodeMonochromeFrame(
-                m_data.get(),
+                getData(),
                 m_frameType,
                 m_width,
                 m_height,
-                m_frameSettings.VerticalFlip
+                m_frameSettings.VerticalFlip,
+                m_frameSettings.HorizontalMirror
             );
         }
-        else
+
+        // Y channel of MJPEG, the chroma is not decoded
+        if (FrameDecoder::isMJPGFrameType(m_frameType))
         {
-            // RGB
-            return FrameDecoder::DecodeRGBFrame(
-                m_data.get(),
-                m_frameType,
+            numOfBytes = m_width * m_height;
+            return FrameDecoder::DecodeMJPGFrame(
+                getData(),
+                m_frameSize,
                 m_width,
                 m_height,
+                YUVOutputFormat::Gray8,
+                JPEGScale::Full,
                 m_frameSettings.VerticalFlip,
-                !m_frameSettings.BGR
+                m_frameSettings.HorizontalMirror
             );
         }
-    }
 
-    std::shared_ptr<unsigned short[]> Frame::getFrame16bitData(int& numOfBytes)
-    {
-        // Check
-        FrameDecoder::Check16BitMonochromeFrameType(m_frameType);
+        // Y channel of YUV
+        if (!FrameDecoder::isLumaFrameType(m_frameType))
+        {
+            throw std::runtime_error("Frame type(" + DirectShowVideoFormatUtils::ToString(m_frameType) + ") has no gray channel.");
+        }
 
-        // Convert
-        return FrameDecoder::Decode16BitMonochromeFrame(
-            m_data.get(),
+        numOfBytes = m_width * m_height;
+        return FrameDecoder::DecodeLumaFrame(
+            getData(),
             m_frameType,
             m_width,
             m_height,
-            m_frameSettings.VerticalFlip
+            m_frameSettings.VerticalFlip,
+            m_frameSettings.HorizontalMirror
         );
     }
 
+    YUV420Planes Frame::getYUV420Planes() const
+    {
+        // Check
+        if (FrameSubtypeRegistry::getFamily(m_frameType) != FrameSubtypeFamily::YUV420)
+        {
+            throw std::runtime_error("Frame type(" + DirectShowVideoFormatUtils::ToString(m_frameType) + ") is not YUV 4:2:0.");
+        }
+
+        return FrameDecoder::getYUV420Planes(getData(), m_frameType, m_width, m_height);
+    }
+
 #pragma endregion Frame
 
 #pragma region Getter
 
     bool Frame::isEmpty() const
     {
-        return m_data == nullptr || m_frameSize == 0;
+        return getData() == nullptr || m_frameSize == 0;
     }
 
     unsigned long Frame::getFrameIndex() const
@@ -166,6 +403,11 @@ namespace DirectShowCamera
         return m_frameIndex;
     }
 
+    FrameTimestamp Frame::getTimestamp() const
+    {
+        return m_timestamp;
+    }
+
     int Frame::getWidth() const
     {
         return m_width;
@@ -176,6 +418,26 @@ namespace DirectShowCamera
         return m_height;
     }
 
+    int Frame::getDecodedWidth() const
+    {
+        if (!FrameDecoder::isResized(m_frameSettings)) return m_width;
+
+        int decodedWidth = 0;
+        int decodedHeight = 0;
+        FrameDecoder::getDecodedSize(m_width, m_height, m_frameSettings, decodedWidth, decodedHeight);
+        return decodedWidth;
+    }
+
+    int Frame::getDecodedHeight() const
+    {
+        if (!FrameDecoder::isResized(m_frameSettings)) return m_height;
+
+        int decodedWidth = 0;
+        int decodedHeight = 0;
+        FrameDecoder::getDecodedSize(m_width, m_height, m_frameSettings, decodedWidth, decodedHeight);
+        return decodedHeight;
+    }
+
     int Frame::getFrameSize() const
     {
         return m_frameSize;
@@ -187,36 +449,60 @@ namespace DirectShowCamera
         {
             return FrameType::None;
         }
-        else if (FrameDecoder::isMonochromeFrameType(m_frameType))
+
+        switch (FrameSubtypeRegistry::getFamily(m_frameType))
         {
+        case FrameSubtypeFamily::Monochrome8bit:
             return FrameType::Monochrome8bit;
-        }
-        else if (FrameDecoder::is16BitMonochromeFrameType(m_frameType))
-        {
+        case FrameSubtypeFamily::Monochrome16bit:
             return FrameType::Monochrome16bit;
-        }
-        else if (FrameDecoder::isRGBFrameType(m_frameType))
-        {
-            if (m_frameSettings.BGR)
-            {
-                return FrameType::ColorBGR24bit;
-            }
-            else
-            {
-                return FrameType::ColorRGB24bit;
-            }
-        }
-        else
-        {
+        case FrameSubtypeFamily::RGB:
+        case FrameSubtypeFamily::YUV422:
+        case FrameSubtypeFamily::YUV420:
+        case FrameSubtypeFamily::MJPEG:
+        case FrameSubtypeFamily::Bayer:
+            return m_frameSettings.BGR ? FrameType::ColorBGR24bit : FrameType::ColorRGB24bit;
+        default:
             return FrameType::Unknown;
         }
     }
 
+    int Frame::getBitDepth() const
+    {
+        if (m_frameType == MEDIASUBTYPE_None) return 0;
+        return FrameDecoder::getBitDepth(m_frameType, m_frameSettings);
+    }
+
     FrameSettings& Frame::getFrameSettings()
     {
         return m_frameSettings;
     }
 
+    std::shared_ptr<const FrameStatistics> Frame::getStatistics()
+    {
+        if (getData() == nullptr || m_frameSettings.Statistics == FrameStatisticsMode::None) return nullptr;
+
+        // Decode once if the frame hasn't been decoded with the current frame settings
+        if (m_statistics == nullptr || m_statisticsSettings != m_frameSettings)
+        {
+            const auto traits = FrameSubtypeRegistry::Find(m_frameType);
+            if (traits == nullptr) throw std::runtime_error("Frame type(" + DirectShowVideoFormatUtils::ToString(m_frameType) + ") is not supported.");
+
+            // The decode buffer is kept for the next recompute, it is reallocated only if it is too small
+            const int numOfBytes = getDecodedWidth() * getDecodedHeight() * traits->DecodedBytesPerPixel;
+            if (m_statisticsBuffer == nullptr || m_statisticsBuffer.get_deleter().NumOfBytes < numOfBytes)
+            {
+                m_statisticsBuffer = FramePool::Allocate(numOfBytes);
+            }
+
+            FrameStatistics statistics;
+            FrameDecoder::DecodeFrame(getData(), m_statisticsBuffer.get(), m_frameType, m_width, m_height, m_frameSettings, &statistics);
+            UpdateStatistics(statistics);
+        }
+
+        return m_statistics;
+    }
+
 #pragma endregion Getter
 
 #ifdef WITH_OPENCV2
@@ -224,18 +510,35 @@ namespace DirectShowCamera
 
     cv::Mat Frame::getMat()
     {
-        // Check
-        FrameDecoder::CheckSupportVideoType(m_frameType);
+        // Convert
+        cv::Mat result;
+        getMat(result);
+        return result;
+    }
 
+    void Frame::getMat(cv::Mat& result)
+    {
         // Convert
-        return FrameDecoder::DecodeFrameToCVMat(
-            m_data.get(),
-            m_frameType,
-            m_width, 
-            m_height,
-            m_frameSettings.VerticalFlip,
-            !m_frameSettings.BGR
-        );
+        FrameStatistics statistics;
+        FrameDecoder::DecodeFrameToCVMat(getData(), m_frameType, m_width, m_height, result, m_frameSettings, &statistics);
+        UpdateStatistics(statistics);
+    }
+
+    cv::Mat Frame::getGrayMat()
+    {
+        // 8 bit monochrome
+        if (FrameDecoder::isMonochromeFrameType(m_frameType))
+        {
+            return FrameDecoder::DecodeMonochromeFrameToCVMat(getData(), m_frameType, m_width, m_height, m_frameSettings.VerticalFlip, m_frameSettings.HorizontalMirror);
+        }
+
+        // Y channel of YUV
+        return FrameDecoder::DecodeLumaFrameToCVMat(getData(), m_frameType, m_width, m_height, m_frameSettings.VerticalFlip, m_frameSettings.HorizontalMirror);
+    }
+
+    cv::Mat Frame::getToneMappedMat(const ToneMapSettings& toneMapSettings)
+    {
+        return FrameDecoder::Decode16BitMonochromeFrameTo8BitCVMat(getData(), m_frameType, m_width, m_height, toneMapSettings, m_frameSettings);
     }
 
 #pragma endregion OpenCV
@@ -248,6 +551,7 @@ namespace DirectShowCamera
     {
         // Check video type
         FrameDecoder::CheckSupportVideoType(m_frameType);
+        const auto traits = FrameSubtypeRegistry::Find(m_frameType);
 
         // Get file Extension
         const auto fileExtension = Utils::PathUtils::getExtension(path);
@@ -279,11 +583,11 @@ namespace DirectShowCamera
 
         // Create bitmap
         Gdiplus::PixelFormat pixelFormat;
-        if (FrameDecoder::isMonochromeFrameType(m_frameType))
+        if (traits->Family == FrameSubtypeFamily::Monochrome8bit)
         {
             pixelFormat = PixelFormat8bppIndexed;
         }
-        else if (FrameDecoder::is16BitMonochromeFrameType(m_frameType))
+        else if (traits->Family == FrameSubtypeFamily::Monochrome16bit)
         {
             pixelFormat = PixelFormat16bppGrayScale;
         }
@@ -291,39 +595,44 @@ namespace DirectShowCamera
         {
             pixelFormat = PixelFormat24bppRGB;
         }
-        Gdiplus::Bitmap bitmap(m_width, m_height, pixelFormat);
+        Gdiplus::Bitmap bitmap(getDecodedWidth(), getDecodedHeight(), pixelFormat);
 
         // Draw
-        if (m_frameSettings.VerticalFlip)
+        if (m_frameSettings.VerticalFlip && !m_frameSettings.HorizontalMirror && !FrameDecoder::isResized(m_frameSettings) && traits->Family != FrameSubtypeFamily::MJPEG && traits->BitsPerPixel == traits->DecodedBytesPerPixel * 8 &&
+            (traits->Family != FrameSubtypeFamily::Monochrome16bit || BitDepthKernel::isIdentity(FrameDecoder::getBitDepthConversion(m_frameType, m_frameSettings))))
         {
             // Draw image which is vertical flip
 
             // Note: The image is already vertical flip in m_data
 
-            Utils::GDIPLUSUtils::DrawBitmap(bitmap, m_data.get(), m_frameSize);
+            Utils::GDIPLUSUtils::DrawBitmap(bitmap, getData(), m_frameSize);
         }
         else
         {
-            // Draw image which is not vertical flip
+            // Draw image which is not vertical flip, is mirrored, is resized or is not stored in the bitmap format
             // As image is already vertical flip in m_data, we need to flip it
 
             // Create a image buffer
-            auto data = new unsigned char[m_frameSize];
+            const int decodedSize = getDecodedWidth() * getDecodedHeight() * traits->DecodedBytesPerPixel;
+            auto data = new unsigned char[decodedSize];
 
             try {
-                // Flip the image into the buffer
-                FrameDecoder::DecodeFrame(
-                    m_data.get(),
+                // Flip, mirror and convert the image into the buffer. The bitmap is in BGR order.
+                FrameSettings frameSettings = m_frameSettings;
+                frameSettings.BGR = true;
+                traits->Decode(
+                    getData(),
                     data,
-                    m_frameType,
                     m_width,
                     m_height,
-                    false,
-                    false
+                    0,
+                    frameSettings,
+                    nullptr,
+                    nullptr
                 );
 
                 // Draw
-                Utils::GDIPLUSUtils::DrawBitmap(bitmap, data, m_frameSize);
+                Utils::GDIPLUSUtils::DrawBitmap(bitmap, data, decodedSize);
 
                 // Delete the buffer
                 delete[] data;
@@ -13,8 +13,11 @@
 #include <guiddef.h>
 
 #include "frame/frame_decoder.h"
+#include "buffer/frame_pool.h"
+#include "buffer/frame_timestamp.h"
 #include "utils/gdi_plus_utils.h"
 
+#include <cstring>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -27,6 +30,8 @@ namespace DirectShowCamera
     {
     public:
         typedef std::function<void(unsigned char* data, unsigned long& frameIndex)> ImportDataFunc;
+        typedef std::function<void(unsigned char* data, unsigned long& frameIndex, FrameTimestamp& timestamp)> ImportTimestampedDataFunc;
+        typedef std::function<bool(FrameBuffer& data, int& numOfBytes, unsigned long& frameIndex, FrameTimestamp& timestamp)> ExchangeDataFunc;
         enum FrameType {
             None,
             Unknown,
@@ -51,7 +56,7 @@ namespace DirectShowCamera
         ~Frame();
 
         /**
-        * @brief Copy constructor
+        * @brief Copy constructor. The frame data is shared with other until either frame is modified, no copy is made.
         */
         Frame(const Frame& other);
 
@@ -77,6 +82,7 @@ namespace DirectShowCamera
         * @param[in] frameType Frame type
         * @param[in] frameSettings Frame settings
         * @param[in] importDataFunc A function to import data. The function should be in the form of void(unsigned char* data, unsigned long& frameIndex)
+        * @param[in] framePool (Optional) Pool to take the buffer from if the frame buffer can't be reused. Default as nullptr which allocates a new buffer.
         */
         void ImportData(
             const long frameSize,
@@ -84,19 +90,70 @@ namespace DirectShowCamera
             const int height,
             const GUID frameType,
             const FrameSettings frameSettings,
-            ImportDataFunc importDataFunc
+            ImportDataFunc importDataFunc,
+            std::shared_ptr<FramePool> framePool = nullptr
+        );
+
+        /**
+        * @brief Import data with the capture timestamps
+        * @param[in] frameSize Frame size in bytes
+        * @param[in] width Frame width in pixel
+        * @param[in] height Frame height in pixel
+        * @param[in] frameType Frame type
+        * @param[in] frameSettings Frame settings
+        * @param[in] importDataFunc A function to import data. The function should be in the form of void(unsigned char* data, unsigned long& frameIndex, FrameTimestamp& timestamp)
+        * @param[in] framePool (Optional) Pool to take the buffer from if the frame buffer can't be reused. Default as nullptr which allocates a new buffer.
+        */
+        void ImportData(
+            const long frameSize,
+            const int width,
+            const int height,
+            const GUID frameType,
+            const FrameSettings frameSettings,
+            ImportTimestampedDataFunc importDataFunc,
+            std::shared_ptr<FramePool> framePool = nullptr
+        );
+
+        /**
+        * @brief Exchange the frame buffer with a filled buffer so that no copy is made. The old buffer is handed to the exchange function for reuse.
+        * @param[in] frameSize Frame size in bytes
+        * @param[in] width Frame width in pixel
+        * @param[in] height Frame height in pixel
+        * @param[in] frameType Frame type
+        * @param[in] frameSettings Frame settings
+        * @param[in] exchangeDataFunc  A function to exchange data. The function should be in the form of bool(FrameBuffer& data, int& numOfBytes, unsigned long& frameIndex, FrameTimestamp& timestamp).
+        *                              numOfBytes is the size of the old buffer as input and the size of the new buffer as output. Return false if nothing is exchanged.
+        * @param[in] framePool (Optional) If the frame is empty or in another size, a buffer is taken from this pool and handed to the exchange function, so that the producer doesn't need to allocate. Default as nullptr
+        * @return Return true if the buffer is exchanged. Return false if nothing is exchanged and the frame is unchanged.
+        */
+        bool ExchangeData(
+            const long frameSize,
+            const int width,
+            const int height,
+            const GUID frameType,
+            const FrameSettings frameSettings,
+            ExchangeDataFunc exchangeDataFunc,
+            std::shared_ptr<FramePool> framePool = nullptr
         );
 
         /**
          * @brief   Get frame data pointer. This is the data pointer in the Frame object which is in the order of pixel by pixel (BGR if color),
          *          row by row and is vertical flipped. Don't release the pointer. The pointer will be released when the frame is destroyed.
+         *          The data can be modified, so it is copied first if it is shared with another frame.
          * @param[out] numOfBytes   Number of bytes of the frame.
          * @return Return the frame in bytes (BGR if color) which is vertical flipped.
         */
         unsigned char* getFrameDataPtr(int& numOfBytes);
 
         /**
-        * @brief    Return a cloned frame data. The data is in the order of pixel by pixel, row by row.
+         * @brief   Get the read-only frame data pointer. It is the same as the non-const getFrameDataPtr() but the data is never copied.
+         * @param[out] numOfBytes   Number of bytes of the frame.
+         * @return Return the frame in bytes (BGR if color) which is vertical flipped.
+        */
+        const unsigned char* getFrameDataPtr(int& numOfBytes) const;
+
+        /**
+        * @brief    Return a cloned frame data. The data is in the order of pixel by pixel, row by row, in the size of getDecodedWidth() x getDecodedHeight().
         *           You will need to know the width, height and frame type to decode the data.
         * @param[out] numOfBytes   Number of bytes of the frame.
         * @return Return the frame in bytes
@@ -104,13 +161,51 @@ namespace DirectShowCamera
         std::shared_ptr<unsigned char[]> getFrameData(int& numOfBytes);
 
         /**
-        * @brief    Return a cloned frame 16 bit data. The data is in the order of pixel by pixel, row by row.
+        * @brief    Decode the frame into a caller-provided buffer, e.g. a pooled image, a tile of a mosaic canvas or a shared memory slot. Nothing is allocated.
+        *           The decoded frame is in the size of getDecodedWidth() x getDecodedHeight(). See FrameDecoder::DecodeFrame().
+        * @param[in] destination Destination
+        */
+        void getFrameData(const FrameDestination& destination);
+
+        /**
+        * @brief    Decode the frame into the planes of a caller-provided float tensor for inference, e.g. the CHW input of a model. See FrameDecoder::DecodeFrameToTensor().
+        *           The binning and the resize of the frame settings are replaced by the resize to the tensor, see FrameDecoder::getTensorRegion().
+        * @param[in] destination Destination
+        */
+        void getTensor(const TensorDestination& destination);
+
+        /**
+        * @brief    Return a cloned frame 16 bit data. The data is in the order of pixel by pixel, row by row, in the size of getDecodedWidth() x getDecodedHeight().
         *           You will need to know the width, height and frame type to decode the data.
         * @param[out] numOfBytes   Number of bytes of the frame.
         * @return Return the frame in bytes
         */
         std::shared_ptr<unsigned short[]> getFrame16bitData(int& numOfBytes);
 
+        /**
+        * @brief    Return a 8 bit gray frame data mapped from a 16 bit monochrome frame in one pass, e.g. for a preview. The data is in the order of pixel by pixel, row by row.
+        *           The samples are converted to getBitDepth() before the tone mapping. See FrameDecoder::Decode16BitMonochromeFrameTo8Bit().
+        * @param[out] numOfBytes   Number of bytes of the frame.
+        * @param[in] toneMapSettings (Optional) Tone mapping. Default as ToneMapSettings(), i.e. auto range.
+        * @return Return the gray frame in bytes
+        */
+        std::shared_ptr<unsigned char[]> getToneMappedFrameData(int& numOfBytes, const ToneMapSettings& toneMapSettings = ToneMapSettings());
+
+        /**
+        * @brief    Return a cloned 8 bit gray frame data. The data is in the order of pixel by pixel, row by row.
+        *           It is the Y channel of a YUV or MJPEG frame, so no color conversion is done. An 8 bit monochrome frame is returned as it is.
+        * @param[out] numOfBytes   Number of bytes of the frame.
+        * @return Return the gray frame in bytes
+        */
+        std::shared_ptr<unsigned char[]> getGrayFrameData(int& numOfBytes);
+
+        /**
+        * @brief    Get the planes of a YUV 4:2:0 frame, e.g. NV12 captured by DirectShowCamera::setRawYUVCapture(). No data is copied, the planes point into the frame data,
+        *           so they are valid until the frame is changed or destroyed. The rows are stored from the top, see FrameDecoder::DecodeYUV420Frame().
+        * @return Return the planes
+        */
+        YUV420Planes getYUV420Planes() const;
+
 #pragma endregion Frame
 
 #pragma region Getter
@@ -127,6 +222,13 @@ namespace DirectShowCamera
         */
         unsigned long getFrameIndex() const;
 
+        /**
+         * @brief   Get the capture timestamps, which are the device presentation time and the std::chrono::steady_clock arrival time in nanosecond.
+         *          Compare the arrival time with FrameTimestamp::Now() to measure the latency.
+         * @return Return the capture timestamps
+        */
+        FrameTimestamp getTimestamp() const;
+
         /**
          * @brief Get the frame width in pixel
          * @return Return the frame width
@@ -139,6 +241,18 @@ namespace DirectShowCamera
         */
         int getHeight() const;
 
+        /**
+         * @brief Get the width of the decoded frame in pixel, e.g. getFrameData() and getMat(). It is smaller than the frame width if the frame settings bin or resize the frame.
+         * @return Return the decoded width
+        */
+        int getDecodedWidth() const;
+
+        /**
+         * @brief Get the height of the decoded frame in pixel, e.g. getFrameData() and getMat(). It is smaller than the frame height if the frame settings bin or resize the frame.
+         * @return Return the decoded height
+        */
+        int getDecodedHeight() const;
+
         /**
          * @brief Get frame size in bytes
          * @return Return the the frame size in bytes
@@ -151,12 +265,27 @@ namespace DirectShowCamera
         */
         FrameType getFrameType() const;
 
+        /**
+        * @brief    Get the significant bits per sample of the decoded frame, e.g. 8 for a color frame. A 16bit monochrome frame is decoded in the bit depth of
+        *           FrameSettings::OutputBitDepth, or the source bit depth, e.g. 10 for Y10, so a normalized frame doesn't need another pass.
+        * @return Return the bit depth. Return 0 if the frame is empty.
+        */
+        int getBitDepth() const;
+
         /**
         * @brief Get the frame settings
         * @return Return the frame settings by reference so that you can change the settings.
         */
         FrameSettings& getFrameSettings();
 
+        /**
+        * @brief    Get the statistics of the decoded frame, e.g. for auto exposure or quality gating. They are accumulated while the frame is decoded by getFrameData(), getFrame16bitData() or getMat()
+        *           if FrameSettings::Statistics is not FrameStatisticsMode::None. If the frame hasn't been decoded with the current frame settings, it is decoded once into a buffer
+        *           which is kept by the frame and reused by the next recompute.
+        * @return Return the statistics. Return nullptr if the frame is empty or FrameSettings::Statistics is FrameStatisticsMode::None.
+        */
+        std::shared_ptr<const FrameStatistics> getStatistics();
+
 #pragma endregion Getter
 
 #ifdef WITH_OPENCV2
@@ -168,13 +297,32 @@ namespace DirectShowCamera
         */
         cv::Mat getMat();
 
+        /**
+         * @brief Decode the current frame into an existing cv::Mat, e.g. a pooled cv::Mat or a region of a canvas. See FrameDecoder::DecodeFrameToCVMat().
+         * @param[in, out] result cv::Mat. It is reused if it is in the decoded size and type.
+        */
+        void getMat(cv::Mat& result);
+
+        /**
+         * @brief Get 8 bit gray cv::Mat of the current frame. See getGrayFrameData().
+         * @return Return cv::Mat
+        */
+        cv::Mat getGrayMat();
+
+        /**
+         * @brief Get 8 bit gray cv::Mat mapped from a 16 bit monochrome frame. See getToneMappedFrameData().
+         * @param[in] toneMapSettings (Optional) Tone mapping. Default as ToneMapSettings(), i.e. auto range.
+         * @return Return cv::Mat
+        */
+        cv::Mat getToneMappedMat(const ToneMapSettings& toneMapSettings = ToneMapSettings());
+
 #pragma endregion OpenCV
 #endif
 
 #pragma region Operator
 
         /**
-        * @brief Copy assignment
+        * @brief Copy assignment. The frame data is shared with other until either frame is modified, no copy is made.
         */
         Frame& operator=(const Frame& other)
         {
@@ -184,13 +332,12 @@ namespace DirectShowCamera
                 m_height = other.m_height;
                 m_frameSize = other.m_frameSize;
                 m_frameIndex = other.m_frameIndex;
+                m_timestamp = other.m_timestamp;
                 m_frameType = other.m_frameType;
                 m_frameSettings = other.m_frameSettings;
-                if (other.m_data != nullptr)
-                {
-                    m_data = std::make_unique<unsigned char[]>(m_frameSize);
-                    memcpy(m_data.get(), other.m_data.get(), m_frameSize);
-                }
+                m_statistics = other.m_statistics;
+                m_statisticsSettings = other.m_statisticsSettings;
+                m_data = other.m_data;
             }
             return *this;
         }
@@ -207,15 +354,18 @@ namespace DirectShowCamera
                 m_height = other.m_height;
                 m_frameSize = other.m_frameSize;
                 m_frameIndex = other.m_frameIndex;
+                m_timestamp = other.m_timestamp;
                 m_frameType = other.m_frameType;
                 m_frameSettings = other.m_frameSettings;
+                m_statistics = std::move(other.m_statistics);
+                m_statisticsSettings = other.m_statisticsSettings;
                 m_data = std::move(other.m_data);
             }
             return *this;
         }
 
         /**
-        * @brief equal operator
+        * @brief equal operator. Capture timestamps are not compared. Pixels are not compared if both frames share the same data.
         */
         bool operator==(const Frame& other) const
         {
@@ -226,16 +376,11 @@ namespace DirectShowCamera
             if (m_frameType != other.m_frameType) return false;
             if (m_frameSettings != other.m_frameSettings) return false;
 
-            if (m_data == nullptr && other.m_data != nullptr) return false;
-            if (m_data != nullptr && other.m_data == nullptr) return false;
-            if (m_data != nullptr && other.m_data != nullptr)
-            {
-                for (int i = 0; i < m_frameSize; i++)
-                {
-                    if (m_data[i] != other.m_data[i]) return false;
-                }
-            }
-            return true;
+            const unsigned char* data = getData();
+            const unsigned char* otherData = other.getData();
+            if (data == otherData) return true;
+            if (data == nullptr || otherData == nullptr) return false;
+            return memcmp(data, otherData, m_frameSize) == 0;
         }
 
         /**
@@ -258,6 +403,31 @@ namespace DirectShowCamera
             const Gdiplus::EncoderParameters* encoderParams = NULL
         );
 
+    private:
+
+        /**
+        * @brief Get the read-only frame data
+        * @return Return the frame data. Return nullptr if the frame is empty.
+        */
+        const unsigned char* getData() const;
+
+        /**
+        * @brief Get the frame buffer if it is not shared with other frames, so that it can be modified or reused.
+        * @return Return the frame buffer. Return nullptr if the frame has no storage or the data is shared with other frames.
+        */
+        FrameBuffer* getExclusiveData();
+
+        /**
+        * @brief Make sure the frame data is not shared with other frames before modifying it. The data is copied if it is shared.
+        */
+        void DetachData();
+
+        /**
+        * @brief Keep the statistics of the last decode with the current frame settings
+        * @param[in] statistics Statistics. They are ignored if they are not accumulated.
+        */
+        void UpdateStatistics(const FrameStatistics& statistics);
+
     private:
 
         /**
@@ -267,8 +437,11 @@ namespace DirectShowCamera
         * 4 5 6
         * 7 8 9
         * The raw data will be [9,8,7,4,5,6,1,2,3] and each number is 3 byte which is BGR.
+        *
+        * Copy-on-write storage. A copied frame shares the storage with the source frame instead of copying the pixels, so copying a const frame doesn't modify it.
+        * The storage is kept and its buffer is reused by ImportData() and ExchangeData() as long as no other frame shares it.
         */
-        std::unique_ptr<unsigned char[]> m_data = nullptr;
+        std::shared_ptr<FrameBuffer> m_data = nullptr;
         long m_frameSize = 0; // In number of byte
 
         int m_width = -1;
@@ -276,7 +449,19 @@ namespace DirectShowCamera
         GUID m_frameType;
         FrameSettings m_frameSettings;
 
+        /**
+        * Statistics of the last decode and the frame settings they were decoded with. They are dropped when the data changes.
+        */
+        std::shared_ptr<const FrameStatistics> m_statistics = nullptr;
+        FrameSettings m_statisticsSettings;
+
+        /**
+        * Decode buffer of getStatistics(). It is a scratch buffer of this frame, so it is neither copied nor moved.
+        */
+        FrameBuffer m_statisticsBuffer = nullptr;
+
         unsigned long m_frameIndex = 0;
+        FrameTimestamp m_timestamp;
 
     };
 
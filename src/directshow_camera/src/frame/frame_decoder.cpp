@@ -5,43 +5,348 @@
 **/
 
 #include "frame/frame_decoder.h"
+#include "frame/frame_subtype_registry.h"
+#include "frame/row_kernel.h"
 
-#include "directshow_camera/video_format/ds_guid.h"
+#include "buffer/frame_pool.h"
 #include "directshow_camera/utils/ds_video_format_utils.h"
+#include "directshow_camera/video_format/ds_guid.h"
+#include "utils/thread_pool.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace DirectShowCamera
 {
+    namespace
+    {
+        /**
+        * @brief Find the traits of a video type. If not supported, throw exception.
+        * @param[in] videoType Video Type
+        * @return Return the traits
+        */
+        const FrameSubtypeTraits& FindTraits(const GUID videoType)
+        {
+            const auto traits = FrameSubtypeRegistry::Find(videoType);
+            if (traits == nullptr)
+            {
+                throw std::invalid_argument("Video type(" + DirectShowVideoFormatUtils::ToString(videoType) + ") is not supported.");
+            }
+            return *traits;
+        }
+
+        /**
+        * @brief Find the traits of a video type in a family. If not found, throw exception.
+        * @param[in] videoType Video Type
+        * @param[in] family Family
+        * @param[in] familyName Family name used in the exception message
+        * @return Return the traits
+        */
+        const FrameSubtypeTraits& FindTraits(const GUID videoType, const FrameSubtypeFamily family, const char* familyName)
+        {
+            const auto traits = FrameSubtypeRegistry::Find(videoType, family);
+            if (traits == nullptr)
+            {
+                throw std::invalid_argument("Video type(" + DirectShowVideoFormatUtils::ToString(videoType) + ") is not a " + std::string(familyName) + " type.");
+            }
+            return *traits;
+        }
+
+        /**
+        * @brief Get the subtypes of a family
+        * @param[in] family Family
+        * @return Return the subtypes
+        */
+        std::vector<GUID> getSubtypes(const FrameSubtypeFamily family)
+        {
+            std::vector<GUID> result;
+            for (const auto& traits : FrameSubtypeRegistry::getAll())
+            {
+                if (traits.Family == family) result.push_back(traits.Subtype);
+            }
+            return result;
+        }
+
+        /**
+        * @brief Create the frame settings of the decode functions taking flags
+        * @param[in] verticalFlip Flip the image vertically
+        * @param[in] outputRGB Output as RGB
+        * @param[in] horizontalMirror Mirror the image horizontally
+        * @return Return the frame settings
+        */
+        FrameSettings ToFrameSettings(const bool verticalFlip, const bool outputRGB, const bool horizontalMirror)
+        {
+            FrameSettings frameSettings;
+            frameSettings.VerticalFlip = verticalFlip;
+            frameSettings.BGR = !outputRGB;
+            frameSettings.HorizontalMirror = horizontalMirror;
+            return frameSettings;
+        }
+
+        /**
+        * @brief Get the byte order of a YUV 4:2:2 video type
+        * @param[in] videoType Video Type
+        * @return Return the byte order
+        */
+        YUV422Layout getYUV422Layout(const GUID videoType)
+        {
+            return videoType == MEDIASUBTYPE_UYVY ? YUV422Layout::UYVY : YUV422Layout::YUYV;
+        }
+
+        /**
+        * @brief Get the plane layout of a YUV 4:2:0 video type
+        * @param[in] videoType Video Type
+        * @return Return the plane layout
+        */
+        YUV420Layout getYUV420Layout(const GUID videoType)
+        {
+            return videoType == MEDIASUBTYPE_NV12 ? YUV420Layout::NV12 : YUV420Layout::I420;
+        }
+
+        /**
+        * @brief Get the bit layout of a packed 16bit monochrome video type and check the width. If the width isn't a multiple of the packing group, throw exception.
+        * @param[in] videoType Video Type. It must be Y10P or Y12P.
+        * @param[in] width Width
+        * @return Return the bit layout
+        */
+        PackedMonochromeLayout getPackedMonochromeLayout(const GUID videoType, const int width)
+        {
+            const auto layout = videoType == MEDIASUBTYPE_Y10P ? PackedMonochromeLayout::Y10P : PackedMonochromeLayout::Y12P;
+            if (width % BitDepthKernel::getPixelsPerGroup(layout) != 0)
+            {
+                throw std::invalid_argument("Width(" + std::to_string(width) + ") of a " + DirectShowVideoFormatUtils::ToString(videoType) + " frame should be a multiple of " + std::to_string(BitDepthKernel::getPixelsPerGroup(layout)) + ".");
+            }
+            return layout;
+        }
+
+        /**
+        * @brief Check if a 16bit monochrome video type is packed
+        * @param[in] videoType Video Type
+        * @return Return true if the video type is Y10P or Y12P
+        */
+        bool isPackedMonochrome(const GUID videoType)
+        {
+            return videoType == MEDIASUBTYPE_Y10P || videoType == MEDIASUBTYPE_Y12P;
+        }
+
+        /**
+        * @brief Get the pattern of a Bayer video type
+        * @param[in] videoType Video Type. It must be a Bayer type.
+        * @return Return the pattern of the first row
+        */
+        BayerPattern getBayerPattern(const GUID videoType)
+        {
+            if (videoType == MEDIASUBTYPE_RGGB || videoType == MEDIASUBTYPE_RG16) return BayerPattern::RGGB;
+            if (videoType == MEDIASUBTYPE_BA81 || videoType == MEDIASUBTYPE_BYR2) return BayerPattern::BGGR;
+            if (videoType == MEDIASUBTYPE_GRBG || videoType == MEDIASUBTYPE_GR16) return BayerPattern::GRBG;
+            return BayerPattern::GBRG;
+        }
+
+        /**
+        * @brief Check the size of a Bayer frame and get the conversion of the 16bit samples to 8 bit. If the size is odd, throw exception.
+        * @param[in] bitsPerSample 8 or 16
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] frameSettings Frame settings. SourceBitDepth and SourceMSBJustified are used.
+        * @return Return the conversion. The output bit depth is 8.
+        */
+        BitDepthConversion getBayerConversion(const int bitsPerSample, const int width, const int height, const FrameSettings& frameSettings)
+        {
+            if (width < 2 || height < 2 || width % 2 != 0 || height % 2 != 0)
+            {
+                throw std::invalid_argument("Size(" + std::to_string(width) + "x" + std::to_string(height) + ") of a Bayer frame must be even.");
+            }
+
+            BitDepthConversion conversion;
+            conversion.InputBitDepth = bitsPerSample == 8 || frameSettings.SourceBitDepth == 0 ? bitsPerSample : frameSettings.SourceBitDepth;
+            conversion.InputMSBJustified = bitsPerSample == 16 && frameSettings.SourceMSBJustified;
+            conversion.OutputBitDepth = 8;
+            BitDepthKernel::CheckConversion(conversion);
+            return conversion;
+        }
+
+        /**
+        * @brief Get the table to bin or resize the decoded rows by the frame settings. If the settings are invalid, throw exception.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] channels Samples per decoded pixel
+        * @param[in] bytesPerSample Bytes per decoded sample
+        * @param[in] frameSettings Frame settings
+        * @return Return the table. Return nullptr if the frame is not resized.
+        */
+        std::shared_ptr<const ResizeTable> getResizeTable(const int width, const int height, const int channels, const int bytesPerSample, const FrameSettings& frameSettings)
+        {
+            if (!FrameDecoder::isResized(frameSettings)) return nullptr;
+
+            int decodedWidth = 0;
+            int decodedHeight = 0;
+            FrameDecoder::getDecodedSize(width, height, frameSettings, decodedWidth, decodedHeight);
+
+            // A resize covers the whole frame, a binning covers the full blocks only
+            const bool binned = frameSettings.ResizeWidth == 0 && frameSettings.ResizeHeight == 0;
+            return std::make_shared<const ResizeTable>(
+                ResizeKernel::BuildTable(
+                    binned ? decodedWidth * frameSettings.Binning : width,
+                    binned ? decodedHeight * frameSettings.Binning : height,
+                    decodedWidth,
+                    decodedHeight,
+                    channels,
+                    bytesPerSample
+                )
+            );
+        }
+
+        /**
+        * @brief Get the number of bytes per output row
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] width Width
+        * @param[in] bytesPerPixel Bytes per decoded pixel
+        * @param[in] resizeTable Resize table. Set it as nullptr if the frame is not resized.
+        * @return Return outputBytesPerRow if it is set, otherwise the number of bytes per packed decoded row
+        */
+        int getOutputBytesPerRow(const int outputBytesPerRow, const int width, const int bytesPerPixel, const ResizeTable* resizeTable)
+        {
+            if (outputBytesPerRow > 0) return outputBytesPerRow;
+            return (resizeTable != nullptr ? resizeTable->Horizontal.getOutputSize() : width) * bytesPerPixel;
+        }
+
+        /**
+        * @brief Resize a frame decoded in full size. It is used by the decoders which don't decode a frame row by row, e.g. MJPEG.
+        * @param[in] decodedData Decoded data. Rows are stored top-down.
+        * @param[out] outputData Output data in the size of the table
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] bytesPerPixel Bytes per pixel
+        * @param[in] resizeTable Resize table
+        * @param[in] threadPool Split the rows into bands and run them on the thread pool. Run on the calling thread if it is nullptr.
+        * @param[in, out] statistics Statistics accumulator of the output. Set it as nullptr to skip the statistics.
+        * @param[out] tensor Tensor written instead of the output data. Set it as nullptr to write the output data.
+        */
+        void ResizeDecodedFrame(
+            const unsigned char* decodedData,
+            unsigned char* outputData,
+            const int outputBytesPerRow,
+            const int width,
+            const int height,
+            const int bytesPerPixel,
+            const ResizeTable& resizeTable,
+            Utils::ThreadPool* threadPool,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        )
+        {
+            // Keep the row order
+            RowKernel::Run(
+                decodedData,
+                outputData,
+                width,
+                height,
+                width * bytesPerPixel,
+                getOutputBytesPerRow(outputBytesPerRow, width, bytesPerPixel, &resizeTable),
+                true,
+                RowKernel::getCopyKernel(bytesPerPixel, false),
+                threadPool,
+                &resizeTable,
+                statistics,
+                tensor
+            );
+        }
+
+        /**
+        * @brief Take a scratch buffer to decode a frame in full size. It is used by the decoders which don't decode a frame row by row, e.g. MJPEG.
+        *        The buffers are recycled by a pool, so a steady stream of frames in the same size doesn't allocate.
+        * @param[in] numOfBytes Number of bytes
+        * @return Return the buffer. It is uninitialized. Return nullptr if numOfBytes <= 0.
+        */
+        FrameBuffer AcquireScratchBuffer(const int numOfBytes)
+        {
+            static const auto pool = std::make_shared<FramePool>();
+            return pool->Acquire(numOfBytes);
+        }
+
+        /**
+        * @brief Get the first pixel of the decoded frame in a destination. If the decoded frame is not inside the buffer, throw exception.
+        * @param[in] destination Destination
+        * @param[in] decodedWidth Decoded width
+        * @param[in] decodedHeight Decoded height
+        * @return Return the first pixel
+        */
+        unsigned char* getDestinationData(const FrameDestination& destination, const int decodedWidth, const int decodedHeight)
+        {
+            if (destination.Data == nullptr) throw std::invalid_argument("Destination data is nullptr.");
+            if (destination.BytesPerRow != 0 && destination.BytesPerRow < destination.Width * destination.getBytesPerPixel())
+            {
+                throw std::invalid_argument(
+                    "Bytes per row(" + std::to_string(destination.BytesPerRow) + ") of the destination is smaller than the width(" + std::to_string(destination.Width) + ") of " +
+                    std::to_string(destination.getBytesPerPixel()) + " bytes per pixel."
+                );
+            }
+            if (destination.X < 0 || destination.Y < 0 || destination.X + decodedWidth > destination.Width || destination.Y + decodedHeight > destination.Height)
+            {
+                throw std::invalid_argument(
+                    "Decoded frame(" + std::to_string(decodedWidth) + "x" + std::to_string(decodedHeight) + ") at (" + std::to_string(destination.X) + ", " + std::to_string(destination.Y) +
+                    ") is outside the destination(" + std::to_string(destination.Width) + "x" + std::to_string(destination.Height) + ")."
+                );
+            }
+            return destination.Data + (long long)destination.Y * destination.getBytesPerRow() + (long long)destination.X * destination.getBytesPerPixel();
+        }
+
+        /**
+        * @brief Create the statistics accumulator of a decoded frame by the frame settings
+        * @param[in] traits Traits of the video type
+        * @param[in] frameSettings Frame settings
+        * @param[in] statistics Statistics requested by the caller. nullptr if the statistics are not requested.
+        * @return Return the accumulator. Return nullptr if the statistics are not requested or FrameSettings::Statistics is FrameStatisticsMode::None.
+        */
+        std::unique_ptr<StatisticsAccumulator> CreateStatisticsAccumulator(const FrameSubtypeTraits& traits, const FrameSettings& frameSettings, const FrameStatistics* statistics)
+        {
+            if (statistics == nullptr || frameSettings.Statistics == FrameStatisticsMode::None) return nullptr;
+
+            // The 16bit monochrome samples are in the decoded bit depth, the others are 8 bit
+            const bool is16Bit = traits.Family == FrameSubtypeFamily::Monochrome16bit;
+            const int bytesPerSample = is16Bit ? 2 : 1;
+            return std::make_unique<StatisticsAccumulator>(
+                StatisticsKernel::CreateAccumulator(
+                    traits.DecodedBytesPerPixel / bytesPerSample,
+                    bytesPerSample,
+                    is16Bit ? FrameDecoder::getBitDepth(traits.Subtype, frameSettings) : 8,
+                    frameSettings.Statistics == FrameStatisticsMode::Sparse ? frameSettings.StatisticsSampleStep : 1
+                )
+            );
+        }
+
+        // Parallel decode settings
+        std::mutex g_decodeThreadPoolMutex;
+        std::shared_ptr<Utils::ThreadPool> g_decodeThreadPool = nullptr;
+        std::atomic<int> g_numOfDecodeThreads = 1;
+        std::atomic<int> g_parallelDecodeMinFrameSize = 1920 * 1080;
+    }
+
 #pragma region Support Video Type
     std::vector<GUID> FrameDecoder::SupportVideoType()
     {
-        const auto monochromeVideoType = SupportMonochromeVideoType();
-        const auto monochrome16BitVideoType = Support16BitMonochromeVideoType();
-        const auto rgbVideoType = SupportRGBVideoType();
-
         std::vector<GUID> result;
-        result.insert(result.end(), monochromeVideoType.begin(), monochromeVideoType.end());
-        result.insert(result.end(), monochrome16BitVideoType.begin(), monochrome16BitVideoType.end());
-        result.insert(result.end(), rgbVideoType.begin(), rgbVideoType.end());
+        for (const auto& traits : FrameSubtypeRegistry::getAll())
+        {
+            result.push_back(traits.Subtype);
+        }
         return result;
     }
 
     bool FrameDecoder::isSupportedVideoType(const GUID videoType)
     {
-        for (const auto supportedtype : SupportVideoType())
-        {
-            if (supportedtype == videoType) return true;
-        }
-        return false;
+        return FrameSubtypeRegistry::Find(videoType) != nullptr;
     }
 
     void FrameDecoder::CheckSupportVideoType(const GUID videoType)
     {
-        if (!isSupportedVideoType(videoType))
-        {
-            throw std::invalid_argument("Video type(" + DirectShowVideoFormatUtils::ToString(videoType) + ") is not supported.");
-        }
+        FindTraits(videoType);
     }
 
 #pragma endregion Support Video Type
@@ -50,58 +355,50 @@ namespace DirectShowCamera
 
     std::vector<GUID> FrameDecoder::SupportMonochromeVideoType()
     {
-        return { MEDIASUBTYPE_Y800, MEDIASUBTYPE_Y8, MEDIASUBTYPE_GREY };
+        return getSubtypes(FrameSubtypeFamily::Monochrome8bit);
     }
 
     bool FrameDecoder::isMonochromeFrameType(const GUID videoType)
     {
-        for (const auto supportedtype : SupportMonochromeVideoType())
-        {
-            if (supportedtype == videoType) return true;
-        }
-        return false;
+        return FrameSubtypeRegistry::Find(videoType, FrameSubtypeFamily::Monochrome8bit) != nullptr;
     }
 
     void FrameDecoder::CheckMonochromeFrameType(const GUID videoType)
     {
         // Check
-        if (!isMonochromeFrameType(videoType))
-        {
-            throw std::invalid_argument("Video type(" + DirectShowVideoFormatUtils::ToString(videoType) + ") is not a Monochrome type.");
-        }
+        FindTraits(videoType, FrameSubtypeFamily::Monochrome8bit, "Monochrome");
     }
 
     void FrameDecoder::DecodeMonochromeFrame(
-        unsigned char* inputData,
+        const unsigned char* inputData,
         unsigned char* outputData,
         const GUID videoType,
         const int width,
         const int height,
-        const bool verticalFlip
+        const bool verticalFlip,
+        const bool horizontalMirror
     )
     {
-        // Check
-        CheckMonochromeFrameType(videoType);
-
-        // Copy 1 byte per pixel
-        CloneRawData(inputData, outputData, width, height, 1, verticalFlip);
+        // Check and decode
+        FindTraits(videoType, FrameSubtypeFamily::Monochrome8bit, "Monochrome").Decode(inputData, outputData, width, height, 0, ToFrameSettings(verticalFlip, false, horizontalMirror), nullptr, nullptr);
     }
 
     std::shared_ptr<unsigned char[]> FrameDecoder::DecodeMonochromeFrame(
-        unsigned char* data,
+        const unsigned char* data,
         const GUID videoType,
         const int width,
         const int height,
-        const bool verticalFlip)
+        const bool verticalFlip,
+        const bool horizontalMirror)
     {
         // Check
-        CheckMonochromeFrameType(videoType);
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::Monochrome8bit, "Monochrome");
 
         // Initialize result buffer
-        auto result = std::make_shared<unsigned char[]>(height * width);
+        auto result = std::make_shared<unsigned char[]>(height * width * traits.DecodedBytesPerPixel);
 
         // Decode
-        DecodeMonochromeFrame(data, result.get(), videoType, width, height, verticalFlip);
+        traits.Decode(data, result.get(), width, height, 0, ToFrameSettings(verticalFlip, false, horizontalMirror), nullptr, nullptr);
 
         return result;
     }
@@ -112,342 +409,1742 @@ namespace DirectShowCamera
 
     std::vector<GUID> FrameDecoder::Support16BitMonochromeVideoType()
     {
-        return { MEDIASUBTYPE_Y16 };
+        return getSubtypes(FrameSubtypeFamily::Monochrome16bit);
     }
 
     bool FrameDecoder::is16BitMonochromeFrameType(const GUID videoType)
     {
-        for (const auto supportedtype : Support16BitMonochromeVideoType())
-        {
-            if (supportedtype == videoType) return true;
-        }
-        return false;
+        return FrameSubtypeRegistry::Find(videoType, FrameSubtypeFamily::Monochrome16bit) != nullptr;
     }
 
     void FrameDecoder::Check16BitMonochromeFrameType(const GUID videoType)
     {
         // Check
-        if (!is16BitMonochromeFrameType(videoType))
-        {
-            throw std::invalid_argument("Video type(" + DirectShowVideoFormatUtils::ToString(videoType) + ") is not a 16Bit Monochrome type.");
-        }
+        FindTraits(videoType, FrameSubtypeFamily::Monochrome16bit, "16Bit Monochrome");
     }
 
-    void FrameDecoder::Decode16BitMonochromeFrame(unsigned char* inputData, unsigned short* outputData, const GUID videoType, const int width, const int height, const bool verticalFlip)
+    void FrameDecoder::Decode16BitMonochromeFrame(const unsigned char* inputData, unsigned short* outputData, const GUID videoType, const int width, const int height, const bool verticalFlip, const bool horizontalMirror)
     {
-        // Check
-        Check16BitMonochromeFrameType(videoType);
-
-        // Copy 2 byte per pixel
-        CloneRawData(inputData, (unsigned char*)outputData, width, height, 2, verticalFlip);
+        // Check and decode
+        FindTraits(videoType, FrameSubtypeFamily::Monochrome16bit, "16Bit Monochrome").Decode(inputData, (unsigned char*)outputData, width, height, 0, ToFrameSettings(verticalFlip, false, horizontalMirror), nullptr, nullptr);
     }
 
     std::shared_ptr<unsigned short[]> FrameDecoder::Decode16BitMonochromeFrame(
-        unsigned char* data,
+        const unsigned char* data,
         const GUID videoType,
         const int width,
         const int height,
-        const bool verticalFlip)
+        const bool verticalFlip,
+        const bool horizontalMirror)
     {
         // Check
-        Check16BitMonochromeFrameType(videoType);
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::Monochrome16bit, "16Bit Monochrome");
 
         // Initialize result buffer
         auto result = std::make_shared<unsigned short[]>(height * width);
 
         // Decode
-        Decode16BitMonochromeFrame(data, result.get(), videoType, width, height, verticalFlip);
+        traits.Decode(data, (unsigned char*)result.get(), width, height, 0, ToFrameSettings(verticalFlip, false, horizontalMirror), nullptr, nullptr);
 
         return result;
     }
 
-#pragma endregion 16bit Monochrome
+    BitDepthConversion FrameDecoder::getBitDepthConversion(const GUID videoType, const FrameSettings& frameSettings)
+    {
+        // Check
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::Monochrome16bit, "16Bit Monochrome");
 
-#pragma region RGB
+        // The packed types define their own bit depth and justification
+        const bool isPacked = traits.BitsPerPixel < 16;
 
-    std::vector<GUID> FrameDecoder::SupportRGBVideoType()
+        BitDepthConversion conversion;
+        conversion.InputBitDepth = isPacked || frameSettings.SourceBitDepth == 0 ? traits.BitDepth : frameSettings.SourceBitDepth;
+        conversion.InputMSBJustified = !isPacked && frameSettings.SourceMSBJustified;
+        conversion.OutputBitDepth = frameSettings.OutputBitDepth == 0 ? conversion.InputBitDepth : frameSettings.OutputBitDepth;
+        BitDepthKernel::CheckConversion(conversion);
+
+        return conversion;
+    }
+
+    int FrameDecoder::getBitDepth(const GUID videoType, const FrameSettings& frameSettings)
     {
-        return { MEDIASUBTYPE_RGB8, MEDIASUBTYPE_YUY2, MEDIASUBTYPE_RGB565, MEDIASUBTYPE_RGB555, MEDIASUBTYPE_RGB24, MEDIASUBTYPE_MJPG };
+        const auto& traits = FindTraits(videoType);
+        return traits.Family == FrameSubtypeFamily::Monochrome16bit ? getBitDepthConversion(videoType, frameSettings).OutputBitDepth : traits.BitDepth;
     }
 
-    bool FrameDecoder::isRGBFrameType(const GUID videoType)
+    void FrameDecoder::Decode16BitMonochromeFrameTo8Bit(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const ToneMapSettings& toneMapSettings,
+        const FrameSettings& frameSettings
+    )
     {
-        for (const auto supportedtype : SupportRGBVideoType())
-        {
-            if (supportedtype == videoType) return true;
-        }
-        return false;
+        // Check and decode
+        Check16BitMonochromeFrameType(videoType);
+        Decode16BitMonochromeTo8Bit(inputData, outputData, videoType, width, height, toneMapSettings, frameSettings);
     }
 
-    void FrameDecoder::CheckRGBFrameType(const GUID videoType)
+    void FrameDecoder::Decode16BitMonochromeFrameTo8Bit(
+        const unsigned char* inputData,
+        const FrameDestination& destination,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const ToneMapSettings& toneMapSettings,
+        const FrameSettings& frameSettings
+    )
     {
         // Check
-        if (!isRGBFrameType(videoType))
-        {
-            throw std::invalid_argument("Video type(" + DirectShowVideoFormatUtils::ToString(videoType) + ") is not a RGB type.");
-        }
+        Check16BitMonochromeFrameType(videoType);
+        if (destination.PixelFormat != FramePixelFormat::Gray8) throw std::invalid_argument("Pixel format(" + std::to_string((int)destination.PixelFormat) + ") of the destination is not Gray8.");
+        int decodedWidth = 0;
+        int decodedHeight = 0;
+        getDecodedSize(width, height, frameSettings, decodedWidth, decodedHeight);
+        unsigned char* outputData = getDestinationData(destination, decodedWidth, decodedHeight);
+
+        // Decode
+        Decode16BitMonochromeTo8Bit(inputData, outputData, videoType, width, height, toneMapSettings, frameSettings, destination.getBytesPerRow());
     }
 
-    void FrameDecoder::DecodeRGBFrame(
-        unsigned char* inputData,
-        unsigned char* outputData,
+    std::shared_ptr<unsigned char[]> FrameDecoder::Decode16BitMonochromeFrameTo8Bit(
+        const unsigned char* data,
         const GUID videoType,
         const int width,
         const int height,
-        const bool verticalFlip,
-        const bool outputRGB
+        const ToneMapSettings& toneMapSettings,
+        const FrameSettings& frameSettings
     )
     {
         // Check
-        CheckRGBFrameType(videoType);
-
-        if (!outputRGB)
-        {
-            // Copy 3 byte per pixel in BGR format
-            CloneRawData(inputData, outputData, width, height, 3, verticalFlip);
-        }
-        else
-        {
-            // Convert to RGB
-            if (verticalFlip) {
-                // Notes: inputData default is vertical flipped. So do nothing if verticalFlip == true
+        Check16BitMonochromeFrameType(videoType);
 
-                // Copy 3 byte per pixel from BGR to RGB format
-                unsigned char* inputDataPtrTemp = inputData;
-                unsigned char* outputDataPtrTemp = outputData;
-                const int frameSize = width * height * 3;
+        // Initialize result buffer
+        int decodedWidth = 0;
+        int decodedHeight = 0;
+        getDecodedSize(width, height, frameSettings, decodedWidth, decodedHeight);
+        auto result = std::make_shared<unsigned char[]>(decodedHeight * decodedWidth);
 
-                // 3 byte - BGR - No Vertical flip
-                for (int i = 0; i < frameSize; i += 3) {
+        // Decode
+        Decode16BitMonochromeTo8Bit(data, result.get(), videoType, width, height, toneMapSettings, frameSettings);
 
-                    // Copy R to B
-                    *outputDataPtrTemp = *(inputDataPtrTemp + 2);
-                    outputDataPtrTemp++;
+        return result;
+    }
 
-                    // Copy G
-                    *outputDataPtrTemp = *(inputDataPtrTemp + 1);
-                    outputDataPtrTemp++;
+    ToneMapTable FrameDecoder::getToneMapTable(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const ToneMapSettings& toneMapSettings,
+        const FrameSettings& frameSettings
+    )
+    {
+        const auto conversion = getBitDepthConversion(videoType, frameSettings);
 
-                    // Copy B to R
-                    *outputDataPtrTemp = *inputDataPtrTemp;
-                    outputDataPtrTemp++;
+        // Fixed window
+        if (toneMapSettings.Mode == ToneMapMode::Window)
+        {
+            return ToneMapKernel::BuildTable(toneMapSettings.WindowLow, toneMapSettings.WindowHigh, toneMapSettings.Gamma);
+        }
 
-                    // Move to next pixel
-                    inputDataPtrTemp += 3;
-                }
+        // Check
+        const int step = toneMapSettings.AutoRangeSampleStep;
+        if (step < 1) throw std::invalid_argument("Auto range sample step(" + std::to_string(step) + ") can't be < 1.");
+
+        // Sample the min and max of every n-th pixel of every n-th row. The sampled rows are converted as in the decode.
+        const bool isPacked = isPackedMonochrome(videoType);
+        const auto layout = isPacked ? getPackedMonochromeLayout(videoType, width) : PackedMonochromeLayout::Y10P;
+        const int inputBytesPerRow = isPacked ? width * BitDepthKernel::getBitDepth(layout) / 8 : width * 2;
+        const bool isIdentity = BitDepthKernel::isIdentity(conversion);
+
+        std::vector<unsigned short> rowBuffer(isPacked || !isIdentity ? width : 0);
+        int minValue = 65535;
+        int maxValue = 0;
+        for (int y = 0; y < height; y += step)
+        {
+            const unsigned char* inputRow = data + (long long)y * inputBytesPerRow;
+            const unsigned short* samples = (const unsigned short*)inputRow;
+            if (isPacked)
+            {
+                BitDepthKernel::UnpackToPixels(inputRow, rowBuffer.data(), width, layout);
+                if (!isIdentity) BitDepthKernel::Normalize(rowBuffer.data(), rowBuffer.data(), width, conversion);
+                samples = rowBuffer.data();
             }
-            else
+            else if (!isIdentity)
             {
-                // Notes: inputData default is vertical flipped. So image should be vertical flip if verticalFlip == false
+                BitDepthKernel::Normalize(samples, rowBuffer.data(), width, conversion);
+                samples = rowBuffer.data();
+            }
 
-                // Copy 3 byte per pixel from BGR to RGB format and Vertical flip
+            for (int x = 0; x < width; x += step)
+            {
+                minValue = std::min(minValue, (int)samples[x]);
+                maxValue = std::max(maxValue, (int)samples[x]);
+            }
+        }
 
-                const int numOfBytePerRow = width * 3;
-                const int frameSize = width * height * 3;
-                unsigned char* inputDataPtrTemp = inputData;    // Input start from the first row
-                unsigned char* outputDataPtrTemp = outputData + (height - 1) * numOfBytePerRow; // Output start from the last row
+        // A flat or an empty frame is mapped to a window of 1 sample
+        if (maxValue <= minValue)
+        {
+            minValue = std::min(minValue, 65534);
+            maxValue = minValue + 1;
+        }
 
-                int x = 0; // x is the current pixel in the row
-                for (int i = 0; i < frameSize; i += 3) {
+        return ToneMapKernel::BuildTable(minValue, maxValue, toneMapSettings.Gamma);
+    }
 
-                    // If x is out of bound, Output move up one row and x reset to 0
-                    if (x >= width) {
-                        x = 0;
-                        outputDataPtrTemp -= numOfBytePerRow * 2; // Now outputDataPtrTemp is at the end of the previous row, so move 2 row up
-                    }
+#pragma endregion 16bit Monochrome
 
-                    // Copy R to B
-                    *inputDataPtrTemp = *(outputDataPtrTemp + 2);
-                    inputDataPtrTemp++;
+#pragma region RGB
 
-                    // Copy G
-                    *inputDataPtrTemp = *(outputDataPtrTemp + 1);
-                    inputDataPtrTemp++;
+    std::vector<GUID> FrameDecoder::SupportRGBVideoType()
+    {
+        return getSubtypes(FrameSubtypeFamily::RGB);
+    }
 
-                    // Copy B to R
-                    *inputDataPtrTemp = *outputDataPtrTemp;
-                    inputDataPtrTemp++;
+    bool FrameDecoder::isRGBFrameType(const GUID videoType)
+    {
+        return FrameSubtypeRegistry::Find(videoType, FrameSubtypeFamily::RGB) != nullptr;
+    }
 
-                    // Move to next pixel
-                    outputDataPtrTemp += 3;
+    void FrameDecoder::CheckRGBFrameType(const GUID videoType)
+    {
+        // Check
+        FindTraits(videoType, FrameSubtypeFamily::RGB, "RGB");
+    }
 
-                    // Update x
-                    x++;
-                }
-            }
-        }
+    void FrameDecoder::DecodeRGBFrame(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const bool verticalFlip,
+        const bool outputRGB,
+        const bool horizontalMirror
+    )
+    {
+        // Check and decode
+        FindTraits(videoType, FrameSubtypeFamily::RGB, "RGB").Decode(inputData, outputData, width, height, 0, ToFrameSettings(verticalFlip, outputRGB, horizontalMirror), nullptr, nullptr);
     }
 
     std::shared_ptr<unsigned char[]> FrameDecoder::DecodeRGBFrame(
-        unsigned char* data,
+        const unsigned char* data,
         const GUID videoType,
         const int width,
         const int height,
         const bool verticalFlip,
-        const bool outputRGB
+        const bool outputRGB,
+        const bool horizontalMirror
     )
     {
         // Check
-        CheckRGBFrameType(videoType);
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::RGB, "RGB");
 
         // Initialize result buffer
-        auto result = std::make_shared<unsigned char[]>(height * width * 3);
+        auto result = std::make_shared<unsigned char[]>(height * width * traits.DecodedBytesPerPixel);
 
         // Decode
-        DecodeRGBFrame(data, result.get(), videoType, width, height, verticalFlip, outputRGB);
+        traits.Decode(data, result.get(), width, height, 0, ToFrameSettings(verticalFlip, outputRGB, horizontalMirror), nullptr, nullptr);
 
         return result;
     }
 
     void FrameDecoder::DecodeFrame(
-        unsigned char* inputData,
+        const unsigned char* inputData,
         unsigned char* outputData,
         const GUID videoType,
         const int width,
         const int height,
         const bool verticalFlip,
-        const bool outputRGB
+        const bool outputRGB,
+        const bool horizontalMirror
+    )
+    {
+        DecodeFrame(inputData, outputData, videoType, width, height, ToFrameSettings(verticalFlip, outputRGB, horizontalMirror));
+    }
+
+    void FrameDecoder::DecodeFrame(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const FrameSettings& frameSettings,
+        FrameStatistics* statistics
+    )
+    {
+        // Check
+        const auto& traits = FindTraits(videoType);
+        const auto accumulator = CreateStatisticsAccumulator(traits, frameSettings, statistics);
+
+        // Decode
+        traits.Decode(inputData, outputData, width, height, 0, frameSettings, accumulator.get(), nullptr);
+        if (statistics != nullptr) *statistics = accumulator ? StatisticsKernel::getStatistics(*accumulator) : FrameStatistics();
+    }
+
+    void FrameDecoder::DecodeFrame(
+        const unsigned char* inputData,
+        const FrameDestination& destination,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const FrameSettings& frameSettings,
+        FrameStatistics* statistics
     )
     {
         // Check
-        CheckSupportVideoType(videoType);
+        const auto& traits = FindTraits(videoType);
 
-        if (isMonochromeFrameType(videoType))
+        // The color video types are decoded in the channel order of the destination
+        FrameSettings decodeSettings = frameSettings;
+        if (destination.PixelFormat == FramePixelFormat::BGR24 || destination.PixelFormat == FramePixelFormat::RGB24)
         {
-            // Monochrome
-            DecodeMonochromeFrame(inputData, outputData, videoType, width, height, verticalFlip);
+            decodeSettings.BGR = destination.PixelFormat == FramePixelFormat::BGR24;
         }
-        else if (is16BitMonochromeFrameType(videoType))
+        if (getDecodedPixelFormat(videoType, decodeSettings) != destination.PixelFormat)
         {
-            // 16bit Monochrome
-            Decode16BitMonochromeFrame(inputData, (unsigned short*)outputData, videoType, width, height, verticalFlip);
+            throw std::invalid_argument(
+                "Pixel format(" + std::to_string((int)destination.PixelFormat) + ") of the destination is not supported by the video type(" + DirectShowVideoFormatUtils::ToString(videoType) + ")."
+            );
         }
-        else
+        int decodedWidth = 0;
+        int decodedHeight = 0;
+        getDecodedSize(width, height, decodeSettings, decodedWidth, decodedHeight);
+        unsigned char* outputData = getDestinationData(destination, decodedWidth, decodedHeight);
+        const auto accumulator = CreateStatisticsAccumulator(traits, decodeSettings, statistics);
+
+        // Decode
+        traits.Decode(inputData, outputData, width, height, destination.getBytesPerRow(), decodeSettings, accumulator.get(), nullptr);
+        if (statistics != nullptr) *statistics = accumulator ? StatisticsKernel::getStatistics(*accumulator) : FrameStatistics();
+    }
+
+    FramePixelFormat FrameDecoder::getDecodedPixelFormat(const GUID videoType, const FrameSettings& frameSettings)
+    {
+        switch (FindTraits(videoType).Family)
         {
-            // RGB
-            DecodeRGBFrame(inputData, outputData, videoType, width, height, verticalFlip, outputRGB);
+        case FrameSubtypeFamily::Monochrome8bit:
+            return FramePixelFormat::Gray8;
+        case FrameSubtypeFamily::Monochrome16bit:
+            return FramePixelFormat::Gray16;
+        default:
+            return frameSettings.BGR ? FramePixelFormat::BGR24 : FramePixelFormat::RGB24;
         }
     }
 
-#pragma endregion RGB
+    void FrameDecoder::getDecodedSize(const int width, const int height, const FrameSettings& frameSettings, int& decodedWidth, int& decodedHeight)
+    {
+        // Resize
+        if (frameSettings.ResizeWidth != 0 || frameSettings.ResizeHeight != 0)
+        {
+            if (frameSettings.ResizeWidth <= 0 || frameSettings.ResizeHeight <= 0 || frameSettings.ResizeWidth > width || frameSettings.ResizeHeight > height)
+            {
+                throw std::invalid_argument(
+                    "Resize size(" + std::to_string(frameSettings.ResizeWidth) + "x" + std::to_string(frameSettings.ResizeHeight) + ") should be > 0 and <= the frame size(" +
+                    std::to_string(width) + "x" + std::to_string(height) + ")."
+                );
+            }
+            decodedWidth = frameSettings.ResizeWidth;
+            decodedHeight = frameSettings.ResizeHeight;
+            return;
+        }
 
-#ifdef WITH_OPENCV2
+        // Binning
+        const int binning = frameSettings.Binning;
+        if (binning != 1 && binning != 2 && binning != 4) throw std::invalid_argument("Binning(" + std::to_string(binning) + ") should be 1, 2 or 4.");
+        if (width < binning || height < binning)
+        {
+            throw std::invalid_argument("Frame size(" + std::to_string(width) + "x" + std::to_string(height) + ") is smaller than the binning(" + std::to_string(binning) + ").");
+        }
+        decodedWidth = width / binning;
+        decodedHeight = height / binning;
+    }
 
-    cv::Mat FrameDecoder::DecodeFrameToCVMat(
-        unsigned char* data,
+    bool FrameDecoder::isResized(const FrameSettings& frameSettings)
+    {
+        return frameSettings.Binning != 1 || frameSettings.ResizeWidth != 0 || frameSettings.ResizeHeight != 0;
+    }
+
+    void FrameDecoder::DecodeFrameToTensor(
+        const unsigned char* inputData,
+        const TensorDestination& destination,
         const GUID videoType,
         const int width,
         const int height,
-        const bool verticalFlip,
-        const bool outputRGB
+        const FrameSettings& frameSettings
+    )
+    {
+        // Check
+        const auto& traits = FindTraits(videoType);
+        if (destination.Data == nullptr) throw std::invalid_argument("Tensor data is nullptr.");
+        int x = 0;
+        int y = 0;
+        int regionWidth = 0;
+        int regionHeight = 0;
+        getTensorRegion(width, height, destination, x, y, regionWidth, regionHeight);
+
+        // Decode in the channel order of the tensor and in the size of the region
+        FrameSettings decodeSettings = frameSettings;
+        decodeSettings.BGR = destination.BGR;
+        decodeSettings.Binning = 1;
+        decodeSettings.ResizeWidth = regionWidth == width && regionHeight == height ? 0 : regionWidth;
+        decodeSettings.ResizeHeight = regionWidth == width && regionHeight == height ? 0 : regionHeight;
+        decodeSettings.Statistics = FrameStatisticsMode::None;
+
+        // The 16bit monochrome samples are normalized by the maximum of the decoded bit depth
+        const bool is16Bit = traits.Family == FrameSubtypeFamily::Monochrome16bit;
+        const int bytesPerSample = is16Bit ? 2 : 1;
+        const auto table = TensorKernel::BuildTable(
+            traits.DecodedBytesPerPixel / bytesPerSample,
+            bytesPerSample,
+            is16Bit ? getBitDepth(videoType, decodeSettings) : 8,
+            destination.Channels,
+            destination.DataType,
+            destination.Mean,
+            destination.Std,
+            destination.PadValue
+        );
+
+        // Decode each row into the tensor while it is still in the cache
+        TensorOutput tensor;
+        tensor.Data = destination.Data;
+        tensor.Width = destination.Width;
+        tensor.Height = destination.Height;
+        tensor.X = x;
+        tensor.Y = y;
+        tensor.Table = &table;
+        traits.Decode(inputData, nullptr, width, height, 0, decodeSettings, nullptr, &tensor);
+    }
+
+    void FrameDecoder::getTensorRegion(
+        const int width,
+        const int height,
+        const TensorDestination& destination,
+        int& x,
+        int& y,
+        int& regionWidth,
+        int& regionHeight
     )
     {
         // Check
-        CheckSupportVideoType(videoType);
+        if (width <= 0 || height <= 0) throw std::invalid_argument("Frame size(" + std::to_string(width) + "x" + std::to_string(height) + ") should be > 0.");
+        if (destination.Width <= 0 || destination.Height <= 0)
+        {
+            throw std::invalid_argument("Tensor size(" + std::to_string(destination.Width) + "x" + std::to_string(destination.Height) + ") should be > 0.");
+        }
 
-        if (isMonochromeFrameType(videoType))
+        if (width <= destination.Width && height <= destination.Height)
         {
-            // Monochrome
-            return DecodeMonochromeFrameToCVMat(data, videoType, width, height, verticalFlip);
+            // Not enlarged
+            regionWidth = width;
+            regionHeight = height;
         }
-        else if (is16BitMonochromeFrameType(videoType))
+        else if (!destination.Letterbox)
         {
-            // 16bit Monochrome
-            return Decode16BitMonochromeFrameToCVMat(data, videoType, width, height, verticalFlip);
+            // Stretch each axis
+            regionWidth = std::min(width, destination.Width);
+            regionHeight = std::min(height, destination.Height);
+        }
+        else if ((long long)destination.Width * height <= (long long)destination.Height * width)
+        {
+            // Fit the width, the height is rounded
+            regionWidth = destination.Width;
+            regionHeight = std::max(1, (int)(((long long)height * destination.Width * 2 + width) / ((long long)width * 2)));
         }
         else
         {
-            // RGB
-            return DecodeRGBFrameFrameToCVMat(data, videoType, width, height, verticalFlip, outputRGB);
+            // Fit the height
+            regionWidth = std::max(1, (int)(((long long)width * destination.Height * 2 + height) / ((long long)height * 2)));
+            regionHeight = destination.Height;
         }
+
+        x = (destination.Width - regionWidth) / 2;
+        y = (destination.Height - regionHeight) / 2;
     }
 
-    cv::Mat FrameDecoder::DecodeMonochromeFrameToCVMat(
-        unsigned char* data,
+#pragma endregion RGB
+
+#pragma region YUV
+
+    std::vector<GUID> FrameDecoder::SupportYUVVideoType()
+    {
+        std::vector<GUID> result = getSubtypes(FrameSubtypeFamily::YUV422);
+        const auto yuv420Subtypes = getSubtypes(FrameSubtypeFamily::YUV420);
+        result.insert(result.end(), yuv420Subtypes.begin(), yuv420Subtypes.end());
+        return result;
+    }
+
+    bool FrameDecoder::isYUVFrameType(const GUID videoType)
+    {
+        const auto family = FrameSubtypeRegistry::getFamily(videoType);
+        return family == FrameSubtypeFamily::YUV422 || family == FrameSubtypeFamily::YUV420;
+    }
+
+    void FrameDecoder::CheckYUVFrameType(const GUID videoType)
+    {
+        if (!isYUVFrameType(videoType))
+        {
+            throw std::invalid_argument("Video type(" + DirectShowVideoFormatUtils::ToString(videoType) + ") is not a YUV type.");
+        }
+    }
+
+    void FrameDecoder::DecodeYUVFrame(
+        const unsigned char* inputData,
+        unsigned char* outputData,
         const GUID videoType,
         const int width,
         const int height,
-        const bool verticalFlip
+        const YUVOutputFormat outputFormat,
+        const YUVColorSpace colorSpace,
+        const bool verticalFlip,
+        const bool horizontalMirror
     )
     {
         // Check
-        CheckMonochromeFrameType(videoType);
-
-        // Initialize buffer
-        auto result = cv::Mat(height, width, CV_8UC1);
+        CheckYUVFrameType(videoType);
 
         // Decode
-        DecodeMonochromeFrame(data, result.ptr(), videoType, width, height, verticalFlip);
-
-        return result;
+        DecodeYUV(inputData, outputData, videoType, width, height, outputFormat, colorSpace, verticalFlip, horizontalMirror);
     }
 
-    cv::Mat FrameDecoder::Decode16BitMonochromeFrameToCVMat(
-        unsigned char* data,
+    std::shared_ptr<unsigned char[]> FrameDecoder::DecodeYUVFrame(
+        const unsigned char* data,
         const GUID videoType,
         const int width,
         const int height,
-        const bool verticalFlip
+        const YUVOutputFormat outputFormat,
+        const YUVColorSpace colorSpace,
+        const bool verticalFlip,
+        const bool horizontalMirror
     )
     {
         // Check
-        Check16BitMonochromeFrameType(videoType);
+        CheckYUVFrameType(videoType);
 
-        // Initialize buffer
-        auto result = cv::Mat(height, width, CV_16UC1);
+        // Initialize result buffer
+        auto result = std::make_shared<unsigned char[]>(height * width * YUVKernel::getBytesPerPixel(outputFormat));
 
         // Decode
-        Decode16BitMonochromeFrame(data, (unsigned short*)result.ptr(), videoType, width, height, verticalFlip);
+        DecodeYUV(data, result.get(), videoType, width, height, outputFormat, colorSpace, verticalFlip, horizontalMirror);
+
+        return result;
+    }
+
+    YUV420Planes FrameDecoder::getYUV420Planes(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height
+    )
+    {
+        // Check
+        FindTraits(videoType, FrameSubtypeFamily::YUV420, "YUV 4:2:0");
+        if (width % 2 != 0 || height % 2 != 0)
+        {
+            throw std::invalid_argument("Size(" + std::to_string(width) + "x" + std::to_string(height) + ") of a YUV 4:2:0 frame must be even.");
+        }
+
+        // The chroma planes follow the Y plane. The NV12 U V plane has the same stride as the Y plane, the I420 U and V planes have half.
+        YUV420Planes planes;
+        planes.Layout = getYUV420Layout(videoType);
+        planes.Y = data;
+        planes.YStride = width;
+        planes.U = data + (long long)width * height;
+        if (planes.Layout == YUV420Layout::NV12)
+        {
+            planes.UVStride = width;
+        }
+        else
+        {
+            planes.UVStride = width / 2;
+            planes.V = planes.U + (long long)(width / 2) * (height / 2);
+        }
+
+        return planes;
+    }
+
+    void FrameDecoder::DecodeYUV420Frame(
+        const YUV420Planes& planes,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const YUVColorSpace colorSpace,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        DecodeYUV420(planes, outputData, width, height, outputFormat, colorSpace, verticalFlip, horizontalMirror);
+    }
+
+    std::shared_ptr<unsigned char[]> FrameDecoder::DecodeYUV420Frame(
+        const YUV420Planes& planes,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const YUVColorSpace colorSpace,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        // Initialize result buffer
+        auto result = std::make_shared<unsigned char[]>(height * width * YUVKernel::getBytesPerPixel(outputFormat));
+
+        // Decode
+        DecodeYUV420(planes, result.get(), width, height, outputFormat, colorSpace, verticalFlip, horizontalMirror);
+
+        return result;
+    }
+
+#pragma endregion YUV
+
+#pragma region Luma
+
+    std::vector<GUID> FrameDecoder::SupportLumaVideoType()
+    {
+        return SupportYUVVideoType();
+    }
+
+    bool FrameDecoder::isLumaFrameType(const GUID videoType)
+    {
+        return isYUVFrameType(videoType);
+    }
+
+    void FrameDecoder::CheckLumaFrameType(const GUID videoType)
+    {
+        if (!isLumaFrameType(videoType))
+        {
+            throw std::invalid_argument("Video type(" + DirectShowVideoFormatUtils::ToString(videoType) + ") is not a YUV type.");
+        }
+    }
+
+    void FrameDecoder::DecodeLumaFrame(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        // Check and decode
+        CheckLumaFrameType(videoType);
+        DecodeLuma(inputData, outputData, videoType, width, height, verticalFlip, horizontalMirror);
+    }
+
+    std::shared_ptr<unsigned char[]> FrameDecoder::DecodeLumaFrame(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        // Check
+        CheckLumaFrameType(videoType);
+
+        // Initialize result buffer
+        auto result = std::make_shared<unsigned char[]>(height * width);
+
+        // Decode
+        DecodeLuma(data, result.get(), videoType, width, height, verticalFlip, horizontalMirror);
+
+        return result;
+    }
+
+#pragma endregion Luma
+
+#pragma region MJPEG
+
+    std::vector<GUID> FrameDecoder::SupportMJPGVideoType()
+    {
+        return getSubtypes(FrameSubtypeFamily::MJPEG);
+    }
+
+    bool FrameDecoder::isMJPGFrameType(const GUID videoType)
+    {
+        return FrameSubtypeRegistry::Find(videoType, FrameSubtypeFamily::MJPEG) != nullptr;
+    }
+
+    void FrameDecoder::CheckMJPGFrameType(const GUID videoType)
+    {
+        // Check
+        FindTraits(videoType, FrameSubtypeFamily::MJPEG, "MJPEG");
+    }
+
+    void FrameDecoder::DecodeMJPGFrame(
+        const unsigned char* inputData,
+        const int numOfInputBytes,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const JPEGScale scale,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        DecodeMJPG(inputData, numOfInputBytes, outputData, width, height, outputFormat, scale, verticalFlip, horizontalMirror);
+    }
+
+    std::shared_ptr<unsigned char[]> FrameDecoder::DecodeMJPGFrame(
+        const unsigned char* data,
+        const int numOfBytes,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const JPEGScale scale,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        // Initialize result buffer
+        const int outputSize = JPEGDecoder::getScaledSize(width, scale) * JPEGDecoder::getScaledSize(height, scale) * YUVKernel::getBytesPerPixel(outputFormat);
+        auto result = std::make_shared<unsigned char[]>(outputSize);
+
+        // Decode
+        DecodeMJPG(data, numOfBytes, result.get(), width, height, outputFormat, scale, verticalFlip, horizontalMirror);
+
+        return result;
+    }
+
+#pragma endregion MJPEG
+
+#pragma region Bayer
+
+    std::vector<GUID> FrameDecoder::SupportBayerVideoType()
+    {
+        return getSubtypes(FrameSubtypeFamily::Bayer);
+    }
+
+    bool FrameDecoder::isBayerFrameType(const GUID videoType)
+    {
+        return FrameSubtypeRegistry::Find(videoType, FrameSubtypeFamily::Bayer) != nullptr;
+    }
+
+    void FrameDecoder::CheckBayerFrameType(const GUID videoType)
+    {
+        // Check
+        FindTraits(videoType, FrameSubtypeFamily::Bayer, "Bayer");
+    }
+
+    void FrameDecoder::DecodeBayerFrame(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const FrameSettings& frameSettings
+    )
+    {
+        // Check and decode
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::Bayer, "Bayer");
+        DecodeBayer(inputData, outputData, getBayerPattern(videoType), traits.BitsPerPixel, width, height, outputFormat, frameSettings);
+    }
+
+    std::shared_ptr<unsigned char[]> FrameDecoder::DecodeBayerFrame(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const FrameSettings& frameSettings
+    )
+    {
+        // Check
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::Bayer, "Bayer");
+
+        // Initialize result buffer
+        int decodedWidth = 0;
+        int decodedHeight = 0;
+        getDecodedSize(width, height, frameSettings, decodedWidth, decodedHeight);
+        auto result = std::make_shared<unsigned char[]>(decodedWidth * decodedHeight * YUVKernel::getBytesPerPixel(outputFormat));
+
+        // Decode
+        DecodeBayer(data, result.get(), getBayerPattern(videoType), traits.BitsPerPixel, width, height, outputFormat, frameSettings);
+
+        return result;
+    }
+
+    void FrameDecoder::DecodeBayerFrameHalfSize(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const FrameSettings& frameSettings
+    )
+    {
+        // Check and decode
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::Bayer, "Bayer");
+        DecodeBayerHalfSize(inputData, outputData, getBayerPattern(videoType), traits.BitsPerPixel, width, height, outputFormat, frameSettings);
+    }
+
+    std::shared_ptr<unsigned char[]> FrameDecoder::DecodeBayerFrameHalfSize(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const FrameSettings& frameSettings
+    )
+    {
+        // Check
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::Bayer, "Bayer");
+
+        // Initialize result buffer
+        auto result = std::make_shared<unsigned char[]>((width / 2) * (height / 2) * YUVKernel::getBytesPerPixel(outputFormat));
+
+        // Decode
+        DecodeBayerHalfSize(data, result.get(), getBayerPattern(videoType), traits.BitsPerPixel, width, height, outputFormat, frameSettings);
+
+        return result;
+    }
+
+#pragma endregion Bayer
+
+#ifdef WITH_OPENCV2
+
+    cv::Mat FrameDecoder::DecodeFrameToCVMat(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const bool verticalFlip,
+        const bool outputRGB,
+        const bool horizontalMirror
+    )
+    {
+        return DecodeFrameToCVMat(data, videoType, width, height, ToFrameSettings(verticalFlip, outputRGB, horizontalMirror));
+    }
+
+    cv::Mat FrameDecoder::DecodeFrameToCVMat(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const FrameSettings& frameSettings
+    )
+    {
+        cv::Mat result;
+        DecodeFrameToCVMat(data, videoType, width, height, result, frameSettings);
+        return result;
+    }
+
+    void FrameDecoder::DecodeFrameToCVMat(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        cv::Mat& result,
+        const FrameSettings& frameSettings,
+        FrameStatistics* statistics
+    )
+    {
+        // Check
+        const auto pixelFormat = getDecodedPixelFormat(videoType, frameSettings);
+
+        // Reuse the buffer if it is in the decoded size and type
+        int cvType = CV_8UC3;
+        switch (pixelFormat)
+        {
+        case FramePixelFormat::Gray8:
+            cvType = CV_8UC1;
+            break;
+        case FramePixelFormat::Gray16:
+            cvType = CV_16UC1;
+            break;
+        default:
+            cvType = CV_8UC3;
+            break;
+        }
+        int decodedWidth = 0;
+        int decodedHeight = 0;
+        getDecodedSize(width, height, frameSettings, decodedWidth, decodedHeight);
+        result.create(decodedHeight, decodedWidth, cvType);
+
+        // Decode in the row stride of the cv::Mat
+        FrameDestination destination;
+        destination.Data = result.data;
+        destination.Width = result.cols;
+        destination.Height = result.rows;
+        destination.BytesPerRow = (int)result.step;
+        destination.PixelFormat = pixelFormat;
+        DecodeFrame(data, destination, videoType, width, height, frameSettings, statistics);
+    }
+
+    cv::Mat FrameDecoder::DecodeMonochromeFrameToCVMat(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        // Check
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::Monochrome8bit, "Monochrome");
+
+        // Initialize buffer
+        auto result = cv::Mat(height, width, CV_8UC1);
+
+        // Decode
+        traits.Decode(data, result.ptr(), width, height, 0, ToFrameSettings(verticalFlip, false, horizontalMirror), nullptr, nullptr);
+
+        return result;
+    }
+
+    cv::Mat FrameDecoder::Decode16BitMonochromeFrameToCVMat(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        // Check
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::Monochrome16bit, "16Bit Monochrome");
+
+        // Initialize buffer
+        auto result = cv::Mat(height, width, CV_16UC1);
+
+        // Decode
+        traits.Decode(data, result.ptr(), width, height, 0, ToFrameSettings(verticalFlip, false, horizontalMirror), nullptr, nullptr);
+
+        return result;
+    }
+
+    cv::Mat FrameDecoder::Decode16BitMonochromeFrameTo8BitCVMat(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const ToneMapSettings& toneMapSettings,
+        const FrameSettings& frameSettings
+    )
+    {
+        // Check
+        Check16BitMonochromeFrameType(videoType);
+
+        // Initialize buffer
+        int decodedWidth = 0;
+        int decodedHeight = 0;
+        getDecodedSize(width, height, frameSettings, decodedWidth, decodedHeight);
+        auto result = cv::Mat(decodedHeight, decodedWidth, CV_8UC1);
+
+        // Decode
+        Decode16BitMonochromeTo8Bit(data, result.ptr(), videoType, width, height, toneMapSettings, frameSettings);
 
         return result;
     }
 
     cv::Mat FrameDecoder::DecodeRGBFrameFrameToCVMat(
-        unsigned char* data,
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const bool verticalFlip,
+        const bool outputRGB,
+        const bool horizontalMirror
+    )
+    {
+        // Check
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::RGB, "RGB");
+
+        // Initialize result buffer
+        auto result = cv::Mat(height, width, CV_8UC3);
+
+        // Decode
+        traits.Decode(data, result.ptr(), width, height, 0, ToFrameSettings(verticalFlip, outputRGB, horizontalMirror), nullptr, nullptr);
+
+        return result;
+    }
+
+    cv::Mat FrameDecoder::DecodeYUVFrameToCVMat(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const YUVColorSpace colorSpace,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        // Check
+        CheckYUVFrameType(videoType);
+
+        // Initialize result buffer
+        auto result = cv::Mat(height, width, CV_8UC(YUVKernel::getBytesPerPixel(outputFormat)));
+
+        // Decode
+        DecodeYUV(data, result.ptr(), videoType, width, height, outputFormat, colorSpace, verticalFlip, horizontalMirror);
+
+        return result;
+    }
+
+    cv::Mat FrameDecoder::DecodeLumaFrameToCVMat(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        // Check
+        CheckLumaFrameType(videoType);
+
+        // Initialize result buffer
+        auto result = cv::Mat(height, width, CV_8UC1);
+
+        // Decode
+        DecodeLuma(data, result.ptr(), videoType, width, height, verticalFlip, horizontalMirror);
+
+        return result;
+    }
+
+    cv::Mat FrameDecoder::DecodeMJPGFrameToCVMat(
+        const unsigned char* data,
+        const int numOfBytes,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const JPEGScale scale,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        // Initialize result buffer
+        auto result = cv::Mat(JPEGDecoder::getScaledSize(height, scale), JPEGDecoder::getScaledSize(width, scale), CV_8UC(YUVKernel::getBytesPerPixel(outputFormat)));
+
+        // Decode
+        DecodeMJPG(data, numOfBytes, result.ptr(), width, height, outputFormat, scale, verticalFlip, horizontalMirror);
+
+        return result;
+    }
+
+    cv::Mat FrameDecoder::DecodeBayerFrameToCVMat(
+        const unsigned char* data,
         const GUID videoType,
         const int width,
         const int height,
-        const bool verticalFlip,
-        const bool outputRGB
+        const YUVOutputFormat outputFormat,
+        const FrameSettings& frameSettings
     )
     {
         // Check
-        CheckRGBFrameType(videoType);
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::Bayer, "Bayer");
 
         // Initialize result buffer
-        auto result = cv::Mat(height, width, CV_8UC3);
+        int decodedWidth = 0;
+        int decodedHeight = 0;
+        getDecodedSize(width, height, frameSettings, decodedWidth, decodedHeight);
+        auto result = cv::Mat(decodedHeight, decodedWidth, CV_8UC(YUVKernel::getBytesPerPixel(outputFormat)));
+
+        // Decode
+        DecodeBayer(data, result.ptr(), getBayerPattern(videoType), traits.BitsPerPixel, width, height, outputFormat, frameSettings);
+
+        return result;
+    }
+
+    cv::Mat FrameDecoder::DecodeBayerFrameHalfSizeToCVMat(
+        const unsigned char* data,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const FrameSettings& frameSettings
+    )
+    {
+        // Check
+        const auto& traits = FindTraits(videoType, FrameSubtypeFamily::Bayer, "Bayer");
+
+        // Initialize result buffer
+        auto result = cv::Mat(height / 2, width / 2, CV_8UC(YUVKernel::getBytesPerPixel(outputFormat)));
 
         // Decode
-        DecodeRGBFrame(data, result.ptr(), videoType, width, height, verticalFlip, outputRGB);
+        DecodeBayerHalfSize(data, result.ptr(), getBayerPattern(videoType), traits.BitsPerPixel, width, height, outputFormat, frameSettings);
 
         return result;
     }
 
 #endif // def WITH_OPENCV2
 
-    void FrameDecoder::CloneRawData(
-        unsigned char* inputData,
+#pragma region Parallel Decode
+
+    void FrameDecoder::setNumOfDecodeThreads(const int numOfThreads)
+    {
+        // Check
+        if (numOfThreads < 0) throw std::invalid_argument("Number of threads(" + std::to_string(numOfThreads) + ") can't be < 0.");
+
+        const int numOfDecodeThreads = numOfThreads == 0 ? (int)std::max(1u, std::thread::hardware_concurrency()) : numOfThreads;
+
+        std::lock_guard<std::mutex> lock(g_decodeThreadPoolMutex);
+        if (numOfDecodeThreads == g_numOfDecodeThreads) return;
+
+        // The old pool is released when the running decodes finish
+        g_decodeThreadPool = numOfDecodeThreads > 1 ? std::make_shared<Utils::ThreadPool>(numOfDecodeThreads - 1) : nullptr;
+        g_numOfDecodeThreads = numOfDecodeThreads;
+    }
+
+    int FrameDecoder::getNumOfDecodeThreads()
+    {
+        return g_numOfDecodeThreads;
+    }
+
+    void FrameDecoder::setParallelDecodeMinFrameSize(const int numOfPixels)
+    {
+        // Check
+        if (numOfPixels < 0) throw std::invalid_argument("Minimum frame size(" + std::to_string(numOfPixels) + ") can't be < 0.");
+
+        g_parallelDecodeMinFrameSize = numOfPixels;
+    }
+
+    int FrameDecoder::getParallelDecodeMinFrameSize()
+    {
+        return g_parallelDecodeMinFrameSize;
+    }
+
+    bool FrameDecoder::isParallelDecode(const int width, const int height)
+    {
+        return g_numOfDecodeThreads > 1 && (long long)width * (long long)height >= g_parallelDecodeMinFrameSize;
+    }
+
+    std::shared_ptr<Utils::ThreadPool> FrameDecoder::getDecodeThreadPool(const int width, const int height)
+    {
+        if (!isParallelDecode(width, height)) return nullptr;
+
+        std::lock_guard<std::mutex> lock(g_decodeThreadPoolMutex);
+        return g_decodeThreadPool;
+    }
+
+#pragma endregion Parallel Decode
+
+#pragma region Decode Kernel
+
+    void FrameDecoder::DecodeMonochromeKernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        // Copy 1 byte per pixel
+        const auto resizeTable = getResizeTable(width, height, 1, 1, frameSettings);
+        const auto threadPool = getDecodeThreadPool(width, height);
+        RowKernel::Run(
+            inputData,
+            outputData,
+            width,
+            height,
+            width,
+            getOutputBytesPerRow(outputBytesPerRow, width, 1, resizeTable.get()),
+            frameSettings.VerticalFlip,
+            RowKernel::getCopyKernel(1, frameSettings.HorizontalMirror),
+            threadPool.get(),
+            resizeTable.get(),
+            statistics,
+            tensor
+        );
+    }
+
+    void FrameDecoder::Decode16BitMonochromeKernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        Decode16BitMonochrome(inputData, outputData, MEDIASUBTYPE_Y16, width, height, frameSettings, outputBytesPerRow, statistics, tensor);
+    }
+
+    void FrameDecoder::DecodeY10Kernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        Decode16BitMonochrome(inputData, outputData, MEDIASUBTYPE_Y10, width, height, frameSettings, outputBytesPerRow, statistics, tensor);
+    }
+
+    void FrameDecoder::DecodeY12Kernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        Decode16BitMonochrome(inputData, outputData, MEDIASUBTYPE_Y12, width, height, frameSettings, outputBytesPerRow, statistics, tensor);
+    }
+
+    void FrameDecoder::DecodeY10PKernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        Decode16BitMonochrome(inputData, outputData, MEDIASUBTYPE_Y10P, width, height, frameSettings, outputBytesPerRow, statistics, tensor);
+    }
+
+    void FrameDecoder::DecodeY12PKernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        Decode16BitMonochrome(inputData, outputData, MEDIASUBTYPE_Y12P, width, height, frameSettings, outputBytesPerRow, statistics, tensor);
+    }
+
+    void FrameDecoder::DecodeBGR24Kernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        // Copy 3 byte per pixel in BGR format or convert to RGB
+        const auto kernel = frameSettings.BGR ? RowKernel::getCopyKernel(3, frameSettings.HorizontalMirror) : RowKernel::getSwapRedBlue24Kernel(frameSettings.HorizontalMirror);
+        const auto resizeTable = getResizeTable(width, height, 3, 1, frameSettings);
+        const auto threadPool = getDecodeThreadPool(width, height);
+        RowKernel::Run(inputData, outputData, width, height, width * 3, getOutputBytesPerRow(outputBytesPerRow, width, 3, resizeTable.get()), frameSettings.VerticalFlip, kernel, threadPool.get(), resizeTable.get(), statistics, tensor);
+    }
+
+    void FrameDecoder::DecodeRGB565Kernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        // Expand 2 byte per pixel to 3 byte per pixel
+        const auto kernel = RowKernel::getRGB16Kernel(RGB16Layout::RGB565, frameSettings.BGR ? YUVOutputFormat::BGR24 : YUVOutputFormat::RGB24, frameSettings.HorizontalMirror);
+        const auto resizeTable = getResizeTable(width, height, 3, 1, frameSettings);
+        const auto threadPool = getDecodeThreadPool(width, height);
+        RowKernel::Run(inputData, outputData, width, height, width * 2, getOutputBytesPerRow(outputBytesPerRow, width, 3, resizeTable.get()), frameSettings.VerticalFlip, kernel, threadPool.get(), resizeTable.get(), statistics, tensor);
+    }
+
+    void FrameDecoder::DecodeRGB555Kernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        // Expand 2 byte per pixel to 3 byte per pixel
+        const auto kernel = RowKernel::getRGB16Kernel(RGB16Layout::RGB555, frameSettings.BGR ? YUVOutputFormat::BGR24 : YUVOutputFormat::RGB24, frameSettings.HorizontalMirror);
+        const auto resizeTable = getResizeTable(width, height, 3, 1, frameSettings);
+        const auto threadPool = getDecodeThreadPool(width, height);
+        RowKernel::Run(inputData, outputData, width, height, width * 2, getOutputBytesPerRow(outputBytesPerRow, width, 3, resizeTable.get()), frameSettings.VerticalFlip, kernel, threadPool.get(), resizeTable.get(), statistics, tensor);
+    }
+
+    void FrameDecoder::DecodeRGB8Kernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        // Build the lookup table once and share it by the rows
+        const auto table = RGBKernel::BuildPaletteTable(frameSettings.Palette.get(), frameSettings.BGR ? YUVOutputFormat::BGR24 : YUVOutputFormat::RGB24);
+        const auto resizeTable = getResizeTable(width, height, 3, 1, frameSettings);
+        const auto threadPool = getDecodeThreadPool(width, height);
+        RowKernel::Run(
+            inputData,
+            outputData,
+            width,
+            height,
+            width,
+            getOutputBytesPerRow(outputBytesPerRow, width, 3, resizeTable.get()),
+            frameSettings.VerticalFlip,
+            RowKernel::getPaletteKernel(frameSettings.HorizontalMirror),
+            &table,
+            threadPool.get(),
+            resizeTable.get(),
+            statistics,
+            tensor
+        );
+    }
+
+    void FrameDecoder::DecodeYUY2Kernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        DecodeYUV422(
+            inputData,
+            outputData,
+            width,
+            height,
+            YUV422Layout::YUYV,
+            frameSettings.BGR ? YUVOutputFormat::BGR24 : YUVOutputFormat::RGB24,
+            frameSettings.ColorSpace,
+            frameSettings.VerticalFlip,
+            frameSettings.HorizontalMirror,
+            getResizeTable(width, height, 3, 1, frameSettings).get(),
+            outputBytesPerRow,
+            statistics,
+            tensor
+        );
+    }
+
+    void FrameDecoder::DecodeUYVYKernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        DecodeYUV422(
+            inputData,
+            outputData,
+            width,
+            height,
+            YUV422Layout::UYVY,
+            frameSettings.BGR ? YUVOutputFormat::BGR24 : YUVOutputFormat::RGB24,
+            frameSettings.ColorSpace,
+            frameSettings.VerticalFlip,
+            frameSettings.HorizontalMirror,
+            getResizeTable(width, height, 3, 1, frameSettings).get(),
+            outputBytesPerRow,
+            statistics,
+            tensor
+        );
+    }
+
+    void FrameDecoder::DecodeNV12Kernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        DecodeYUV420(
+            getYUV420Planes(inputData, MEDIASUBTYPE_NV12, width, height),
+            outputData,
+            width,
+            height,
+            frameSettings.BGR ? YUVOutputFormat::BGR24 : YUVOutputFormat::RGB24,
+            frameSettings.ColorSpace,
+            frameSettings.VerticalFlip,
+            frameSettings.HorizontalMirror,
+            getResizeTable(width, height, 3, 1, frameSettings).get(),
+            outputBytesPerRow,
+            statistics,
+            tensor
+        );
+    }
+
+    void FrameDecoder::DecodeI420Kernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        DecodeYUV420(
+            getYUV420Planes(inputData, MEDIASUBTYPE_I420, width, height),
+            outputData,
+            width,
+            height,
+            frameSettings.BGR ? YUVOutputFormat::BGR24 : YUVOutputFormat::RGB24,
+            frameSettings.ColorSpace,
+            frameSettings.VerticalFlip,
+            frameSettings.HorizontalMirror,
+            getResizeTable(width, height, 3, 1, frameSettings).get(),
+            outputBytesPerRow,
+            statistics,
+            tensor
+        );
+    }
+
+    void FrameDecoder::Decode16BitMonochrome(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const FrameSettings& frameSettings,
+        const int outputBytesPerRow,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        const auto conversion = getBitDepthConversion(videoType, frameSettings);
+        const auto resizeTable = getResizeTable(width, height, 1, 2, frameSettings);
+        const int bytesPerRow = getOutputBytesPerRow(outputBytesPerRow, width, 2, resizeTable.get());
+        const auto threadPool = getDecodeThreadPool(width, height);
+        if (isPackedMonochrome(videoType))
+        {
+            // Unpack, the rows are packed without padding
+            const auto layout = getPackedMonochromeLayout(videoType, width);
+            const int inputBytesPerRow = width * BitDepthKernel::getBitDepth(layout) / 8;
+            RowKernel::Run(inputData, outputData, width, height, inputBytesPerRow, bytesPerRow, frameSettings.VerticalFlip, RowKernel::getPackedMonochromeKernel(layout, frameSettings.HorizontalMirror), &conversion, threadPool.get(), resizeTable.get(), statistics, tensor);
+        }
+        else if (BitDepthKernel::isIdentity(conversion))
+        {
+            // Copy 2 byte per pixel
+            RowKernel::Run(inputData, outputData, width, height, width * 2, bytesPerRow, frameSettings.VerticalFlip, RowKernel::getCopyKernel(2, frameSettings.HorizontalMirror), threadPool.get(), resizeTable.get(), statistics, tensor);
+        }
+        else
+        {
+            // Shift and scale 2 byte per pixel
+            RowKernel::Run(inputData, outputData, width, height, width * 2, bytesPerRow, frameSettings.VerticalFlip, RowKernel::getNormalizeKernel(frameSettings.HorizontalMirror), &conversion, threadPool.get(), resizeTable.get(), statistics, tensor);
+        }
+    }
+
+    void FrameDecoder::Decode16BitMonochromeTo8Bit(
+        const unsigned char* inputData,
         unsigned char* outputData,
+        const GUID videoType,
         const int width,
         const int height,
-        const int bytesPerPixel,
-        const bool verticalFlip
+        const ToneMapSettings& toneMapSettings,
+        const FrameSettings& frameSettings,
+        const int outputBytesPerRow
     )
     {
-        // Notes: inputData default is vertical flipped. So do nothing if verticalFlip == true
+        ToneMapRowContext context;
+        context.Conversion = getBitDepthConversion(videoType, frameSettings);
+        context.Table = getToneMapTable(inputData, videoType, width, height, toneMapSettings, frameSettings);
+
+        const auto resizeTable = getResizeTable(width, height, 1, 1, frameSettings);
+        const int bytesPerRow = getOutputBytesPerRow(outputBytesPerRow, width, 1, resizeTable.get());
+        const auto threadPool = getDecodeThreadPool(width, height);
+        if (isPackedMonochrome(videoType))
+        {
+            // Unpack, the rows are packed without padding
+            const auto layout = getPackedMonochromeLayout(videoType, width);
+            const int inputBytesPerRow = width * BitDepthKernel::getBitDepth(layout) / 8;
+            RowKernel::Run(inputData, outputData, width, height, inputBytesPerRow, bytesPerRow, frameSettings.VerticalFlip, RowKernel::getPackedToneMapKernel(layout, frameSettings.HorizontalMirror), &context, threadPool.get(), resizeTable.get());
+        }
+        else
+        {
+            RowKernel::Run(inputData, outputData, width, height, width * 2, bytesPerRow, frameSettings.VerticalFlip, RowKernel::getToneMapKernel(frameSettings.HorizontalMirror), &context, threadPool.get(), resizeTable.get());
+        }
+    }
 
-        if (verticalFlip)
+    void FrameDecoder::DecodeYUV(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const YUVColorSpace colorSpace,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        if (FrameSubtypeRegistry::getFamily(videoType) == FrameSubtypeFamily::YUV420)
         {
-            // Return image in Vertical flip
-            memcpy(outputData, inputData, (long)height * (long)width * (long)bytesPerPixel);
+            DecodeYUV420(getYUV420Planes(inputData, videoType, width, height), outputData, width, height, outputFormat, colorSpace, verticalFlip, horizontalMirror);
         }
         else
         {
-            // Return image in non-Vertical flip
-            int numOfBytePerRow = width * bytesPerPixel;
-            for (int y = 0; y < height; y++) {
-                memcpy(outputData + (numOfBytePerRow * (long)y), inputData + (numOfBytePerRow * (long)(height - y - 1)), numOfBytePerRow);
+            DecodeYUV422(inputData, outputData, width, height, getYUV422Layout(videoType), outputFormat, colorSpace, verticalFlip, horizontalMirror);
+        }
+    }
+
+    void FrameDecoder::DecodeYUV420(
+        const YUV420Planes& planes,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const YUVColorSpace colorSpace,
+        const bool verticalFlip,
+        const bool horizontalMirror,
+        const ResizeTable* resizeTable,
+        const int outputBytesPerRow,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        // Check
+        if (planes.Y == nullptr || planes.U == nullptr || (planes.Layout == YUV420Layout::I420 && planes.V == nullptr))
+        {
+            throw std::invalid_argument("YUV 4:2:0 planes are missing.");
+        }
+        if (planes.YStride < width || planes.UVStride < (planes.Layout == YUV420Layout::NV12 ? (width + 1) / 2 * 2 : (width + 1) / 2))
+        {
+            throw std::invalid_argument("Stride(" + std::to_string(planes.YStride) + ", " + std::to_string(planes.UVStride) + ") of the YUV 4:2:0 planes is smaller than the width(" + std::to_string(width) + ").");
+        }
+
+        // The planes are stored from the top, RunYUV420() flips them if verticalFlip is true
+        const auto kernel = RowKernel::getYUV420Kernel(planes.Layout, colorSpace, outputFormat, horizontalMirror);
+        const auto threadPool = getDecodeThreadPool(width, height);
+        RowKernel::RunYUV420(planes, outputData, width, height, getOutputBytesPerRow(outputBytesPerRow, width, YUVKernel::getBytesPerPixel(outputFormat), resizeTable), verticalFlip, kernel, threadPool.get(), resizeTable, statistics, tensor);
+    }
+
+    void FrameDecoder::DecodeYUV422(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const YUV422Layout layout,
+        const YUVOutputFormat outputFormat,
+        const YUVColorSpace colorSpace,
+        const bool verticalFlip,
+        const bool horizontalMirror,
+        const ResizeTable* resizeTable,
+        const int outputBytesPerRow,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        // Check
+        if (width % 2 != 0) throw std::invalid_argument("Width(" + std::to_string(width) + ") of a YUV 4:2:2 frame must be even.");
+
+        // Unlike RGB, YUV rows are stored from the top, so the row order is reversed to the RGB frames
+        const auto kernel = RowKernel::getYUV422Kernel(layout, colorSpace, outputFormat, horizontalMirror);
+        const auto threadPool = getDecodeThreadPool(width, height);
+        RowKernel::Run(
+            inputData,
+            outputData,
+            width,
+            height,
+            width * 2,
+            getOutputBytesPerRow(outputBytesPerRow, width, YUVKernel::getBytesPerPixel(outputFormat), resizeTable),
+            !verticalFlip,
+            kernel,
+            threadPool.get(),
+            resizeTable,
+            statistics,
+            tensor
+        );
+    }
+
+    void FrameDecoder::DecodeMJPGKernel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        // The payload ends at the EOI marker in a buffer of 24 bits per pixel
+        const auto outputFormat = frameSettings.BGR ? YUVOutputFormat::BGR24 : YUVOutputFormat::RGB24;
+        const auto resizeTable = getResizeTable(width, height, 3, 1, frameSettings);
+        const auto threadPool = getDecodeThreadPool(width, height);
+        if (resizeTable || tensor != nullptr)
+        {
+            // The JPEG decoder writes the frame by MCU rows, so the frame is decoded in full size, then resized or converted into the tensor
+            const auto decodedData = AcquireScratchBuffer(width * height * 3);
+            DecodeMJPG(inputData, width * height * 3, decodedData.get(), width, height, outputFormat, JPEGScale::Full, frameSettings.VerticalFlip, frameSettings.HorizontalMirror);
+            if (resizeTable)
+            {
+                ResizeDecodedFrame(decodedData.get(), outputData, outputBytesPerRow, width, height, 3, *resizeTable, threadPool.get(), statistics, tensor);
+            }
+            else
+            {
+                RowKernel::RunTensor(decodedData.get(), width, height, width * 3, *tensor, threadPool.get());
             }
         }
+        else
+        {
+            DecodeMJPG(inputData, width * height * 3, outputData, width, height, outputFormat, JPEGScale::Full, frameSettings.VerticalFlip, frameSettings.HorizontalMirror, outputBytesPerRow);
+
+            // The MCU rows are written out of order, so the statistics are accumulated after the frame is decoded
+            if (statistics != nullptr) RowKernel::RunStatistics(outputData, width, height, getOutputBytesPerRow(outputBytesPerRow, width, 3, nullptr), *statistics, threadPool.get());
+        }
+    }
+
+    void FrameDecoder::DecodeMJPG(
+        const unsigned char* inputData,
+        const int numOfInputBytes,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const JPEGScale scale,
+        const bool verticalFlip,
+        const bool horizontalMirror,
+        const int outputBytesPerRow
+    )
+    {
+        // Check
+        int jpegWidth = 0;
+        int jpegHeight = 0;
+        if (!JPEGDecoder::ReadSize(inputData, numOfInputBytes, jpegWidth, jpegHeight))
+        {
+            throw std::invalid_argument("JPEG frame header is not found.");
+        }
+        if (jpegWidth != width || jpegHeight != height)
+        {
+            throw std::invalid_argument("JPEG size(" + std::to_string(jpegWidth) + "x" + std::to_string(jpegHeight) + ") is not equal to the frame size(" + std::to_string(width) + "x" + std::to_string(height) + ").");
+        }
+
+        // Unlike RGB, JPEG rows are stored from the top
+        const auto threadPool = getDecodeThreadPool(width, height);
+        JPEGDecoder::Decode(inputData, numOfInputBytes, outputData, outputFormat, scale, verticalFlip, horizontalMirror, threadPool.get(), outputBytesPerRow);
+    }
+
+    void FrameDecoder::DecodeLuma(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const GUID videoType,
+        const int width,
+        const int height,
+        const bool verticalFlip,
+        const bool horizontalMirror
+    )
+    {
+        // The color space isn't used in gray. The chroma planes of a YUV 4:2:0 frame are skipped.
+        DecodeYUV(inputData, outputData, videoType, width, height, YUVOutputFormat::Gray8, YUVColorSpace::BT601, verticalFlip, horizontalMirror);
+    }
+
+    void FrameDecoder::DecodeBayer(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const BayerPattern pattern,
+        const int bitsPerSample,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const FrameSettings& frameSettings,
+        const int outputBytesPerRow,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        const auto conversion = getBayerConversion(bitsPerSample, width, height, frameSettings);
+
+        // The demosaic reads the neighbor rows, so the frame is decoded in full size, then resized or converted into the tensor
+        const int bytesPerPixel = YUVKernel::getBytesPerPixel(outputFormat);
+        const auto resizeTable = getResizeTable(width, height, bytesPerPixel, 1, frameSettings);
+        const auto decodedData = AcquireScratchBuffer(resizeTable || tensor != nullptr ? width * height * bytesPerPixel : 0);
+
+        // Bayer rows are stored from the top
+        const auto threadPool = getDecodeThreadPool(width, height);
+        RowKernel::RunBayer(
+            inputData,
+            decodedData ? decodedData.get() : outputData,
+            width,
+            height,
+            width * bitsPerSample / 8,
+            decodedData ? width * bytesPerPixel : getOutputBytesPerRow(outputBytesPerRow, width, bytesPerPixel, nullptr),
+            !frameSettings.VerticalFlip,
+            pattern,
+            frameSettings.Demosaic,
+            outputFormat,
+            frameSettings.HorizontalMirror,
+            bitsPerSample == 16 ? &conversion : nullptr,
+            threadPool.get(),
+            decodedData ? nullptr : statistics
+        );
+        if (resizeTable)
+        {
+            ResizeDecodedFrame(decodedData.get(), outputData, outputBytesPerRow, width, height, bytesPerPixel, *resizeTable, threadPool.get(), statistics, tensor);
+        }
+        else if (tensor != nullptr)
+        {
+            RowKernel::RunTensor(decodedData.get(), width, height, width * bytesPerPixel, *tensor, threadPool.get());
+        }
     }
+
+    void FrameDecoder::DecodeBayerHalfSize(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const BayerPattern pattern,
+        const int bitsPerSample,
+        const int width,
+        const int height,
+        const YUVOutputFormat outputFormat,
+        const FrameSettings& frameSettings
+    )
+    {
+        const auto conversion = getBayerConversion(bitsPerSample, width, height, frameSettings);
+
+        // Bayer rows are stored from the top
+        const auto threadPool = getDecodeThreadPool(width, height);
+        RowKernel::RunBayerSuperpixel(
+            inputData,
+            outputData,
+            width,
+            height,
+            width * bitsPerSample / 8,
+            (width / 2) * YUVKernel::getBytesPerPixel(outputFormat),
+            !frameSettings.VerticalFlip,
+            pattern,
+            outputFormat,
+            frameSettings.HorizontalMirror,
+            bitsPerSample == 16 ? &conversion : nullptr,
+            threadPool.get()
+        );
+    }
+
+#pragma endregion Decode Kernel
 }
\ No newline at end of file
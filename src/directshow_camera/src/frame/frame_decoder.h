@@ -18,7 +18,21 @@
 #include <vector>
 #include <memory>
 
+#include "frame/bayer_kernel.h"
+#include "frame/bit_depth_kernel.h"
+#include "frame/frame_destination.h"
 #include "frame/frame_settings.h"
+#include "frame/jpeg_decoder.h"
+#include "frame/resize_kernel.h"
+#include "frame/statistics_kernel.h"
+#include "frame/tensor_kernel.h"
+#include "frame/tone_map_kernel.h"
+#include "frame/yuv_kernel.h"
+
+namespace Utils
+{
+    class ThreadPool;
+}
 
 namespace DirectShowCamera
 {
@@ -81,14 +95,16 @@ namespace DirectShowCamera
         * @param[in] width Width
         * @param[in] height Height
         * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
         */
         static void DecodeMonochromeFrame(
-            unsigned char* inputData,
+            const unsigned char* inputData,
             unsigned char* outputData,
             const GUID videoType,
             const int width,
             const int height,
-            const bool verticalFlip = false
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
         );
 
         /**
@@ -98,13 +114,15 @@ namespace DirectShowCamera
         * @param[in] width Width
         * @param[in] height Height
         * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
         */
         static std::shared_ptr<unsigned char[]> DecodeMonochromeFrame(
-            unsigned char* data,
+            const unsigned char* data,
             const GUID videoType,
             const int width,
             const int height,
-            const bool verticalFlip = false
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
         );
 
 #pragma endregion 8bit Monochrome
@@ -138,14 +156,16 @@ namespace DirectShowCamera
         * @param[in] width Width
         * @param[in] height Height
         * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
         */
         static void Decode16BitMonochromeFrame(
-            unsigned char* inputData,
+            const unsigned char* inputData,
             unsigned short* outputData,
             const GUID videoType,
             const int width,
             const int height,
-            const bool verticalFlip = false
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
         );
 
         /**
@@ -155,13 +175,111 @@ namespace DirectShowCamera
         * @param[in] width Width
         * @param[in] height Height
         * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
         */
         static std::shared_ptr<unsigned short[]> Decode16BitMonochromeFrame(
-            unsigned char* data,
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
+        );
+
+        /**
+        * @brief Get the bit depth conversion of a 16bit monochrome video type, i.e. how the samples are shifted or scaled by the frame settings
+        * @param[in] videoType Video Type
+        * @param[in] frameSettings Frame settings. SourceBitDepth, SourceMSBJustified and OutputBitDepth are used.
+        * @return Return the conversion. The input bit depth is the bit depth of the video type if FrameSettings::SourceBitDepth is 0 or the video type is packed.
+        */
+        static BitDepthConversion getBitDepthConversion(const GUID videoType, const FrameSettings& frameSettings);
+
+        /**
+        * @brief Get the significant bits per sample of the decoded image, e.g. 8 for a RGB frame and 10 for a Y10 frame which is not converted.
+        * @param[in] videoType Video Type
+        * @param[in] frameSettings Frame settings
+        * @return Return the bit depth
+        */
+        static int getBitDepth(const GUID videoType, const FrameSettings& frameSettings);
+
+        /**
+        * @brief Map the 16bit monochrome frame to an 8 bit gray image in one pass. The samples are converted to the bit depth of the frame settings and mapped by the tone mapping,
+        *        no 16-bit image is created. It runs in parallel if the frame is large enough, see setNumOfDecodeThreads().
+        * @param[in] inputData Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[out] outputData Output data. Image data is stored in pixel by pixel, row by row.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be a multiple of BitDepthKernel::getPixelsPerGroup() if the video type is packed.
+        * @param[in] height Height
+        * @param[in] toneMapSettings Tone mapping. The window is in the bit depth of getBitDepth().
+        * @param[in] frameSettings (Optional) Frame settings. The vertical flip, the horizontal mirror, the bit depth settings and the binning or the resize are used, see getDecodedSize(). Default as FrameSettings()
+        */
+        static void Decode16BitMonochromeFrameTo8Bit(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const ToneMapSettings& toneMapSettings,
+            const FrameSettings& frameSettings = FrameSettings()
+        );
+
+        /**
+        * @brief Map the 16bit monochrome frame to an 8 bit gray image in one pass into a caller-provided buffer. See Decode16BitMonochromeFrameTo8Bit().
+        * @param[in] inputData Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[in] destination Destination. The pixel format must be FramePixelFormat::Gray8 and the decoded frame must be inside the buffer.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be a multiple of BitDepthKernel::getPixelsPerGroup() if the video type is packed.
+        * @param[in] height Height
+        * @param[in] toneMapSettings Tone mapping. The window is in the bit depth of getBitDepth().
+        * @param[in] frameSettings (Optional) Frame settings. The vertical flip, the horizontal mirror, the bit depth settings and the binning or the resize are used, see getDecodedSize(). Default as FrameSettings()
+        */
+        static void Decode16BitMonochromeFrameTo8Bit(
+            const unsigned char* inputData,
+            const FrameDestination& destination,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const ToneMapSettings& toneMapSettings,
+            const FrameSettings& frameSettings = FrameSettings()
+        );
+
+        /**
+        * @brief Map the 16bit monochrome frame to an 8 bit gray image in one pass. See Decode16BitMonochromeFrameTo8Bit().
+        * @param[in] data Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be a multiple of BitDepthKernel::getPixelsPerGroup() if the video type is packed.
+        * @param[in] height Height
+        * @param[in] toneMapSettings Tone mapping. The window is in the bit depth of getBitDepth().
+        * @param[in] frameSettings (Optional) Frame settings. The vertical flip, the horizontal mirror, the bit depth settings and the binning or the resize are used, see getDecodedSize(). Default as FrameSettings()
+        * @return Return the 8 bit gray image
+        */
+        static std::shared_ptr<unsigned char[]> Decode16BitMonochromeFrameTo8Bit(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const ToneMapSettings& toneMapSettings,
+            const FrameSettings& frameSettings = FrameSettings()
+        );
+
+        /**
+        * @brief Get the tone mapping table of a 16bit monochrome frame. ToneMapMode::AutoRange samples the min and max of the frame.
+        *        Keep the table to hold an auto range window over the following frames, see ToneMapKernel.
+        * @param[in] data Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be a multiple of BitDepthKernel::getPixelsPerGroup() if the video type is packed.
+        * @param[in] height Height
+        * @param[in] toneMapSettings Tone mapping. The window is in the bit depth of getBitDepth().
+        * @param[in] frameSettings (Optional) Frame settings. The bit depth settings are used. Default as FrameSettings()
+        * @return Return the table
+        */
+        static ToneMapTable getToneMapTable(
+            const unsigned char* data,
             const GUID videoType,
             const int width,
             const int height,
-            const bool verticalFlip = false
+            const ToneMapSettings& toneMapSettings,
+            const FrameSettings& frameSettings = FrameSettings()
         );
 
 #pragma endregion 16bit Monochrome
@@ -189,155 +307,1408 @@ namespace DirectShowCamera
 
         /**
         * @brief Decode the RGB frame into another array
-        * @param[in] inputData Input data. Image data is stored in pixel by pixel, row by row in BGR format and has been flipped vertically.
+        * @param[in] inputData Input data. Image data is stored in pixel by pixel, row by row in the format of the video type (BGR for RGB24) and has been flipped vertically. RGB8 is looked up in the gray levels, use DecodeFrame() with FrameSettings::Palette to apply a palette.
         * @param[out] outputData Output data. Image data is stored in pixel by pixel, row by row.
         * @param[in] videoType Video Type
         * @param[in] width Width
         * @param[in] height Height
         * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
         * @param[in] outputRGB (Optional) Output as RGB. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
         */
         static void DecodeRGBFrame(
-            unsigned char* inputData,
+            const unsigned char* inputData,
             unsigned char* outputData,
             const GUID videoType,
             const int width,
             const int height,
             const bool verticalFlip = false,
-            const bool outputRGB = false
+            const bool outputRGB = false,
+            const bool horizontalMirror = false
         );
 
         /**
         * @brief Decode the RGB frame into another array
-        * @param[in] data Input data. Image data is stored in pixel by pixel, row by row in BGR format and has been flipped vertically.
+        * @param[in] data Input data. Image data is stored in pixel by pixel, row by row in the format of the video type (BGR for RGB24) and has been flipped vertically. RGB8 is looked up in the gray levels, use DecodeFrame() with FrameSettings::Palette to apply a palette.
         * @param[in] videoType Video Type
         * @param[in] width Width
         * @param[in] height Height
         * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
         * @param[in] outputRGB (Optional) Output as RGB. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
         */
         static std::shared_ptr<unsigned char[]> DecodeRGBFrame(
-            unsigned char* data,
+            const unsigned char* data,
             const GUID videoType,
             const int width,
             const int height,
             const bool verticalFlip = false,
-            const bool outputRGB = false
+            const bool outputRGB = false,
+            const bool horizontalMirror = false
         );
 
 #pragma endregion RGB
 
+#pragma region YUV
+
         /**
-        * @brief Decode the frame into another array
-        * @param[in] inputData Input data. Image data is stored in pixel by pixel, row by row in BGR format(If color image) and has been flipped vertically.
+        * @brief Get the support YUV video type. They are the packed YUV 4:2:2 and the YUV 4:2:0 types.
+        *        The frame data is kept in YUV if DirectShowCamera::setRawYUVCapture() is enabled.
+        * @return std::vector<GUID> Return the support YUV video type
+        */
+        static std::vector<GUID> SupportYUVVideoType();
+
+        /**
+        * @brief Check if the video type is YUV
+        * @param[in] videoType Video Type
+        * @return bool Return true if the video type is YUV
+        */
+        static bool isYUVFrameType(const GUID videoType);
+
+        /**
+        * @brief Check if the video type is YUV. If not YUV, throw exception.
+        * @param[in] videoType Video Type
+        */
+        static void CheckYUVFrameType(const GUID videoType);
+
+        /**
+        * @brief Decode the YUV frame into another array
+        * @param[in] inputData Input data. Image data is stored row by row from the top as DirectShow delivers YUV frames.
         * @param[out] outputData Output data. Image data is stored in pixel by pixel, row by row.
         * @param[in] videoType Video Type
-        * @param[in] width Width
-        * @param[in] height Height
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even if the video type is YUV 4:2:0.
+        * @param[in] outputFormat (Optional) Output format. Default as YUVOutputFormat::BGR24
+        * @param[in] colorSpace (Optional) Color matrix. Default as YUVColorSpace::BT601
         * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
-        * @param[in] outputRGB (Optional) Output as RGB. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
         */
-        static void DecodeFrame(
-            unsigned char* inputData,
+        static void DecodeYUVFrame(
+            const unsigned char* inputData,
             unsigned char* outputData,
             const GUID videoType,
             const int width,
             const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const YUVColorSpace colorSpace = YUVColorSpace::BT601,
             const bool verticalFlip = false,
-            const bool outputRGB = false
+            const bool horizontalMirror = false
         );
 
-#ifdef WITH_OPENCV2
+        /**
+        * @brief Decode the YUV frame into another array
+        * @param[in] data Input data. Image data is stored row by row from the top as DirectShow delivers YUV frames.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even if the video type is YUV 4:2:0.
+        * @param[in] outputFormat (Optional) Output format. Default as YUVOutputFormat::BGR24
+        * @param[in] colorSpace (Optional) Color matrix. Default as YUVColorSpace::BT601
+        * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
+        */
+        static std::shared_ptr<unsigned char[]> DecodeYUVFrame(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const YUVColorSpace colorSpace = YUVColorSpace::BT601,
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
+        );
 
         /**
-        * @brief Decode the frame into cv::Mat
-        * @param[in] data Input data. Image data is stored in pixel by pixel, row by row in BGR format(If color image) and has been flipped vertically.
+        * @brief Get the planes of a YUV 4:2:0 frame in which the planes are packed without padding, e.g. a frame captured by DirectShowCamera::setRawYUVCapture(). No data is copied.
+        * @param[in] data Frame data
         * @param[in] videoType Video Type
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even.
+        * @return Return the planes pointing into the frame data
+        */
+        static YUV420Planes getYUV420Planes(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height
+        );
+
+        /**
+        * @brief Decode the planes of a YUV 4:2:0 image into another array. The strides of the planes may be larger than the rows,
+        *        so an image in a padded buffer, e.g. a hardware decoder output, can be decoded without repacking.
+        * @param[in] planes Input planes. Rows are stored from the top.
+        * @param[out] outputData Output data. Image data is stored in pixel by pixel, row by row.
         * @param[in] width Width
         * @param[in] height Height
+        * @param[in] outputFormat (Optional) Output format. Default as YUVOutputFormat::BGR24
+        * @param[in] colorSpace (Optional) Color matrix. Default as YUVColorSpace::BT601
         * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
-        * @param[in] outputRGB (Optional) Output as RGB. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
         */
-        static cv::Mat DecodeFrameToCVMat(
-            unsigned char* data,
-            const GUID videoType,
+        static void DecodeYUV420Frame(
+            const YUV420Planes& planes,
+            unsigned char* outputData,
             const int width,
             const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const YUVColorSpace colorSpace = YUVColorSpace::BT601,
             const bool verticalFlip = false,
-            const bool outputRGB = false
+            const bool horizontalMirror = false
         );
 
         /**
-        * @brief Decode the monochrome frame into cv::Mat
-        * @param[in] data Input data. Image data is stored row by row and has been flipped vertically.
-        * @param[in] videoType Video Type
+        * @brief Decode the planes of a YUV 4:2:0 image. See DecodeYUV420Frame().
+        * @param[in] planes Input planes. Rows are stored from the top.
         * @param[in] width Width
         * @param[in] height Height
+        * @param[in] outputFormat (Optional) Output format. Default as YUVOutputFormat::BGR24
+        * @param[in] colorSpace (Optional) Color matrix. Default as YUVColorSpace::BT601
         * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
         */
-        static cv::Mat DecodeMonochromeFrameToCVMat(
-            unsigned char* data,
+        static std::shared_ptr<unsigned char[]> DecodeYUV420Frame(
+            const YUV420Planes& planes,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const YUVColorSpace colorSpace = YUVColorSpace::BT601,
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
+        );
+
+#pragma endregion YUV
+
+#pragma region Luma
+
+        /**
+        * @brief Get the video type which the Y channel can be extracted from. They are the YUV types, see SupportYUVVideoType().
+        * @return std::vector<GUID> Return the support luma video type
+        */
+        static std::vector<GUID> SupportLumaVideoType();
+
+        /**
+        * @brief Check if the Y channel can be extracted from the video type
+        * @param[in] videoType Video Type
+        * @return bool Return true if the Y channel can be extracted
+        */
+        static bool isLumaFrameType(const GUID videoType);
+
+        /**
+        * @brief Check if the Y channel can be extracted from the video type. If not, throw exception.
+        * @param[in] videoType Video Type
+        */
+        static void CheckLumaFrameType(const GUID videoType);
+
+        /**
+        * @brief Extract the Y channel of the YUV frame as an 8 bit gray image. No color conversion is done.
+        * @param[in] inputData Input data. Image data is stored row by row from the top as DirectShow delivers YUV frames.
+        * @param[out] outputData Output data. Image data is stored in pixel by pixel, row by row.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even if the video type is YUV 4:2:0.
+        * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
+        */
+        static void DecodeLumaFrame(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
+        );
+
+        /**
+        * @brief Extract the Y channel of the YUV frame as an 8 bit gray image. No color conversion is done.
+        * @param[in] data Input data. Image data is stored row by row from the top as DirectShow delivers YUV frames.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even if the video type is YUV 4:2:0.
+        * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
+        */
+        static std::shared_ptr<unsigned char[]> DecodeLumaFrame(
+            const unsigned char* data,
             const GUID videoType,
             const int width,
             const int height,
-            const bool verticalFlip = false
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
         );
 
+#pragma endregion Luma
+
+#pragma region MJPEG
+
         /**
-        * @brief Decode the 16bit monochrome frame into cv::Mat
-        * @param[in] data Input data. Image data is stored row by row and has been flipped vertically.
+        * @brief Get the support MJPEG video type. The frame data is kept compressed if DirectShowCamera::setRawMJPGCapture() is enabled.
+        * @return std::vector<GUID> Return the support MJPEG video type
+        */
+        static std::vector<GUID> SupportMJPGVideoType();
+
+        /**
+        * @brief Check if the video type is MJPEG
         * @param[in] videoType Video Type
-        * @param[in] width Width
-        * @param[in] height Height
+        * @return bool Return true if the video type is MJPEG
+        */
+        static bool isMJPGFrameType(const GUID videoType);
+
+        /**
+        * @brief Check if the video type is MJPEG. If not MJPEG, throw exception.
+        * @param[in] videoType Video Type
+        */
+        static void CheckMJPGFrameType(const GUID videoType);
+
+        /**
+        * @brief Decode the MJPEG frame into another array. The restart interval segments are decoded in parallel, see setNumOfDecodeThreads().
+        * @param[in] inputData Input data. It is a baseline JPEG image.
+        * @param[in] numOfInputBytes Number of bytes of the input data. Bytes after the EOI marker are ignored.
+        * @param[out] outputData Output data. Image data is stored in pixel by pixel, row by row. It must have JPEGDecoder::getScaledSize() of the width and height pixels.
+        * @param[in] width Width. It must be equal to the width of the JPEG image.
+        * @param[in] height Height. It must be equal to the height of the JPEG image.
+        * @param[in] outputFormat (Optional) Output format. Default as YUVOutputFormat::BGR24
+        * @param[in] scale (Optional) Output scale. A smaller scale is decoded faster, JPEGScale::Eighth decodes the DC coefficients only. Default as JPEGScale::Full
         * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
         */
-        static cv::Mat Decode16BitMonochromeFrameToCVMat(
-            unsigned char* data,
+        static void DecodeMJPGFrame(
+            const unsigned char* inputData,
+            const int numOfInputBytes,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const JPEGScale scale = JPEGScale::Full,
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
+        );
+
+        /**
+        * @brief Decode the MJPEG frame into another array. The restart interval segments are decoded in parallel, see setNumOfDecodeThreads().
+        * @param[in] data Input data. It is a baseline JPEG image.
+        * @param[in] numOfBytes Number of bytes of the input data. Bytes after the EOI marker are ignored.
+        * @param[in] width Width. It must be equal to the width of the JPEG image.
+        * @param[in] height Height. It must be equal to the height of the JPEG image.
+        * @param[in] outputFormat (Optional) Output format. Default as YUVOutputFormat::BGR24
+        * @param[in] scale (Optional) Output scale. A smaller scale is decoded faster, JPEGScale::Eighth decodes the DC coefficients only. Default as JPEGScale::Full
+        * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
+        * @return Return the image in JPEGDecoder::getScaledSize() of the width and height
+        */
+        static std::shared_ptr<unsigned char[]> DecodeMJPGFrame(
+            const unsigned char* data,
+            const int numOfBytes,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const JPEGScale scale = JPEGScale::Full,
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
+        );
+
+#pragma endregion MJPEG
+
+#pragma region Bayer
+
+        /**
+        * @brief Get the support Bayer video type. They are the 8 bit and 16bit raw sensor types of the 4 patterns.
+        * @return std::vector<GUID> Return the support Bayer video type
+        */
+        static std::vector<GUID> SupportBayerVideoType();
+
+        /**
+        * @brief Check if the video type is Bayer
+        * @param[in] videoType Video Type
+        * @return bool Return true if the video type is Bayer
+        */
+        static bool isBayerFrameType(const GUID videoType);
+
+        /**
+        * @brief Check if the video type is Bayer. If not Bayer, throw exception.
+        * @param[in] videoType Video Type
+        */
+        static void CheckBayerFrameType(const GUID videoType);
+
+        /**
+        * @brief Demosaic the Bayer frame into another array. It runs in parallel if the frame is large enough, see setNumOfDecodeThreads().
+        * @param[in] inputData Input data. Image data is stored row by row from the top as DirectShow delivers FourCC frames, the pattern starts at the first row.
+        * @param[out] outputData Output data. Image data is stored in pixel by pixel, row by row.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even.
+        * @param[in] outputFormat (Optional) Output format. YUVOutputFormat::Gray8 is not supported. Default as YUVOutputFormat::BGR24
+        * @param[in] frameSettings (Optional) Frame settings. The demosaic, the vertical flip, the horizontal mirror, the source bit depth settings of the 16bit types and the binning or the resize are used, see getDecodedSize(). Default as FrameSettings()
+        */
+        static void DecodeBayerFrame(
+            const unsigned char* inputData,
+            unsigned char* outputData,
             const GUID videoType,
             const int width,
             const int height,
-            const bool verticalFlip = false
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const FrameSettings& frameSettings = FrameSettings()
         );
 
         /**
-        * @brief Decode the RGB frame into cv::Mat
-        * @param[in] data Input data. Image data is stored in pixel by pixel, row by row in BGR format and has been flipped vertically.
+        * @brief Demosaic the Bayer frame into another array. See DecodeBayerFrame().
+        * @param[in] data Input data. Image data is stored row by row from the top as DirectShow delivers FourCC frames, the pattern starts at the first row.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even.
+        * @param[in] outputFormat (Optional) Output format. YUVOutputFormat::Gray8 is not supported. Default as YUVOutputFormat::BGR24
+        * @param[in] frameSettings (Optional) Frame settings. The demosaic, the vertical flip, the horizontal mirror, the source bit depth settings of the 16bit types and the binning or the resize are used, see getDecodedSize(). Default as FrameSettings()
+        * @return Return the image
+        */
+        static std::shared_ptr<unsigned char[]> DecodeBayerFrame(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const FrameSettings& frameSettings = FrameSettings()
+        );
+
+        /**
+        * @brief Merge each 2 x 2 block of the Bayer frame into a pixel, e.g. for a preview. No interpolation is done, it is faster than DecodeBayerFrame().
+        * @param[in] inputData Input data. Image data is stored row by row from the top as DirectShow delivers FourCC frames, the pattern starts at the first row.
+        * @param[out] outputData Output data in width / 2 x height / 2. Image data is stored in pixel by pixel, row by row.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even.
+        * @param[in] outputFormat (Optional) Output format. YUVOutputFormat::Gray8 is not supported. Default as YUVOutputFormat::BGR24
+        * @param[in] frameSettings (Optional) Frame settings. The vertical flip, the horizontal mirror and the source bit depth settings of the 16bit types are used. Default as FrameSettings()
+        */
+        static void DecodeBayerFrameHalfSize(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const FrameSettings& frameSettings = FrameSettings()
+        );
+
+        /**
+        * @brief Merge each 2 x 2 block of the Bayer frame into a pixel. See DecodeBayerFrameHalfSize().
+        * @param[in] data Input data. Image data is stored row by row from the top as DirectShow delivers FourCC frames, the pattern starts at the first row.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even.
+        * @param[in] outputFormat (Optional) Output format. YUVOutputFormat::Gray8 is not supported. Default as YUVOutputFormat::BGR24
+        * @param[in] frameSettings (Optional) Frame settings. The vertical flip, the horizontal mirror and the source bit depth settings of the 16bit types are used. Default as FrameSettings()
+        * @return Return the image in width / 2 x height / 2
+        */
+        static std::shared_ptr<unsigned char[]> DecodeBayerFrameHalfSize(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const FrameSettings& frameSettings = FrameSettings()
+        );
+
+#pragma endregion Bayer
+
+        /**
+        * @brief Decode the frame into another array
+        * @param[in] inputData Input data. Image data is stored in pixel by pixel, row by row in BGR format(If color image) and has been flipped vertically.
+        * @param[out] outputData Output data. Image data is stored in pixel by pixel, row by row.
         * @param[in] videoType Video Type
         * @param[in] width Width
         * @param[in] height Height
         * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
         * @param[in] outputRGB (Optional) Output as RGB. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
         */
-        static cv::Mat DecodeRGBFrameFrameToCVMat(
-            unsigned char* data,
+        static void DecodeFrame(
+            const unsigned char* inputData,
+            unsigned char* outputData,
             const GUID videoType,
             const int width,
             const int height,
             const bool verticalFlip = false,
-            const bool outputRGB = false
+            const bool outputRGB = false,
+            const bool horizontalMirror = false
         );
-#endif // def WITH_OPENCV2
-
-    private:
 
         /**
-        * @brief Clone the raw data into another array. It can be used to vertical flip the image.
-        * @param[in] inputData Input data. Image data is stored row by row and has been flipped vertically.
-        * @param[out] outputData Output data. Image data is stored row by row.
+        * @brief Decode the frame into another array
+        * @param[in] inputData Input data. Image data is stored in pixel by pixel, row by row in BGR format(If color image) and has been flipped vertically.
+        * @param[out] outputData Output data. Image data is stored in pixel by pixel, row by row.
+        * @param[in] videoType Video Type
         * @param[in] width Width
         * @param[in] height Height
-        * @param[in] bytesPerPixel Bytes per pixel
-        * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] frameSettings Frame settings. The output is binned or resized by the frame settings, see getDecodedSize().
+        * @param[out] statistics (Optional) Statistics of the decoded frame, accumulated while it is decoded if FrameSettings::Statistics is not FrameStatisticsMode::None. Default as nullptr, not accumulated.
         */
-        static void CloneRawData(
-            unsigned char* inputData,
+        static void DecodeFrame(
+            const unsigned char* inputData,
             unsigned char* outputData,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const FrameSettings& frameSettings,
+            FrameStatistics* statistics = nullptr
+        );
+
+        /**
+        * @brief Decode the frame into a caller-provided buffer, e.g. a pooled image, a tile of a mosaic canvas or a shared memory slot. Nothing is allocated and the pixels outside the decoded frame are not written.
+        * @param[in] inputData Input data. Image data is stored in pixel by pixel, row by row in BGR format(If color image) and has been flipped vertically.
+        * @param[in] destination Destination. The pixel format must be getDecodedPixelFormat() of the video type, except the color video types are decoded in FramePixelFormat::BGR24 or FramePixelFormat::RGB24 regardless of FrameSettings::BGR.
+        *                        The decoded frame in the size of getDecodedSize() must be inside the buffer.
+        * @param[in] videoType Video Type
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] frameSettings (Optional) Frame settings. Default as FrameSettings()
+        * @param[out] statistics (Optional) Statistics of the decoded frame, accumulated while it is decoded if FrameSettings::Statistics is not FrameStatisticsMode::None. Default as nullptr, not accumulated.
+        */
+        static void DecodeFrame(
+            const unsigned char* inputData,
+            const FrameDestination& destination,
+            const GUID videoType,
             const int width,
             const int height,
-            const int bytesPerPixel,
-            const bool verticalFlip = false
+            const FrameSettings& frameSettings = FrameSettings(),
+            FrameStatistics* statistics = nullptr
         );
 
+        /**
+        * @brief Get the pixel format of a frame decoded by DecodeFrame(). If the video type is not supported, throw exception.
+        * @param[in] videoType Video Type
+        * @param[in] frameSettings (Optional) Frame settings. BGR is used. Default as FrameSettings()
+        * @return Return the pixel format
+        */
+        static FramePixelFormat getDecodedPixelFormat(const GUID videoType, const FrameSettings& frameSettings = FrameSettings());
+
+        /**
+        * @brief Get the size of a frame decoded with the frame settings, i.e. after FrameSettings::Binning or FrameSettings::ResizeWidth and FrameSettings::ResizeHeight.
+        *        The rows are binned or resized while they are decoded, so the full size frame is never written. If the settings are invalid, throw exception.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] frameSettings Frame settings
+        * @param[out] decodedWidth Decoded width
+        * @param[out] decodedHeight Decoded height
+        */
+        static void getDecodedSize(const int width, const int height, const FrameSettings& frameSettings, int& decodedWidth, int& decodedHeight);
+
+        /**
+        * @brief Check if the frame settings bin or resize the decoded frame
+        * @param[in] frameSettings Frame settings
+        * @return Return true if the decoded frame is binned or resized
+        */
+        static bool isResized(const FrameSettings& frameSettings);
+
+        /**
+        * @brief Decode the frame into the planes of a caller-provided float tensor for inference, e.g. the CHW input of a model, instead of decoding, converting and splitting a cv::Mat.
+        *        The frame is decoded in the channel order of the tensor and resized to getTensorRegion() while it is decoded. Each decoded row is split into the planes,
+        *        normalized, converted to the element type and padded while it is still in the cache, so the decoded frame is never written. MJPEG and Bayer frames are
+        *        decoded into a recycled scratch buffer first. The rows run in parallel if the frame is large enough, see setNumOfDecodeThreads().
+        * @param[in] inputData Input data. Image data is stored in pixel by pixel, row by row in BGR format(If color image) and has been flipped vertically.
+        * @param[in] destination Destination. A color video type must be decoded into 3 planes.
+        * @param[in] videoType Video Type
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] frameSettings (Optional) Frame settings. The binning and the resize are replaced by the resize to the tensor, and the statistics are not accumulated. Default as FrameSettings()
+        */
+        static void DecodeFrameToTensor(
+            const unsigned char* inputData,
+            const TensorDestination& destination,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const FrameSettings& frameSettings = FrameSettings()
+        );
+
+        /**
+        * @brief Get the region of a frame in a tensor decoded by DecodeFrameToTensor(), e.g. to map the detections of a model back to the frame. If the sizes are invalid, throw exception.
+        *        The frame is only shrunk by area averaging, so a frame smaller than the tensor keeps its size. The region is centered in the tensor.
+        * @param[in] width Width of the frame
+        * @param[in] height Height of the frame
+        * @param[in] destination Destination. The width, the height and the letterbox are used.
+        * @param[out] x X of the top left pixel of the frame in the tensor
+        * @param[out] y Y of the top left pixel of the frame in the tensor
+        * @param[out] regionWidth Width of the frame in the tensor
+        * @param[out] regionHeight Height of the frame in the tensor
+        */
+        static void getTensorRegion(
+            const int width,
+            const int height,
+            const TensorDestination& destination,
+            int& x,
+            int& y,
+            int& regionWidth,
+            int& regionHeight
+        );
+
+#ifdef WITH_OPENCV2
+
+        /**
+        * @brief Decode the frame into cv::Mat
+        * @param[in] data Input data. Image data is stored in pixel by pixel, row by row in BGR format(If color image) and has been flipped vertically.
+        * @param[in] videoType Video Type
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] outputRGB (Optional) Output as RGB. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
+        */
+        static cv::Mat DecodeFrameToCVMat(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const bool verticalFlip = false,
+            const bool outputRGB = false,
+            const bool horizontalMirror = false
+        );
+
+        /**
+        * @brief Decode the frame into cv::Mat
+        * @param[in] data Input data. Image data is stored in pixel by pixel, row by row in BGR format(If color image) and has been flipped vertically.
+        * @param[in] videoType Video Type
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] frameSettings Frame settings. The cv::Mat is in the size of getDecodedSize().
+        */
+        static cv::Mat DecodeFrameToCVMat(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const FrameSettings& frameSettings
+        );
+
+        /**
+        * @brief Decode the frame into an existing cv::Mat, e.g. a pooled cv::Mat or a region of a canvas. The cv::Mat is reused if it is in the size of getDecodedSize() and the type of the video type,
+        *        otherwise it is reallocated by cv::Mat::create().
+        * @param[in] data Input data. Image data is stored in pixel by pixel, row by row in BGR format(If color image) and has been flipped vertically.
+        * @param[in] videoType Video Type
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in, out] result cv::Mat
+        * @param[in] frameSettings (Optional) Frame settings. Default as FrameSettings()
+        * @param[out] statistics (Optional) Statistics of the decoded frame, accumulated while it is decoded if FrameSettings::Statistics is not FrameStatisticsMode::None. Default as nullptr, not accumulated.
+        */
+        static void DecodeFrameToCVMat(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            cv::Mat& result,
+            const FrameSettings& frameSettings = FrameSettings(),
+            FrameStatistics* statistics = nullptr
+        );
+
+        /**
+        * @brief Decode the monochrome frame into cv::Mat
+        * @param[in] data Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[in] videoType Video Type
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
+        */
+        static cv::Mat DecodeMonochromeFrameToCVMat(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
+        );
+
+        /**
+        * @brief Decode the 16bit monochrome frame into cv::Mat
+        * @param[in] data Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[in] videoType Video Type
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
+        */
+        static cv::Mat Decode16BitMonochromeFrameToCVMat(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
+        );
+
+        /**
+        * @brief Map the 16bit monochrome frame to an 8 bit gray cv::Mat in one pass. See Decode16BitMonochromeFrameTo8Bit().
+        * @param[in] data Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be a multiple of BitDepthKernel::getPixelsPerGroup() if the video type is packed.
+        * @param[in] height Height
+        * @param[in] toneMapSettings Tone mapping. The window is in the bit depth of getBitDepth().
+        * @param[in] frameSettings (Optional) Frame settings. The vertical flip, the horizontal mirror, the bit depth settings and the binning or the resize are used, see getDecodedSize(). Default as FrameSettings()
+        */
+        static cv::Mat Decode16BitMonochromeFrameTo8BitCVMat(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const ToneMapSettings& toneMapSettings,
+            const FrameSettings& frameSettings = FrameSettings()
+        );
+
+        /**
+        * @brief Decode the RGB frame into cv::Mat
+        * @param[in] data Input data. Image data is stored in pixel by pixel, row by row in the format of the video type (BGR for RGB24) and has been flipped vertically. RGB8 is looked up in the gray levels, use DecodeFrame() with FrameSettings::Palette to apply a palette.
+        * @param[in] videoType Video Type
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] outputRGB (Optional) Output as RGB. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
+        */
+        static cv::Mat DecodeRGBFrameFrameToCVMat(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const bool verticalFlip = false,
+            const bool outputRGB = false,
+            const bool horizontalMirror = false
+        );
+
+        /**
+        * @brief Decode the YUV frame into cv::Mat
+        * @param[in] data Input data. Image data is stored row by row from the top as DirectShow delivers YUV frames.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even if the video type is YUV 4:2:0.
+        * @param[in] outputFormat (Optional) Output format. Default as YUVOutputFormat::BGR24
+        * @param[in] colorSpace (Optional) Color matrix. Default as YUVColorSpace::BT601
+        * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
+        */
+        static cv::Mat DecodeYUVFrameToCVMat(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const YUVColorSpace colorSpace = YUVColorSpace::BT601,
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
+        );
+
+        /**
+        * @brief Extract the Y channel of the YUV frame into cv::Mat. No color conversion is done.
+        * @param[in] data Input data. Image data is stored row by row from the top as DirectShow delivers YUV frames.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even if the video type is YUV 4:2:0.
+        * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
+        */
+        static cv::Mat DecodeLumaFrameToCVMat(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
+        );
+
+        /**
+        * @brief Decode the MJPEG frame into cv::Mat
+        * @param[in] data Input data. It is a baseline JPEG image.
+        * @param[in] numOfBytes Number of bytes of the input data. Bytes after the EOI marker are ignored.
+        * @param[in] width Width. It must be equal to the width of the JPEG image.
+        * @param[in] height Height. It must be equal to the height of the JPEG image.
+        * @param[in] outputFormat (Optional) Output format. Default as YUVOutputFormat::BGR24
+        * @param[in] scale (Optional) Output scale. Default as JPEGScale::Full
+        * @param[in] verticalFlip (Optional) Flip the image vertically. Default as false.
+        * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
+        */
+        static cv::Mat DecodeMJPGFrameToCVMat(
+            const unsigned char* data,
+            const int numOfBytes,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const JPEGScale scale = JPEGScale::Full,
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false
+        );
+
+        /**
+        * @brief Demosaic the Bayer frame into cv::Mat. See DecodeBayerFrame().
+        * @param[in] data Input data. Image data is stored row by row from the top as DirectShow delivers FourCC frames, the pattern starts at the first row.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even.
+        * @param[in] outputFormat (Optional) Output format. YUVOutputFormat::Gray8 is not supported. Default as YUVOutputFormat::BGR24
+        * @param[in] frameSettings (Optional) Frame settings. The demosaic, the vertical flip, the horizontal mirror, the source bit depth settings of the 16bit types and the binning or the resize are used, see getDecodedSize(). Default as FrameSettings()
+        */
+        static cv::Mat DecodeBayerFrameToCVMat(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const FrameSettings& frameSettings = FrameSettings()
+        );
+
+        /**
+        * @brief Merge each 2 x 2 block of the Bayer frame into a pixel of cv::Mat. See DecodeBayerFrameHalfSize().
+        * @param[in] data Input data. Image data is stored row by row from the top as DirectShow delivers FourCC frames, the pattern starts at the first row.
+        * @param[in] videoType Video Type
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even.
+        * @param[in] outputFormat (Optional) Output format. YUVOutputFormat::Gray8 is not supported. Default as YUVOutputFormat::BGR24
+        * @param[in] frameSettings (Optional) Frame settings. The vertical flip, the horizontal mirror and the source bit depth settings of the 16bit types are used. Default as FrameSettings()
+        */
+        static cv::Mat DecodeBayerFrameHalfSizeToCVMat(
+            const unsigned char* data,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat = YUVOutputFormat::BGR24,
+            const FrameSettings& frameSettings = FrameSettings()
+        );
+#endif // def WITH_OPENCV2
+
+#pragma region Parallel Decode
+
+        /**
+        * @brief Set the number of threads used to decode a frame. The rows are split into bands which run on a shared worker pool.
+        *        Frames smaller than getParallelDecodeMinFrameSize() are always decoded on the calling thread.
+        * @param[in] numOfThreads Number of threads including the calling thread. 1 to decode on the calling thread, 0 to use the number of hardware threads. Default as 1
+        */
+        static void setNumOfDecodeThreads(const int numOfThreads);
+
+        /**
+        * @brief Get the number of threads used to decode a frame
+        * @return Return the number of threads including the calling thread
+        */
+        static int getNumOfDecodeThreads();
+
+        /**
+        * @brief Set the minimum frame size decoded in parallel
+        * @param[in] numOfPixels Number of pixels. Default as 1920 x 1080
+        */
+        static void setParallelDecodeMinFrameSize(const int numOfPixels);
+
+        /**
+        * @brief Get the minimum frame size decoded in parallel
+        * @return Return the number of pixels
+        */
+        static int getParallelDecodeMinFrameSize();
+
+        /**
+        * @brief Check if a frame is decoded in parallel
+        * @param[in] width Width
+        * @param[in] height Height
+        * @return Return true if the frame is decoded in parallel
+        */
+        static bool isParallelDecode(const int width, const int height);
+
+#pragma endregion Parallel Decode
+
+#pragma region Decode Kernel
+
+        /**
+        * @brief Decode kernel of the 8bit monochrome subtypes. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[out] outputData Output data. Image data is stored row by row.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. VerticalFlip and HorizontalMirror are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeMonochromeKernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the 16bit monochrome subtypes. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[out] outputData Output data in unsigned short. Image data is stored row by row.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. VerticalFlip and HorizontalMirror are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void Decode16BitMonochromeKernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the Y10 frame data, 10 bits in the low bits of 16-bit samples. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[out] outputData Output data in unsigned short. Image data is stored row by row.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. VerticalFlip, HorizontalMirror and the bit depth settings are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeY10Kernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the Y12 frame data, 12 bits in the low bits of 16-bit samples. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[out] outputData Output data in unsigned short. Image data is stored row by row.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. VerticalFlip, HorizontalMirror and the bit depth settings are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeY12Kernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the Y10P frame data. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. Image data is stored row by row in PackedMonochromeLayout::Y10P and has been flipped vertically.
+        * @param[out] outputData Output data in unsigned short. Image data is stored row by row.
+        * @param[in] width Width. It must be a multiple of 4.
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. VerticalFlip, HorizontalMirror and OutputBitDepth are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeY10PKernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the Y12P frame data. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. Image data is stored row by row in PackedMonochromeLayout::Y12P and has been flipped vertically.
+        * @param[out] outputData Output data in unsigned short. Image data is stored row by row.
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. VerticalFlip, HorizontalMirror and OutputBitDepth are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeY12PKernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the BGR24 frame data. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. Image data is stored in pixel by pixel, row by row in BGR format and has been flipped vertically.
+        * @param[out] outputData Output data. Image data is stored in pixel by pixel, row by row.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. BGR, VerticalFlip and HorizontalMirror are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeBGR24Kernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the RGB565 frame data. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. Image data is stored in 16-bit pixels, row by row and has been flipped vertically.
+        * @param[out] outputData Output data in 24 bits. Image data is stored in pixel by pixel, row by row.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. BGR, VerticalFlip and HorizontalMirror are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeRGB565Kernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the RGB555 frame data. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. Image data is stored in 16-bit pixels, row by row and has been flipped vertically.
+        * @param[out] outputData Output data in 24 bits. Image data is stored in pixel by pixel, row by row.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. BGR, VerticalFlip and HorizontalMirror are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeRGB555Kernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the RGB8 frame data. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. Image data is stored in 8 bit palette indices, row by row and has been flipped vertically.
+        * @param[out] outputData Output data in 24 bits. Image data is stored in pixel by pixel, row by row.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. BGR, VerticalFlip, HorizontalMirror and Palette are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeRGB8Kernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the YUY2 frame data. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. Image data is stored row by row from the top.
+        * @param[out] outputData Output data in 24 bits. Image data is stored in pixel by pixel, row by row.
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. BGR, VerticalFlip, HorizontalMirror and ColorSpace are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeYUY2Kernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the UYVY frame data. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. Image data is stored row by row from the top.
+        * @param[out] outputData Output data in 24 bits. Image data is stored in pixel by pixel, row by row.
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. BGR, VerticalFlip, HorizontalMirror and ColorSpace are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeUYVYKernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the NV12 frame data. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. The Y plane is followed by the interleaved U V plane, rows are stored from the top.
+        * @param[out] outputData Output data in 24 bits. Image data is stored in pixel by pixel, row by row.
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even.
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. BGR, VerticalFlip, HorizontalMirror and ColorSpace are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeNV12Kernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the I420 and IYUV frame data. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. The Y plane is followed by the U plane and the V plane, rows are stored from the top.
+        * @param[out] outputData Output data in 24 bits. Image data is stored in pixel by pixel, row by row.
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even.
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. BGR, VerticalFlip, HorizontalMirror and ColorSpace are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeI420Kernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the MJPEG frame data. Video type is not checked. See FrameSubtypeRegistry.
+        * @param[in] inputData Input data. It is a baseline JPEG image in a buffer of width * height * 3 bytes.
+        * @param[out] outputData Output data in 24 bits. Image data is stored in pixel by pixel, row by row.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. BGR, VerticalFlip and HorizontalMirror are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        static void DecodeMJPGKernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        );
+
+        /**
+        * @brief Decode kernel of the Bayer frame data. Video type is not checked. See FrameSubtypeRegistry.
+        * @tparam Pattern Pattern of the first row
+        * @tparam BitsPerSample 8 or 16
+        * @param[in] inputData Input data. Image data is stored row by row from the top.
+        * @param[out] outputData Output data in 24 bits. Image data is stored in pixel by pixel, row by row.
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even.
+        * @param[in] outputBytesPerRow Number of bytes per output row. 0 if the rows are packed.
+        * @param[in] frameSettings Frame settings. BGR, VerticalFlip, HorizontalMirror, Demosaic and the source bit depth settings of the 16bit types are used.
+        * @param[in, out] statistics Statistics accumulator of the decoded frame. nullptr if the statistics are not accumulated.
+        * @param[out] tensor Tensor written instead of the output data. nullptr if the output data is written.
+        */
+        template <BayerPattern Pattern, int BitsPerSample>
+        static void DecodeBayerKernel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const FrameSettings& frameSettings,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        )
+        {
+            DecodeBayer(inputData, outputData, Pattern, BitsPerSample, width, height, frameSettings.BGR ? YUVOutputFormat::BGR24 : YUVOutputFormat::RGB24, frameSettings, outputBytesPerRow, statistics, tensor);
+        }
+
+#pragma endregion Decode Kernel
+
+    private:
+
+        /**
+        * @brief Decode a 16bit monochrome frame in the bit depth of the frame settings
+        * @param[in] inputData Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[out] outputData Output data in unsigned short
+        * @param[in] videoType Video Type. It must be a 16bit monochrome type.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] frameSettings Frame settings
+        * @param[in] outputBytesPerRow (Optional) Number of bytes per output row. Default as 0, the rows are packed.
+        * @param[in, out] statistics (Optional) Accumulate the statistics of the decoded frame. Default as nullptr, not accumulated.
+        * @param[out] tensor (Optional) Write the decoded frame into a tensor instead of the output data. Default as nullptr, write the output data.
+        */
+        static void Decode16BitMonochrome(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const FrameSettings& frameSettings,
+            const int outputBytesPerRow = 0,
+            StatisticsAccumulator* statistics = nullptr,
+            const TensorOutput* tensor = nullptr
+        );
+
+        /**
+        * @brief Map a 16bit monochrome frame to an 8 bit gray image
+        * @param[in] inputData Input data. Image data is stored row by row and has been flipped vertically.
+        * @param[out] outputData Output data, 1 byte per pixel
+        * @param[in] videoType Video Type. It must be a 16bit monochrome type.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] toneMapSettings Tone mapping
+        * @param[in] frameSettings Frame settings
+        * @param[in] outputBytesPerRow (Optional) Number of bytes per output row. Default as 0, the rows are packed.
+        */
+        static void Decode16BitMonochromeTo8Bit(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const ToneMapSettings& toneMapSettings,
+            const FrameSettings& frameSettings,
+            const int outputBytesPerRow = 0
+        );
+
+        /**
+        * @brief Decode a MJPEG frame
+        * @param[in] inputData Input data
+        * @param[in] numOfInputBytes Number of bytes of the input data
+        * @param[out] outputData Output data
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputFormat Output format
+        * @param[in] scale Output scale
+        * @param[in] verticalFlip Flip the image vertically
+        * @param[in] horizontalMirror Mirror the image horizontally
+        * @param[in] outputBytesPerRow (Optional) Number of bytes per output row. Default as 0, the rows are packed.
+        */
+        static void DecodeMJPG(
+            const unsigned char* inputData,
+            const int numOfInputBytes,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat,
+            const JPEGScale scale,
+            const bool verticalFlip,
+            const bool horizontalMirror,
+            const int outputBytesPerRow = 0
+        );
+
+        /**
+        * @brief Extract the Y channel of a YUV frame
+        * @param[in] inputData Input data. Image data is stored row by row from the top.
+        * @param[out] outputData Output data
+        * @param[in] videoType Video Type
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] verticalFlip Flip the image vertically
+        * @param[in] horizontalMirror Mirror the image horizontally
+        */
+        static void DecodeLuma(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const bool verticalFlip,
+            const bool horizontalMirror
+        );
+
+        /**
+        * @brief Decode a packed YUV 4:2:2 frame
+        * @param[in] inputData Input data. Image data is stored row by row from the top.
+        * @param[out] outputData Output data
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height
+        * @param[in] layout Byte order of the input
+        * @param[in] outputFormat Output format
+        * @param[in] colorSpace Color matrix
+        * @param[in] verticalFlip Flip the image vertically
+        * @param[in] horizontalMirror Mirror the image horizontally
+        * @param[in] resizeTable (Optional) Resize the rows while they are decoded. Default as nullptr, not resized.
+        * @param[in] outputBytesPerRow (Optional) Number of bytes per output row. Default as 0, the rows are packed.
+        * @param[in, out] statistics (Optional) Accumulate the statistics of the decoded frame. Default as nullptr, not accumulated.
+        * @param[out] tensor (Optional) Write the decoded frame into a tensor instead of the output data. Default as nullptr, write the output data.
+        */
+        static void DecodeYUV422(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const YUV422Layout layout,
+            const YUVOutputFormat outputFormat,
+            const YUVColorSpace colorSpace,
+            const bool verticalFlip,
+            const bool horizontalMirror,
+            const ResizeTable* resizeTable = nullptr,
+            const int outputBytesPerRow = 0,
+            StatisticsAccumulator* statistics = nullptr,
+            const TensorOutput* tensor = nullptr
+        );
+
+        /**
+        * @brief Decode a YUV frame of any YUV video type
+        * @param[in] inputData Input data. Image data is stored row by row from the top.
+        * @param[out] outputData Output data
+        * @param[in] videoType Video Type. It must be a YUV type.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputFormat Output format
+        * @param[in] colorSpace Color matrix
+        * @param[in] verticalFlip Flip the image vertically
+        * @param[in] horizontalMirror Mirror the image horizontally
+        */
+        static void DecodeYUV(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const GUID videoType,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat,
+            const YUVColorSpace colorSpace,
+            const bool verticalFlip,
+            const bool horizontalMirror
+        );
+
+        /**
+        * @brief Decode the planes of a YUV 4:2:0 image
+        * @param[in] planes Input planes. Rows are stored from the top.
+        * @param[out] outputData Output data
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputFormat Output format
+        * @param[in] colorSpace Color matrix
+        * @param[in] verticalFlip Flip the image vertically
+        * @param[in] horizontalMirror Mirror the image horizontally
+        * @param[in] resizeTable (Optional) Resize the rows while they are decoded. Default as nullptr, not resized.
+        * @param[in] outputBytesPerRow (Optional) Number of bytes per output row. Default as 0, the rows are packed.
+        * @param[in, out] statistics (Optional) Accumulate the statistics of the decoded frame. Default as nullptr, not accumulated.
+        * @param[out] tensor (Optional) Write the decoded frame into a tensor instead of the output data. Default as nullptr, write the output data.
+        */
+        static void DecodeYUV420(
+            const YUV420Planes& planes,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat,
+            const YUVColorSpace colorSpace,
+            const bool verticalFlip,
+            const bool horizontalMirror,
+            const ResizeTable* resizeTable = nullptr,
+            const int outputBytesPerRow = 0,
+            StatisticsAccumulator* statistics = nullptr,
+            const TensorOutput* tensor = nullptr
+        );
+
+        /**
+        * @brief Demosaic a Bayer frame
+        * @param[in] inputData Input data. Image data is stored row by row from the top.
+        * @param[out] outputData Output data
+        * @param[in] pattern Pattern of the first row
+        * @param[in] bitsPerSample 8 or 16
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even.
+        * @param[in] outputFormat Output format
+        * @param[in] frameSettings Frame settings
+        * @param[in] outputBytesPerRow (Optional) Number of bytes per output row. Default as 0, the rows are packed.
+        * @param[in, out] statistics (Optional) Accumulate the statistics of the decoded frame. Default as nullptr, not accumulated.
+        * @param[out] tensor (Optional) Write the decoded frame into a tensor instead of the output data. Default as nullptr, write the output data.
+        */
+        static void DecodeBayer(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const BayerPattern pattern,
+            const int bitsPerSample,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat,
+            const FrameSettings& frameSettings,
+            const int outputBytesPerRow = 0,
+            StatisticsAccumulator* statistics = nullptr,
+            const TensorOutput* tensor = nullptr
+        );
+
+        /**
+        * @brief Merge each 2 x 2 block of a Bayer frame into a pixel
+        * @param[in] inputData Input data. Image data is stored row by row from the top.
+        * @param[out] outputData Output data
+        * @param[in] pattern Pattern of the first row
+        * @param[in] bitsPerSample 8 or 16
+        * @param[in] width Width. It must be even.
+        * @param[in] height Height. It must be even.
+        * @param[in] outputFormat Output format
+        * @param[in] frameSettings Frame settings
+        */
+        static void DecodeBayerHalfSize(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const BayerPattern pattern,
+            const int bitsPerSample,
+            const int width,
+            const int height,
+            const YUVOutputFormat outputFormat,
+            const FrameSettings& frameSettings
+        );
+
+        /**
+        * @brief Get the worker pool to decode a frame
+        * @param[in] width Width
+        * @param[in] height Height
+        * @return Return the worker pool. Return nullptr if the frame is decoded on the calling thread.
+        */
+        static std::shared_ptr<Utils::ThreadPool> getDecodeThreadPool(const int width, const int height);
+
     private:
         GUID m_videoType;
         std::vector<GUID> m_supportVideoType;
@@ -0,0 +1,185 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__FRAME_DESTINATION_H
+#define DIRECTSHOW_CAMERA__FRAME__FRAME_DESTINATION_H
+
+//************Content************
+
+#include <array>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Pixel format of a decoded frame
+    */
+    enum class FramePixelFormat
+    {
+        BGR24,
+        RGB24,
+        Gray8,
+        Gray16  // Unsigned short in the bit depth of FrameSettings
+    };
+
+    /**
+     * @brief Caller-provided buffer to decode a frame into, e.g. a pooled image, a tile of a mosaic canvas or a shared memory slot.
+     *        The decoded frame is written at (X, Y) of the buffer. Rows are stored from the top. The pixels outside the decoded frame are not written.
+    */
+    struct FrameDestination
+    {
+        /**
+         * @brief First pixel of the buffer
+        */
+        unsigned char* Data = nullptr;
+
+        /**
+         * @brief Width of the buffer in pixel
+        */
+        int Width = 0;
+
+        /**
+         * @brief Height of the buffer in pixel
+        */
+        int Height = 0;
+
+        /**
+         * @brief Number of bytes per row of the buffer. It must be >= Width * bytes per pixel. Default as 0, the rows are packed.
+        */
+        int BytesPerRow = 0;
+
+        /**
+         * @brief Pixel format of the buffer. Default as FramePixelFormat::BGR24
+        */
+        FramePixelFormat PixelFormat = FramePixelFormat::BGR24;
+
+        /**
+         * @brief X of the top left pixel of the decoded frame in the buffer. Default as 0
+        */
+        int X = 0;
+
+        /**
+         * @brief Y of the top left pixel of the decoded frame in the buffer. Default as 0
+        */
+        int Y = 0;
+
+        /**
+         * @brief Get the number of bytes per pixel of the pixel format
+         * @return Return the number of bytes per pixel
+        */
+        int getBytesPerPixel() const
+        {
+            switch (PixelFormat)
+            {
+            case FramePixelFormat::Gray8:
+                return 1;
+            case FramePixelFormat::Gray16:
+                return 2;
+            default:
+                return 3;
+            }
+        }
+
+        /**
+         * @brief Get the number of bytes per row of the buffer
+         * @return Return BytesPerRow if it is set, otherwise the number of bytes per packed row
+        */
+        int getBytesPerRow() const
+        {
+            return BytesPerRow > 0 ? BytesPerRow : Width * getBytesPerPixel();
+        }
+    };
+
+    /**
+     * @brief Element type of a tensor
+    */
+    enum class TensorDataType
+    {
+        Float32,
+        Float16 // IEEE half precision, stored as unsigned short
+    };
+
+    /**
+     * @brief Caller-provided planar tensor to decode a frame into for inference, e.g. a CHW float input of a model or an image of a NCHW batch.
+     *        Each plane is Height rows of Width elements, the planes are packed one after another. Each sample is normalized as (sample / maximum - Mean) / Std,
+     *        where the maximum is 255 or the maximum of the bit depth of a 16bit monochrome frame. The frame is resized to fit the tensor, see FrameDecoder::getTensorRegion(),
+     *        and the elements outside the frame are set to PadValue.
+    */
+    struct TensorDestination
+    {
+        /**
+         * @brief First element of the first plane
+        */
+        void* Data = nullptr;
+
+        /**
+         * @brief Width of the tensor in element
+        */
+        int Width = 0;
+
+        /**
+         * @brief Height of the tensor in element
+        */
+        int Height = 0;
+
+        /**
+         * @brief Number of planes, 1 or 3. A monochrome frame is repeated in the 3 planes, a color frame can't be decoded into 1 plane. Default as 3
+        */
+        int Channels = 3;
+
+        /**
+         * @brief Element type. Default as TensorDataType::Float32
+        */
+        TensorDataType DataType = TensorDataType::Float32;
+
+        /**
+         * @brief Set it as true to store the planes in B, G, R order, otherwise R, G, B. Default as false.
+        */
+        bool BGR = false;
+
+        /**
+         * @brief Mean of each plane from 0 to 1, e.g. { 0.485f, 0.456f, 0.406f } of ImageNet in R, G, B order. Default as 0
+        */
+        std::array<float, 3> Mean = { 0.0f, 0.0f, 0.0f };
+
+        /**
+         * @brief Standard deviation of each plane, e.g. { 0.229f, 0.224f, 0.225f } of ImageNet in R, G, B order. It must not be 0. Default as 1
+        */
+        std::array<float, 3> Std = { 1.0f, 1.0f, 1.0f };
+
+        /**
+         * @brief Set it as true to keep the aspect ratio of the frame and pad the rest of the tensor, otherwise the frame is stretched to the tensor. Default as true.
+        */
+        bool Letterbox = true;
+
+        /**
+         * @brief Sample of the padded elements from 0 to 1 before the normalization, e.g. 114.0f / 255.0f of YOLO. Default as 0
+        */
+        float PadValue = 0.0f;
+
+        /**
+         * @brief Get the number of bytes per element of the element type
+         * @return Return the number of bytes per element
+        */
+        int getBytesPerElement() const
+        {
+            return DataType == TensorDataType::Float16 ? 2 : 4;
+        }
+
+        /**
+         * @brief Get the number of bytes of the tensor
+         * @return Return the number of bytes of all planes
+        */
+        long long getNumOfBytes() const
+        {
+            return (long long)Channels * Width * Height * getBytesPerElement();
+        }
+    };
+}
+
+//*******************************
+
+#endif
@@ -18,5 +18,17 @@ namespace DirectShowCamera
     {
         BGR = true;
         VerticalFlip = false;
+        HorizontalMirror = false;
+        ColorSpace = YUVColorSpace::BT601;
+        Palette = nullptr;
+        SourceBitDepth = 0;
+        SourceMSBJustified = false;
+        OutputBitDepth = 0;
+        Demosaic = BayerDemosaic::Bilinear;
+        Binning = 1;
+        ResizeWidth = 0;
+        ResizeHeight = 0;
+        Statistics = FrameStatisticsMode::None;
+        StatisticsSampleStep = 16;
     }
 }
\ No newline at end of file
@@ -9,8 +9,45 @@
 #define DIRECTSHOW_CAMERA__OPENCV_UTILS__FRAME__FRAME_SETTINGS_H
 
 //************Content************
+
+#include <array>
+#include <memory>
+
 namespace DirectShowCamera
 {
+    /**
+     * @brief Color matrix used to convert YUV frame data to RGB. Both are in the limited range (Y in 16-235).
+    */
+    enum class YUVColorSpace
+    {
+        BT601,
+        BT709
+    };
+
+    /**
+     * @brief Demosaic of the Bayer frames
+    */
+    enum class BayerDemosaic
+    {
+        Bilinear,   // Average of the nearest samples of each color, 3 x 3 neighborhood
+        EdgeAware   // Green interpolated along the smoother direction (Hamilton-Adams), red and blue gradient-corrected (Malvar-He-Cutler), 5 x 5 neighborhood
+    };
+
+    /**
+     * @brief Pixels sampled by the statistics accumulated while a frame is decoded
+    */
+    enum class FrameStatisticsMode
+    {
+        None,   // Not accumulated
+        Sparse, // Every n-th pixel of every n-th row, see FrameSettings::StatisticsSampleStep
+        Full    // All pixels. It costs about 5 - 9 times the decode time of a 3840x2160 frame on one core. Sparse is the only low overhead mode.
+    };
+
+    /**
+     * @brief Palette of the 8 bit RGB frames. 256 entries in B, G, R, reserved order as the RGBQUAD of VIDEOINFO::bmiColors.
+    */
+    typedef std::array<unsigned char, 256 * 4> RGBPalette;
+
     class FrameSettings
     {
     public:
@@ -35,12 +72,79 @@ namespace DirectShowCamera
         */
         bool VerticalFlip = false;
 
+        /**
+         * @brief Set it as true to mirror image horizontally. Default as false
+        */
+        bool HorizontalMirror = false;
+
+        /**
+         * @brief Color matrix used to convert YUV frame data to RGB. Default as YUVColorSpace::BT601
+        */
+        YUVColorSpace ColorSpace = YUVColorSpace::BT601;
+
+        /**
+         * @brief Palette used to decode the 8 bit RGB frames. It is set by Camera from the video format. Default as nullptr, the pixels are decoded as gray levels.
+        */
+        std::shared_ptr<const RGBPalette> Palette = nullptr;
+
+        /**
+         * @brief Significant bits of the 16bit monochrome and 16-bit Bayer samples, from 8 to 16. It is ignored by the packed types, e.g. Y10P. Default as 0, use the bit depth of the video type, e.g. 16 for Y16.
+        */
+        int SourceBitDepth = 0;
+
+        /**
+         * @brief Set it as true if the significant bits of the 16bit monochrome and 16-bit Bayer samples are stored in the high bits. It is ignored by the packed types. Default as false.
+        */
+        bool SourceMSBJustified = false;
+
+        /**
+         * @brief Bit depth of the decoded 16bit monochrome samples, from 8 to 16. The samples are shifted or scaled to it and stored in the low bits. Default as 0, keep the source bit depth.
+        */
+        int OutputBitDepth = 0;
+
+        /**
+         * @brief Demosaic of the Bayer frames. Default as BayerDemosaic::Bilinear
+        */
+        BayerDemosaic Demosaic = BayerDemosaic::Bilinear;
+
+        /**
+         * @brief Average each Binning x Binning block of pixels into a pixel while the frame is decoded, e.g. 2 for a half size preview. It must be 1, 2 or 4.
+         *        The pixels at the right and the bottom of the decoded frame which don't fill a block are dropped. It is ignored if ResizeWidth and ResizeHeight are set. Default as 1, not binned.
+        */
+        int Binning = 1;
+
+        /**
+         * @brief Width of the frame resized by area averaging while the frame is decoded, e.g. 640 for a preview of a 3840 x 2160 frame.
+         *        It must not be larger than the frame width. Set it with ResizeHeight. Default as 0, not resized.
+        */
+        int ResizeWidth = 0;
+
+        /**
+         * @brief Height of the frame resized by area averaging while the frame is decoded, e.g. 360 for a preview of a 3840 x 2160 frame.
+         *        It must not be larger than the frame height. Set it with ResizeWidth. Default as 0, not resized.
+        */
+        int ResizeHeight = 0;
+
+        /**
+         * @brief Accumulate the histograms, means, minimums, maximums and saturated pixels of the decoded frame while it is decoded, see FrameStatistics.
+         *        The statistics are of the decoded frame, i.e. after binning or resizing. Default as FrameStatisticsMode::None, not accumulated.
+        */
+        FrameStatisticsMode Statistics = FrameStatisticsMode::None;
+
+        /**
+         * @brief Sample every n-th pixel of every n-th row in FrameStatisticsMode::Sparse. It must be >= 1. Default as 16, i.e. 1 of 256 pixels, which is enough for auto exposure and costs a few percent of the decode time.
+        */
+        int StatisticsSampleStep = 16;
+
         /**
         * @brief equal operator
         */
         bool operator==(const FrameSettings& other) const
         {
-            return BGR == other.BGR && VerticalFlip == other.VerticalFlip;
+            return BGR == other.BGR && VerticalFlip == other.VerticalFlip && HorizontalMirror == other.HorizontalMirror && ColorSpace == other.ColorSpace && Palette == other.Palette &&
+                SourceBitDepth == other.SourceBitDepth && SourceMSBJustified == other.SourceMSBJustified && OutputBitDepth == other.OutputBitDepth && Demosaic == other.Demosaic &&
+                Binning == other.Binning && ResizeWidth == other.ResizeWidth && ResizeHeight == other.ResizeHeight && Statistics == other.Statistics &&
+                StatisticsSampleStep == other.StatisticsSampleStep;
         }
 
         /**
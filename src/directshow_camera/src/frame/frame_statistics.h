@@ -0,0 +1,91 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__FRAME_STATISTICS_H
+#define DIRECTSHOW_CAMERA__FRAME__FRAME_STATISTICS_H
+
+//************Content************
+
+#include <array>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Statistics of a decoded frame, accumulated while the frame is decoded. See FrameSettings::Statistics.
+     *        The channels are in the order of the decoded pixels, e.g. B, G, R if FrameSettings::BGR is true. The statistics are of the sampled pixels only.
+    */
+    struct FrameStatistics
+    {
+        /**
+         * @brief Maximum number of channels
+        */
+        static constexpr int MaxChannels = 3;
+
+        /**
+         * @brief Number of histogram bins
+        */
+        static constexpr int NumOfBins = 256;
+
+        /**
+         * @brief Number of channels, 1 or 3. 0 if the statistics are not accumulated.
+        */
+        int Channels = 0;
+
+        /**
+         * @brief Bit depth of the samples, e.g. 8, or the bit depth of the decoded 16bit monochrome samples
+        */
+        int BitDepth = 8;
+
+        /**
+         * @brief Number of sampled pixels
+        */
+        long long NumOfPixels = 0;
+
+        /**
+         * @brief 256-bin histogram of each channel. The bin of a sample is sample >> (BitDepth - 8).
+        */
+        std::array<std::array<unsigned int, NumOfBins>, MaxChannels> Histograms = {};
+
+        /**
+         * @brief Mean of each channel
+        */
+        std::array<double, MaxChannels> Means = {};
+
+        /**
+         * @brief Minimum of each channel
+        */
+        std::array<int, MaxChannels> Mins = {};
+
+        /**
+         * @brief Maximum of each channel
+        */
+        std::array<int, MaxChannels> Maxs = {};
+
+        /**
+         * @brief Number of saturated samples of each channel, i.e. samples at the maximum of the bit depth
+        */
+        std::array<long long, MaxChannels> NumOfSaturatedSamples = {};
+
+        /**
+         * @brief Number of pixels with any channel saturated
+        */
+        long long NumOfSaturatedPixels = 0;
+
+        /**
+         * @brief Get the fraction of the sampled pixels with any channel saturated
+         * @return Return the fraction from 0 to 1. Return 0 if no pixel is sampled.
+        */
+        double getSaturatedFraction() const
+        {
+            return NumOfPixels > 0 ? (double)NumOfSaturatedPixels / (double)NumOfPixels : 0.0;
+        }
+    };
+}
+
+//*******************************
+
+#endif
@@ -0,0 +1,333 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__FRAME_SUBTYPE_REGISTRY_H
+#define DIRECTSHOW_CAMERA__FRAME__FRAME_SUBTYPE_REGISTRY_H
+
+//************Content************
+
+#include <guiddef.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+#include "frame/frame_decoder.h"
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Family of a media subtype
+    */
+    enum class FrameSubtypeFamily
+    {
+        Unknown,
+        Monochrome8bit,
+        Monochrome16bit,
+        RGB,
+        YUV422,
+        YUV420,
+        MJPEG,
+        Bayer
+    };
+
+    /**
+     * @brief Decode function of a media subtype.
+     *        Arguments are input data, output data, width, height, number of bytes per output row (0 if the rows are packed), frame settings and
+     *        the statistics accumulator of the decoded frame (nullptr if the statistics are not accumulated) and
+     *        the tensor written instead of the output data (nullptr if the output data is written). See FrameDecoder::DecodeFrame() and FrameDecoder::DecodeFrameToTensor().
+    */
+    typedef void (*FrameDecodeFunction)(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const FrameSettings& frameSettings,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    );
+
+    /**
+     * @brief Traits of a media subtype
+    */
+    struct FrameSubtypeTraits
+    {
+        /**
+         * @brief Media subtype
+        */
+        GUID Subtype;
+
+        /**
+         * @brief Family of the subtype
+        */
+        FrameSubtypeFamily Family;
+
+        /**
+         * @brief Bits per pixel of the frame data. Subtypes converted to RGB24 by the sample grabber are stored in 24 bits.
+         *        It is not equal to DecodedBytesPerPixel * 8 if the frame data is kept in the capture format.
+         *        A compressed frame is stored in a buffer of this size and its payload may be shorter.
+        */
+        int BitsPerPixel;
+
+        /**
+         * @brief Bytes per pixel of the decoded image
+        */
+        int DecodedBytesPerPixel;
+
+        /**
+         * @brief Significant bits per sample of the decoded image before the bit depth conversion of FrameSettings
+        */
+        int BitDepth;
+
+        /**
+         * @brief Decode function
+        */
+        FrameDecodeFunction Decode;
+    };
+
+    /**
+     * @brief A compile-time registry of the media subtypes supported by FrameDecoder.
+     *
+     * The subtypes are indexed by a hash of GUID::Data1 (FourCC or the RGB subtype index) which is built at compile time,
+     * so a lookup is O(1) and doesn't allocate.
+     */
+    class FrameSubtypeRegistry
+    {
+    public:
+
+#pragma region Lookup
+
+        /**
+         * @brief Find the traits of a subtype
+         * @param[in] subtype Media subtype
+         * @return Return the traits. Return nullptr if the subtype is not supported.
+        */
+        static constexpr const FrameSubtypeTraits* Find(const GUID& subtype);
+
+        /**
+         * @brief Find the traits of a subtype in a family
+         * @param[in] subtype Media subtype
+         * @param[in] family Family
+         * @return Return the traits. Return nullptr if the subtype is not supported or not in the family.
+        */
+        static constexpr const FrameSubtypeTraits* Find(const GUID& subtype, const FrameSubtypeFamily family);
+
+        /**
+         * @brief Get the family of a subtype
+         * @param[in] subtype Media subtype
+         * @return Return the family. Return FrameSubtypeFamily::Unknown if the subtype is not supported.
+        */
+        static constexpr FrameSubtypeFamily getFamily(const GUID& subtype);
+
+        /**
+         * @brief Get all registered subtypes
+         * @return Return the traits of all subtypes
+        */
+        static constexpr std::span<const FrameSubtypeTraits> getAll();
+
+#pragma endregion Lookup
+
+    private:
+
+        /**
+         * @brief Number of slots of the hash table. It must be a power of 2 and larger than the number of subtypes.
+        */
+        static constexpr int HASH_TABLE_SIZE = 64;
+
+        /**
+         * @brief Create a FourCC subtype GUID
+         * @param[in] fourCC FourCC
+         * @return Return the GUID
+        */
+        static constexpr GUID FourCCSubtype(const std::uint32_t fourCC);
+
+        /**
+         * @brief Create an uncompressed RGB subtype GUID
+         * @param[in] data1 GUID::Data1
+         * @return Return the GUID
+        */
+        static constexpr GUID RGBSubtype(const std::uint32_t data1);
+
+        /**
+         * @brief Compare 2 GUIDs
+         * @param[in] guid1 GUID
+         * @param[in] guid2 GUID
+         * @return Return true if they are equal
+        */
+        static constexpr bool isEqual(const GUID& guid1, const GUID& guid2);
+
+        /**
+         * @brief Get the hash table slot of a GUID::Data1
+         * @param[in] data1 GUID::Data1
+         * @return Return the slot
+        */
+        static constexpr int Hash(const std::uint32_t data1);
+
+        /**
+         * @brief Build the hash table by linear probing. A slot stores the index of the subtype, -1 if empty.
+         * @return Return the hash table
+        */
+        static constexpr std::array<signed char, HASH_TABLE_SIZE> BuildHashTable();
+
+        static const std::array<FrameSubtypeTraits, 26> SUBTYPES;
+        static const std::array<signed char, HASH_TABLE_SIZE> HASH_TABLE;
+    };
+
+#pragma region Private
+
+    constexpr GUID FrameSubtypeRegistry::FourCCSubtype(const std::uint32_t fourCC)
+    {
+        return { fourCC, 0x0000, 0x0010, { 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 } };
+    }
+
+    constexpr GUID FrameSubtypeRegistry::RGBSubtype(const std::uint32_t data1)
+    {
+        return { data1, 0x524f, 0x11ce, { 0x9f, 0x53, 0x00, 0x20, 0xaf, 0x0b, 0xa7, 0x70 } };
+    }
+
+    constexpr bool FrameSubtypeRegistry::isEqual(const GUID& guid1, const GUID& guid2)
+    {
+        if (guid1.Data1 != guid2.Data1 || guid1.Data2 != guid2.Data2 || guid1.Data3 != guid2.Data3) return false;
+        for (int i = 0; i < 8; i++)
+        {
+            if (guid1.Data4[i] != guid2.Data4[i]) return false;
+        }
+        return true;
+    }
+
+    constexpr int FrameSubtypeRegistry::Hash(const std::uint32_t data1)
+    {
+        // Fibonacci hashing, take the top 6 bits
+        return (int)((data1 * 2654435769u) >> 26) & (HASH_TABLE_SIZE - 1);
+    }
+
+    // Order of the subtypes is the order returned by FrameDecoder::SupportVideoType()
+    inline constexpr std::array<FrameSubtypeTraits, 26> FrameSubtypeRegistry::SUBTYPES = { {
+        // 8bit Monochrome
+        { FourCCSubtype(0x30303859), FrameSubtypeFamily::Monochrome8bit, 8, 1, 8, FrameDecoder::DecodeMonochromeKernel },   // Y800
+        { FourCCSubtype(0x20203859), FrameSubtypeFamily::Monochrome8bit, 8, 1, 8, FrameDecoder::DecodeMonochromeKernel },   // Y8
+        { FourCCSubtype(0x59455247), FrameSubtypeFamily::Monochrome8bit, 8, 1, 8, FrameDecoder::DecodeMonochromeKernel },   // GREY
+
+        // 16bit Monochrome. The samples are converted to the bit depth of FrameSettings.
+        { FourCCSubtype(0x20363159), FrameSubtypeFamily::Monochrome16bit, 16, 2, 16, FrameDecoder::Decode16BitMonochromeKernel }, // Y16
+        { FourCCSubtype(0x20303159), FrameSubtypeFamily::Monochrome16bit, 16, 2, 10, FrameDecoder::DecodeY10Kernel },              // Y10
+        { FourCCSubtype(0x20323159), FrameSubtypeFamily::Monochrome16bit, 16, 2, 12, FrameDecoder::DecodeY12Kernel },              // Y12
+        { FourCCSubtype(0x50303159), FrameSubtypeFamily::Monochrome16bit, 10, 2, 10, FrameDecoder::DecodeY10PKernel },           // Y10P
+        { FourCCSubtype(0x50323159), FrameSubtypeFamily::Monochrome16bit, 12, 2, 12, FrameDecoder::DecodeY12PKernel },           // Y12P
+
+        // RGB. RGB8, RGB565 and RGB555 are kept in the capture format by DirectShowCamera::setRawRGBCapture(), otherwise they are converted to RGB24 by the sample grabber.
+        { RGBSubtype(0xe436eb7a), FrameSubtypeFamily::RGB, 8, 3, 8, FrameDecoder::DecodeRGB8Kernel },     // RGB8
+        { RGBSubtype(0xe436eb7b), FrameSubtypeFamily::RGB, 16, 3, 8, FrameDecoder::DecodeRGB565Kernel },  // RGB565
+        { RGBSubtype(0xe436eb7c), FrameSubtypeFamily::RGB, 16, 3, 8, FrameDecoder::DecodeRGB555Kernel },  // RGB555
+        { RGBSubtype(0xe436eb7d), FrameSubtypeFamily::RGB, 24, 3, 8, FrameDecoder::DecodeBGR24Kernel },   // RGB24
+
+        // YUV 4:2:2. They are kept in YUV by DirectShowCamera::setRawYUVCapture(), otherwise they are converted to RGB24 by the sample grabber.
+        { FourCCSubtype(0x32595559), FrameSubtypeFamily::YUV422, 16, 3, 8, FrameDecoder::DecodeYUY2Kernel },  // YUY2
+        { FourCCSubtype(0x59565955), FrameSubtypeFamily::YUV422, 16, 3, 8, FrameDecoder::DecodeUYVYKernel },  // UYVY
+
+        // YUV 4:2:0. They are kept in YUV by DirectShowCamera::setRawYUVCapture(), otherwise they are converted to RGB24 by the sample grabber.
+        { FourCCSubtype(0x3231564E), FrameSubtypeFamily::YUV420, 12, 3, 8, FrameDecoder::DecodeNV12Kernel },  // NV12
+        { FourCCSubtype(0x30323449), FrameSubtypeFamily::YUV420, 12, 3, 8, FrameDecoder::DecodeI420Kernel },  // I420
+        { FourCCSubtype(0x56555949), FrameSubtypeFamily::YUV420, 12, 3, 8, FrameDecoder::DecodeI420Kernel },  // IYUV
+
+        // MJPEG. It is kept compressed by DirectShowCamera::setRawMJPGCapture() in a buffer of BitsPerPixel, otherwise it is converted to RGB24 by the sample grabber.
+        { FourCCSubtype(0x47504A4D), FrameSubtypeFamily::MJPEG, 24, 3, 8, FrameDecoder::DecodeMJPGKernel },   // MJPG
+
+        // Bayer. They are kept in the capture format and demosaiced by FrameSettings::Demosaic. 16bit samples are scaled to 8 bit by the bit depth of FrameSettings.
+        { FourCCSubtype(0x42474752), FrameSubtypeFamily::Bayer, 8, 3, 8, FrameDecoder::DecodeBayerKernel<BayerPattern::RGGB, 8> },    // RGGB
+        { FourCCSubtype(0x31384142), FrameSubtypeFamily::Bayer, 8, 3, 8, FrameDecoder::DecodeBayerKernel<BayerPattern::BGGR, 8> },    // BA81
+        { FourCCSubtype(0x47425247), FrameSubtypeFamily::Bayer, 8, 3, 8, FrameDecoder::DecodeBayerKernel<BayerPattern::GRBG, 8> },    // GRBG
+        { FourCCSubtype(0x47524247), FrameSubtypeFamily::Bayer, 8, 3, 8, FrameDecoder::DecodeBayerKernel<BayerPattern::GBRG, 8> },    // GBRG
+        { FourCCSubtype(0x36314752), FrameSubtypeFamily::Bayer, 16, 3, 8, FrameDecoder::DecodeBayerKernel<BayerPattern::RGGB, 16> },  // RG16
+        { FourCCSubtype(0x32525942), FrameSubtypeFamily::Bayer, 16, 3, 8, FrameDecoder::DecodeBayerKernel<BayerPattern::BGGR, 16> },  // BYR2
+        { FourCCSubtype(0x36315247), FrameSubtypeFamily::Bayer, 16, 3, 8, FrameDecoder::DecodeBayerKernel<BayerPattern::GRBG, 16> },  // GR16
+        { FourCCSubtype(0x36314247), FrameSubtypeFamily::Bayer, 16, 3, 8, FrameDecoder::DecodeBayerKernel<BayerPattern::GBRG, 16> }   // GB16
+    } };
+
+    constexpr std::array<signed char, FrameSubtypeRegistry::HASH_TABLE_SIZE> FrameSubtypeRegistry::BuildHashTable()
+    {
+        static_assert(std::tuple_size_v<decltype(SUBTYPES)> < HASH_TABLE_SIZE, "Hash table of FrameSubtypeRegistry is full.");
+
+        std::array<signed char, HASH_TABLE_SIZE> hashTable{};
+        for (auto& slot : hashTable) slot = -1;
+
+        for (int i = 0; i < (int)SUBTYPES.size(); i++)
+        {
+            // Data1 must be unique
+            for (int j = 0; j < i; j++)
+            {
+                if (SUBTYPES[j].Subtype.Data1 == SUBTYPES[i].Subtype.Data1) throw std::logic_error("Duplicated subtype.");
+            }
+
+            // Linear probing
+            int slot = Hash(SUBTYPES[i].Subtype.Data1);
+            while (hashTable[slot] >= 0) slot = (slot + 1) & (HASH_TABLE_SIZE - 1);
+            hashTable[slot] = (signed char)i;
+        }
+
+        return hashTable;
+    }
+
+    inline constexpr std::array<signed char, FrameSubtypeRegistry::HASH_TABLE_SIZE> FrameSubtypeRegistry::HASH_TABLE = BuildHashTable();
+
+#pragma endregion Private
+
+#pragma region Lookup
+
+    constexpr const FrameSubtypeTraits* FrameSubtypeRegistry::Find(const GUID& subtype)
+    {
+        // The table is never full, so an empty slot ends the probing
+        int slot = Hash(subtype.Data1);
+        while (HASH_TABLE[slot] >= 0)
+        {
+            const auto& traits = SUBTYPES[HASH_TABLE[slot]];
+            if (traits.Subtype.Data1 == subtype.Data1)
+            {
+                return isEqual(traits.Subtype, subtype) ? &traits : nullptr;
+            }
+            slot = (slot + 1) & (HASH_TABLE_SIZE - 1);
+        }
+        return nullptr;
+    }
+
+    constexpr const FrameSubtypeTraits* FrameSubtypeRegistry::Find(const GUID& subtype, const FrameSubtypeFamily family)
+    {
+        const auto traits = Find(subtype);
+        return traits != nullptr && traits->Family == family ? traits : nullptr;
+    }
+
+    constexpr FrameSubtypeFamily FrameSubtypeRegistry::getFamily(const GUID& subtype)
+    {
+        const auto traits = Find(subtype);
+        return traits != nullptr ? traits->Family : FrameSubtypeFamily::Unknown;
+    }
+
+    constexpr std::span<const FrameSubtypeTraits> FrameSubtypeRegistry::getAll()
+    {
+        return SUBTYPES;
+    }
+
+#pragma endregion Lookup
+
+    // Every registered subtype can be found
+    static_assert(
+        []() {
+            for (const auto& traits : FrameSubtypeRegistry::getAll())
+            {
+                if (FrameSubtypeRegistry::Find(traits.Subtype) != &traits) return false;
+            }
+            return true;
+        }(),
+        "FrameSubtypeRegistry lookup is broken."
+    );
+}
+
+//*******************************
+
+#endif
@@ -0,0 +1,769 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "frame/jpeg_decoder.h"
+#include "frame/jpeg_standard_tables.h"
+
+#include "utils/thread_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace DirectShowCamera
+{
+    namespace
+    {
+        /**
+         * @brief Number of bits looked up at once by the Huffman decoder
+        */
+        constexpr int FAST_BITS = 9;
+
+        /**
+         * @brief A Huffman table. Codes up to FAST_BITS are decoded by a lookup, longer codes are decoded by the maximum code of each length.
+        */
+        struct HuffmanTable
+        {
+            bool IsDefined = false;
+            unsigned char Fast[1 << FAST_BITS];
+            unsigned short Codes[256];
+            unsigned char Values[256];
+            unsigned char Sizes[257];
+            unsigned int MaxCode[18];
+            int Delta[17];
+        };
+
+        /**
+         * @brief Build a Huffman table
+         * @param[out] table Huffman table
+         * @param[in] counts Number of codes of each length from 1 to 16 bits
+         * @param[in] values Symbols in the code order
+        */
+        void BuildHuffmanTable(HuffmanTable& table, const unsigned char counts[16], const unsigned char* values)
+        {
+            // Code lengths
+            int numOfCodes = 0;
+            for (int i = 0; i < 16; i++)
+            {
+                numOfCodes += counts[i];
+                if (numOfCodes > 256) throw std::invalid_argument("JPEG Huffman table has more than 256 codes.");
+                for (int j = numOfCodes - counts[i]; j < numOfCodes; j++) table.Sizes[j] = (unsigned char)(i + 1);
+            }
+            table.Sizes[numOfCodes] = 0;
+
+            // Canonical codes
+            int code = 0;
+            int k = 0;
+            for (int length = 1; length <= 16; length++)
+            {
+                table.Delta[length] = k - code;
+                if (table.Sizes[k] == length)
+                {
+                    while (table.Sizes[k] == length) table.Codes[k++] = (unsigned short)code++;
+                    if (code - 1 >= (1 << length)) throw std::invalid_argument("JPEG Huffman table is invalid.");
+                }
+                table.MaxCode[length] = (unsigned int)code << (16 - length);
+                code <<= 1;
+            }
+            table.MaxCode[17] = 0xFFFFFFFF;
+
+            // Lookup of the short codes
+            std::memcpy(table.Values, values, numOfCodes);
+            std::memset(table.Fast, 255, sizeof(table.Fast));
+            for (int i = 0; i < numOfCodes; i++)
+            {
+                const int size = table.Sizes[i];
+                if (size > FAST_BITS) continue;
+
+                const int first = table.Codes[i] << (FAST_BITS - size);
+                std::memset(table.Fast + first, i, (size_t)1 << (FAST_BITS - size));
+            }
+            table.IsDefined = true;
+        }
+
+        /**
+         * @brief Read the entropy coded data of a restart interval segment. Stuffed zeros are removed and zeros are returned after the segment.
+        */
+        class BitReader
+        {
+        public:
+            BitReader(const unsigned char* data, const unsigned char* end) :
+                m_data(data),
+                m_end(end)
+            {
+            }
+
+            /**
+             * @brief Decode a Huffman symbol
+             * @param[in] table Huffman table
+             * @return Return the symbol. Return -1 if the code is invalid.
+            */
+            int Decode(const HuffmanTable& table)
+            {
+                Fill();
+
+                // Short code
+                const int fast = table.Fast[m_buffer >> (32 - FAST_BITS)];
+                if (fast < 255)
+                {
+                    Consume(table.Sizes[fast]);
+                    return table.Values[fast];
+                }
+
+                // Long code
+                const unsigned int code16 = m_buffer >> 16;
+                int size = FAST_BITS + 1;
+                while (code16 >= table.MaxCode[size]) size++;
+                if (size == 17) return -1;
+
+                const int index = (int)(m_buffer >> (32 - size)) + table.Delta[size];
+                if (index < 0 || index > 255) return -1;
+                Consume(size);
+                return table.Values[index];
+            }
+
+            /**
+             * @brief Read a signed value of a number of bits
+             * @param[in] size Number of bits, 0 to 16
+             * @return Return the value
+            */
+            int ReceiveExtend(const int size)
+            {
+                if (size == 0) return 0;
+
+                Fill();
+                const int value = (int)(m_buffer >> (32 - size));
+                Consume(size);
+                return value < (1 << (size - 1)) ? value - (1 << size) + 1 : value;
+            }
+
+        private:
+            void Fill()
+            {
+                while (m_numOfBits <= 24)
+                {
+                    unsigned int byte = 0;
+                    if (m_data < m_end)
+                    {
+                        byte = *m_data++;
+                        if (byte == 0xFF)
+                        {
+                            // 0xFF is followed by a stuffed zero, otherwise it is a fill byte before a marker
+                            if (m_data < m_end && *m_data == 0x00)
+                            {
+                                m_data++;
+                            }
+                            else
+                            {
+                                byte = 0;
+                                m_data = m_end;
+                            }
+                        }
+                    }
+                    m_buffer |= byte << (24 - m_numOfBits);
+                    m_numOfBits += 8;
+                }
+            }
+
+            void Consume(const int size)
+            {
+                m_buffer <<= size;
+                m_numOfBits -= size;
+            }
+
+            const unsigned char* m_data;
+            const unsigned char* m_end;
+            unsigned int m_buffer = 0;
+            int m_numOfBits = 0;
+        };
+
+        /**
+         * @brief Component of a frame
+        */
+        struct JPEGComponent
+        {
+            int Id = 0;
+            int H = 1;
+            int V = 1;
+            int QuantizationTable = 0;
+            int DCTable = 0;
+            int ACTable = 0;
+        };
+
+        /**
+         * @brief Tables and parameters of a JPEG image
+        */
+        struct JPEGHeader
+        {
+            int Width = 0;
+            int Height = 0;
+            int NumOfComponents = 0;
+            JPEGComponent Components[3];
+            int MaxH = 1;
+            int MaxV = 1;
+            int RestartInterval = 0;
+            bool HasQuantizationTable[4] = { false, false, false, false };
+            unsigned short QuantizationTables[4][64];   // Zigzag order
+            HuffmanTable DCTables[4];
+            HuffmanTable ACTables[4];
+        };
+
+        int ReadUInt16(const unsigned char* data)
+        {
+            return (data[0] << 8) | data[1];
+        }
+
+        void ParseFrameHeader(const unsigned char* segment, const int length, JPEGHeader& header)
+        {
+            if (length < 6) throw std::invalid_argument("JPEG frame header is truncated.");
+            if (segment[0] != 8) throw std::invalid_argument("JPEG precision(" + std::to_string(segment[0]) + ") is not supported. Only 8 bit is supported.");
+
+            header.Height = ReadUInt16(segment + 1);
+            header.Width = ReadUInt16(segment + 3);
+            header.NumOfComponents = segment[5];
+            if (header.Width <= 0 || header.Height <= 0) throw std::invalid_argument("JPEG size(" + std::to_string(header.Width) + "x" + std::to_string(header.Height) + ") is not supported.");
+            if (header.NumOfComponents != 1 && header.NumOfComponents != 3) throw std::invalid_argument("JPEG number of components(" + std::to_string(header.NumOfComponents) + ") is not supported.");
+            if (length < 6 + header.NumOfComponents * 3) throw std::invalid_argument("JPEG frame header is truncated.");
+
+            for (int i = 0; i < header.NumOfComponents; i++)
+            {
+                const unsigned char* component = segment + 6 + i * 3;
+                auto& result = header.Components[i];
+                result.Id = component[0];
+                result.H = component[1] >> 4;
+                result.V = component[1] & 15;
+                result.QuantizationTable = component[2];
+                if (result.H < 1 || result.H > 2 || result.V < 1 || result.V > 2) throw std::invalid_argument("JPEG sampling factor(" + std::to_string(result.H) + "x" + std::to_string(result.V) + ") is not supported.");
+                if (result.QuantizationTable > 3) throw std::invalid_argument("JPEG quantization table(" + std::to_string(result.QuantizationTable) + ") is invalid.");
+            }
+
+            // A single component scan is not interleaved, its MCU is a block
+            if (header.NumOfComponents == 1)
+            {
+                header.Components[0].H = 1;
+                header.Components[0].V = 1;
+            }
+            for (int i = 0; i < header.NumOfComponents; i++)
+            {
+                header.MaxH = std::max(header.MaxH, header.Components[i].H);
+                header.MaxV = std::max(header.MaxV, header.Components[i].V);
+            }
+        }
+
+        void ParseQuantizationTables(const unsigned char* segment, const int length, JPEGHeader& header)
+        {
+            int i = 0;
+            while (i < length)
+            {
+                const int precision = segment[i] >> 4;
+                const int index = segment[i] & 15;
+                const int tableSize = precision == 0 ? 64 : 128;
+                if (index > 3 || i + 1 + tableSize > length) throw std::invalid_argument("JPEG quantization table is invalid.");
+
+                for (int k = 0; k < 64; k++)
+                {
+                    header.QuantizationTables[index][k] = (unsigned short)(precision == 0 ? segment[i + 1 + k] : ReadUInt16(segment + i + 1 + k * 2));
+                }
+                header.HasQuantizationTable[index] = true;
+                i += 1 + tableSize;
+            }
+        }
+
+        void ParseHuffmanTables(const unsigned char* segment, const int length, JPEGHeader& header)
+        {
+            int i = 0;
+            while (i < length)
+            {
+                if (i + 17 > length) throw std::invalid_argument("JPEG Huffman table is truncated.");
+
+                const int tableClass = segment[i] >> 4;
+                const int index = segment[i] & 15;
+                if (tableClass > 1 || index > 3) throw std::invalid_argument("JPEG Huffman table is invalid.");
+
+                const unsigned char* counts = segment + i + 1;
+                int numOfCodes = 0;
+                for (int k = 0; k < 16; k++) numOfCodes += counts[k];
+                if (i + 17 + numOfCodes > length) throw std::invalid_argument("JPEG Huffman table is truncated.");
+
+                BuildHuffmanTable(tableClass == 0 ? header.DCTables[index] : header.ACTables[index], counts, segment + i + 17);
+                i += 17 + numOfCodes;
+            }
+        }
+
+        void ParseScanHeader(const unsigned char* segment, const int length, JPEGHeader& header)
+        {
+            if (header.NumOfComponents == 0) throw std::invalid_argument("JPEG scan is found before the frame header.");
+            if (length < 1 || length < 1 + segment[0] * 2) throw std::invalid_argument("JPEG scan header is truncated.");
+            if (segment[0] != header.NumOfComponents) throw std::invalid_argument("JPEG with multiple scans is not supported.");
+
+            for (int i = 0; i < header.NumOfComponents; i++)
+            {
+                const int id = segment[1 + i * 2];
+                const int tables = segment[2 + i * 2];
+                auto component = std::find_if(header.Components, header.Components + header.NumOfComponents, [id](const JPEGComponent& c) { return c.Id == id; });
+                if (component == header.Components + header.NumOfComponents) throw std::invalid_argument("JPEG scan component(" + std::to_string(id) + ") is not found.");
+                component->DCTable = tables >> 4;
+                component->ACTable = tables & 15;
+                if (component->DCTable > 3 || component->ACTable > 3) throw std::invalid_argument("JPEG Huffman table selector is invalid.");
+            }
+        }
+
+        /**
+         * @brief Parse the markers until the frame header or the scan
+         * @param[in] data JPEG data
+         * @param[in] numOfBytes Number of bytes
+         * @param[out] header Header
+         * @param[in] isFrameHeaderOnly Stop at the frame header
+         * @return Return the beginning of the entropy coded data. Return the end of the frame header if isFrameHeaderOnly is true.
+        */
+        const unsigned char* ParseHeader(const unsigned char* data, const int numOfBytes, JPEGHeader& header, const bool isFrameHeaderOnly)
+        {
+            const unsigned char* end = data + numOfBytes;
+            if (numOfBytes < 4 || data[0] != 0xFF || data[1] != 0xD8) throw std::invalid_argument("JPEG SOI marker is not found.");
+
+            const unsigned char* p = data + 2;
+            while (true)
+            {
+                // Marker, skip the fill bytes
+                if (p >= end || *p != 0xFF) throw std::invalid_argument("JPEG marker is not found.");
+                while (p < end && *p == 0xFF) p++;
+                if (p >= end) throw std::invalid_argument("JPEG data is truncated.");
+                const int marker = *p++;
+
+                // Markers without a segment
+                if (marker == 0xD9) throw std::invalid_argument("JPEG scan is not found.");
+                if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) continue;
+
+                // Segment
+                if (p + 2 > end) throw std::invalid_argument("JPEG data is truncated.");
+                const int length = ReadUInt16(p);
+                if (length < 2 || p + length > end) throw std::invalid_argument("JPEG data is truncated.");
+                const unsigned char* segment = p + 2;
+                const int segmentLength = length - 2;
+                p += length;
+
+                switch (marker)
+                {
+                case 0xC0:  // Baseline
+                case 0xC1:  // Extended sequential, Huffman
+                    ParseFrameHeader(segment, segmentLength, header);
+                    if (isFrameHeaderOnly) return p;
+                    break;
+                case 0xC2: case 0xC3: case 0xC5: case 0xC6: case 0xC7:
+                case 0xC9: case 0xCA: case 0xCB: case 0xCD: case 0xCE: case 0xCF:
+                    throw std::invalid_argument("JPEG process(SOF" + std::to_string(marker - 0xC0) + ") is not supported. Only baseline JPEG is supported.");
+                case 0xC4:
+                    ParseHuffmanTables(segment, segmentLength, header);
+                    break;
+                case 0xDB:
+                    ParseQuantizationTables(segment, segmentLength, header);
+                    break;
+                case 0xDD:
+                    if (segmentLength < 2) throw std::invalid_argument("JPEG restart interval is truncated.");
+                    header.RestartInterval = ReadUInt16(segment);
+                    break;
+                case 0xDA:
+                    ParseScanHeader(segment, segmentLength, header);
+                    return p;
+                default:
+                    // APPn, COM and the others
+                    break;
+                }
+            }
+        }
+
+        /**
+         * @brief Use the standard Huffman tables if they are not defined, as MJPEG frames usually don't have them.
+        */
+        void SetDefaultHuffmanTables(JPEGHeader& header)
+        {
+            using namespace JPEGStandardTables;
+            if (!header.DCTables[0].IsDefined) BuildHuffmanTable(header.DCTables[0], DC_LUMINANCE_COUNTS, DC_LUMINANCE_VALUES);
+            if (!header.DCTables[1].IsDefined) BuildHuffmanTable(header.DCTables[1], DC_CHROMINANCE_COUNTS, DC_CHROMINANCE_VALUES);
+            if (!header.ACTables[0].IsDefined) BuildHuffmanTable(header.ACTables[0], AC_LUMINANCE_COUNTS, AC_LUMINANCE_VALUES);
+            if (!header.ACTables[1].IsDefined) BuildHuffmanTable(header.ACTables[1], AC_CHROMINANCE_COUNTS, AC_CHROMINANCE_VALUES);
+        }
+
+        /**
+         * @brief Scaled IDCT tables. IDCT_TABLES[scale][x][u] = C(u) / 2 * cos((2x + 1)u * pi / 2N), N = 8 >> scale.
+         *        An N point IDCT of the N lowest frequencies gives the 8 / N downscaled block.
+        */
+        const std::array<std::array<std::array<float, 8>, 8>, 4> IDCT_TABLES = []()
+        {
+            const double pi = 3.14159265358979323846;
+            std::array<std::array<std::array<float, 8>, 8>, 4> tables{};
+            for (int scale = 0; scale < 4; scale++)
+            {
+                const int n = 8 >> scale;
+                for (int x = 0; x < n; x++)
+                {
+                    for (int u = 0; u < n; u++)
+                    {
+                        const double c = u == 0 ? std::sqrt(0.5) : 1.0;
+                        tables[scale][x][u] = (float)(c / 2 * std::cos((2 * x + 1) * u * pi / (2 * n)));
+                    }
+                }
+            }
+            return tables;
+        }();
+
+        /**
+         * @brief Decode a segment into the output
+        */
+        class SegmentDecoder
+        {
+        public:
+            SegmentDecoder(
+                const JPEGHeader& header,
+                unsigned char* outputData,
+                const YUVOutputFormat outputFormat,
+                const JPEGScale scale,
+                const bool verticalFlip,
+                const bool horizontalMirror,
+                const int outputBytesPerRow
+            ) :
+                m_header(header),
+                m_outputData(outputData),
+                m_outputFormat(outputFormat),
+                m_bytesPerPixel(YUVKernel::getBytesPerPixel(outputFormat)),
+                m_scale(scale),
+                m_blockSize(8 >> (int)scale),
+                m_outputWidth(JPEGDecoder::getScaledSize(header.Width, scale)),
+                m_outputHeight(JPEGDecoder::getScaledSize(header.Height, scale)),
+                m_verticalFlip(verticalFlip),
+                m_horizontalMirror(horizontalMirror),
+                m_outputBytesPerRow(outputBytesPerRow > 0 ? outputBytesPerRow : m_outputWidth * m_bytesPerPixel)
+            {
+                m_numOfMCUsX = (header.Width + header.MaxH * 8 - 1) / (header.MaxH * 8);
+                m_numOfMCUsY = (header.Height + header.MaxV * 8 - 1) / (header.MaxV * 8);
+            }
+
+            int getNumOfMCUs() const
+            {
+                return m_numOfMCUsX * m_numOfMCUsY;
+            }
+
+            /**
+             * @brief Decode the MCUs of a restart interval segment
+             * @param[in] begin Beginning of the entropy coded data
+             * @param[in] end End of the entropy coded data
+             * @param[in] firstMCU First MCU
+             * @param[in] lastMCU Last MCU + 1
+            */
+            void Decode(const unsigned char* begin, const unsigned char* end, const int firstMCU, const int lastMCU) const
+            {
+                BitReader reader(begin, end);
+                int dcPredictions[3] = { 0, 0, 0 };
+                bool isCorrupted = false;
+
+                // Gray output only needs the luma
+                const int numOfOutputComponents = m_outputFormat == YUVOutputFormat::Gray8 ? 1 : m_header.NumOfComponents;
+
+                float coefficients[64];
+                unsigned char planes[3][16 * 16];
+                for (int mcu = firstMCU; mcu < lastMCU; mcu++)
+                {
+                    for (int c = 0; c < m_header.NumOfComponents; c++)
+                    {
+                        const auto& component = m_header.Components[c];
+                        const int planeStride = component.H * m_blockSize;
+                        for (int blockY = 0; blockY < component.V; blockY++)
+                        {
+                            for (int blockX = 0; blockX < component.H; blockX++)
+                            {
+                                DecodeBlock(reader, component, dcPredictions[c], coefficients, isCorrupted);
+                                if (c < numOfOutputComponents)
+                                {
+                                    InverseDCT(coefficients, planes[c] + blockY * m_blockSize * planeStride + blockX * m_blockSize, planeStride);
+                                }
+                            }
+                        }
+                    }
+
+                    StoreMCU(planes, mcu % m_numOfMCUsX, mcu / m_numOfMCUsX);
+                }
+            }
+
+        private:
+
+            /**
+             * @brief Entropy decode and dequantize a block. Only the coefficients used by the scaled IDCT are kept.
+             *        The rest of the segment is decoded as DC only if the data is corrupted.
+            */
+            void DecodeBlock(BitReader& reader, const JPEGComponent& component, int& dcPrediction, float coefficients[64], bool& isCorrupted) const
+            {
+                const unsigned short* quantizationTable = m_header.QuantizationTables[component.QuantizationTable];
+                std::fill(coefficients, coefficients + 64, 0.0f);
+
+                if (!isCorrupted)
+                {
+                    // DC
+                    const int dcSize = reader.Decode(m_header.DCTables[component.DCTable]);
+                    if (dcSize < 0 || dcSize > 11)
+                    {
+                        isCorrupted = true;
+                    }
+                    else
+                    {
+                        dcPrediction += reader.ReceiveExtend(dcSize);
+                    }
+
+                    // AC
+                    for (int k = 1; k < 64 && !isCorrupted;)
+                    {
+                        const int runSize = reader.Decode(m_header.ACTables[component.ACTable]);
+                        if (runSize < 0)
+                        {
+                            isCorrupted = true;
+                            break;
+                        }
+
+                        const int run = runSize >> 4;
+                        const int size = runSize & 15;
+                        if (size == 0)
+                        {
+                            // End of block or 16 zeros
+                            if (run != 15) break;
+                            k += 16;
+                            continue;
+                        }
+
+                        k += run;
+                        if (k > 63)
+                        {
+                            isCorrupted = true;
+                            break;
+                        }
+
+                        const int value = reader.ReceiveExtend(size);
+                        const int natural = JPEGStandardTables::ZIGZAG_TO_NATURAL[k];
+                        if ((natural & 7) < m_blockSize && (natural >> 3) < m_blockSize)
+                        {
+                            coefficients[natural] = (float)(value * quantizationTable[k]);
+                        }
+                        k++;
+                    }
+                }
+
+                coefficients[0] = (float)(dcPrediction * quantizationTable[0]);
+            }
+
+            /**
+             * @brief Scaled separable IDCT of a block
+            */
+            void InverseDCT(const float coefficients[64], unsigned char* output, const int outputStride) const
+            {
+                const auto& table = IDCT_TABLES[(int)m_scale];
+                const int n = m_blockSize;
+
+                // Rows
+                float rows[8][8];
+                for (int v = 0; v < n; v++)
+                {
+                    const float* row = coefficients + v * 8;
+                    for (int x = 0; x < n; x++)
+                    {
+                        float sum = 0;
+                        for (int u = 0; u < n; u++) sum += table[x][u] * row[u];
+                        rows[v][x] = sum;
+                    }
+                }
+
+                // Columns
+                for (int y = 0; y < n; y++)
+                {
+                    unsigned char* outputRow = output + y * outputStride;
+                    for (int x = 0; x < n; x++)
+                    {
+                        float sum = 0;
+                        for (int v = 0; v < n; v++) sum += table[y][v] * rows[v][x];
+                        outputRow[x] = (unsigned char)std::clamp((int)(sum + 128.5f), 0, 255);
+                    }
+                }
+            }
+
+            /**
+             * @brief Convert the MCU planes into the output. Chroma is upsampled by the nearest sample.
+            */
+            void StoreMCU(const unsigned char planes[3][16 * 16], const int mcuX, const int mcuY) const
+            {
+                const int mcuWidth = m_header.MaxH * m_blockSize;
+                const int mcuHeight = m_header.MaxV * m_blockSize;
+                const int x0 = mcuX * mcuWidth;
+                const int y0 = mcuY * mcuHeight;
+                const int width = std::min(mcuWidth, m_outputWidth - x0);
+                const int height = std::min(mcuHeight, m_outputHeight - y0);
+
+                // Sample position of each component is shifted by 1 if it is subsampled
+                int shiftX[3] = { 0, 0, 0 };
+                int shiftY[3] = { 0, 0, 0 };
+                int strides[3] = { 0, 0, 0 };
+                for (int c = 0; c < m_header.NumOfComponents; c++)
+                {
+                    shiftX[c] = m_header.Components[c].H < m_header.MaxH ? 1 : 0;
+                    shiftY[c] = m_header.Components[c].V < m_header.MaxV ? 1 : 0;
+                    strides[c] = m_header.Components[c].H * m_blockSize;
+                }
+
+                const bool isGray = m_outputFormat == YUVOutputFormat::Gray8 || m_header.NumOfComponents == 1;
+                const bool isRGB = m_outputFormat == YUVOutputFormat::RGB24 || m_outputFormat == YUVOutputFormat::RGBA32;
+                for (int y = 0; y < height; y++)
+                {
+                    const int outputY = m_verticalFlip ? m_outputHeight - 1 - (y0 + y) : y0 + y;
+                    unsigned char* outputRow = m_outputData + (long long)outputY * m_outputBytesPerRow;
+                    const unsigned char* lumaRow = planes[0] + (y >> shiftY[0]) * strides[0];
+                    const unsigned char* cbRow = planes[1] + (y >> shiftY[1]) * strides[1];
+                    const unsigned char* crRow = planes[2] + (y >> shiftY[2]) * strides[2];
+
+                    for (int x = 0; x < width; x++)
+                    {
+                        const int outputX = m_horizontalMirror ? m_outputWidth - 1 - (x0 + x) : x0 + x;
+                        unsigned char* pixel = outputRow + outputX * m_bytesPerPixel;
+                        const int luma = lumaRow[x >> shiftX[0]];
+
+                        if (m_outputFormat == YUVOutputFormat::Gray8)
+                        {
+                            pixel[0] = (unsigned char)luma;
+                            continue;
+                        }
+
+                        unsigned char b = (unsigned char)luma;
+                        unsigned char g = (unsigned char)luma;
+                        unsigned char r = (unsigned char)luma;
+                        if (!isGray)
+                        {
+                            // Full range BT.601 in 16 fractional bits
+                            const int cb = cbRow[x >> shiftX[1]] - 128;
+                            const int cr = crRow[x >> shiftX[2]] - 128;
+                            r = (unsigned char)std::clamp(luma + ((91881 * cr + 32768) >> 16), 0, 255);
+                            g = (unsigned char)std::clamp(luma + ((-22554 * cb - 46802 * cr + 32768) >> 16), 0, 255);
+                            b = (unsigned char)std::clamp(luma + ((116130 * cb + 32768) >> 16), 0, 255);
+                        }
+
+                        pixel[0] = isRGB ? r : b;
+                        pixel[1] = g;
+                        pixel[2] = isRGB ? b : r;
+                        if (m_bytesPerPixel == 4) pixel[3] = 255;
+                    }
+                }
+            }
+
+            const JPEGHeader& m_header;
+            unsigned char* m_outputData;
+            const YUVOutputFormat m_outputFormat;
+            const int m_bytesPerPixel;
+            const JPEGScale m_scale;
+            const int m_blockSize;
+            const int m_outputWidth;
+            const int m_outputHeight;
+            const bool m_verticalFlip;
+            const bool m_horizontalMirror;
+            const int m_outputBytesPerRow;
+            int m_numOfMCUsX = 0;
+            int m_numOfMCUsY = 0;
+        };
+    }
+
+    bool JPEGDecoder::ReadSize(const unsigned char* data, const int numOfBytes, int& width, int& height)
+    {
+        try
+        {
+            auto header = std::make_unique<JPEGHeader>();
+            ParseHeader(data, numOfBytes, *header, true);
+            width = header->Width;
+            height = header->Height;
+            return true;
+        }
+        catch (const std::invalid_argument&)
+        {
+            return false;
+        }
+    }
+
+    void JPEGDecoder::Decode(
+        const unsigned char* data,
+        const int numOfBytes,
+        unsigned char* outputData,
+        const YUVOutputFormat outputFormat,
+        const JPEGScale scale,
+        const bool verticalFlip,
+        const bool horizontalMirror,
+        Utils::ThreadPool* threadPool,
+        const int outputBytesPerRow
+    )
+    {
+        // Header
+        auto header = std::make_unique<JPEGHeader>();
+        const unsigned char* scan = ParseHeader(data, numOfBytes, *header, false);
+        SetDefaultHuffmanTables(*header);
+        for (int c = 0; c < header->NumOfComponents; c++)
+        {
+            const auto& component = header->Components[c];
+            if (!header->HasQuantizationTable[component.QuantizationTable]) throw std::invalid_argument("JPEG quantization table(" + std::to_string(component.QuantizationTable) + ") is not found.");
+            if (!header->DCTables[component.DCTable].IsDefined || !header->ACTables[component.ACTable].IsDefined) throw std::invalid_argument("JPEG Huffman table is not found.");
+        }
+
+        // Split the entropy coded data by the restart markers. The scan ends at any other marker.
+        const unsigned char* end = data + numOfBytes;
+        std::vector<std::pair<const unsigned char*, const unsigned char*>> segments;
+        const unsigned char* segmentBegin = scan;
+        const unsigned char* scanEnd = end;
+        for (const unsigned char* p = scan; p + 1 < end; p++)
+        {
+            if (p[0] != 0xFF || p[1] == 0x00 || p[1] == 0xFF) continue;
+            if (p[1] < 0xD0 || p[1] > 0xD7)
+            {
+                scanEnd = p;
+                break;
+            }
+
+            segments.emplace_back(segmentBegin, p);
+            segmentBegin = p + 2;
+            p++;
+        }
+        segments.emplace_back(segmentBegin, scanEnd);
+
+        // MCUs of each segment. Missing segments of a truncated frame are decoded as gray.
+        const SegmentDecoder segmentDecoder(*header, outputData, outputFormat, scale, verticalFlip, horizontalMirror, outputBytesPerRow);
+        const int numOfMCUs = segmentDecoder.getNumOfMCUs();
+        const int numOfMCUsPerSegment = header->RestartInterval > 0 ? header->RestartInterval : numOfMCUs;
+        const int numOfSegments = (numOfMCUs + numOfMCUsPerSegment - 1) / numOfMCUsPerSegment;
+        const auto decodeSegments = [&](const int firstSegment, const int lastSegment)
+        {
+            for (int i = firstSegment; i < lastSegment; i++)
+            {
+                const auto segment = i < (int)segments.size() ? segments[i] : std::make_pair(end, end);
+                segmentDecoder.Decode(segment.first, segment.second, i * numOfMCUsPerSegment, std::min((i + 1) * numOfMCUsPerSegment, numOfMCUs));
+            }
+        };
+
+        if (threadPool == nullptr || threadPool->getNumOfWorkers() == 0 || numOfSegments < 2)
+        {
+            decodeSegments(0, numOfSegments);
+        }
+        else
+        {
+            // A few tasks per thread to balance the segments in different complexity
+            const int numOfTasks = std::min(numOfSegments, (threadPool->getNumOfWorkers() + 1) * 4);
+            threadPool->ParallelFor(
+                numOfTasks,
+                [&](const int task)
+                {
+                    decodeSegments(
+                        (int)((long long)numOfSegments * task / numOfTasks),
+                        (int)((long long)numOfSegments * (task + 1) / numOfTasks)
+                    );
+                }
+            );
+        }
+    }
+}
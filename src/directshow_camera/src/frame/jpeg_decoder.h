@@ -0,0 +1,95 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__JPEG_DECODER_H
+#define DIRECTSHOW_CAMERA__FRAME__JPEG_DECODER_H
+
+//************Content************
+
+#include "frame/yuv_kernel.h"
+
+namespace Utils
+{
+    class ThreadPool;
+}
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Output scale of the JPEG decoder. The IDCT is done in a smaller size, so a scaled decode is cheaper than a full decode.
+    */
+    enum class JPEGScale
+    {
+        Full,       // 1/1
+        Half,       // 1/2
+        Quarter,    // 1/4
+        Eighth      // 1/8, DC coefficients only
+    };
+
+    /**
+     * @brief A baseline JPEG decoder for MJPEG frames.
+     *
+     * It supports 8 bit baseline Huffman JPEG in gray or YCbCr with 1x1, 2x1, 1x2 and 2x2 luma sampling.
+     * MJPEG frames without Huffman tables use the standard tables of ITU T.81 Annex K.
+     * The restart interval segments are independent, so they are decoded in parallel if a thread pool is given.
+     * Chroma is upsampled by the nearest sample.
+     */
+    class JPEGDecoder
+    {
+    public:
+
+        /**
+         * @brief Get the scaled size
+         * @param[in] size Width or height
+         * @param[in] scale Scale
+         * @return Return the scaled size, which is rounded up.
+        */
+        static constexpr int getScaledSize(const int size, const JPEGScale scale)
+        {
+            const int denominator = 1 << (int)scale;
+            return (size + denominator - 1) / denominator;
+        }
+
+        /**
+         * @brief Read the image size from the frame header
+         * @param[in] data JPEG data
+         * @param[in] numOfBytes Number of bytes of the data. Bytes after the EOI marker are ignored.
+         * @param[out] width Width
+         * @param[out] height Height
+         * @return Return false if the frame header is not found
+        */
+        static bool ReadSize(const unsigned char* data, const int numOfBytes, int& width, int& height);
+
+        /**
+         * @brief Decode a JPEG image
+         * @param[in] data JPEG data
+         * @param[in] numOfBytes Number of bytes of the data. Bytes after the EOI marker are ignored.
+         * @param[out] outputData Output data. It must have getScaledSize(height) rows of getScaledSize(width) pixels.
+         * @param[in] outputFormat Output format
+         * @param[in] scale (Optional) Output scale. Default as JPEGScale::Full
+         * @param[in] verticalFlip (Optional) Store the rows from the bottom. Default as false.
+         * @param[in] horizontalMirror (Optional) Mirror the image horizontally. Default as false.
+         * @param[in] threadPool (Optional) Decode the restart interval segments on the thread pool. Default as nullptr, decode on the calling thread.
+         * @param[in] outputBytesPerRow (Optional) Number of bytes per output row. Default as 0, the rows are packed.
+        */
+        static void Decode(
+            const unsigned char* data,
+            const int numOfBytes,
+            unsigned char* outputData,
+            const YUVOutputFormat outputFormat,
+            const JPEGScale scale = JPEGScale::Full,
+            const bool verticalFlip = false,
+            const bool horizontalMirror = false,
+            Utils::ThreadPool* threadPool = nullptr,
+            const int outputBytesPerRow = 0
+        );
+    };
+}
+
+//*******************************
+
+#endif
@@ -0,0 +1,398 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "frame/resize_kernel.h"
+
+#include "utils/cpu_utils.h"
+
+#ifdef DIRECTSHOW_CAMERA_X86
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace DirectShowCamera
+{
+    namespace
+    {
+        // The output is (sum + ReduceRounding) >> ReduceShift, the weights of both axes sum to 2 ^ ReduceShift.
+        // The sum of 16-bit samples is at most 65535 * 2 ^ 16, so it fits in 32 bits with the rounding.
+        constexpr int ReduceShift = 16;
+        constexpr unsigned int ReduceRounding = 1u << (ReduceShift - 1);
+
+        static_assert(ResizeKernel::WeightScale * ResizeKernel::WeightScale == 1 << ReduceShift, "The weights of both axes must sum to 2 ^ ReduceShift.");
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+        /**
+         * @brief Store or add 4 32-bit sums
+        */
+        DIRECTSHOW_CAMERA_TARGET("sse2")
+        inline void AddSumsSSE2(unsigned int* sums, const __m128i values, const bool firstRow)
+        {
+            __m128i* address = (__m128i*)sums;
+            _mm_storeu_si128(address, firstRow ? values : _mm_add_epi32(_mm_loadu_si128(address), values));
+        }
+
+        /**
+         * @brief Store or add 8 32-bit sums
+        */
+        DIRECTSHOW_CAMERA_TARGET("avx2")
+        inline void AddSumsAVX2(unsigned int* sums, const __m256i values, const bool firstRow)
+        {
+            __m256i* address = (__m256i*)sums;
+            _mm256_storeu_si256(address, firstRow ? values : _mm256_add_epi32(_mm256_loadu_si256(address), values));
+        }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+    }
+
+#pragma region Table
+
+    ResizeTable ResizeKernel::BuildTable(
+        const int inputWidth,
+        const int inputHeight,
+        const int outputWidth,
+        const int outputHeight,
+        const int channels,
+        const int bytesPerSample
+    )
+    {
+        // Check
+        if (outputWidth <= 0 || outputHeight <= 0 || outputWidth > inputWidth || outputHeight > inputHeight)
+        {
+            throw std::invalid_argument(
+                "Output size(" + std::to_string(outputWidth) + "x" + std::to_string(outputHeight) + ") should be > 0 and <= the input size(" +
+                std::to_string(inputWidth) + "x" + std::to_string(inputHeight) + ")."
+            );
+        }
+        if (channels != 1 && channels != 3 && channels != 4) throw std::invalid_argument("Channels(" + std::to_string(channels) + ") should be 1, 3 or 4.");
+        if (bytesPerSample != 1 && bytesPerSample != 2) throw std::invalid_argument("Bytes per sample(" + std::to_string(bytesPerSample) + ") should be 1 or 2.");
+
+        ResizeTable table;
+        table.Channels = channels;
+        table.BytesPerSample = bytesPerSample;
+        table.Horizontal = BuildAxis(inputWidth, outputWidth);
+        table.Vertical = BuildAxis(inputHeight, outputHeight);
+        return table;
+    }
+
+    ResizeAxis ResizeKernel::BuildAxis(const int inputSize, const int outputSize)
+    {
+        ResizeAxis axis;
+        axis.InputSize = inputSize;
+        axis.Factor = inputSize == outputSize || inputSize == outputSize * 2 || inputSize == outputSize * 4 ? inputSize / outputSize : 0;
+        axis.Starts.reserve(outputSize);
+        axis.Offsets.reserve(outputSize + 1);
+        axis.Offsets.push_back(0);
+
+        // In units of 1 / outputSize input, the input i covers [i * outputSize, (i + 1) * outputSize) and the output covers [begin, begin + inputSize).
+        // The weight of an input is the rounded cumulative weight at its end minus the one at its start, so the weights of an output sum to WeightScale exactly.
+        const long long size = inputSize;
+        for (int x = 0; x < outputSize; x++)
+        {
+            const long long begin = (long long)x * size;
+            const long long end = begin + size;
+            const auto cumulativeWeight = [&](const long long position)
+            {
+                return (int)((2 * WeightScale * (position - begin) + size) / (2 * size));
+            };
+
+            // Skip the inputs at both ends which are covered too little to get a weight
+            int first = (int)(begin / outputSize);
+            int last = (int)((end - 1) / outputSize);
+            const auto getWeight = [&](const int i)
+            {
+                return cumulativeWeight(std::min(end, (long long)(i + 1) * outputSize)) - cumulativeWeight(std::max(begin, (long long)i * outputSize));
+            };
+            while (getWeight(first) == 0) first++;
+            while (getWeight(last) == 0) last--;
+
+            axis.Starts.push_back(first);
+            for (int i = first; i <= last; i++)
+            {
+                axis.Weights.push_back((unsigned short)getWeight(i));
+            }
+            axis.Offsets.push_back((int)axis.Weights.size());
+        }
+
+        return axis;
+    }
+
+#pragma endregion Table
+
+#pragma region Accumulate
+
+    void ResizeKernel::AccumulateRow(
+        const unsigned char* inputRow,
+        unsigned int* sums,
+        const int numOfSamples,
+        const int bytesPerSample,
+        const int weight,
+        const bool firstRow
+    )
+    {
+        AccumulateRow(inputRow, sums, numOfSamples, bytesPerSample, weight, firstRow, SwizzleKernel::getSIMDLevel());
+    }
+
+    void ResizeKernel::AccumulateRow(
+        const unsigned char* inputRow,
+        unsigned int* sums,
+        const int numOfSamples,
+        const int bytesPerSample,
+        const int weight,
+        const bool firstRow,
+        const SIMDLevel simdLevel
+    )
+    {
+        // SSE2 is enough for the 16-bit multiply, it is used in the SSSE3 level
+        switch (std::min(simdLevel, SwizzleKernel::getSIMDLevel()))
+        {
+        case SIMDLevel::AVX2:
+            AccumulateRowAVX2(inputRow, sums, numOfSamples, bytesPerSample, weight, firstRow);
+            break;
+        case SIMDLevel::SSSE3:
+            AccumulateRowSSE2(inputRow, sums, numOfSamples, bytesPerSample, weight, firstRow);
+            break;
+        default:
+            if (bytesPerSample == 2)
+            {
+                AccumulateRowScalar((const unsigned short*)inputRow, sums, numOfSamples, weight, firstRow);
+            }
+            else
+            {
+                AccumulateRowScalar(inputRow, sums, numOfSamples, weight, firstRow);
+            }
+            break;
+        }
+    }
+
+    template <typename Sample>
+    void ResizeKernel::AccumulateRowScalar(const Sample* inputRow, unsigned int* sums, const int numOfSamples, const int weight, const bool firstRow)
+    {
+        const unsigned int rowWeight = (unsigned int)weight;
+        if (firstRow)
+        {
+            for (int i = 0; i < numOfSamples; i++) sums[i] = rowWeight * inputRow[i];
+        }
+        else
+        {
+            for (int i = 0; i < numOfSamples; i++) sums[i] += rowWeight * inputRow[i];
+        }
+    }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+    DIRECTSHOW_CAMERA_TARGET("sse2")
+    void ResizeKernel::AccumulateRowSSE2(
+        const unsigned char* inputRow,
+        unsigned int* sums,
+        const int numOfSamples,
+        const int bytesPerSample,
+        const int weight,
+        const bool firstRow
+    )
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i rowWeight = _mm_set1_epi16((short)weight);
+
+        int i = 0;
+        if (bytesPerSample == 2)
+        {
+            // 8 samples per iteration. The 32-bit products are the low and the high halves of the 16-bit multiply.
+            const unsigned short* samples = (const unsigned short*)inputRow;
+            for (; i + 8 <= numOfSamples; i += 8)
+            {
+                const __m128i values = _mm_loadu_si128((const __m128i*)(samples + i));
+                const __m128i productLow = _mm_mullo_epi16(values, rowWeight);
+                const __m128i productHigh = _mm_mulhi_epu16(values, rowWeight);
+                AddSumsSSE2(sums + i, _mm_unpacklo_epi16(productLow, productHigh), firstRow);
+                AddSumsSSE2(sums + i + 4, _mm_unpackhi_epi16(productLow, productHigh), firstRow);
+            }
+
+            // Remaining samples
+            AccumulateRowScalar(samples + i, sums + i, numOfSamples - i, weight, firstRow);
+        }
+        else
+        {
+            // 16 samples per iteration. The products of 8-bit samples and a weight <= 256 fit in 16 bits.
+            for (; i + 16 <= numOfSamples; i += 16)
+            {
+                const __m128i values = _mm_loadu_si128((const __m128i*)(inputRow + i));
+                const __m128i products0 = _mm_mullo_epi16(_mm_unpacklo_epi8(values, zero), rowWeight);
+                const __m128i products1 = _mm_mullo_epi16(_mm_unpackhi_epi8(values, zero), rowWeight);
+                AddSumsSSE2(sums + i, _mm_unpacklo_epi16(products0, zero), firstRow);
+                AddSumsSSE2(sums + i + 4, _mm_unpackhi_epi16(products0, zero), firstRow);
+                AddSumsSSE2(sums + i + 8, _mm_unpacklo_epi16(products1, zero), firstRow);
+                AddSumsSSE2(sums + i + 12, _mm_unpackhi_epi16(products1, zero), firstRow);
+            }
+
+            // Remaining samples
+            AccumulateRowScalar(inputRow + i, sums + i, numOfSamples - i, weight, firstRow);
+        }
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2")
+    void ResizeKernel::AccumulateRowAVX2(
+        const unsigned char* inputRow,
+        unsigned int* sums,
+        const int numOfSamples,
+        const int bytesPerSample,
+        const int weight,
+        const bool firstRow
+    )
+    {
+        int i = 0;
+        if (bytesPerSample == 2)
+        {
+            // 16 samples per iteration
+            const unsigned short* samples = (const unsigned short*)inputRow;
+            const __m256i rowWeight = _mm256_set1_epi32(weight);
+            for (; i + 16 <= numOfSamples; i += 16)
+            {
+                const __m256i values0 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(samples + i)));
+                const __m256i values1 = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(samples + i + 8)));
+                AddSumsAVX2(sums + i, _mm256_mullo_epi32(values0, rowWeight), firstRow);
+                AddSumsAVX2(sums + i + 8, _mm256_mullo_epi32(values1, rowWeight), firstRow);
+            }
+        }
+        else
+        {
+            // 32 samples per iteration. The zero extensions keep the order of the samples, unlike the unpacks which are in lane.
+            const __m256i rowWeight = _mm256_set1_epi16((short)weight);
+            for (; i + 32 <= numOfSamples; i += 32)
+            {
+                const __m256i products0 = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(inputRow + i))), rowWeight);
+                const __m256i products1 = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(inputRow + i + 16))), rowWeight);
+                AddSumsAVX2(sums + i, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(products0)), firstRow);
+                AddSumsAVX2(sums + i + 8, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(products0, 1)), firstRow);
+                AddSumsAVX2(sums + i + 16, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(products1)), firstRow);
+                AddSumsAVX2(sums + i + 24, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(products1, 1)), firstRow);
+            }
+        }
+
+        // Remaining samples
+        AccumulateRowSSE2(inputRow + (long long)i * bytesPerSample, sums + i, numOfSamples - i, bytesPerSample, weight, firstRow);
+    }
+
+#else
+
+    void ResizeKernel::AccumulateRowSSE2(
+        const unsigned char* inputRow,
+        unsigned int* sums,
+        const int numOfSamples,
+        const int bytesPerSample,
+        const int weight,
+        const bool firstRow
+    )
+    {
+        AccumulateRow(inputRow, sums, numOfSamples, bytesPerSample, weight, firstRow, SIMDLevel::Scalar);
+    }
+
+    void ResizeKernel::AccumulateRowAVX2(
+        const unsigned char* inputRow,
+        unsigned int* sums,
+        const int numOfSamples,
+        const int bytesPerSample,
+        const int weight,
+        const bool firstRow
+    )
+    {
+        AccumulateRow(inputRow, sums, numOfSamples, bytesPerSample, weight, firstRow, SIMDLevel::Scalar);
+    }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+
+#pragma endregion Accumulate
+
+#pragma region Reduce
+
+    void ResizeKernel::ReduceRow(const unsigned int* sums, unsigned char* outputRow, const ResizeTable& table)
+    {
+        if (table.BytesPerSample == 2)
+        {
+            ReduceRowByChannels(sums, (unsigned short*)outputRow, table);
+        }
+        else
+        {
+            ReduceRowByChannels(sums, outputRow, table);
+        }
+    }
+
+    template <typename Sample>
+    void ResizeKernel::ReduceRowByChannels(const unsigned int* sums, Sample* outputRow, const ResizeTable& table)
+    {
+        switch (table.Channels)
+        {
+        case 4:
+            ReduceRowArea<Sample, 4>(sums, outputRow, table.Horizontal);
+            break;
+        case 3:
+            ReduceRowArea<Sample, 3>(sums, outputRow, table.Horizontal);
+            break;
+        default:
+            ReduceRowArea<Sample, 1>(sums, outputRow, table.Horizontal);
+            break;
+        }
+    }
+
+    template <typename Sample, int Channels>
+    void ResizeKernel::ReduceRowArea(const unsigned int* sums, Sample* outputRow, const ResizeAxis& axis)
+    {
+        const int outputWidth = axis.getOutputSize();
+
+        // The inputs of a binning are at fixed offsets with the same weight
+        switch (axis.Factor)
+        {
+        case 1:
+            ReduceRowBinned<Sample, Channels, 1>(sums, outputRow, outputWidth);
+            return;
+        case 2:
+            ReduceRowBinned<Sample, Channels, 2>(sums, outputRow, outputWidth);
+            return;
+        case 4:
+            ReduceRowBinned<Sample, Channels, 4>(sums, outputRow, outputWidth);
+            return;
+        default:
+            break;
+        }
+
+        for (int x = 0; x < outputWidth; x++)
+        {
+            const unsigned int* inputSums = sums + (long long)axis.Starts[x] * Channels;
+            const unsigned short* weights = axis.Weights.data() + axis.Offsets[x];
+            const int numOfWeights = axis.Offsets[x + 1] - axis.Offsets[x];
+
+            unsigned int values[Channels];
+            for (int c = 0; c < Channels; c++) values[c] = ReduceRounding;
+            for (int i = 0; i < numOfWeights; i++)
+            {
+                for (int c = 0; c < Channels; c++) values[c] += weights[i] * inputSums[i * Channels + c];
+            }
+            for (int c = 0; c < Channels; c++) outputRow[x * Channels + c] = (Sample)(values[c] >> ReduceShift);
+        }
+    }
+
+    template <typename Sample, int Channels, int Factor>
+    void ResizeKernel::ReduceRowBinned(const unsigned int* sums, Sample* outputRow, const int outputWidth)
+    {
+        constexpr unsigned int Weight = WeightScale / Factor;
+        for (int x = 0; x < outputWidth; x++)
+        {
+            const unsigned int* inputSums = sums + (long long)x * Factor * Channels;
+            for (int c = 0; c < Channels; c++)
+            {
+                unsigned int sum = 0;
+                for (int i = 0; i < Factor; i++) sum += inputSums[i * Channels + c];
+                outputRow[x * Channels + c] = (Sample)((sum * Weight + ReduceRounding) >> ReduceShift);
+            }
+        }
+    }
+
+#pragma endregion Reduce
+}
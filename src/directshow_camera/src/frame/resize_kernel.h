@@ -0,0 +1,187 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__RESIZE_KERNEL_H
+#define DIRECTSHOW_CAMERA__FRAME__RESIZE_KERNEL_H
+
+//************Content************
+
+#include "frame/swizzle_kernel.h"
+
+#include <vector>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Weights of an axis of an area resize. The output i is the weighted sum of the Offsets[i + 1] - Offsets[i] inputs from Starts[i].
+    */
+    struct ResizeAxis
+    {
+        /**
+         * @brief Number of inputs covered by the outputs. The inputs after it are dropped.
+        */
+        int InputSize = 0;
+
+        /**
+         * @brief Inputs per output if the axis is a binning, i.e. the input size is 1, 2 or 4 times the output size. Otherwise 0.
+        */
+        int Factor = 0;
+
+        /**
+         * @brief First input of each output
+        */
+        std::vector<int> Starts;
+
+        /**
+         * @brief Offset of the first weight of each output in Weights. It has one more entry than the outputs.
+        */
+        std::vector<int> Offsets;
+
+        /**
+         * @brief Weights of the inputs. The weights of an output sum to ResizeKernel::WeightScale.
+        */
+        std::vector<unsigned short> Weights;
+
+        /**
+         * @brief Get the number of outputs
+         * @return Return the number of outputs
+        */
+        int getOutputSize() const
+        {
+            return (int)Starts.size();
+        }
+    };
+
+    /**
+     * @brief Area resize of the decoded rows of a frame. See ResizeKernel::BuildTable().
+    */
+    struct ResizeTable
+    {
+        /**
+         * @brief Samples per pixel, 1, 3 or 4
+        */
+        int Channels = 1;
+
+        /**
+         * @brief Bytes per sample, 1 or 2
+        */
+        int BytesPerSample = 1;
+
+        /**
+         * @brief Weights of the columns
+        */
+        ResizeAxis Horizontal;
+
+        /**
+         * @brief Weights of the rows
+        */
+        ResizeAxis Vertical;
+    };
+
+    /**
+     * @brief Area resize kernels. Each output pixel is the average of the input pixels it covers, weighted by the covered area.
+     *
+     * The rows are resized in 2 steps. The input rows of an output row are accumulated into 32-bit column sums by AccumulateRow(),
+     * then the columns are merged into the output row by ReduceRow(). The weights are fixed point, so a binning, e.g. 2 x 2, is the exact rounded average.
+     * The kernel is selected at runtime by the instruction sets supported by the CPU. All kernels return the same output.
+     */
+    class ResizeKernel
+    {
+    public:
+
+        /**
+         * @brief Sum of the weights of an output in each axis
+        */
+        static constexpr int WeightScale = 256;
+
+        /**
+         * @brief Build the table of an area resize. Build it once per frame and share it by the rows.
+         * @param[in] inputWidth Number of input columns covered by the output. The columns after it are dropped, e.g. the columns which don't fill a binning block.
+         * @param[in] inputHeight Number of input rows covered by the output
+         * @param[in] outputWidth Output width. It must be > 0 and <= inputWidth.
+         * @param[in] outputHeight Output height. It must be > 0 and <= inputHeight.
+         * @param[in] channels Samples per pixel. It must be 1, 3 or 4.
+         * @param[in] bytesPerSample Bytes per sample. It must be 1 or 2.
+         * @return Return the table
+        */
+        static ResizeTable BuildTable(
+            const int inputWidth,
+            const int inputHeight,
+            const int outputWidth,
+            const int outputHeight,
+            const int channels,
+            const int bytesPerSample
+        );
+
+        /**
+         * @brief Add a weighted input row to the column sums
+         * @param[in] inputRow Input samples
+         * @param[in, out] sums Column sums
+         * @param[in] numOfSamples Number of samples
+         * @param[in] bytesPerSample Bytes per sample, 1 or 2
+         * @param[in] weight Weight of the row
+         * @param[in] firstRow Set it as true to overwrite the sums by the first row of an output row
+        */
+        static void AccumulateRow(
+            const unsigned char* inputRow,
+            unsigned int* sums,
+            const int numOfSamples,
+            const int bytesPerSample,
+            const int weight,
+            const bool firstRow
+        );
+
+        /**
+         * @brief Add a weighted input row to the column sums by a specific SIMD level
+         * @param[in] inputRow Input samples
+         * @param[in, out] sums Column sums
+         * @param[in] numOfSamples Number of samples
+         * @param[in] bytesPerSample Bytes per sample, 1 or 2
+         * @param[in] weight Weight of the row
+         * @param[in] firstRow Set it as true to overwrite the sums by the first row of an output row
+         * @param[in] simdLevel SIMD level. It is lowered to SwizzleKernel::getSIMDLevel() if the CPU doesn't support it.
+        */
+        static void AccumulateRow(
+            const unsigned char* inputRow,
+            unsigned int* sums,
+            const int numOfSamples,
+            const int bytesPerSample,
+            const int weight,
+            const bool firstRow,
+            const SIMDLevel simdLevel
+        );
+
+        /**
+         * @brief Merge the column sums into an output row
+         * @param[in] sums Column sums of the input columns covered by the table
+         * @param[out] outputRow Output row
+         * @param[in] table Table, see BuildTable().
+        */
+        static void ReduceRow(const unsigned int* sums, unsigned char* outputRow, const ResizeTable& table);
+
+    private:
+        static ResizeAxis BuildAxis(const int inputSize, const int outputSize);
+
+        template <typename Sample>
+        static void AccumulateRowScalar(const Sample* inputRow, unsigned int* sums, const int numOfSamples, const int weight, const bool firstRow);
+        static void AccumulateRowSSE2(const unsigned char* inputRow, unsigned int* sums, const int numOfSamples, const int bytesPerSample, const int weight, const bool firstRow);
+        static void AccumulateRowAVX2(const unsigned char* inputRow, unsigned int* sums, const int numOfSamples, const int bytesPerSample, const int weight, const bool firstRow);
+
+        template <typename Sample>
+        static void ReduceRowByChannels(const unsigned int* sums, Sample* outputRow, const ResizeTable& table);
+
+        template <typename Sample, int Channels>
+        static void ReduceRowArea(const unsigned int* sums, Sample* outputRow, const ResizeAxis& axis);
+
+        template <typename Sample, int Channels, int Factor>
+        static void ReduceRowBinned(const unsigned int* sums, Sample* outputRow, const int outputWidth);
+    };
+}
+
+//*******************************
+
+#endif
@@ -0,0 +1,329 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "frame/rgb_kernel.h"
+
+#include "frame/simd_pixel_store.h"
+#include "utils/cpu_utils.h"
+
+#ifdef DIRECTSHOW_CAMERA_X86
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace DirectShowCamera
+{
+    namespace
+    {
+        bool isRGBOrder(const YUVOutputFormat outputFormat)
+        {
+            return outputFormat == YUVOutputFormat::RGB24 || outputFormat == YUVOutputFormat::RGBA32;
+        }
+
+        /**
+         * @brief Expand a 5 bit channel to 8 bits
+        */
+        inline int Expand5(const int value)
+        {
+            return (value << 3) | (value >> 2);
+        }
+
+        /**
+         * @brief Expand a 6 bit channel to 8 bits
+        */
+        inline int Expand6(const int value)
+        {
+            return (value << 2) | (value >> 4);
+        }
+
+        void CheckOutputFormat(const YUVOutputFormat outputFormat)
+        {
+            if (outputFormat == YUVOutputFormat::Gray8)
+            {
+                throw std::invalid_argument("Output format(" + std::to_string((int)outputFormat) + ") is not supported by the 16-bit RGB kernels.");
+            }
+        }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+        /**
+         * @brief Expand 8 16-bit RGB pixels to B, G and R in 16-bit lanes
+        */
+        DIRECTSHOW_CAMERA_TARGET("ssse3")
+        inline void ExpandRGB16SSSE3(const __m128i pixels, const bool isRGB565, __m128i& b, __m128i& g, __m128i& r)
+        {
+            const __m128i mask5 = _mm_set1_epi16(0x1F);
+            const __m128i b5 = _mm_and_si128(pixels, mask5);
+            b = _mm_or_si128(_mm_slli_epi16(b5, 3), _mm_srli_epi16(b5, 2));
+            if (isRGB565)
+            {
+                const __m128i g6 = _mm_and_si128(_mm_srli_epi16(pixels, 5), _mm_set1_epi16(0x3F));
+                const __m128i r5 = _mm_srli_epi16(pixels, 11);
+                g = _mm_or_si128(_mm_slli_epi16(g6, 2), _mm_srli_epi16(g6, 4));
+                r = _mm_or_si128(_mm_slli_epi16(r5, 3), _mm_srli_epi16(r5, 2));
+            }
+            else
+            {
+                const __m128i g5 = _mm_and_si128(_mm_srli_epi16(pixels, 5), mask5);
+                const __m128i r5 = _mm_and_si128(_mm_srli_epi16(pixels, 10), mask5);
+                g = _mm_or_si128(_mm_slli_epi16(g5, 3), _mm_srli_epi16(g5, 2));
+                r = _mm_or_si128(_mm_slli_epi16(r5, 3), _mm_srli_epi16(r5, 2));
+            }
+        }
+
+        /**
+         * @brief Expand 16 16-bit RGB pixels to B, G and R in 16-bit lanes
+        */
+        DIRECTSHOW_CAMERA_TARGET("avx2")
+        inline void ExpandRGB16AVX2(const __m256i pixels, const bool isRGB565, __m256i& b, __m256i& g, __m256i& r)
+        {
+            const __m256i mask5 = _mm256_set1_epi16(0x1F);
+            const __m256i b5 = _mm256_and_si256(pixels, mask5);
+            b = _mm256_or_si256(_mm256_slli_epi16(b5, 3), _mm256_srli_epi16(b5, 2));
+            if (isRGB565)
+            {
+                const __m256i g6 = _mm256_and_si256(_mm256_srli_epi16(pixels, 5), _mm256_set1_epi16(0x3F));
+                const __m256i r5 = _mm256_srli_epi16(pixels, 11);
+                g = _mm256_or_si256(_mm256_slli_epi16(g6, 2), _mm256_srli_epi16(g6, 4));
+                r = _mm256_or_si256(_mm256_slli_epi16(r5, 3), _mm256_srli_epi16(r5, 2));
+            }
+            else
+            {
+                const __m256i g5 = _mm256_and_si256(_mm256_srli_epi16(pixels, 5), mask5);
+                const __m256i r5 = _mm256_and_si256(_mm256_srli_epi16(pixels, 10), mask5);
+                g = _mm256_or_si256(_mm256_slli_epi16(g5, 3), _mm256_srli_epi16(g5, 2));
+                r = _mm256_or_si256(_mm256_slli_epi16(r5, 3), _mm256_srli_epi16(r5, 2));
+            }
+        }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+    }
+
+    void RGBKernel::RGB16ToPixels(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const RGB16Layout layout,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        RGB16ToPixels(inputData, outputData, numOfPixels, layout, outputFormat, SwizzleKernel::getSIMDLevel());
+    }
+
+    void RGBKernel::RGB16ToPixels(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const RGB16Layout layout,
+        const YUVOutputFormat outputFormat,
+        const SIMDLevel simdLevel
+    )
+    {
+        // Check
+        CheckOutputFormat(outputFormat);
+
+        switch (std::min(simdLevel, SwizzleKernel::getSIMDLevel()))
+        {
+        case SIMDLevel::AVX2:
+            RGB16ToPixelsAVX2(inputData, outputData, numOfPixels, layout, outputFormat);
+            break;
+        case SIMDLevel::SSSE3:
+            RGB16ToPixelsSSSE3(inputData, outputData, numOfPixels, layout, outputFormat);
+            break;
+        default:
+            RGB16ToPixelsScalar(inputData, outputData, numOfPixels, layout, outputFormat);
+            break;
+        }
+    }
+
+    void RGBKernel::RGB16ToPixelsScalar(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const RGB16Layout layout,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        const int bytesPerPixel = YUVKernel::getBytesPerPixel(outputFormat);
+        const bool isRGB = isRGBOrder(outputFormat);
+        const bool isRGB565 = layout == RGB16Layout::RGB565;
+        for (int x = 0; x < numOfPixels; x++)
+        {
+            // Little-endian word
+            const int pixel = inputData[x * 2] | (inputData[x * 2 + 1] << 8);
+            const unsigned char b = (unsigned char)Expand5(pixel & 0x1F);
+            const unsigned char g = (unsigned char)(isRGB565 ? Expand6((pixel >> 5) & 0x3F) : Expand5((pixel >> 5) & 0x1F));
+            const unsigned char r = (unsigned char)Expand5((pixel >> (isRGB565 ? 11 : 10)) & 0x1F);
+
+            unsigned char* output = outputData + x * bytesPerPixel;
+            output[0] = isRGB ? r : b;
+            output[1] = g;
+            output[2] = isRGB ? b : r;
+            if (bytesPerPixel == 4) output[3] = 255;
+        }
+    }
+
+    RGBPaletteTable RGBKernel::BuildPaletteTable(const RGBPalette* palette, const YUVOutputFormat outputFormat)
+    {
+        RGBPaletteTable table;
+        table.OutputFormat = outputFormat;
+        const bool isRGB = isRGBOrder(outputFormat);
+        for (int i = 0; i < 256; i++)
+        {
+            const std::uint32_t b = palette != nullptr ? (*palette)[i * 4] : (std::uint32_t)i;
+            const std::uint32_t g = palette != nullptr ? (*palette)[i * 4 + 1] : (std::uint32_t)i;
+            const std::uint32_t r = palette != nullptr ? (*palette)[i * 4 + 2] : (std::uint32_t)i;
+            if (outputFormat == YUVOutputFormat::Gray8)
+            {
+                // BT.601 luma in 8 fractional bits
+                table.Entries[i] = (r * 77 + g * 150 + b * 29 + 128) >> 8;
+            }
+            else
+            {
+                table.Entries[i] = (isRGB ? r : b) | (g << 8) | ((isRGB ? b : r) << 16) | (0xFFu << 24);
+            }
+        }
+        return table;
+    }
+
+    void RGBKernel::PaletteToPixels(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const RGBPaletteTable& table
+    )
+    {
+        // Table entries are already in the output order, so a pixel is a single lookup and store
+        const std::uint32_t* entries = table.Entries.data();
+        switch (YUVKernel::getBytesPerPixel(table.OutputFormat))
+        {
+        case 4:
+            for (int x = 0; x < numOfPixels; x++)
+            {
+                memcpy(outputData + x * 4, &entries[inputData[x]], 4);
+            }
+            break;
+        case 3:
+            // Store 4 bytes and let the next pixel overwrite the 4th byte, the last pixel stores 3 bytes only
+            for (int x = 0; x + 1 < numOfPixels; x++)
+            {
+                memcpy(outputData + x * 3, &entries[inputData[x]], 4);
+            }
+            if (numOfPixels > 0)
+            {
+                memcpy(outputData + (numOfPixels - 1) * 3, &entries[inputData[numOfPixels - 1]], 3);
+            }
+            break;
+        default:
+            for (int x = 0; x < numOfPixels; x++)
+            {
+                outputData[x] = (unsigned char)entries[inputData[x]];
+            }
+            break;
+        }
+    }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+    DIRECTSHOW_CAMERA_TARGET("ssse3")
+    void RGBKernel::RGB16ToPixelsSSSE3(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const RGB16Layout layout,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        // 16 pixels per 32 bytes
+        const int bytesPerPixel = YUVKernel::getBytesPerPixel(outputFormat);
+        const bool isRGB = isRGBOrder(outputFormat);
+        const bool hasAlpha = bytesPerPixel == 4;
+        const bool isRGB565 = layout == RGB16Layout::RGB565;
+
+        int x = 0;
+        for (; x + 16 <= numOfPixels; x += 16)
+        {
+            const __m128i v0 = _mm_loadu_si128((const __m128i*)(inputData + x * 2));
+            const __m128i v1 = _mm_loadu_si128((const __m128i*)(inputData + x * 2 + 16));
+            __m128i b0, g0, r0, b1, g1, r1;
+            ExpandRGB16SSSE3(v0, isRGB565, b0, g0, r0);
+            ExpandRGB16SSSE3(v1, isRGB565, b1, g1, r1);
+            const __m128i b = _mm_packus_epi16(b0, b1);
+            const __m128i g = _mm_packus_epi16(g0, g1);
+            const __m128i r = _mm_packus_epi16(r0, r1);
+            StorePixelsSSSE3(isRGB ? r : b, g, isRGB ? b : r, outputData + x * bytesPerPixel, hasAlpha);
+        }
+
+        // Remaining pixels
+        RGB16ToPixelsScalar(inputData + x * 2, outputData + x * bytesPerPixel, numOfPixels - x, layout, outputFormat);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2")
+    void RGBKernel::RGB16ToPixelsAVX2(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const RGB16Layout layout,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        // 32 pixels per 64 bytes, the 64-bit blocks are reordered after the pack as YUVKernel
+        const int bytesPerPixel = YUVKernel::getBytesPerPixel(outputFormat);
+        const bool isRGB = isRGBOrder(outputFormat);
+        const bool hasAlpha = bytesPerPixel == 4;
+        const bool isRGB565 = layout == RGB16Layout::RGB565;
+
+        int x = 0;
+        for (; x + 32 <= numOfPixels; x += 32)
+        {
+            const __m256i v0 = _mm256_loadu_si256((const __m256i*)(inputData + x * 2));
+            const __m256i v1 = _mm256_loadu_si256((const __m256i*)(inputData + x * 2 + 32));
+            __m256i b0, g0, r0, b1, g1, r1;
+            ExpandRGB16AVX2(v0, isRGB565, b0, g0, r0);
+            ExpandRGB16AVX2(v1, isRGB565, b1, g1, r1);
+            const __m256i b = _mm256_permute4x64_epi64(_mm256_packus_epi16(b0, b1), 0xD8);
+            const __m256i g = _mm256_permute4x64_epi64(_mm256_packus_epi16(g0, g1), 0xD8);
+            const __m256i r = _mm256_permute4x64_epi64(_mm256_packus_epi16(r0, r1), 0xD8);
+            const __m256i c0 = isRGB ? r : b;
+            const __m256i c2 = isRGB ? b : r;
+            StorePixelsSSSE3(_mm256_castsi256_si128(c0), _mm256_castsi256_si128(g), _mm256_castsi256_si128(c2), outputData + x * bytesPerPixel, hasAlpha);
+            StorePixelsSSSE3(_mm256_extracti128_si256(c0, 1), _mm256_extracti128_si256(g, 1), _mm256_extracti128_si256(c2, 1), outputData + (x + 16) * bytesPerPixel, hasAlpha);
+        }
+
+        // Remaining pixels
+        RGB16ToPixelsSSSE3(inputData + x * 2, outputData + x * bytesPerPixel, numOfPixels - x, layout, outputFormat);
+    }
+
+#else
+
+    void RGBKernel::RGB16ToPixelsSSSE3(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const RGB16Layout layout,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        RGB16ToPixelsScalar(inputData, outputData, numOfPixels, layout, outputFormat);
+    }
+
+    void RGBKernel::RGB16ToPixelsAVX2(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const RGB16Layout layout,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        RGB16ToPixelsScalar(inputData, outputData, numOfPixels, layout, outputFormat);
+    }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+}
@@ -0,0 +1,122 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__RGB_KERNEL_H
+#define DIRECTSHOW_CAMERA__FRAME__RGB_KERNEL_H
+
+//************Content************
+
+#include "frame/frame_settings.h"
+#include "frame/swizzle_kernel.h"
+#include "frame/yuv_kernel.h"
+
+#include <array>
+#include <cstdint>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Bit layout of the 16-bit RGB pixels. A pixel is a little-endian word.
+    */
+    enum class RGB16Layout
+    {
+        RGB565,     // R in bit 11-15, G in bit 5-10, B in bit 0-4
+        RGB555      // R in bit 10-14, G in bit 5-9, B in bit 0-4, bit 15 is not used
+    };
+
+    /**
+     * @brief Lookup table of the 8 bit RGB pixels. See RGBKernel::BuildPaletteTable().
+    */
+    struct RGBPaletteTable
+    {
+        /**
+         * @brief Output pixel of each index. The bytes of an output pixel are stored from the lowest byte.
+        */
+        std::array<std::uint32_t, 256> Entries;
+
+        /**
+         * @brief Output format
+        */
+        YUVOutputFormat OutputFormat = YUVOutputFormat::BGR24;
+    };
+
+    /**
+     * @brief Unpack kernels of the 16-bit and the 8 bit palette RGB pixels. The output formats are the same as the YUV kernels.
+     *
+     * The 5 and 6 bit channels are expanded to 8 bits by replicating the high bits, so 0 and the maximum map to 0 and 255.
+     * The kernel is selected at runtime by the instruction sets supported by the CPU. All kernels return the same output.
+     */
+    class RGBKernel
+    {
+    public:
+
+        /**
+         * @brief Expand 16-bit RGB pixels. Alpha is set to 255.
+         * @param[in] inputData Input pixels
+         * @param[out] outputData Output pixels. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] layout Bit layout of the input
+         * @param[in] outputFormat Output format. YUVOutputFormat::Gray8 is not supported.
+        */
+        static void RGB16ToPixels(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int numOfPixels,
+            const RGB16Layout layout,
+            const YUVOutputFormat outputFormat
+        );
+
+        /**
+         * @brief Expand 16-bit RGB pixels by a specific SIMD level. Alpha is set to 255.
+         * @param[in] inputData Input pixels
+         * @param[out] outputData Output pixels. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] layout Bit layout of the input
+         * @param[in] outputFormat Output format. YUVOutputFormat::Gray8 is not supported.
+         * @param[in] simdLevel SIMD level. It is lowered to SwizzleKernel::getSIMDLevel() if the CPU doesn't support it.
+        */
+        static void RGB16ToPixels(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int numOfPixels,
+            const RGB16Layout layout,
+            const YUVOutputFormat outputFormat,
+            const SIMDLevel simdLevel
+        );
+
+        /**
+         * @brief Build the lookup table of a palette. Build it once per frame and share it by the rows.
+         * @param[in] palette Palette. nullptr for the gray levels, i.e. index i is (i, i, i).
+         * @param[in] outputFormat Output format. The gray output is the BT.601 luma of the palette color.
+         * @return Return the lookup table
+        */
+        static RGBPaletteTable BuildPaletteTable(const RGBPalette* palette, const YUVOutputFormat outputFormat);
+
+        /**
+         * @brief Look up 8 bit palette pixels
+         * @param[in] inputData Input palette indices
+         * @param[out] outputData Output pixels. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] table Lookup table. See BuildPaletteTable().
+        */
+        static void PaletteToPixels(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int numOfPixels,
+            const RGBPaletteTable& table
+        );
+
+    private:
+        static void RGB16ToPixelsScalar(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels, const RGB16Layout layout, const YUVOutputFormat outputFormat);
+        static void RGB16ToPixelsSSSE3(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels, const RGB16Layout layout, const YUVOutputFormat outputFormat);
+        static void RGB16ToPixelsAVX2(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels, const RGB16Layout layout, const YUVOutputFormat outputFormat);
+    };
+}
+
+//*******************************
+
+#endif
@@ -0,0 +1,920 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "frame/row_kernel.h"
+
+#include "frame/swizzle_kernel.h"
+
+#include "utils/thread_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace DirectShowCamera
+{
+    namespace
+    {
+        // Number of 16-bit samples converted at a time by the tone mapping kernels. It is a multiple of the packing groups.
+        constexpr int ToneMapBlockSize = 512;
+
+        // Number of output bytes decoded at a time before their statistics are accumulated. The rows of a block stay in the L2 cache.
+        constexpr int StatisticsBlockSize = 256 * 1024;
+        constexpr int StatisticsMinBlockRows = 16;
+
+        /**
+        * @brief Run the rows of a frame, split into bands on the thread pool
+        * @param[in] height Height
+        * @param[in] threadPool Thread pool. Run on the calling thread if it is nullptr.
+        * @param[in] runRows Function running the rows from startY to endY - 1
+        */
+        template <typename RunRowsFunction>
+        void RunBands(const int height, Utils::ThreadPool* threadPool, const RunRowsFunction& runRows)
+        {
+            if (threadPool == nullptr || threadPool->getNumOfWorkers() == 0 || height < 2)
+            {
+                runRows(0, height);
+            }
+            else
+            {
+                // One band per thread, the calling thread takes a band too
+                const int numOfBands = std::min(height, threadPool->getNumOfWorkers() + 1);
+                threadPool->ParallelFor(
+                    numOfBands,
+                    [&](const int band)
+                    {
+                        runRows(
+                            (int)((long long)height * band / numOfBands),
+                            (int)((long long)height * (band + 1) / numOfBands)
+                        );
+                    }
+                );
+            }
+        }
+
+        /**
+        * @brief Run the rows of a frame, split into bands on the thread pool, and accumulate the statistics of the output rows.
+        *        Each band runs its rows in blocks and accumulates a block while it is still in the cache, then merges its statistics at the end.
+        * @param[in] height Height
+        * @param[in] threadPool Thread pool. Run on the calling thread if it is nullptr.
+        * @param[in] runRows Function running the rows from startY to endY - 1
+        * @param[in] outputData Output data. Rows are stored top-down.
+        * @param[in] outputWidth Output width
+        * @param[in] outputBytesPerRow Number of bytes per output row
+        * @param[in, out] statistics Statistics accumulator. Set it as nullptr to skip the statistics.
+        */
+        template <typename RunRowsFunction>
+        void RunBands(
+            const int height,
+            Utils::ThreadPool* threadPool,
+            const RunRowsFunction& runRows,
+            const unsigned char* outputData,
+            const int outputWidth,
+            const int outputBytesPerRow,
+            StatisticsAccumulator* statistics
+        )
+        {
+            if (statistics == nullptr)
+            {
+                RunBands(height, threadPool, runRows);
+                return;
+            }
+
+            std::mutex mutex;
+            const int rowsPerBlock = std::max(StatisticsMinBlockRows, StatisticsBlockSize / std::max(outputBytesPerRow, 1));
+            const auto runRowsWithStatistics = [&](const int startY, const int endY)
+            {
+                auto partial = StatisticsKernel::CreateAccumulator(*statistics);
+                for (int blockY = startY; blockY < endY; blockY += rowsPerBlock)
+                {
+                    const int blockEndY = std::min(endY, blockY + rowsPerBlock);
+                    runRows(blockY, blockEndY);
+                    for (int y = blockY; y < blockEndY; y++)
+                    {
+                        if (StatisticsKernel::isSampledRow(partial, y)) StatisticsKernel::AccumulateRow(outputData + (long long)outputBytesPerRow * (long long)y, outputWidth, partial);
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                StatisticsKernel::Merge(partial, *statistics);
+            };
+
+            RunBands(height, threadPool, runRowsWithStatistics);
+        }
+
+        /**
+        * @brief Get the first element of a tensor row in each plane
+        * @param[in] tensor Tensor
+        * @param[in] tensorY Row of the tensor
+        * @param[out] planes First element of the row in each plane
+        */
+        void getTensorRow(const TensorOutput& tensor, const int tensorY, void** planes)
+        {
+            const int bytesPerElement = tensor.Table->DataType == TensorDataType::Float16 ? 2 : 4;
+            const long long bytesPerPlane = (long long)tensor.Width * (long long)tensor.Height * bytesPerElement;
+            for (int p = 0; p < tensor.Table->NumOfPlanes; p++)
+            {
+                planes[p] = (unsigned char*)tensor.Data + bytesPerPlane * p + (long long)tensor.Width * tensorY * bytesPerElement;
+            }
+        }
+
+        /**
+        * @brief Pad the rows of a tensor above and below the frame. They are contiguous in each plane, so each side is filled at once.
+        * @param[in] tensor Tensor
+        * @param[in] height Height of the frame
+        */
+        void PadTensorRows(const TensorOutput& tensor, const int height)
+        {
+            void* planes[3] = {};
+            getTensorRow(tensor, 0, planes);
+            TensorKernel::FillPlanes(planes, tensor.Width * tensor.Y, *tensor.Table);
+            getTensorRow(tensor, tensor.Y + height, planes);
+            TensorKernel::FillPlanes(planes, tensor.Width * (tensor.Height - tensor.Y - height), *tensor.Table);
+        }
+
+        /**
+        * @brief Convert a decoded row into a tensor row. The columns at the left and the right of the frame are padded.
+        * @param[in] row Decoded row
+        * @param[in] width Width of the frame
+        * @param[in] y Row of the frame
+        * @param[in] tensor Tensor
+        */
+        void WriteTensorRow(const unsigned char* row, const int width, const int y, const TensorOutput& tensor)
+        {
+            const int bytesPerElement = tensor.Table->DataType == TensorDataType::Float16 ? 2 : 4;
+            void* planes[3] = {};
+            getTensorRow(tensor, tensor.Y + y, planes);
+
+            TensorKernel::FillPlanes(planes, tensor.X, *tensor.Table);
+            for (int p = 0; p < tensor.Table->NumOfPlanes; p++) planes[p] = (unsigned char*)planes[p] + (long long)tensor.X * bytesPerElement;
+            TensorKernel::ToPlanes(row, planes, width, *tensor.Table);
+            for (int p = 0; p < tensor.Table->NumOfPlanes; p++) planes[p] = (unsigned char*)planes[p] + (long long)width * bytesPerElement;
+            TensorKernel::FillPlanes(planes, tensor.Width - tensor.X - width, *tensor.Table);
+        }
+
+        /**
+        * @brief Run the rows of a frame into a tensor, split into bands on the thread pool.
+        *        Each row is decoded into a row buffer of the band and converted into the planes while it is still in the cache, so the decoded frame is never written.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] rowBytes Number of bytes of the row buffer. 0 if the rows are already decoded.
+        * @param[in] tensor Tensor
+        * @param[in] threadPool Thread pool. Run on the calling thread if it is nullptr.
+        * @param[in] getRow Function returning the decoded row y from the top. The row can be decoded into the row buffer.
+        */
+        template <typename GetRowFunction>
+        void RunTensorBands(
+            const int width,
+            const int height,
+            const int rowBytes,
+            const TensorOutput& tensor,
+            Utils::ThreadPool* threadPool,
+            const GetRowFunction& getRow
+        )
+        {
+            PadTensorRows(tensor, height);
+
+            // Run the rows from startY to endY - 1
+            const auto runRows = [&](const int startY, const int endY)
+            {
+                std::vector<unsigned char> row(rowBytes);
+                for (int y = startY; y < endY; y++)
+                {
+                    WriteTensorRow(getRow(y, row.data()), width, y, tensor);
+                }
+            };
+
+            RunBands(height, threadPool, runRows);
+        }
+
+        /**
+        * @brief Run the rows of an area resize, split into bands of output rows on the thread pool.
+        *        The input rows of an output row are decoded into a row buffer and accumulated while they are still in the cache, so the full size frame is never written.
+        * @param[in] width Width of the decoded rows
+        * @param[out] outputData Output data. Rows are stored top-down.
+        * @param[in] outputBytesPerRow Number of bytes per output row
+        * @param[in] table Resize table
+        * @param[in] threadPool Thread pool. Run on the calling thread if it is nullptr.
+        * @param[in] decodeRow Function decoding the row y from the top of the full size output into a row buffer
+        * @param[in, out] statistics Statistics accumulator of the output rows. Set it as nullptr to skip the statistics.
+        * @param[out] tensor Tensor written instead of the output data. Set it as nullptr to write the output data.
+        */
+        template <typename DecodeRowFunction>
+        void RunResizedBands(
+            const int width,
+            unsigned char* outputData,
+            const int outputBytesPerRow,
+            const ResizeTable& table,
+            Utils::ThreadPool* threadPool,
+            const DecodeRowFunction& decodeRow,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor
+        )
+        {
+            const ResizeAxis& vertical = table.Vertical;
+            const int outputWidth = table.Horizontal.getOutputSize();
+            const int numOfSamples = table.Horizontal.InputSize * table.Channels;
+
+            // Run the output rows from startY to endY - 1
+            const auto runRows = [&](const int startY, const int endY)
+            {
+                std::vector<unsigned char> row((size_t)width * table.Channels * table.BytesPerSample);
+                std::vector<unsigned int> sums(numOfSamples);
+                std::vector<unsigned char> outputRow(tensor != nullptr ? (size_t)outputWidth * table.Channels * table.BytesPerSample : 0);
+
+                // An input row on the boundary of 2 output rows is decoded once
+                int rowY = -1;
+                for (int y = startY; y < endY; y++)
+                {
+                    for (int i = vertical.Offsets[y]; i < vertical.Offsets[y + 1]; i++)
+                    {
+                        const int inputY = vertical.Starts[y] + i - vertical.Offsets[y];
+                        if (inputY != rowY)
+                        {
+                            decodeRow(inputY, row.data());
+                            rowY = inputY;
+                        }
+                        ResizeKernel::AccumulateRow(row.data(), sums.data(), numOfSamples, table.BytesPerSample, vertical.Weights[i], i == vertical.Offsets[y]);
+                    }
+                    if (tensor != nullptr)
+                    {
+                        ResizeKernel::ReduceRow(sums.data(), outputRow.data(), table);
+                        WriteTensorRow(outputRow.data(), outputWidth, y, *tensor);
+                    }
+                    else
+                    {
+                        ResizeKernel::ReduceRow(sums.data(), outputData + (long long)outputBytesPerRow * (long long)y, table);
+                    }
+                }
+            };
+
+            if (tensor != nullptr)
+            {
+                PadTensorRows(*tensor, vertical.getOutputSize());
+                RunBands(vertical.getOutputSize(), threadPool, runRows);
+            }
+            else
+            {
+                RunBands(vertical.getOutputSize(), threadPool, runRows, outputData, outputWidth, outputBytesPerRow, statistics);
+            }
+        }
+
+        /**
+        * @brief Run the rows of a row kernel into the output data, the resize or the tensor.
+        * @param[in] width Width of the decoded rows
+        * @param[in] height Height of the decoded rows
+        * @param[out] outputData Output data. Rows are stored top-down.
+        * @param[in] outputBytesPerRow Number of bytes per output row
+        * @param[in] threadPool Thread pool. Run on the calling thread if it is nullptr.
+        * @param[in] resizeTable Resize table. Set it as nullptr if the rows are not resized.
+        * @param[in, out] statistics Statistics accumulator of the output rows. Set it as nullptr to skip the statistics.
+        * @param[out] tensor Tensor written instead of the output data. Set it as nullptr to write the output data.
+        * @param[in] decodeRow Function decoding the row y from the top of the full size output into a row
+        */
+        template <typename DecodeRowFunction>
+        void RunRows(
+            const int width,
+            const int height,
+            unsigned char* outputData,
+            const int outputBytesPerRow,
+            Utils::ThreadPool* threadPool,
+            const ResizeTable* resizeTable,
+            StatisticsAccumulator* statistics,
+            const TensorOutput* tensor,
+            const DecodeRowFunction& decodeRow
+        )
+        {
+            // Resize the rows while they are decoded
+            if (resizeTable != nullptr)
+            {
+                RunResizedBands(width, outputData, outputBytesPerRow, *resizeTable, threadPool, decodeRow, statistics, tensor);
+                return;
+            }
+
+            // Convert each row into the tensor while it is still in the cache
+            if (tensor != nullptr)
+            {
+                RunTensorBands(
+                    width,
+                    height,
+                    width * tensor->Table->Channels * tensor->Table->BytesPerSample,
+                    *tensor,
+                    threadPool,
+                    [&](const int y, unsigned char* row)
+                    {
+                        decodeRow(y, row);
+                        return (const unsigned char*)row;
+                    }
+                );
+                return;
+            }
+
+            // Run the rows from startY to endY - 1
+            const auto runRows = [&](const int startY, const int endY)
+            {
+                for (int y = startY; y < endY; y++)
+                {
+                    decodeRow(y, outputData + (long long)outputBytesPerRow * (long long)y);
+                }
+            };
+
+            RunBands(height, threadPool, runRows, outputData, width, outputBytesPerRow, statistics);
+        }
+    }
+
+    void RowKernel::Run(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int inputBytesPerRow,
+        const int outputBytesPerRow,
+        const bool verticalFlip,
+        const RowKernelFunction kernel,
+        Utils::ThreadPool* threadPool,
+        const ResizeTable* resizeTable,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        // Decode the row y from the top of the output
+        // Notes: inputData default is vertical flipped. So rows are read in reverse order if verticalFlip == false
+        const auto decodeRow = [&](const int y, unsigned char* row)
+        {
+            const int inputY = verticalFlip ? y : height - y - 1;
+            kernel(inputData + (long long)inputBytesPerRow * (long long)inputY, row, width);
+        };
+
+        RunRows(width, height, outputData, outputBytesPerRow, threadPool, resizeTable, statistics, tensor, decodeRow);
+    }
+
+    void RowKernel::Run(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int inputBytesPerRow,
+        const int outputBytesPerRow,
+        const bool verticalFlip,
+        const ContextRowKernelFunction kernel,
+        const void* context,
+        Utils::ThreadPool* threadPool,
+        const ResizeTable* resizeTable,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        // Decode the row y from the top of the output
+        // Notes: inputData default is vertical flipped. So rows are read in reverse order if verticalFlip == false
+        const auto decodeRow = [&](const int y, unsigned char* row)
+        {
+            const int inputY = verticalFlip ? y : height - y - 1;
+            kernel(context, inputData + (long long)inputBytesPerRow * (long long)inputY, row, width);
+        };
+
+        RunRows(width, height, outputData, outputBytesPerRow, threadPool, resizeTable, statistics, tensor, decodeRow);
+    }
+
+    void RowKernel::RunYUV420(
+        const YUV420Planes& planes,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int outputBytesPerRow,
+        const bool verticalFlip,
+        const YUV420RowKernelFunction kernel,
+        Utils::ThreadPool* threadPool,
+        const ResizeTable* resizeTable,
+        StatisticsAccumulator* statistics,
+        const TensorOutput* tensor
+    )
+    {
+        // Decode the row y from the top of the output. Rows are independent, so the bands can start at any row.
+        const auto decodeRow = [&](const int y, unsigned char* row)
+        {
+            const int inputY = verticalFlip ? height - y - 1 : y;
+            const long long chromaOffset = (long long)planes.UVStride * (long long)(inputY / 2);
+            kernel(
+                planes.Y + (long long)planes.YStride * (long long)inputY,
+                planes.U + chromaOffset,
+                planes.V != nullptr ? planes.V + chromaOffset : nullptr,
+                row,
+                width
+            );
+        };
+
+        RunRows(width, height, outputData, outputBytesPerRow, threadPool, resizeTable, statistics, tensor, decodeRow);
+    }
+
+    void RowKernel::RunBayer(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int inputBytesPerRow,
+        const int outputBytesPerRow,
+        const bool verticalFlip,
+        const BayerPattern pattern,
+        const BayerDemosaic demosaic,
+        const YUVOutputFormat outputFormat,
+        const bool horizontalMirror,
+        const BitDepthConversion* conversion,
+        Utils::ThreadPool* threadPool,
+        StatisticsAccumulator* statistics
+    )
+    {
+        const int radius = BayerKernel::getRadius(demosaic);
+        const int paddedWidth = width + 2 * BayerKernel::RowPadding;
+
+        // A row reads the rows from inputY - radius to inputY + radius. Bands overlap by the radius, the overlapped rows are loaded by both bands.
+        const auto runRows = [&](const int startY, const int endY)
+        {
+            // Ring buffer of the padded 8 bit rows. Slot inputY % RingSize holds the row inputY, the rows of a window never share a slot.
+            constexpr int RingSize = 5;
+            std::vector<unsigned char> ringBuffer((size_t)paddedWidth * RingSize);
+            int ringRows[RingSize] = { -1, -1, -1, -1, -1 };
+            std::vector<unsigned short> samples(conversion != nullptr ? width : 0);
+
+            const unsigned char* rows[RingSize];
+            for (int y = startY; y < endY; y++)
+            {
+                // Notes: inputData default is vertical flipped. So rows are read in reverse order if verticalFlip == false
+                const int inputY = verticalFlip ? y : height - y - 1;
+                for (int i = -radius; i <= radius; i++)
+                {
+                    const int rowY = BayerKernel::getReflectedIndex(inputY + i, height);
+                    const int slot = rowY % RingSize;
+                    unsigned char* row = ringBuffer.data() + (long long)paddedWidth * slot + BayerKernel::RowPadding;
+                    if (ringRows[slot] != rowY)
+                    {
+                        LoadBayerRow(inputData + (long long)inputBytesPerRow * (long long)rowY, row, samples.data(), width, conversion);
+                        BayerKernel::PadRow(row, width);
+                        ringRows[slot] = rowY;
+                    }
+                    rows[i + radius] = row;
+                }
+
+                unsigned char* outputRow = outputData + (long long)outputBytesPerRow * (long long)y;
+                BayerKernel::DemosaicRow(rows, outputRow, width, BayerKernel::getRowPattern(pattern, inputY), demosaic, outputFormat);
+                if (horizontalMirror) MirrorBayerOutputRow(outputRow, width, outputFormat);
+            }
+        };
+
+        RunBands(height, threadPool, runRows, outputData, width, outputBytesPerRow, statistics);
+    }
+
+    void RowKernel::RunBayerSuperpixel(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int width,
+        const int height,
+        const int inputBytesPerRow,
+        const int outputBytesPerRow,
+        const bool verticalFlip,
+        const BayerPattern pattern,
+        const YUVOutputFormat outputFormat,
+        const bool horizontalMirror,
+        const BitDepthConversion* conversion,
+        Utils::ThreadPool* threadPool,
+        StatisticsAccumulator* statistics
+    )
+    {
+        const int outputWidth = width / 2;
+        const int outputHeight = height / 2;
+
+        // Run the output rows from startY to endY - 1
+        const auto runRows = [&](const int startY, const int endY)
+        {
+            // 16-bit rows are converted to 8 bit first
+            std::vector<unsigned char> rowBuffer(conversion != nullptr ? (size_t)width * 2 : 0);
+            std::vector<unsigned short> samples(conversion != nullptr ? width : 0);
+
+            for (int y = startY; y < endY; y++)
+            {
+                // Notes: inputData default is vertical flipped. So the blocks are read in reverse order if verticalFlip == false
+                const int blockY = verticalFlip ? y : outputHeight - y - 1;
+                const unsigned char* row0 = inputData + (long long)inputBytesPerRow * (long long)(blockY * 2);
+                const unsigned char* row1 = row0 + inputBytesPerRow;
+                if (conversion != nullptr)
+                {
+                    LoadBayerRow(row0, rowBuffer.data(), samples.data(), width, conversion);
+                    LoadBayerRow(row1, rowBuffer.data() + width, samples.data(), width, conversion);
+                    row0 = rowBuffer.data();
+                    row1 = rowBuffer.data() + width;
+                }
+
+                unsigned char* outputRow = outputData + (long long)outputBytesPerRow * (long long)y;
+                BayerKernel::SuperpixelRow(row0, row1, outputRow, outputWidth, pattern, outputFormat);
+                if (horizontalMirror) MirrorBayerOutputRow(outputRow, outputWidth, outputFormat);
+            }
+        };
+
+        RunBands(outputHeight, threadPool, runRows, outputData, outputWidth, outputBytesPerRow, statistics);
+    }
+
+    void RowKernel::RunStatistics(
+        const unsigned char* data,
+        const int width,
+        const int height,
+        const int bytesPerRow,
+        StatisticsAccumulator& statistics,
+        Utils::ThreadPool* threadPool
+    )
+    {
+        // The rows are already decoded
+        RunBands(height, threadPool, [](const int, const int) {}, data, width, bytesPerRow, &statistics);
+    }
+
+    void RowKernel::RunTensor(
+        const unsigned char* inputData,
+        const int width,
+        const int height,
+        const int inputBytesPerRow,
+        const TensorOutput& tensor,
+        Utils::ThreadPool* threadPool
+    )
+    {
+        // The rows are already decoded
+        RunTensorBands(
+            width,
+            height,
+            0,
+            tensor,
+            threadPool,
+            [&](const int y, unsigned char*)
+            {
+                return inputData + (long long)inputBytesPerRow * (long long)y;
+            }
+        );
+    }
+
+    void RowKernel::LoadBayerRow(const unsigned char* inputRow, unsigned char* outputRow, unsigned short* samples, const int width, const BitDepthConversion* conversion)
+    {
+        if (conversion == nullptr)
+        {
+            std::memcpy(outputRow, inputRow, width);
+            return;
+        }
+
+        // Scale to 8 bit and narrow
+        BitDepthKernel::Normalize((const unsigned short*)inputRow, samples, width, *conversion);
+        for (int x = 0; x < width; x++) outputRow[x] = (unsigned char)samples[x];
+    }
+
+    void RowKernel::MirrorBayerOutputRow(unsigned char* row, const int width, const YUVOutputFormat outputFormat)
+    {
+        if (YUVKernel::getBytesPerPixel(outputFormat) == 4)
+        {
+            MirrorRowInPlace<4>(row, width);
+        }
+        else
+        {
+            MirrorRowInPlace<3>(row, width);
+        }
+    }
+
+    RowKernelFunction RowKernel::getCopyKernel(const int bytesPerPixel, const bool horizontalMirror)
+    {
+        switch (bytesPerPixel)
+        {
+        case 1:
+            return horizontalMirror ? MirrorRow<1> : CopyRow<1>;
+        case 2:
+            return horizontalMirror ? MirrorRow<2> : CopyRow<2>;
+        case 3:
+            return horizontalMirror ? MirrorRow<3> : CopyRow<3>;
+        case 4:
+            return horizontalMirror ? MirrorRow<4> : CopyRow<4>;
+        default:
+            throw std::invalid_argument("Bytes per pixel(" + std::to_string(bytesPerPixel) + ") is not supported.");
+        }
+    }
+
+    RowKernelFunction RowKernel::getSwapRedBlue24Kernel(const bool horizontalMirror)
+    {
+        return horizontalMirror ? MirrorSwapRedBlue24Row : SwapRedBlue24Row;
+    }
+
+    RowKernelFunction RowKernel::getYUV422Kernel(
+        const YUV422Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat,
+        const bool horizontalMirror
+    )
+    {
+        if (layout == YUV422Layout::UYVY)
+        {
+            return colorSpace == YUVColorSpace::BT709 ?
+                getYUV422Kernel<YUV422Layout::UYVY, YUVColorSpace::BT709>(outputFormat, horizontalMirror) :
+                getYUV422Kernel<YUV422Layout::UYVY, YUVColorSpace::BT601>(outputFormat, horizontalMirror);
+        }
+        else
+        {
+            return colorSpace == YUVColorSpace::BT709 ?
+                getYUV422Kernel<YUV422Layout::YUYV, YUVColorSpace::BT709>(outputFormat, horizontalMirror) :
+                getYUV422Kernel<YUV422Layout::YUYV, YUVColorSpace::BT601>(outputFormat, horizontalMirror);
+        }
+    }
+
+    template <YUV422Layout Layout, YUVColorSpace ColorSpace>
+    RowKernelFunction RowKernel::getYUV422Kernel(const YUVOutputFormat outputFormat, const bool horizontalMirror)
+    {
+        switch (outputFormat)
+        {
+        case YUVOutputFormat::BGR24:
+            return horizontalMirror ? YUV422Row<Layout, ColorSpace, YUVOutputFormat::BGR24, true> : YUV422Row<Layout, ColorSpace, YUVOutputFormat::BGR24, false>;
+        case YUVOutputFormat::RGB24:
+            return horizontalMirror ? YUV422Row<Layout, ColorSpace, YUVOutputFormat::RGB24, true> : YUV422Row<Layout, ColorSpace, YUVOutputFormat::RGB24, false>;
+        case YUVOutputFormat::BGRA32:
+            return horizontalMirror ? YUV422Row<Layout, ColorSpace, YUVOutputFormat::BGRA32, true> : YUV422Row<Layout, ColorSpace, YUVOutputFormat::BGRA32, false>;
+        case YUVOutputFormat::RGBA32:
+            return horizontalMirror ? YUV422Row<Layout, ColorSpace, YUVOutputFormat::RGBA32, true> : YUV422Row<Layout, ColorSpace, YUVOutputFormat::RGBA32, false>;
+        case YUVOutputFormat::Gray8:
+            return horizontalMirror ? YUV422Row<Layout, ColorSpace, YUVOutputFormat::Gray8, true> : YUV422Row<Layout, ColorSpace, YUVOutputFormat::Gray8, false>;
+        default:
+            throw std::invalid_argument("YUV output format(" + std::to_string((int)outputFormat) + ") is not supported.");
+        }
+    }
+
+    YUV420RowKernelFunction RowKernel::getYUV420Kernel(
+        const YUV420Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat,
+        const bool horizontalMirror
+    )
+    {
+        if (layout == YUV420Layout::I420)
+        {
+            return colorSpace == YUVColorSpace::BT709 ?
+                getYUV420Kernel<YUV420Layout::I420, YUVColorSpace::BT709>(outputFormat, horizontalMirror) :
+                getYUV420Kernel<YUV420Layout::I420, YUVColorSpace::BT601>(outputFormat, horizontalMirror);
+        }
+        else
+        {
+            return colorSpace == YUVColorSpace::BT709 ?
+                getYUV420Kernel<YUV420Layout::NV12, YUVColorSpace::BT709>(outputFormat, horizontalMirror) :
+                getYUV420Kernel<YUV420Layout::NV12, YUVColorSpace::BT601>(outputFormat, horizontalMirror);
+        }
+    }
+
+    template <YUV420Layout Layout, YUVColorSpace ColorSpace>
+    YUV420RowKernelFunction RowKernel::getYUV420Kernel(const YUVOutputFormat outputFormat, const bool horizontalMirror)
+    {
+        switch (outputFormat)
+        {
+        case YUVOutputFormat::BGR24:
+            return horizontalMirror ? YUV420Row<Layout, ColorSpace, YUVOutputFormat::BGR24, true> : YUV420Row<Layout, ColorSpace, YUVOutputFormat::BGR24, false>;
+        case YUVOutputFormat::RGB24:
+            return horizontalMirror ? YUV420Row<Layout, ColorSpace, YUVOutputFormat::RGB24, true> : YUV420Row<Layout, ColorSpace, YUVOutputFormat::RGB24, false>;
+        case YUVOutputFormat::BGRA32:
+            return horizontalMirror ? YUV420Row<Layout, ColorSpace, YUVOutputFormat::BGRA32, true> : YUV420Row<Layout, ColorSpace, YUVOutputFormat::BGRA32, false>;
+        case YUVOutputFormat::RGBA32:
+            return horizontalMirror ? YUV420Row<Layout, ColorSpace, YUVOutputFormat::RGBA32, true> : YUV420Row<Layout, ColorSpace, YUVOutputFormat::RGBA32, false>;
+        case YUVOutputFormat::Gray8:
+            return horizontalMirror ? YUV420Row<Layout, ColorSpace, YUVOutputFormat::Gray8, true> : YUV420Row<Layout, ColorSpace, YUVOutputFormat::Gray8, false>;
+        default:
+            throw std::invalid_argument("YUV output format(" + std::to_string((int)outputFormat) + ") is not supported.");
+        }
+    }
+
+    RowKernelFunction RowKernel::getRGB16Kernel(
+        const RGB16Layout layout,
+        const YUVOutputFormat outputFormat,
+        const bool horizontalMirror
+    )
+    {
+        return layout == RGB16Layout::RGB555 ?
+            getRGB16Kernel<RGB16Layout::RGB555>(outputFormat, horizontalMirror) :
+            getRGB16Kernel<RGB16Layout::RGB565>(outputFormat, horizontalMirror);
+    }
+
+    template <RGB16Layout Layout>
+    RowKernelFunction RowKernel::getRGB16Kernel(const YUVOutputFormat outputFormat, const bool horizontalMirror)
+    {
+        switch (outputFormat)
+        {
+        case YUVOutputFormat::BGR24:
+            return horizontalMirror ? RGB16Row<Layout, YUVOutputFormat::BGR24, true> : RGB16Row<Layout, YUVOutputFormat::BGR24, false>;
+        case YUVOutputFormat::RGB24:
+            return horizontalMirror ? RGB16Row<Layout, YUVOutputFormat::RGB24, true> : RGB16Row<Layout, YUVOutputFormat::RGB24, false>;
+        case YUVOutputFormat::BGRA32:
+            return horizontalMirror ? RGB16Row<Layout, YUVOutputFormat::BGRA32, true> : RGB16Row<Layout, YUVOutputFormat::BGRA32, false>;
+        case YUVOutputFormat::RGBA32:
+            return horizontalMirror ? RGB16Row<Layout, YUVOutputFormat::RGBA32, true> : RGB16Row<Layout, YUVOutputFormat::RGBA32, false>;
+        default:
+            throw std::invalid_argument("RGB output format(" + std::to_string((int)outputFormat) + ") is not supported.");
+        }
+    }
+
+    ContextRowKernelFunction RowKernel::getPaletteKernel(const bool horizontalMirror)
+    {
+        return horizontalMirror ? PaletteRow<true> : PaletteRow<false>;
+    }
+
+    ContextRowKernelFunction RowKernel::getNormalizeKernel(const bool horizontalMirror)
+    {
+        return horizontalMirror ? NormalizeRow<true> : NormalizeRow<false>;
+    }
+
+    ContextRowKernelFunction RowKernel::getPackedMonochromeKernel(const PackedMonochromeLayout layout, const bool horizontalMirror)
+    {
+        if (layout == PackedMonochromeLayout::Y12P)
+        {
+            return horizontalMirror ? PackedMonochromeRow<PackedMonochromeLayout::Y12P, true> : PackedMonochromeRow<PackedMonochromeLayout::Y12P, false>;
+        }
+        else
+        {
+            return horizontalMirror ? PackedMonochromeRow<PackedMonochromeLayout::Y10P, true> : PackedMonochromeRow<PackedMonochromeLayout::Y10P, false>;
+        }
+    }
+
+    ContextRowKernelFunction RowKernel::getToneMapKernel(const bool horizontalMirror)
+    {
+        return horizontalMirror ? ToneMapRow<true> : ToneMapRow<false>;
+    }
+
+    ContextRowKernelFunction RowKernel::getPackedToneMapKernel(const PackedMonochromeLayout layout, const bool horizontalMirror)
+    {
+        if (layout == PackedMonochromeLayout::Y12P)
+        {
+            return horizontalMirror ? PackedToneMapRow<PackedMonochromeLayout::Y12P, true> : PackedToneMapRow<PackedMonochromeLayout::Y12P, false>;
+        }
+        else
+        {
+            return horizontalMirror ? PackedToneMapRow<PackedMonochromeLayout::Y10P, true> : PackedToneMapRow<PackedMonochromeLayout::Y10P, false>;
+        }
+    }
+
+    template <int BytesPerPixel>
+    void RowKernel::CopyRow(const unsigned char* inputRow, unsigned char* outputRow, const int width)
+    {
+        memcpy(outputRow, inputRow, (size_t)width * BytesPerPixel);
+    }
+
+    template <int BytesPerPixel>
+    void RowKernel::MirrorRow(const unsigned char* inputRow, unsigned char* outputRow, const int width)
+    {
+        // Read the input from the last pixel
+        const unsigned char* inputPixel = inputRow + (long long)(width - 1) * BytesPerPixel;
+        for (int x = 0; x < width; x++)
+        {
+            for (int i = 0; i < BytesPerPixel; i++) outputRow[i] = inputPixel[i];
+
+            // Move to next pixel
+            inputPixel -= BytesPerPixel;
+            outputRow += BytesPerPixel;
+        }
+    }
+
+    void RowKernel::SwapRedBlue24Row(const unsigned char* inputRow, unsigned char* outputRow, const int width)
+    {
+        SwizzleKernel::SwapRedBlue24(inputRow, outputRow, width);
+    }
+
+    void RowKernel::MirrorSwapRedBlue24Row(const unsigned char* inputRow, unsigned char* outputRow, const int width)
+    {
+        // Read the input from the last pixel
+        const unsigned char* inputPixel = inputRow + (long long)(width - 1) * 3;
+        for (int x = 0; x < width; x++)
+        {
+            outputRow[0] = inputPixel[2];
+            outputRow[1] = inputPixel[1];
+            outputRow[2] = inputPixel[0];
+
+            // Move to next pixel
+            inputPixel -= 3;
+            outputRow += 3;
+        }
+    }
+
+    template <int BytesPerPixel>
+    void RowKernel::MirrorRowInPlace(unsigned char* row, const int width)
+    {
+        // Swap the pixels from both ends
+        unsigned char* left = row;
+        unsigned char* right = row + (long long)(width - 1) * BytesPerPixel;
+        while (left < right)
+        {
+            for (int i = 0; i < BytesPerPixel; i++) std::swap(left[i], right[i]);
+
+            // Move to next pixel
+            left += BytesPerPixel;
+            right -= BytesPerPixel;
+        }
+    }
+
+    template <YUV422Layout Layout, YUVColorSpace ColorSpace, YUVOutputFormat OutputFormat, bool HorizontalMirror>
+    void RowKernel::YUV422Row(const unsigned char* inputRow, unsigned char* outputRow, const int width)
+    {
+        YUVKernel::YUV422ToPixels(inputRow, outputRow, width, Layout, ColorSpace, OutputFormat);
+        if constexpr (HorizontalMirror) MirrorRowInPlace<YUVKernel::getBytesPerPixel(OutputFormat)>(outputRow, width);
+    }
+
+    template <YUV420Layout Layout, YUVColorSpace ColorSpace, YUVOutputFormat OutputFormat, bool HorizontalMirror>
+    void RowKernel::YUV420Row(const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* outputRow, const int width)
+    {
+        if constexpr (OutputFormat == YUVOutputFormat::Gray8 && HorizontalMirror)
+        {
+            // The Y row is copied, so mirror it while copying
+            MirrorRow<1>(yRow, outputRow, width);
+        }
+        else
+        {
+            YUVKernel::YUV420ToPixels(yRow, uRow, vRow, outputRow, width, Layout, ColorSpace, OutputFormat);
+            if constexpr (HorizontalMirror) MirrorRowInPlace<YUVKernel::getBytesPerPixel(OutputFormat)>(outputRow, width);
+        }
+    }
+
+    template <RGB16Layout Layout, YUVOutputFormat OutputFormat, bool HorizontalMirror>
+    void RowKernel::RGB16Row(const unsigned char* inputRow, unsigned char* outputRow, const int width)
+    {
+        RGBKernel::RGB16ToPixels(inputRow, outputRow, width, Layout, OutputFormat);
+        if constexpr (HorizontalMirror) MirrorRowInPlace<YUVKernel::getBytesPerPixel(OutputFormat)>(outputRow, width);
+    }
+
+    template <bool HorizontalMirror>
+    void RowKernel::PaletteRow(const void* context, const unsigned char* inputRow, unsigned char* outputRow, const int width)
+    {
+        const RGBPaletteTable& table = *static_cast<const RGBPaletteTable*>(context);
+        RGBKernel::PaletteToPixels(inputRow, outputRow, width, table);
+        if constexpr (HorizontalMirror)
+        {
+            switch (YUVKernel::getBytesPerPixel(table.OutputFormat))
+            {
+            case 4:
+                MirrorRowInPlace<4>(outputRow, width);
+                break;
+            case 3:
+                MirrorRowInPlace<3>(outputRow, width);
+                break;
+            default:
+                MirrorRowInPlace<1>(outputRow, width);
+                break;
+            }
+        }
+    }
+
+    template <bool HorizontalMirror>
+    void RowKernel::NormalizeRow(const void* context, const unsigned char* inputRow, unsigned char* outputRow, const int width)
+    {
+        BitDepthKernel::Normalize((const unsigned short*)inputRow, (unsigned short*)outputRow, width, *static_cast<const BitDepthConversion*>(context));
+        if constexpr (HorizontalMirror) MirrorRowInPlace<2>(outputRow, width);
+    }
+
+    template <PackedMonochromeLayout Layout, bool HorizontalMirror>
+    void RowKernel::PackedMonochromeRow(const void* context, const unsigned char* inputRow, unsigned char* outputRow, const int width)
+    {
+        const BitDepthConversion& conversion = *static_cast<const BitDepthConversion*>(context);
+        BitDepthKernel::UnpackToPixels(inputRow, (unsigned short*)outputRow, width, Layout);
+        if (!BitDepthKernel::isIdentity(conversion)) BitDepthKernel::Normalize((const unsigned short*)outputRow, (unsigned short*)outputRow, width, conversion);
+        if constexpr (HorizontalMirror) MirrorRowInPlace<2>(outputRow, width);
+    }
+
+    template <bool HorizontalMirror>
+    void RowKernel::ToneMapRow(const void* context, const unsigned char* inputRow, unsigned char* outputRow, const int width)
+    {
+        const ToneMapRowContext& toneMapContext = *static_cast<const ToneMapRowContext*>(context);
+        const unsigned short* inputSamples = (const unsigned short*)inputRow;
+        if (BitDepthKernel::isIdentity(toneMapContext.Conversion))
+        {
+            ToneMapKernel::ToPixels(inputSamples, outputRow, width, toneMapContext.Table);
+        }
+        else
+        {
+            // Convert a block at a time, the block stays in the cache
+            unsigned short samples[ToneMapBlockSize];
+            for (int x = 0; x < width; x += ToneMapBlockSize)
+            {
+                const int numOfPixels = std::min(ToneMapBlockSize, width - x);
+                BitDepthKernel::Normalize(inputSamples + x, samples, numOfPixels, toneMapContext.Conversion);
+                ToneMapKernel::ToPixels(samples, outputRow + x, numOfPixels, toneMapContext.Table);
+            }
+        }
+        if constexpr (HorizontalMirror) MirrorRowInPlace<1>(outputRow, width);
+    }
+
+    template <PackedMonochromeLayout Layout, bool HorizontalMirror>
+    void RowKernel::PackedToneMapRow(const void* context, const unsigned char* inputRow, unsigned char* outputRow, const int width)
+    {
+        const ToneMapRowContext& toneMapContext = *static_cast<const ToneMapRowContext*>(context);
+        const bool isIdentity = BitDepthKernel::isIdentity(toneMapContext.Conversion);
+
+        // Unpack a block at a time, the block size is a multiple of the packing groups
+        unsigned short samples[ToneMapBlockSize];
+        for (int x = 0; x < width; x += ToneMapBlockSize)
+        {
+            const int numOfPixels = std::min(ToneMapBlockSize, width - x);
+            BitDepthKernel::UnpackToPixels(inputRow + (long long)x * BitDepthKernel::getBitDepth(Layout) / 8, samples, numOfPixels, Layout);
+            if (!isIdentity) BitDepthKernel::Normalize(samples, samples, numOfPixels, toneMapContext.Conversion);
+            ToneMapKernel::ToPixels(samples, outputRow + x, numOfPixels, toneMapContext.Table);
+        }
+        if constexpr (HorizontalMirror) MirrorRowInPlace<1>(outputRow, width);
+    }
+}
@@ -0,0 +1,431 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__ROW_KERNEL_H
+#define DIRECTSHOW_CAMERA__FRAME__ROW_KERNEL_H
+
+//************Content************
+
+#include "frame/yuv_kernel.h"
+#include "frame/rgb_kernel.h"
+#include "frame/bit_depth_kernel.h"
+#include "frame/tone_map_kernel.h"
+#include "frame/bayer_kernel.h"
+#include "frame/resize_kernel.h"
+#include "frame/statistics_kernel.h"
+#include "frame/tensor_kernel.h"
+
+namespace Utils
+{
+    class ThreadPool;
+}
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Convert a row of input pixels into a row of output pixels.
+     *        Channel reorder and horizontal mirror are done in the same pass, so each output byte is written once.
+     *        Arguments are input row, output row and width in pixels. The input and output must not overlap.
+    */
+    typedef void (*RowKernelFunction)(
+        const unsigned char* inputRow,
+        unsigned char* outputRow,
+        const int width
+    );
+
+    /**
+     * @brief Convert a row of YUV 4:2:0 pixels into a row of output pixels. The chroma rows are shared by 2 rows.
+     *        Arguments are Y row, U row, V row, output row and width in pixels. See YUVKernel::YUV420ToPixels().
+    */
+    typedef void (*YUV420RowKernelFunction)(
+        const unsigned char* yRow,
+        const unsigned char* uRow,
+        const unsigned char* vRow,
+        unsigned char* outputRow,
+        const int width
+    );
+
+    /**
+     * @brief Convert a row of input pixels into a row of output pixels with a per-frame context, e.g. a lookup table.
+     *        Arguments are context, input row, output row and width in pixels. The input and output must not overlap.
+    */
+    typedef void (*ContextRowKernelFunction)(
+        const void* context,
+        const unsigned char* inputRow,
+        unsigned char* outputRow,
+        const int width
+    );
+
+    /**
+     * @brief Context of the tone mapping kernels, see RowKernel::getToneMapKernel().
+    */
+    struct ToneMapRowContext
+    {
+        /**
+         * @brief Conversion applied to the 16-bit samples before the tone mapping
+        */
+        BitDepthConversion Conversion;
+
+        /**
+         * @brief Table of the tone mapping
+        */
+        ToneMapTable Table;
+    };
+
+    /**
+     * @brief Row-oriented decode framework. Vertical flip is done by the row order, the rest is done by a RowKernelFunction.
+     */
+    class RowKernel
+    {
+    public:
+
+        /**
+        * @brief Run a row kernel over a frame. If resizeTable is set, the output is in the size of the table and outputBytesPerRow is the bytes per resized row.
+        * @param[in] inputData Input data. Rows are stored bottom-up, i.e. the image has been flipped vertically.
+        * @param[out] outputData Output data. Rows are stored top-down.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] inputBytesPerRow Number of bytes per input row
+        * @param[in] outputBytesPerRow Number of bytes per output row
+        * @param[in] verticalFlip Flip the image vertically, i.e. keep the input row order
+        * @param[in] kernel Row kernel
+        * @param[in] threadPool (Optional) Split the rows into bands and run them on the thread pool. Default as nullptr, run on the calling thread.
+        * @param[in] resizeTable (Optional) Resize the rows by area averaging while they are decoded, see ResizeKernel. Default as nullptr, not resized.
+        * @param[in, out] statistics (Optional) Accumulate the statistics of the output rows while they are in the cache. Default as nullptr, not accumulated.
+        * @param[out] tensor (Optional) Write the output rows into a tensor instead of the output data. outputData is not used and the statistics are not accumulated. Default as nullptr, write the output data.
+        */
+        static void Run(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int inputBytesPerRow,
+            const int outputBytesPerRow,
+            const bool verticalFlip,
+            const RowKernelFunction kernel,
+            Utils::ThreadPool* threadPool = nullptr,
+            const ResizeTable* resizeTable = nullptr,
+            StatisticsAccumulator* statistics = nullptr,
+            const TensorOutput* tensor = nullptr
+        );
+
+        /**
+        * @brief Run a row kernel with a per-frame context over a frame. If resizeTable is set, the output is in the size of the table and outputBytesPerRow is the bytes per resized row.
+        * @param[in] inputData Input data. Rows are stored bottom-up, i.e. the image has been flipped vertically.
+        * @param[out] outputData Output data. Rows are stored top-down.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] inputBytesPerRow Number of bytes per input row
+        * @param[in] outputBytesPerRow Number of bytes per output row
+        * @param[in] verticalFlip Flip the image vertically, i.e. keep the input row order
+        * @param[in] kernel Row kernel
+        * @param[in] context Context passed to each row. It is shared by the bands, so it must be read only.
+        * @param[in] threadPool (Optional) Split the rows into bands and run them on the thread pool. Default as nullptr, run on the calling thread.
+        * @param[in] resizeTable (Optional) Resize the rows by area averaging while they are decoded, see ResizeKernel. Default as nullptr, not resized.
+        * @param[in, out] statistics (Optional) Accumulate the statistics of the output rows while they are in the cache. Default as nullptr, not accumulated.
+        * @param[out] tensor (Optional) Write the output rows into a tensor instead of the output data. outputData is not used and the statistics are not accumulated. Default as nullptr, write the output data.
+        */
+        static void Run(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int inputBytesPerRow,
+            const int outputBytesPerRow,
+            const bool verticalFlip,
+            const ContextRowKernelFunction kernel,
+            const void* context,
+            Utils::ThreadPool* threadPool = nullptr,
+            const ResizeTable* resizeTable = nullptr,
+            StatisticsAccumulator* statistics = nullptr,
+            const TensorOutput* tensor = nullptr
+        );
+
+        /**
+        * @brief Run a YUV 4:2:0 row kernel over the planes of a frame. The output row y reads the chroma row y / 2.
+        *        If resizeTable is set, the output is in the size of the table and outputBytesPerRow is the bytes per resized row.
+        * @param[in] planes Input planes. Rows are stored top-down.
+        * @param[out] outputData Output data. Rows are stored top-down.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] outputBytesPerRow Number of bytes per output row
+        * @param[in] verticalFlip Flip the image vertically, i.e. read the input rows in reverse order
+        * @param[in] kernel Row kernel
+        * @param[in] threadPool (Optional) Split the rows into bands and run them on the thread pool. Default as nullptr, run on the calling thread.
+        * @param[in] resizeTable (Optional) Resize the rows by area averaging while they are decoded, see ResizeKernel. Default as nullptr, not resized.
+        * @param[in, out] statistics (Optional) Accumulate the statistics of the output rows while they are in the cache. Default as nullptr, not accumulated.
+        * @param[out] tensor (Optional) Write the output rows into a tensor instead of the output data. outputData is not used and the statistics are not accumulated. Default as nullptr, write the output data.
+        */
+        static void RunYUV420(
+            const YUV420Planes& planes,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int outputBytesPerRow,
+            const bool verticalFlip,
+            const YUV420RowKernelFunction kernel,
+            Utils::ThreadPool* threadPool = nullptr,
+            const ResizeTable* resizeTable = nullptr,
+            StatisticsAccumulator* statistics = nullptr,
+            const TensorOutput* tensor = nullptr
+        );
+
+        /**
+        * @brief Demosaic a Bayer frame. Each band keeps the padded neighbor rows of its current row in a ring buffer, so each input row is read once per band.
+        * @param[in] inputData Input data. Rows are stored bottom-up, i.e. the image has been flipped vertically.
+        * @param[out] outputData Output data. Rows are stored top-down.
+        * @param[in] width Width. It must be >= 2.
+        * @param[in] height Height. It must be >= 2.
+        * @param[in] inputBytesPerRow Number of bytes per input row
+        * @param[in] outputBytesPerRow Number of bytes per output row
+        * @param[in] verticalFlip Flip the image vertically, i.e. keep the input row order
+        * @param[in] pattern Pattern of the first row of the input data
+        * @param[in] demosaic Demosaic
+        * @param[in] outputFormat Output format. YUVOutputFormat::Gray8 is not supported.
+        * @param[in] horizontalMirror Mirror the rows horizontally
+        * @param[in] conversion Conversion of the 16-bit samples to 8 bit. Set it as nullptr if the samples are 8 bit.
+        * @param[in] threadPool (Optional) Split the rows into bands and run them on the thread pool. Default as nullptr, run on the calling thread.
+        * @param[in, out] statistics (Optional) Accumulate the statistics of the output rows while they are in the cache. Default as nullptr, not accumulated.
+        */
+        static void RunBayer(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int inputBytesPerRow,
+            const int outputBytesPerRow,
+            const bool verticalFlip,
+            const BayerPattern pattern,
+            const BayerDemosaic demosaic,
+            const YUVOutputFormat outputFormat,
+            const bool horizontalMirror,
+            const BitDepthConversion* conversion,
+            Utils::ThreadPool* threadPool = nullptr,
+            StatisticsAccumulator* statistics = nullptr
+        );
+
+        /**
+        * @brief Merge each 2 x 2 block of a Bayer frame into a pixel. The output is width / 2 x height / 2.
+        * @param[in] inputData Input data. Rows are stored bottom-up, i.e. the image has been flipped vertically.
+        * @param[out] outputData Output data. Rows are stored top-down.
+        * @param[in] width Input width. It must be even.
+        * @param[in] height Input height. It must be even.
+        * @param[in] inputBytesPerRow Number of bytes per input row
+        * @param[in] outputBytesPerRow Number of bytes per output row
+        * @param[in] verticalFlip Flip the image vertically, i.e. keep the input row order
+        * @param[in] pattern Pattern of the first row of the input data
+        * @param[in] outputFormat Output format. YUVOutputFormat::Gray8 is not supported.
+        * @param[in] horizontalMirror Mirror the rows horizontally
+        * @param[in] conversion Conversion of the 16-bit samples to 8 bit. Set it as nullptr if the samples are 8 bit.
+        * @param[in] threadPool (Optional) Split the rows into bands and run them on the thread pool. Default as nullptr, run on the calling thread.
+        * @param[in, out] statistics (Optional) Accumulate the statistics of the output rows while they are in the cache. Default as nullptr, not accumulated.
+        */
+        static void RunBayerSuperpixel(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int width,
+            const int height,
+            const int inputBytesPerRow,
+            const int outputBytesPerRow,
+            const bool verticalFlip,
+            const BayerPattern pattern,
+            const YUVOutputFormat outputFormat,
+            const bool horizontalMirror,
+            const BitDepthConversion* conversion,
+            Utils::ThreadPool* threadPool = nullptr,
+            StatisticsAccumulator* statistics = nullptr
+        );
+
+        /**
+        * @brief Accumulate the statistics of a decoded frame. It is used by the decoders which don't decode a frame row by row, e.g. MJPEG.
+        * @param[in] data Decoded data. Rows are stored top-down.
+        * @param[in] width Width
+        * @param[in] height Height
+        * @param[in] bytesPerRow Number of bytes per row
+        * @param[in, out] statistics Statistics accumulator
+        * @param[in] threadPool (Optional) Split the rows into bands and run them on the thread pool. Default as nullptr, run on the calling thread.
+        */
+        static void RunStatistics(
+            const unsigned char* data,
+            const int width,
+            const int height,
+            const int bytesPerRow,
+            StatisticsAccumulator& statistics,
+            Utils::ThreadPool* threadPool = nullptr
+        );
+
+        /**
+        * @brief Convert a decoded frame into the planes of a tensor. It is used by the decoders which don't decode a frame row by row, e.g. MJPEG.
+        *        The elements of the tensor outside the frame are padded in the same pass.
+        * @param[in] inputData Decoded data. Rows are stored top-down.
+        * @param[in] width Width of the decoded frame
+        * @param[in] height Height of the decoded frame
+        * @param[in] inputBytesPerRow Number of bytes per decoded row
+        * @param[out] tensor Tensor
+        * @param[in] threadPool (Optional) Split the rows into bands and run them on the thread pool. Default as nullptr, run on the calling thread.
+        */
+        static void RunTensor(
+            const unsigned char* inputData,
+            const int width,
+            const int height,
+            const int inputBytesPerRow,
+            const TensorOutput& tensor,
+            Utils::ThreadPool* threadPool = nullptr
+        );
+
+        /**
+        * @brief Get a kernel copying the pixels
+        * @param[in] bytesPerPixel Bytes per pixel. It must be 1, 2, 3 or 4.
+        * @param[in] horizontalMirror Mirror the row horizontally
+        * @return Return the kernel
+        */
+        static RowKernelFunction getCopyKernel(const int bytesPerPixel, const bool horizontalMirror);
+
+        /**
+        * @brief Get a kernel swapping the first and the third byte of 24-bit pixels, i.e. BGR to RGB
+        * @param[in] horizontalMirror Mirror the row horizontally
+        * @return Return the kernel
+        */
+        static RowKernelFunction getSwapRedBlue24Kernel(const bool horizontalMirror);
+
+        /**
+        * @brief Get a kernel converting packed YUV 4:2:2 pixels. The mirror is done in place on the converted row while it is still in the cache.
+        * @param[in] layout Byte order of the input
+        * @param[in] colorSpace Color matrix
+        * @param[in] outputFormat Output format
+        * @param[in] horizontalMirror Mirror the row horizontally
+        * @return Return the kernel. The width must be even.
+        */
+        static RowKernelFunction getYUV422Kernel(
+            const YUV422Layout layout,
+            const YUVColorSpace colorSpace,
+            const YUVOutputFormat outputFormat,
+            const bool horizontalMirror
+        );
+
+        /**
+        * @brief Get a kernel converting YUV 4:2:0 pixels. The mirror is done in place on the converted row while it is still in the cache.
+        * @param[in] layout Plane layout of the input
+        * @param[in] colorSpace Color matrix
+        * @param[in] outputFormat Output format
+        * @param[in] horizontalMirror Mirror the row horizontally
+        * @return Return the kernel
+        */
+        static YUV420RowKernelFunction getYUV420Kernel(
+            const YUV420Layout layout,
+            const YUVColorSpace colorSpace,
+            const YUVOutputFormat outputFormat,
+            const bool horizontalMirror
+        );
+
+        /**
+        * @brief Get a kernel expanding 16-bit RGB pixels. The mirror is done in place on the expanded row while it is still in the cache.
+        * @param[in] layout Bit layout of the input
+        * @param[in] outputFormat Output format. YUVOutputFormat::Gray8 is not supported.
+        * @param[in] horizontalMirror Mirror the row horizontally
+        * @return Return the kernel
+        */
+        static RowKernelFunction getRGB16Kernel(
+            const RGB16Layout layout,
+            const YUVOutputFormat outputFormat,
+            const bool horizontalMirror
+        );
+
+        /**
+        * @brief Get a kernel looking up 8 bit palette pixels. The context is a RGBPaletteTable, see RGBKernel::BuildPaletteTable().
+        * @param[in] horizontalMirror Mirror the row horizontally
+        * @return Return the kernel
+        */
+        static ContextRowKernelFunction getPaletteKernel(const bool horizontalMirror);
+
+        /**
+        * @brief Get a kernel shifting and scaling 16-bit monochrome samples. The context is a BitDepthConversion.
+        * @param[in] horizontalMirror Mirror the row horizontally
+        * @return Return the kernel
+        */
+        static ContextRowKernelFunction getNormalizeKernel(const bool horizontalMirror);
+
+        /**
+        * @brief Get a kernel unpacking packed monochrome pixels into 16-bit samples. The context is a BitDepthConversion applied to the unpacked samples,
+        *        its input bit depth must be the bit depth of the layout. The samples are normalized and mirrored in place while they are still in the cache.
+        * @param[in] layout Bit layout of the input
+        * @param[in] horizontalMirror Mirror the row horizontally
+        * @return Return the kernel. The width must be a multiple of BitDepthKernel::getPixelsPerGroup().
+        */
+        static ContextRowKernelFunction getPackedMonochromeKernel(const PackedMonochromeLayout layout, const bool horizontalMirror);
+
+        /**
+        * @brief Get a kernel mapping 16-bit monochrome samples to 8 bit pixels. The context is a ToneMapRowContext.
+        *        The samples are converted and mapped in blocks on the stack, so the 16-bit row is never written to memory.
+        * @param[in] horizontalMirror Mirror the row horizontally
+        * @return Return the kernel
+        */
+        static ContextRowKernelFunction getToneMapKernel(const bool horizontalMirror);
+
+        /**
+        * @brief Get a kernel unpacking packed monochrome pixels and mapping them to 8 bit pixels. The context is a ToneMapRowContext,
+        *        the input bit depth of its conversion must be the bit depth of the layout.
+        * @param[in] layout Bit layout of the input
+        * @param[in] horizontalMirror Mirror the row horizontally
+        * @return Return the kernel. The width must be a multiple of BitDepthKernel::getPixelsPerGroup().
+        */
+        static ContextRowKernelFunction getPackedToneMapKernel(const PackedMonochromeLayout layout, const bool horizontalMirror);
+
+    private:
+        template <int BytesPerPixel>
+        static void CopyRow(const unsigned char* inputRow, unsigned char* outputRow, const int width);
+
+        template <int BytesPerPixel>
+        static void MirrorRow(const unsigned char* inputRow, unsigned char* outputRow, const int width);
+
+        static void SwapRedBlue24Row(const unsigned char* inputRow, unsigned char* outputRow, const int width);
+        static void MirrorSwapRedBlue24Row(const unsigned char* inputRow, unsigned char* outputRow, const int width);
+
+        template <int BytesPerPixel>
+        static void MirrorRowInPlace(unsigned char* row, const int width);
+
+        static void LoadBayerRow(const unsigned char* inputRow, unsigned char* outputRow, unsigned short* samples, const int width, const BitDepthConversion* conversion);
+        static void MirrorBayerOutputRow(unsigned char* row, const int width, const YUVOutputFormat outputFormat);
+
+        template <YUV422Layout Layout, YUVColorSpace ColorSpace>
+        static RowKernelFunction getYUV422Kernel(const YUVOutputFormat outputFormat, const bool horizontalMirror);
+
+        template <YUV422Layout Layout, YUVColorSpace ColorSpace, YUVOutputFormat OutputFormat, bool HorizontalMirror>
+        static void YUV422Row(const unsigned char* inputRow, unsigned char* outputRow, const int width);
+
+        template <YUV420Layout Layout, YUVColorSpace ColorSpace>
+        static YUV420RowKernelFunction getYUV420Kernel(const YUVOutputFormat outputFormat, const bool horizontalMirror);
+
+        template <YUV420Layout Layout, YUVColorSpace ColorSpace, YUVOutputFormat OutputFormat, bool HorizontalMirror>
+        static void YUV420Row(const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* outputRow, const int width);
+
+        template <RGB16Layout Layout>
+        static RowKernelFunction getRGB16Kernel(const YUVOutputFormat outputFormat, const bool horizontalMirror);
+
+        template <RGB16Layout Layout, YUVOutputFormat OutputFormat, bool HorizontalMirror>
+        static void RGB16Row(const unsigned char* inputRow, unsigned char* outputRow, const int width);
+
+        template <bool HorizontalMirror>
+        static void NormalizeRow(const void* context, const unsigned char* inputRow, unsigned char* outputRow, const int width);
+
+        template <PackedMonochromeLayout Layout, bool HorizontalMirror>
+        static void PackedMonochromeRow(const void* context, const unsigned char* inputRow, unsigned char* outputRow, const int width);
+
+        template <bool HorizontalMirror>
+        static void ToneMapRow(const void* context, const unsigned char* inputRow, unsigned char* outputRow, const int width);
+
+        template <PackedMonochromeLayout Layout, bool HorizontalMirror>
+        static void PackedToneMapRow(const void* context, const unsigned char* inputRow, unsigned char* outputRow, const int width);
+
+        template <bool HorizontalMirror>
+        static void PaletteRow(const void* context, const unsigned char* inputRow, unsigned char* outputRow, const int width);
+    };
+}
+
+//*******************************
+
+#endif
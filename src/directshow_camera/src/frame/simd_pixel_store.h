@@ -0,0 +1,69 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__SIMD_PIXEL_STORE_H
+#define DIRECTSHOW_CAMERA__FRAME__SIMD_PIXEL_STORE_H
+
+//************Content************
+
+#include "utils/cpu_utils.h"
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+#include <immintrin.h>
+
+// Store helpers shared by the SIMD pixel kernels. Include it in the kernel source files only.
+namespace DirectShowCamera
+{
+    /**
+     * @brief Interleave and store 16 pixels
+     * @param[in] c0 First channel
+     * @param[in] c1 Second channel
+     * @param[in] c2 Third channel
+     * @param[out] outputData Output pixels. 48 bytes are written, 64 bytes if hasAlpha is true.
+     * @param[in] hasAlpha Store the alpha channel as 255
+    */
+    DIRECTSHOW_CAMERA_TARGET("ssse3")
+    inline void StorePixelsSSSE3(const __m128i c0, const __m128i c1, const __m128i c2, unsigned char* outputData, const bool hasAlpha)
+    {
+        const __m128i alpha = _mm_set1_epi8(-1);
+        const __m128i c01Low = _mm_unpacklo_epi8(c0, c1);
+        const __m128i c01High = _mm_unpackhi_epi8(c0, c1);
+        const __m128i c2aLow = _mm_unpacklo_epi8(c2, alpha);
+        const __m128i c2aHigh = _mm_unpackhi_epi8(c2, alpha);
+        __m128i p0 = _mm_unpacklo_epi16(c01Low, c2aLow);
+        __m128i p1 = _mm_unpackhi_epi16(c01Low, c2aLow);
+        __m128i p2 = _mm_unpacklo_epi16(c01High, c2aHigh);
+        __m128i p3 = _mm_unpackhi_epi16(c01High, c2aHigh);
+
+        if (hasAlpha)
+        {
+            _mm_storeu_si128((__m128i*)outputData, p0);
+            _mm_storeu_si128((__m128i*)(outputData + 16), p1);
+            _mm_storeu_si128((__m128i*)(outputData + 32), p2);
+            _mm_storeu_si128((__m128i*)(outputData + 48), p3);
+        }
+        else
+        {
+            // Drop the alpha, 12 bytes per 4 pixels, and join them into 3 stores
+            const __m128i packMask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+            p0 = _mm_shuffle_epi8(p0, packMask);
+            p1 = _mm_shuffle_epi8(p1, packMask);
+            p2 = _mm_shuffle_epi8(p2, packMask);
+            p3 = _mm_shuffle_epi8(p3, packMask);
+            _mm_storeu_si128((__m128i*)outputData, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+            _mm_storeu_si128((__m128i*)(outputData + 16), _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+            _mm_storeu_si128((__m128i*)(outputData + 32), _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+        }
+    }
+}
+
+#endif // def DIRECTSHOW_CAMERA_X86
+
+//*******************************
+
+#endif
@@ -0,0 +1,227 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "frame/statistics_kernel.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace DirectShowCamera
+{
+    StatisticsAccumulator StatisticsKernel::CreateAccumulator(const int channels, const int bytesPerSample, const int bitDepth, const int sampleStep)
+    {
+        // Check
+        if (channels != 1 && channels != 3) throw std::invalid_argument("Channels(" + std::to_string(channels) + ") should be 1 or 3.");
+        if (bytesPerSample != 1 && bytesPerSample != 2) throw std::invalid_argument("Bytes per sample(" + std::to_string(bytesPerSample) + ") should be 1 or 2.");
+        if (bytesPerSample == 2 && channels != 1) throw std::invalid_argument("Channels(" + std::to_string(channels) + ") of the 16-bit samples should be 1.");
+        if (bytesPerSample == 1 ? bitDepth != 8 : bitDepth < 8 || bitDepth > 16)
+        {
+            throw std::invalid_argument("Bit depth(" + std::to_string(bitDepth) + ") is not supported by " + std::to_string(bytesPerSample) + " bytes per sample.");
+        }
+        if (sampleStep < 1) throw std::invalid_argument("Sample step(" + std::to_string(sampleStep) + ") should be >= 1.");
+
+        StatisticsAccumulator accumulator;
+        accumulator.Channels = channels;
+        accumulator.BytesPerSample = bytesPerSample;
+        accumulator.BitDepth = bitDepth;
+        accumulator.SampleStep = sampleStep;
+        accumulator.Histograms.assign((size_t)channels * StatisticsAccumulator::NumOfSubHistograms * FrameStatistics::NumOfBins, 0);
+        accumulator.Mins.fill(std::numeric_limits<int>::max());
+        accumulator.Maxs.fill(0);
+        return accumulator;
+    }
+
+    StatisticsAccumulator StatisticsKernel::CreateAccumulator(const StatisticsAccumulator& accumulator)
+    {
+        return CreateAccumulator(accumulator.Channels, accumulator.BytesPerSample, accumulator.BitDepth, accumulator.SampleStep);
+    }
+
+    void StatisticsKernel::AccumulateRow(const unsigned char* row, const int width, StatisticsAccumulator& accumulator)
+    {
+        if (accumulator.BytesPerSample == 2)
+        {
+            AccumulateRow16Bit((const unsigned short*)row, width, accumulator);
+        }
+        else if (accumulator.Channels == 3)
+        {
+            AccumulateRow8Bit<3>(row, width, accumulator);
+        }
+        else
+        {
+            AccumulateRow8Bit<1>(row, width, accumulator);
+        }
+    }
+
+    template <int Channels>
+    void StatisticsKernel::AccumulateRow8Bit(const unsigned char* row, const int width, StatisticsAccumulator& accumulator)
+    {
+        constexpr int NumOfBins = FrameStatistics::NumOfBins;
+        const int step = accumulator.SampleStep * Channels;
+        const int numOfPixels = (width + accumulator.SampleStep - 1) / accumulator.SampleStep;
+
+        // 4 neighbor pixels are counted in the 4 sub-histograms, the sub-histogram i of the channel c is (i * Channels + c)
+        unsigned int* histograms = accumulator.Histograms.data();
+        const unsigned char* pixel = row;
+        int i = 0;
+        for (; i + 4 <= numOfPixels; i += 4, pixel += 4 * step)
+        {
+            for (int c = 0; c < Channels; c++)
+            {
+                histograms[c * NumOfBins + pixel[c]]++;
+                histograms[(Channels + c) * NumOfBins + pixel[step + c]]++;
+                histograms[(2 * Channels + c) * NumOfBins + pixel[2 * step + c]]++;
+                histograms[(3 * Channels + c) * NumOfBins + pixel[3 * step + c]]++;
+            }
+        }
+        for (; i < numOfPixels; i++, pixel += step)
+        {
+            for (int c = 0; c < Channels; c++)
+            {
+                histograms[c * NumOfBins + pixel[c]]++;
+            }
+        }
+
+        // The saturated samples of each channel are in the last bin, the saturated pixels of 1 channel too
+        if constexpr (Channels > 1)
+        {
+            long long numOfSaturatedPixels = 0;
+            pixel = row;
+            for (i = 0; i < numOfPixels; i++, pixel += step)
+            {
+                numOfSaturatedPixels += (pixel[0] == 255) | (pixel[1] == 255) | (pixel[2] == 255);
+            }
+            accumulator.NumOfSaturatedPixels += numOfSaturatedPixels;
+        }
+
+        accumulator.NumOfPixels += numOfPixels;
+    }
+
+    void StatisticsKernel::AccumulateRow16Bit(const unsigned short* row, const int width, StatisticsAccumulator& accumulator)
+    {
+        constexpr int NumOfBins = FrameStatistics::NumOfBins;
+        const int step = accumulator.SampleStep;
+        const int numOfPixels = (width + step - 1) / step;
+        const int shift = accumulator.BitDepth - 8;
+        const int saturatedSample = (1 << accumulator.BitDepth) - 1;
+
+        // Moments. The loop is branchless, so it is vectorized if all pixels are sampled.
+        int minSample = accumulator.Mins[0];
+        int maxSample = accumulator.Maxs[0];
+        unsigned long long sum = 0;
+        unsigned int numOfSaturatedSamples = 0;
+        if (step == 1)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                const int sample = row[x];
+                sum += (unsigned int)sample;
+                minSample = std::min(minSample, sample);
+                maxSample = std::max(maxSample, sample);
+                numOfSaturatedSamples += sample >= saturatedSample;
+            }
+        }
+        else
+        {
+            for (int x = 0; x < width; x += step)
+            {
+                const int sample = row[x];
+                sum += (unsigned int)sample;
+                minSample = std::min(minSample, sample);
+                maxSample = std::max(maxSample, sample);
+                numOfSaturatedSamples += sample >= saturatedSample;
+            }
+        }
+
+        // Histogram. The samples above the bit depth, e.g. garbage in the unused bits, are counted in the last bin.
+        unsigned int* histograms = accumulator.Histograms.data();
+        const unsigned short* sample = row;
+        int i = 0;
+        for (; i + 4 <= numOfPixels; i += 4, sample += 4 * step)
+        {
+            histograms[std::min(sample[0] >> shift, NumOfBins - 1)]++;
+            histograms[NumOfBins + std::min(sample[step] >> shift, NumOfBins - 1)]++;
+            histograms[2 * NumOfBins + std::min(sample[2 * step] >> shift, NumOfBins - 1)]++;
+            histograms[3 * NumOfBins + std::min(sample[3 * step] >> shift, NumOfBins - 1)]++;
+        }
+        for (; i < numOfPixels; i++, sample += step)
+        {
+            histograms[std::min(sample[0] >> shift, NumOfBins - 1)]++;
+        }
+
+        accumulator.Sums[0] += sum;
+        accumulator.Mins[0] = minSample;
+        accumulator.Maxs[0] = maxSample;
+        accumulator.NumOfSaturatedSamples[0] += numOfSaturatedSamples;
+        accumulator.NumOfPixels += numOfPixels;
+    }
+
+    void StatisticsKernel::Merge(const StatisticsAccumulator& partial, StatisticsAccumulator& accumulator)
+    {
+        for (size_t i = 0; i < accumulator.Histograms.size(); i++)
+        {
+            accumulator.Histograms[i] += partial.Histograms[i];
+        }
+        for (int c = 0; c < FrameStatistics::MaxChannels; c++)
+        {
+            accumulator.Sums[c] += partial.Sums[c];
+            accumulator.Mins[c] = std::min(accumulator.Mins[c], partial.Mins[c]);
+            accumulator.Maxs[c] = std::max(accumulator.Maxs[c], partial.Maxs[c]);
+            accumulator.NumOfSaturatedSamples[c] += partial.NumOfSaturatedSamples[c];
+        }
+        accumulator.NumOfPixels += partial.NumOfPixels;
+        accumulator.NumOfSaturatedPixels += partial.NumOfSaturatedPixels;
+    }
+
+    FrameStatistics StatisticsKernel::getStatistics(const StatisticsAccumulator& accumulator)
+    {
+        FrameStatistics statistics;
+        statistics.Channels = accumulator.Channels;
+        statistics.BitDepth = accumulator.BitDepth;
+        statistics.NumOfPixels = accumulator.NumOfPixels;
+        statistics.NumOfSaturatedPixels = accumulator.NumOfSaturatedPixels;
+
+        for (int c = 0; c < accumulator.Channels; c++)
+        {
+            // Merge the sub-histograms
+            auto& histogram = statistics.Histograms[c];
+            for (int i = 0; i < StatisticsAccumulator::NumOfSubHistograms; i++)
+            {
+                const unsigned int* subHistogram = accumulator.Histograms.data() + (i * accumulator.Channels + c) * FrameStatistics::NumOfBins;
+                for (int bin = 0; bin < FrameStatistics::NumOfBins; bin++)
+                {
+                    histogram[bin] += subHistogram[bin];
+                }
+            }
+            if (accumulator.NumOfPixels == 0) continue;
+
+            if (accumulator.BytesPerSample == 2)
+            {
+                statistics.Means[c] = (double)accumulator.Sums[c] / (double)accumulator.NumOfPixels;
+                statistics.Mins[c] = accumulator.Mins[c];
+                statistics.Maxs[c] = accumulator.Maxs[c];
+                statistics.NumOfSaturatedSamples[c] = accumulator.NumOfSaturatedSamples[c];
+            }
+            else
+            {
+                // The bins of the 8 bit samples are the samples
+                unsigned long long sum = 0;
+                for (int bin = 0; bin < FrameStatistics::NumOfBins; bin++)
+                {
+                    sum += (unsigned long long)bin * histogram[bin];
+                }
+                statistics.Means[c] = (double)sum / (double)accumulator.NumOfPixels;
+                statistics.Mins[c] = (int)(std::find_if(histogram.begin(), histogram.end(), [](const unsigned int count) { return count > 0; }) - histogram.begin());
+                statistics.Maxs[c] = FrameStatistics::NumOfBins - 1 - (int)(std::find_if(histogram.rbegin(), histogram.rend(), [](const unsigned int count) { return count > 0; }) - histogram.rbegin());
+                statistics.NumOfSaturatedSamples[c] = histogram[FrameStatistics::NumOfBins - 1];
+            }
+        }
+        if (accumulator.Channels == 1) statistics.NumOfSaturatedPixels = statistics.NumOfSaturatedSamples[0];
+
+        return statistics;
+    }
+}
@@ -0,0 +1,155 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__STATISTICS_KERNEL_H
+#define DIRECTSHOW_CAMERA__FRAME__STATISTICS_KERNEL_H
+
+//************Content************
+
+#include "frame/frame_statistics.h"
+
+#include <array>
+#include <vector>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Partial statistics of the decoded rows of a frame. See StatisticsKernel::CreateAccumulator().
+    */
+    struct StatisticsAccumulator
+    {
+        /**
+         * @brief Number of histograms per channel. Neighbor pixels are counted in different histograms, so the increments of a run of equal samples don't wait for each other.
+        */
+        static constexpr int NumOfSubHistograms = 4;
+
+        /**
+         * @brief Samples per pixel, 1 or 3
+        */
+        int Channels = 1;
+
+        /**
+         * @brief Bytes per sample, 1 or 2
+        */
+        int BytesPerSample = 1;
+
+        /**
+         * @brief Bit depth of the samples
+        */
+        int BitDepth = 8;
+
+        /**
+         * @brief Sample every n-th pixel of every n-th row
+        */
+        int SampleStep = 1;
+
+        /**
+         * @brief Number of sampled pixels
+        */
+        long long NumOfPixels = 0;
+
+        /**
+         * @brief Number of sampled pixels with any channel saturated. It is only counted if there are more than 1 channel.
+        */
+        long long NumOfSaturatedPixels = 0;
+
+        /**
+         * @brief Histograms of FrameStatistics::NumOfBins bins, NumOfSubHistograms per channel. The sub-histogram i of the channel c is (i * Channels + c).
+        */
+        std::vector<unsigned int> Histograms;
+
+        /**
+         * @brief Sum of each channel. It is only counted for the 16-bit samples, the 8 bit sums are taken from the histograms.
+        */
+        std::array<unsigned long long, FrameStatistics::MaxChannels> Sums = {};
+
+        /**
+         * @brief Minimum of each channel. It is only counted for the 16-bit samples.
+        */
+        std::array<int, FrameStatistics::MaxChannels> Mins = {};
+
+        /**
+         * @brief Maximum of each channel. It is only counted for the 16-bit samples.
+        */
+        std::array<int, FrameStatistics::MaxChannels> Maxs = {};
+
+        /**
+         * @brief Number of saturated samples of each channel. It is only counted for the 16-bit samples.
+        */
+        std::array<long long, FrameStatistics::MaxChannels> NumOfSaturatedSamples = {};
+    };
+
+    /**
+     * @brief Statistics kernels. The decoded rows are accumulated while they are still in the cache, so the statistics don't read the frame again.
+     *
+     * The histograms are counted in NumOfSubHistograms interleaved copies per channel and merged at the end. The 8 bit sums, minimums and maximums are taken from the histograms,
+     * the 16-bit ones are accumulated in a separate branchless loop which the compiler vectorizes.
+    */
+    class StatisticsKernel
+    {
+    public:
+
+        /**
+         * @brief Create an empty accumulator. If the arguments are invalid, throw exception.
+         * @param[in] channels Samples per pixel. It must be 1 or 3.
+         * @param[in] bytesPerSample Bytes per sample. It must be 1 or 2.
+         * @param[in] bitDepth Bit depth of the samples. It must be 8 for the 8 bit samples or from 8 to 16 for the 16-bit samples.
+         * @param[in] sampleStep Sample every n-th pixel of every n-th row. It must be >= 1.
+         * @return Return the accumulator
+        */
+        static StatisticsAccumulator CreateAccumulator(const int channels, const int bytesPerSample, const int bitDepth, const int sampleStep);
+
+        /**
+         * @brief Create an empty accumulator in the same format as another accumulator, e.g. for a band of rows
+         * @param[in] accumulator Accumulator
+         * @return Return the accumulator
+        */
+        static StatisticsAccumulator CreateAccumulator(const StatisticsAccumulator& accumulator);
+
+        /**
+         * @brief Check whether a row is sampled
+         * @param[in] accumulator Accumulator
+         * @param[in] y Row from the top of the decoded frame
+         * @return Return true if the row is sampled
+        */
+        static bool isSampledRow(const StatisticsAccumulator& accumulator, const int y)
+        {
+            return y % accumulator.SampleStep == 0;
+        }
+
+        /**
+         * @brief Accumulate the sampled pixels of a decoded row
+         * @param[in] row Decoded row
+         * @param[in] width Width
+         * @param[in, out] accumulator Accumulator
+        */
+        static void AccumulateRow(const unsigned char* row, const int width, StatisticsAccumulator& accumulator);
+
+        /**
+         * @brief Merge a partial accumulator, e.g. of a band of rows. Both must be in the same format.
+         * @param[in] partial Partial accumulator
+         * @param[in, out] accumulator Accumulator
+        */
+        static void Merge(const StatisticsAccumulator& partial, StatisticsAccumulator& accumulator);
+
+        /**
+         * @brief Get the statistics of an accumulator
+         * @param[in] accumulator Accumulator
+         * @return Return the statistics
+        */
+        static FrameStatistics getStatistics(const StatisticsAccumulator& accumulator);
+
+    private:
+        template <int Channels>
+        static void AccumulateRow8Bit(const unsigned char* row, const int width, StatisticsAccumulator& accumulator);
+        static void AccumulateRow16Bit(const unsigned short* row, const int width, StatisticsAccumulator& accumulator);
+    };
+}
+
+//*******************************
+
+#endif
@@ -0,0 +1,145 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "frame/swizzle_kernel.h"
+
+#include "utils/cpu_utils.h"
+
+#ifdef DIRECTSHOW_CAMERA_X86
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+
+namespace DirectShowCamera
+{
+    SIMDLevel SwizzleKernel::getSIMDLevel()
+    {
+        static const SIMDLevel simdLevel = []() {
+            if (Utils::CPUUtils::isAVX2Supported()) return SIMDLevel::AVX2;
+            if (Utils::CPUUtils::isSSSE3Supported()) return SIMDLevel::SSSE3;
+            return SIMDLevel::Scalar;
+        }();
+        return simdLevel;
+    }
+
+    void SwizzleKernel::SwapRedBlue24(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels
+    )
+    {
+        SwapRedBlue24(inputData, outputData, numOfPixels, getSIMDLevel());
+    }
+
+    void SwizzleKernel::SwapRedBlue24(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const SIMDLevel simdLevel
+    )
+    {
+        switch (std::min(simdLevel, getSIMDLevel()))
+        {
+        case SIMDLevel::AVX2:
+            SwapRedBlue24AVX2(inputData, outputData, numOfPixels);
+            break;
+        case SIMDLevel::SSSE3:
+            SwapRedBlue24SSSE3(inputData, outputData, numOfPixels);
+            break;
+        default:
+            SwapRedBlue24Scalar(inputData, outputData, numOfPixels);
+            break;
+        }
+    }
+
+    void SwizzleKernel::SwapRedBlue24Scalar(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels)
+    {
+        for (int i = 0; i < numOfPixels; i++)
+        {
+            outputData[0] = inputData[2];
+            outputData[1] = inputData[1];
+            outputData[2] = inputData[0];
+
+            // Move to next pixel
+            inputData += 3;
+            outputData += 3;
+        }
+    }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+    DIRECTSHOW_CAMERA_TARGET("ssse3")
+    void SwizzleKernel::SwapRedBlue24SSSE3(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels)
+    {
+        // 5 pixels per 16 bytes. The 16th byte is kept and rewritten by the next store, so stores must go forward.
+        const __m128i shuffleMask = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+        const int numOfBytes = numOfPixels * 3;
+
+        int i = 0;
+        for (; i + 61 <= numOfBytes; i += 60)
+        {
+            const __m128i v0 = _mm_loadu_si128((const __m128i*)(inputData + i));
+            const __m128i v1 = _mm_loadu_si128((const __m128i*)(inputData + i + 15));
+            const __m128i v2 = _mm_loadu_si128((const __m128i*)(inputData + i + 30));
+            const __m128i v3 = _mm_loadu_si128((const __m128i*)(inputData + i + 45));
+            _mm_storeu_si128((__m128i*)(outputData + i), _mm_shuffle_epi8(v0, shuffleMask));
+            _mm_storeu_si128((__m128i*)(outputData + i + 15), _mm_shuffle_epi8(v1, shuffleMask));
+            _mm_storeu_si128((__m128i*)(outputData + i + 30), _mm_shuffle_epi8(v2, shuffleMask));
+            _mm_storeu_si128((__m128i*)(outputData + i + 45), _mm_shuffle_epi8(v3, shuffleMask));
+        }
+        for (; i + 16 <= numOfBytes; i += 15)
+        {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(inputData + i));
+            _mm_storeu_si128((__m128i*)(outputData + i), _mm_shuffle_epi8(v, shuffleMask));
+        }
+
+        // Remaining pixels
+        SwapRedBlue24Scalar(inputData + i, outputData + i, (numOfBytes - i) / 3);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2")
+    void SwizzleKernel::SwapRedBlue24AVX2(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels)
+    {
+        // 8 pixels per 32 bytes. Pixel 0-3 go to the low lane and pixel 4-7 go to the high lane, so that the shuffle doesn't cross lanes.
+        // The last 8 bytes of a store are rewritten by the next store, so stores must go forward.
+        const __m256i spreadIndex = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+        const __m256i packIndex = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+        const __m256i shuffleMask = _mm256_setr_epi8(
+            2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, -1, -1, -1, -1,
+            2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, -1, -1, -1, -1
+        );
+        const int numOfBytes = numOfPixels * 3;
+
+        int i = 0;
+        for (; i + 56 <= numOfBytes; i += 48)
+        {
+            __m256i v0 = _mm256_loadu_si256((const __m256i*)(inputData + i));
+            __m256i v1 = _mm256_loadu_si256((const __m256i*)(inputData + i + 24));
+            v0 = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(v0, spreadIndex), shuffleMask), packIndex);
+            v1 = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(v1, spreadIndex), shuffleMask), packIndex);
+            _mm256_storeu_si256((__m256i*)(outputData + i), v0);
+            _mm256_storeu_si256((__m256i*)(outputData + i + 24), v1);
+        }
+
+        // Remaining pixels
+        SwapRedBlue24SSSE3(inputData + i, outputData + i, (numOfBytes - i) / 3);
+    }
+
+#else
+
+    void SwizzleKernel::SwapRedBlue24SSSE3(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels)
+    {
+        SwapRedBlue24Scalar(inputData, outputData, numOfPixels);
+    }
+
+    void SwizzleKernel::SwapRedBlue24AVX2(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels)
+    {
+        SwapRedBlue24Scalar(inputData, outputData, numOfPixels);
+    }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+}
@@ -0,0 +1,75 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__SWIZZLE_KERNEL_H
+#define DIRECTSHOW_CAMERA__FRAME__SWIZZLE_KERNEL_H
+
+//************Content************
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief SIMD instruction set used by a kernel
+    */
+    enum class SIMDLevel
+    {
+        Scalar = 0,
+        SSSE3 = 1,
+        AVX2 = 2
+    };
+
+    /**
+     * @brief Channel swizzle kernels of the 24-bit pixels.
+     *
+     * The kernel is selected at runtime by the instruction sets supported by the CPU. All kernels return the same output.
+     */
+    class SwizzleKernel
+    {
+    public:
+
+        /**
+         * @brief Get the best SIMD level supported by the CPU. It is detected once.
+         * @return Return the SIMD level
+        */
+        static SIMDLevel getSIMDLevel();
+
+        /**
+         * @brief Swap the first and the third byte of each 24-bit pixel, i.e. BGR to RGB or RGB to BGR.
+         * @param[in] inputData Input pixels
+         * @param[out] outputData Output pixels. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels
+        */
+        static void SwapRedBlue24(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int numOfPixels
+        );
+
+        /**
+         * @brief Swap the first and the third byte of each 24-bit pixel by a specific SIMD level.
+         * @param[in] inputData Input pixels
+         * @param[out] outputData Output pixels. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] simdLevel SIMD level. It is lowered to getSIMDLevel() if the CPU doesn't support it.
+        */
+        static void SwapRedBlue24(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int numOfPixels,
+            const SIMDLevel simdLevel
+        );
+
+    private:
+        static void SwapRedBlue24Scalar(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels);
+        static void SwapRedBlue24SSSE3(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels);
+        static void SwapRedBlue24AVX2(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels);
+    };
+}
+
+//*******************************
+
+#endif
@@ -0,0 +1,446 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "frame/tensor_kernel.h"
+
+#include "utils/cpu_utils.h"
+
+#ifdef DIRECTSHOW_CAMERA_X86
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace DirectShowCamera
+{
+    namespace
+    {
+        // Number of pixels converted at a time by the SIMD kernels
+        constexpr int BlockSize = 16;
+
+        /**
+        * @brief Get the planes moved forward by a number of elements
+        * @param[in] planes First element of each plane
+        * @param[in] table Table
+        * @param[in] numOfElements Number of elements
+        * @return Return the planes
+        */
+        std::array<void*, 3> OffsetPlanes(void* const* planes, const TensorTable& table, const int numOfElements)
+        {
+            const int bytesPerElement = table.DataType == TensorDataType::Float16 ? 2 : 4;
+            std::array<void*, 3> result = {};
+            for (int p = 0; p < table.NumOfPlanes; p++)
+            {
+                result[p] = (unsigned char*)planes[p] + (long long)numOfElements * bytesPerElement;
+            }
+            return result;
+        }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+        /**
+         * @brief Split 16 pixels of 24-bit into 3 channels
+         * @param[in] inputData Input pixels. 48 bytes are read.
+         * @param[out] c0 First channel
+         * @param[out] c1 Second channel
+         * @param[out] c2 Third channel
+        */
+        DIRECTSHOW_CAMERA_TARGET("ssse3")
+        inline void Deinterleave24SSSE3(const unsigned char* inputData, __m128i& c0, __m128i& c1, __m128i& c2)
+        {
+            const __m128i v0 = _mm_loadu_si128((const __m128i*)inputData);
+            const __m128i v1 = _mm_loadu_si128((const __m128i*)(inputData + 16));
+            const __m128i v2 = _mm_loadu_si128((const __m128i*)(inputData + 32));
+
+            // Each channel takes 5 or 6 bytes from each vector
+            c0 = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_shuffle_epi8(v0, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                    _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))
+                ),
+                _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13))
+            );
+            c1 = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_shuffle_epi8(v0, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                    _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))
+                ),
+                _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14))
+            );
+            c2 = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_shuffle_epi8(v0, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                    _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))
+                ),
+                _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15))
+            );
+        }
+
+        /**
+         * @brief Load BlockSize pixels into the samples of each channel
+         * @param[in] inputData Input pixels
+         * @param[in] table Table
+         * @param[out] channels 4 vectors of samples per channel
+        */
+        DIRECTSHOW_CAMERA_TARGET("ssse3")
+        inline void LoadSamplesSSSE3(const unsigned char* inputData, const TensorTable& table, __m128 channels[3][4])
+        {
+            const __m128i zero = _mm_setzero_si128();
+            if (table.BytesPerSample == 2)
+            {
+                const __m128i low = _mm_loadu_si128((const __m128i*)inputData);
+                const __m128i high = _mm_loadu_si128((const __m128i*)(inputData + 16));
+                channels[0][0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero));
+                channels[0][1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero));
+                channels[0][2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero));
+                channels[0][3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero));
+                return;
+            }
+
+            __m128i bytes[3];
+            if (table.Channels == 3)
+            {
+                Deinterleave24SSSE3(inputData, bytes[0], bytes[1], bytes[2]);
+            }
+            else
+            {
+                bytes[0] = _mm_loadu_si128((const __m128i*)inputData);
+            }
+            for (int c = 0; c < table.Channels; c++)
+            {
+                const __m128i low = _mm_unpacklo_epi8(bytes[c], zero);
+                const __m128i high = _mm_unpackhi_epi8(bytes[c], zero);
+                channels[c][0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero));
+                channels[c][1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero));
+                channels[c][2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero));
+                channels[c][3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero));
+            }
+        }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+    }
+
+    TensorTable TensorKernel::BuildTable(
+        const int channels,
+        const int bytesPerSample,
+        const int bitDepth,
+        const int numOfPlanes,
+        const TensorDataType dataType,
+        const std::array<float, 3>& mean,
+        const std::array<float, 3>& std,
+        const float padValue
+    )
+    {
+        // Check
+        if (channels != 1 && channels != 3) throw std::invalid_argument("Channels(" + std::to_string(channels) + ") should be 1 or 3.");
+        if (bytesPerSample != 1 && bytesPerSample != 2) throw std::invalid_argument("Bytes per sample(" + std::to_string(bytesPerSample) + ") should be 1 or 2.");
+        if (bytesPerSample == 2 && channels != 1) throw std::invalid_argument("Channels(" + std::to_string(channels) + ") of the 16-bit samples should be 1.");
+        if (bytesPerSample == 1 ? bitDepth != 8 : bitDepth < 8 || bitDepth > 16)
+        {
+            throw std::invalid_argument("Bit depth(" + std::to_string(bitDepth) + ") is not supported by " + std::to_string(bytesPerSample) + " bytes per sample.");
+        }
+        if (numOfPlanes != 1 && numOfPlanes != 3) throw std::invalid_argument("Number of planes(" + std::to_string(numOfPlanes) + ") should be 1 or 3.");
+        if (numOfPlanes < channels)
+        {
+            throw std::invalid_argument("Number of planes(" + std::to_string(numOfPlanes) + ") is smaller than the channels(" + std::to_string(channels) + ") of the pixels.");
+        }
+        for (int p = 0; p < numOfPlanes; p++)
+        {
+            if (std[p] == 0.0f || !std::isfinite(std[p]))
+            {
+                throw std::invalid_argument("Standard deviation(" + std::to_string(std[p]) + ") of the plane " + std::to_string(p) + " should be a non-zero number.");
+            }
+        }
+
+        // The mean and the standard deviation are scaled to the samples, so a sample is normalized by a subtraction and a multiplication
+        TensorTable table;
+        table.Channels = channels;
+        table.BytesPerSample = bytesPerSample;
+        table.NumOfPlanes = numOfPlanes;
+        table.DataType = dataType;
+        const float maxSample = (float)((1 << bitDepth) - 1);
+        for (int p = 0; p < numOfPlanes; p++)
+        {
+            table.Offsets[p] = mean[p] * maxSample;
+            table.Scales[p] = 1.0f / (std[p] * maxSample);
+            table.PadValues[p] = (padValue * maxSample - table.Offsets[p]) * table.Scales[p];
+        }
+
+        return table;
+    }
+
+    void TensorKernel::ToPlanes(
+        const unsigned char* inputData,
+        void* const* planes,
+        const int numOfPixels,
+        const TensorTable& table
+    )
+    {
+        ToPlanes(inputData, planes, numOfPixels, table, SwizzleKernel::getSIMDLevel());
+    }
+
+    void TensorKernel::ToPlanes(
+        const unsigned char* inputData,
+        void* const* planes,
+        const int numOfPixels,
+        const TensorTable& table,
+        const SIMDLevel simdLevel
+    )
+    {
+        // The half precision conversion of the AVX2 kernel needs F16C
+        SIMDLevel level = std::min(simdLevel, SwizzleKernel::getSIMDLevel());
+        if (level == SIMDLevel::AVX2 && table.DataType == TensorDataType::Float16 && !Utils::CPUUtils::isF16CSupported()) level = SIMDLevel::SSSE3;
+
+        switch (level)
+        {
+        case SIMDLevel::AVX2:
+            ToPlanesAVX2(inputData, planes, numOfPixels, table);
+            break;
+        case SIMDLevel::SSSE3:
+            ToPlanesSSSE3(inputData, planes, numOfPixels, table);
+            break;
+        default:
+            if (table.BytesPerSample == 2)
+            {
+                ToPlanesScalar((const unsigned short*)inputData, planes, numOfPixels, table);
+            }
+            else
+            {
+                ToPlanesScalar(inputData, planes, numOfPixels, table);
+            }
+            break;
+        }
+    }
+
+    void TensorKernel::FillPlanes(void* const* planes, const int numOfElements, const TensorTable& table)
+    {
+        for (int p = 0; p < table.NumOfPlanes; p++)
+        {
+            if (table.DataType == TensorDataType::Float32)
+            {
+                std::fill_n((float*)planes[p], numOfElements, table.PadValues[p]);
+            }
+            else
+            {
+                std::fill_n((unsigned short*)planes[p], numOfElements, FloatToHalf(table.PadValues[p]));
+            }
+        }
+    }
+
+    unsigned short TensorKernel::FloatToHalf(const float value)
+    {
+        unsigned int bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const unsigned short sign = (unsigned short)((bits >> 16) & 0x8000);
+        bits &= 0x7FFFFFFF;
+
+        // Infinity, NaN and the floats >= 2 ^ 16. The floats from 65520, the middle of the largest half and 2 ^ 16, round to infinity in the normal path.
+        if (bits >= 0x47800000) return sign | (bits > 0x7F800000 ? 0x7E00 : 0x7C00);
+
+        // Subnormal or zero. The float addition aligns the 10 mantissa bits of the half at the bottom and rounds them to the nearest even.
+        if (bits < 0x38800000)
+        {
+            const unsigned int magicBits = 0x3F000000; // 0.5, its mantissa lsb is 2 ^ -24, the smallest half subnormal
+            float magic = 0.0f;
+            std::memcpy(&magic, &magicBits, sizeof(magic));
+            float absolute = 0.0f;
+            std::memcpy(&absolute, &bits, sizeof(absolute));
+            absolute += magic;
+            std::memcpy(&bits, &absolute, sizeof(bits));
+            return sign | (unsigned short)(bits - magicBits);
+        }
+
+        // Normal. Rebias the exponent and round the 13 dropped mantissa bits to the nearest even.
+        const unsigned int isOdd = (bits >> 13) & 1;
+        bits += 0xC8000FFF + isOdd; // (15 - 127) << 23, and the rounding bias
+        return sign | (unsigned short)(bits >> 13);
+    }
+
+    float TensorKernel::HalfToFloat(const unsigned short value)
+    {
+        const unsigned int sign = (unsigned int)(value & 0x8000) << 16;
+        const unsigned int exponent = (value >> 10) & 0x1F;
+        const unsigned int mantissa = value & 0x3FF;
+
+        // Subnormal or zero, mantissa * 2 ^ -24
+        if (exponent == 0)
+        {
+            const float result = (float)mantissa * (1.0f / 16777216.0f);
+            return sign != 0 ? -result : result;
+        }
+
+        // Infinity and NaN keep the exponent of all 1, the normals are rebiased
+        const unsigned int bits = sign | (exponent == 0x1F ? 0x7F800000 : (exponent + 112) << 23) | (mantissa << 13);
+        float result = 0.0f;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    template <typename Sample>
+    void TensorKernel::ToPlanesScalar(const Sample* inputData, void* const* planes, const int numOfPixels, const TensorTable& table)
+    {
+        for (int p = 0; p < table.NumOfPlanes; p++)
+        {
+            // A pixel of 1 channel is repeated in each plane
+            const Sample* samples = inputData + (table.Channels == 1 ? 0 : p);
+            const float offset = table.Offsets[p];
+            const float scale = table.Scales[p];
+            if (table.DataType == TensorDataType::Float32)
+            {
+                float* plane = (float*)planes[p];
+                for (int x = 0; x < numOfPixels; x++)
+                {
+                    plane[x] = ((float)samples[x * table.Channels] - offset) * scale;
+                }
+            }
+            else
+            {
+                unsigned short* plane = (unsigned short*)planes[p];
+                for (int x = 0; x < numOfPixels; x++)
+                {
+                    plane[x] = FloatToHalf(((float)samples[x * table.Channels] - offset) * scale);
+                }
+            }
+        }
+    }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+    DIRECTSHOW_CAMERA_TARGET("ssse3")
+    void TensorKernel::ToPlanesSSSE3(const unsigned char* inputData, void* const* planes, const int numOfPixels, const TensorTable& table)
+    {
+        const int bytesPerPixel = table.Channels * table.BytesPerSample;
+        __m128 offsets[3];
+        __m128 scales[3];
+        for (int p = 0; p < table.NumOfPlanes; p++)
+        {
+            offsets[p] = _mm_set1_ps(table.Offsets[p]);
+            scales[p] = _mm_set1_ps(table.Scales[p]);
+        }
+
+        int x = 0;
+        for (; x + BlockSize <= numOfPixels; x += BlockSize)
+        {
+            __m128 channels[3][4];
+            LoadSamplesSSSE3(inputData + (long long)x * bytesPerPixel, table, channels);
+
+            for (int p = 0; p < table.NumOfPlanes; p++)
+            {
+                const __m128* samples = channels[table.Channels == 1 ? 0 : p];
+                if (table.DataType == TensorDataType::Float32)
+                {
+                    float* plane = (float*)planes[p] + x;
+                    for (int i = 0; i < 4; i++)
+                    {
+                        _mm_storeu_ps(plane + i * 4, _mm_mul_ps(_mm_sub_ps(samples[i], offsets[p]), scales[p]));
+                    }
+                }
+                else
+                {
+                    // No half precision conversion before F16C, the normalized block is converted by the scalar conversion
+                    alignas(16) float block[BlockSize];
+                    for (int i = 0; i < 4; i++)
+                    {
+                        _mm_store_ps(block + i * 4, _mm_mul_ps(_mm_sub_ps(samples[i], offsets[p]), scales[p]));
+                    }
+                    unsigned short* plane = (unsigned short*)planes[p] + x;
+                    for (int i = 0; i < BlockSize; i++)
+                    {
+                        plane[i] = FloatToHalf(block[i]);
+                    }
+                }
+            }
+        }
+
+        // Remaining pixels
+        const auto remainingPlanes = OffsetPlanes(planes, table, x);
+        ToPlanes(inputData + (long long)x * bytesPerPixel, remainingPlanes.data(), numOfPixels - x, table, SIMDLevel::Scalar);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2,f16c")
+    void TensorKernel::ToPlanesAVX2(const unsigned char* inputData, void* const* planes, const int numOfPixels, const TensorTable& table)
+    {
+        const int bytesPerPixel = table.Channels * table.BytesPerSample;
+        __m256 offsets[3];
+        __m256 scales[3];
+        for (int p = 0; p < table.NumOfPlanes; p++)
+        {
+            offsets[p] = _mm256_set1_ps(table.Offsets[p]);
+            scales[p] = _mm256_set1_ps(table.Scales[p]);
+        }
+
+        int x = 0;
+        for (; x + BlockSize <= numOfPixels; x += BlockSize)
+        {
+            // 2 vectors of 8 samples per channel
+            const unsigned char* pixels = inputData + (long long)x * bytesPerPixel;
+            __m256 channels[3][2];
+            if (table.BytesPerSample == 2)
+            {
+                channels[0][0] = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)pixels)));
+                channels[0][1] = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(pixels + 16))));
+            }
+            else
+            {
+                __m128i bytes[3];
+                if (table.Channels == 3)
+                {
+                    Deinterleave24SSSE3(pixels, bytes[0], bytes[1], bytes[2]);
+                }
+                else
+                {
+                    bytes[0] = _mm_loadu_si128((const __m128i*)pixels);
+                }
+                for (int c = 0; c < table.Channels; c++)
+                {
+                    channels[c][0] = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes[c]));
+                    channels[c][1] = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes[c], 8)));
+                }
+            }
+
+            for (int p = 0; p < table.NumOfPlanes; p++)
+            {
+                const __m256* samples = channels[table.Channels == 1 ? 0 : p];
+                const __m256 result0 = _mm256_mul_ps(_mm256_sub_ps(samples[0], offsets[p]), scales[p]);
+                const __m256 result1 = _mm256_mul_ps(_mm256_sub_ps(samples[1], offsets[p]), scales[p]);
+                if (table.DataType == TensorDataType::Float32)
+                {
+                    float* plane = (float*)planes[p] + x;
+                    _mm256_storeu_ps(plane, result0);
+                    _mm256_storeu_ps(plane + 8, result1);
+                }
+                else
+                {
+                    unsigned short* plane = (unsigned short*)planes[p] + x;
+                    _mm_storeu_si128((__m128i*)plane, _mm256_cvtps_ph(result0, _MM_FROUND_TO_NEAREST_INT));
+                    _mm_storeu_si128((__m128i*)(plane + 8), _mm256_cvtps_ph(result1, _MM_FROUND_TO_NEAREST_INT));
+                }
+            }
+        }
+
+        // Remaining pixels
+        const auto remainingPlanes = OffsetPlanes(planes, table, x);
+        ToPlanes(inputData + (long long)x * bytesPerPixel, remainingPlanes.data(), numOfPixels - x, table, SIMDLevel::Scalar);
+    }
+
+#else
+
+    void TensorKernel::ToPlanesSSSE3(const unsigned char* inputData, void* const* planes, const int numOfPixels, const TensorTable& table)
+    {
+        ToPlanes(inputData, planes, numOfPixels, table, SIMDLevel::Scalar);
+    }
+
+    void TensorKernel::ToPlanesAVX2(const unsigned char* inputData, void* const* planes, const int numOfPixels, const TensorTable& table)
+    {
+        ToPlanes(inputData, planes, numOfPixels, table, SIMDLevel::Scalar);
+    }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+}
@@ -0,0 +1,193 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__TENSOR_KERNEL_H
+#define DIRECTSHOW_CAMERA__FRAME__TENSOR_KERNEL_H
+
+//************Content************
+
+#include "frame/frame_destination.h"
+#include "frame/swizzle_kernel.h"
+
+#include <array>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Normalization of the decoded pixels into the planes of a tensor. See TensorKernel::BuildTable().
+    */
+    struct TensorTable
+    {
+        /**
+         * @brief Samples per decoded pixel, 1 or 3
+        */
+        int Channels = 3;
+
+        /**
+         * @brief Bytes per decoded sample, 1 or 2
+        */
+        int BytesPerSample = 1;
+
+        /**
+         * @brief Number of planes, 1 or 3. The plane i is the channel i, or the only channel if the pixels have 1 channel.
+        */
+        int NumOfPlanes = 3;
+
+        /**
+         * @brief Element type of the planes
+        */
+        TensorDataType DataType = TensorDataType::Float32;
+
+        /**
+         * @brief Offset of each plane. The element is (sample - Offset) * Scale.
+        */
+        std::array<float, 3> Offsets = {};
+
+        /**
+         * @brief Scale of each plane
+        */
+        std::array<float, 3> Scales = {};
+
+        /**
+         * @brief Padded element of each plane, normalized as the samples
+        */
+        std::array<float, 3> PadValues = {};
+    };
+
+    /**
+     * @brief Tensor written by the decoders instead of the output data. Each decoded row is converted into the planes while it is still in the cache, see RowKernel::Run().
+    */
+    struct TensorOutput
+    {
+        /**
+         * @brief First element of the first plane. The planes are packed one after another.
+        */
+        void* Data = nullptr;
+
+        /**
+         * @brief Width of the tensor
+        */
+        int Width = 0;
+
+        /**
+         * @brief Height of the tensor
+        */
+        int Height = 0;
+
+        /**
+         * @brief X of the top left pixel of the frame in the tensor. The frame must be inside the tensor, the elements outside the frame are padded.
+        */
+        int X = 0;
+
+        /**
+         * @brief Y of the top left pixel of the frame in the tensor
+        */
+        int Y = 0;
+
+        /**
+         * @brief Tensor table, see TensorKernel::BuildTable(). The samples of the table must be the decoded pixels.
+        */
+        const TensorTable* Table = nullptr;
+    };
+
+    /**
+     * @brief Tensor kernels. The interleaved decoded pixels are split into planes, normalized and converted to the element type in one pass.
+     *
+     * Each element is (sample - Offset) * Scale, a subtraction and a multiplication in float, so every kernel rounds the same way.
+     * The kernel is selected at runtime by the instruction sets supported by the CPU. All kernels return the same output.
+     * The half precision elements are converted by F16C with AVX2, and by the scalar conversion otherwise.
+     */
+    class TensorKernel
+    {
+    public:
+
+        /**
+         * @brief Build the table of a tensor. Build it once per frame and share it by the rows. If the arguments are invalid, throw exception.
+         * @param[in] channels Samples per decoded pixel. It must be 1 or 3.
+         * @param[in] bytesPerSample Bytes per decoded sample. It must be 1, or 2 for 1 channel.
+         * @param[in] bitDepth Bit depth of the samples. It must be 8 for the 8 bit samples or from 8 to 16 for the 16-bit samples.
+         * @param[in] numOfPlanes Number of planes. It must be 3, or 1 for 1 channel.
+         * @param[in] dataType Element type
+         * @param[in] mean Mean of each plane from 0 to 1
+         * @param[in] std Standard deviation of each plane. It must not be 0.
+         * @param[in] padValue Sample of the padded elements from 0 to 1
+         * @return Return the table
+        */
+        static TensorTable BuildTable(
+            const int channels,
+            const int bytesPerSample,
+            const int bitDepth,
+            const int numOfPlanes,
+            const TensorDataType dataType,
+            const std::array<float, 3>& mean,
+            const std::array<float, 3>& std,
+            const float padValue
+        );
+
+        /**
+         * @brief Split decoded pixels into the planes of a tensor
+         * @param[in] inputData Decoded pixels
+         * @param[out] planes First element of each plane
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] table Table, see BuildTable().
+        */
+        static void ToPlanes(
+            const unsigned char* inputData,
+            void* const* planes,
+            const int numOfPixels,
+            const TensorTable& table
+        );
+
+        /**
+         * @brief Split decoded pixels into the planes of a tensor by a specific SIMD level
+         * @param[in] inputData Decoded pixels
+         * @param[out] planes First element of each plane
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] table Table, see BuildTable().
+         * @param[in] simdLevel SIMD level. It is lowered to SwizzleKernel::getSIMDLevel() if the CPU doesn't support it.
+        */
+        static void ToPlanes(
+            const unsigned char* inputData,
+            void* const* planes,
+            const int numOfPixels,
+            const TensorTable& table,
+            const SIMDLevel simdLevel
+        );
+
+        /**
+         * @brief Set the elements of the planes of a tensor to the padded elements
+         * @param[out] planes First element of each plane
+         * @param[in] numOfElements Number of elements per plane
+         * @param[in] table Table, see BuildTable().
+        */
+        static void FillPlanes(void* const* planes, const int numOfElements, const TensorTable& table);
+
+        /**
+         * @brief Convert a float to half precision, rounded to the nearest even. The overflows are converted to infinity.
+         * @param[in] value Float
+         * @return Return the half precision bits
+        */
+        static unsigned short FloatToHalf(const float value);
+
+        /**
+         * @brief Convert a half precision to float, e.g. to read a TensorDataType::Float16 tensor
+         * @param[in] value Half precision bits
+         * @return Return the float
+        */
+        static float HalfToFloat(const unsigned short value);
+
+    private:
+        template <typename Sample>
+        static void ToPlanesScalar(const Sample* inputData, void* const* planes, const int numOfPixels, const TensorTable& table);
+        static void ToPlanesSSSE3(const unsigned char* inputData, void* const* planes, const int numOfPixels, const TensorTable& table);
+        static void ToPlanesAVX2(const unsigned char* inputData, void* const* planes, const int numOfPixels, const TensorTable& table);
+    };
+}
+
+//*******************************
+
+#endif
@@ -0,0 +1,259 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "frame/tone_map_kernel.h"
+
+#include "utils/cpu_utils.h"
+
+#ifdef DIRECTSHOW_CAMERA_X86
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace DirectShowCamera
+{
+#ifdef DIRECTSHOW_CAMERA_X86
+    namespace
+    {
+        /**
+         * @brief Map 8 samples linearly. The results are 16-bit.
+        */
+        DIRECTSHOW_CAMERA_TARGET("sse2")
+        inline __m128i Map8SSE2(const __m128i samples, const __m128i low, const __m128i clampBias, const __m128i multiplier, const __m128i rounding, const __m128i shift)
+        {
+            // Clamp to the window by the saturated add and sub, i.e. min(max(sample - low, 0), high - low)
+            __m128i value = _mm_subs_epu16(samples, low);
+            value = _mm_subs_epu16(_mm_adds_epu16(value, clampBias), clampBias);
+
+            // 32-bit products
+            const __m128i productLow = _mm_mullo_epi16(value, multiplier);
+            const __m128i productHigh = _mm_mulhi_epu16(value, multiplier);
+            const __m128i result0 = _mm_srl_epi32(_mm_add_epi32(_mm_unpacklo_epi16(productLow, productHigh), rounding), shift);
+            const __m128i result1 = _mm_srl_epi32(_mm_add_epi32(_mm_unpackhi_epi16(productLow, productHigh), rounding), shift);
+            return _mm_packs_epi32(result0, result1);
+        }
+
+        /**
+         * @brief Map 16 samples linearly. The results are 16-bit.
+        */
+        DIRECTSHOW_CAMERA_TARGET("avx2")
+        inline __m256i Map16AVX2(const __m256i samples, const __m256i low, const __m256i clampBias, const __m256i multiplier, const __m256i rounding, const __m128i shift)
+        {
+            // Clamp to the window by the saturated add and sub, i.e. min(max(sample - low, 0), high - low)
+            __m256i value = _mm256_subs_epu16(samples, low);
+            value = _mm256_subs_epu16(_mm256_adds_epu16(value, clampBias), clampBias);
+
+            // 32-bit products. The unpack and the pack are in lane, so the order of the 16-bit results is kept.
+            const __m256i productLow = _mm256_mullo_epi16(value, multiplier);
+            const __m256i productHigh = _mm256_mulhi_epu16(value, multiplier);
+            const __m256i result0 = _mm256_srl_epi32(_mm256_add_epi32(_mm256_unpacklo_epi16(productLow, productHigh), rounding), shift);
+            const __m256i result1 = _mm256_srl_epi32(_mm256_add_epi32(_mm256_unpackhi_epi16(productLow, productHigh), rounding), shift);
+            return _mm256_packs_epi32(result0, result1);
+        }
+    }
+#endif // def DIRECTSHOW_CAMERA_X86
+
+#pragma region Table
+
+    ToneMapTable ToneMapKernel::BuildTable(const int low, const int high, const double gamma)
+    {
+        // Check
+        if (low < 0) throw std::invalid_argument("Window low(" + std::to_string(low) + ") can't be < 0.");
+        if (high > 65535) throw std::invalid_argument("Window high(" + std::to_string(high) + ") can't be > 65535.");
+        if (high <= low) throw std::invalid_argument("Window high(" + std::to_string(high) + ") should be > window low(" + std::to_string(low) + ").");
+        if (!(gamma > 0)) throw std::invalid_argument("Gamma(" + std::to_string(gamma) + ") should be > 0.");
+
+        ToneMapTable table;
+        table.Low = low;
+        table.High = high;
+
+        // The largest shift keeping the multiplier in 16 bits. The product of the window and the multiplier fits in 32 bits as the shift is <= 24.
+        const long long range = high - low;
+        for (table.Shift = 24; table.Shift > 0; table.Shift--)
+        {
+            const long long multiplier = ((255LL << table.Shift) + range / 2) / range;
+            if (multiplier <= 65535)
+            {
+                table.Multiplier = (int)multiplier;
+                break;
+            }
+        }
+
+        // Lookup table of the gamma curve
+        if (gamma != 1.0)
+        {
+            table.Entries.resize(range + 1);
+            for (int i = 0; i <= range; i++)
+            {
+                table.Entries[i] = (unsigned char)std::lround(255.0 * std::pow((double)i / range, 1.0 / gamma));
+            }
+        }
+
+        return table;
+    }
+
+#pragma endregion Table
+
+#pragma region To Pixels
+
+    void ToneMapKernel::ToPixels(
+        const unsigned short* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const ToneMapTable& table
+    )
+    {
+        ToPixels(inputData, outputData, numOfPixels, table, SwizzleKernel::getSIMDLevel());
+    }
+
+    void ToneMapKernel::ToPixels(
+        const unsigned short* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const ToneMapTable& table,
+        const SIMDLevel simdLevel
+    )
+    {
+        // Gamma
+        if (!table.Entries.empty())
+        {
+            TableToPixels(inputData, outputData, numOfPixels, table);
+            return;
+        }
+
+        // Linear. SSE2 is enough for the 16-bit multiply, it is used in the SSSE3 level
+        switch (std::min(simdLevel, SwizzleKernel::getSIMDLevel()))
+        {
+        case SIMDLevel::AVX2:
+            LinearToPixelsAVX2(inputData, outputData, numOfPixels, table);
+            break;
+        case SIMDLevel::SSSE3:
+            LinearToPixelsSSE2(inputData, outputData, numOfPixels, table);
+            break;
+        default:
+            LinearToPixelsScalar(inputData, outputData, numOfPixels, table);
+            break;
+        }
+    }
+
+    void ToneMapKernel::TableToPixels(
+        const unsigned short* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const ToneMapTable& table
+    )
+    {
+        const unsigned char* entries = table.Entries.data();
+        for (int x = 0; x < numOfPixels; x++)
+        {
+            outputData[x] = entries[std::clamp((int)inputData[x], table.Low, table.High) - table.Low];
+        }
+    }
+
+    void ToneMapKernel::LinearToPixelsScalar(
+        const unsigned short* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const ToneMapTable& table
+    )
+    {
+        const unsigned int rounding = 1u << (table.Shift - 1);
+        for (int x = 0; x < numOfPixels; x++)
+        {
+            const unsigned int value = (unsigned int)(std::clamp((int)inputData[x], table.Low, table.High) - table.Low);
+            outputData[x] = (unsigned char)((value * (unsigned int)table.Multiplier + rounding) >> table.Shift);
+        }
+    }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+    DIRECTSHOW_CAMERA_TARGET("sse2")
+    void ToneMapKernel::LinearToPixelsSSE2(
+        const unsigned short* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const ToneMapTable& table
+    )
+    {
+        // 16 pixels per iteration
+        const __m128i low = _mm_set1_epi16((short)table.Low);
+        const __m128i clampBias = _mm_set1_epi16((short)(65535 - (table.High - table.Low)));
+        const __m128i multiplier = _mm_set1_epi16((short)table.Multiplier);
+        const __m128i rounding = _mm_set1_epi32(1 << (table.Shift - 1));
+        const __m128i shift = _mm_cvtsi32_si128(table.Shift);
+
+        int x = 0;
+        for (; x + 16 <= numOfPixels; x += 16)
+        {
+            const __m128i result0 = Map8SSE2(_mm_loadu_si128((const __m128i*)(inputData + x)), low, clampBias, multiplier, rounding, shift);
+            const __m128i result1 = Map8SSE2(_mm_loadu_si128((const __m128i*)(inputData + x + 8)), low, clampBias, multiplier, rounding, shift);
+            _mm_storeu_si128((__m128i*)(outputData + x), _mm_packus_epi16(result0, result1));
+        }
+
+        // Remaining pixels
+        LinearToPixelsScalar(inputData + x, outputData + x, numOfPixels - x, table);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2")
+    void ToneMapKernel::LinearToPixelsAVX2(
+        const unsigned short* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const ToneMapTable& table
+    )
+    {
+        // 32 pixels per iteration
+        const __m256i low = _mm256_set1_epi16((short)table.Low);
+        const __m256i clampBias = _mm256_set1_epi16((short)(65535 - (table.High - table.Low)));
+        const __m256i multiplier = _mm256_set1_epi16((short)table.Multiplier);
+        const __m256i rounding = _mm256_set1_epi32(1 << (table.Shift - 1));
+        const __m128i shift = _mm_cvtsi32_si128(table.Shift);
+
+        int x = 0;
+        for (; x + 32 <= numOfPixels; x += 32)
+        {
+            const __m256i result0 = Map16AVX2(_mm256_loadu_si256((const __m256i*)(inputData + x)), low, clampBias, multiplier, rounding, shift);
+            const __m256i result1 = Map16AVX2(_mm256_loadu_si256((const __m256i*)(inputData + x + 16)), low, clampBias, multiplier, rounding, shift);
+
+            // The byte pack interleaves the lanes of the 2 inputs
+            const __m256i result = _mm256_permute4x64_epi64(_mm256_packus_epi16(result0, result1), 0xD8);
+            _mm256_storeu_si256((__m256i*)(outputData + x), result);
+        }
+
+        // Remaining pixels
+        LinearToPixelsSSE2(inputData + x, outputData + x, numOfPixels - x, table);
+    }
+
+#else
+
+    void ToneMapKernel::LinearToPixelsSSE2(
+        const unsigned short* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const ToneMapTable& table
+    )
+    {
+        LinearToPixelsScalar(inputData, outputData, numOfPixels, table);
+    }
+
+    void ToneMapKernel::LinearToPixelsAVX2(
+        const unsigned short* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const ToneMapTable& table
+    )
+    {
+        LinearToPixelsScalar(inputData, outputData, numOfPixels, table);
+    }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+
+#pragma endregion To Pixels
+}
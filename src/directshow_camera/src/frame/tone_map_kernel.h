@@ -0,0 +1,153 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__TONE_MAP_KERNEL_H
+#define DIRECTSHOW_CAMERA__FRAME__TONE_MAP_KERNEL_H
+
+//************Content************
+
+#include "frame/swizzle_kernel.h"
+
+#include <vector>
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief How the window of a 16-bit to 8 bit tone mapping is chosen
+    */
+    enum class ToneMapMode
+    {
+        Window,     // Fixed window, see ToneMapSettings::WindowLow and ToneMapSettings::WindowHigh
+        AutoRange   // Window from the min and max of the sampled pixels of each frame
+    };
+
+    /**
+     * @brief Settings of a 16-bit to 8 bit tone mapping. The samples in the window are mapped to 0 - 255, the samples outside are clamped.
+     *
+     * A window/level of (level, window) is the window from level - window / 2 to level + window / 2.
+    */
+    struct ToneMapSettings
+    {
+        /**
+         * @brief Window mode
+        */
+        ToneMapMode Mode = ToneMapMode::AutoRange;
+
+        /**
+         * @brief Sample mapped to 0 in ToneMapMode::Window. It is in the bit depth of the decoded image, see FrameDecoder::getBitDepth().
+        */
+        int WindowLow = 0;
+
+        /**
+         * @brief Sample mapped to 255 in ToneMapMode::Window. It is in the bit depth of the decoded image, see FrameDecoder::getBitDepth().
+        */
+        int WindowHigh = 65535;
+
+        /**
+         * @brief Gamma, the output is 255 * t ^ (1 / Gamma) where t is the position in the window from 0 to 1. A gamma > 1 brightens the dark samples.
+         *        1 is linear and runs on SIMD, the others run on a lookup table.
+        */
+        double Gamma = 1.0;
+
+        /**
+         * @brief Sample every n-th pixel of every n-th row in ToneMapMode::AutoRange. 1 samples all pixels.
+        */
+        int AutoRangeSampleStep = 8;
+    };
+
+    /**
+     * @brief Resolved window of a tone mapping. See ToneMapKernel::BuildTable().
+    */
+    struct ToneMapTable
+    {
+        /**
+         * @brief Sample mapped to 0
+        */
+        int Low = 0;
+
+        /**
+         * @brief Sample mapped to 255
+        */
+        int High = 65535;
+
+        /**
+         * @brief Fixed point scale of the linear mapping. The output is ((sample - Low) * Multiplier + 2 ^ (Shift - 1)) >> Shift.
+        */
+        int Multiplier = 0;
+
+        /**
+         * @brief Fixed point shift of the linear mapping
+        */
+        int Shift = 0;
+
+        /**
+         * @brief Output of the samples from Low to High. Empty if the mapping is linear.
+        */
+        std::vector<unsigned char> Entries;
+    };
+
+    /**
+     * @brief 16-bit to 8 bit tone mapping kernels. Samples are unsigned short.
+     *
+     * The linear mapping is a fixed point multiply on SIMD, the gamma mapping is a lookup table.
+     * The kernel is selected at runtime by the instruction sets supported by the CPU. All kernels return the same output.
+     */
+    class ToneMapKernel
+    {
+    public:
+
+        /**
+         * @brief Build the table of a window. Build it once per frame and share it by the rows.
+         * @param[in] low Sample mapped to 0. It must be >= 0.
+         * @param[in] high Sample mapped to 255. It must be > low and <= 65535.
+         * @param[in] gamma (Optional) Gamma, see ToneMapSettings::Gamma. It must be > 0. Default as 1.0
+         * @return Return the table
+        */
+        static ToneMapTable BuildTable(const int low, const int high, const double gamma = 1.0);
+
+        /**
+         * @brief Map 16-bit samples to 8 bit pixels
+         * @param[in] inputData Input samples
+         * @param[out] outputData Output pixels
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] table Table, see BuildTable().
+        */
+        static void ToPixels(
+            const unsigned short* inputData,
+            unsigned char* outputData,
+            const int numOfPixels,
+            const ToneMapTable& table
+        );
+
+        /**
+         * @brief Map 16-bit samples to 8 bit pixels by a specific SIMD level
+         * @param[in] inputData Input samples
+         * @param[out] outputData Output pixels
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] table Table, see BuildTable().
+         * @param[in] simdLevel SIMD level. It is lowered to SwizzleKernel::getSIMDLevel() if the CPU doesn't support it.
+        */
+        static void ToPixels(
+            const unsigned short* inputData,
+            unsigned char* outputData,
+            const int numOfPixels,
+            const ToneMapTable& table,
+            const SIMDLevel simdLevel
+        );
+
+    private:
+        static void LinearToPixelsScalar(const unsigned short* inputData, unsigned char* outputData, const int numOfPixels, const ToneMapTable& table);
+        static void LinearToPixelsSSE2(const unsigned short* inputData, unsigned char* outputData, const int numOfPixels, const ToneMapTable& table);
+        static void LinearToPixelsAVX2(const unsigned short* inputData, unsigned char* outputData, const int numOfPixels, const ToneMapTable& table);
+
+        static void TableToPixels(const unsigned short* inputData, unsigned char* outputData, const int numOfPixels, const ToneMapTable& table);
+    };
+}
+
+//*******************************
+
+#endif
@@ -0,0 +1,704 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "frame/yuv_kernel.h"
+
+#include "frame/simd_pixel_store.h"
+#include "utils/cpu_utils.h"
+
+#ifdef DIRECTSHOW_CAMERA_X86
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+namespace DirectShowCamera
+{
+    namespace
+    {
+        /**
+         * @brief Limited range YUV to RGB coefficients in 6 fractional bits.
+         *        B = YG(Y-16) + UB(U-128), G = YG(Y-16) - UG(U-128) - VG(V-128), R = YG(Y-16) + VR(V-128)
+        */
+        struct YUVCoefficients
+        {
+            short YG;
+            short UB;
+            short UG;
+            short VG;
+            short VR;
+        };
+
+        constexpr YUVCoefficients BT601_COEFFICIENTS = { 75, 129, 25, 52, 102 };
+        constexpr YUVCoefficients BT709_COEFFICIENTS = { 75, 135, 14, 34, 115 };
+
+        const YUVCoefficients& getCoefficients(const YUVColorSpace colorSpace)
+        {
+            return colorSpace == YUVColorSpace::BT709 ? BT709_COEFFICIENTS : BT601_COEFFICIENTS;
+        }
+
+        /**
+         * @brief Byte offsets of Y0, U and V in the 4 bytes shared by 2 pixels. Y1 is at Y + 2.
+        */
+        struct YUV422Offsets
+        {
+            int Y;
+            int U;
+            int V;
+        };
+
+        constexpr YUV422Offsets getOffsets(const YUV422Layout layout)
+        {
+            return layout == YUV422Layout::UYVY ? YUV422Offsets{ 1, 0, 2 } : YUV422Offsets{ 0, 1, 3 };
+        }
+
+        bool isRGBOrder(const YUVOutputFormat outputFormat)
+        {
+            return outputFormat == YUVOutputFormat::RGB24 || outputFormat == YUVOutputFormat::RGBA32;
+        }
+
+        unsigned char Clamp(const int value)
+        {
+            return (unsigned char)std::clamp(value, 0, 255);
+        }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+        /**
+         * @brief Get the shuffle masks spreading Y, U and V of 8 pixels into 16-bit lanes
+         * @param[in] layout Byte order of the input
+         * @param[out] masks Y, U and V masks
+        */
+        DIRECTSHOW_CAMERA_TARGET("ssse3")
+        void getShuffleMasks(const YUV422Layout layout, __m128i masks[3])
+        {
+            const auto offsets = getOffsets(layout);
+            alignas(16) signed char yMask[16], uMask[16], vMask[16];
+            for (int i = 0; i < 8; i++)
+            {
+                yMask[i * 2] = (signed char)(i * 2 + offsets.Y);
+                uMask[i * 2] = (signed char)((i / 2) * 4 + offsets.U);
+                vMask[i * 2] = (signed char)((i / 2) * 4 + offsets.V);
+                yMask[i * 2 + 1] = uMask[i * 2 + 1] = vMask[i * 2 + 1] = -1;
+            }
+            masks[0] = _mm_load_si128((const __m128i*)yMask);
+            masks[1] = _mm_load_si128((const __m128i*)uMask);
+            masks[2] = _mm_load_si128((const __m128i*)vMask);
+        }
+
+        /**
+         * @brief Convert Y, U and V of 8 pixels in 16-bit lanes to B, G and R in 16-bit lanes. The saturation only happens if the result is > 255.
+        */
+        DIRECTSHOW_CAMERA_TARGET("ssse3")
+        inline void ConvertYUVSSSE3(const __m128i y16, const __m128i u16, const __m128i v16, const __m128i coefficients[5], __m128i& b, __m128i& g, __m128i& r)
+        {
+            const __m128i y = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(y16, _mm_set1_epi16(16)), coefficients[0]), _mm_set1_epi16(32));
+            const __m128i u = _mm_sub_epi16(u16, _mm_set1_epi16(128));
+            const __m128i v = _mm_sub_epi16(v16, _mm_set1_epi16(128));
+            b = _mm_srai_epi16(_mm_adds_epi16(y, _mm_mullo_epi16(u, coefficients[1])), 6);
+            g = _mm_srai_epi16(_mm_subs_epi16(_mm_subs_epi16(y, _mm_mullo_epi16(u, coefficients[2])), _mm_mullo_epi16(v, coefficients[3])), 6);
+            r = _mm_srai_epi16(_mm_adds_epi16(y, _mm_mullo_epi16(v, coefficients[4])), 6);
+        }
+
+        /**
+         * @brief Convert Y, U and V of 16 pixels in 16-bit lanes to B, G and R in 16-bit lanes. The saturation only happens if the result is > 255.
+        */
+        DIRECTSHOW_CAMERA_TARGET("avx2")
+        inline void ConvertYUVAVX2(const __m256i y16, const __m256i u16, const __m256i v16, const __m256i coefficients[5], __m256i& b, __m256i& g, __m256i& r)
+        {
+            const __m256i y = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(y16, _mm256_set1_epi16(16)), coefficients[0]), _mm256_set1_epi16(32));
+            const __m256i u = _mm256_sub_epi16(u16, _mm256_set1_epi16(128));
+            const __m256i v = _mm256_sub_epi16(v16, _mm256_set1_epi16(128));
+            b = _mm256_srai_epi16(_mm256_adds_epi16(y, _mm256_mullo_epi16(u, coefficients[1])), 6);
+            g = _mm256_srai_epi16(_mm256_subs_epi16(_mm256_subs_epi16(y, _mm256_mullo_epi16(u, coefficients[2])), _mm256_mullo_epi16(v, coefficients[3])), 6);
+            r = _mm256_srai_epi16(_mm256_adds_epi16(y, _mm256_mullo_epi16(v, coefficients[4])), 6);
+        }
+
+        /**
+         * @brief Convert 8 packed YUV 4:2:2 pixels to B, G and R in 16-bit lanes
+        */
+        DIRECTSHOW_CAMERA_TARGET("ssse3")
+        inline void ConvertYUV422SSSE3(const __m128i yuv, const __m128i masks[3], const __m128i coefficients[5], __m128i& b, __m128i& g, __m128i& r)
+        {
+            ConvertYUVSSSE3(_mm_shuffle_epi8(yuv, masks[0]), _mm_shuffle_epi8(yuv, masks[1]), _mm_shuffle_epi8(yuv, masks[2]), coefficients, b, g, r);
+        }
+
+        /**
+         * @brief Convert 16 packed YUV 4:2:2 pixels to B, G and R in 16-bit lanes
+        */
+        DIRECTSHOW_CAMERA_TARGET("avx2")
+        inline void ConvertYUV422AVX2(const __m256i yuv, const __m256i masks[3], const __m256i coefficients[5], __m256i& b, __m256i& g, __m256i& r)
+        {
+            ConvertYUVAVX2(_mm256_shuffle_epi8(yuv, masks[0]), _mm256_shuffle_epi8(yuv, masks[1]), _mm256_shuffle_epi8(yuv, masks[2]), coefficients, b, g, r);
+        }
+
+        /**
+         * @brief Shuffle masks spreading the 16-bit U and V of 4 interleaved U V pairs to 8 pixels
+        */
+        DIRECTSHOW_CAMERA_TARGET("ssse3")
+        inline void getUVPairShuffleMasks(__m128i& uMask, __m128i& vMask)
+        {
+            uMask = _mm_setr_epi8(0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13);
+            vMask = _mm_setr_epi8(2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15);
+        }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+    }
+
+    void YUVKernel::YUV422ToPixels(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        YUV422ToPixels(inputData, outputData, numOfPixels, layout, colorSpace, outputFormat, SwizzleKernel::getSIMDLevel());
+    }
+
+    void YUVKernel::YUV422ToPixels(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat,
+        const SIMDLevel simdLevel
+    )
+    {
+        // Y only
+        if (outputFormat == YUVOutputFormat::Gray8)
+        {
+            YUV422ToLuma(inputData, outputData, numOfPixels, layout, simdLevel);
+            return;
+        }
+
+        switch (std::min(simdLevel, SwizzleKernel::getSIMDLevel()))
+        {
+        case SIMDLevel::AVX2:
+            YUV422ToPixelsAVX2(inputData, outputData, numOfPixels, layout, colorSpace, outputFormat);
+            break;
+        case SIMDLevel::SSSE3:
+            YUV422ToPixelsSSSE3(inputData, outputData, numOfPixels, layout, colorSpace, outputFormat);
+            break;
+        default:
+            YUV422ToPixelsScalar(inputData, outputData, numOfPixels, layout, colorSpace, outputFormat);
+            break;
+        }
+    }
+
+    void YUVKernel::YUV422ToPixelsScalar(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        const auto offsets = getOffsets(layout);
+        const auto& coefficients = getCoefficients(colorSpace);
+        const int bytesPerPixel = getBytesPerPixel(outputFormat);
+        const bool isRGB = isRGBOrder(outputFormat);
+        for (int x = 0; x < numOfPixels; x += 2)
+        {
+            // U and V are shared by 2 pixels
+            const unsigned char* pair = inputData + x * 2;
+            const int u = pair[offsets.U] - 128;
+            const int v = pair[offsets.V] - 128;
+            const int bu = coefficients.UB * u;
+            const int guv = coefficients.UG * u + coefficients.VG * v;
+            const int rv = coefficients.VR * v;
+
+            for (int i = 0; i < 2; i++)
+            {
+                const int y = (pair[offsets.Y + i * 2] - 16) * coefficients.YG + 32;
+                const unsigned char b = Clamp((y + bu) >> 6);
+                const unsigned char g = Clamp((y - guv) >> 6);
+                const unsigned char r = Clamp((y + rv) >> 6);
+
+                unsigned char* pixel = outputData + (x + i) * bytesPerPixel;
+                pixel[0] = isRGB ? r : b;
+                pixel[1] = g;
+                pixel[2] = isRGB ? b : r;
+                if (bytesPerPixel == 4) pixel[3] = 255;
+            }
+        }
+    }
+
+    void YUVKernel::YUV422ToLuma(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout
+    )
+    {
+        YUV422ToLuma(inputData, outputData, numOfPixels, layout, SwizzleKernel::getSIMDLevel());
+    }
+
+    void YUVKernel::YUV422ToLuma(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout,
+        const SIMDLevel simdLevel
+    )
+    {
+        switch (std::min(simdLevel, SwizzleKernel::getSIMDLevel()))
+        {
+        case SIMDLevel::AVX2:
+            YUV422ToLumaAVX2(inputData, outputData, numOfPixels, layout);
+            break;
+        case SIMDLevel::SSSE3:
+            YUV422ToLumaSSE2(inputData, outputData, numOfPixels, layout);
+            break;
+        default:
+            YUV422ToLumaScalar(inputData, outputData, numOfPixels, layout);
+            break;
+        }
+    }
+
+    void YUVKernel::YUV422ToLumaScalar(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout
+    )
+    {
+        const int offset = getOffsets(layout).Y;
+        for (int x = 0; x < numOfPixels; x++)
+        {
+            outputData[x] = inputData[x * 2 + offset];
+        }
+    }
+
+    void YUVKernel::YUV420ToPixels(
+        const unsigned char* yRow,
+        const unsigned char* uRow,
+        const unsigned char* vRow,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV420Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        YUV420ToPixels(yRow, uRow, vRow, outputData, numOfPixels, layout, colorSpace, outputFormat, SwizzleKernel::getSIMDLevel());
+    }
+
+    void YUVKernel::YUV420ToPixels(
+        const unsigned char* yRow,
+        const unsigned char* uRow,
+        const unsigned char* vRow,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV420Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat,
+        const SIMDLevel simdLevel
+    )
+    {
+        // Y only, the Y plane is already 8 bit gray
+        if (outputFormat == YUVOutputFormat::Gray8)
+        {
+            memcpy(outputData, yRow, (size_t)numOfPixels);
+            return;
+        }
+
+        switch (std::min(simdLevel, SwizzleKernel::getSIMDLevel()))
+        {
+        case SIMDLevel::AVX2:
+            YUV420ToPixelsAVX2(yRow, uRow, vRow, outputData, numOfPixels, layout, colorSpace, outputFormat);
+            break;
+        case SIMDLevel::SSSE3:
+            YUV420ToPixelsSSSE3(yRow, uRow, vRow, outputData, numOfPixels, layout, colorSpace, outputFormat);
+            break;
+        default:
+            YUV420ToPixelsScalar(yRow, uRow, vRow, outputData, numOfPixels, layout, colorSpace, outputFormat);
+            break;
+        }
+    }
+
+    void YUVKernel::YUV420ToPixelsScalar(
+        const unsigned char* yRow,
+        const unsigned char* uRow,
+        const unsigned char* vRow,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV420Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        const auto& coefficients = getCoefficients(colorSpace);
+        const int bytesPerPixel = getBytesPerPixel(outputFormat);
+        const bool isRGB = isRGBOrder(outputFormat);
+        const bool isNV12 = layout == YUV420Layout::NV12;
+        for (int x = 0; x < numOfPixels; x += 2)
+        {
+            // U and V are shared by 2 pixels. The last pixel has its own chroma sample if the width is odd.
+            const int chromaX = x / 2;
+            const int u = (isNV12 ? uRow[chromaX * 2] : uRow[chromaX]) - 128;
+            const int v = (isNV12 ? uRow[chromaX * 2 + 1] : vRow[chromaX]) - 128;
+            const int bu = coefficients.UB * u;
+            const int guv = coefficients.UG * u + coefficients.VG * v;
+            const int rv = coefficients.VR * v;
+
+            for (int i = 0; i < 2 && x + i < numOfPixels; i++)
+            {
+                const int y = (yRow[x + i] - 16) * coefficients.YG + 32;
+                const unsigned char b = Clamp((y + bu) >> 6);
+                const unsigned char g = Clamp((y - guv) >> 6);
+                const unsigned char r = Clamp((y + rv) >> 6);
+
+                unsigned char* pixel = outputData + (x + i) * bytesPerPixel;
+                pixel[0] = isRGB ? r : b;
+                pixel[1] = g;
+                pixel[2] = isRGB ? b : r;
+                if (bytesPerPixel == 4) pixel[3] = 255;
+            }
+        }
+    }
+
+#ifdef DIRECTSHOW_CAMERA_X86
+
+    DIRECTSHOW_CAMERA_TARGET("ssse3")
+    void YUVKernel::YUV422ToPixelsSSSE3(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        // 16 pixels per 32 bytes
+        __m128i masks[3];
+        getShuffleMasks(layout, masks);
+        const int bytesPerPixel = getBytesPerPixel(outputFormat);
+
+        const auto& c = getCoefficients(colorSpace);
+        const __m128i coefficients[5] = { _mm_set1_epi16(c.YG), _mm_set1_epi16(c.UB), _mm_set1_epi16(c.UG), _mm_set1_epi16(c.VG), _mm_set1_epi16(c.VR) };
+        const bool isRGB = isRGBOrder(outputFormat);
+        const bool hasAlpha = bytesPerPixel == 4;
+
+        int x = 0;
+        for (; x + 16 <= numOfPixels; x += 16)
+        {
+            const __m128i v0 = _mm_loadu_si128((const __m128i*)(inputData + x * 2));
+            const __m128i v1 = _mm_loadu_si128((const __m128i*)(inputData + x * 2 + 16));
+            __m128i b0, g0, r0, b1, g1, r1;
+            ConvertYUV422SSSE3(v0, masks, coefficients, b0, g0, r0);
+            ConvertYUV422SSSE3(v1, masks, coefficients, b1, g1, r1);
+            const __m128i b = _mm_packus_epi16(b0, b1);
+            const __m128i g = _mm_packus_epi16(g0, g1);
+            const __m128i r = _mm_packus_epi16(r0, r1);
+            StorePixelsSSSE3(isRGB ? r : b, g, isRGB ? b : r, outputData + x * bytesPerPixel, hasAlpha);
+        }
+
+        // Remaining pixels
+        YUV422ToPixelsScalar(inputData + x * 2, outputData + x * bytesPerPixel, numOfPixels - x, layout, colorSpace, outputFormat);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2")
+    void YUVKernel::YUV422ToPixelsAVX2(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        // 32 pixels per 64 bytes. Pixel 0-7 and 8-15 of a load are in different lanes, packing 2 loads gives 0-7, 16-23 | 8-15, 24-31
+        // so the 64-bit blocks are reordered after the pack.
+        __m128i masks128[3];
+        getShuffleMasks(layout, masks128);
+        const __m256i masks[3] = { _mm256_broadcastsi128_si256(masks128[0]), _mm256_broadcastsi128_si256(masks128[1]), _mm256_broadcastsi128_si256(masks128[2]) };
+        const int bytesPerPixel = getBytesPerPixel(outputFormat);
+
+        const auto& c = getCoefficients(colorSpace);
+        const __m256i coefficients[5] = { _mm256_set1_epi16(c.YG), _mm256_set1_epi16(c.UB), _mm256_set1_epi16(c.UG), _mm256_set1_epi16(c.VG), _mm256_set1_epi16(c.VR) };
+        const bool isRGB = isRGBOrder(outputFormat);
+        const bool hasAlpha = bytesPerPixel == 4;
+
+        int x = 0;
+        for (; x + 32 <= numOfPixels; x += 32)
+        {
+            const __m256i v0 = _mm256_loadu_si256((const __m256i*)(inputData + x * 2));
+            const __m256i v1 = _mm256_loadu_si256((const __m256i*)(inputData + x * 2 + 32));
+            __m256i b0, g0, r0, b1, g1, r1;
+            ConvertYUV422AVX2(v0, masks, coefficients, b0, g0, r0);
+            ConvertYUV422AVX2(v1, masks, coefficients, b1, g1, r1);
+            const __m256i b = _mm256_permute4x64_epi64(_mm256_packus_epi16(b0, b1), 0xD8);
+            const __m256i g = _mm256_permute4x64_epi64(_mm256_packus_epi16(g0, g1), 0xD8);
+            const __m256i r = _mm256_permute4x64_epi64(_mm256_packus_epi16(r0, r1), 0xD8);
+            const __m256i c0 = isRGB ? r : b;
+            const __m256i c2 = isRGB ? b : r;
+            StorePixelsSSSE3(_mm256_castsi256_si128(c0), _mm256_castsi256_si128(g), _mm256_castsi256_si128(c2), outputData + x * bytesPerPixel, hasAlpha);
+            StorePixelsSSSE3(_mm256_extracti128_si256(c0, 1), _mm256_extracti128_si256(g, 1), _mm256_extracti128_si256(c2, 1), outputData + (x + 16) * bytesPerPixel, hasAlpha);
+        }
+
+        // Remaining pixels
+        YUV422ToPixelsSSSE3(inputData + x * 2, outputData + x * bytesPerPixel, numOfPixels - x, layout, colorSpace, outputFormat);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("sse2")
+    void YUVKernel::YUV422ToLumaSSE2(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout
+    )
+    {
+        // Y is the low byte of each 16-bit word in YUYV and the high byte in UYVY. Keep it in the low byte and pack 16 pixels.
+        const bool isUYVY = layout == YUV422Layout::UYVY;
+        const __m128i lowByteMask = _mm_set1_epi16(0x00FF);
+
+        int x = 0;
+        for (; x + 16 <= numOfPixels; x += 16)
+        {
+            __m128i v0 = _mm_loadu_si128((const __m128i*)(inputData + x * 2));
+            __m128i v1 = _mm_loadu_si128((const __m128i*)(inputData + x * 2 + 16));
+            if (isUYVY)
+            {
+                v0 = _mm_srli_epi16(v0, 8);
+                v1 = _mm_srli_epi16(v1, 8);
+            }
+            else
+            {
+                v0 = _mm_and_si128(v0, lowByteMask);
+                v1 = _mm_and_si128(v1, lowByteMask);
+            }
+            _mm_storeu_si128((__m128i*)(outputData + x), _mm_packus_epi16(v0, v1));
+        }
+
+        // Remaining pixels
+        YUV422ToLumaScalar(inputData + x * 2, outputData + x, numOfPixels - x, layout);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2")
+    void YUVKernel::YUV422ToLumaAVX2(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout
+    )
+    {
+        // 32 pixels per 64 bytes, the 64-bit blocks are reordered after the pack as YUV422ToPixelsAVX2()
+        const bool isUYVY = layout == YUV422Layout::UYVY;
+        const __m256i lowByteMask = _mm256_set1_epi16(0x00FF);
+
+        int x = 0;
+        for (; x + 32 <= numOfPixels; x += 32)
+        {
+            __m256i v0 = _mm256_loadu_si256((const __m256i*)(inputData + x * 2));
+            __m256i v1 = _mm256_loadu_si256((const __m256i*)(inputData + x * 2 + 32));
+            if (isUYVY)
+            {
+                v0 = _mm256_srli_epi16(v0, 8);
+                v1 = _mm256_srli_epi16(v1, 8);
+            }
+            else
+            {
+                v0 = _mm256_and_si256(v0, lowByteMask);
+                v1 = _mm256_and_si256(v1, lowByteMask);
+            }
+            _mm256_storeu_si256((__m256i*)(outputData + x), _mm256_permute4x64_epi64(_mm256_packus_epi16(v0, v1), 0xD8));
+        }
+
+        // Remaining pixels
+        YUV422ToLumaSSE2(inputData + x * 2, outputData + x, numOfPixels - x, layout);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("ssse3")
+    void YUVKernel::YUV420ToPixelsSSSE3(
+        const unsigned char* yRow,
+        const unsigned char* uRow,
+        const unsigned char* vRow,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV420Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        // 16 pixels per 16 Y bytes and 8 U V pairs. The I420 U and V are interleaved into pairs as NV12.
+        __m128i uMask, vMask;
+        getUVPairShuffleMasks(uMask, vMask);
+        const int bytesPerPixel = getBytesPerPixel(outputFormat);
+        const __m128i zero = _mm_setzero_si128();
+
+        const auto& c = getCoefficients(colorSpace);
+        const __m128i coefficients[5] = { _mm_set1_epi16(c.YG), _mm_set1_epi16(c.UB), _mm_set1_epi16(c.UG), _mm_set1_epi16(c.VG), _mm_set1_epi16(c.VR) };
+        const bool isRGB = isRGBOrder(outputFormat);
+        const bool hasAlpha = bytesPerPixel == 4;
+        const bool isNV12 = layout == YUV420Layout::NV12;
+
+        int x = 0;
+        for (; x + 16 <= numOfPixels; x += 16)
+        {
+            const __m128i y = _mm_loadu_si128((const __m128i*)(yRow + x));
+            const __m128i uv = isNV12 ?
+                _mm_loadu_si128((const __m128i*)(uRow + x)) :
+                _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(uRow + x / 2)), _mm_loadl_epi64((const __m128i*)(vRow + x / 2)));
+            const __m128i uvLow = _mm_unpacklo_epi8(uv, zero);
+            const __m128i uvHigh = _mm_unpackhi_epi8(uv, zero);
+
+            __m128i b0, g0, r0, b1, g1, r1;
+            ConvertYUVSSSE3(_mm_unpacklo_epi8(y, zero), _mm_shuffle_epi8(uvLow, uMask), _mm_shuffle_epi8(uvLow, vMask), coefficients, b0, g0, r0);
+            ConvertYUVSSSE3(_mm_unpackhi_epi8(y, zero), _mm_shuffle_epi8(uvHigh, uMask), _mm_shuffle_epi8(uvHigh, vMask), coefficients, b1, g1, r1);
+            const __m128i b = _mm_packus_epi16(b0, b1);
+            const __m128i g = _mm_packus_epi16(g0, g1);
+            const __m128i r = _mm_packus_epi16(r0, r1);
+            StorePixelsSSSE3(isRGB ? r : b, g, isRGB ? b : r, outputData + x * bytesPerPixel, hasAlpha);
+        }
+
+        // Remaining pixels. x is even, so the chroma of the remaining pixels starts at x / 2.
+        YUV420ToPixelsScalar(yRow + x, isNV12 ? uRow + x : uRow + x / 2, isNV12 ? vRow : vRow + x / 2, outputData + x * bytesPerPixel, numOfPixels - x, layout, colorSpace, outputFormat);
+    }
+
+    DIRECTSHOW_CAMERA_TARGET("avx2")
+    void YUVKernel::YUV420ToPixelsAVX2(
+        const unsigned char* yRow,
+        const unsigned char* uRow,
+        const unsigned char* vRow,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV420Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        // 32 pixels per 32 Y bytes and 16 U V pairs. The bytes are zero extended in order, so the 128-bit masks work in each lane.
+        // The 64-bit blocks are reordered after the pack as YUV422ToPixelsAVX2().
+        __m128i uMask128, vMask128;
+        getUVPairShuffleMasks(uMask128, vMask128);
+        const __m256i uMask = _mm256_broadcastsi128_si256(uMask128);
+        const __m256i vMask = _mm256_broadcastsi128_si256(vMask128);
+        const int bytesPerPixel = getBytesPerPixel(outputFormat);
+
+        const auto& c = getCoefficients(colorSpace);
+        const __m256i coefficients[5] = { _mm256_set1_epi16(c.YG), _mm256_set1_epi16(c.UB), _mm256_set1_epi16(c.UG), _mm256_set1_epi16(c.VG), _mm256_set1_epi16(c.VR) };
+        const bool isRGB = isRGBOrder(outputFormat);
+        const bool hasAlpha = bytesPerPixel == 4;
+        const bool isNV12 = layout == YUV420Layout::NV12;
+
+        int x = 0;
+        for (; x + 32 <= numOfPixels; x += 32)
+        {
+            const __m128i y0 = _mm_loadu_si128((const __m128i*)(yRow + x));
+            const __m128i y1 = _mm_loadu_si128((const __m128i*)(yRow + x + 16));
+            __m128i uv0, uv1;
+            if (isNV12)
+            {
+                uv0 = _mm_loadu_si128((const __m128i*)(uRow + x));
+                uv1 = _mm_loadu_si128((const __m128i*)(uRow + x + 16));
+            }
+            else
+            {
+                const __m128i u = _mm_loadu_si128((const __m128i*)(uRow + x / 2));
+                const __m128i v = _mm_loadu_si128((const __m128i*)(vRow + x / 2));
+                uv0 = _mm_unpacklo_epi8(u, v);
+                uv1 = _mm_unpackhi_epi8(u, v);
+            }
+            const __m256i uvWide0 = _mm256_cvtepu8_epi16(uv0);
+            const __m256i uvWide1 = _mm256_cvtepu8_epi16(uv1);
+
+            __m256i b0, g0, r0, b1, g1, r1;
+            ConvertYUVAVX2(_mm256_cvtepu8_epi16(y0), _mm256_shuffle_epi8(uvWide0, uMask), _mm256_shuffle_epi8(uvWide0, vMask), coefficients, b0, g0, r0);
+            ConvertYUVAVX2(_mm256_cvtepu8_epi16(y1), _mm256_shuffle_epi8(uvWide1, uMask), _mm256_shuffle_epi8(uvWide1, vMask), coefficients, b1, g1, r1);
+            const __m256i b = _mm256_permute4x64_epi64(_mm256_packus_epi16(b0, b1), 0xD8);
+            const __m256i g = _mm256_permute4x64_epi64(_mm256_packus_epi16(g0, g1), 0xD8);
+            const __m256i r = _mm256_permute4x64_epi64(_mm256_packus_epi16(r0, r1), 0xD8);
+            const __m256i c0 = isRGB ? r : b;
+            const __m256i c2 = isRGB ? b : r;
+            StorePixelsSSSE3(_mm256_castsi256_si128(c0), _mm256_castsi256_si128(g), _mm256_castsi256_si128(c2), outputData + x * bytesPerPixel, hasAlpha);
+            StorePixelsSSSE3(_mm256_extracti128_si256(c0, 1), _mm256_extracti128_si256(g, 1), _mm256_extracti128_si256(c2, 1), outputData + (x + 16) * bytesPerPixel, hasAlpha);
+        }
+
+        // Remaining pixels
+        YUV420ToPixelsSSSE3(yRow + x, isNV12 ? uRow + x : uRow + x / 2, isNV12 ? vRow : vRow + x / 2, outputData + x * bytesPerPixel, numOfPixels - x, layout, colorSpace, outputFormat);
+    }
+
+#else
+
+    void YUVKernel::YUV422ToPixelsSSSE3(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        YUV422ToPixelsScalar(inputData, outputData, numOfPixels, layout, colorSpace, outputFormat);
+    }
+
+    void YUVKernel::YUV422ToPixelsAVX2(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        YUV422ToPixelsScalar(inputData, outputData, numOfPixels, layout, colorSpace, outputFormat);
+    }
+
+    void YUVKernel::YUV422ToLumaSSE2(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout
+    )
+    {
+        YUV422ToLumaScalar(inputData, outputData, numOfPixels, layout);
+    }
+
+    void YUVKernel::YUV422ToLumaAVX2(
+        const unsigned char* inputData,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV422Layout layout
+    )
+    {
+        YUV422ToLumaScalar(inputData, outputData, numOfPixels, layout);
+    }
+
+    void YUVKernel::YUV420ToPixelsSSSE3(
+        const unsigned char* yRow,
+        const unsigned char* uRow,
+        const unsigned char* vRow,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV420Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        YUV420ToPixelsScalar(yRow, uRow, vRow, outputData, numOfPixels, layout, colorSpace, outputFormat);
+    }
+
+    void YUVKernel::YUV420ToPixelsAVX2(
+        const unsigned char* yRow,
+        const unsigned char* uRow,
+        const unsigned char* vRow,
+        unsigned char* outputData,
+        const int numOfPixels,
+        const YUV420Layout layout,
+        const YUVColorSpace colorSpace,
+        const YUVOutputFormat outputFormat
+    )
+    {
+        YUV420ToPixelsScalar(yRow, uRow, vRow, outputData, numOfPixels, layout, colorSpace, outputFormat);
+    }
+
+#endif // def DIRECTSHOW_CAMERA_X86
+}
@@ -0,0 +1,244 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__FRAME__YUV_KERNEL_H
+#define DIRECTSHOW_CAMERA__FRAME__YUV_KERNEL_H
+
+//************Content************
+
+#include "frame/frame_settings.h"
+#include "frame/swizzle_kernel.h"
+
+namespace DirectShowCamera
+{
+    /**
+     * @brief Byte order of the packed YUV 4:2:2 pixels. 2 pixels share 4 bytes.
+    */
+    enum class YUV422Layout
+    {
+        YUYV,   // Y0 U Y1 V, e.g. YUY2
+        UYVY    // U Y0 V Y1, e.g. UYVY
+    };
+
+    /**
+     * @brief Plane layout of the YUV 4:2:0 frames. The Y plane is followed by the chroma planes which are subsampled by 2 in both directions.
+    */
+    enum class YUV420Layout
+    {
+        NV12,   // Y plane and an interleaved U V plane, e.g. NV12
+        I420    // Y plane, U plane and V plane, e.g. I420, IYUV
+    };
+
+    /**
+     * @brief Planes of a YUV 4:2:0 image. Rows are stored from the top. A stride may be larger than the row to pad the rows.
+    */
+    struct YUV420Planes
+    {
+        /**
+         * @brief Plane layout
+        */
+        YUV420Layout Layout = YUV420Layout::NV12;
+
+        /**
+         * @brief Y plane
+        */
+        const unsigned char* Y = nullptr;
+
+        /**
+         * @brief U plane. It is the interleaved U V plane in NV12.
+        */
+        const unsigned char* U = nullptr;
+
+        /**
+         * @brief V plane. It is not used in NV12.
+        */
+        const unsigned char* V = nullptr;
+
+        /**
+         * @brief Number of bytes per row of the Y plane
+        */
+        int YStride = 0;
+
+        /**
+         * @brief Number of bytes per row of the chroma planes
+        */
+        int UVStride = 0;
+    };
+
+    /**
+     * @brief Output pixel format of the YUV kernels
+    */
+    enum class YUVOutputFormat
+    {
+        BGR24,
+        RGB24,
+        BGRA32,
+        RGBA32,
+        Gray8   // Y channel only, see YUVKernel::YUV422ToLuma(). The Y plane of a YUV 4:2:0 image is copied.
+    };
+
+    /**
+     * @brief YUV to RGB conversion kernels.
+     *
+     * The conversion is done in 16-bit fixed point with 6 fractional bits. The kernel is selected at runtime by the instruction sets
+     * supported by the CPU. All kernels return the same output.
+     */
+    class YUVKernel
+    {
+    public:
+
+        /**
+         * @brief Get the number of bytes per pixel of an output format
+         * @param[in] outputFormat Output format
+         * @return Return the number of bytes per pixel
+        */
+        static constexpr int getBytesPerPixel(const YUVOutputFormat outputFormat)
+        {
+            switch (outputFormat)
+            {
+            case YUVOutputFormat::BGRA32:
+            case YUVOutputFormat::RGBA32:
+                return 4;
+            case YUVOutputFormat::Gray8:
+                return 1;
+            default:
+                return 3;
+            }
+        }
+
+        /**
+         * @brief Convert packed YUV 4:2:2 pixels. Alpha is set to 255.
+         * @param[in] inputData Input pixels
+         * @param[out] outputData Output pixels. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels. It must be even.
+         * @param[in] layout Byte order of the input
+         * @param[in] colorSpace Color matrix
+         * @param[in] outputFormat Output format
+        */
+        static void YUV422ToPixels(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int numOfPixels,
+            const YUV422Layout layout,
+            const YUVColorSpace colorSpace,
+            const YUVOutputFormat outputFormat
+        );
+
+        /**
+         * @brief Convert packed YUV 4:2:2 pixels by a specific SIMD level. Alpha is set to 255.
+         * @param[in] inputData Input pixels
+         * @param[out] outputData Output pixels. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels. It must be even.
+         * @param[in] layout Byte order of the input
+         * @param[in] colorSpace Color matrix
+         * @param[in] outputFormat Output format
+         * @param[in] simdLevel SIMD level. It is lowered to SwizzleKernel::getSIMDLevel() if the CPU doesn't support it.
+        */
+        static void YUV422ToPixels(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int numOfPixels,
+            const YUV422Layout layout,
+            const YUVColorSpace colorSpace,
+            const YUVOutputFormat outputFormat,
+            const SIMDLevel simdLevel
+        );
+
+        /**
+         * @brief Extract the Y channel of packed YUV 4:2:2 pixels. No color conversion is done.
+         * @param[in] inputData Input pixels
+         * @param[out] outputData Output 8 bit gray pixels. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] layout Byte order of the input
+        */
+        static void YUV422ToLuma(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int numOfPixels,
+            const YUV422Layout layout
+        );
+
+        /**
+         * @brief Extract the Y channel of packed YUV 4:2:2 pixels by a specific SIMD level. No color conversion is done.
+         * @param[in] inputData Input pixels
+         * @param[out] outputData Output 8 bit gray pixels. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] layout Byte order of the input
+         * @param[in] simdLevel SIMD level. It is lowered to SwizzleKernel::getSIMDLevel() if the CPU doesn't support it.
+        */
+        static void YUV422ToLuma(
+            const unsigned char* inputData,
+            unsigned char* outputData,
+            const int numOfPixels,
+            const YUV422Layout layout,
+            const SIMDLevel simdLevel
+        );
+
+        /**
+         * @brief Convert a row of YUV 4:2:0 pixels. Alpha is set to 255.
+         * @param[in] yRow Y row
+         * @param[in] uRow U row. It is the interleaved U V row in NV12.
+         * @param[in] vRow V row. It is not used in NV12.
+         * @param[out] outputData Output pixels. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] layout Plane layout of the input
+         * @param[in] colorSpace Color matrix
+         * @param[in] outputFormat Output format
+        */
+        static void YUV420ToPixels(
+            const unsigned char* yRow,
+            const unsigned char* uRow,
+            const unsigned char* vRow,
+            unsigned char* outputData,
+            const int numOfPixels,
+            const YUV420Layout layout,
+            const YUVColorSpace colorSpace,
+            const YUVOutputFormat outputFormat
+        );
+
+        /**
+         * @brief Convert a row of YUV 4:2:0 pixels by a specific SIMD level. Alpha is set to 255.
+         * @param[in] yRow Y row
+         * @param[in] uRow U row. It is the interleaved U V row in NV12.
+         * @param[in] vRow V row. It is not used in NV12.
+         * @param[out] outputData Output pixels. It must not overlap the input.
+         * @param[in] numOfPixels Number of pixels
+         * @param[in] layout Plane layout of the input
+         * @param[in] colorSpace Color matrix
+         * @param[in] outputFormat Output format
+         * @param[in] simdLevel SIMD level. It is lowered to SwizzleKernel::getSIMDLevel() if the CPU doesn't support it.
+        */
+        static void YUV420ToPixels(
+            const unsigned char* yRow,
+            const unsigned char* uRow,
+            const unsigned char* vRow,
+            unsigned char* outputData,
+            const int numOfPixels,
+            const YUV420Layout layout,
+            const YUVColorSpace colorSpace,
+            const YUVOutputFormat outputFormat,
+            const SIMDLevel simdLevel
+        );
+
+    private:
+        static void YUV422ToPixelsScalar(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels, const YUV422Layout layout, const YUVColorSpace colorSpace, const YUVOutputFormat outputFormat);
+        static void YUV422ToPixelsSSSE3(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels, const YUV422Layout layout, const YUVColorSpace colorSpace, const YUVOutputFormat outputFormat);
+        static void YUV422ToPixelsAVX2(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels, const YUV422Layout layout, const YUVColorSpace colorSpace, const YUVOutputFormat outputFormat);
+
+        static void YUV422ToLumaScalar(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels, const YUV422Layout layout);
+        static void YUV422ToLumaSSE2(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels, const YUV422Layout layout);
+        static void YUV422ToLumaAVX2(const unsigned char* inputData, unsigned char* outputData, const int numOfPixels, const YUV422Layout layout);
+
+        static void YUV420ToPixelsScalar(const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* outputData, const int numOfPixels, const YUV420Layout layout, const YUVColorSpace colorSpace, const YUVOutputFormat outputFormat);
+        static void YUV420ToPixelsSSSE3(const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* outputData, const int numOfPixels, const YUV420Layout layout, const YUVColorSpace colorSpace, const YUVOutputFormat outputFormat);
+        static void YUV420ToPixelsAVX2(const unsigned char* yRow, const unsigned char* uRow, const unsigned char* vRow, unsigned char* outputData, const int numOfPixels, const YUV420Layout layout, const YUVColorSpace colorSpace, const YUVOutputFormat outputFormat);
+    };
+}
+
+//*******************************
+
+#endif
@@ -0,0 +1,89 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "utils/cpu_utils.h"
+
+#if defined(DIRECTSHOW_CAMERA_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Utils
+{
+    namespace
+    {
+#if defined(DIRECTSHOW_CAMERA_X86) && defined(_MSC_VER)
+        /**
+         * @brief Check a bit of CPUID
+         * @param[in] leaf CPUID leaf
+         * @param[in] registerIndex Register index. 0: EAX, 1: EBX, 2: ECX, 3: EDX
+         * @param[in] bit Bit
+         * @return Return true if the bit is set
+        */
+        bool isCPUIDBitSet(const int leaf, const int registerIndex, const int bit)
+        {
+            int cpuInfo[4] = { 0 };
+            __cpuid(cpuInfo, 0);
+            if (cpuInfo[0] < leaf) return false;
+
+            __cpuidex(cpuInfo, leaf, 0);
+            return (cpuInfo[registerIndex] & (1 << bit)) != 0;
+        }
+#endif
+    }
+
+    bool CPUUtils::isSSSE3Supported()
+    {
+#if defined(DIRECTSHOW_CAMERA_X86) && defined(_MSC_VER)
+        static const bool supported = isCPUIDBitSet(1, 2, 9);
+        return supported;
+#elif defined(DIRECTSHOW_CAMERA_X86)
+        static const bool supported = __builtin_cpu_supports("ssse3");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    bool CPUUtils::isAVX2Supported()
+    {
+#if defined(DIRECTSHOW_CAMERA_X86) && defined(_MSC_VER)
+        static const bool supported = []() {
+            // OS saves the AVX registers (OSXSAVE, AVX and XCR0 bit 1 and 2)
+            if (!isCPUIDBitSet(1, 2, 27) || !isCPUIDBitSet(1, 2, 28)) return false;
+            if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+            // AVX2
+            return isCPUIDBitSet(7, 1, 5);
+        }();
+        return supported;
+#elif defined(DIRECTSHOW_CAMERA_X86)
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return false;
+#endif
+    }
+
+    bool CPUUtils::isF16CSupported()
+    {
+#if defined(DIRECTSHOW_CAMERA_X86) && defined(_MSC_VER)
+        static const bool supported = []() {
+            // OS saves the AVX registers (OSXSAVE, AVX and XCR0 bit 1 and 2)
+            if (!isCPUIDBitSet(1, 2, 27) || !isCPUIDBitSet(1, 2, 28)) return false;
+            if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+            // F16C
+            return isCPUIDBitSet(1, 2, 29);
+        }();
+        return supported;
+#elif defined(DIRECTSHOW_CAMERA_X86)
+        static const bool supported = __builtin_cpu_supports("f16c");
+        return supported;
+#else
+        return false;
+#endif
+    }
+}
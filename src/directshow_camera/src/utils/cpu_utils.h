@@ -0,0 +1,52 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__UTILS__CPU_UTILS_H
+#define DIRECTSHOW_CAMERA__UTILS__CPU_UTILS_H
+
+//************Content************
+
+// x86 and x64 build, SIMD kernels are available
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DIRECTSHOW_CAMERA_X86
+#endif
+
+// Enable an instruction set for a function. MSVC doesn't need it.
+#if defined(__GNUC__) || defined(__clang__)
+#define DIRECTSHOW_CAMERA_TARGET(instructionSet) __attribute__((target(instructionSet)))
+#else
+#define DIRECTSHOW_CAMERA_TARGET(instructionSet)
+#endif
+
+namespace Utils
+{
+    class CPUUtils
+    {
+    public:
+        /**
+         * @brief Check if the CPU supports SSSE3. The result is detected once.
+         * @return Return true if SSSE3 is supported
+        */
+        static bool isSSSE3Supported();
+
+        /**
+         * @brief Check if the CPU and the OS support AVX2. The result is detected once.
+         * @return Return true if AVX2 is supported
+        */
+        static bool isAVX2Supported();
+
+        /**
+         * @brief Check if the CPU and the OS support F16C, i.e. the half precision float conversion of the AVX registers. The result is detected once.
+         * @return Return true if F16C is supported
+        */
+        static bool isF16CSupported();
+    };
+}
+
+//*******************************
+
+#endif
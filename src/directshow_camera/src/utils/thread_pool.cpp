@@ -0,0 +1,119 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include "utils/thread_pool.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace Utils
+{
+    ThreadPool::ThreadPool(const int numOfWorkers)
+    {
+        // Check
+        if (numOfWorkers < 0) throw std::invalid_argument("Number of workers(" + std::to_string(numOfWorkers) + ") can't be < 0.");
+
+        m_jobs.reserve(16);
+        m_workers.reserve(numOfWorkers);
+        for (int i = 0; i < numOfWorkers; i++)
+        {
+            m_workers.emplace_back(&ThreadPool::Run, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_jobAvailable.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    int ThreadPool::getNumOfWorkers() const
+    {
+        return (int)m_workers.size();
+    }
+
+    void ThreadPool::ParallelFor(const int numOfTasks, const std::function<void(int)>& task)
+    {
+        // Nothing to share
+        if (numOfTasks <= 0) return;
+        if (numOfTasks == 1 || m_workers.empty())
+        {
+            for (int i = 0; i < numOfTasks; i++) task(i);
+            return;
+        }
+
+        Job job;
+        job.Task = &task;
+        job.NumOfTasks = numOfTasks;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        // Publish
+        m_jobs.push_back(&job);
+        m_jobAvailable.notify_all();
+
+        // Work on the job
+        while (job.NextTask < job.NumOfTasks)
+        {
+            RunTask(job, job.NextTask++, lock);
+        }
+
+        // Wait for the tasks taken by the workers
+        m_jobs.erase(std::remove(m_jobs.begin(), m_jobs.end(), &job), m_jobs.end());
+        m_jobFinished.wait(lock, [&job]() { return job.NumOfFinishedTasks == job.NumOfTasks; });
+
+        if (job.Exception) std::rethrow_exception(job.Exception);
+    }
+
+    void ThreadPool::Run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_jobAvailable.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+            if (m_stop) return;
+
+            // Take a task of the oldest job. A job without task left is waiting for its caller to remove it.
+            Job& job = *m_jobs.front();
+            if (job.NextTask >= job.NumOfTasks)
+            {
+                m_jobs.erase(m_jobs.begin());
+                continue;
+            }
+
+            RunTask(job, job.NextTask++, lock);
+        }
+    }
+
+    void ThreadPool::RunTask(Job& job, const int taskIndex, std::unique_lock<std::mutex>& lock)
+    {
+        lock.unlock();
+        std::exception_ptr exception = nullptr;
+        try
+        {
+            (*job.Task)(taskIndex);
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+        lock.lock();
+
+        // The job can't be released by its caller until all tasks are finished
+        if (exception && !job.Exception) job.Exception = exception;
+        job.NumOfFinishedTasks++;
+        if (job.NumOfFinishedTasks == job.NumOfTasks) m_jobFinished.notify_all();
+    }
+}
@@ -0,0 +1,98 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#pragma once
+#ifndef DIRECTSHOW_CAMERA__UTILS__THREAD_POOL_H
+#define DIRECTSHOW_CAMERA__UTILS__THREAD_POOL_H
+
+//************Content************
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Utils
+{
+    /**
+     * @brief A fixed size worker pool running parallel-for jobs. The calling thread works on its own job too.
+     *        Jobs from different threads can run at the same time.
+     */
+    class ThreadPool
+    {
+    public:
+
+        /**
+         * @brief Constructor
+         * @param[in] numOfWorkers Number of worker threads. It must be >= 0.
+        */
+        ThreadPool(const int numOfWorkers);
+
+        /**
+         * @brief Destructor. Worker threads are joined.
+        */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Get the number of worker threads
+         * @return Return the number of worker threads
+        */
+        int getNumOfWorkers() const;
+
+        /**
+         * @brief Run task(0) to task(numOfTasks - 1) on the workers and the calling thread, and wait until all tasks are finished.
+         *        The first exception thrown by a task is rethrown after all tasks are finished.
+         * @param[in] numOfTasks Number of tasks
+         * @param[in] task Task which takes the task index
+        */
+        void ParallelFor(const int numOfTasks, const std::function<void(int)>& task);
+
+    private:
+
+        /**
+         * @brief A ParallelFor() call. It lives on the stack of the calling thread.
+        */
+        struct Job
+        {
+            const std::function<void(int)>* Task = nullptr;
+            int NumOfTasks = 0;
+            int NextTask = 0;
+            int NumOfFinishedTasks = 0;
+            std::exception_ptr Exception = nullptr;
+        };
+
+        /**
+         * @brief Worker thread
+        */
+        void Run();
+
+        /**
+         * @brief Run a task of the job and mark it finished. The lock is released while the task is running.
+         * @param[in] job Job
+         * @param[in] taskIndex Task index
+         * @param[in] lock Lock of m_mutex
+        */
+        void RunTask(Job& job, const int taskIndex, std::unique_lock<std::mutex>& lock);
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::vector<Job*> m_jobs;
+
+        std::mutex m_mutex;
+        std::condition_variable m_jobAvailable;
+        std::condition_variable m_jobFinished;
+        bool m_stop = false;
+    };
+}
+
+//*******************************
+
+#endif
@@ -7,8 +7,18 @@
 #include <gtest/gtest.h>
 
 #include "camera/camera.h"
+#include "camera/camera_thread.h"
 #include "directshow_camera/stub/ds_camera_stub.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <utility>
+
+#include <windows.h>
+
 
 class TestUVCCameraStubF : public ::testing::Test {
 protected:
@@ -27,6 +37,21 @@ protected:
     DirectShowCamera::Camera camera = DirectShowCamera::Camera(stub);
 };
 
+/**
+ * @brief Get the CPU time consumed by this process
+ * @return Return the user and kernel time in second
+ */
+double getProcessCPUTime()
+{
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime);
+
+    // FILETIME is in 100ns
+    const unsigned long long kernel = ((unsigned long long)kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime;
+    const unsigned long long user = ((unsigned long long)userTime.dwHighDateTime << 32) | userTime.dwLowDateTime;
+    return (kernel + user) / 1e7;
+}
+
 /**
  * @brief 
  * <pre>
@@ -145,4 +170,648 @@ TEST(TestUVCCameraStub, TestCapture)
     EXPECT_FALSE(camera.isOpened()) << "Fail: camera.close()";
     EXPECT_FALSE(camera.isCapturing()) << "Fail: camera.close()";
 
-}
\ No newline at end of file
+}
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> stub_capture02
+ * <b>Title:</b> Test getFrame() hands the grabber buffer over to Frame without copying
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Test the zero copy consumer path with the allocation and copy counters of the frame buffer
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. open UVCCamera and start capture
+ *   2. getFrame() a few times to warm up the frame buffer and reset the statistics
+ *   3. getFrame() 100 times into the same Frame and compare with DirectShowCameraStubDefaultSetting
+ *   4. Change the frame buffer mode to mutex and getFrame()
+ *   5. Close
+ * <b>Expected Result:</b>
+ *   1. True
+ *   2. True
+ *   3. Same bytes. No allocation, no copy and 100 exchanges.
+ *   4. Same bytes. The frame is copied.
+ *   5. True
+ * </pre>
+ */
+TEST_F(TestUVCCameraStubF, TestZeroCopyGetFrame)
+{
+    const int numOfFrames = 100;
+
+    // Open and start capture
+    std::vector<DirectShowCamera::CameraDevice> cameraDeivceList = camera.getCameras();
+    std::vector <std::pair<int, int>> resolutions = cameraDeivceList[0].getResolutions();
+    const int width = resolutions[resolutions.size() - 1].first;
+    const int height = resolutions[resolutions.size() - 1].second;
+    ASSERT_TRUE(camera.Open(cameraDeivceList[0], width, height)) << "Fail: camera.open()";
+    ASSERT_TRUE(camera.StartCapture()) << "Fail: camera.startCapture()";
+
+    // Warm up. The buffers are allocated until the frame and the triple buffer slots are all in circulation.
+    DirectShowCamera::Frame frame;
+    for (int i = 0; i < 5; i++)
+    {
+        ASSERT_TRUE(camera.getFrame(frame)) << "Fail: camera.getFrame()";
+    }
+
+    // Get frames
+    const auto warmUpStatistics = camera.getFrameBufferStatistics();
+    for (int i = 0; i < numOfFrames; i++)
+    {
+        ASSERT_TRUE(camera.getFrame(frame)) << "Fail: camera.getFrame()";
+
+        DirectShowCamera::Frame expectedFrame;
+        DirectShowCamera::DirectShowCameraStubDefaultSetting::getFrame(expectedFrame, frame.getFrameIndex(), width, height);
+        EXPECT_EQ(frame, expectedFrame) << "Fail: camera.getFrame()";
+    }
+    const auto statistics = camera.getFrameBufferStatistics();
+
+    // Check
+    EXPECT_EQ(statistics.Allocations - warmUpStatistics.Allocations, 0) << "Fail: Buffer is allocated while streaming";
+    EXPECT_EQ(statistics.Copies - warmUpStatistics.Copies, 0) << "Fail: Frame is copied to the consumer";
+    EXPECT_EQ(statistics.Exchanges - warmUpStatistics.Exchanges, numOfFrames) << "Fail: Frame is not exchanged";
+
+    // Mutex mode falls back to copy
+    camera.setFrameBufferMode(DirectShowCamera::FrameBufferMode::Mutex);
+    ASSERT_TRUE(camera.getFrame(frame)) << "Fail: camera.getFrame()";
+    DirectShowCamera::Frame expectedFrame;
+    DirectShowCamera::DirectShowCameraStubDefaultSetting::getFrame(expectedFrame, frame.getFrameIndex(), width, height);
+    EXPECT_EQ(frame, expectedFrame) << "Fail: camera.getFrame()";
+    EXPECT_EQ(camera.getFrameBufferStatistics().Copies, 1) << "Fail: Frame is not copied in mutex mode";
+
+    // Close
+    EXPECT_TRUE(camera.Close()) << "Fail: camera.close()";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> stub_capture03
+ * <b>Title:</b> Test getFrame() in ring buffer mode
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Test the DirectShowCameraStub feeds the ring buffer and getFrame() returns every frame in order
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Set ring buffer mode, open UVCCamera and start capture
+ *   2. getFrame() 10 times and compare with DirectShowCameraStubDefaultSetting
+ *   3. Close
+ * <b>Expected Result:</b>
+ *   1. True
+ *   2. Frame index increases by 1 each time. Same bytes. 10 frames produced and consumed, no frame dropped.
+ *   3. True
+ * </pre>
+ */
+TEST_F(TestUVCCameraStubF, TestRingBufferGetFrame)
+{
+    const int numOfFrames = 10;
+
+    // Open and start capture
+    camera.setFrameBufferMode(DirectShowCamera::FrameBufferMode::Ring);
+    camera.setFrameRingBuffer(4, DirectShowCamera::FrameOverflowPolicy::DropOldest);
+    std::vector<DirectShowCamera::CameraDevice> cameraDeivceList = camera.getCameras();
+    std::vector <std::pair<int, int>> resolutions = cameraDeivceList[0].getResolutions();
+    const int width = resolutions[0].first;
+    const int height = resolutions[0].second;
+    ASSERT_TRUE(camera.Open(cameraDeivceList[0], width, height)) << "Fail: camera.open()";
+    ASSERT_TRUE(camera.StartCapture()) << "Fail: camera.startCapture()";
+    EXPECT_EQ(camera.getFrameRingBufferCapacity(), 4) << "Fail: camera.getFrameRingBufferCapacity()";
+
+    // Get frames
+    DirectShowCamera::Frame frame;
+    unsigned long lastFrameIndex = 0;
+    for (int i = 0; i < numOfFrames; i++)
+    {
+        ASSERT_TRUE(camera.getFrame(frame)) << "Fail: camera.getFrame()";
+        if (i > 0)
+        {
+            EXPECT_EQ(frame.getFrameIndex(), lastFrameIndex + 1) << "Fail: camera.getFrame() skips a frame";
+        }
+        lastFrameIndex = frame.getFrameIndex();
+
+        DirectShowCamera::Frame expectedFrame;
+        DirectShowCamera::DirectShowCameraStubDefaultSetting::getFrame(expectedFrame, frame.getFrameIndex(), width, height);
+        EXPECT_EQ(frame, expectedFrame) << "Fail: camera.getFrame()";
+    }
+
+    // Check
+    const auto statistics = camera.getFrameBufferStatistics();
+    EXPECT_EQ(statistics.Produced, numOfFrames) << "Fail: FrameBufferStatistics::Produced";
+    EXPECT_EQ(statistics.Consumed, numOfFrames) << "Fail: FrameBufferStatistics::Consumed";
+    EXPECT_EQ(statistics.Dropped, 0) << "Fail: FrameBufferStatistics::Dropped";
+
+    // Close
+    EXPECT_TRUE(camera.Close()) << "Fail: camera.close()";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> stub_capture04
+ * <b>Title:</b> Test getFrameLease() in lease mode
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Test the DirectShowCameraStub hands out leases over its own frames and the number of held frames is capped
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Set lease mode with 2 outstanding leases, open UVCCamera and start capture
+ *   2. getFrameLease() and compare with DirectShowCameraStubDefaultSetting
+ *   3. getFrameLease() into another lease and then getFrameLease() while both leases are held
+ *   4. Release the first lease and getFrameLease()
+ *   5. Release all leases and getFrame()
+ *   6. Close
+ * <b>Expected Result:</b>
+ *   1. True
+ *   2. True. Same bytes.
+ *   3. True for the second lease. False for the third lease and the frame is dropped.
+ *   4. True
+ *   5. True. No exchange.
+ *   6. True
+ * </pre>
+ */
+TEST_F(TestUVCCameraStubF, TestLeaseGetFrame)
+{
+    // Open and start capture
+    camera.setFrameBufferMode(DirectShowCamera::FrameBufferMode::Lease);
+    camera.setMaxFrameLeases(2);
+    std::vector<DirectShowCamera::CameraDevice> cameraDeivceList = camera.getCameras();
+    std::vector <std::pair<int, int>> resolutions = cameraDeivceList[0].getResolutions();
+    const int width = resolutions[0].first;
+    const int height = resolutions[0].second;
+    ASSERT_TRUE(camera.Open(cameraDeivceList[0], width, height)) << "Fail: camera.open()";
+    ASSERT_TRUE(camera.StartCapture()) << "Fail: camera.startCapture()";
+    EXPECT_EQ(camera.getMaxFrameLeases(), 2) << "Fail: camera.getMaxFrameLeases()";
+
+    // Lease
+    DirectShowCamera::FrameLease lease1;
+    ASSERT_TRUE(camera.getFrameLease(lease1)) << "Fail: camera.getFrameLease()";
+    ASSERT_EQ(lease1.getNumOfBytes(), camera.getFrameSize()) << "Fail: FrameLease::getNumOfBytes()";
+    DirectShowCamera::Frame expectedFrame;
+    DirectShowCamera::DirectShowCameraStubDefaultSetting::getFrame(expectedFrame, lease1.getFrameIndex(), width, height);
+    int expectedNumOfBytes = 0;
+    const unsigned char* expectedData = expectedFrame.getFrameDataPtr(expectedNumOfBytes);
+    ASSERT_EQ(lease1.getNumOfBytes(), expectedNumOfBytes) << "Fail: FrameLease::getNumOfBytes()";
+    EXPECT_EQ(memcmp(lease1.getData(), expectedData, expectedNumOfBytes), 0) << "Fail: camera.getFrameLease()";
+
+    // Lease cap
+    DirectShowCamera::FrameLease lease2;
+    DirectShowCamera::FrameLease lease3;
+    ASSERT_TRUE(camera.getFrameLease(lease2)) << "Fail: camera.getFrameLease()";
+    EXPECT_GT(lease2.getFrameIndex(), lease1.getFrameIndex()) << "Fail: camera.getFrameLease() doesn't return a new frame";
+    EXPECT_FALSE(camera.getFrameLease(lease3)) << "Fail: Frame is not dropped when the lease cap is reached";
+    EXPECT_EQ(camera.getFrameBufferStatistics().Dropped, 1) << "Fail: FrameBufferStatistics::Dropped";
+
+    // Release
+    lease1.Release();
+    EXPECT_TRUE(camera.getFrameLease(lease3)) << "Fail: camera.getFrameLease() after releasing a lease";
+
+    // Get frame by copying from the lease
+    lease2.Release();
+    lease3.Release();
+    DirectShowCamera::Frame frame;
+    EXPECT_TRUE(camera.getFrame(frame)) << "Fail: camera.getFrame()";
+    EXPECT_EQ(camera.getFrameBufferStatistics().Exchanges, 0) << "Fail: FrameBufferStatistics::Exchanges";
+
+    // Close
+    EXPECT_TRUE(camera.Close()) << "Fail: camera.close()";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> stub_capture05
+ * <b>Title:</b> Test frame capture timestamps
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Test the DirectShowCameraStub stamps each frame with the device time and the arrival time
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Open UVCCamera and start capture
+ *   2. getFrame() 2 times with 10ms in between
+ *   3. Copy the second frame
+ *   4. Close
+ * <b>Expected Result:</b>
+ *   1. True
+ *   2. The device time and the arrival time are set and increase by at least 10ms. The arrival time is not later than now.
+ *   3. Same timestamps
+ *   4. True
+ * </pre>
+ */
+TEST_F(TestUVCCameraStubF, TestFrameTimestamp)
+{
+    // Open and start capture
+    std::vector<DirectShowCamera::CameraDevice> cameraDeivceList = camera.getCameras();
+    std::vector <std::pair<int, int>> resolutions = cameraDeivceList[0].getResolutions();
+    ASSERT_TRUE(camera.Open(cameraDeivceList[0], resolutions[0].first, resolutions[0].second)) << "Fail: camera.open()";
+    ASSERT_TRUE(camera.StartCapture()) << "Fail: camera.startCapture()";
+
+    // Get frames
+    DirectShowCamera::Frame frame1;
+    DirectShowCamera::Frame frame2;
+    ASSERT_TRUE(camera.getFrame(frame1)) << "Fail: camera.getFrame()";
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_TRUE(camera.getFrame(frame2)) << "Fail: camera.getFrame()";
+
+    // Check
+    const auto timestamp1 = frame1.getTimestamp();
+    const auto timestamp2 = frame2.getTimestamp();
+    EXPECT_GE(timestamp1.DeviceTime, 0) << "Fail: FrameTimestamp::DeviceTime is not set";
+    EXPECT_GT(timestamp1.ArrivalTime, 0) << "Fail: FrameTimestamp::ArrivalTime is not set";
+    EXPECT_GE(timestamp2.DeviceTime - timestamp1.DeviceTime, 10000000) << "Fail: FrameTimestamp::DeviceTime";
+    EXPECT_GE(timestamp2.ArrivalTime - timestamp1.ArrivalTime, 10000000) << "Fail: FrameTimestamp::ArrivalTime";
+    EXPECT_LE(timestamp2.ArrivalTime, DirectShowCamera::FrameTimestamp::Now()) << "Fail: FrameTimestamp::ArrivalTime is later than now";
+
+    // Copy
+    DirectShowCamera::Frame copiedFrame = frame2;
+    EXPECT_EQ(copiedFrame.getTimestamp(), timestamp2) << "Fail: Frame copy constructor";
+
+    // Close
+    EXPECT_TRUE(camera.Close()) << "Fail: camera.close()";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> stub_capture06
+ * <b>Title:</b> Test DirectShow Camera Stub wait for frame
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Push frames from the stub at 100 fps and wait for them in UVCCamera
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Open camera and start capture in the push frame mode
+ *   2. Wait for a new frame and get it. Repeat it.
+ *   3. Get new frames by getNewFrame()
+ *   4. Close camera
+ *   5. Wait for a new frame
+ * <b>Expected Result:</b>
+ *   1. True
+ *   2. A new frame is returned every time. The median wait is < 25 ms, i.e. about a frame period (10 ms), which a wait polling in steps of
+ *      Camera::getNewFrame() (50 ms) or CameraThread (100 ms) can't meet.
+ *   3. True. The frame index increases by skip + 1.
+ *   4. True
+ *   5. False
+ * </pre>
+ */
+TEST_F(TestUVCCameraStubF, TestWaitForFrame)
+{
+    const int numOfFrames = 21;
+    const auto timeout = std::chrono::milliseconds(1000);
+    const auto maxWaitTime = std::chrono::milliseconds(25);
+
+    // Open and start capture
+    cameraStub->setPushFrameMode(true, 100);
+    std::vector<DirectShowCamera::CameraDevice> cameraDeivceList = camera.getCameras();
+    std::vector <std::pair<int, int>> resolutions = cameraDeivceList[0].getResolutions();
+    ASSERT_TRUE(camera.Open(cameraDeivceList[0], resolutions[0].first, resolutions[0].second)) << "Fail: camera.open()";
+    ASSERT_TRUE(camera.StartCapture()) << "Fail: camera.startCapture()";
+
+    // Wait for frames
+    DirectShowCamera::Frame frame;
+    std::vector<std::chrono::steady_clock::duration> waitTimes;
+    for (int i = 0; i < numOfFrames; i++)
+    {
+        const unsigned long lastFrameIndex = camera.getLastFrameIndex();
+        const auto waitStartTime = std::chrono::steady_clock::now();
+        ASSERT_TRUE(camera.waitForFrame(lastFrameIndex, waitStartTime + timeout)) << "Fail: camera.waitForFrame()";
+        waitTimes.push_back(std::chrono::steady_clock::now() - waitStartTime);
+        ASSERT_TRUE(camera.getFrame(frame, true)) << "Fail: camera.getFrame()";
+        EXPECT_NE(frame.getFrameIndex(), lastFrameIndex) << "Fail: camera.waitForFrame() returns without a new frame";
+    }
+
+    // A blocking wait is woken up by the next frame, a polling wait sleeps at least a step. The median is robust to a preempted wake-up.
+    std::sort(waitTimes.begin(), waitTimes.end());
+    EXPECT_LT(waitTimes[numOfFrames / 2], maxWaitTime) << "Fail: camera.waitForFrame() is not woken up by the frame";
+
+    // Get new frame
+    const unsigned long lastFrameIndex = camera.getLastFrameIndex();
+    ASSERT_TRUE(camera.getNewFrame(frame, 50, 1000, 2)) << "Fail: camera.getNewFrame()";
+    EXPECT_GE(frame.getFrameIndex(), lastFrameIndex + 3) << "Fail: camera.getNewFrame() skips less frames";
+
+    // Close
+    EXPECT_TRUE(camera.Close()) << "Fail: camera.close()";
+    EXPECT_FALSE(camera.waitForFrame(camera.getLastFrameIndex(), std::chrono::steady_clock::now() + std::chrono::milliseconds(20))) << "Fail: camera.waitForFrame() after closing";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> stub_capture07
+ * <b>Title:</b> Test raw YUV capture
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Capture the YUY2 video format of the stub in YUY2 and decode it lazily in Frame
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Enable the raw YUV capture, open UVCCamera in the YUY2 video format and start capture
+ *   2. getFrame()
+ *   3. Get the decoded frame data
+ *   4. Close
+ * <b>Expected Result:</b>
+ *   1. True
+ *   2. The frame is in YUY2 with 2 bytes per pixel. The frame type is BGR.
+ *   3. Same as the default RGB frame within the error of the YUV conversion
+ *   4. True
+ * </pre>
+ */
+TEST_F(TestUVCCameraStubF, TestRawYUVCapture)
+{
+    const int width = 640;
+    const int height = 480;
+
+    // Open and start capture
+    camera.setRawYUVCapture(true);
+    EXPECT_TRUE(camera.isRawYUVCapture()) << "Fail: camera.isRawYUVCapture()";
+    ASSERT_TRUE(camera.Open(width, height)) << "Fail: camera.open()";
+    ASSERT_TRUE(camera.StartCapture()) << "Fail: camera.startCapture()";
+
+    // Get frame
+    DirectShowCamera::Frame frame;
+    ASSERT_TRUE(camera.getFrame(frame)) << "Fail: camera.getFrame()";
+    EXPECT_EQ(frame.getFrameType(), DirectShowCamera::Frame::FrameType::ColorBGR24bit) << "Fail: Frame::getFrameType()";
+
+    int numOfBytes = 0;
+    const unsigned char* yuy2Data = std::as_const(frame).getFrameDataPtr(numOfBytes);
+    ASSERT_EQ(numOfBytes, width * height * 2) << "Fail: Raw YUY2 frame size";
+
+    std::vector<unsigned char> expectedYUY2Data(width * height * 2);
+    int expectedNumOfBytes = 0;
+    DirectShowCamera::DirectShowCameraStubDefaultSetting::getYUY2Frame(expectedYUY2Data.data(), expectedNumOfBytes, frame.getFrameIndex(), width, height);
+    EXPECT_TRUE(std::equal(expectedYUY2Data.begin(), expectedYUY2Data.end(), yuy2Data)) << "Fail: Raw YUY2 frame data";
+
+    // Decode
+    DirectShowCamera::Frame rgbFrame;
+    DirectShowCamera::DirectShowCameraStubDefaultSetting::getFrame(rgbFrame, frame.getFrameIndex(), width, height);
+    int rgbNumOfBytes = 0;
+    const auto expectedData = rgbFrame.getFrameData(rgbNumOfBytes);
+    const auto data = frame.getFrameData(numOfBytes);
+    ASSERT_EQ(numOfBytes, rgbNumOfBytes) << "Fail: Frame::getFrameData() size";
+
+    // Skip the pixel pairs in 2 colors. They share the chroma.
+    int maxError = 0;
+    for (int i = 0; i < width * height; i += 2)
+    {
+        const unsigned char* pair = expectedData.get() + i * 3;
+        if (!std::equal(pair, pair + 3, pair + 3)) continue;
+        for (int j = 0; j < 6; j++)
+        {
+            maxError = std::max(maxError, std::abs(data[i * 3 + j] - pair[j]));
+        }
+    }
+    EXPECT_LE(maxError, 3) << "Fail: Decoded YUY2 frame";
+
+    // Close
+    EXPECT_TRUE(camera.Close()) << "Fail: camera.close()";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> stub_capture08
+ * <b>Title:</b> Test raw MJPEG capture
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Capture the compressed MJPEG frames and decode them by FrameDecoder
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Enable the raw MJPEG capture, open UVCCamera in the MJPG video format and start capture
+ *   2. getFrame()
+ *   3. Get the decoded frame data and the gray frame data
+ *   4. Close
+ * <b>Expected Result:</b>
+ *   1. True
+ *   2. The frame buffer has 3 bytes per pixel and begins with the JPEG data. The frame type is BGR.
+ *   3. Close to the default RGB frame. The gray frame has 1 byte per pixel.
+ *   4. True
+ * </pre>
+ */
+TEST_F(TestUVCCameraStubF, TestRawMJPGCapture)
+{
+    const int width = 320;
+    const int height = 240;
+
+    // Open and start capture
+    camera.setRawMJPGCapture(true);
+    EXPECT_TRUE(camera.isRawMJPGCapture()) << "Fail: camera.isRawMJPGCapture()";
+    ASSERT_TRUE(camera.Open(width, height)) << "Fail: camera.open()";
+    ASSERT_TRUE(camera.StartCapture()) << "Fail: camera.startCapture()";
+
+    // Get frame
+    DirectShowCamera::Frame frame;
+    ASSERT_TRUE(camera.getFrame(frame)) << "Fail: camera.getFrame()";
+    EXPECT_EQ(frame.getFrameType(), DirectShowCamera::Frame::FrameType::ColorBGR24bit) << "Fail: Frame::getFrameType()";
+
+    int numOfBytes = 0;
+    const unsigned char* mjpgData = std::as_const(frame).getFrameDataPtr(numOfBytes);
+    ASSERT_EQ(numOfBytes, width * height * 3) << "Fail: Raw MJPEG frame size";
+
+    std::vector<unsigned char> expectedMJPGData(width * height * 3);
+    int expectedNumOfBytes = 0;
+    DirectShowCamera::DirectShowCameraStubDefaultSetting::getMJPGFrame(expectedMJPGData.data(), expectedNumOfBytes, frame.getFrameIndex(), width, height);
+    EXPECT_TRUE(std::equal(expectedMJPGData.begin(), expectedMJPGData.begin() + expectedNumOfBytes, mjpgData)) << "Fail: Raw MJPEG frame data";
+
+    // Decode
+    DirectShowCamera::Frame rgbFrame;
+    DirectShowCamera::DirectShowCameraStubDefaultSetting::getFrame(rgbFrame, frame.getFrameIndex(), width, height);
+    int rgbNumOfBytes = 0;
+    const auto expectedData = rgbFrame.getFrameData(rgbNumOfBytes);
+    const auto data = frame.getFrameData(numOfBytes);
+    ASSERT_EQ(numOfBytes, rgbNumOfBytes) << "Fail: Frame::getFrameData() size";
+
+    // The color boxes are blurred at the edges, compare the mean error
+    double sumOfError = 0;
+    for (int i = 0; i < numOfBytes; i++) sumOfError += std::abs(data[i] - expectedData[i]);
+    EXPECT_LT(sumOfError / numOfBytes, 3.0) << "Fail: Decoded MJPEG frame";
+
+    // Gray
+    const auto gray = frame.getGrayFrameData(numOfBytes);
+    EXPECT_EQ(numOfBytes, width * height) << "Fail: Frame::getGrayFrameData() with MJPEG";
+
+    // Close
+    EXPECT_TRUE(camera.Close()) << "Fail: camera.close()";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> stub_capture09
+ * <b>Title:</b> Test getFrame() into two Frames in triple buffer mode
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Get the newest frame into two Frames back to back after the first Frame has taken it by the exchange
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Open camera and start capture in the push frame mode at 10 fps
+ *   2. Wait for a new frame, then getFrame() into a Frame and getFrame() into another Frame. Repeat it 5 times.
+ *   3. getFrame() into the first Frame again
+ *   4. Close camera
+ * <b>Expected Result:</b>
+ *   1. True
+ *   2. True for both Frames. Same bytes as DirectShowCameraStubDefaultSetting. If both get the same frame, the second Frame shares the data of the first Frame and no copy is made.
+ *   3. True
+ *   4. True
+ * </pre>
+ */
+TEST_F(TestUVCCameraStubF, TestGetFrameIntoTwoFrames)
+{
+    const int numOfFrames = 5;
+
+    // Open and start capture
+    cameraStub->setPushFrameMode(true, 10);
+    std::vector<DirectShowCamera::CameraDevice> cameraDeivceList = camera.getCameras();
+    std::vector <std::pair<int, int>> resolutions = cameraDeivceList[0].getResolutions();
+    const int width = resolutions[0].first;
+    const int height = resolutions[0].second;
+    ASSERT_TRUE(camera.Open(cameraDeivceList[0], width, height)) << "Fail: camera.open()";
+    ASSERT_TRUE(camera.StartCapture()) << "Fail: camera.startCapture()";
+    ASSERT_EQ(camera.getFrameBufferMode(), DirectShowCamera::FrameBufferMode::TripleBuffer) << "Fail: Default frame buffer mode";
+
+    // Get frames
+    DirectShowCamera::Frame frame;
+    DirectShowCamera::Frame otherFrame;
+    for (int i = 0; i < numOfFrames; i++)
+    {
+        // Wait for the next frame pushed by the stub
+        ASSERT_TRUE(camera.waitForFrame(cameraStub->getLastFrameIndex(), std::chrono::steady_clock::now() + std::chrono::seconds(1))) << "Fail: camera.waitForFrame()";
+        const auto copies = camera.getFrameBufferStatistics().Copies;
+        ASSERT_TRUE(camera.getFrame(frame, false)) << "Fail: camera.getFrame() into the first Frame";
+        ASSERT_TRUE(camera.getFrame(otherFrame, false)) << "Fail: camera.getFrame() into the other Frame";
+
+        for (const auto* gotFrame : { &frame, &otherFrame })
+        {
+            DirectShowCamera::Frame expectedFrame;
+            DirectShowCamera::DirectShowCameraStubDefaultSetting::getFrame(expectedFrame, gotFrame->getFrameIndex(), width, height);
+            EXPECT_EQ(*gotFrame, expectedFrame) << "Fail: camera.getFrame()";
+        }
+
+        // The same frame is shared
+        if (otherFrame.getFrameIndex() == frame.getFrameIndex())
+        {
+            int numOfBytes = 0;
+            EXPECT_EQ(std::as_const(otherFrame).getFrameDataPtr(numOfBytes), std::as_const(frame).getFrameDataPtr(numOfBytes)) << "Fail: Frame data is not shared";
+            EXPECT_EQ(camera.getFrameBufferStatistics().Copies, copies) << "Fail: Frame is copied";
+        }
+    }
+
+    // Get the frame again
+    EXPECT_TRUE(camera.getFrame(frame, false)) << "Fail: camera.getFrame() into the first Frame again";
+
+    // Close
+    EXPECT_TRUE(camera.Close()) << "Fail: camera.close()";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> stub_thread01
+ * <b>Title:</b> Test CameraThread CPU time
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Push frames from the stub at 30 fps and compare the CPU time of CameraThread with a loop polling getFrame(frame, true).
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ *   The CPU time depends on the scheduler, so it is only compared with the polling loop.
+ * <b>Test Steps:</b>
+ *   1. Open camera in the push frame mode at 30 fps
+ *   2. Poll getFrame(frame, true) for 1s
+ *   3. Run CameraThread for 1s
+ *   4. Run CameraThread with 10 fps pacing for 1s
+ *   5. Close camera
+ * <b>Expected Result:</b>
+ *   1. True
+ *   2. The polling loop consumes about one core.
+ *   3. About 30 frames are processed. CameraThread wakes up about once per produced frame, i.e. it blocks between frames instead of polling.
+ *      It consumes less than half of the CPU time of the polling loop.
+ *   4. About 10 frames are processed.
+ *   5. True
+ * </pre>
+ */
+TEST_F(TestUVCCameraStubF, TestCameraThreadCPUTime)
+{
+    const auto duration = std::chrono::seconds(1);
+
+    // Open camera
+    cameraStub->setPushFrameMode(true, 30);
+    std::shared_ptr<DirectShowCamera::Camera> threadCamera = std::make_shared<DirectShowCamera::Camera>(stub);
+    std::vector<DirectShowCamera::CameraDevice> cameraDeivceList = threadCamera->getCameras();
+    std::vector <std::pair<int, int>> resolutions = cameraDeivceList[0].getResolutions();
+    ASSERT_TRUE(threadCamera->Open(cameraDeivceList[0], resolutions[0].first, resolutions[0].second)) << "Fail: camera.open()";
+    ASSERT_TRUE(threadCamera->StartCapture()) << "Fail: camera.startCapture()";
+
+    // Polling
+    DirectShowCamera::Frame frame;
+    double startCPUTime = getProcessCPUTime();
+    auto endTime = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < endTime)
+    {
+        threadCamera->getFrame(frame, true);
+    }
+    const double pollingCPUTime = getProcessCPUTime() - startCPUTime;
+
+    // Camera thread
+    std::atomic<int> numOfProcessedFrames = 0;
+    DirectShowCamera::CameraThread cameraThread(threadCamera);
+    cameraThread.setCapturedProcess([&numOfProcessedFrames](DirectShowCamera::Frame& frame) { numOfProcessedFrames++; });
+    startCPUTime = getProcessCPUTime();
+    const auto startProduced = threadCamera->getFrameBufferStatistics().Produced;
+    cameraThread.Start(false);
+    std::this_thread::sleep_for(duration);
+    ASSERT_TRUE(cameraThread.Stop(false, false)) << "Fail: CameraThread::Stop()";
+    const double threadCPUTime = getProcessCPUTime() - startCPUTime;
+    const auto numOfProducedFrames = threadCamera->getFrameBufferStatistics().Produced - startProduced;
+    const auto numOfWakeUps = cameraThread.getNumOfWakeUps();
+
+    EXPECT_GE(numOfProcessedFrames, 20) << "Fail: CameraThread misses frames";
+
+    // A frame wakes the thread up once, besides the first iteration and the wait interval of 100 ms if a frame is late
+    EXPECT_LE(numOfWakeUps, numOfProducedFrames + 10) << "Fail: CameraThread polls between frames";
+
+    // The polling loop keeps a core busy, the bound is loose to tolerate the stub thread and a busy scheduler
+    EXPECT_LT(threadCPUTime, pollingCPUTime / 2) << "Fail: CameraThread consumes as much CPU time as polling";
+
+    // Pacing
+    numOfProcessedFrames = 0;
+    cameraThread.setPacingFPS(10);
+    cameraThread.Start(false);
+    std::this_thread::sleep_for(duration);
+    ASSERT_TRUE(cameraThread.Stop(false, false)) << "Fail: CameraThread::Stop()";
+    EXPECT_GE(numOfProcessedFrames, 7) << "Fail: CameraThread pacing";
+    EXPECT_LE(numOfProcessedFrames, 12) << "Fail: CameraThread pacing";
+
+    // Close
+    EXPECT_TRUE(threadCamera->Close()) << "Fail: camera.close()";
+}
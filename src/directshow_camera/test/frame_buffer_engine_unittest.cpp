@@ -0,0 +1,568 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include <gtest/gtest.h>
+
+#include "buffer/frame_buffer_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * @brief Run a producer thread and a consumer thread on the FrameBufferEngine.
+     *        Each frame is filled with a single byte value so that a torn frame can be detected.
+     * @param[in] engine Frame buffer engine
+     * @param[in] frameSize Frame size in bytes
+     * @param[in] numOfFrames Number of frames to be produced
+     * @param[out] numOfTornFrames Number of frames which contain bytes from different frames
+     * @param[out] numOfOutOfOrderFrames Number of frames which are older than the previous read
+     */
+    void RunProducerConsumer(
+        DirectShowCamera::FrameBufferEngine& engine,
+        const int frameSize,
+        const int numOfFrames,
+        int& numOfTornFrames,
+        int& numOfOutOfOrderFrames
+    )
+    {
+        engine.setBufferSize(frameSize);
+        engine.ResetStatistics();
+
+        numOfTornFrames = 0;
+        numOfOutOfOrderFrames = 0;
+        std::atomic<bool> producerDone = false;
+
+        // Producer
+        std::thread producer(
+            [&engine, &producerDone, frameSize, numOfFrames]()
+            {
+                std::vector<unsigned char> source(frameSize);
+                for (int i = 0; i < numOfFrames; i++)
+                {
+                    memset(source.data(), i % 256, frameSize);
+                    engine.Write(source.data(), frameSize);
+                }
+                producerDone = true;
+            }
+        );
+
+        // Consumer
+        std::vector<unsigned char> frame(frameSize);
+        unsigned long lastFrameIndex = 0;
+        while (!producerDone)
+        {
+            int numOfBytes = 0;
+            unsigned long frameIndex = 0;
+            engine.Read(frame.data(), numOfBytes, frameIndex);
+
+            // Check tearing
+            for (int i = 1; i < numOfBytes; i++)
+            {
+                if (frame[i] != frame[0])
+                {
+                    numOfTornFrames++;
+                    break;
+                }
+            }
+
+            // Check order
+            if (frameIndex < lastFrameIndex) numOfOutOfOrderFrames++;
+            lastFrameIndex = frameIndex;
+        }
+
+        producer.join();
+    }
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_buffer01
+ * <b>Title:</b> Test FrameBufferEngine returns the newest frame
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Test the FrameBufferEngine in both modes without DirectShow
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Read a frame in the mutex mode before any frame is written
+ *   2. Write 3 frames
+ *   3. Read a frame
+ *   4. Read again without writing
+ * <b>Expected Result:</b>
+ *   1. A black frame is returned
+ *   2. True
+ *   3. The third frame and its frame index is returned
+ *   4. The third frame is returned again
+ * </pre>
+ */
+TEST(TestFrameBufferEngine, TestNewestFrame)
+{
+    for (const auto mode : { DirectShowCamera::FrameBufferMode::Mutex, DirectShowCamera::FrameBufferMode::TripleBuffer })
+    {
+        DirectShowCamera::FrameBufferEngine engine(mode);
+        engine.setBufferSize(16);
+
+        // The mutex buffer is black before the first frame
+        if (mode == DirectShowCamera::FrameBufferMode::Mutex)
+        {
+            std::vector<unsigned char> frame(16, 0xFF);
+            int numOfBytes = 0;
+            unsigned long frameIndex = 0;
+            EXPECT_TRUE(engine.Read(frame.data(), numOfBytes, frameIndex)) << "Fail: FrameBufferEngine::Read()";
+            EXPECT_EQ(frame, std::vector<unsigned char>(16, 0)) << "Fail: FrameBufferEngine::Read() before the first frame";
+        }
+
+        // Write 3 frames
+        std::vector<unsigned char> source(16);
+        for (int i = 1; i <= 3; i++)
+        {
+            memset(source.data(), i, source.size());
+            EXPECT_TRUE(engine.Write(source.data(), 16)) << "Fail: FrameBufferEngine::Write()";
+        }
+        const unsigned long lastFrameIndex = engine.getLastFrameIndex();
+
+        // Read
+        for (int i = 0; i < 2; i++)
+        {
+            std::vector<unsigned char> frame(16);
+            int numOfBytes = 0;
+            unsigned long frameIndex = 0;
+            EXPECT_TRUE(engine.Read(frame.data(), numOfBytes, frameIndex)) << "Fail: FrameBufferEngine::Read()";
+            EXPECT_EQ(numOfBytes, 16) << "Fail: FrameBufferEngine::Read()";
+            EXPECT_EQ(frameIndex, lastFrameIndex) << "Fail: FrameBufferEngine::Read()";
+            EXPECT_EQ(frame, source) << "Fail: FrameBufferEngine::Read()";
+        }
+
+        // Frame in a wrong size is rejected
+        EXPECT_FALSE(engine.Write(source.data(), 8)) << "Fail: FrameBufferEngine::Write()";
+    }
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_buffer02
+ * <b>Title:</b> Test FrameBufferEngine producer/consumer contention
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Run a producer and a consumer concurrently on a 4K RGB24 frame and check the contention of both modes.
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Run producer and consumer in mutex mode
+ *   2. Run producer and consumer in triple buffer mode
+ * <b>Expected Result:</b>
+ *   1. No torn or out of order frame
+ *   2. No torn or out of order frame. Producer and consumer contention are 0.
+ * </pre>
+ */
+TEST(TestFrameBufferEngine, TestContention)
+{
+    const int frameSize = 3840 * 2160 * 3;
+    const int numOfFrames = 60;
+
+    for (const auto mode : { DirectShowCamera::FrameBufferMode::Mutex, DirectShowCamera::FrameBufferMode::TripleBuffer })
+    {
+        DirectShowCamera::FrameBufferEngine engine(mode);
+
+        int numOfTornFrames = 0;
+        int numOfOutOfOrderFrames = 0;
+        RunProducerConsumer(engine, frameSize, numOfFrames, numOfTornFrames, numOfOutOfOrderFrames);
+        const auto statistics = engine.getStatistics();
+
+        // Check
+        EXPECT_EQ(statistics.Produced, numOfFrames) << "Fail: FrameBufferEngine::Write()";
+        EXPECT_EQ(numOfTornFrames, 0) << "Fail: FrameBufferEngine::Read() returns a torn frame";
+        EXPECT_EQ(numOfOutOfOrderFrames, 0) << "Fail: FrameBufferEngine::Read() returns an older frame";
+        if (mode == DirectShowCamera::FrameBufferMode::TripleBuffer)
+        {
+            EXPECT_EQ(statistics.ProducerContention, 0) << "Fail: Producer waits in triple buffer mode";
+            EXPECT_EQ(statistics.ConsumerContention, 0) << "Fail: Consumer waits in triple buffer mode";
+        }
+    }
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_buffer03
+ * <b>Title:</b> Test FrameBufferEngine ring buffer overflow policies
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Write a burst of frames into a ring buffer which is smaller than the burst and drain it.
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Write 10 frames into a 4-slot ring buffer in FrameOverflowPolicy::DropOldest and read until empty
+ *   2. Write 10 frames into a 4-slot ring buffer in FrameOverflowPolicy::DropNewest and read until empty
+ *   3. Write 10 frames into a 4-slot ring buffer in FrameOverflowPolicy::Block from a producer thread and read until all frames are received
+ * <b>Expected Result:</b>
+ *   1. The last 4 frames are returned in order. 6 frames are dropped.
+ *   2. The first 4 frames are returned in order. 6 frames are dropped.
+ *   3. All frames are returned in order. No frame is dropped.
+ * </pre>
+ */
+TEST(TestFrameBufferEngine, TestRingBuffer)
+{
+    const int frameSize = 16;
+    const int capacity = 4;
+    const int numOfFrames = 10;
+
+    for (const auto policy : { DirectShowCamera::FrameOverflowPolicy::DropOldest, DirectShowCamera::FrameOverflowPolicy::DropNewest })
+    {
+        DirectShowCamera::FrameBufferEngine engine(DirectShowCamera::FrameBufferMode::Ring);
+        engine.setBufferSize(frameSize);
+        engine.setRingBufferCapacity(capacity);
+        engine.setOverflowPolicy(policy);
+
+        // Write a burst
+        std::vector<unsigned char> source(frameSize);
+        for (int i = 1; i <= numOfFrames; i++)
+        {
+            memset(source.data(), i, frameSize);
+            const bool written = engine.Write(source.data(), frameSize);
+            if (policy == DirectShowCamera::FrameOverflowPolicy::DropNewest)
+            {
+                EXPECT_EQ(written, i <= capacity) << "Fail: FrameBufferEngine::Write()";
+            }
+        }
+        EXPECT_EQ(engine.getNumOfQueuedFrames(), capacity) << "Fail: FrameBufferEngine::getNumOfQueuedFrames()";
+
+        // Drain
+        std::vector<int> values;
+        std::vector<unsigned char> frame(frameSize);
+        int numOfBytes = 0;
+        unsigned long frameIndex = 0;
+        while (engine.Read(frame.data(), numOfBytes, frameIndex))
+        {
+            EXPECT_EQ(numOfBytes, frameSize) << "Fail: FrameBufferEngine::Read()";
+            values.push_back(frame[0]);
+        }
+
+        // Check
+        const int firstValue = policy == DirectShowCamera::FrameOverflowPolicy::DropOldest ? numOfFrames - capacity + 1 : 1;
+        ASSERT_EQ(values.size(), capacity) << "Fail: FrameBufferEngine::Read()";
+        for (int i = 0; i < capacity; i++)
+        {
+            EXPECT_EQ(values[i], firstValue + i) << "Fail: FrameBufferEngine::Read() returns frames out of order";
+        }
+
+        const auto statistics = engine.getStatistics();
+        EXPECT_EQ(statistics.Dropped, numOfFrames - capacity) << "Fail: FrameBufferStatistics::Dropped";
+        EXPECT_EQ(statistics.Consumed, capacity) << "Fail: FrameBufferStatistics::Consumed";
+    }
+
+    // Block
+    {
+        DirectShowCamera::FrameBufferEngine engine(DirectShowCamera::FrameBufferMode::Ring);
+        engine.setBufferSize(frameSize);
+        engine.setRingBufferCapacity(capacity);
+        engine.setOverflowPolicy(DirectShowCamera::FrameOverflowPolicy::Block);
+
+        // Producer
+        std::thread producer(
+            [&engine, frameSize, numOfFrames]()
+            {
+                std::vector<unsigned char> source(frameSize);
+                for (int i = 1; i <= numOfFrames; i++)
+                {
+                    memset(source.data(), i, frameSize);
+                    engine.Write(source.data(), frameSize);
+                }
+            }
+        );
+
+        // Slow consumer
+        std::vector<int> values;
+        std::vector<unsigned char> frame(frameSize);
+        const auto startTime = std::chrono::steady_clock::now();
+        while (values.size() < numOfFrames && std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+            int numOfBytes = 0;
+            unsigned long frameIndex = 0;
+            if (engine.Read(frame.data(), numOfBytes, frameIndex)) values.push_back(frame[0]);
+        }
+        producer.join();
+
+        // Check
+        ASSERT_EQ(values.size(), numOfFrames) << "Fail: FrameBufferEngine::Read()";
+        for (int i = 0; i < numOfFrames; i++)
+        {
+            EXPECT_EQ(values[i], i + 1) << "Fail: FrameBufferEngine::Read() returns frames out of order";
+        }
+        const auto statistics = engine.getStatistics();
+        EXPECT_EQ(statistics.Dropped, 0) << "Fail: FrameBufferStatistics::Dropped";
+        EXPECT_GT(statistics.ProducerContention, 0) << "Fail: Producer is not blocked";
+    }
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_buffer04
+ * <b>Title:</b> Test FrameBufferEngine lease mode
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Publish producer frames without copying and lease them. The producer frames are counted by the hold and release functions.
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Set 2 outstanding leases. Publish frame 1 and lease it.
+ *   2. Publish frame 2 and lease it.
+ *   3. Publish frame 3.
+ *   4. Release the lease of frame 1 and publish frame 3 again.
+ *   5. Release the lease of frame 2.
+ *   6. Read the newest frame by copying.
+ *   7. Reset the buffer mode.
+ * <b>Expected Result:</b>
+ *   1. The lease points to the producer memory of frame 1. 1 frame is held.
+ *   2. The lease points to frame 2. Frame 1 is kept by its lease. 2 frames are held.
+ *   3. Frame 3 is dropped because 2 frames are held.
+ *   4. Frame 1 is released and frame 3 is published. Frame 2 is kept by its lease. 2 frames are held.
+ *   5. Frame 2 is released. 1 frame is held.
+ *   6. Frame 3 is copied.
+ *   7. All frames are released.
+ * </pre>
+ */
+TEST(TestFrameBufferEngine, TestLease)
+{
+    const int frameSize = 16;
+
+    DirectShowCamera::FrameBufferEngine engine(DirectShowCamera::FrameBufferMode::Lease);
+    engine.setBufferSize(frameSize);
+    engine.setMaxOutstandingLeases(2);
+
+    // Producer frames
+    std::vector<std::vector<unsigned char>> frames;
+    for (int i = 1; i <= 3; i++) frames.push_back(std::vector<unsigned char>(frameSize, (unsigned char)i));
+    std::vector<int> numOfHolds(frames.size(), 0);
+    const auto writeLease = [&engine, &frames, &numOfHolds, frameSize](const int i)
+    {
+        return engine.WriteLease(
+            frames[i].data(),
+            frameSize,
+            [&numOfHolds, i]() { numOfHolds[i]++; },
+            [&numOfHolds, i]() { numOfHolds[i]--; }
+        );
+    };
+
+    // Frame 1
+    DirectShowCamera::FrameLease lease1;
+    ASSERT_TRUE(writeLease(0)) << "Fail: FrameBufferEngine::WriteLease()";
+    ASSERT_TRUE(engine.Lease(lease1)) << "Fail: FrameBufferEngine::Lease()";
+    EXPECT_EQ(lease1.getData(), frames[0].data()) << "Fail: FrameLease doesn't point to the producer frame";
+    EXPECT_EQ(lease1.getNumOfBytes(), frameSize) << "Fail: FrameLease::getNumOfBytes()";
+    EXPECT_EQ(lease1.getFrameIndex(), engine.getLastFrameIndex()) << "Fail: FrameLease::getFrameIndex()";
+    EXPECT_EQ(engine.getNumOfOutstandingLeases(), 1) << "Fail: FrameBufferEngine::getNumOfOutstandingLeases()";
+
+    // Frame 2
+    DirectShowCamera::FrameLease lease2;
+    ASSERT_TRUE(writeLease(1)) << "Fail: FrameBufferEngine::WriteLease()";
+    ASSERT_TRUE(engine.Lease(lease2)) << "Fail: FrameBufferEngine::Lease()";
+    EXPECT_EQ(lease2.getData(), frames[1].data()) << "Fail: FrameLease doesn't point to the producer frame";
+    EXPECT_EQ(numOfHolds[0], 1) << "Fail: Leased frame is released";
+    EXPECT_EQ(engine.getNumOfOutstandingLeases(), 2) << "Fail: FrameBufferEngine::getNumOfOutstandingLeases()";
+
+    // Frame 3 is dropped
+    EXPECT_FALSE(writeLease(2)) << "Fail: Frame is not dropped when the lease cap is reached";
+    EXPECT_EQ(numOfHolds[2], 0) << "Fail: Dropped frame is held";
+    EXPECT_EQ(engine.getStatistics().Dropped, 1) << "Fail: FrameBufferStatistics::Dropped";
+
+    // Release frame 1
+    lease1.Release();
+    EXPECT_FALSE(lease1.isValid()) << "Fail: FrameLease::Release()";
+    EXPECT_EQ(numOfHolds[0], 0) << "Fail: Frame is not released by FrameLease::Release()";
+    ASSERT_TRUE(writeLease(2)) << "Fail: FrameBufferEngine::WriteLease()";
+    EXPECT_EQ(numOfHolds[1], 1) << "Fail: Leased frame is released";
+    EXPECT_EQ(engine.getNumOfOutstandingLeases(), 2) << "Fail: FrameBufferEngine::getNumOfOutstandingLeases()";
+
+    // Release frame 2 by moving an empty lease
+    lease2 = DirectShowCamera::FrameLease();
+    EXPECT_EQ(numOfHolds[1], 0) << "Fail: Frame is not released by FrameLease";
+    EXPECT_EQ(engine.getNumOfOutstandingLeases(), 1) << "Fail: FrameBufferEngine::getNumOfOutstandingLeases()";
+
+    // Read by copying
+    std::vector<unsigned char> frame(frameSize);
+    int numOfBytes = 0;
+    unsigned long frameIndex = 0;
+    ASSERT_TRUE(engine.Read(frame.data(), numOfBytes, frameIndex)) << "Fail: FrameBufferEngine::Read()";
+    EXPECT_EQ(frame, frames[2]) << "Fail: FrameBufferEngine::Read()";
+    EXPECT_EQ(engine.getStatistics().Leases, 2) << "Fail: FrameBufferStatistics::Leases";
+
+    // Reset
+    engine.setMode(DirectShowCamera::FrameBufferMode::Lease);
+    EXPECT_EQ(numOfHolds[2], 0) << "Fail: Frame is not released by FrameBufferEngine::setMode()";
+    EXPECT_EQ(engine.getNumOfOutstandingLeases(), 0) << "Fail: FrameBufferEngine::getNumOfOutstandingLeases()";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_buffer05
+ * <b>Title:</b> Test FrameBufferEngine capture timestamps
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Write frames with and without capture timestamps in every buffer mode and read them back.
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Write a frame with the device time and the arrival time and read it.
+ *   2. Write a frame without timestamps and read it.
+ * <b>Expected Result:</b>
+ *   1. Same timestamps are returned.
+ *   2. The device time is -1. The arrival time is stamped by the frame buffer in between the time before writing and after reading.
+ * </pre>
+ */
+TEST(TestFrameBufferEngine, TestTimestamp)
+{
+    const int frameSize = 16;
+
+    for (const auto mode : {
+        DirectShowCamera::FrameBufferMode::Mutex,
+        DirectShowCamera::FrameBufferMode::TripleBuffer,
+        DirectShowCamera::FrameBufferMode::Ring,
+        DirectShowCamera::FrameBufferMode::Lease
+    })
+    {
+        DirectShowCamera::FrameBufferEngine engine(mode);
+        engine.setBufferSize(frameSize);
+        std::vector<unsigned char> source(frameSize, 1);
+        std::vector<unsigned char> frame(frameSize);
+        int numOfBytes = 0;
+        unsigned long frameIndex = 0;
+
+        // Given timestamps
+        DirectShowCamera::FrameTimestamp timestamp;
+        timestamp.DeviceTime = 33333300;
+        timestamp.ArrivalTime = 123456789;
+        ASSERT_TRUE(engine.Write(source.data(), frameSize, timestamp)) << "Fail: FrameBufferEngine::Write()";
+        DirectShowCamera::FrameTimestamp readTimestamp;
+        ASSERT_TRUE(engine.Read(frame.data(), numOfBytes, frameIndex, &readTimestamp)) << "Fail: FrameBufferEngine::Read()";
+        EXPECT_EQ(readTimestamp, timestamp) << "Fail: FrameBufferEngine::Read() returns a wrong timestamp";
+
+        // Stamped by the frame buffer
+        const long long startTime = DirectShowCamera::FrameTimestamp::Now();
+        ASSERT_TRUE(engine.Write(source.data(), frameSize)) << "Fail: FrameBufferEngine::Write()";
+        ASSERT_TRUE(engine.Read(frame.data(), numOfBytes, frameIndex, &readTimestamp)) << "Fail: FrameBufferEngine::Read()";
+        const long long endTime = DirectShowCamera::FrameTimestamp::Now();
+        EXPECT_EQ(readTimestamp.DeviceTime, -1) << "Fail: FrameTimestamp::DeviceTime";
+        EXPECT_GE(readTimestamp.ArrivalTime, startTime) << "Fail: FrameTimestamp::ArrivalTime";
+        EXPECT_LE(readTimestamp.ArrivalTime, endTime) << "Fail: FrameTimestamp::ArrivalTime";
+    }
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_buffer06
+ * <b>Title:</b> Test FrameBufferEngine wait for frame
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Block a consumer in WaitForFrame() and publish frames from a producer thread.
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Wait for a frame newer than the last frame index while no frame is published.
+ *   2. Wait for a frame newer than an old frame index.
+ *   3. Publish a frame in a producer thread after the consumer starts waiting. Repeat it in every buffer mode.
+ * <b>Expected Result:</b>
+ *   1. It returns false after the deadline.
+ *   2. It returns true immediately.
+ *   3. It returns true long before the timeout and the frame is the next frame. The median wake-up latency from the frame arrival time is < 10 ms,
+ *      which a wait polling in steps of Camera::getNewFrame() (50 ms) or CameraThread (100 ms) can't meet.
+ * </pre>
+ */
+TEST(TestFrameBufferEngine, TestWaitForFrame)
+{
+    const int frameSize = 16;
+    const int numOfFrames = 21;
+    const auto timeout = std::chrono::milliseconds(1000);
+    const long long maxWakeUpLatency = 10000000;
+
+    for (const auto mode : {
+        DirectShowCamera::FrameBufferMode::Mutex,
+        DirectShowCamera::FrameBufferMode::TripleBuffer,
+        DirectShowCamera::FrameBufferMode::Ring,
+        DirectShowCamera::FrameBufferMode::Lease
+    })
+    {
+        DirectShowCamera::FrameBufferEngine engine(mode);
+        engine.setBufferSize(frameSize);
+        std::vector<unsigned char> source(frameSize, 1);
+        std::vector<unsigned char> frame(frameSize);
+        int numOfBytes = 0;
+        unsigned long frameIndex = 0;
+
+        // Timeout
+        const auto startTime = std::chrono::steady_clock::now();
+        EXPECT_FALSE(engine.WaitForFrame(engine.getLastFrameIndex(), startTime + std::chrono::milliseconds(20))) << "Fail: FrameBufferEngine::WaitForFrame() without a new frame";
+        EXPECT_GE(std::chrono::steady_clock::now() - startTime, std::chrono::milliseconds(20)) << "Fail: FrameBufferEngine::WaitForFrame() returns before the deadline";
+
+        // A new frame has been published
+        const unsigned long oldFrameIndex = engine.getLastFrameIndex();
+        ASSERT_TRUE(engine.Write(source.data(), frameSize)) << "Fail: FrameBufferEngine::Write()";
+        EXPECT_TRUE(engine.WaitForFrame(oldFrameIndex, std::chrono::steady_clock::now())) << "Fail: FrameBufferEngine::WaitForFrame() with a published frame";
+        ASSERT_TRUE(engine.Read(frame.data(), numOfBytes, frameIndex)) << "Fail: FrameBufferEngine::Read()";
+
+        // Wake up latency
+        std::vector<long long> latencies;
+        for (int i = 0; i < numOfFrames; i++)
+        {
+            const unsigned long lastFrameIndex = engine.getLastFrameIndex();
+            std::thread producer(
+                [&engine, &source, frameSize]()
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                    engine.Write(source.data(), frameSize);
+                }
+            );
+
+            const auto waitStartTime = std::chrono::steady_clock::now();
+            const bool hasNewFrame = engine.WaitForFrame(lastFrameIndex, waitStartTime + timeout);
+            const long long wakeUpTime = DirectShowCamera::FrameTimestamp::Now();
+            const auto waitTime = std::chrono::steady_clock::now() - waitStartTime;
+            producer.join();
+            ASSERT_TRUE(hasNewFrame) << "Fail: FrameBufferEngine::WaitForFrame() misses the frame";
+            EXPECT_LT(waitTime, timeout / 2) << "Fail: FrameBufferEngine::WaitForFrame() is not woken up by the frame";
+
+            DirectShowCamera::FrameTimestamp timestamp;
+            ASSERT_TRUE(engine.Read(frame.data(), numOfBytes, frameIndex, &timestamp)) << "Fail: FrameBufferEngine::Read()";
+            EXPECT_EQ(frameIndex, lastFrameIndex + 1) << "Fail: FrameBufferEngine::WaitForFrame() misses a frame";
+            latencies.push_back(wakeUpTime - timestamp.ArrivalTime);
+        }
+
+        // A blocking wait is woken up by the frame, a polling wait sleeps a step after the frame arrives. The median is robust to a preempted wake-up.
+        std::sort(latencies.begin(), latencies.end());
+        EXPECT_LT(latencies[numOfFrames / 2], maxWakeUpLatency) << "Fail: FrameBufferEngine::WaitForFrame() is not woken up by the frame in mode " << (int)mode;
+    }
+}
@@ -0,0 +1,3454 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include <gtest/gtest.h>
+
+#include "frame/frame_decoder.h"
+#include "frame/bayer_kernel.h"
+#include "frame/bit_depth_kernel.h"
+#include "frame/frame_destination.h"
+#include "frame/frame_subtype_registry.h"
+#include "frame/resize_kernel.h"
+#include "frame/statistics_kernel.h"
+#include "frame/rgb_kernel.h"
+#include "frame/swizzle_kernel.h"
+#include "frame/tensor_kernel.h"
+#include "frame/tone_map_kernel.h"
+#include "frame/yuv_kernel.h"
+#include "directshow_camera/stub/ds_camera_stub_jpeg_encoder.h"
+#include "directshow_camera/utils/ds_video_format_utils.h"
+#include "directshow_camera/video_format/ds_guid.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Decode a BGR frame to RGB pixel by pixel as a reference
+ * @param[in] inputData Input data which has been flipped vertically
+ * @param[in] width Width
+ * @param[in] height Height
+ * @param[in] verticalFlip Flip the image vertically
+ * @return Return the RGB image
+*/
+static std::vector<unsigned char> DecodeRGBReference(const std::vector<unsigned char>& inputData, const int width, const int height, const bool verticalFlip)
+{
+    std::vector<unsigned char> result(inputData.size());
+    for (int y = 0; y < height; y++)
+    {
+        const int inputY = verticalFlip ? y : height - y - 1;
+        for (int x = 0; x < width; x++)
+        {
+            const int inputIndex = (inputY * width + x) * 3;
+            const int outputIndex = (y * width + x) * 3;
+            result[outputIndex] = inputData[inputIndex + 2];
+            result[outputIndex + 1] = inputData[inputIndex + 1];
+            result[outputIndex + 2] = inputData[inputIndex];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Create a random image
+ * @param[in] numOfBytes Number of bytes
+ * @return Return the image
+*/
+static std::vector<unsigned char> CreateRandomImage(const int numOfBytes)
+{
+    std::mt19937 random(numOfBytes);
+    std::vector<unsigned char> result(numOfBytes);
+    for (auto& value : result) value = (unsigned char)random();
+    return result;
+}
+
+/**
+ * @brief Decode a packed YUV 4:2:2 frame pixel by pixel as a reference. It uses the fixed point coefficients of YUVKernel.
+ * @param[in] inputData Input data which is stored from the top
+ * @param[in] width Width
+ * @param[in] height Height
+ * @param[in] layout Byte order of the input
+ * @param[in] colorSpace Color matrix
+ * @param[in] outputFormat Output format
+ * @param[in] verticalFlip Flip the image vertically
+ * @param[in] horizontalMirror Mirror the image horizontally
+ * @return Return the image
+*/
+static std::vector<unsigned char> DecodeYUV422Reference(
+    const std::vector<unsigned char>& inputData,
+    const int width,
+    const int height,
+    const DirectShowCamera::YUV422Layout layout,
+    const DirectShowCamera::YUVColorSpace colorSpace,
+    const DirectShowCamera::YUVOutputFormat outputFormat,
+    const bool verticalFlip,
+    const bool horizontalMirror
+)
+{
+    using DirectShowCamera::YUVOutputFormat;
+
+    const bool isBT709 = colorSpace == DirectShowCamera::YUVColorSpace::BT709;
+    const int ub = isBT709 ? 135 : 129;
+    const int ug = isBT709 ? 14 : 25;
+    const int vg = isBT709 ? 34 : 52;
+    const int vr = isBT709 ? 115 : 102;
+    const bool isUYVY = layout == DirectShowCamera::YUV422Layout::UYVY;
+    const int bytesPerPixel = DirectShowCamera::YUVKernel::getBytesPerPixel(outputFormat);
+    const auto clamp = [](const int value) { return (unsigned char)std::clamp(value >> 6, 0, 255); };
+
+    std::vector<unsigned char> result(width * height * bytesPerPixel);
+    for (int y = 0; y < height; y++)
+    {
+        const int inputY = verticalFlip ? height - y - 1 : y;
+        for (int x = 0; x < width; x++)
+        {
+            const int inputX = horizontalMirror ? width - x - 1 : x;
+            const unsigned char* pair = inputData.data() + (inputY * width + inputX / 2 * 2) * 2;
+            const int luma = pair[(inputX % 2) * 2 + (isUYVY ? 1 : 0)];
+            const int u = pair[isUYVY ? 0 : 1] - 128;
+            const int v = pair[isUYVY ? 2 : 3] - 128;
+            const int yy = (luma - 16) * 75 + 32;
+            const unsigned char b = clamp(yy + ub * u);
+            const unsigned char g = clamp(yy - ug * u - vg * v);
+            const unsigned char r = clamp(yy + vr * v);
+
+            unsigned char* pixel = result.data() + (y * width + x) * bytesPerPixel;
+            if (outputFormat == YUVOutputFormat::Gray8)
+            {
+                pixel[0] = (unsigned char)luma;
+                continue;
+            }
+            const bool isRGB = outputFormat == YUVOutputFormat::RGB24 || outputFormat == YUVOutputFormat::RGBA32;
+            pixel[0] = isRGB ? r : b;
+            pixel[1] = g;
+            pixel[2] = isRGB ? b : r;
+            if (bytesPerPixel == 4) pixel[3] = 255;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Decode the planes of a YUV 4:2:0 image by the reference formula
+ * @param[in] planes Input planes
+ * @param[in] width Width
+ * @param[in] height Height
+ * @param[in] colorSpace Color matrix
+ * @param[in] outputFormat Output format
+ * @param[in] verticalFlip Flip the image vertically
+ * @param[in] horizontalMirror Mirror the image horizontally
+ * @return Return the image
+*/
+static std::vector<unsigned char> DecodeYUV420Reference(
+    const DirectShowCamera::YUV420Planes& planes,
+    const int width,
+    const int height,
+    const DirectShowCamera::YUVColorSpace colorSpace,
+    const DirectShowCamera::YUVOutputFormat outputFormat,
+    const bool verticalFlip,
+    const bool horizontalMirror
+)
+{
+    using DirectShowCamera::YUVOutputFormat;
+
+    const bool isBT709 = colorSpace == DirectShowCamera::YUVColorSpace::BT709;
+    const int ub = isBT709 ? 135 : 129;
+    const int ug = isBT709 ? 14 : 25;
+    const int vg = isBT709 ? 34 : 52;
+    const int vr = isBT709 ? 115 : 102;
+    const bool isNV12 = planes.Layout == DirectShowCamera::YUV420Layout::NV12;
+    const int bytesPerPixel = DirectShowCamera::YUVKernel::getBytesPerPixel(outputFormat);
+    const auto clamp = [](const int value) { return (unsigned char)std::clamp(value >> 6, 0, 255); };
+
+    std::vector<unsigned char> result(width * height * bytesPerPixel);
+    for (int y = 0; y < height; y++)
+    {
+        const int inputY = verticalFlip ? height - y - 1 : y;
+        for (int x = 0; x < width; x++)
+        {
+            const int inputX = horizontalMirror ? width - x - 1 : x;
+            const int luma = planes.Y[inputY * planes.YStride + inputX];
+            const unsigned char* chroma = planes.U + (inputY / 2) * planes.UVStride;
+            const int u = (isNV12 ? chroma[inputX / 2 * 2] : chroma[inputX / 2]) - 128;
+            const int v = (isNV12 ? chroma[inputX / 2 * 2 + 1] : planes.V[(inputY / 2) * planes.UVStride + inputX / 2]) - 128;
+            const int yy = (luma - 16) * 75 + 32;
+            const unsigned char b = clamp(yy + ub * u);
+            const unsigned char g = clamp(yy - ug * u - vg * v);
+            const unsigned char r = clamp(yy + vr * v);
+
+            unsigned char* pixel = result.data() + (y * width + x) * bytesPerPixel;
+            if (outputFormat == YUVOutputFormat::Gray8)
+            {
+                pixel[0] = (unsigned char)luma;
+                continue;
+            }
+            const bool isRGB = outputFormat == YUVOutputFormat::RGB24 || outputFormat == YUVOutputFormat::RGBA32;
+            pixel[0] = isRGB ? r : b;
+            pixel[1] = g;
+            pixel[2] = isRGB ? b : r;
+            if (bytesPerPixel == 4) pixel[3] = 255;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Create a smooth BGR image which is stored from the top
+ * @param[in] width Width
+ * @param[in] height Height
+ * @return Return the image
+*/
+static std::vector<unsigned char> CreateGradientImage(const int width, const int height)
+{
+    std::vector<unsigned char> result(width * height * 3);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            unsigned char* pixel = result.data() + (y * width + x) * 3;
+            pixel[0] = (unsigned char)(128 + 64 * std::sin(x * 0.05));
+            pixel[1] = (unsigned char)(128 + 64 * std::cos(y * 0.07));
+            pixel[2] = (unsigned char)(128 + 64 * std::sin((x + y) * 0.03));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Get the mean absolute difference of 2 images
+ * @param[in] image1 Image
+ * @param[in] image2 Image
+ * @param[in] numOfBytes Number of bytes
+ * @return Return the mean absolute difference
+*/
+static double MeanAbsoluteDifference(const unsigned char* image1, const unsigned char* image2, const int numOfBytes)
+{
+    double sum = 0;
+    for (int i = 0; i < numOfBytes; i++) sum += std::abs(image1[i] - image2[i]);
+    return numOfBytes > 0 ? sum / numOfBytes : 0;
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder01
+ * <b>Title:</b> Test FrameSubtypeRegistry lookup
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Look up the subtypes supported by FrameDecoder in FrameSubtypeRegistry
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Find the Windows SDK subtypes of each family
+ *   2. Find unsupported subtypes
+ *   3. Get FrameDecoder::SupportVideoType()
+ * <b>Expected Result:</b>
+ *   1. The traits are found with the correct family and bytes per pixel
+ *   2. nullptr, FrameDecoder::isSupportedVideoType() returns false and FrameDecoder::CheckSupportVideoType() throws
+ *   3. Same as the registered subtypes
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestSubtypeRegistry)
+{
+    using DirectShowCamera::FrameSubtypeFamily;
+    using DirectShowCamera::FrameSubtypeRegistry;
+
+    // Supported subtypes
+    const std::vector<std::pair<GUID, FrameSubtypeFamily>> subtypes = {
+        { MEDIASUBTYPE_Y800, FrameSubtypeFamily::Monochrome8bit },
+        { MEDIASUBTYPE_Y8, FrameSubtypeFamily::Monochrome8bit },
+        { MEDIASUBTYPE_GREY, FrameSubtypeFamily::Monochrome8bit },
+        { MEDIASUBTYPE_Y16, FrameSubtypeFamily::Monochrome16bit },
+        { MEDIASUBTYPE_Y10, FrameSubtypeFamily::Monochrome16bit },
+        { MEDIASUBTYPE_Y12, FrameSubtypeFamily::Monochrome16bit },
+        { MEDIASUBTYPE_Y10P, FrameSubtypeFamily::Monochrome16bit },
+        { MEDIASUBTYPE_Y12P, FrameSubtypeFamily::Monochrome16bit },
+        { MEDIASUBTYPE_RGB8, FrameSubtypeFamily::RGB },
+        { MEDIASUBTYPE_RGB565, FrameSubtypeFamily::RGB },
+        { MEDIASUBTYPE_RGB555, FrameSubtypeFamily::RGB },
+        { MEDIASUBTYPE_RGB24, FrameSubtypeFamily::RGB },
+        { MEDIASUBTYPE_YUY2, FrameSubtypeFamily::YUV422 },
+        { MEDIASUBTYPE_UYVY, FrameSubtypeFamily::YUV422 },
+        { MEDIASUBTYPE_NV12, FrameSubtypeFamily::YUV420 },
+        { MEDIASUBTYPE_I420, FrameSubtypeFamily::YUV420 },
+        { MEDIASUBTYPE_IYUV, FrameSubtypeFamily::YUV420 },
+        { MEDIASUBTYPE_MJPG, FrameSubtypeFamily::MJPEG },
+        { MEDIASUBTYPE_RGGB, FrameSubtypeFamily::Bayer },
+        { MEDIASUBTYPE_BA81, FrameSubtypeFamily::Bayer },
+        { MEDIASUBTYPE_GRBG, FrameSubtypeFamily::Bayer },
+        { MEDIASUBTYPE_GBRG, FrameSubtypeFamily::Bayer },
+        { MEDIASUBTYPE_RG16, FrameSubtypeFamily::Bayer },
+        { MEDIASUBTYPE_BYR2, FrameSubtypeFamily::Bayer },
+        { MEDIASUBTYPE_GR16, FrameSubtypeFamily::Bayer },
+        { MEDIASUBTYPE_GB16, FrameSubtypeFamily::Bayer }
+    };
+    for (const auto& [subtype, family] : subtypes)
+    {
+        const auto traits = FrameSubtypeRegistry::Find(subtype);
+        ASSERT_NE(traits, nullptr) << "Fail: FrameSubtypeRegistry::Find()";
+        EXPECT_EQ(traits->Subtype, subtype) << "Fail: FrameSubtypeTraits::Subtype";
+        EXPECT_EQ(traits->Family, family) << "Fail: FrameSubtypeTraits::Family";
+        EXPECT_EQ(traits->DecodedBytesPerPixel, family == FrameSubtypeFamily::Monochrome8bit ? 1 : family == FrameSubtypeFamily::Monochrome16bit ? 2 : 3) << "Fail: FrameSubtypeTraits::DecodedBytesPerPixel";
+        EXPECT_NE(traits->Decode, nullptr) << "Fail: FrameSubtypeTraits::Decode";
+        EXPECT_EQ(FrameSubtypeRegistry::Find(subtype, family), traits) << "Fail: FrameSubtypeRegistry::Find() with family";
+        EXPECT_TRUE(DirectShowCamera::FrameDecoder::isSupportedVideoType(subtype)) << "Fail: FrameDecoder::isSupportedVideoType()";
+    }
+    EXPECT_EQ(FrameSubtypeRegistry::Find(MEDIASUBTYPE_Y16, FrameSubtypeFamily::Monochrome8bit), nullptr) << "Fail: FrameSubtypeRegistry::Find() in another family";
+    EXPECT_TRUE(DirectShowCamera::FrameDecoder::is16BitMonochromeFrameType(MEDIASUBTYPE_Y16)) << "Fail: FrameDecoder::is16BitMonochromeFrameType()";
+    EXPECT_FALSE(DirectShowCamera::FrameDecoder::isRGBFrameType(MEDIASUBTYPE_Y8)) << "Fail: FrameDecoder::isRGBFrameType()";
+    EXPECT_TRUE(DirectShowCamera::FrameDecoder::isYUVFrameType(MEDIASUBTYPE_UYVY)) << "Fail: FrameDecoder::isYUVFrameType()";
+    EXPECT_TRUE(DirectShowCamera::FrameDecoder::isYUVFrameType(MEDIASUBTYPE_NV12)) << "Fail: FrameDecoder::isYUVFrameType()";
+    EXPECT_FALSE(DirectShowCamera::FrameDecoder::isRGBFrameType(MEDIASUBTYPE_YUY2)) << "Fail: FrameDecoder::isRGBFrameType()";
+    EXPECT_TRUE(DirectShowCamera::FrameDecoder::isMJPGFrameType(MEDIASUBTYPE_MJPG)) << "Fail: FrameDecoder::isMJPGFrameType()";
+    EXPECT_FALSE(DirectShowCamera::FrameDecoder::isRGBFrameType(MEDIASUBTYPE_MJPG)) << "Fail: FrameDecoder::isRGBFrameType()";
+    EXPECT_TRUE(DirectShowCamera::FrameDecoder::isBayerFrameType(MEDIASUBTYPE_BYR2)) << "Fail: FrameDecoder::isBayerFrameType()";
+    EXPECT_FALSE(DirectShowCamera::FrameDecoder::isBayerFrameType(MEDIASUBTYPE_Y16)) << "Fail: FrameDecoder::isBayerFrameType()";
+
+    // Unsupported subtypes
+    for (const auto& subtype : { MEDIASUBTYPE_None, MEDIASUBTYPE_RGB32, MEDIASUBTYPE_Y411 })
+    {
+        EXPECT_EQ(FrameSubtypeRegistry::Find(subtype), nullptr) << "Fail: FrameSubtypeRegistry::Find() an unsupported subtype";
+        EXPECT_EQ(FrameSubtypeRegistry::getFamily(subtype), FrameSubtypeFamily::Unknown) << "Fail: FrameSubtypeRegistry::getFamily()";
+        EXPECT_FALSE(DirectShowCamera::FrameDecoder::isSupportedVideoType(subtype)) << "Fail: FrameDecoder::isSupportedVideoType()";
+        EXPECT_THROW(DirectShowCamera::FrameDecoder::CheckSupportVideoType(subtype), std::invalid_argument) << "Fail: FrameDecoder::CheckSupportVideoType()";
+    }
+
+    // Support video type
+    const auto supportVideoType = DirectShowCamera::FrameDecoder::SupportVideoType();
+    ASSERT_EQ(supportVideoType.size(), subtypes.size()) << "Fail: FrameDecoder::SupportVideoType()";
+    for (int i = 0; i < (int)subtypes.size(); i++)
+    {
+        EXPECT_EQ(supportVideoType[i], subtypes[i].first) << "Fail: FrameDecoder::SupportVideoType()";
+    }
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder02
+ * <b>Title:</b> Test BGR to RGB swizzle kernels
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Decode BGR frames to RGB by every SIMD level supported by the CPU
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Swap red and blue of 0 to 200 pixels by each SIMD level
+ *   2. Decode RGB frames in odd sizes by FrameDecoder::DecodeRGBFrame() with and without vertical flip
+ * <b>Expected Result:</b>
+ *   1. Same as the reference. Bytes after the output are not written.
+ *   2. Same as the reference
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestSwizzleKernel)
+{
+    using DirectShowCamera::SIMDLevel;
+
+    // Swizzle kernels
+    for (const auto simdLevel : { SIMDLevel::Scalar, SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+    {
+        for (int numOfPixels = 0; numOfPixels <= 200; numOfPixels++)
+        {
+            const auto input = CreateRandomImage(numOfPixels * 3);
+            const auto expected = DecodeRGBReference(input, numOfPixels, 1, true);
+
+            std::vector<unsigned char> output(numOfPixels * 3 + 32, 0xCD);
+            DirectShowCamera::SwizzleKernel::SwapRedBlue24(input.data(), output.data(), numOfPixels, simdLevel);
+
+            ASSERT_TRUE(std::equal(expected.begin(), expected.end(), output.begin()))
+                << "Fail: SwizzleKernel::SwapRedBlue24() in SIMD level " << (int)simdLevel << " with " << numOfPixels << " pixels";
+            ASSERT_TRUE(std::all_of(output.begin() + numOfPixels * 3, output.end(), [](const unsigned char value) { return value == 0xCD; }))
+                << "Fail: SwizzleKernel::SwapRedBlue24() writes out of bound in SIMD level " << (int)simdLevel;
+        }
+    }
+
+    // Decode RGB frame
+    for (const auto& [width, height] : std::vector<std::pair<int, int>>{ { 1, 1 }, { 7, 3 }, { 33, 5 }, { 641, 11 } })
+    {
+        const auto input = CreateRandomImage(width * height * 3);
+        for (const bool verticalFlip : { true, false })
+        {
+            const auto expected = DecodeRGBReference(input, width, height, verticalFlip);
+            std::vector<unsigned char> output(input.size());
+            DirectShowCamera::FrameDecoder::DecodeRGBFrame(input.data(), output.data(), MEDIASUBTYPE_RGB24, width, height, verticalFlip, true);
+            EXPECT_EQ(output, expected) << "Fail: FrameDecoder::DecodeRGBFrame() in " << width << "x" << height << " verticalFlip = " << verticalFlip;
+        }
+    }
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder03
+ * <b>Title:</b> Test BGR to RGB swizzle kernels in frame sizes
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Swap red and blue of a full frame by each SIMD level
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Swap red and blue of 640x480, 1280x720, 1920x1080 and 3840x2160 frames by each SIMD level supported by the CPU
+ * <b>Expected Result:</b>
+ *   1. All SIMD levels return the same output
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestSwizzleFrameSize)
+{
+    using DirectShowCamera::SIMDLevel;
+
+    for (const auto& [width, height] : std::vector<std::pair<int, int>>{ { 640, 480 }, { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } })
+    {
+        const int numOfPixels = width * height;
+        const auto input = CreateRandomImage(numOfPixels * 3);
+        std::vector<unsigned char> scalarOutput(input.size());
+        std::vector<unsigned char> output(input.size());
+
+        for (const auto simdLevel : { SIMDLevel::Scalar, SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+        {
+            if (simdLevel > DirectShowCamera::SwizzleKernel::getSIMDLevel()) continue;
+            auto& result = simdLevel == SIMDLevel::Scalar ? scalarOutput : output;
+            DirectShowCamera::SwizzleKernel::SwapRedBlue24(input.data(), result.data(), numOfPixels, simdLevel);
+
+            if (simdLevel != SIMDLevel::Scalar)
+            {
+                EXPECT_EQ(output, scalarOutput) << "Fail: SIMD level " << (int)simdLevel << " in " << width << "x" << height;
+            }
+        }
+    }
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder04
+ * <b>Title:</b> Test row kernels with vertical flip and horizontal mirror
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Decode 8bit monochrome, 16bit monochrome, BGR and RGB frames by FrameDecoder::DecodeFrame() in every combination of vertical flip and horizontal mirror
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Decode frames in odd sizes
+ * <b>Expected Result:</b>
+ *   1. Same as the pixel by pixel reference. Bytes after the output are not written.
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestRowKernel)
+{
+    struct DecodeCase
+    {
+        GUID VideoType;
+        int BytesPerPixel;
+        bool OutputRGB;
+    };
+
+    for (const auto& decodeCase : {
+        DecodeCase{ MEDIASUBTYPE_Y800, 1, false },
+        DecodeCase{ MEDIASUBTYPE_Y16, 2, false },
+        DecodeCase{ MEDIASUBTYPE_RGB24, 3, false },
+        DecodeCase{ MEDIASUBTYPE_RGB24, 3, true }
+    })
+    {
+        for (const auto& [width, height] : std::vector<std::pair<int, int>>{ { 1, 1 }, { 7, 3 }, { 33, 5 }, { 641, 11 } })
+        {
+            const int numOfBytes = width * height * decodeCase.BytesPerPixel;
+            const auto input = CreateRandomImage(numOfBytes);
+
+            for (const bool verticalFlip : { true, false })
+            {
+                for (const bool horizontalMirror : { true, false })
+                {
+                    // Reference
+                    std::vector<unsigned char> expected(numOfBytes);
+                    for (int y = 0; y < height; y++)
+                    {
+                        const int inputY = verticalFlip ? y : height - y - 1;
+                        for (int x = 0; x < width; x++)
+                        {
+                            const int inputX = horizontalMirror ? width - x - 1 : x;
+                            for (int i = 0; i < decodeCase.BytesPerPixel; i++)
+                            {
+                                const int inputI = decodeCase.OutputRGB ? 2 - i : i;
+                                expected[(y * width + x) * decodeCase.BytesPerPixel + i] = input[(inputY * width + inputX) * decodeCase.BytesPerPixel + inputI];
+                            }
+                        }
+                    }
+
+                    // Decode
+                    std::vector<unsigned char> output(numOfBytes + 32, 0xCD);
+                    DirectShowCamera::FrameDecoder::DecodeFrame(
+                        input.data(),
+                        output.data(),
+                        decodeCase.VideoType,
+                        width,
+                        height,
+                        verticalFlip,
+                        decodeCase.OutputRGB,
+                        horizontalMirror
+                    );
+
+                    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), output.begin()))
+                        << "Fail: FrameDecoder::DecodeFrame() in " << decodeCase.BytesPerPixel << " bytes per pixel, " << width << "x" << height
+                        << ", outputRGB = " << decodeCase.OutputRGB << ", verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror;
+                    EXPECT_TRUE(std::all_of(output.begin() + numOfBytes, output.end(), [](const unsigned char value) { return value == 0xCD; }))
+                        << "Fail: FrameDecoder::DecodeFrame() writes out of bound";
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder05
+ * <b>Title:</b> Test parallel decode
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Decode a 3840x2160 BGR frame to RGB in different number of threads
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Set the minimum frame size to 1920 x 1080 and the number of threads to 4
+ *   2. Decode a 3840x2160 frame in 1, 2, 4 and 8 threads, with and without vertical flip
+ *   3. Reset the number of threads to 1
+ * <b>Expected Result:</b>
+ *   1. 3840x2160 is decoded in parallel. 1280x720 is not.
+ *   2. Same as the output of 1 thread
+ *   3. 3840x2160 is not decoded in parallel
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestParallelDecode)
+{
+    const int width = 3840;
+    const int height = 2160;
+    const auto input = CreateRandomImage(width * height * 3);
+
+    // Minimum frame size
+    DirectShowCamera::FrameDecoder::setParallelDecodeMinFrameSize(1920 * 1080);
+    DirectShowCamera::FrameDecoder::setNumOfDecodeThreads(4);
+    EXPECT_EQ(DirectShowCamera::FrameDecoder::getNumOfDecodeThreads(), 4) << "Fail: FrameDecoder::getNumOfDecodeThreads()";
+    EXPECT_TRUE(DirectShowCamera::FrameDecoder::isParallelDecode(width, height)) << "Fail: FrameDecoder::isParallelDecode()";
+    EXPECT_FALSE(DirectShowCamera::FrameDecoder::isParallelDecode(1280, 720)) << "Fail: FrameDecoder::isParallelDecode() below the minimum frame size";
+
+    // Decode
+    for (const bool verticalFlip : { true, false })
+    {
+        std::vector<unsigned char> serialOutput(input.size());
+        std::vector<unsigned char> output(input.size());
+
+        for (const int numOfThreads : { 1, 2, 4, 8 })
+        {
+            DirectShowCamera::FrameDecoder::setNumOfDecodeThreads(numOfThreads);
+            auto& result = numOfThreads == 1 ? serialOutput : output;
+            DirectShowCamera::FrameDecoder::DecodeFrame(input.data(), result.data(), MEDIASUBTYPE_RGB24, width, height, verticalFlip, true);
+
+            if (numOfThreads != 1)
+            {
+                EXPECT_EQ(output, serialOutput) << "Fail: Parallel decode in " << numOfThreads << " threads";
+            }
+        }
+    }
+
+    // Reset
+    DirectShowCamera::FrameDecoder::setNumOfDecodeThreads(1);
+    EXPECT_FALSE(DirectShowCamera::FrameDecoder::isParallelDecode(width, height)) << "Fail: FrameDecoder::setNumOfDecodeThreads(1)";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder06
+ * <b>Title:</b> Test YUV 4:2:2 decode
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Decode YUY2 and UYVY frames into BGR, RGB, BGRA, RGBA and gray in BT.601 and BT.709 by every SIMD level supported by the CPU
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Convert 0 to 200 pixels by each SIMD level
+ *   2. Convert every Y, U and V value and compare with the floating point conversion
+ *   3. Decode frames by FrameDecoder::DecodeYUVFrame() in every combination of vertical flip and horizontal mirror
+ *   4. Decode a frame by FrameDecoder::DecodeFrame() with FrameSettings
+ *   5. Decode a frame in odd width
+ * <b>Expected Result:</b>
+ *   1. Same as the reference. Bytes after the output are not written.
+ *   2. The difference is <= 3
+ *   3. Same as the reference
+ *   4. Same as FrameDecoder::DecodeYUVFrame() in the color space and the channel order of the FrameSettings
+ *   5. Throw std::invalid_argument
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestYUVDecode)
+{
+    using DirectShowCamera::SIMDLevel;
+    using DirectShowCamera::YUV422Layout;
+    using DirectShowCamera::YUVColorSpace;
+    using DirectShowCamera::YUVOutputFormat;
+    using DirectShowCamera::YUVKernel;
+
+    const auto layouts = { YUV422Layout::YUYV, YUV422Layout::UYVY };
+    const auto colorSpaces = { YUVColorSpace::BT601, YUVColorSpace::BT709 };
+    const auto outputFormats = { YUVOutputFormat::BGR24, YUVOutputFormat::RGB24, YUVOutputFormat::BGRA32, YUVOutputFormat::RGBA32, YUVOutputFormat::Gray8 };
+
+    // YUV kernels
+    for (const auto simdLevel : { SIMDLevel::Scalar, SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+    {
+        for (const auto layout : layouts)
+        {
+            for (const auto colorSpace : colorSpaces)
+            {
+                for (const auto outputFormat : outputFormats)
+                {
+                    const int bytesPerPixel = YUVKernel::getBytesPerPixel(outputFormat);
+                    for (int numOfPixels = 0; numOfPixels <= 200; numOfPixels += 2)
+                    {
+                        const auto input = CreateRandomImage(numOfPixels * 2);
+                        const auto expected = DecodeYUV422Reference(input, numOfPixels, 1, layout, colorSpace, outputFormat, false, false);
+
+                        std::vector<unsigned char> output(numOfPixels * bytesPerPixel + 64, 0xCD);
+                        YUVKernel::YUV422ToPixels(input.data(), output.data(), numOfPixels, layout, colorSpace, outputFormat, simdLevel);
+
+                        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), output.begin()))
+                            << "Fail: YUVKernel::YUV422ToPixels() in SIMD level " << (int)simdLevel << ", layout " << (int)layout << ", color space " << (int)colorSpace
+                            << ", output format " << (int)outputFormat << " with " << numOfPixels << " pixels";
+                        ASSERT_TRUE(std::all_of(output.begin() + numOfPixels * bytesPerPixel, output.end(), [](const unsigned char value) { return value == 0xCD; }))
+                            << "Fail: YUVKernel::YUV422ToPixels() writes out of bound in SIMD level " << (int)simdLevel;
+                    }
+                }
+            }
+        }
+    }
+
+    // Accuracy
+    for (const auto colorSpace : colorSpaces)
+    {
+        const bool isBT709 = colorSpace == YUVColorSpace::BT709;
+        const double kr = isBT709 ? 0.2126 : 0.299;
+        const double kb = isBT709 ? 0.0722 : 0.114;
+        int maxError = 0;
+        for (int u = 16; u <= 240; u++)
+        {
+            for (int v = 16; v <= 240; v++)
+            {
+                // Y 16 to 235 in a row
+                std::vector<unsigned char> input(220 * 2);
+                for (int i = 0; i < 220; i++)
+                {
+                    input[i * 2] = (unsigned char)(16 + i);
+                    input[i * 2 + 1] = (unsigned char)(i % 2 == 0 ? u : v);
+                }
+                std::vector<unsigned char> output(220 * 3);
+                YUVKernel::YUV422ToPixels(input.data(), output.data(), 220, YUV422Layout::YUYV, colorSpace, YUVOutputFormat::RGB24);
+
+                for (int i = 0; i < 220; i++)
+                {
+                    const double luma = (i * 255.0) / 219.0;
+                    const double pb = (u - 128) * 255.0 / 224.0;
+                    const double pr = (v - 128) * 255.0 / 224.0;
+                    const double r = luma + 2.0 * (1.0 - kr) * pr;
+                    const double b = luma + 2.0 * (1.0 - kb) * pb;
+                    const double g = (luma - kr * r - kb * b) / (1.0 - kr - kb);
+                    const double expected[3] = { r, g, b };
+                    for (int c = 0; c < 3; c++)
+                    {
+                        const int expectedValue = (int)std::lround(std::clamp(expected[c], 0.0, 255.0));
+                        maxError = std::max(maxError, std::abs(output[i * 3 + c] - expectedValue));
+                    }
+                }
+            }
+        }
+        EXPECT_LE(maxError, 3) << "Fail: YUVKernel::YUV422ToPixels() accuracy in color space " << (int)colorSpace;
+    }
+
+    // Decode YUV frame
+    for (const auto& [width, height] : std::vector<std::pair<int, int>>{ { 2, 1 }, { 8, 3 }, { 34, 5 }, { 642, 11 } })
+    {
+        const auto input = CreateRandomImage(width * height * 2);
+        for (const auto& [videoType, layout] : std::vector<std::pair<GUID, YUV422Layout>>{ { MEDIASUBTYPE_YUY2, YUV422Layout::YUYV }, { MEDIASUBTYPE_UYVY, YUV422Layout::UYVY } })
+        {
+            for (const auto outputFormat : outputFormats)
+            {
+                for (const bool verticalFlip : { true, false })
+                {
+                    for (const bool horizontalMirror : { true, false })
+                    {
+                        const auto expected = DecodeYUV422Reference(input, width, height, layout, YUVColorSpace::BT709, outputFormat, verticalFlip, horizontalMirror);
+                        const auto output = DirectShowCamera::FrameDecoder::DecodeYUVFrame(input.data(), videoType, width, height, outputFormat, YUVColorSpace::BT709, verticalFlip, horizontalMirror);
+                        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), output.get()))
+                            << "Fail: FrameDecoder::DecodeYUVFrame() in " << width << "x" << height << ", layout " << (int)layout << ", output format " << (int)outputFormat
+                            << ", verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror;
+                    }
+                }
+            }
+        }
+    }
+
+    // Decode frame with frame settings
+    {
+        const int width = 64;
+        const int height = 4;
+        const auto input = CreateRandomImage(width * height * 2);
+        DirectShowCamera::FrameSettings frameSettings;
+        frameSettings.BGR = false;
+        frameSettings.ColorSpace = YUVColorSpace::BT709;
+        std::vector<unsigned char> output(width * height * 3);
+        DirectShowCamera::FrameDecoder::DecodeFrame(input.data(), output.data(), MEDIASUBTYPE_UYVY, width, height, frameSettings);
+        const auto expected = DirectShowCamera::FrameDecoder::DecodeYUVFrame(input.data(), MEDIASUBTYPE_UYVY, width, height, YUVOutputFormat::RGB24, YUVColorSpace::BT709);
+        EXPECT_TRUE(std::equal(output.begin(), output.end(), expected.get())) << "Fail: FrameDecoder::DecodeFrame() with FrameSettings";
+    }
+
+    // Odd width
+    std::vector<unsigned char> oddFrame(3 * 2 * 2);
+    EXPECT_THROW(DirectShowCamera::FrameDecoder::DecodeYUVFrame(oddFrame.data(), MEDIASUBTYPE_YUY2, 3, 2), std::invalid_argument) << "Fail: FrameDecoder::DecodeYUVFrame() in odd width";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder07
+ * <b>Title:</b> Test luma extraction
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Extract the Y channel of YUY2, UYVY, NV12 and I420 frames by every SIMD level supported by the CPU
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Extract Y from 0 to 200 pixels by each SIMD level
+ *   2. Extract Y of frames by FrameDecoder::DecodeLumaFrame() in every combination of vertical flip and horizontal mirror
+ *   3. Extract Y of a RGB24 frame
+ * <b>Expected Result:</b>
+ *   1. Same as the Y bytes. Bytes after the output are not written.
+ *   2. Same as the Y bytes in the flipped and mirrored order. YUV 4:2:2 frames are the same as FrameDecoder::DecodeYUVFrame() in gray.
+ *   3. Throw std::invalid_argument
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestLumaDecode)
+{
+    using DirectShowCamera::SIMDLevel;
+    using DirectShowCamera::YUV422Layout;
+    using DirectShowCamera::YUVKernel;
+
+    // YUV 4:2:2 kernels
+    for (const auto simdLevel : { SIMDLevel::Scalar, SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+    {
+        for (const auto layout : { YUV422Layout::YUYV, YUV422Layout::UYVY })
+        {
+            const int offset = layout == YUV422Layout::UYVY ? 1 : 0;
+            for (int numOfPixels = 0; numOfPixels <= 200; numOfPixels++)
+            {
+                const auto input = CreateRandomImage(numOfPixels * 2);
+                std::vector<unsigned char> output(numOfPixels + 64, 0xCD);
+                YUVKernel::YUV422ToLuma(input.data(), output.data(), numOfPixels, layout, simdLevel);
+
+                bool isEqual = true;
+                for (int i = 0; i < numOfPixels; i++) isEqual &= output[i] == input[i * 2 + offset];
+                ASSERT_TRUE(isEqual) << "Fail: YUVKernel::YUV422ToLuma() in SIMD level " << (int)simdLevel << ", layout " << (int)layout << " with " << numOfPixels << " pixels";
+                ASSERT_TRUE(std::all_of(output.begin() + numOfPixels, output.end(), [](const unsigned char value) { return value == 0xCD; }))
+                    << "Fail: YUVKernel::YUV422ToLuma() writes out of bound in SIMD level " << (int)simdLevel;
+            }
+        }
+    }
+
+    // Decode luma frame
+    for (const auto& [width, height] : std::vector<std::pair<int, int>>{ { 2, 2 }, { 8, 4 }, { 34, 6 }, { 642, 10 } })
+    {
+        for (const auto& videoType : DirectShowCamera::FrameDecoder::SupportLumaVideoType())
+        {
+            const bool isYUV422 = DirectShowCamera::FrameSubtypeRegistry::getFamily(videoType) == DirectShowCamera::FrameSubtypeFamily::YUV422;
+            const int yStride = isYUV422 ? 2 : 1;
+            const int yOffset = videoType == MEDIASUBTYPE_UYVY ? 1 : 0;
+            const auto input = CreateRandomImage(isYUV422 ? width * height * 2 : width * height * 3 / 2);
+            for (const bool verticalFlip : { true, false })
+            {
+                for (const bool horizontalMirror : { true, false })
+                {
+                    const auto output = DirectShowCamera::FrameDecoder::DecodeLumaFrame(input.data(), videoType, width, height, verticalFlip, horizontalMirror);
+
+                    bool isEqual = true;
+                    for (int y = 0; y < height; y++)
+                    {
+                        const int inputY = verticalFlip ? height - y - 1 : y;
+                        for (int x = 0; x < width; x++)
+                        {
+                            const int inputX = horizontalMirror ? width - x - 1 : x;
+                            isEqual &= output[y * width + x] == input[(inputY * width + inputX) * yStride + yOffset];
+                        }
+                    }
+                    EXPECT_TRUE(isEqual) << "Fail: FrameDecoder::DecodeLumaFrame() in " << width << "x" << height << ", " << DirectShowVideoFormatUtils::ToString(videoType)
+                        << ", verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror;
+
+                    // Gray output of the YUV kernels
+                    {
+                        const auto gray = DirectShowCamera::FrameDecoder::DecodeYUVFrame(input.data(), videoType, width, height, DirectShowCamera::YUVOutputFormat::Gray8, DirectShowCamera::YUVColorSpace::BT601, verticalFlip, horizontalMirror);
+                        EXPECT_TRUE(std::equal(gray.get(), gray.get() + width * height, output.get())) << "Fail: FrameDecoder::DecodeYUVFrame() in gray";
+                    }
+                }
+            }
+        }
+    }
+
+    // Unsupported
+    std::vector<unsigned char> rgbFrame(4 * 2 * 3);
+    EXPECT_FALSE(DirectShowCamera::FrameDecoder::isLumaFrameType(MEDIASUBTYPE_RGB24)) << "Fail: FrameDecoder::isLumaFrameType()";
+    EXPECT_THROW(DirectShowCamera::FrameDecoder::DecodeLumaFrame(rgbFrame.data(), MEDIASUBTYPE_RGB24, 4, 2), std::invalid_argument) << "Fail: FrameDecoder::DecodeLumaFrame() with RGB24";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder08
+ * <b>Title:</b> Test MJPEG decode
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Decode the JPEG images encoded by the stub encoder in full and scaled sizes, in parallel and in corrupted data
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Encode gradient images in 4:4:4, 4:2:2 and 4:2:0 and decode them in BGR24, RGB24 and Gray8
+ *   2. Decode in every combination of vertical flip and horizontal mirror
+ *   3. Decode in 1/2, 1/4 and 1/8 scale
+ *   4. Decode a 1920x1080 image with restart markers in 1 and 4 threads
+ *   5. Decode the JPEG stored in a frame buffer by FrameDecoder::DecodeFrame()
+ *   6. Decode a truncated image, a progressive image, a non-JPEG data and a JPEG in a wrong size
+ * <b>Expected Result:</b>
+ *   1. Close to the source image
+ *   2. Same as the full decode in the flipped and mirrored order
+ *   3. The size is rounded up and the image is close to the box filtered full decode
+ *   4. Same as the output of 1 thread
+ *   5. Same as FrameDecoder::DecodeMJPGFrame()
+ *   6. The segments before the truncation are decoded. The others throw std::invalid_argument.
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestMJPGDecode)
+{
+    using DirectShowCamera::DirectShowCameraStubJPEGEncoder;
+    using DirectShowCamera::FrameDecoder;
+    using DirectShowCamera::JPEGDecoder;
+    using DirectShowCamera::JPEGScale;
+    using DirectShowCamera::YUVOutputFormat;
+
+    // Full decode
+    for (const auto& [width, height] : std::vector<std::pair<int, int>>{ { 16, 8 }, { 100, 60 }, { 320, 240 } })
+    {
+        const auto source = CreateGradientImage(width, height);
+        for (const auto& [horizontalSampling, verticalSampling] : std::vector<std::pair<int, int>>{ { 1, 1 }, { 2, 1 }, { 2, 2 } })
+        {
+            const auto jpeg = DirectShowCameraStubJPEGEncoder::Encode(source.data(), width, height, false, 95, 0, horizontalSampling, verticalSampling);
+            const int numOfBytes = (int)jpeg.size();
+
+            // BGR, RGB and gray
+            const auto bgr = FrameDecoder::DecodeMJPGFrame(jpeg.data(), numOfBytes, width, height);
+            EXPECT_LT(MeanAbsoluteDifference(bgr.get(), source.data(), width * height * 3), 3.0)
+                << "Fail: FrameDecoder::DecodeMJPGFrame() in " << width << "x" << height << ", sampling " << horizontalSampling << "x" << verticalSampling;
+
+            const auto rgb = FrameDecoder::DecodeMJPGFrame(jpeg.data(), numOfBytes, width, height, YUVOutputFormat::RGB24);
+            bool isEqual = true;
+            for (int i = 0; i < width * height; i++)
+            {
+                isEqual &= rgb[i * 3] == bgr[i * 3 + 2] && rgb[i * 3 + 1] == bgr[i * 3 + 1] && rgb[i * 3 + 2] == bgr[i * 3];
+            }
+            EXPECT_TRUE(isEqual) << "Fail: FrameDecoder::DecodeMJPGFrame() in RGB24";
+
+            const auto gray = FrameDecoder::DecodeMJPGFrame(jpeg.data(), numOfBytes, width, height, YUVOutputFormat::Gray8);
+            std::vector<unsigned char> sourceGray(width * height);
+            for (int i = 0; i < width * height; i++)
+            {
+                sourceGray[i] = (unsigned char)std::lround(0.114 * source[i * 3] + 0.587 * source[i * 3 + 1] + 0.299 * source[i * 3 + 2]);
+            }
+            EXPECT_LT(MeanAbsoluteDifference(gray.get(), sourceGray.data(), width * height), 2.0) << "Fail: FrameDecoder::DecodeMJPGFrame() in Gray8";
+
+            // Flip and mirror
+            for (const bool verticalFlip : { true, false })
+            {
+                for (const bool horizontalMirror : { true, false })
+                {
+                    const auto output = FrameDecoder::DecodeMJPGFrame(jpeg.data(), numOfBytes, width, height, YUVOutputFormat::BGR24, JPEGScale::Full, verticalFlip, horizontalMirror);
+
+                    isEqual = true;
+                    for (int y = 0; y < height; y++)
+                    {
+                        const int inputY = verticalFlip ? height - y - 1 : y;
+                        for (int x = 0; x < width; x++)
+                        {
+                            const int inputX = horizontalMirror ? width - x - 1 : x;
+                            isEqual &= std::equal(output.get() + (y * width + x) * 3, output.get() + (y * width + x) * 3 + 3, bgr.get() + (inputY * width + inputX) * 3);
+                        }
+                    }
+                    EXPECT_TRUE(isEqual) << "Fail: FrameDecoder::DecodeMJPGFrame() in verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror;
+                }
+            }
+
+            // Scaled decode
+            for (const auto scale : { JPEGScale::Half, JPEGScale::Quarter, JPEGScale::Eighth })
+            {
+                const int denominator = 1 << (int)scale;
+                const int scaledWidth = JPEGDecoder::getScaledSize(width, scale);
+                const int scaledHeight = JPEGDecoder::getScaledSize(height, scale);
+                EXPECT_EQ(scaledWidth, (width + denominator - 1) / denominator) << "Fail: JPEGDecoder::getScaledSize()";
+
+                const auto output = FrameDecoder::DecodeMJPGFrame(jpeg.data(), numOfBytes, width, height, YUVOutputFormat::BGR24, scale);
+
+                // Box filter of the full decode
+                std::vector<unsigned char> reference(scaledWidth * scaledHeight * 3);
+                for (int y = 0; y < scaledHeight; y++)
+                {
+                    for (int x = 0; x < scaledWidth; x++)
+                    {
+                        for (int c = 0; c < 3; c++)
+                        {
+                            int sum = 0;
+                            int count = 0;
+                            for (int j = y * denominator; j < std::min((y + 1) * denominator, height); j++)
+                            {
+                                for (int i = x * denominator; i < std::min((x + 1) * denominator, width); i++)
+                                {
+                                    sum += bgr[(j * width + i) * 3 + c];
+                                    count++;
+                                }
+                            }
+                            reference[(y * scaledWidth + x) * 3 + c] = (unsigned char)(sum / count);
+                        }
+                    }
+                }
+                // A subsampled chroma sample covers more than 1 pixel in 1/8 scale
+                EXPECT_LT(MeanAbsoluteDifference(output.get(), reference.data(), scaledWidth * scaledHeight * 3), scale == JPEGScale::Eighth ? 8.0 : 4.0)
+                    << "Fail: FrameDecoder::DecodeMJPGFrame() in scale 1/" << denominator << ", " << width << "x" << height;
+            }
+        }
+    }
+
+    // Parallel decode
+    {
+        const int width = 1920;
+        const int height = 1080;
+        const auto source = CreateGradientImage(width, height);
+        const auto jpeg = DirectShowCameraStubJPEGEncoder::Encode(source.data(), width, height, false, 90, width / 16);
+        const int numOfBytes = (int)jpeg.size();
+
+        const int minFrameSize = FrameDecoder::getParallelDecodeMinFrameSize();
+        FrameDecoder::setParallelDecodeMinFrameSize(0);
+        std::shared_ptr<unsigned char[]> serialOutput = nullptr;
+        for (const int numOfThreads : { 1, 4 })
+        {
+            FrameDecoder::setNumOfDecodeThreads(numOfThreads);
+            const auto output = FrameDecoder::DecodeMJPGFrame(jpeg.data(), numOfBytes, width, height);
+
+            if (numOfThreads == 1)
+            {
+                serialOutput = output;
+                EXPECT_LT(MeanAbsoluteDifference(output.get(), source.data(), width * height * 3), 3.0) << "Fail: FrameDecoder::DecodeMJPGFrame() with restart markers";
+            }
+            else
+            {
+                EXPECT_TRUE(std::equal(output.get(), output.get() + width * height * 3, serialOutput.get())) << "Fail: Parallel MJPEG decode in " << numOfThreads << " threads";
+            }
+        }
+        FrameDecoder::setNumOfDecodeThreads(1);
+        FrameDecoder::setParallelDecodeMinFrameSize(minFrameSize);
+    }
+
+    // Frame buffer
+    const int width = 64;
+    const int height = 48;
+    const auto source = CreateGradientImage(width, height);
+    const auto jpeg = DirectShowCameraStubJPEGEncoder::Encode(source.data(), width, height, false, 90, width / 16);
+    {
+        std::vector<unsigned char> frameBuffer(width * height * 3, 0);
+        std::copy(jpeg.begin(), jpeg.end(), frameBuffer.begin());
+        std::vector<unsigned char> output(width * height * 3);
+        FrameDecoder::DecodeFrame(frameBuffer.data(), output.data(), MEDIASUBTYPE_MJPG, width, height, false, true);
+        const auto reference = FrameDecoder::DecodeMJPGFrame(jpeg.data(), (int)jpeg.size(), width, height, YUVOutputFormat::RGB24);
+        EXPECT_TRUE(std::equal(output.begin(), output.end(), reference.get())) << "Fail: FrameDecoder::DecodeFrame() with MJPG";
+    }
+
+    // Truncated. The first MCU row is in the first segment.
+    {
+        const auto full = FrameDecoder::DecodeMJPGFrame(jpeg.data(), (int)jpeg.size(), width, height);
+        std::vector<unsigned char> output(width * height * 3);
+        EXPECT_NO_THROW(FrameDecoder::DecodeMJPGFrame(jpeg.data(), (int)jpeg.size() * 2 / 3, output.data(), width, height)) << "Fail: FrameDecoder::DecodeMJPGFrame() with truncated data";
+        EXPECT_TRUE(std::equal(output.begin(), output.begin() + width * 8 * 3, full.get())) << "Fail: FrameDecoder::DecodeMJPGFrame() with truncated data";
+    }
+
+    // Progressive
+    {
+        auto progressive = jpeg;
+        for (int i = 0; i + 1 < (int)progressive.size(); i++)
+        {
+            if (progressive[i] == 0xFF && progressive[i + 1] == 0xC0)
+            {
+                progressive[i + 1] = 0xC2;
+                break;
+            }
+        }
+        EXPECT_THROW(FrameDecoder::DecodeMJPGFrame(progressive.data(), (int)progressive.size(), width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeMJPGFrame() with progressive JPEG";
+    }
+
+    // Not a JPEG or wrong size
+    const auto randomData = CreateRandomImage(width * height * 3);
+    EXPECT_THROW(FrameDecoder::DecodeMJPGFrame(randomData.data(), (int)randomData.size(), width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeMJPGFrame() with random data";
+    EXPECT_THROW(FrameDecoder::DecodeMJPGFrame(jpeg.data(), (int)jpeg.size(), width * 2, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeMJPGFrame() in a wrong size";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder09
+ * <b>Title:</b> Test YUV 4:2:0 decode
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Decode NV12, I420 and IYUV frames into BGR, RGB, BGRA, RGBA and gray in BT.601 and BT.709 by every SIMD level supported by the CPU
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Convert 0 to 200 pixels by each SIMD level
+ *   2. Decode frames by FrameDecoder::DecodeYUVFrame() in every combination of vertical flip and horizontal mirror
+ *   3. Decode the planes in padded buffers by FrameDecoder::DecodeYUV420Frame(), in even and odd sizes
+ *   4. Decode a frame by FrameDecoder::DecodeFrame() with FrameSettings
+ *   5. Decode a frame in odd size, planes in a stride smaller than the width and a non YUV 4:2:0 type
+ * <b>Expected Result:</b>
+ *   1. Same as the reference. Bytes after the output are not written.
+ *   2. Same as the reference
+ *   3. Same as the reference
+ *   4. Same as FrameDecoder::DecodeYUVFrame() in the color space and the channel order of the FrameSettings
+ *   5. Throw std::invalid_argument
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestYUV420Decode)
+{
+    using DirectShowCamera::FrameDecoder;
+    using DirectShowCamera::SIMDLevel;
+    using DirectShowCamera::YUV420Layout;
+    using DirectShowCamera::YUV420Planes;
+    using DirectShowCamera::YUVColorSpace;
+    using DirectShowCamera::YUVOutputFormat;
+    using DirectShowCamera::YUVKernel;
+
+    const auto colorSpaces = { YUVColorSpace::BT601, YUVColorSpace::BT709 };
+    const auto outputFormats = { YUVOutputFormat::BGR24, YUVOutputFormat::RGB24, YUVOutputFormat::BGRA32, YUVOutputFormat::RGBA32, YUVOutputFormat::Gray8 };
+
+    // YUV kernels
+    for (const auto simdLevel : { SIMDLevel::Scalar, SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+    {
+        for (const auto layout : { YUV420Layout::NV12, YUV420Layout::I420 })
+        {
+            for (const auto colorSpace : colorSpaces)
+            {
+                for (const auto outputFormat : outputFormats)
+                {
+                    const int bytesPerPixel = YUVKernel::getBytesPerPixel(outputFormat);
+                    for (int numOfPixels = 0; numOfPixels <= 200; numOfPixels++)
+                    {
+                        // A row of Y, U and V. The chroma rows are in the exact size.
+                        const int chromaWidth = (numOfPixels + 1) / 2;
+                        const auto yRow = CreateRandomImage(numOfPixels);
+                        const auto uRow = CreateRandomImage(layout == YUV420Layout::NV12 ? chromaWidth * 2 : chromaWidth);
+                        const auto vRow = CreateRandomImage(chromaWidth);
+                        YUV420Planes planes;
+                        planes.Layout = layout;
+                        planes.Y = yRow.data();
+                        planes.U = uRow.data();
+                        planes.V = vRow.data();
+                        const auto expected = DecodeYUV420Reference(planes, numOfPixels, 1, colorSpace, outputFormat, false, false);
+
+                        std::vector<unsigned char> output(numOfPixels * bytesPerPixel + 64, 0xCD);
+                        YUVKernel::YUV420ToPixels(yRow.data(), uRow.data(), vRow.data(), output.data(), numOfPixels, layout, colorSpace, outputFormat, simdLevel);
+
+                        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), output.begin()))
+                            << "Fail: YUVKernel::YUV420ToPixels() in SIMD level " << (int)simdLevel << ", layout " << (int)layout << ", color space " << (int)colorSpace
+                            << ", output format " << (int)outputFormat << " with " << numOfPixels << " pixels";
+                        ASSERT_TRUE(std::all_of(output.begin() + numOfPixels * bytesPerPixel, output.end(), [](const unsigned char value) { return value == 0xCD; }))
+                            << "Fail: YUVKernel::YUV420ToPixels() writes out of bound in SIMD level " << (int)simdLevel;
+                    }
+                }
+            }
+        }
+    }
+
+    // Decode YUV frame
+    for (const auto& [width, height] : std::vector<std::pair<int, int>>{ { 2, 2 }, { 8, 4 }, { 34, 6 }, { 642, 10 } })
+    {
+        const auto input = CreateRandomImage(width * height * 3 / 2);
+        for (const auto& videoType : { MEDIASUBTYPE_NV12, MEDIASUBTYPE_I420, MEDIASUBTYPE_IYUV })
+        {
+            const auto planes = FrameDecoder::getYUV420Planes(input.data(), videoType, width, height);
+            EXPECT_EQ(planes.Layout, videoType == MEDIASUBTYPE_NV12 ? YUV420Layout::NV12 : YUV420Layout::I420) << "Fail: FrameDecoder::getYUV420Planes() layout";
+            for (const auto outputFormat : outputFormats)
+            {
+                for (const bool verticalFlip : { true, false })
+                {
+                    for (const bool horizontalMirror : { true, false })
+                    {
+                        const auto expected = DecodeYUV420Reference(planes, width, height, YUVColorSpace::BT709, outputFormat, verticalFlip, horizontalMirror);
+                        const auto output = FrameDecoder::DecodeYUVFrame(input.data(), videoType, width, height, outputFormat, YUVColorSpace::BT709, verticalFlip, horizontalMirror);
+                        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), output.get()))
+                            << "Fail: FrameDecoder::DecodeYUVFrame() in " << width << "x" << height << ", " << DirectShowVideoFormatUtils::ToString(videoType) << ", output format " << (int)outputFormat
+                            << ", verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror;
+                    }
+                }
+            }
+        }
+    }
+
+    // Padded planes
+    for (const auto& [width, height] : std::vector<std::pair<int, int>>{ { 34, 6 }, { 35, 7 } })
+    {
+        for (const auto layout : { YUV420Layout::NV12, YUV420Layout::I420 })
+        {
+            // Rows are padded to 64 bytes, the planes are in separate buffers
+            const int stride = 64;
+            const auto yPlane = CreateRandomImage(stride * height);
+            const auto uPlane = CreateRandomImage(stride * ((height + 1) / 2));
+            const auto vPlane = CreateRandomImage(stride * ((height + 1) / 2));
+            YUV420Planes planes;
+            planes.Layout = layout;
+            planes.Y = yPlane.data();
+            planes.YStride = stride;
+            planes.U = uPlane.data();
+            planes.V = layout == YUV420Layout::I420 ? vPlane.data() : nullptr;
+            planes.UVStride = stride;
+            for (const bool verticalFlip : { true, false })
+            {
+                for (const bool horizontalMirror : { true, false })
+                {
+                    const auto expected = DecodeYUV420Reference(planes, width, height, YUVColorSpace::BT601, YUVOutputFormat::BGR24, verticalFlip, horizontalMirror);
+                    const auto output = FrameDecoder::DecodeYUV420Frame(planes, width, height, YUVOutputFormat::BGR24, YUVColorSpace::BT601, verticalFlip, horizontalMirror);
+                    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), output.get()))
+                        << "Fail: FrameDecoder::DecodeYUV420Frame() in " << width << "x" << height << ", layout " << (int)layout
+                        << ", verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror;
+                }
+            }
+        }
+    }
+
+    // Decode frame with frame settings
+    {
+        const int width = 64;
+        const int height = 4;
+        const auto input = CreateRandomImage(width * height * 3 / 2);
+        DirectShowCamera::FrameSettings frameSettings;
+        frameSettings.BGR = false;
+        frameSettings.ColorSpace = YUVColorSpace::BT709;
+        for (const auto& videoType : { MEDIASUBTYPE_NV12, MEDIASUBTYPE_I420 })
+        {
+            std::vector<unsigned char> output(width * height * 3);
+            FrameDecoder::DecodeFrame(input.data(), output.data(), videoType, width, height, frameSettings);
+            const auto expected = FrameDecoder::DecodeYUVFrame(input.data(), videoType, width, height, YUVOutputFormat::RGB24, YUVColorSpace::BT709);
+            EXPECT_TRUE(std::equal(output.begin(), output.end(), expected.get())) << "Fail: FrameDecoder::DecodeFrame() with FrameSettings in " << DirectShowVideoFormatUtils::ToString(videoType);
+        }
+    }
+
+    // Invalid
+    std::vector<unsigned char> frame(8 * 8 * 3 / 2);
+    EXPECT_THROW(FrameDecoder::DecodeYUVFrame(frame.data(), MEDIASUBTYPE_NV12, 8, 3), std::invalid_argument) << "Fail: FrameDecoder::DecodeYUVFrame() in odd height";
+    EXPECT_THROW(FrameDecoder::getYUV420Planes(frame.data(), MEDIASUBTYPE_YUY2, 8, 8), std::invalid_argument) << "Fail: FrameDecoder::getYUV420Planes() with YUY2";
+    auto planes = FrameDecoder::getYUV420Planes(frame.data(), MEDIASUBTYPE_I420, 8, 8);
+    planes.UVStride = 2;
+    EXPECT_THROW(FrameDecoder::DecodeYUV420Frame(planes, 8, 8), std::invalid_argument) << "Fail: FrameDecoder::DecodeYUV420Frame() with a small stride";
+}
+
+/**
+ * @brief Expand 16-bit RGB pixels pixel by pixel as a reference
+ * @param[in] inputData Input data which has been flipped vertically
+ * @param[in] width Width
+ * @param[in] height Height
+ * @param[in] isRGB565 True for RGB565, false for RGB555
+ * @param[in] outputFormat Output format
+ * @param[in] verticalFlip Flip the image vertically
+ * @param[in] horizontalMirror Mirror the image horizontally
+ * @return Return the image
+*/
+static std::vector<unsigned char> DecodeRGB16Reference(
+    const std::vector<unsigned char>& inputData,
+    const int width,
+    const int height,
+    const bool isRGB565,
+    const DirectShowCamera::YUVOutputFormat outputFormat,
+    const bool verticalFlip,
+    const bool horizontalMirror
+)
+{
+    using DirectShowCamera::YUVOutputFormat;
+
+    const int bytesPerPixel = DirectShowCamera::YUVKernel::getBytesPerPixel(outputFormat);
+    const bool isRGB = outputFormat == YUVOutputFormat::RGB24 || outputFormat == YUVOutputFormat::RGBA32;
+    std::vector<unsigned char> result(width * height * bytesPerPixel);
+    for (int y = 0; y < height; y++)
+    {
+        const int inputY = verticalFlip ? y : height - y - 1;
+        for (int x = 0; x < width; x++)
+        {
+            const int inputX = horizontalMirror ? width - x - 1 : x;
+            const int inputIndex = (inputY * width + inputX) * 2;
+            const int pixel = inputData[inputIndex] | (inputData[inputIndex + 1] << 8);
+
+            // Scale the channels to 0 - 255 with rounding
+            const int b = ((pixel & 0x1F) * 255 + 15) / 31;
+            const int g = isRGB565 ? (((pixel >> 5) & 0x3F) * 255 + 31) / 63 : (((pixel >> 5) & 0x1F) * 255 + 15) / 31;
+            const int r = isRGB565 ? ((pixel >> 11) * 255 + 15) / 31 : (((pixel >> 10) & 0x1F) * 255 + 15) / 31;
+
+            unsigned char* output = result.data() + (y * width + x) * bytesPerPixel;
+            output[0] = (unsigned char)(isRGB ? r : b);
+            output[1] = (unsigned char)g;
+            output[2] = (unsigned char)(isRGB ? b : r);
+            if (bytesPerPixel == 4) output[3] = 255;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder10
+ * <b>Title:</b> Test RGB565, RGB555 and RGB8 unpack
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Expand 16-bit RGB pixels into BGR, RGB, BGRA and RGBA by every SIMD level supported by the CPU and look up 8 bit palette pixels
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ *   Replicating the high bits of a channel is within 1 of the rounded scaling to 0 - 255, and equal at both ends
+ * <b>Test Steps:</b>
+ *   1. Expand 0 to 200 pixels of each layout by each SIMD level
+ *   2. Expand every 16-bit value
+ *   3. Look up 0 to 40 pixels in a palette and in the gray levels in each output format
+ *   4. Decode RGB565, RGB555 and RGB8 frames by FrameDecoder::DecodeFrame() in every combination of vertical flip and horizontal mirror
+ *   5. Expand into gray
+ * <b>Expected Result:</b>
+ *   1. Same as the scalar kernel and within 1 of the reference. Bytes after the output are not written.
+ *   2. 0 and the maximum of a channel are expanded to 0 and 255
+ *   3. Same as the palette colors, or the luma in gray. Bytes after the output are not written.
+ *   4. Same as the kernels in the row order and the pixel order of the FrameSettings
+ *   5. Throw std::invalid_argument
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestRGBUnpack)
+{
+    using DirectShowCamera::FrameDecoder;
+    using DirectShowCamera::RGB16Layout;
+    using DirectShowCamera::RGBKernel;
+    using DirectShowCamera::RGBPalette;
+    using DirectShowCamera::SIMDLevel;
+    using DirectShowCamera::YUVKernel;
+    using DirectShowCamera::YUVOutputFormat;
+
+    const auto outputFormats = { YUVOutputFormat::BGR24, YUVOutputFormat::RGB24, YUVOutputFormat::BGRA32, YUVOutputFormat::RGBA32 };
+
+    // 16-bit RGB kernels
+    for (const auto layout : { RGB16Layout::RGB565, RGB16Layout::RGB555 })
+    {
+        for (const auto outputFormat : outputFormats)
+        {
+            const int bytesPerPixel = YUVKernel::getBytesPerPixel(outputFormat);
+            for (int numOfPixels = 0; numOfPixels <= 200; numOfPixels++)
+            {
+                const auto input = CreateRandomImage(numOfPixels * 2);
+                const auto reference = DecodeRGB16Reference(input, numOfPixels, 1, layout == RGB16Layout::RGB565, outputFormat, true, false);
+
+                std::vector<unsigned char> expected(numOfPixels * bytesPerPixel);
+                RGBKernel::RGB16ToPixels(input.data(), expected.data(), numOfPixels, layout, outputFormat, SIMDLevel::Scalar);
+                for (int i = 0; i < (int)expected.size(); i++)
+                {
+                    ASSERT_LE(std::abs(expected[i] - reference[i]), 1) << "Fail: RGBKernel::RGB16ToPixels() in layout " << (int)layout << ", output format " << (int)outputFormat;
+                }
+
+                for (const auto simdLevel : { SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+                {
+                    std::vector<unsigned char> output(numOfPixels * bytesPerPixel + 64, 0xCD);
+                    RGBKernel::RGB16ToPixels(input.data(), output.data(), numOfPixels, layout, outputFormat, simdLevel);
+                    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), output.begin()))
+                        << "Fail: RGBKernel::RGB16ToPixels() in SIMD level " << (int)simdLevel << ", layout " << (int)layout << ", output format " << (int)outputFormat
+                        << " with " << numOfPixels << " pixels";
+                    ASSERT_TRUE(std::all_of(output.begin() + numOfPixels * bytesPerPixel, output.end(), [](const unsigned char value) { return value == 0xCD; }))
+                        << "Fail: RGBKernel::RGB16ToPixels() writes out of bound in SIMD level " << (int)simdLevel;
+                }
+            }
+        }
+    }
+
+    // Every 16-bit value
+    {
+        std::vector<unsigned char> input(65536 * 2);
+        for (int i = 0; i < 65536; i++)
+        {
+            input[i * 2] = (unsigned char)(i & 0xFF);
+            input[i * 2 + 1] = (unsigned char)(i >> 8);
+        }
+        for (const auto layout : { RGB16Layout::RGB565, RGB16Layout::RGB555 })
+        {
+            std::vector<unsigned char> output(65536 * 3);
+            RGBKernel::RGB16ToPixels(input.data(), output.data(), 65536, layout, YUVOutputFormat::RGB24);
+            const auto reference = DecodeRGB16Reference(input, 65536, 1, layout == RGB16Layout::RGB565, YUVOutputFormat::RGB24, true, false);
+            for (int i = 0; i < (int)output.size(); i++)
+            {
+                ASSERT_LE(std::abs(output[i] - reference[i]), 1) << "Fail: RGBKernel::RGB16ToPixels() of value " << i / 3 << " in layout " << (int)layout;
+                if (reference[i] == 0 || reference[i] == 255)
+                {
+                    ASSERT_EQ(output[i], reference[i]) << "Fail: RGBKernel::RGB16ToPixels() at the end of the range";
+                }
+            }
+        }
+    }
+
+    // Palette lookup
+    RGBPalette palette;
+    {
+        const auto colors = CreateRandomImage((int)palette.size());
+        std::copy(colors.begin(), colors.end(), palette.begin());
+    }
+    for (const bool hasPalette : { true, false })
+    {
+        for (const auto outputFormat : { YUVOutputFormat::BGR24, YUVOutputFormat::RGB24, YUVOutputFormat::BGRA32, YUVOutputFormat::RGBA32, YUVOutputFormat::Gray8 })
+        {
+            const int bytesPerPixel = YUVKernel::getBytesPerPixel(outputFormat);
+            const auto table = RGBKernel::BuildPaletteTable(hasPalette ? &palette : nullptr, outputFormat);
+            for (int numOfPixels = 0; numOfPixels <= 40; numOfPixels++)
+            {
+                const auto input = CreateRandomImage(numOfPixels);
+                std::vector<unsigned char> output(numOfPixels * bytesPerPixel + 16, 0xCD);
+                RGBKernel::PaletteToPixels(input.data(), output.data(), numOfPixels, table);
+
+                for (int x = 0; x < numOfPixels; x++)
+                {
+                    const int b = hasPalette ? palette[input[x] * 4] : input[x];
+                    const int g = hasPalette ? palette[input[x] * 4 + 1] : input[x];
+                    const int r = hasPalette ? palette[input[x] * 4 + 2] : input[x];
+                    const unsigned char* pixel = output.data() + x * bytesPerPixel;
+                    switch (outputFormat)
+                    {
+                    case YUVOutputFormat::Gray8:
+                        ASSERT_LE(std::abs(pixel[0] - (int)std::lround(r * 0.299 + g * 0.587 + b * 0.114)), 1) << "Fail: RGBKernel::PaletteToPixels() in gray";
+                        break;
+                    case YUVOutputFormat::RGB24:
+                    case YUVOutputFormat::RGBA32:
+                        ASSERT_TRUE(pixel[0] == r && pixel[1] == g && pixel[2] == b) << "Fail: RGBKernel::PaletteToPixels() in output format " << (int)outputFormat;
+                        break;
+                    default:
+                        ASSERT_TRUE(pixel[0] == b && pixel[1] == g && pixel[2] == r) << "Fail: RGBKernel::PaletteToPixels() in output format " << (int)outputFormat;
+                        break;
+                    }
+                    if (bytesPerPixel == 4)
+                    {
+                        ASSERT_EQ(pixel[3], 255) << "Fail: RGBKernel::PaletteToPixels() alpha";
+                    }
+                }
+                ASSERT_TRUE(std::all_of(output.begin() + numOfPixels * bytesPerPixel, output.end(), [](const unsigned char value) { return value == 0xCD; }))
+                    << "Fail: RGBKernel::PaletteToPixels() writes out of bound in output format " << (int)outputFormat;
+            }
+        }
+    }
+
+    // Decode frame
+    for (const auto& [width, height] : std::vector<std::pair<int, int>>{ { 1, 1 }, { 7, 3 }, { 67, 5 } })
+    {
+        for (const bool verticalFlip : { true, false })
+        {
+            for (const bool horizontalMirror : { true, false })
+            {
+                for (const bool bgr : { true, false })
+                {
+                    DirectShowCamera::FrameSettings frameSettings;
+                    frameSettings.BGR = bgr;
+                    frameSettings.VerticalFlip = verticalFlip;
+                    frameSettings.HorizontalMirror = horizontalMirror;
+                    const auto outputFormat = bgr ? YUVOutputFormat::BGR24 : YUVOutputFormat::RGB24;
+
+                    // 16-bit RGB
+                    const auto input16 = CreateRandomImage(width * height * 2);
+                    for (const auto& [videoType, layout] : std::vector<std::pair<GUID, RGB16Layout>>{ { MEDIASUBTYPE_RGB565, RGB16Layout::RGB565 }, { MEDIASUBTYPE_RGB555, RGB16Layout::RGB555 } })
+                    {
+                        std::vector<unsigned char> output(width * height * 3);
+                        FrameDecoder::DecodeFrame(input16.data(), output.data(), videoType, width, height, frameSettings);
+
+                        // Expand the rows in the reference order
+                        std::vector<unsigned char> expected(width * height * 3);
+                        for (int y = 0; y < height; y++)
+                        {
+                            const int inputY = verticalFlip ? y : height - y - 1;
+                            RGBKernel::RGB16ToPixels(input16.data() + inputY * width * 2, expected.data() + y * width * 3, width, layout, outputFormat);
+                            if (horizontalMirror)
+                            {
+                                for (int x = 0; x < width / 2; x++)
+                                {
+                                    std::swap_ranges(expected.begin() + (y * width + x) * 3, expected.begin() + (y * width + x) * 3 + 3, expected.begin() + (y * width + width - x - 1) * 3);
+                                }
+                            }
+                        }
+                        EXPECT_EQ(output, expected) << "Fail: FrameDecoder::DecodeFrame() in " << width << "x" << height << ", " << DirectShowVideoFormatUtils::ToString(videoType)
+                            << ", verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror << ", BGR = " << bgr;
+                    }
+
+                    // RGB8 with and without palette
+                    const auto input8 = CreateRandomImage(width * height);
+                    for (const bool hasPalette : { true, false })
+                    {
+                        frameSettings.Palette = hasPalette ? std::make_shared<const RGBPalette>(palette) : nullptr;
+                        std::vector<unsigned char> output(width * height * 3);
+                        FrameDecoder::DecodeFrame(input8.data(), output.data(), MEDIASUBTYPE_RGB8, width, height, frameSettings);
+
+                        std::vector<unsigned char> expected(width * height * 3);
+                        for (int y = 0; y < height; y++)
+                        {
+                            const int inputY = verticalFlip ? y : height - y - 1;
+                            for (int x = 0; x < width; x++)
+                            {
+                                const int index = input8[inputY * width + (horizontalMirror ? width - x - 1 : x)];
+                                for (int c = 0; c < 3; c++)
+                                {
+                                    expected[(y * width + x) * 3 + c] = hasPalette ? palette[index * 4 + (bgr ? c : 2 - c)] : (unsigned char)index;
+                                }
+                            }
+                        }
+                        EXPECT_EQ(output, expected) << "Fail: FrameDecoder::DecodeFrame() in " << width << "x" << height << ", RGB8, hasPalette = " << hasPalette
+                            << ", verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror << ", BGR = " << bgr;
+                    }
+                }
+            }
+        }
+    }
+
+    // Invalid
+    std::vector<unsigned char> frame(16 * 3);
+    EXPECT_THROW(RGBKernel::RGB16ToPixels(frame.data(), frame.data() + 32, 16, RGB16Layout::RGB565, YUVOutputFormat::Gray8), std::invalid_argument) << "Fail: RGBKernel::RGB16ToPixels() into gray";
+}
+
+/**
+ * @brief Pack 16-bit samples as a reference
+ * @param[in] samples Samples in the low bits
+ * @param[in] layout Bit layout
+ * @return Return the packed data
+*/
+static std::vector<unsigned char> PackMonochromeReference(const std::vector<unsigned short>& samples, const DirectShowCamera::PackedMonochromeLayout layout)
+{
+    std::vector<unsigned char> result;
+    if (layout == DirectShowCamera::PackedMonochromeLayout::Y10P)
+    {
+        for (int x = 0; x < (int)samples.size(); x += 4)
+        {
+            unsigned char lowBits = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                result.push_back((unsigned char)(samples[x + i] >> 2));
+                lowBits |= (unsigned char)((samples[x + i] & 0x3) << (i * 2));
+            }
+            result.push_back(lowBits);
+        }
+    }
+    else
+    {
+        for (int x = 0; x < (int)samples.size(); x += 2)
+        {
+            result.push_back((unsigned char)(samples[x] >> 4));
+            result.push_back((unsigned char)(samples[x + 1] >> 4));
+            result.push_back((unsigned char)((samples[x] & 0xF) | ((samples[x + 1] & 0xF) << 4)));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder11
+ * <b>Title:</b> Test 10/12-bit monochrome unpack and bit depth normalization
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Unpack Y10P and Y12P pixels and normalize 16-bit samples by every SIMD level supported by the CPU, and decode Y16, Y10, Y12, Y10P and Y12P frames in the bit depth of FrameSettings
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Unpack 0 to 200 pixels of each layout by each SIMD level
+ *   2. Normalize 0 to 100 samples between the bit depths from 8 to 16, LSB- and MSB-justified, by each SIMD level
+ *   3. Decode frames with every combination of vertical flip and horizontal mirror, in the source bit depth and in 16 bits
+ *   4. Get the bit depth of the video types with FrameSettings
+ *   5. Unpack a number of pixels which is not a multiple of the packing group, decode a Y10P frame in a width of 6 and normalize to 17 bits
+ * <b>Expected Result:</b>
+ *   1. Same as the packed samples. Samples after the output are not written.
+ *   2. Same as the rounded scaling within 1, and exact at 0 and the maximum. Samples after the output are not written.
+ *   3. Same as unpacking and normalizing the rows in the order of the FrameSettings
+ *   4. The output bit depth, or the source bit depth if it is not set
+ *   5. Throw std::invalid_argument
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestBitDepthDecode)
+{
+    using DirectShowCamera::BitDepthConversion;
+    using DirectShowCamera::BitDepthKernel;
+    using DirectShowCamera::FrameDecoder;
+    using DirectShowCamera::PackedMonochromeLayout;
+    using DirectShowCamera::SIMDLevel;
+
+    std::mt19937 random(11);
+    const auto createSamples = [&random](const int numOfPixels, const int bitDepth)
+    {
+        std::vector<unsigned short> result(numOfPixels);
+        for (auto& value : result) value = (unsigned short)(random() & ((1 << bitDepth) - 1));
+        return result;
+    };
+
+    // Unpack
+    for (const auto layout : { PackedMonochromeLayout::Y10P, PackedMonochromeLayout::Y12P })
+    {
+        for (int numOfPixels = 0; numOfPixels <= 200; numOfPixels += BitDepthKernel::getPixelsPerGroup(layout))
+        {
+            const auto expected = createSamples(numOfPixels, BitDepthKernel::getBitDepth(layout));
+            const auto input = PackMonochromeReference(expected, layout);
+            for (const auto simdLevel : { SIMDLevel::Scalar, SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+            {
+                std::vector<unsigned short> output(numOfPixels + 32, 0xCDCD);
+                BitDepthKernel::UnpackToPixels(input.data(), output.data(), numOfPixels, layout, simdLevel);
+                ASSERT_TRUE(std::equal(expected.begin(), expected.end(), output.begin()))
+                    << "Fail: BitDepthKernel::UnpackToPixels() in SIMD level " << (int)simdLevel << ", layout " << (int)layout << " with " << numOfPixels << " pixels";
+                ASSERT_TRUE(std::all_of(output.begin() + numOfPixels, output.end(), [](const unsigned short value) { return value == 0xCDCD; }))
+                    << "Fail: BitDepthKernel::UnpackToPixels() writes out of bound in SIMD level " << (int)simdLevel;
+            }
+        }
+    }
+
+    // Normalize
+    for (int inputBitDepth = 8; inputBitDepth <= 16; inputBitDepth++)
+    {
+        for (int outputBitDepth = 8; outputBitDepth <= 16; outputBitDepth++)
+        {
+            for (const bool msbJustified : { false, true })
+            {
+                BitDepthConversion conversion;
+                conversion.InputBitDepth = inputBitDepth;
+                conversion.InputMSBJustified = msbJustified;
+                conversion.OutputBitDepth = outputBitDepth;
+
+                const int inputMax = (1 << inputBitDepth) - 1;
+                const int outputMax = (1 << outputBitDepth) - 1;
+                for (int numOfPixels = 0; numOfPixels <= 100; numOfPixels += 11)
+                {
+                    auto samples = createSamples(numOfPixels, inputBitDepth);
+                    if (numOfPixels >= 2)
+                    {
+                        samples[0] = 0;
+                        samples[1] = (unsigned short)inputMax;
+                    }
+                    std::vector<unsigned short> input(samples);
+                    if (msbJustified)
+                    {
+                        for (auto& value : input) value = (unsigned short)(value << (16 - inputBitDepth));
+                    }
+
+                    std::vector<unsigned short> expected(numOfPixels);
+                    BitDepthKernel::Normalize(input.data(), expected.data(), numOfPixels, conversion, SIMDLevel::Scalar);
+                    for (int x = 0; x < numOfPixels; x++)
+                    {
+                        const int reference = (int)std::lround((double)samples[x] * outputMax / inputMax);
+                        if (outputBitDepth >= inputBitDepth)
+                        {
+                            ASSERT_LE(std::abs(expected[x] - reference), 1) << "Fail: BitDepthKernel::Normalize() from " << inputBitDepth << " to " << outputBitDepth << " bits";
+                        }
+                        else
+                        {
+                            ASSERT_EQ(expected[x], samples[x] >> (inputBitDepth - outputBitDepth)) << "Fail: BitDepthKernel::Normalize() from " << inputBitDepth << " to " << outputBitDepth << " bits";
+                        }
+                    }
+                    if (numOfPixels >= 2)
+                    {
+                        ASSERT_EQ(expected[0], 0) << "Fail: BitDepthKernel::Normalize() of 0";
+                        ASSERT_EQ(expected[1], outputMax) << "Fail: BitDepthKernel::Normalize() of the maximum from " << inputBitDepth << " to " << outputBitDepth << " bits";
+                    }
+
+                    for (const auto simdLevel : { SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+                    {
+                        std::vector<unsigned short> output(numOfPixels + 32, 0xCDCD);
+                        BitDepthKernel::Normalize(input.data(), output.data(), numOfPixels, conversion, simdLevel);
+                        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), output.begin()))
+                            << "Fail: BitDepthKernel::Normalize() in SIMD level " << (int)simdLevel << " from " << inputBitDepth << " to " << outputBitDepth << " bits, MSB-justified = " << msbJustified;
+                        ASSERT_TRUE(std::all_of(output.begin() + numOfPixels, output.end(), [](const unsigned short value) { return value == 0xCDCD; }))
+                            << "Fail: BitDepthKernel::Normalize() writes out of bound in SIMD level " << (int)simdLevel;
+                    }
+                }
+            }
+        }
+    }
+
+    // Decode frame
+    struct VideoTypeCase
+    {
+        GUID VideoType;
+        int BitDepth;
+        bool MSBJustified;
+    };
+    const std::vector<VideoTypeCase> videoTypes = {
+        { MEDIASUBTYPE_Y16, 16, false },
+        { MEDIASUBTYPE_Y16, 12, true },
+        { MEDIASUBTYPE_Y10, 10, false },
+        { MEDIASUBTYPE_Y12, 12, false },
+        { MEDIASUBTYPE_Y10P, 10, false },
+        { MEDIASUBTYPE_Y12P, 12, false }
+    };
+    for (const auto& [width, height] : std::vector<std::pair<int, int>>{ { 4, 1 }, { 8, 3 }, { 68, 5 } })
+    {
+        for (const auto& videoTypeCase : videoTypes)
+        {
+            const bool isPacked = videoTypeCase.VideoType == MEDIASUBTYPE_Y10P || videoTypeCase.VideoType == MEDIASUBTYPE_Y12P;
+            const auto samples = createSamples(width * height, videoTypeCase.BitDepth);
+            std::vector<unsigned char> input;
+            if (isPacked)
+            {
+                input = PackMonochromeReference(samples, videoTypeCase.VideoType == MEDIASUBTYPE_Y10P ? PackedMonochromeLayout::Y10P : PackedMonochromeLayout::Y12P);
+            }
+            else
+            {
+                input.resize(width * height * 2);
+                for (int i = 0; i < width * height; i++)
+                {
+                    const unsigned short value = (unsigned short)(videoTypeCase.MSBJustified ? samples[i] << (16 - videoTypeCase.BitDepth) : samples[i]);
+                    input[i * 2] = (unsigned char)(value & 0xFF);
+                    input[i * 2 + 1] = (unsigned char)(value >> 8);
+                }
+            }
+
+            for (const int outputBitDepth : { 0, 16 })
+            {
+                DirectShowCamera::FrameSettings frameSettings;
+                frameSettings.SourceBitDepth = videoTypeCase.VideoType == MEDIASUBTYPE_Y16 ? videoTypeCase.BitDepth : 0;
+                frameSettings.SourceMSBJustified = videoTypeCase.MSBJustified;
+                frameSettings.OutputBitDepth = outputBitDepth;
+
+                // Samples in the output bit depth
+                BitDepthConversion conversion;
+                conversion.InputBitDepth = videoTypeCase.BitDepth;
+                conversion.OutputBitDepth = outputBitDepth == 0 ? videoTypeCase.BitDepth : outputBitDepth;
+                std::vector<unsigned short> normalized(samples.size());
+                BitDepthKernel::Normalize(samples.data(), normalized.data(), (int)samples.size(), conversion, SIMDLevel::Scalar);
+                EXPECT_EQ(FrameDecoder::getBitDepth(videoTypeCase.VideoType, frameSettings), conversion.OutputBitDepth) << "Fail: FrameDecoder::getBitDepth()";
+
+                for (const bool verticalFlip : { true, false })
+                {
+                    for (const bool horizontalMirror : { true, false })
+                    {
+                        frameSettings.VerticalFlip = verticalFlip;
+                        frameSettings.HorizontalMirror = horizontalMirror;
+
+                        std::vector<unsigned short> expected(width * height);
+                        for (int y = 0; y < height; y++)
+                        {
+                            const int inputY = verticalFlip ? y : height - y - 1;
+                            for (int x = 0; x < width; x++)
+                            {
+                                expected[y * width + x] = normalized[inputY * width + (horizontalMirror ? width - x - 1 : x)];
+                            }
+                        }
+
+                        std::vector<unsigned short> output(width * height);
+                        FrameDecoder::DecodeFrame(input.data(), (unsigned char*)output.data(), videoTypeCase.VideoType, width, height, frameSettings);
+                        EXPECT_EQ(output, expected) << "Fail: FrameDecoder::DecodeFrame() in " << width << "x" << height << ", " << DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType)
+                            << ", source bit depth " << videoTypeCase.BitDepth << ", output bit depth " << outputBitDepth
+                            << ", verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror;
+                    }
+                }
+            }
+        }
+    }
+
+    // Bit depth of the other video types
+    EXPECT_EQ(FrameDecoder::getBitDepth(MEDIASUBTYPE_RGB24, DirectShowCamera::FrameSettings()), 8) << "Fail: FrameDecoder::getBitDepth() with RGB24";
+    EXPECT_EQ(FrameDecoder::getBitDepth(MEDIASUBTYPE_Y800, DirectShowCamera::FrameSettings()), 8) << "Fail: FrameDecoder::getBitDepth() with Y800";
+
+    // Invalid
+    std::vector<unsigned char> frame(64);
+    std::vector<unsigned short> samples(64);
+    EXPECT_THROW(BitDepthKernel::UnpackToPixels(frame.data(), samples.data(), 6, PackedMonochromeLayout::Y10P), std::invalid_argument) << "Fail: BitDepthKernel::UnpackToPixels() with 6 pixels";
+    EXPECT_THROW(FrameDecoder::DecodeFrame(frame.data(), frame.data(), MEDIASUBTYPE_Y10P, 6, 1, DirectShowCamera::FrameSettings()), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrame() with Y10P in a width of 6";
+    DirectShowCamera::FrameSettings frameSettings;
+    frameSettings.OutputBitDepth = 17;
+    EXPECT_THROW(FrameDecoder::getBitDepthConversion(MEDIASUBTYPE_Y16, frameSettings), std::invalid_argument) << "Fail: FrameDecoder::getBitDepthConversion() to 17 bits";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder12
+ * <b>Title:</b> Test 16-bit to 8 bit tone mapping
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Map 16-bit samples to 8 bit pixels by every SIMD level supported by the CPU, and map Y16, Y12 and Y10P frames in a fixed window and in auto range
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Map 0 to 100 samples in windows from 1 sample to the full 16 bits, linear and with a gamma, by each SIMD level
+ *   2. Get the tone mapping table of the frames in auto range, sampling all pixels and a flat frame
+ *   3. Map the frames with every combination of vertical flip and horizontal mirror, in the source bit depth and in 16 bits
+ *   4. Build a table with an empty window, a gamma of 0 and get a table with a sample step of 0 or of a RGB24 frame
+ * <b>Expected Result:</b>
+ *   1. Same as the rounded scaling within 1. The samples at and outside the window ends are 0 and 255. All SIMD levels are the same.
+ *   2. The window is the min and the max of the frame. The window of the flat frame is 1 sample from the frame value.
+ *   3. Same as mapping the 16-bit frame decoded by FrameDecoder::DecodeFrame()
+ *   4. Throw std::invalid_argument
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestToneMap)
+{
+    using DirectShowCamera::BitDepthKernel;
+    using DirectShowCamera::FrameDecoder;
+    using DirectShowCamera::PackedMonochromeLayout;
+    using DirectShowCamera::SIMDLevel;
+    using DirectShowCamera::ToneMapKernel;
+    using DirectShowCamera::ToneMapMode;
+    using DirectShowCamera::ToneMapSettings;
+
+    std::mt19937 random(12);
+
+    // Kernels
+    for (const auto& [low, high] : std::vector<std::pair<int, int>>{ { 0, 1 }, { 100, 101 }, { 0, 255 }, { 10, 300 }, { 100, 1123 }, { 0, 4095 }, { 1000, 60000 }, { 0, 65535 } })
+    {
+        for (const double gamma : { 1.0, 2.2, 0.5 })
+        {
+            const auto table = ToneMapKernel::BuildTable(low, high, gamma);
+            for (int numOfPixels = 0; numOfPixels <= 100; numOfPixels += 11)
+            {
+                // Samples around the window, including the ends
+                std::vector<unsigned short> input(numOfPixels);
+                for (auto& value : input) value = (unsigned short)std::clamp(low - 8 + (int)(random() % (high - low + 17)), 0, 65535);
+                if (numOfPixels >= 4)
+                {
+                    input[0] = (unsigned short)low;
+                    input[1] = (unsigned short)high;
+                    input[2] = 0;
+                    input[3] = 65535;
+                }
+
+                std::vector<unsigned char> expected(numOfPixels);
+                ToneMapKernel::ToPixels(input.data(), expected.data(), numOfPixels, table, SIMDLevel::Scalar);
+                for (int x = 0; x < numOfPixels; x++)
+                {
+                    const double position = (double)(std::clamp((int)input[x], low, high) - low) / (high - low);
+                    const int reference = (int)std::lround(255.0 * std::pow(position, 1.0 / gamma));
+                    ASSERT_LE(std::abs(expected[x] - reference), 1) << "Fail: ToneMapKernel::ToPixels() of " << input[x] << " in the window " << low << " - " << high << ", gamma " << gamma;
+                }
+                if (numOfPixels >= 4)
+                {
+                    EXPECT_EQ(expected[0], 0) << "Fail: ToneMapKernel::ToPixels() of the window low " << low;
+                    EXPECT_EQ(expected[1], 255) << "Fail: ToneMapKernel::ToPixels() of the window high " << high;
+                    EXPECT_EQ(expected[2], 0) << "Fail: ToneMapKernel::ToPixels() of 0 in the window " << low << " - " << high;
+                    EXPECT_EQ(expected[3], 255) << "Fail: ToneMapKernel::ToPixels() of 65535 in the window " << low << " - " << high;
+                }
+
+                for (const auto simdLevel : { SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+                {
+                    std::vector<unsigned char> output(numOfPixels + 32, 0xCD);
+                    ToneMapKernel::ToPixels(input.data(), output.data(), numOfPixels, table, simdLevel);
+                    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), output.begin()))
+                        << "Fail: ToneMapKernel::ToPixels() in SIMD level " << (int)simdLevel << " in the window " << low << " - " << high << ", gamma " << gamma << " with " << numOfPixels << " pixels";
+                    ASSERT_TRUE(std::all_of(output.begin() + numOfPixels, output.end(), [](const unsigned char value) { return value == 0xCD; }))
+                        << "Fail: ToneMapKernel::ToPixels() writes out of bound in SIMD level " << (int)simdLevel;
+                }
+            }
+        }
+    }
+
+    // Frames
+    struct VideoTypeCase
+    {
+        GUID VideoType;
+        int BitDepth;
+    };
+    const int width = 68;
+    const int height = 5;
+    for (const auto& videoTypeCase : std::vector<VideoTypeCase>{ { MEDIASUBTYPE_Y16, 16 }, { MEDIASUBTYPE_Y12, 12 }, { MEDIASUBTYPE_Y10P, 10 } })
+    {
+        // Samples in the middle of the range
+        const int maxValue = (1 << videoTypeCase.BitDepth) - 1;
+        std::vector<unsigned short> samples(width * height);
+        for (auto& value : samples) value = (unsigned short)(maxValue / 4 + random() % (maxValue / 2));
+
+        std::vector<unsigned char> input;
+        if (videoTypeCase.VideoType == MEDIASUBTYPE_Y10P)
+        {
+            input = PackMonochromeReference(samples, PackedMonochromeLayout::Y10P);
+        }
+        else
+        {
+            input.resize(width * height * 2);
+            memcpy(input.data(), samples.data(), input.size());
+        }
+
+        for (const int outputBitDepth : { 0, 16 })
+        {
+            DirectShowCamera::FrameSettings frameSettings;
+            frameSettings.OutputBitDepth = outputBitDepth;
+
+            // 16-bit frame in the output bit depth
+            std::vector<unsigned short> decoded(width * height);
+            FrameDecoder::DecodeFrame(input.data(), (unsigned char*)decoded.data(), videoTypeCase.VideoType, width, height, frameSettings);
+            const auto [minIt, maxIt] = std::minmax_element(decoded.begin(), decoded.end());
+
+            // Auto range of all pixels
+            ToneMapSettings autoRange;
+            autoRange.AutoRangeSampleStep = 1;
+            const auto autoRangeTable = FrameDecoder::getToneMapTable(input.data(), videoTypeCase.VideoType, width, height, autoRange, frameSettings);
+            EXPECT_EQ(autoRangeTable.Low, *minIt) << "Fail: FrameDecoder::getToneMapTable() auto range low of " << DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType);
+            EXPECT_EQ(autoRangeTable.High, *maxIt) << "Fail: FrameDecoder::getToneMapTable() auto range high of " << DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType);
+
+            // Fixed window in the middle of the samples
+            ToneMapSettings window;
+            window.Mode = ToneMapMode::Window;
+            window.WindowLow = *minIt + (*maxIt - *minIt) / 4;
+            window.WindowHigh = *maxIt - (*maxIt - *minIt) / 4;
+            window.Gamma = 2.2;
+
+            for (const auto& [toneMapSettings, table] : std::vector<std::pair<ToneMapSettings, DirectShowCamera::ToneMapTable>>{
+                { autoRange, autoRangeTable },
+                { window, ToneMapKernel::BuildTable(window.WindowLow, window.WindowHigh, window.Gamma) } })
+            {
+                for (const bool verticalFlip : { true, false })
+                {
+                    for (const bool horizontalMirror : { true, false })
+                    {
+                        frameSettings.VerticalFlip = verticalFlip;
+                        frameSettings.HorizontalMirror = horizontalMirror;
+
+                        std::vector<unsigned short> decodedFrame(width * height);
+                        FrameDecoder::DecodeFrame(input.data(), (unsigned char*)decodedFrame.data(), videoTypeCase.VideoType, width, height, frameSettings);
+                        std::vector<unsigned char> expected(width * height);
+                        ToneMapKernel::ToPixels(decodedFrame.data(), expected.data(), width * height, table, SIMDLevel::Scalar);
+
+                        const auto output = FrameDecoder::Decode16BitMonochromeFrameTo8Bit(input.data(), videoTypeCase.VideoType, width, height, toneMapSettings, frameSettings);
+                        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), output.get()))
+                            << "Fail: FrameDecoder::Decode16BitMonochromeFrameTo8Bit() of " << DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType)
+                            << ", mode " << (int)toneMapSettings.Mode << ", output bit depth " << outputBitDepth
+                            << ", verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror;
+                    }
+                }
+            }
+        }
+    }
+
+    // Flat frame
+    const std::vector<unsigned short> flatFrame(width * height, 65535);
+    const auto flatTable = FrameDecoder::getToneMapTable((const unsigned char*)flatFrame.data(), MEDIASUBTYPE_Y16, width, height, ToneMapSettings());
+    EXPECT_EQ(flatTable.Low, 65534) << "Fail: FrameDecoder::getToneMapTable() auto range low of a flat frame";
+    EXPECT_EQ(flatTable.High, 65535) << "Fail: FrameDecoder::getToneMapTable() auto range high of a flat frame";
+
+    // Invalid
+    EXPECT_THROW(ToneMapKernel::BuildTable(100, 100), std::invalid_argument) << "Fail: ToneMapKernel::BuildTable() with an empty window";
+    EXPECT_THROW(ToneMapKernel::BuildTable(0, 100, 0.0), std::invalid_argument) << "Fail: ToneMapKernel::BuildTable() with a gamma of 0";
+    ToneMapSettings invalidStep;
+    invalidStep.AutoRangeSampleStep = 0;
+    EXPECT_THROW(FrameDecoder::getToneMapTable((const unsigned char*)flatFrame.data(), MEDIASUBTYPE_Y16, width, height, invalidStep), std::invalid_argument)
+        << "Fail: FrameDecoder::getToneMapTable() with a sample step of 0";
+    EXPECT_THROW(FrameDecoder::Decode16BitMonochromeFrameTo8Bit((const unsigned char*)flatFrame.data(), MEDIASUBTYPE_RGB24, width, height, ToneMapSettings()), std::invalid_argument)
+        << "Fail: FrameDecoder::Decode16BitMonochromeFrameTo8Bit() with RGB24";
+}
+
+/**
+ * @brief Get the channel of a pixel of a Bayer pattern
+ * @param[in] pattern Pattern of the first row
+ * @param[in] x X
+ * @param[in] y Y
+ * @return Return 0 for red, 1 for green and 2 for blue
+*/
+static int getBayerChannel(const DirectShowCamera::BayerPattern pattern, const int x, const int y)
+{
+    static const int channels[4][4] = { { 0, 1, 1, 2 }, { 2, 1, 1, 0 }, { 1, 0, 2, 1 }, { 1, 2, 0, 1 } };
+    return channels[(int)pattern][(y % 2) * 2 + x % 2];
+}
+
+/**
+ * @brief Sample a RGB image by a Bayer pattern as a reference
+ * @param[in] rgb RGB image. Rows are stored from the top.
+ * @param[in] width Width
+ * @param[in] height Height
+ * @param[in] pattern Pattern of the first row
+ * @return Return the Bayer frame in 8 bit
+*/
+static std::vector<unsigned char> MosaicBayerReference(const std::vector<unsigned char>& rgb, const int width, const int height, const DirectShowCamera::BayerPattern pattern)
+{
+    std::vector<unsigned char> result(width * height);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            result[y * width + x] = rgb[(y * width + x) * 3 + getBayerChannel(pattern, x, y)];
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder13
+ * <b>Title:</b> Test Bayer demosaic
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Demosaic Bayer rows by every SIMD level supported by the CPU, and decode the 8 bit and 16bit Bayer frames of the 4 patterns in the bilinear, the edge-aware and the half size demosaic
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Demosaic random rows and merge random 2 x 2 blocks of each pattern to each output format in widths from 2 to 100 by each SIMD level
+ *   2. Decode frames of a flat color
+ *   3. Decode a random frame in bilinear
+ *   4. Decode a frame of a vertical edge
+ *   5. Decode a random frame in half size
+ *   6. Decode a random frame in 16 bits with a source bit depth of 16 and 12, with every combination of vertical flip and horizontal mirror, and in 4 threads
+ *   7. Decode a frame in an odd size, to Gray8 and of a RGB24 frame
+ * <b>Expected Result:</b>
+ *   1. All SIMD levels are the same as the scalar kernel, no byte after the output is written
+ *   2. All pixels are the flat color in all demosaics
+ *   3. The interior pixels are the mean of the nearest samples of each color within 1
+ *   4. The green of the edge-aware demosaic is exact, the bilinear one is not
+ *   5. Red and blue are the samples of the block, green is the rounded average of the 2 green samples
+ *   6. Same as the 8 bit frame in the same flip, mirror and FrameDecoder::DecodeFrame(). The flip and the mirror reverse the rows and the pixels.
+ *   7. Throw std::invalid_argument
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestBayerDemosaic)
+{
+    using DirectShowCamera::BayerDemosaic;
+    using DirectShowCamera::BayerKernel;
+    using DirectShowCamera::BayerPattern;
+    using DirectShowCamera::FrameDecoder;
+    using DirectShowCamera::SIMDLevel;
+    using DirectShowCamera::YUVOutputFormat;
+
+    std::mt19937 random(13);
+    const auto patterns = { BayerPattern::RGGB, BayerPattern::BGGR, BayerPattern::GRBG, BayerPattern::GBRG };
+    const auto demosaics = { BayerDemosaic::Bilinear, BayerDemosaic::EdgeAware };
+    const auto outputFormats = { YUVOutputFormat::BGR24, YUVOutputFormat::RGB24, YUVOutputFormat::BGRA32, YUVOutputFormat::RGBA32 };
+
+    // Kernels
+    for (const int width : { 2, 4, 6, 14, 16, 18, 30, 32, 34, 62, 64, 66, 100 })
+    {
+        // 5 padded rows
+        const int paddedWidth = width + 2 * BayerKernel::RowPadding;
+        const auto input = CreateRandomImage(paddedWidth * 5);
+        const unsigned char* rows[5];
+        for (int i = 0; i < 5; i++) rows[i] = input.data() + paddedWidth * i + BayerKernel::RowPadding;
+
+        for (const auto pattern : patterns)
+        {
+            for (const auto outputFormat : outputFormats)
+            {
+                const int bytesPerPixel = DirectShowCamera::YUVKernel::getBytesPerPixel(outputFormat);
+                for (const auto demosaic : demosaics)
+                {
+                    const auto windowRows = rows + 2 - BayerKernel::getRadius(demosaic);
+                    std::vector<unsigned char> expected(width * bytesPerPixel);
+                    BayerKernel::DemosaicRow(windowRows, expected.data(), width, pattern, demosaic, outputFormat, SIMDLevel::Scalar);
+                    for (const auto simdLevel : { SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+                    {
+                        std::vector<unsigned char> output(expected.size() + 32, 0xCD);
+                        BayerKernel::DemosaicRow(windowRows, output.data(), width, pattern, demosaic, outputFormat, simdLevel);
+                        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), output.begin()))
+                            << "Fail: BayerKernel::DemosaicRow() in SIMD level " << (int)simdLevel << ", pattern " << (int)pattern << ", demosaic " << (int)demosaic
+                            << ", output format " << (int)outputFormat << " with " << width << " pixels";
+                        ASSERT_TRUE(std::all_of(output.begin() + expected.size(), output.end(), [](const unsigned char value) { return value == 0xCD; }))
+                            << "Fail: BayerKernel::DemosaicRow() writes out of bound in SIMD level " << (int)simdLevel;
+                    }
+                }
+
+                // Half size
+                const int outputWidth = width / 2 + 1;
+                const auto blocks = CreateRandomImage(outputWidth * 4);
+                std::vector<unsigned char> expected(outputWidth * bytesPerPixel);
+                BayerKernel::SuperpixelRow(blocks.data(), blocks.data() + outputWidth * 2, expected.data(), outputWidth, pattern, outputFormat, SIMDLevel::Scalar);
+                for (const auto simdLevel : { SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+                {
+                    std::vector<unsigned char> output(expected.size() + 32, 0xCD);
+                    BayerKernel::SuperpixelRow(blocks.data(), blocks.data() + outputWidth * 2, output.data(), outputWidth, pattern, outputFormat, simdLevel);
+                    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), output.begin()))
+                        << "Fail: BayerKernel::SuperpixelRow() in SIMD level " << (int)simdLevel << ", pattern " << (int)pattern << ", output format " << (int)outputFormat << " with " << outputWidth << " pixels";
+                    ASSERT_TRUE(std::all_of(output.begin() + expected.size(), output.end(), [](const unsigned char value) { return value == 0xCD; }))
+                        << "Fail: BayerKernel::SuperpixelRow() writes out of bound in SIMD level " << (int)simdLevel;
+                }
+            }
+        }
+    }
+
+    // Frames
+    struct VideoTypeCase
+    {
+        GUID VideoType;
+        GUID VideoType16Bit;
+        BayerPattern Pattern;
+    };
+    const std::vector<VideoTypeCase> videoTypeCases = {
+        { MEDIASUBTYPE_RGGB, MEDIASUBTYPE_RG16, BayerPattern::RGGB },
+        { MEDIASUBTYPE_BA81, MEDIASUBTYPE_BYR2, BayerPattern::BGGR },
+        { MEDIASUBTYPE_GRBG, MEDIASUBTYPE_GR16, BayerPattern::GRBG },
+        { MEDIASUBTYPE_GBRG, MEDIASUBTYPE_GB16, BayerPattern::GBRG }
+    };
+    const int width = 70;
+    const int height = 12;
+    for (const auto& videoTypeCase : videoTypeCases)
+    {
+        const auto videoTypeName = DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType);
+
+        // Flat color
+        std::vector<unsigned char> flat(width * height * 3);
+        for (int i = 0; i < width * height; i++)
+        {
+            flat[i * 3] = 200;
+            flat[i * 3 + 1] = 100;
+            flat[i * 3 + 2] = 30;
+        }
+        const auto flatFrame = MosaicBayerReference(flat, width, height, videoTypeCase.Pattern);
+        for (const auto demosaic : demosaics)
+        {
+            DirectShowCamera::FrameSettings frameSettings;
+            frameSettings.Demosaic = demosaic;
+            const auto output = FrameDecoder::DecodeBayerFrame(flatFrame.data(), videoTypeCase.VideoType, width, height, YUVOutputFormat::RGB24, frameSettings);
+            EXPECT_TRUE(std::equal(flat.begin(), flat.end(), output.get())) << "Fail: FrameDecoder::DecodeBayerFrame() of a flat color in " << videoTypeName << ", demosaic " << (int)demosaic;
+        }
+        const auto flatHalfSize = FrameDecoder::DecodeBayerFrameHalfSize(flatFrame.data(), videoTypeCase.VideoType, width, height, YUVOutputFormat::RGB24);
+        EXPECT_TRUE(std::equal(flat.begin(), flat.begin() + (width / 2) * (height / 2) * 3, flatHalfSize.get())) << "Fail: FrameDecoder::DecodeBayerFrameHalfSize() of a flat color in " << videoTypeName;
+
+        // Bilinear, the mean of the nearest samples of each color
+        const auto frame = CreateRandomImage(width * height);
+        const auto bilinear = FrameDecoder::DecodeBayerFrame(frame.data(), videoTypeCase.VideoType, width, height, YUVOutputFormat::RGB24);
+        for (int y = 1; y < height - 1; y++)
+        {
+            for (int x = 1; x < width - 1; x++)
+            {
+                int sums[3] = { 0, 0, 0 };
+                int counts[3] = { 0, 0, 0 };
+                const int channel = getBayerChannel(videoTypeCase.Pattern, x, y);
+                for (int dy = -1; dy <= 1; dy++)
+                {
+                    for (int dx = -1; dx <= 1; dx++)
+                    {
+                        // The green of a green pixel is its own sample
+                        const int neighborChannel = getBayerChannel(videoTypeCase.Pattern, x + dx, y + dy);
+                        if (channel == 1 && neighborChannel == 1 && (dx != 0 || dy != 0)) continue;
+                        sums[neighborChannel] += frame[(y + dy) * width + x + dx];
+                        counts[neighborChannel]++;
+                    }
+                }
+                for (int c = 0; c < 3; c++)
+                {
+                    const double mean = (double)sums[c] / counts[c];
+                    ASSERT_LE(std::abs(bilinear[(y * width + x) * 3 + c] - mean), 1.0)
+                        << "Fail: FrameDecoder::DecodeBayerFrame() in bilinear of " << videoTypeName << " at (" << x << ", " << y << "), channel " << c;
+                }
+            }
+        }
+
+        // Vertical edge
+        std::vector<unsigned char> edge(width * height * 3);
+        for (int i = 0; i < width * height * 3; i++) edge[i] = (i / 3) % width < width / 2 + 1 ? 220 : 30;
+        const auto edgeFrame = MosaicBayerReference(edge, width, height, videoTypeCase.Pattern);
+        int bilinearGreenErrors = 0;
+        for (const auto demosaic : demosaics)
+        {
+            DirectShowCamera::FrameSettings frameSettings;
+            frameSettings.Demosaic = demosaic;
+            const auto output = FrameDecoder::DecodeBayerFrame(edgeFrame.data(), videoTypeCase.VideoType, width, height, YUVOutputFormat::RGB24, frameSettings);
+            for (int i = 0; i < width * height; i++)
+            {
+                if (demosaic == BayerDemosaic::EdgeAware)
+                {
+                    ASSERT_EQ(output[i * 3 + 1], edge[i * 3 + 1]) << "Fail: FrameDecoder::DecodeBayerFrame() green of a vertical edge in " << videoTypeName << " at (" << i % width << ", " << i / width << ")";
+                }
+                else if (output[i * 3 + 1] != edge[i * 3 + 1])
+                {
+                    bilinearGreenErrors++;
+                }
+            }
+        }
+        EXPECT_GT(bilinearGreenErrors, 0) << "Fail: FrameDecoder::DecodeBayerFrame() bilinear green of a vertical edge in " << videoTypeName;
+
+        // Half size
+        const auto halfSize = FrameDecoder::DecodeBayerFrameHalfSize(frame.data(), videoTypeCase.VideoType, width, height, YUVOutputFormat::BGRA32);
+        for (int y = 0; y < height / 2; y++)
+        {
+            for (int x = 0; x < width / 2; x++)
+            {
+                int colors[3] = { 0, 0, 0 };
+                for (int i = 0; i < 4; i++)
+                {
+                    const int sampleX = x * 2 + i % 2;
+                    const int sampleY = y * 2 + i / 2;
+                    colors[getBayerChannel(videoTypeCase.Pattern, sampleX, sampleY)] += frame[sampleY * width + sampleX];
+                }
+                const unsigned char* pixel = halfSize.get() + (y * (width / 2) + x) * 4;
+                ASSERT_EQ(pixel[0], colors[2]) << "Fail: FrameDecoder::DecodeBayerFrameHalfSize() blue of " << videoTypeName << " at (" << x << ", " << y << ")";
+                ASSERT_EQ(pixel[1], (colors[1] + 1) / 2) << "Fail: FrameDecoder::DecodeBayerFrameHalfSize() green of " << videoTypeName << " at (" << x << ", " << y << ")";
+                ASSERT_EQ(pixel[2], colors[0]) << "Fail: FrameDecoder::DecodeBayerFrameHalfSize() red of " << videoTypeName << " at (" << x << ", " << y << ")";
+                ASSERT_EQ(pixel[3], 255) << "Fail: FrameDecoder::DecodeBayerFrameHalfSize() alpha of " << videoTypeName;
+            }
+        }
+
+        // 16 bits, flip and mirror
+        std::vector<unsigned short> frame16Bit(width * height);
+        std::vector<unsigned short> frame12Bit(width * height);
+        for (int i = 0; i < width * height; i++)
+        {
+            frame16Bit[i] = (unsigned short)((frame[i] << 8) | (random() % 256));
+            frame12Bit[i] = (unsigned short)((frame[i] << 4) | (random() % 16));
+        }
+        for (const auto demosaic : demosaics)
+        {
+            DirectShowCamera::FrameSettings frameSettings;
+            frameSettings.Demosaic = demosaic;
+            const auto unflipped = FrameDecoder::DecodeBayerFrame(frame.data(), videoTypeCase.VideoType, width, height, YUVOutputFormat::BGR24, frameSettings);
+
+            for (const bool verticalFlip : { true, false })
+            {
+                for (const bool horizontalMirror : { true, false })
+                {
+                    frameSettings.VerticalFlip = verticalFlip;
+                    frameSettings.HorizontalMirror = horizontalMirror;
+                    frameSettings.SourceBitDepth = 0;
+
+                    const auto output = FrameDecoder::DecodeBayerFrame(frame.data(), videoTypeCase.VideoType, width, height, YUVOutputFormat::BGR24, frameSettings);
+                    for (int y = 0; y < height; y++)
+                    {
+                        for (int x = 0; x < width; x++)
+                        {
+                            const int sourceX = horizontalMirror ? width - 1 - x : x;
+                            const int sourceY = verticalFlip ? height - 1 - y : y;
+                            ASSERT_TRUE(std::equal(output.get() + (y * width + x) * 3, output.get() + (y * width + x) * 3 + 3, unflipped.get() + (sourceY * width + sourceX) * 3))
+                                << "Fail: FrameDecoder::DecodeBayerFrame() of " << videoTypeName << ", verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror;
+                        }
+                    }
+
+                    std::vector<unsigned char> decoded(width * height * 3);
+                    FrameDecoder::DecodeFrame(frame.data(), decoded.data(), videoTypeCase.VideoType, width, height, frameSettings);
+                    EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), output.get())) << "Fail: FrameDecoder::DecodeFrame() of " << videoTypeName;
+
+                    const auto output16Bit = FrameDecoder::DecodeBayerFrame((const unsigned char*)frame16Bit.data(), videoTypeCase.VideoType16Bit, width, height, YUVOutputFormat::BGR24, frameSettings);
+                    EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), output16Bit.get())) << "Fail: FrameDecoder::DecodeBayerFrame() of 16 bits " << DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType16Bit);
+
+                    frameSettings.SourceBitDepth = 12;
+                    const auto output12Bit = FrameDecoder::DecodeBayerFrame((const unsigned char*)frame12Bit.data(), videoTypeCase.VideoType16Bit, width, height, YUVOutputFormat::BGR24, frameSettings);
+                    EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), output12Bit.get())) << "Fail: FrameDecoder::DecodeBayerFrame() of 12 bits " << DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType16Bit);
+
+                    const auto halfSize16Bit = FrameDecoder::DecodeBayerFrameHalfSize((const unsigned char*)frame12Bit.data(), videoTypeCase.VideoType16Bit, width, height, YUVOutputFormat::BGR24, frameSettings);
+                    frameSettings.SourceBitDepth = 0;
+                    const auto halfSize8Bit = FrameDecoder::DecodeBayerFrameHalfSize(frame.data(), videoTypeCase.VideoType, width, height, YUVOutputFormat::BGR24, frameSettings);
+                    EXPECT_TRUE(std::equal(halfSize8Bit.get(), halfSize8Bit.get() + (width / 2) * (height / 2) * 3, halfSize16Bit.get()))
+                        << "Fail: FrameDecoder::DecodeBayerFrameHalfSize() of 12 bits " << DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType16Bit);
+                }
+            }
+
+            // Parallel
+            frameSettings.VerticalFlip = false;
+            frameSettings.HorizontalMirror = false;
+            FrameDecoder::setParallelDecodeMinFrameSize(0);
+            FrameDecoder::setNumOfDecodeThreads(4);
+            const auto parallel = FrameDecoder::DecodeBayerFrame(frame.data(), videoTypeCase.VideoType, width, height, YUVOutputFormat::BGR24, frameSettings);
+            FrameDecoder::setNumOfDecodeThreads(1);
+            FrameDecoder::setParallelDecodeMinFrameSize(1920 * 1080);
+            EXPECT_TRUE(std::equal(unflipped.get(), unflipped.get() + width * height * 3, parallel.get())) << "Fail: FrameDecoder::DecodeBayerFrame() of " << videoTypeName << " in 4 threads";
+        }
+    }
+
+    // Invalid
+    const auto frame = CreateRandomImage(width * height * 2);
+    EXPECT_THROW(FrameDecoder::DecodeBayerFrame(frame.data(), MEDIASUBTYPE_RGGB, 7, 4), std::invalid_argument) << "Fail: FrameDecoder::DecodeBayerFrame() in a width of 7";
+    EXPECT_THROW(FrameDecoder::DecodeBayerFrameHalfSize(frame.data(), MEDIASUBTYPE_RGGB, 8, 5), std::invalid_argument) << "Fail: FrameDecoder::DecodeBayerFrameHalfSize() in a height of 5";
+    EXPECT_THROW(FrameDecoder::DecodeBayerFrame(frame.data(), MEDIASUBTYPE_RGGB, 8, 4, YUVOutputFormat::Gray8), std::invalid_argument) << "Fail: FrameDecoder::DecodeBayerFrame() to Gray8";
+    EXPECT_THROW(FrameDecoder::DecodeBayerFrame(frame.data(), MEDIASUBTYPE_RGB24, 8, 4), std::invalid_argument) << "Fail: FrameDecoder::DecodeBayerFrame() of RGB24";
+}
+
+/**
+ * @brief Resize an image by area averaging in double as a reference
+ * @param[in] input Input image
+ * @param[in] width Width of the input image
+ * @param[in] channels Samples per pixel
+ * @param[in] coveredWidth Number of input columns covered by the output
+ * @param[in] coveredHeight Number of input rows covered by the output
+ * @param[in] outputWidth Output width
+ * @param[in] outputHeight Output height
+ * @return Return the resized image
+*/
+template <typename Sample>
+static std::vector<double> ResizeAreaReference(
+    const Sample* input,
+    const int width,
+    const int channels,
+    const int coveredWidth,
+    const int coveredHeight,
+    const int outputWidth,
+    const int outputHeight
+)
+{
+    std::vector<double> result(outputWidth * outputHeight * channels);
+    const double scaleX = (double)coveredWidth / outputWidth;
+    const double scaleY = (double)coveredHeight / outputHeight;
+    for (int outputY = 0; outputY < outputHeight; outputY++)
+    {
+        const double top = outputY * scaleY;
+        const double bottom = (outputY + 1) * scaleY;
+        for (int outputX = 0; outputX < outputWidth; outputX++)
+        {
+            const double left = outputX * scaleX;
+            const double right = (outputX + 1) * scaleX;
+            for (int c = 0; c < channels; c++)
+            {
+                // Sum the inputs weighted by the covered area
+                double sum = 0;
+                for (int y = (int)top; y < bottom; y++)
+                {
+                    const double weightY = std::min(bottom, y + 1.0) - std::max(top, (double)y);
+                    for (int x = (int)left; x < right; x++)
+                    {
+                        const double weightX = std::min(right, x + 1.0) - std::max(left, (double)x);
+                        sum += weightX * weightY * input[(y * width + x) * channels + c];
+                    }
+                }
+                result[(outputY * outputWidth + outputX) * channels + c] = sum / (scaleX * scaleY);
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder14
+ * <b>Title:</b> Test resize
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Accumulate rows by every SIMD level supported by the CPU, and bin and resize frames of each family while they are decoded
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Accumulate random rows of 8 bit and 16 bit samples in lengths from 1 to 100 by each SIMD level
+ *   2. Decode random RGB24, YUY2, NV12, Y800, Y16, RGGB and MJPG frames in a binning of 2 and 4, a resize of 33x13 and a resize to the frame size, with every combination of vertical flip and horizontal mirror
+ *   3. Decode the frames in 4 threads
+ *   4. Tone map a random Y16 frame in a binning of 2
+ *   5. Decode in invalid binning and resize settings
+ * <b>Expected Result:</b>
+ *   1. All SIMD levels are the same as the scalar kernel, no sum after the row is written
+ *   2. The size is returned by FrameDecoder::getDecodedSize(). The binning is the rounded average of each block of the decoded frame, the right and the bottom pixels which don't fill a block are dropped.
+ *      The resize is the area average of the decoded frame within 2 levels of 8 bits, the weights are in 1/256 of an output.
+ *   3. Same as 1 thread
+ *   4. Same as the binning of the tone mapped frame
+ *   5. Throw std::invalid_argument
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestResize)
+{
+    using DirectShowCamera::DirectShowCameraStubJPEGEncoder;
+    using DirectShowCamera::FrameDecoder;
+    using DirectShowCamera::ResizeKernel;
+    using DirectShowCamera::SIMDLevel;
+
+    std::mt19937 random(14);
+
+    // Kernels
+    for (const int numOfSamples : { 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100 })
+    {
+        for (const int bytesPerSample : { 1, 2 })
+        {
+            const auto input = CreateRandomImage(numOfSamples * bytesPerSample);
+            std::vector<unsigned int> sums(numOfSamples + 16);
+            for (auto& sum : sums) sum = random() % (1 << 24);
+
+            for (const bool firstRow : { true, false })
+            {
+                std::vector<unsigned int> expected = sums;
+                ResizeKernel::AccumulateRow(input.data(), expected.data(), numOfSamples, bytesPerSample, 93, firstRow, SIMDLevel::Scalar);
+                for (const auto simdLevel : { SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+                {
+                    std::vector<unsigned int> output = sums;
+                    ResizeKernel::AccumulateRow(input.data(), output.data(), numOfSamples, bytesPerSample, 93, firstRow, simdLevel);
+                    ASSERT_EQ(output, expected)
+                        << "Fail: ResizeKernel::AccumulateRow() in SIMD level " << (int)simdLevel << ", " << bytesPerSample << " bytes per sample, firstRow = " << firstRow << " with " << numOfSamples << " samples";
+                }
+                ASSERT_TRUE(std::equal(sums.begin() + numOfSamples, sums.end(), expected.begin() + numOfSamples)) << "Fail: ResizeKernel::AccumulateRow() writes out of bound";
+            }
+        }
+    }
+
+    // Frames
+    struct VideoTypeCase
+    {
+        GUID VideoType;
+        int Channels;
+        int BytesPerSample;
+    };
+    const std::vector<VideoTypeCase> videoTypeCases = {
+        { MEDIASUBTYPE_RGB24, 3, 1 },
+        { MEDIASUBTYPE_YUY2, 3, 1 },
+        { MEDIASUBTYPE_NV12, 3, 1 },
+        { MEDIASUBTYPE_Y800, 1, 1 },
+        { MEDIASUBTYPE_Y16, 1, 2 },
+        { MEDIASUBTYPE_RGGB, 3, 1 },
+        { MEDIASUBTYPE_MJPG, 3, 1 }
+    };
+    const int width = 70;
+    const int height = 38;
+    struct ResizeCase
+    {
+        int Binning;
+        int ResizeWidth;
+        int ResizeHeight;
+    };
+    const std::vector<ResizeCase> resizeCases = { { 2, 0, 0 }, { 4, 0, 0 }, { 1, 33, 13 }, { 4, width, height } };
+
+    for (const auto& videoTypeCase : videoTypeCases)
+    {
+        const auto videoTypeName = DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType);
+        const int bytesPerPixel = videoTypeCase.Channels * videoTypeCase.BytesPerSample;
+
+        // The MJPG frame is stored in a buffer of 24 bits per pixel
+        auto frame = CreateRandomImage(width * height * 3);
+        if (videoTypeCase.VideoType == MEDIASUBTYPE_MJPG)
+        {
+            const auto jpeg = DirectShowCameraStubJPEGEncoder::Encode(CreateGradientImage(width, height).data(), width, height, false);
+            std::fill(frame.begin(), frame.end(), 0);
+            std::copy(jpeg.begin(), jpeg.end(), frame.begin());
+        }
+
+        for (const bool verticalFlip : { true, false })
+        {
+            for (const bool horizontalMirror : { true, false })
+            {
+                DirectShowCamera::FrameSettings frameSettings;
+                frameSettings.VerticalFlip = verticalFlip;
+                frameSettings.HorizontalMirror = horizontalMirror;
+                std::vector<unsigned char> decoded(width * height * bytesPerPixel);
+                FrameDecoder::DecodeFrame(frame.data(), decoded.data(), videoTypeCase.VideoType, width, height, frameSettings);
+
+                for (const auto& resizeCase : resizeCases)
+                {
+                    frameSettings.Binning = resizeCase.Binning;
+                    frameSettings.ResizeWidth = resizeCase.ResizeWidth;
+                    frameSettings.ResizeHeight = resizeCase.ResizeHeight;
+                    EXPECT_TRUE(FrameDecoder::isResized(frameSettings)) << "Fail: FrameDecoder::isResized()";
+
+                    int decodedWidth = 0;
+                    int decodedHeight = 0;
+                    FrameDecoder::getDecodedSize(width, height, frameSettings, decodedWidth, decodedHeight);
+                    const bool binned = resizeCase.ResizeWidth == 0;
+                    EXPECT_EQ(decodedWidth, binned ? width / resizeCase.Binning : resizeCase.ResizeWidth) << "Fail: FrameDecoder::getDecodedSize() width of " << videoTypeName;
+                    EXPECT_EQ(decodedHeight, binned ? height / resizeCase.Binning : resizeCase.ResizeHeight) << "Fail: FrameDecoder::getDecodedSize() height of " << videoTypeName;
+
+                    std::vector<unsigned char> output(decodedWidth * decodedHeight * bytesPerPixel + 32, 0xCD);
+                    FrameDecoder::DecodeFrame(frame.data(), output.data(), videoTypeCase.VideoType, width, height, frameSettings);
+                    ASSERT_TRUE(std::all_of(output.end() - 32, output.end(), [](const unsigned char value) { return value == 0xCD; }))
+                        << "Fail: FrameDecoder::DecodeFrame() writes out of bound in " << videoTypeName;
+
+                    const int coveredWidth = binned ? decodedWidth * resizeCase.Binning : width;
+                    const int coveredHeight = binned ? decodedHeight * resizeCase.Binning : height;
+                    const auto reference = videoTypeCase.BytesPerSample == 2 ?
+                        ResizeAreaReference((const unsigned short*)decoded.data(), width, videoTypeCase.Channels, coveredWidth, coveredHeight, decodedWidth, decodedHeight) :
+                        ResizeAreaReference(decoded.data(), width, videoTypeCase.Channels, coveredWidth, coveredHeight, decodedWidth, decodedHeight);
+                    for (int i = 0; i < (int)reference.size(); i++)
+                    {
+                        const int value = videoTypeCase.BytesPerSample == 2 ? ((const unsigned short*)output.data())[i] : output[i];
+                        if (binned)
+                        {
+                            ASSERT_EQ(value, (int)std::floor(reference[i] + 0.5))
+                                << "Fail: FrameDecoder::DecodeFrame() in a binning of " << resizeCase.Binning << " of " << videoTypeName << " at " << i
+                                << ", verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror;
+                        }
+                        else
+                        {
+                            ASSERT_LE(std::abs(value - reference[i]), videoTypeCase.BytesPerSample == 2 ? 2.0 * 257 : 2.0)
+                                << "Fail: FrameDecoder::DecodeFrame() in a resize of " << decodedWidth << "x" << decodedHeight << " of " << videoTypeName << " at " << i
+                                << ", verticalFlip = " << verticalFlip << ", horizontalMirror = " << horizontalMirror;
+                        }
+                    }
+
+                    // Parallel
+                    FrameDecoder::setParallelDecodeMinFrameSize(0);
+                    FrameDecoder::setNumOfDecodeThreads(4);
+                    std::vector<unsigned char> parallel(output.size(), 0xCD);
+                    FrameDecoder::DecodeFrame(frame.data(), parallel.data(), videoTypeCase.VideoType, width, height, frameSettings);
+                    FrameDecoder::setNumOfDecodeThreads(1);
+                    FrameDecoder::setParallelDecodeMinFrameSize(1920 * 1080);
+                    EXPECT_EQ(parallel, output) << "Fail: FrameDecoder::DecodeFrame() of " << videoTypeName << " in 4 threads";
+                }
+            }
+        }
+    }
+
+    // Tone map
+    {
+        const auto frame = CreateRandomImage(width * height * 2);
+        DirectShowCamera::FrameSettings frameSettings;
+        const auto toneMapped = FrameDecoder::Decode16BitMonochromeFrameTo8Bit(frame.data(), MEDIASUBTYPE_Y16, width, height, DirectShowCamera::ToneMapSettings(), frameSettings);
+        frameSettings.Binning = 2;
+        const auto binned = FrameDecoder::Decode16BitMonochromeFrameTo8Bit(frame.data(), MEDIASUBTYPE_Y16, width, height, DirectShowCamera::ToneMapSettings(), frameSettings);
+        const auto reference = ResizeAreaReference(toneMapped.get(), width, 1, width, height, width / 2, height / 2);
+        for (int i = 0; i < (int)reference.size(); i++)
+        {
+            ASSERT_EQ(binned[i], (int)std::floor(reference[i] + 0.5)) << "Fail: FrameDecoder::Decode16BitMonochromeFrameTo8Bit() in a binning of 2 at " << i;
+        }
+    }
+
+    // Invalid
+    const auto frame = CreateRandomImage(width * height * 3);
+    std::vector<unsigned char> output(width * height * 3);
+    DirectShowCamera::FrameSettings frameSettings;
+    EXPECT_FALSE(FrameDecoder::isResized(frameSettings)) << "Fail: FrameDecoder::isResized() of the default settings";
+    frameSettings.Binning = 3;
+    EXPECT_THROW(FrameDecoder::DecodeFrame(frame.data(), output.data(), MEDIASUBTYPE_RGB24, width, height, frameSettings), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrame() in a binning of 3";
+    frameSettings.Binning = 4;
+    EXPECT_THROW(FrameDecoder::DecodeFrame(frame.data(), output.data(), MEDIASUBTYPE_RGB24, 3, 3, frameSettings), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrame() in a binning larger than the frame";
+    frameSettings.Binning = 1;
+    frameSettings.ResizeWidth = width + 1;
+    frameSettings.ResizeHeight = height;
+    EXPECT_THROW(FrameDecoder::DecodeFrame(frame.data(), output.data(), MEDIASUBTYPE_RGB24, width, height, frameSettings), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrame() in a resize larger than the frame";
+    frameSettings.ResizeWidth = width / 2;
+    frameSettings.ResizeHeight = 0;
+    EXPECT_THROW(FrameDecoder::DecodeFrame(frame.data(), output.data(), MEDIASUBTYPE_RGB24, width, height, frameSettings), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrame() in a resize without the height";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder15
+ * <b>Title:</b> Test resize while decoding a 4K frame
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Resize a 3840x2160 frame while it is decoded and after it is decoded
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Decode RGB24, YUY2, NV12 and Y800 frames of 3840x2160 in a binning of 2 and 4 and a resize of 640x360
+ *   2. Decode the frames in full size and resize the decoded frames
+ * <b>Expected Result:</b>
+ *   1. No exception
+ *   2. Same as the output of step 1
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestResizeWhileDecoding)
+{
+    using DirectShowCamera::FrameDecoder;
+
+    const int width = 3840;
+    const int height = 2160;
+    struct VideoTypeCase
+    {
+        GUID VideoType;
+        GUID DecodedVideoType;
+        int BytesPerPixel;
+    };
+    const std::vector<VideoTypeCase> videoTypeCases = {
+        { MEDIASUBTYPE_RGB24, MEDIASUBTYPE_RGB24, 3 },
+        { MEDIASUBTYPE_YUY2, MEDIASUBTYPE_RGB24, 3 },
+        { MEDIASUBTYPE_NV12, MEDIASUBTYPE_RGB24, 3 },
+        { MEDIASUBTYPE_Y800, MEDIASUBTYPE_Y800, 1 }
+    };
+    struct ResizeCase
+    {
+        int Binning;
+        int ResizeWidth;
+        int ResizeHeight;
+    };
+    const std::vector<ResizeCase> resizeCases = { { 2, 0, 0 }, { 4, 0, 0 }, { 1, 640, 360 } };
+
+    const auto frame = CreateRandomImage(width * height * 3);
+    for (const auto& videoTypeCase : videoTypeCases)
+    {
+        const auto videoTypeName = DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType);
+        std::vector<unsigned char> decoded(width * height * videoTypeCase.BytesPerPixel);
+
+        for (const auto& resizeCase : resizeCases)
+        {
+            DirectShowCamera::FrameSettings frameSettings;
+            frameSettings.Binning = resizeCase.Binning;
+            frameSettings.ResizeWidth = resizeCase.ResizeWidth;
+            frameSettings.ResizeHeight = resizeCase.ResizeHeight;
+            int decodedWidth = 0;
+            int decodedHeight = 0;
+            FrameDecoder::getDecodedSize(width, height, frameSettings, decodedWidth, decodedHeight);
+            std::vector<unsigned char> fusedOutput(decodedWidth * decodedHeight * videoTypeCase.BytesPerPixel);
+            std::vector<unsigned char> output(fusedOutput.size());
+
+            // Resize while decoding
+            FrameDecoder::DecodeFrame(frame.data(), fusedOutput.data(), videoTypeCase.VideoType, width, height, frameSettings);
+
+            // Decode, then resize the decoded frame. The decoded rows are stored from the top, so the copy keeps the order by the vertical flip.
+            DirectShowCamera::FrameSettings decodedFrameSettings = frameSettings;
+            decodedFrameSettings.VerticalFlip = true;
+            FrameDecoder::DecodeFrame(frame.data(), decoded.data(), videoTypeCase.VideoType, width, height, DirectShowCamera::FrameSettings());
+            FrameDecoder::DecodeFrame(decoded.data(), output.data(), videoTypeCase.DecodedVideoType, width, height, decodedFrameSettings);
+
+            EXPECT_EQ(output, fusedOutput) << "Fail: Resize of " << videoTypeName << " to " << decodedWidth << "x" << decodedHeight;
+        }
+    }
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder16
+ * <b>Title:</b> Test decode into a destination
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Decode frames of each family into a tile of a padded canvas
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Decode random RGB24, RGB565, YUY2, NV12, Y800, Y16, Y10P, RGGB and MJPG frames into a tile of a canvas with padded rows, with every combination of vertical flip and horizontal mirror, without and with a binning of 2, and in 4 threads
+ *   2. Decode the color frames into a canvas of RGB24 and BGR24
+ *   3. Tone map a random Y16 frame into a tile
+ *   4. Decode into invalid destinations
+ * <b>Expected Result:</b>
+ *   1. The tile is the same as FrameDecoder::DecodeFrame() into a packed buffer, the pixels outside the tile and the padding are not written
+ *   2. The channel order follows the pixel format of the canvas regardless of FrameSettings::BGR
+ *   3. The tile is the same as FrameDecoder::Decode16BitMonochromeFrameTo8Bit()
+ *   4. Throw std::invalid_argument if the data is nullptr, the tile is outside the canvas, the row stride is smaller than the width or the pixel format doesn't match the video type
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestDecodeToDestination)
+{
+    using DirectShowCamera::DirectShowCameraStubJPEGEncoder;
+    using DirectShowCamera::FrameDecoder;
+    using DirectShowCamera::FrameDestination;
+    using DirectShowCamera::FramePixelFormat;
+
+    const int width = 64;
+    const int height = 36;
+    const int canvasWidth = 150;
+    const int canvasHeight = 90;
+    const int tileX = 37;
+    const int tileY = 21;
+
+    // Check a tile of a canvas against a packed image, and the bytes outside the tile are not written
+    const auto checkTile = [&](const std::vector<unsigned char>& canvas, const FrameDestination& destination, const std::vector<unsigned char>& expected, const int tileWidth, const int tileHeight, const std::string& name)
+    {
+        const int bytesPerPixel = destination.getBytesPerPixel();
+        const int bytesPerRow = destination.getBytesPerRow();
+        for (int y = 0; y < canvasHeight; y++)
+        {
+            for (int x = 0; x < bytesPerRow; x++)
+            {
+                const bool inside = y >= destination.Y && y < destination.Y + tileHeight && x >= destination.X * bytesPerPixel && x < (destination.X + tileWidth) * bytesPerPixel;
+                const unsigned char value = canvas[y * bytesPerRow + x];
+                const unsigned char expectedValue = inside ? expected[(y - destination.Y) * tileWidth * bytesPerPixel + x - destination.X * bytesPerPixel] : 0xCD;
+                ASSERT_EQ(value, expectedValue) << "Fail: " << name << " at byte " << x << " of row " << y << (inside ? "" : " outside the tile");
+            }
+        }
+    };
+
+    struct VideoTypeCase
+    {
+        GUID VideoType;
+        FramePixelFormat PixelFormat;
+    };
+    const std::vector<VideoTypeCase> videoTypeCases = {
+        { MEDIASUBTYPE_RGB24, FramePixelFormat::BGR24 },
+        { MEDIASUBTYPE_RGB565, FramePixelFormat::RGB24 },
+        { MEDIASUBTYPE_YUY2, FramePixelFormat::BGR24 },
+        { MEDIASUBTYPE_NV12, FramePixelFormat::RGB24 },
+        { MEDIASUBTYPE_Y800, FramePixelFormat::Gray8 },
+        { MEDIASUBTYPE_Y16, FramePixelFormat::Gray16 },
+        { MEDIASUBTYPE_Y10P, FramePixelFormat::Gray16 },
+        { MEDIASUBTYPE_RGGB, FramePixelFormat::BGR24 },
+        { MEDIASUBTYPE_MJPG, FramePixelFormat::RGB24 }
+    };
+    for (const auto& videoTypeCase : videoTypeCases)
+    {
+        const auto videoTypeName = DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType);
+
+        // The MJPG frame is stored in a buffer of 24 bits per pixel
+        auto frame = CreateRandomImage(width * height * 3);
+        if (videoTypeCase.VideoType == MEDIASUBTYPE_MJPG)
+        {
+            const auto jpeg = DirectShowCameraStubJPEGEncoder::Encode(CreateGradientImage(width, height).data(), width, height, false, 90, 0);
+            std::fill(frame.begin(), frame.end(), 0);
+            std::copy(jpeg.begin(), jpeg.end(), frame.begin());
+        }
+
+        FrameDestination destination;
+        destination.Width = canvasWidth;
+        destination.Height = canvasHeight;
+        destination.PixelFormat = videoTypeCase.PixelFormat;
+        destination.BytesPerRow = canvasWidth * destination.getBytesPerPixel() + 40;
+        destination.X = tileX;
+        destination.Y = tileY;
+        std::vector<unsigned char> canvas(destination.BytesPerRow * canvasHeight);
+        destination.Data = canvas.data();
+
+        for (const bool verticalFlip : { true, false })
+        {
+            for (const bool horizontalMirror : { true, false })
+            {
+                for (const int binning : { 1, 2 })
+                {
+                    DirectShowCamera::FrameSettings frameSettings;
+                    frameSettings.VerticalFlip = verticalFlip;
+                    frameSettings.HorizontalMirror = horizontalMirror;
+                    frameSettings.Binning = binning;
+                    frameSettings.BGR = videoTypeCase.PixelFormat == FramePixelFormat::BGR24;
+                    std::vector<unsigned char> expected(width * height * destination.getBytesPerPixel());
+                    FrameDecoder::DecodeFrame(frame.data(), expected.data(), videoTypeCase.VideoType, width, height, frameSettings);
+                    const auto name = "FrameDecoder::DecodeFrame() of " + videoTypeName + " into a destination, verticalFlip = " + std::to_string(verticalFlip) +
+                        ", horizontalMirror = " + std::to_string(horizontalMirror) + ", binning = " + std::to_string(binning);
+
+                    // The pixel format of the destination overrides BGR
+                    frameSettings.BGR = !frameSettings.BGR;
+                    std::fill(canvas.begin(), canvas.end(), 0xCD);
+                    FrameDecoder::DecodeFrame(frame.data(), destination, videoTypeCase.VideoType, width, height, frameSettings);
+                    checkTile(canvas, destination, expected, width / binning, height / binning, name);
+
+                    // Parallel
+                    FrameDecoder::setParallelDecodeMinFrameSize(0);
+                    FrameDecoder::setNumOfDecodeThreads(4);
+                    std::fill(canvas.begin(), canvas.end(), 0xCD);
+                    FrameDecoder::DecodeFrame(frame.data(), destination, videoTypeCase.VideoType, width, height, frameSettings);
+                    FrameDecoder::setNumOfDecodeThreads(1);
+                    FrameDecoder::setParallelDecodeMinFrameSize(1920 * 1080);
+                    checkTile(canvas, destination, expected, width / binning, height / binning, name + " in 4 threads");
+                }
+            }
+        }
+
+        // Pixel format
+        EXPECT_EQ(FrameDecoder::getDecodedPixelFormat(videoTypeCase.VideoType, DirectShowCamera::FrameSettings()),
+            videoTypeCase.PixelFormat == FramePixelFormat::RGB24 ? FramePixelFormat::BGR24 : videoTypeCase.PixelFormat) << "Fail: FrameDecoder::getDecodedPixelFormat() of " << videoTypeName;
+    }
+
+    // Tone map
+    {
+        const auto frame = CreateRandomImage(width * height * 2);
+        const auto expected = FrameDecoder::Decode16BitMonochromeFrameTo8Bit(frame.data(), MEDIASUBTYPE_Y16, width, height, DirectShowCamera::ToneMapSettings());
+        FrameDestination destination;
+        destination.Width = canvasWidth;
+        destination.Height = canvasHeight;
+        destination.PixelFormat = FramePixelFormat::Gray8;
+        destination.X = tileX;
+        destination.Y = tileY;
+        std::vector<unsigned char> canvas(canvasWidth * canvasHeight, 0xCD);
+        destination.Data = canvas.data();
+        FrameDecoder::Decode16BitMonochromeFrameTo8Bit(frame.data(), destination, MEDIASUBTYPE_Y16, width, height, DirectShowCamera::ToneMapSettings());
+        checkTile(canvas, destination, std::vector<unsigned char>(expected.get(), expected.get() + width * height), width, height, "FrameDecoder::Decode16BitMonochromeFrameTo8Bit() into a destination");
+
+        destination.PixelFormat = FramePixelFormat::Gray16;
+        EXPECT_THROW(FrameDecoder::Decode16BitMonochromeFrameTo8Bit(frame.data(), destination, MEDIASUBTYPE_Y16, width, height, DirectShowCamera::ToneMapSettings()), std::invalid_argument)
+            << "Fail: FrameDecoder::Decode16BitMonochromeFrameTo8Bit() into a Gray16 destination";
+    }
+
+    // Invalid
+    const auto frame = CreateRandomImage(width * height * 3);
+    std::vector<unsigned char> canvas(canvasWidth * canvasHeight * 3);
+    FrameDestination destination;
+    destination.Width = canvasWidth;
+    destination.Height = canvasHeight;
+    EXPECT_THROW(FrameDecoder::DecodeFrame(frame.data(), destination, MEDIASUBTYPE_RGB24, width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrame() into a nullptr";
+    destination.Data = canvas.data();
+    destination.X = canvasWidth - width + 1;
+    EXPECT_THROW(FrameDecoder::DecodeFrame(frame.data(), destination, MEDIASUBTYPE_RGB24, width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrame() outside the destination";
+    destination.X = -1;
+    EXPECT_THROW(FrameDecoder::DecodeFrame(frame.data(), destination, MEDIASUBTYPE_RGB24, width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrame() at a negative X";
+    destination.X = 0;
+    destination.BytesPerRow = canvasWidth * 3 - 1;
+    EXPECT_THROW(FrameDecoder::DecodeFrame(frame.data(), destination, MEDIASUBTYPE_RGB24, width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrame() in a row stride smaller than the width";
+    destination.BytesPerRow = 0;
+    destination.PixelFormat = FramePixelFormat::Gray8;
+    EXPECT_THROW(FrameDecoder::DecodeFrame(frame.data(), destination, MEDIASUBTYPE_RGB24, width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrame() of RGB24 into Gray8";
+    destination.PixelFormat = FramePixelFormat::BGR24;
+    EXPECT_THROW(FrameDecoder::DecodeFrame(frame.data(), destination, MEDIASUBTYPE_Y16, width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrame() of Y16 into BGR24";
+    EXPECT_NO_THROW(FrameDecoder::DecodeFrame(frame.data(), destination, MEDIASUBTYPE_RGB24, width, height)) << "Fail: FrameDecoder::DecodeFrame() into a packed destination";
+}
+
+/**
+ * @brief Compute the statistics of a decoded frame pixel by pixel as a reference
+ * @param[in] data Decoded data. Rows are stored from the top and packed.
+ * @param[in] width Width
+ * @param[in] height Height
+ * @param[in] channels Samples per pixel
+ * @param[in] bitDepth Bit depth. The samples are 16 bit if it is > 8.
+ * @param[in] sampleStep Sample every n-th pixel of every n-th row
+ * @return Return the statistics
+*/
+static DirectShowCamera::FrameStatistics ComputeStatisticsReference(const unsigned char* data, const int width, const int height, const int channels, const int bitDepth, const int sampleStep)
+{
+    const auto samples16 = (const unsigned short*)data;
+    const int saturatedSample = (1 << bitDepth) - 1;
+
+    DirectShowCamera::FrameStatistics statistics;
+    statistics.Channels = channels;
+    statistics.BitDepth = bitDepth;
+    statistics.Mins.fill(65536);
+    std::vector<double> sums(channels, 0.0);
+    for (int y = 0; y < height; y += sampleStep)
+    {
+        for (int x = 0; x < width; x += sampleStep)
+        {
+            bool saturated = false;
+            for (int c = 0; c < channels; c++)
+            {
+                const int i = (y * width + x) * channels + c;
+                const int sample = bitDepth > 8 ? samples16[i] : data[i];
+                statistics.Histograms[c][std::min(sample >> (bitDepth - 8), 255)]++;
+                sums[c] += sample;
+                statistics.Mins[c] = std::min(statistics.Mins[c], sample);
+                statistics.Maxs[c] = std::max(statistics.Maxs[c], sample);
+                if (sample >= saturatedSample)
+                {
+                    statistics.NumOfSaturatedSamples[c]++;
+                    saturated = true;
+                }
+            }
+            if (saturated) statistics.NumOfSaturatedPixels++;
+            statistics.NumOfPixels++;
+        }
+    }
+    for (int c = 0; c < channels; c++)
+    {
+        statistics.Means[c] = sums[c] / statistics.NumOfPixels;
+    }
+    return statistics;
+}
+
+/**
+ * @brief Check the statistics against a reference
+ * @param[in] statistics Statistics
+ * @param[in] expected Expected statistics
+ * @param[in] name Name of the case in the failure message
+*/
+static void ExpectStatisticsEqual(const DirectShowCamera::FrameStatistics& statistics, const DirectShowCamera::FrameStatistics& expected, const std::string& name)
+{
+    ASSERT_EQ(statistics.Channels, expected.Channels) << "Fail: " << name << " channels";
+    EXPECT_EQ(statistics.BitDepth, expected.BitDepth) << "Fail: " << name << " bit depth";
+    EXPECT_EQ(statistics.NumOfPixels, expected.NumOfPixels) << "Fail: " << name << " number of pixels";
+    EXPECT_EQ(statistics.NumOfSaturatedPixels, expected.NumOfSaturatedPixels) << "Fail: " << name << " number of saturated pixels";
+    for (int c = 0; c < expected.Channels; c++)
+    {
+        EXPECT_EQ(statistics.Histograms[c], expected.Histograms[c]) << "Fail: " << name << " histogram of channel " << c;
+        EXPECT_NEAR(statistics.Means[c], expected.Means[c], 1e-9 * std::max(1.0, expected.Means[c])) << "Fail: " << name << " mean of channel " << c;
+        EXPECT_EQ(statistics.Mins[c], expected.Mins[c]) << "Fail: " << name << " minimum of channel " << c;
+        EXPECT_EQ(statistics.Maxs[c], expected.Maxs[c]) << "Fail: " << name << " maximum of channel " << c;
+        EXPECT_EQ(statistics.NumOfSaturatedSamples[c], expected.NumOfSaturatedSamples[c]) << "Fail: " << name << " number of saturated samples of channel " << c;
+    }
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder17
+ * <b>Title:</b> Test statistics while decoding
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Accumulate the statistics of frames of each family while they are decoded
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Accumulate random rows of 8 bit gray, 8 bit color and 12-bit samples with garbage in the unused bits by StatisticsKernel, in one accumulator and merged from 2 accumulators
+ *   2. Decode random RGB24, RGB565, YUY2, NV12, Y800, Y16, Y10P, RGGB and MJPG frames with FrameStatisticsMode::Full and FrameStatisticsMode::Sparse, without and with a binning of 2, and in 4 threads
+ *   3. Decode into a destination with padded rows
+ *   4. Decode a saturated frame and decode with FrameStatisticsMode::None
+ *   5. Create accumulators with invalid arguments
+ * <b>Expected Result:</b>
+ *   1. Same as the statistics computed pixel by pixel
+ *   2. Same as the statistics computed pixel by pixel from the decoded frame. The decoded frame is the same as without statistics.
+ *   3. Same as step 2
+ *   4. The saturated fraction is 1. No statistics are accumulated in FrameStatisticsMode::None.
+ *   5. Throw std::invalid_argument
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestStatistics)
+{
+    using DirectShowCamera::DirectShowCameraStubJPEGEncoder;
+    using DirectShowCamera::FrameDecoder;
+    using DirectShowCamera::FrameStatistics;
+    using DirectShowCamera::FrameStatisticsMode;
+    using DirectShowCamera::StatisticsKernel;
+
+    // Kernel
+    {
+        const int width = 301;
+        const int height = 7;
+        struct KernelCase
+        {
+            int Channels;
+            int BytesPerSample;
+            int BitDepth;
+        };
+        for (const auto& kernelCase : { KernelCase{ 1, 1, 8 }, KernelCase{ 3, 1, 8 }, KernelCase{ 1, 2, 12 }, KernelCase{ 1, 2, 16 } })
+        {
+            for (const int sampleStep : { 1, 3 })
+            {
+                // Saturate a few samples
+                auto data = CreateRandomImage(width * height * kernelCase.Channels * kernelCase.BytesPerSample);
+                for (int i = 0; i < (int)data.size(); i += 17) data[i] = 0xFF;
+                if (kernelCase.BitDepth == 12)
+                {
+                    auto samples = (unsigned short*)data.data();
+                    for (int i = 0; i < width * height; i++) samples[i] = i % 5 == 0 ? samples[i] : samples[i] & 0x0FFF;
+                }
+                const auto name = "StatisticsKernel of " + std::to_string(kernelCase.Channels) + " channels of " + std::to_string(kernelCase.BitDepth) + " bits, sample step " + std::to_string(sampleStep);
+                const int bytesPerRow = width * kernelCase.Channels * kernelCase.BytesPerSample;
+
+                auto accumulator = StatisticsKernel::CreateAccumulator(kernelCase.Channels, kernelCase.BytesPerSample, kernelCase.BitDepth, sampleStep);
+                auto partial = StatisticsKernel::CreateAccumulator(accumulator);
+                auto mergedAccumulator = StatisticsKernel::CreateAccumulator(accumulator);
+                for (int y = 0; y < height; y++)
+                {
+                    if (!StatisticsKernel::isSampledRow(accumulator, y)) continue;
+                    StatisticsKernel::AccumulateRow(data.data() + y * bytesPerRow, width, accumulator);
+                    StatisticsKernel::AccumulateRow(data.data() + y * bytesPerRow, width, y < height / 2 ? mergedAccumulator : partial);
+                }
+                StatisticsKernel::Merge(partial, mergedAccumulator);
+
+                const auto expected = ComputeStatisticsReference(data.data(), width, height, kernelCase.Channels, kernelCase.BitDepth, sampleStep);
+                ExpectStatisticsEqual(StatisticsKernel::getStatistics(accumulator), expected, name);
+                ExpectStatisticsEqual(StatisticsKernel::getStatistics(mergedAccumulator), expected, name + " merged");
+            }
+        }
+    }
+
+    // Decode
+    const int width = 64;
+    const int height = 36;
+    struct VideoTypeCase
+    {
+        GUID VideoType;
+        int Channels;
+        int BitDepth;
+    };
+    const std::vector<VideoTypeCase> videoTypeCases = {
+        { MEDIASUBTYPE_RGB24, 3, 8 },
+        { MEDIASUBTYPE_RGB565, 3, 8 },
+        { MEDIASUBTYPE_YUY2, 3, 8 },
+        { MEDIASUBTYPE_NV12, 3, 8 },
+        { MEDIASUBTYPE_Y800, 1, 8 },
+        { MEDIASUBTYPE_Y16, 1, 16 },
+        { MEDIASUBTYPE_Y10P, 1, 10 },
+        { MEDIASUBTYPE_RGGB, 3, 8 },
+        { MEDIASUBTYPE_MJPG, 3, 8 }
+    };
+    for (const auto& videoTypeCase : videoTypeCases)
+    {
+        const auto videoTypeName = DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType);
+
+        // The MJPG frame is stored in a buffer of 24 bits per pixel
+        auto frame = CreateRandomImage(width * height * 3);
+        if (videoTypeCase.VideoType == MEDIASUBTYPE_MJPG)
+        {
+            const auto jpeg = DirectShowCameraStubJPEGEncoder::Encode(CreateGradientImage(width, height).data(), width, height, false, 90, 0);
+            std::fill(frame.begin(), frame.end(), 0);
+            std::copy(jpeg.begin(), jpeg.end(), frame.begin());
+        }
+
+        const int bytesPerPixel = videoTypeCase.Channels * (videoTypeCase.BitDepth > 8 ? 2 : 1);
+        for (const auto mode : { FrameStatisticsMode::Full, FrameStatisticsMode::Sparse })
+        {
+            for (const int binning : { 1, 2 })
+            {
+                DirectShowCamera::FrameSettings frameSettings;
+                frameSettings.Binning = binning;
+                frameSettings.StatisticsSampleStep = 3;
+                const int decodedWidth = width / binning;
+                const int decodedHeight = height / binning;
+                std::vector<unsigned char> expectedOutput(decodedWidth * decodedHeight * bytesPerPixel);
+                FrameDecoder::DecodeFrame(frame.data(), expectedOutput.data(), videoTypeCase.VideoType, width, height, frameSettings);
+                const auto expected = ComputeStatisticsReference(expectedOutput.data(), decodedWidth, decodedHeight, videoTypeCase.Channels, videoTypeCase.BitDepth, mode == FrameStatisticsMode::Sparse ? 3 : 1);
+                const auto name = "FrameDecoder::DecodeFrame() statistics of " + videoTypeName + ", " + (mode == FrameStatisticsMode::Sparse ? "sparse" : "full") + ", binning = " + std::to_string(binning);
+
+                frameSettings.Statistics = mode;
+                FrameStatistics statistics;
+                std::vector<unsigned char> output(expectedOutput.size());
+                FrameDecoder::DecodeFrame(frame.data(), output.data(), videoTypeCase.VideoType, width, height, frameSettings, &statistics);
+                EXPECT_EQ(output, expectedOutput) << "Fail: " << name << " output";
+                ExpectStatisticsEqual(statistics, expected, name);
+
+                // Parallel
+                FrameDecoder::setParallelDecodeMinFrameSize(0);
+                FrameDecoder::setNumOfDecodeThreads(4);
+                FrameDecoder::DecodeFrame(frame.data(), output.data(), videoTypeCase.VideoType, width, height, frameSettings, &statistics);
+                FrameDecoder::setNumOfDecodeThreads(1);
+                FrameDecoder::setParallelDecodeMinFrameSize(1920 * 1080);
+                ExpectStatisticsEqual(statistics, expected, name + " in 4 threads");
+
+                // Destination with padded rows
+                DirectShowCamera::FrameDestination destination;
+                destination.Width = decodedWidth;
+                destination.Height = decodedHeight;
+                destination.PixelFormat = FrameDecoder::getDecodedPixelFormat(videoTypeCase.VideoType, frameSettings);
+                destination.BytesPerRow = decodedWidth * bytesPerPixel + 24;
+                std::vector<unsigned char> canvas(destination.BytesPerRow * decodedHeight, 0xFF);
+                destination.Data = canvas.data();
+                FrameDecoder::DecodeFrame(frame.data(), destination, videoTypeCase.VideoType, width, height, frameSettings, &statistics);
+                ExpectStatisticsEqual(statistics, expected, name + " into a destination");
+            }
+        }
+    }
+
+    // Saturated
+    DirectShowCamera::FrameSettings frameSettings;
+    frameSettings.Statistics = FrameStatisticsMode::Full;
+    const std::vector<unsigned char> saturatedFrame(width * height * 3, 0xFF);
+    std::vector<unsigned char> output(width * height * 3);
+    FrameStatistics statistics;
+    FrameDecoder::DecodeFrame(saturatedFrame.data(), output.data(), MEDIASUBTYPE_RGB24, width, height, frameSettings, &statistics);
+    EXPECT_EQ(statistics.getSaturatedFraction(), 1.0) << "Fail: FrameStatistics::getSaturatedFraction() of a saturated frame";
+    EXPECT_EQ(statistics.Means[1], 255.0) << "Fail: FrameStatistics::Means of a saturated frame";
+
+    // None
+    frameSettings.Statistics = FrameStatisticsMode::None;
+    FrameDecoder::DecodeFrame(saturatedFrame.data(), output.data(), MEDIASUBTYPE_RGB24, width, height, frameSettings, &statistics);
+    EXPECT_EQ(statistics.Channels, 0) << "Fail: FrameDecoder::DecodeFrame() statistics in FrameStatisticsMode::None";
+    EXPECT_EQ(statistics.getSaturatedFraction(), 0.0) << "Fail: FrameStatistics::getSaturatedFraction() in FrameStatisticsMode::None";
+
+    // Invalid
+    EXPECT_THROW(StatisticsKernel::CreateAccumulator(2, 1, 8, 1), std::invalid_argument) << "Fail: StatisticsKernel::CreateAccumulator() of 2 channels";
+    EXPECT_THROW(StatisticsKernel::CreateAccumulator(3, 2, 16, 1), std::invalid_argument) << "Fail: StatisticsKernel::CreateAccumulator() of 3 channels of 16 bits";
+    EXPECT_THROW(StatisticsKernel::CreateAccumulator(1, 1, 10, 1), std::invalid_argument) << "Fail: StatisticsKernel::CreateAccumulator() of 10 bits in 1 byte";
+    EXPECT_THROW(StatisticsKernel::CreateAccumulator(1, 2, 17, 1), std::invalid_argument) << "Fail: StatisticsKernel::CreateAccumulator() of 17 bits";
+    EXPECT_THROW(StatisticsKernel::CreateAccumulator(1, 1, 8, 0), std::invalid_argument) << "Fail: StatisticsKernel::CreateAccumulator() of sample step 0";
+    frameSettings.Statistics = FrameStatisticsMode::Sparse;
+    frameSettings.StatisticsSampleStep = 0;
+    EXPECT_THROW(FrameDecoder::DecodeFrame(saturatedFrame.data(), output.data(), MEDIASUBTYPE_RGB24, width, height, frameSettings, &statistics), std::invalid_argument)
+        << "Fail: FrameDecoder::DecodeFrame() with FrameSettings::StatisticsSampleStep of 0";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder18
+ * <b>Title:</b> Test statistics while decoding a 4K frame
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Decode a 3840x2160 frame without statistics, with sparse statistics and with full statistics
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Decode RGB24, YUY2, NV12, Y800 and Y16 frames of 3840x2160 in FrameStatisticsMode::None, FrameStatisticsMode::Sparse and FrameStatisticsMode::Full
+ * <b>Expected Result:</b>
+ *   1. The decoded frame is the same in all modes. The statistics count the sampled pixels.
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestStatisticsWhileDecoding)
+{
+    using DirectShowCamera::FrameDecoder;
+    using DirectShowCamera::FrameStatisticsMode;
+
+    const int width = 3840;
+    const int height = 2160;
+    struct VideoTypeCase
+    {
+        GUID VideoType;
+        int BytesPerPixel;
+    };
+    const std::vector<VideoTypeCase> videoTypeCases = {
+        { MEDIASUBTYPE_RGB24, 3 },
+        { MEDIASUBTYPE_YUY2, 3 },
+        { MEDIASUBTYPE_NV12, 3 },
+        { MEDIASUBTYPE_Y800, 1 },
+        { MEDIASUBTYPE_Y16, 2 }
+    };
+
+    const auto frame = CreateRandomImage(width * height * 3);
+    for (const auto& videoTypeCase : videoTypeCases)
+    {
+        const auto videoTypeName = DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType);
+        std::vector<unsigned char> expectedOutput(width * height * videoTypeCase.BytesPerPixel);
+        std::vector<unsigned char> output(expectedOutput.size());
+        FrameDecoder::DecodeFrame(frame.data(), expectedOutput.data(), videoTypeCase.VideoType, width, height, DirectShowCamera::FrameSettings());
+
+        for (const auto mode : { FrameStatisticsMode::None, FrameStatisticsMode::Sparse, FrameStatisticsMode::Full })
+        {
+            DirectShowCamera::FrameSettings frameSettings;
+            frameSettings.Statistics = mode;
+            DirectShowCamera::FrameStatistics statistics;
+            FrameDecoder::DecodeFrame(frame.data(), output.data(), videoTypeCase.VideoType, width, height, frameSettings, &statistics);
+
+            const auto modeName = mode == FrameStatisticsMode::None ? "none" : (mode == FrameStatisticsMode::Sparse ? "sparse" : "full");
+            EXPECT_EQ(output, expectedOutput) << "Fail: Decode of " << videoTypeName << " with statistics " << modeName;
+
+            const int sampleStep = mode == FrameStatisticsMode::Sparse ? frameSettings.StatisticsSampleStep : 1;
+            const long long numOfPixels = mode == FrameStatisticsMode::None ? 0 : (long long)((width + sampleStep - 1) / sampleStep) * ((height + sampleStep - 1) / sampleStep);
+            EXPECT_EQ(statistics.NumOfPixels, numOfPixels) << "Fail: Number of pixels of " << videoTypeName << " with statistics " << modeName;
+        }
+    }
+}
+
+/**
+ * @brief Convert a decoded frame into the planes of a tensor pixel by pixel as a reference
+ * @param[in] data Decoded data. Rows are stored from the top and packed.
+ * @param[in] width Width of the decoded frame
+ * @param[in] height Height of the decoded frame
+ * @param[in] channels Samples per pixel
+ * @param[in] bitDepth Bit depth. The samples are 16 bit if it is > 8.
+ * @param[in] destination Destination. The size, the channels, the mean, the standard deviation and the padded sample are used.
+ * @param[in] x X of the frame in the tensor
+ * @param[in] y Y of the frame in the tensor
+ * @return Return the elements of all planes
+*/
+static std::vector<double> ConvertTensorReference(
+    const unsigned char* data,
+    const int width,
+    const int height,
+    const int channels,
+    const int bitDepth,
+    const DirectShowCamera::TensorDestination& destination,
+    const int x,
+    const int y
+)
+{
+    const auto samples16 = (const unsigned short*)data;
+    const double maxSample = (double)((1 << bitDepth) - 1);
+
+    std::vector<double> result((size_t)destination.Channels * destination.Width * destination.Height);
+    for (int p = 0; p < destination.Channels; p++)
+    {
+        for (int tensorY = 0; tensorY < destination.Height; tensorY++)
+        {
+            for (int tensorX = 0; tensorX < destination.Width; tensorX++)
+            {
+                double value = destination.PadValue;
+                if (tensorX >= x && tensorX < x + width && tensorY >= y && tensorY < y + height)
+                {
+                    const int i = ((tensorY - y) * width + tensorX - x) * channels + (channels == 1 ? 0 : p);
+                    value = (bitDepth > 8 ? samples16[i] : data[i]) / maxSample;
+                }
+                result[((size_t)p * destination.Height + tensorY) * destination.Width + tensorX] = (value - destination.Mean[p]) / destination.Std[p];
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Check the elements of a tensor against a reference. The half precision elements are compared in the precision of a half.
+ * @param[in] tensor Tensor data
+ * @param[in] dataType Element type
+ * @param[in] expected Expected elements
+ * @param[in] name Name of the case in the failure message
+*/
+static void ExpectTensorNear(const std::vector<unsigned char>& tensor, const DirectShowCamera::TensorDataType dataType, const std::vector<double>& expected, const std::string& name)
+{
+    using DirectShowCamera::TensorDataType;
+    using DirectShowCamera::TensorKernel;
+
+    const bool isHalf = dataType == TensorDataType::Float16;
+    ASSERT_EQ(tensor.size(), expected.size() * (isHalf ? 2 : 4)) << "Fail: " << name << " size";
+    int numOfErrors = 0;
+    for (size_t i = 0; i < expected.size() && numOfErrors < 10; i++)
+    {
+        const double element = isHalf ? TensorKernel::HalfToFloat(((const unsigned short*)tensor.data())[i]) : ((const float*)tensor.data())[i];
+        const double tolerance = isHalf ? 1e-3 * std::abs(expected[i]) + 1e-6 : 1e-5 * std::max(1.0, std::abs(expected[i]));
+        if (std::abs(element - expected[i]) > tolerance)
+        {
+            ADD_FAILURE() << "Fail: " << name << " element " << i << " is " << element << ", expected " << expected[i];
+            numOfErrors++;
+        }
+    }
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder19
+ * <b>Title:</b> Test decoding into a tensor
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Decode frames of each family into the normalized planes of a float and a half precision tensor
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Convert floats to half precision, including ties, overflows and subnormals, and convert all half precisions to float and back
+ *   2. Split random rows of 8 bit gray, 8 bit color and 12-bit samples into 1 or 3 planes of float and half precision by TensorKernel in each SIMD level
+ *   3. Get the region of frames in tensors with and without the letterbox
+ *   4. Decode random RGB24, YUY2, NV12, Y800, Y16, RGGB and MJPG frames into letterbox, stretched and larger tensors, in R, G, B and B, G, R order, with a binning, and in 4 threads
+ *   5. Decode with invalid tensors
+ * <b>Expected Result:</b>
+ *   1. Rounded to the nearest even. The half precisions are the same after the round trip.
+ *   2. Same as the scalar kernel, which is the same as the normalization computed pixel by pixel
+ *   3. The frame is shrunk to fit the tensor and centered. The aspect ratio is kept with the letterbox.
+ *   4. Same as the frame decoded in the size of the region and normalized pixel by pixel. The binning is ignored. The tensor is the same in 4 threads.
+ *   5. Throw std::invalid_argument
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestTensor)
+{
+    using DirectShowCamera::DirectShowCameraStubJPEGEncoder;
+    using DirectShowCamera::FrameDecoder;
+    using DirectShowCamera::SIMDLevel;
+    using DirectShowCamera::TensorDataType;
+    using DirectShowCamera::TensorDestination;
+    using DirectShowCamera::TensorKernel;
+
+    // Half precision
+    EXPECT_EQ(TensorKernel::FloatToHalf(0.0f), 0x0000) << "Fail: TensorKernel::FloatToHalf() of 0";
+    EXPECT_EQ(TensorKernel::FloatToHalf(-0.0f), 0x8000) << "Fail: TensorKernel::FloatToHalf() of -0";
+    EXPECT_EQ(TensorKernel::FloatToHalf(1.0f), 0x3C00) << "Fail: TensorKernel::FloatToHalf() of 1";
+    EXPECT_EQ(TensorKernel::FloatToHalf(-2.0f), 0xC000) << "Fail: TensorKernel::FloatToHalf() of -2";
+    EXPECT_EQ(TensorKernel::FloatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3C00) << "Fail: TensorKernel::FloatToHalf() of a tie to an even mantissa";
+    EXPECT_EQ(TensorKernel::FloatToHalf(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3C02) << "Fail: TensorKernel::FloatToHalf() of a tie to an odd mantissa";
+    EXPECT_EQ(TensorKernel::FloatToHalf(65504.0f), 0x7BFF) << "Fail: TensorKernel::FloatToHalf() of the largest half";
+    EXPECT_EQ(TensorKernel::FloatToHalf(65519.0f), 0x7BFF) << "Fail: TensorKernel::FloatToHalf() below the overflow";
+    EXPECT_EQ(TensorKernel::FloatToHalf(65520.0f), 0x7C00) << "Fail: TensorKernel::FloatToHalf() of the overflow";
+    EXPECT_EQ(TensorKernel::FloatToHalf(-1e10f), 0xFC00) << "Fail: TensorKernel::FloatToHalf() of a large negative";
+    EXPECT_EQ(TensorKernel::FloatToHalf(std::ldexp(1.0f, -24)), 0x0001) << "Fail: TensorKernel::FloatToHalf() of the smallest subnormal";
+    EXPECT_EQ(TensorKernel::FloatToHalf(std::ldexp(1.0f, -25)), 0x0000) << "Fail: TensorKernel::FloatToHalf() of a tie to 0";
+    EXPECT_EQ(TensorKernel::FloatToHalf(3 * std::ldexp(1.0f, -26)), 0x0001) << "Fail: TensorKernel::FloatToHalf() of a subnormal rounded up";
+    EXPECT_EQ(TensorKernel::FloatToHalf(std::ldexp(1023.5f, -24)), 0x0400) << "Fail: TensorKernel::FloatToHalf() of a subnormal rounded to the smallest normal";
+    for (int i = 0; i < 65536; i++)
+    {
+        // Skip NaN
+        if ((i & 0x7C00) == 0x7C00 && (i & 0x03FF) != 0) continue;
+        ASSERT_EQ(TensorKernel::FloatToHalf(TensorKernel::HalfToFloat((unsigned short)i)), i) << "Fail: Round trip of the half precision " << i;
+    }
+
+    // Kernel
+    {
+        struct KernelCase
+        {
+            int Channels;
+            int BytesPerSample;
+            int BitDepth;
+            int NumOfPlanes;
+        };
+        const std::array<float, 3> mean = { 0.485f, 0.456f, 0.406f };
+        const std::array<float, 3> std = { 0.229f, 0.224f, 0.225f };
+        for (const auto& kernelCase : { KernelCase{ 3, 1, 8, 3 }, KernelCase{ 1, 1, 8, 3 }, KernelCase{ 1, 1, 8, 1 }, KernelCase{ 1, 2, 12, 1 }, KernelCase{ 1, 2, 12, 3 } })
+        {
+            for (const auto dataType : { TensorDataType::Float32, TensorDataType::Float16 })
+            {
+                const auto table = TensorKernel::BuildTable(kernelCase.Channels, kernelCase.BytesPerSample, kernelCase.BitDepth, kernelCase.NumOfPlanes, dataType, mean, std, 0.5f);
+                const int bytesPerElement = dataType == TensorDataType::Float16 ? 2 : 4;
+                for (const int numOfPixels : { 1, 15, 16, 17, 301 })
+                {
+                    auto input = CreateRandomImage(numOfPixels * kernelCase.Channels * kernelCase.BytesPerSample);
+                    if (kernelCase.BytesPerSample == 2)
+                    {
+                        auto samples = (unsigned short*)input.data();
+                        for (int i = 0; i < numOfPixels; i++) samples[i] &= 0x0FFF;
+                    }
+                    const auto name = "TensorKernel::ToPlanes() of " + std::to_string(kernelCase.Channels) + " channels of " + std::to_string(kernelCase.BitDepth) + " bits into " +
+                        std::to_string(kernelCase.NumOfPlanes) + " planes of " + (dataType == TensorDataType::Float16 ? "half" : "float") + ", " + std::to_string(numOfPixels) + " pixels";
+
+                    std::vector<unsigned char> expectedOutput(numOfPixels * kernelCase.NumOfPlanes * bytesPerElement);
+                    void* expectedPlanes[3] = {};
+                    for (int p = 0; p < kernelCase.NumOfPlanes; p++) expectedPlanes[p] = expectedOutput.data() + p * numOfPixels * bytesPerElement;
+                    TensorKernel::ToPlanes(input.data(), expectedPlanes, numOfPixels, table, SIMDLevel::Scalar);
+
+                    // Scalar
+                    TensorDestination destination;
+                    destination.Width = numOfPixels;
+                    destination.Height = 1;
+                    destination.Channels = kernelCase.NumOfPlanes;
+                    destination.Mean = mean;
+                    destination.Std = std;
+                    ExpectTensorNear(expectedOutput, dataType, ConvertTensorReference(input.data(), numOfPixels, 1, kernelCase.Channels, kernelCase.BitDepth, destination, 0, 0), name);
+
+                    for (const auto simdLevel : { SIMDLevel::SSSE3, SIMDLevel::AVX2 })
+                    {
+                        if (simdLevel > DirectShowCamera::SwizzleKernel::getSIMDLevel()) continue;
+                        std::vector<unsigned char> output(expectedOutput.size());
+                        void* planes[3] = {};
+                        for (int p = 0; p < kernelCase.NumOfPlanes; p++) planes[p] = output.data() + p * numOfPixels * bytesPerElement;
+                        TensorKernel::ToPlanes(input.data(), planes, numOfPixels, table, simdLevel);
+                        EXPECT_EQ(output, expectedOutput) << "Fail: " << name << " in SIMD level " << (int)simdLevel;
+                    }
+                }
+            }
+        }
+    }
+
+    // Region
+    {
+        struct RegionCase
+        {
+            int Width;
+            int Height;
+            int TensorWidth;
+            int TensorHeight;
+            bool Letterbox;
+            std::array<int, 4> Expected;
+        };
+        const std::vector<RegionCase> regionCases = {
+            { 640, 480, 320, 320, true, { 0, 40, 320, 240 } },
+            { 480, 640, 320, 320, true, { 40, 0, 240, 320 } },
+            { 1920, 1080, 640, 640, true, { 0, 140, 640, 360 } },
+            { 200, 100, 320, 320, true, { 60, 110, 200, 100 } },
+            { 640, 480, 320, 320, false, { 0, 0, 320, 320 } },
+            { 640, 100, 320, 320, false, { 0, 110, 320, 100 } }
+        };
+        for (const auto& regionCase : regionCases)
+        {
+            TensorDestination destination;
+            destination.Width = regionCase.TensorWidth;
+            destination.Height = regionCase.TensorHeight;
+            destination.Letterbox = regionCase.Letterbox;
+            std::array<int, 4> region = {};
+            FrameDecoder::getTensorRegion(regionCase.Width, regionCase.Height, destination, region[0], region[1], region[2], region[3]);
+            EXPECT_EQ(region, regionCase.Expected) << "Fail: FrameDecoder::getTensorRegion() of " << regionCase.Width << "x" << regionCase.Height << " in " << regionCase.TensorWidth << "x" <<
+                regionCase.TensorHeight << (regionCase.Letterbox ? " letterbox" : " stretched");
+        }
+    }
+
+    // Decode
+    const int width = 64;
+    const int height = 48;
+    struct VideoTypeCase
+    {
+        GUID VideoType;
+        int Channels;
+        int NumOfPlanes;
+    };
+    const std::vector<VideoTypeCase> videoTypeCases = {
+        { MEDIASUBTYPE_RGB24, 3, 3 },
+        { MEDIASUBTYPE_YUY2, 3, 3 },
+        { MEDIASUBTYPE_NV12, 3, 3 },
+        { MEDIASUBTYPE_Y800, 1, 3 },
+        { MEDIASUBTYPE_Y800, 1, 1 },
+        { MEDIASUBTYPE_Y16, 1, 1 },
+        { MEDIASUBTYPE_RGGB, 3, 3 },
+        { MEDIASUBTYPE_MJPG, 3, 3 }
+    };
+    struct TensorCase
+    {
+        int Width;
+        int Height;
+        bool Letterbox;
+        bool BGR;
+        TensorDataType DataType;
+    };
+    const std::vector<TensorCase> tensorCases = {
+        { 40, 40, true, false, TensorDataType::Float32 },
+        { 40, 40, true, true, TensorDataType::Float16 },
+        { 32, 20, false, false, TensorDataType::Float16 },
+        { 80, 60, true, false, TensorDataType::Float32 }
+    };
+    for (const auto& videoTypeCase : videoTypeCases)
+    {
+        const auto videoTypeName = DirectShowVideoFormatUtils::ToString(videoTypeCase.VideoType);
+
+        // The MJPG frame is stored in a buffer of 24 bits per pixel
+        auto frame = CreateRandomImage(width * height * 3);
+        if (videoTypeCase.VideoType == MEDIASUBTYPE_MJPG)
+        {
+            const auto jpeg = DirectShowCameraStubJPEGEncoder::Encode(CreateGradientImage(width, height).data(), width, height, false, 90, 0);
+            std::fill(frame.begin(), frame.end(), 0);
+            std::copy(jpeg.begin(), jpeg.end(), frame.begin());
+        }
+
+        for (const auto& tensorCase : tensorCases)
+        {
+            TensorDestination destination;
+            destination.Width = tensorCase.Width;
+            destination.Height = tensorCase.Height;
+            destination.Channels = videoTypeCase.NumOfPlanes;
+            destination.DataType = tensorCase.DataType;
+            destination.BGR = tensorCase.BGR;
+            destination.Mean = { 0.485f, 0.456f, 0.406f };
+            destination.Std = { 0.229f, 0.224f, 0.225f };
+            destination.Letterbox = tensorCase.Letterbox;
+            destination.PadValue = 114.0f / 255.0f;
+            const auto name = "FrameDecoder::DecodeFrameToTensor() of " + videoTypeName + " into " + std::to_string(videoTypeCase.NumOfPlanes) + " planes of " + std::to_string(tensorCase.Width) + "x" +
+                std::to_string(tensorCase.Height) + (tensorCase.Letterbox ? " letterbox" : " stretched") + (tensorCase.BGR ? " BGR" : " RGB") + (tensorCase.DataType == TensorDataType::Float16 ? " half" : " float");
+
+            // Reference, the frame is decoded in the size of the region
+            int x = 0;
+            int y = 0;
+            int regionWidth = 0;
+            int regionHeight = 0;
+            FrameDecoder::getTensorRegion(width, height, destination, x, y, regionWidth, regionHeight);
+            DirectShowCamera::FrameSettings frameSettings;
+            frameSettings.SourceBitDepth = videoTypeCase.VideoType == MEDIASUBTYPE_Y16 ? 12 : 0;
+            DirectShowCamera::FrameSettings referenceSettings = frameSettings;
+            referenceSettings.BGR = tensorCase.BGR;
+            if (regionWidth != width || regionHeight != height)
+            {
+                referenceSettings.ResizeWidth = regionWidth;
+                referenceSettings.ResizeHeight = regionHeight;
+            }
+            const int bitDepth = FrameDecoder::getBitDepth(videoTypeCase.VideoType, referenceSettings);
+            std::vector<unsigned char> decoded(regionWidth * regionHeight * videoTypeCase.Channels * (bitDepth > 8 ? 2 : 1));
+            FrameDecoder::DecodeFrame(frame.data(), decoded.data(), videoTypeCase.VideoType, width, height, referenceSettings);
+            const auto expected = ConvertTensorReference(decoded.data(), regionWidth, regionHeight, videoTypeCase.Channels, bitDepth, destination, x, y);
+
+            // The binning is replaced by the resize to the tensor
+            frameSettings.Binning = 2;
+            std::vector<unsigned char> tensor(destination.getNumOfBytes(), 0xFF);
+            destination.Data = tensor.data();
+            FrameDecoder::DecodeFrameToTensor(frame.data(), destination, videoTypeCase.VideoType, width, height, frameSettings);
+            ExpectTensorNear(tensor, tensorCase.DataType, expected, name);
+
+            // Parallel
+            std::vector<unsigned char> parallelTensor(tensor.size(), 0xFF);
+            destination.Data = parallelTensor.data();
+            FrameDecoder::setParallelDecodeMinFrameSize(0);
+            FrameDecoder::setNumOfDecodeThreads(4);
+            FrameDecoder::DecodeFrameToTensor(frame.data(), destination, videoTypeCase.VideoType, width, height, frameSettings);
+            FrameDecoder::setNumOfDecodeThreads(1);
+            FrameDecoder::setParallelDecodeMinFrameSize(1920 * 1080);
+            EXPECT_EQ(parallelTensor, tensor) << "Fail: " << name << " in 4 threads";
+        }
+    }
+
+    // Invalid
+    std::vector<float> tensor(3 * 40 * 40);
+    const auto frame = CreateRandomImage(width * height * 3);
+    TensorDestination destination;
+    destination.Width = 40;
+    destination.Height = 40;
+    EXPECT_THROW(FrameDecoder::DecodeFrameToTensor(frame.data(), destination, MEDIASUBTYPE_RGB24, width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrameToTensor() of nullptr";
+    destination.Data = tensor.data();
+    destination.Channels = 1;
+    EXPECT_THROW(FrameDecoder::DecodeFrameToTensor(frame.data(), destination, MEDIASUBTYPE_RGB24, width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrameToTensor() of a color frame into 1 plane";
+    destination.Channels = 2;
+    EXPECT_THROW(FrameDecoder::DecodeFrameToTensor(frame.data(), destination, MEDIASUBTYPE_Y800, width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrameToTensor() of 2 planes";
+    destination.Channels = 3;
+    destination.Std[1] = 0.0f;
+    EXPECT_THROW(FrameDecoder::DecodeFrameToTensor(frame.data(), destination, MEDIASUBTYPE_RGB24, width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrameToTensor() of a standard deviation of 0";
+    destination.Std[1] = 1.0f;
+    destination.Height = 0;
+    EXPECT_THROW(FrameDecoder::DecodeFrameToTensor(frame.data(), destination, MEDIASUBTYPE_RGB24, width, height), std::invalid_argument) << "Fail: FrameDecoder::DecodeFrameToTensor() of a tensor height of 0";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_decoder20
+ * <b>Title:</b> Test tensor of a full HD frame against separate passes
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Decode a 1920x1080 frame into a normalized float tensor in one call and by decoding, swapping, converting and splitting it in separate passes
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Decode RGB24 and YUY2 frames of 1920x1080 into a BGR image, swap it to RGB, normalize it into floats and split it into planes
+ *   2. Decode the same frames by FrameDecoder::DecodeFrameToTensor() into a 1920x1080 float tensor, a 640x640 letterbox float tensor and a 640x640 letterbox half precision tensor
+ * <b>Expected Result:</b>
+ *   1. No exception
+ *   2. No exception. The 1920x1080 tensor is the same as step 1 within the float rounding.
+ * </pre>
+ */
+TEST(TestFrameDecoder, TestTensorSeparatePasses)
+{
+    using DirectShowCamera::FrameDecoder;
+    using DirectShowCamera::TensorDataType;
+    using DirectShowCamera::TensorDestination;
+
+    const int width = 1920;
+    const int height = 1080;
+    const std::array<float, 3> mean = { 0.485f, 0.456f, 0.406f };
+    const std::array<float, 3> std = { 0.229f, 0.224f, 0.225f };
+
+    const auto frame = CreateRandomImage(width * height * 3);
+    for (const auto videoType : { MEDIASUBTYPE_RGB24, MEDIASUBTYPE_YUY2 })
+    {
+        const auto videoTypeName = DirectShowVideoFormatUtils::ToString(videoType);
+
+        // Separate passes
+        std::vector<unsigned char> bgr(width * height * 3);
+        std::vector<unsigned char> rgb(bgr.size());
+        std::vector<float> normalized(bgr.size());
+        std::vector<float> expectedTensor(bgr.size());
+        FrameDecoder::DecodeFrame(frame.data(), bgr.data(), videoType, width, height, DirectShowCamera::FrameSettings());
+        for (int j = 0; j < width * height; j++)
+        {
+            rgb[j * 3] = bgr[j * 3 + 2];
+            rgb[j * 3 + 1] = bgr[j * 3 + 1];
+            rgb[j * 3 + 2] = bgr[j * 3];
+        }
+        for (int j = 0; j < width * height * 3; j++)
+        {
+            normalized[j] = (rgb[j] / 255.0f - mean[j % 3]) / std[j % 3];
+        }
+        for (int j = 0; j < width * height; j++)
+        {
+            for (int c = 0; c < 3; c++) expectedTensor[c * width * height + j] = normalized[j * 3 + c];
+        }
+
+        struct TensorCase
+        {
+            int Width;
+            int Height;
+            TensorDataType DataType;
+        };
+        for (const auto& tensorCase : { TensorCase{ width, height, TensorDataType::Float32 }, TensorCase{ 640, 640, TensorDataType::Float32 }, TensorCase{ 640, 640, TensorDataType::Float16 } })
+        {
+            TensorDestination destination;
+            destination.Width = tensorCase.Width;
+            destination.Height = tensorCase.Height;
+            destination.DataType = tensorCase.DataType;
+            destination.Mean = mean;
+            destination.Std = std;
+            std::vector<unsigned char> tensor(destination.getNumOfBytes());
+            destination.Data = tensor.data();
+
+            FrameDecoder::DecodeFrameToTensor(frame.data(), destination, videoType, width, height);
+
+            if (tensorCase.Width == width && tensorCase.Height == height)
+            {
+                const auto elements = (const float*)tensor.data();
+                int numOfErrors = 0;
+                for (size_t i = 0; i < expectedTensor.size() && numOfErrors < 10; i++)
+                {
+                    if (std::abs(elements[i] - expectedTensor[i]) > 1e-5f * std::max(1.0f, std::abs(expectedTensor[i])))
+                    {
+                        ADD_FAILURE() << "Fail: " << videoTypeName << " tensor element " << i << " is " << elements[i] << ", expected " << expectedTensor[i];
+                        numOfErrors++;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,165 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include <gtest/gtest.h>
+
+#include "buffer/frame_pool.h"
+#include "camera/camera.h"
+#include "directshow_camera/stub/ds_camera_stub.h"
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_pool01
+ * <b>Title:</b> Test FramePool recycles buffers
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Acquire and release buffers from a FramePool
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Acquire 3 buffers and release them
+ *   2. Acquire a buffer again
+ *   3. Acquire a buffer in another size
+ *   4. Move a buffer into a shared storage, release it and move another buffer into a shared storage
+ *   5. Release the pool while a buffer is still held, then release the buffer
+ * <b>Expected Result:</b>
+ *   1. Buffers are aligned to FramePool::ALIGNMENT. 3 allocations. Only 2 buffers are kept as the pool keeps at most 2 buffers.
+ *   2. The buffer is reused. No allocation.
+ *   3. A new buffer is allocated. Free buffers in the old size are released.
+ *   4. The memory of the first storage is reused by the second storage. 1 shared allocation.
+ *   5. The buffer is still valid and freed safely.
+ * </pre>
+ */
+TEST(TestFramePool, TestRecycle)
+{
+    const int bufferSize = 1000;
+    auto framePool = std::make_shared<DirectShowCamera::FramePool>(2);
+
+    // Acquire
+    {
+        DirectShowCamera::FrameBuffer buffers[3] = {
+            framePool->Acquire(bufferSize),
+            framePool->Acquire(bufferSize),
+            framePool->Acquire(bufferSize)
+        };
+        for (const auto& buffer : buffers)
+        {
+            ASSERT_NE(buffer, nullptr) << "Fail: FramePool::Acquire()";
+            EXPECT_EQ((std::uintptr_t)buffer.get() % DirectShowCamera::FramePool::ALIGNMENT, 0) << "Fail: Buffer is not aligned";
+        }
+        EXPECT_EQ(framePool->getNumOfAllocations(), 3) << "Fail: FramePool::getNumOfAllocations()";
+    }
+    EXPECT_EQ(framePool->getNumOfFreeBuffers(), 2) << "Fail: FramePool::getNumOfFreeBuffers()";
+
+    // Reuse
+    {
+        auto buffer = framePool->Acquire(bufferSize);
+        EXPECT_EQ(framePool->getNumOfAllocations(), 3) << "Fail: Buffer is not reused";
+        EXPECT_EQ(framePool->getNumOfReuses(), 1) << "Fail: FramePool::getNumOfReuses()";
+        EXPECT_EQ(framePool->getNumOfFreeBuffers(), 1) << "Fail: FramePool::getNumOfFreeBuffers()";
+    }
+
+    // Another size
+    auto buffer = framePool->Acquire(bufferSize * 2);
+    EXPECT_EQ(framePool->getNumOfAllocations(), 4) << "Fail: FramePool::Acquire() in another size";
+    EXPECT_EQ(framePool->getBufferSize(), bufferSize * 2) << "Fail: FramePool::getBufferSize()";
+    EXPECT_EQ(framePool->getNumOfFreeBuffers(), 0) << "Fail: Free buffers in the old size are not released";
+
+    // Shared storage
+    for (int i = 0; i < 2; i++)
+    {
+        const auto storage = framePool->MakeShared(DirectShowCamera::FramePool::Allocate(bufferSize));
+        ASSERT_NE(storage, nullptr) << "Fail: FramePool::MakeShared()";
+        EXPECT_NE(storage->get(), nullptr) << "Fail: FramePool::MakeShared()";
+    }
+    EXPECT_EQ(framePool->getNumOfSharedAllocations(), 1) << "Fail: Shared storage is not reused";
+
+    // The buffer keeps the pool alive
+    std::weak_ptr<DirectShowCamera::FramePool> weakFramePool = framePool;
+    framePool.reset();
+    EXPECT_FALSE(weakFramePool.expired()) << "Fail: Pool is released before its buffer";
+    memset(buffer.get(), 1, bufferSize * 2);
+    buffer.reset();
+    EXPECT_TRUE(weakFramePool.expired()) << "Fail: Pool is not released";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame_pool02
+ * <b>Title:</b> Test getFrame() doesn't allocate in the steady state
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Count the buffers allocated by Camera::getFrame() on DirectShowCameraStub by the statistics of the frame pool and the frame buffer.
+ *   A new Frame is created and destroyed for every frame.
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Open camera and start capture
+ *   2. Warm up by getting 10 frames in FrameBufferMode::Mutex, FrameBufferMode::TripleBuffer and FrameBufferMode::Ring
+ *   3. Get 100 frames
+ * <b>Expected Result:</b>
+ *   1. True
+ *   3. All frames are got. No frame buffer or shared storage is allocated.
+ * </pre>
+ */
+TEST(TestFramePool, TestGetFrameAllocation)
+{
+    const int numOfFrames = 100;
+
+    // Open and start capture
+    const std::shared_ptr<DirectShowCamera::AbstractDirectShowCamera> stub = std::make_shared<DirectShowCamera::DirectShowCameraStub>();
+    DirectShowCamera::Camera camera = DirectShowCamera::Camera(stub);
+    std::vector<DirectShowCamera::CameraDevice> cameraDeivceList = camera.getCameras();
+    std::vector <std::pair<int, int>> resolutions = cameraDeivceList[0].getResolutions();
+    ASSERT_TRUE(camera.Open(cameraDeivceList[0], resolutions[0].first, resolutions[0].second)) << "Fail: camera.open()";
+
+    for (const auto mode : {
+        DirectShowCamera::FrameBufferMode::Mutex,
+        DirectShowCamera::FrameBufferMode::TripleBuffer,
+        DirectShowCamera::FrameBufferMode::Ring
+    })
+    {
+        camera.setFrameBufferMode(mode);
+        ASSERT_TRUE(camera.StartCapture()) << "Fail: camera.startCapture()";
+
+        // Warm up
+        for (int i = 0; i < 10; i++)
+        {
+            DirectShowCamera::Frame frame;
+            ASSERT_TRUE(camera.getFrame(frame)) << "Fail: camera.getFrame()";
+        }
+
+        // Steady state
+        const auto framePool = camera.getFramePool();
+        const unsigned long long numOfAllocations = framePool->getNumOfAllocations();
+        const unsigned long long numOfSharedAllocations = framePool->getNumOfSharedAllocations();
+        const unsigned long long numOfFrameBufferAllocations = camera.getFrameBufferStatistics().Allocations;
+        int numOfGotFrames = 0;
+        for (int i = 0; i < numOfFrames; i++)
+        {
+            DirectShowCamera::Frame frame;
+            if (camera.getFrame(frame)) numOfGotFrames++;
+        }
+
+        EXPECT_EQ(numOfGotFrames, numOfFrames) << "Fail: camera.getFrame() in mode " << (int)mode;
+        EXPECT_EQ(framePool->getNumOfAllocations(), numOfAllocations) << "Fail: camera.getFrame() allocates a buffer in mode " << (int)mode;
+        EXPECT_EQ(framePool->getNumOfSharedAllocations(), numOfSharedAllocations) << "Fail: camera.getFrame() allocates a shared storage in mode " << (int)mode;
+        EXPECT_EQ(camera.getFrameBufferStatistics().Allocations, numOfFrameBufferAllocations) << "Fail: The frame buffer allocates in mode " << (int)mode;
+
+        ASSERT_TRUE(camera.StopCapture()) << "Fail: camera.stopCapture()";
+    }
+
+    // Close
+    EXPECT_TRUE(camera.Close()) << "Fail: camera.close()";
+}
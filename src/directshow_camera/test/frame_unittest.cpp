@@ -0,0 +1,598 @@
+/**
+* Copy right (c) 2024 Ka Chun Wong. All rights reserved.
+* This is a open source project under MIT license (see LICENSE for details).
+* If you find any bugs, please feel free to report under https://github.com/kcwongjoe/directshow_camera/issues
+**/
+
+#include <gtest/gtest.h>
+
+#include "frame/frame.h"
+#include "directshow_camera/video_format/ds_guid.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame01
+ * <b>Title:</b> Test Frame copy-on-write
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Copy a frame and modify the frame data of the copy and the source
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Import a frame from a FramePool and copy it into a vector 10 times
+ *   2. Modify the copy through the non-const getFrameDataPtr()
+ *   3. Import a new frame into the source frame
+ *   4. Exchange a new frame into a shared frame
+ * <b>Expected Result:</b>
+ *   1. All copies share the same data pointer and are equal to the source. No buffer is taken from the pool.
+ *   2. The copy gets its own buffer. The source and the other copies are unchanged.
+ *   3. The copies still keep the old frame.
+ *   4. The shared data is not handed to the exchange function. The other copies are unchanged.
+ * </pre>
+ */
+TEST(TestFrame, TestCopyOnWrite)
+{
+    const int width = 4;
+    const int height = 2;
+    const int frameSize = width * height * 3;
+    auto framePool = std::make_shared<DirectShowCamera::FramePool>();
+
+    // Import
+    DirectShowCamera::Frame frame;
+    frame.ImportData(
+        frameSize,
+        width,
+        height,
+        MEDIASUBTYPE_RGB24,
+        DirectShowCamera::FrameSettings(),
+        [](unsigned char* data, unsigned long& frameIndex)
+        {
+            memset(data, 1, frameSize);
+            frameIndex = 1;
+        },
+        framePool
+    );
+    ASSERT_EQ(framePool->getNumOfAllocations(), 1) << "Fail: Frame::ImportData()";
+
+    // Copy
+    std::vector<DirectShowCamera::Frame> copiedFrames(10, frame);
+    int numOfBytes = 0;
+    const unsigned char* data = std::as_const(frame).getFrameDataPtr(numOfBytes);
+    for (const auto& copiedFrame : copiedFrames)
+    {
+        EXPECT_EQ(copiedFrame.getFrameDataPtr(numOfBytes), data) << "Fail: Frame data is copied";
+        EXPECT_EQ(copiedFrame, frame) << "Fail: Frame::operator==";
+    }
+    EXPECT_EQ(framePool->getNumOfAllocations() + framePool->getNumOfReuses(), 1) << "Fail: Frame copy takes a buffer";
+
+    // Modify the copy
+    unsigned char* modifiedData = copiedFrames[0].getFrameDataPtr(numOfBytes);
+    EXPECT_NE(modifiedData, data) << "Fail: Shared data is modified";
+    modifiedData[0] = 2;
+    EXPECT_EQ(std::as_const(frame).getFrameDataPtr(numOfBytes)[0], 1) << "Fail: Source frame is modified";
+    EXPECT_EQ(std::as_const(copiedFrames[1]).getFrameDataPtr(numOfBytes)[0], 1) << "Fail: Other copy is modified";
+    EXPECT_NE(copiedFrames[0], frame) << "Fail: Frame::operator!=";
+
+    // Import a new frame into the source
+    frame.ImportData(
+        frameSize,
+        width,
+        height,
+        MEDIASUBTYPE_RGB24,
+        DirectShowCamera::FrameSettings(),
+        [](unsigned char* data, unsigned long& frameIndex)
+        {
+            memset(data, 3, frameSize);
+            frameIndex = 2;
+        },
+        framePool
+    );
+    EXPECT_EQ(std::as_const(copiedFrames[1]).getFrameDataPtr(numOfBytes), data) << "Fail: Shared data is released";
+    EXPECT_EQ(std::as_const(copiedFrames[1]).getFrameDataPtr(numOfBytes)[0], 1) << "Fail: Shared data is overwritten";
+    EXPECT_EQ(copiedFrames[1].getFrameIndex(), 1) << "Fail: Copied frame is changed";
+
+    // Exchange a new frame into a shared frame
+    DirectShowCamera::Frame exchangedFrame = copiedFrames[1];
+    const bool success = exchangedFrame.ExchangeData(
+        frameSize,
+        width,
+        height,
+        MEDIASUBTYPE_RGB24,
+        DirectShowCamera::FrameSettings(),
+        [data](DirectShowCamera::FrameBuffer& buffer, int& numOfBytes, unsigned long& frameIndex, DirectShowCamera::FrameTimestamp& timestamp)
+        {
+            EXPECT_NE(buffer.get(), data) << "Fail: Shared data is handed to the exchange function";
+            buffer = DirectShowCamera::FramePool::Allocate(frameSize);
+            memset(buffer.get(), 4, frameSize);
+            numOfBytes = frameSize;
+            frameIndex = 3;
+            return true;
+        }
+    );
+    ASSERT_TRUE(success) << "Fail: Frame::ExchangeData()";
+    EXPECT_EQ(exchangedFrame.getFrameIndex(), 3) << "Fail: Frame::ExchangeData()";
+    EXPECT_EQ(std::as_const(copiedFrames[2]).getFrameDataPtr(numOfBytes), data) << "Fail: Shared data is released";
+    EXPECT_EQ(std::as_const(copiedFrames[2]).getFrameDataPtr(numOfBytes)[0], 1) << "Fail: Shared data is overwritten";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame02
+ * <b>Title:</b> Test Frame gray data
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Get the 8 bit gray data of YUY2, NV12, 8 bit monochrome and RGB24 frames
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Import a YUY2 frame and get the gray data with and without vertical flip
+ *   2. Import a NV12 frame and get the gray data
+ *   3. Import a Y800 frame and get the gray data
+ *   4. Import a RGB24 frame and get the gray data
+ * <b>Expected Result:</b>
+ *   1. The Y bytes. Rows are in the reversed order if vertical flip is enabled.
+ *   2. The Y plane
+ *   3. Same as Frame::getFrameData()
+ *   4. Throw std::runtime_error
+ * </pre>
+ */
+TEST(TestFrame, TestGrayFrameData)
+{
+    const int width = 4;
+    const int height = 2;
+
+    const auto importFrame = [](DirectShowCamera::Frame& frame, const std::vector<unsigned char>& data, const GUID frameType)
+    {
+        frame.ImportData(
+            (long)data.size(),
+            width,
+            height,
+            frameType,
+            DirectShowCamera::FrameSettings(),
+            [&data](unsigned char* frameData, unsigned long& frameIndex)
+            {
+                memcpy(frameData, data.data(), data.size());
+                frameIndex = 1;
+            }
+        );
+    };
+
+    // YUY2
+    DirectShowCamera::Frame frame;
+    importFrame(frame, { 10, 128, 11, 128, 12, 128, 13, 128, 20, 128, 21, 128, 22, 128, 23, 128 }, MEDIASUBTYPE_YUY2);
+    int numOfBytes = 0;
+    auto gray = frame.getGrayFrameData(numOfBytes);
+    ASSERT_EQ(numOfBytes, width * height) << "Fail: Frame::getGrayFrameData() size";
+    EXPECT_EQ(std::vector<unsigned char>(gray.get(), gray.get() + numOfBytes), std::vector<unsigned char>({ 10, 11, 12, 13, 20, 21, 22, 23 })) << "Fail: Frame::getGrayFrameData() with YUY2";
+
+    frame.getFrameSettings().VerticalFlip = true;
+    gray = frame.getGrayFrameData(numOfBytes);
+    EXPECT_EQ(std::vector<unsigned char>(gray.get(), gray.get() + numOfBytes), std::vector<unsigned char>({ 20, 21, 22, 23, 10, 11, 12, 13 })) << "Fail: Frame::getGrayFrameData() with vertical flip";
+
+    // NV12
+    importFrame(frame, { 1, 2, 3, 4, 5, 6, 7, 8, 128, 128, 128, 128 }, MEDIASUBTYPE_NV12);
+    gray = frame.getGrayFrameData(numOfBytes);
+    EXPECT_EQ(std::vector<unsigned char>(gray.get(), gray.get() + numOfBytes), std::vector<unsigned char>({ 1, 2, 3, 4, 5, 6, 7, 8 })) << "Fail: Frame::getGrayFrameData() with NV12";
+
+    // Y800
+    importFrame(frame, { 1, 2, 3, 4, 5, 6, 7, 8 }, MEDIASUBTYPE_Y800);
+    gray = frame.getGrayFrameData(numOfBytes);
+    int expectedNumOfBytes = 0;
+    const auto expected = frame.getFrameData(expectedNumOfBytes);
+    ASSERT_EQ(numOfBytes, expectedNumOfBytes) << "Fail: Frame::getGrayFrameData() size with Y800";
+    EXPECT_TRUE(std::equal(gray.get(), gray.get() + numOfBytes, expected.get())) << "Fail: Frame::getGrayFrameData() with Y800";
+
+    // RGB24
+    importFrame(frame, std::vector<unsigned char>(width * height * 3), MEDIASUBTYPE_RGB24);
+    EXPECT_THROW(frame.getGrayFrameData(numOfBytes), std::runtime_error) << "Fail: Frame::getGrayFrameData() with RGB24";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame03
+ * <b>Title:</b> Test Frame YUV 4:2:0 planes
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Get the planes of NV12 and I420 frames and decode the frames
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Import a NV12 frame and get the planes
+ *   2. Import an I420 frame and get the planes
+ *   3. Get the frame data of the I420 frame
+ *   4. Get the planes of a YUY2 frame
+ * <b>Expected Result:</b>
+ *   1. The planes point into the frame data. The U V plane follows the Y plane in the same stride.
+ *   2. The U and V planes follow the Y plane in half stride
+ *   3. Gray pixels in BGR24 as U and V are 128
+ *   4. Throw std::runtime_error
+ * </pre>
+ */
+TEST(TestFrame, TestYUV420Planes)
+{
+    const int width = 4;
+    const int height = 2;
+
+    const auto importFrame = [](DirectShowCamera::Frame& frame, const std::vector<unsigned char>& data, const GUID frameType)
+    {
+        frame.ImportData(
+            (long)data.size(),
+            width,
+            height,
+            frameType,
+            DirectShowCamera::FrameSettings(),
+            [&data](unsigned char* frameData, unsigned long& frameIndex)
+            {
+                memcpy(frameData, data.data(), data.size());
+                frameIndex = 1;
+            }
+        );
+    };
+
+    // NV12
+    DirectShowCamera::Frame frame;
+    importFrame(frame, { 16, 16, 16, 16, 235, 235, 235, 235, 128, 128, 128, 128 }, MEDIASUBTYPE_NV12);
+    int numOfBytes = 0;
+    const DirectShowCamera::Frame& constFrame = frame;
+    const unsigned char* data = constFrame.getFrameDataPtr(numOfBytes);
+    auto planes = constFrame.getYUV420Planes();
+    EXPECT_EQ(planes.Layout, DirectShowCamera::YUV420Layout::NV12) << "Fail: Frame::getYUV420Planes() layout with NV12";
+    EXPECT_EQ(planes.Y, data) << "Fail: Frame::getYUV420Planes() Y plane with NV12";
+    EXPECT_EQ(planes.U, data + width * height) << "Fail: Frame::getYUV420Planes() U V plane with NV12";
+    EXPECT_EQ(planes.YStride, width) << "Fail: Frame::getYUV420Planes() Y stride with NV12";
+    EXPECT_EQ(planes.UVStride, width) << "Fail: Frame::getYUV420Planes() U V stride with NV12";
+
+    // I420
+    importFrame(frame, { 16, 16, 16, 16, 235, 235, 235, 235, 128, 128, 128, 128 }, MEDIASUBTYPE_I420);
+    data = constFrame.getFrameDataPtr(numOfBytes);
+    planes = constFrame.getYUV420Planes();
+    EXPECT_EQ(planes.Layout, DirectShowCamera::YUV420Layout::I420) << "Fail: Frame::getYUV420Planes() layout with I420";
+    EXPECT_EQ(planes.U, data + width * height) << "Fail: Frame::getYUV420Planes() U plane with I420";
+    EXPECT_EQ(planes.V, data + width * height + width * height / 4) << "Fail: Frame::getYUV420Planes() V plane with I420";
+    EXPECT_EQ(planes.UVStride, width / 2) << "Fail: Frame::getYUV420Planes() U V stride with I420";
+
+    // Decode
+    const auto decoded = frame.getFrameData(numOfBytes);
+    ASSERT_EQ(numOfBytes, width * height * 3) << "Fail: Frame::getFrameData() size with I420";
+    EXPECT_EQ(std::vector<unsigned char>(decoded.get(), decoded.get() + numOfBytes), std::vector<unsigned char>({ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255 }))
+        << "Fail: Frame::getFrameData() with I420";
+
+    // YUY2
+    importFrame(frame, std::vector<unsigned char>(width * height * 2, 128), MEDIASUBTYPE_YUY2);
+    EXPECT_THROW(frame.getYUV420Planes(), std::runtime_error) << "Fail: Frame::getYUV420Planes() with YUY2";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame04
+ * <b>Title:</b> Test Frame bit depth
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Get the bit depth and the 16 bit data of a Y10P frame in the source bit depth and in 16 bits
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Get the bit depth of an empty frame
+ *   2. Import a Y10P frame, get the bit depth and the 16 bit data
+ *   3. Set FrameSettings::OutputBitDepth to 16, get the bit depth and the 16 bit data
+ *   4. Import a RGB24 frame and get the bit depth
+ * <b>Expected Result:</b>
+ *   1. 0
+ *   2. 10 and the unpacked samples
+ *   3. 16 and the samples scaled to 16 bits
+ *   4. 8
+ * </pre>
+ */
+TEST(TestFrame, TestBitDepth)
+{
+    const int width = 4;
+    const int height = 2;
+
+    const auto importFrame = [](DirectShowCamera::Frame& frame, const std::vector<unsigned char>& data, const GUID frameType)
+    {
+        frame.ImportData(
+            (long)data.size(),
+            width,
+            height,
+            frameType,
+            DirectShowCamera::FrameSettings(),
+            [&data](unsigned char* frameData, unsigned long& frameIndex)
+            {
+                memcpy(frameData, data.data(), data.size());
+                frameIndex = 1;
+            }
+        );
+    };
+
+    // Empty
+    DirectShowCamera::Frame frame;
+    EXPECT_EQ(frame.getBitDepth(), 0) << "Fail: Frame::getBitDepth() of an empty frame";
+
+    // Y10P, 2 rows of 1023, 0, 513 and 258
+    importFrame(frame, { 0xFF, 0x00, 0x80, 0x40, 0x93, 0xFF, 0x00, 0x80, 0x40, 0x93 }, MEDIASUBTYPE_Y10P);
+    EXPECT_EQ(frame.getBitDepth(), 10) << "Fail: Frame::getBitDepth() with Y10P";
+    int numOfBytes = 0;
+    auto data = frame.getFrame16bitData(numOfBytes);
+    ASSERT_EQ(numOfBytes, width * height * 2) << "Fail: Frame::getFrame16bitData() size with Y10P";
+    EXPECT_EQ(std::vector<unsigned short>(data.get(), data.get() + width * height), std::vector<unsigned short>({ 1023, 0, 513, 258, 1023, 0, 513, 258 }))
+        << "Fail: Frame::getFrame16bitData() with Y10P";
+
+    // Y10P in 16 bits
+    frame.getFrameSettings().OutputBitDepth = 16;
+    EXPECT_EQ(frame.getBitDepth(), 16) << "Fail: Frame::getBitDepth() with Y10P in 16 bits";
+    data = frame.getFrame16bitData(numOfBytes);
+    EXPECT_EQ(std::vector<unsigned short>(data.get(), data.get() + width * height), std::vector<unsigned short>({ 65535, 0, 32864, 16528, 65535, 0, 32864, 16528 }))
+        << "Fail: Frame::getFrame16bitData() with Y10P in 16 bits";
+
+    // RGB24
+    importFrame(frame, std::vector<unsigned char>(width * height * 3, 128), MEDIASUBTYPE_RGB24);
+    EXPECT_EQ(frame.getBitDepth(), 8) << "Fail: Frame::getBitDepth() with RGB24";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame05
+ * <b>Title:</b> Test Frame statistics
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Get the statistics of a frame accumulated while it is decoded
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Get the statistics of an empty frame and of a RGB24 frame in FrameStatisticsMode::None
+ *   2. Set FrameStatisticsMode::Full and get the statistics without decoding the frame
+ *   3. Decode the frame by getFrameData() and get the statistics, then copy the frame
+ *   4. Set a binning of 2 and get the statistics
+ *   5. Modify the frame through the non-const getFrameDataPtr() and get the statistics
+ * <b>Expected Result:</b>
+ *   1. nullptr
+ *   2. The statistics of the frame
+ *   3. The statistics of the decode are kept, the frame is not decoded again. The copy shares them.
+ *   4. The statistics of the binned frame
+ *   5. The statistics of the modified frame
+ * </pre>
+ */
+TEST(TestFrame, TestStatistics)
+{
+    const int width = 4;
+    const int height = 2;
+
+    // 4 x 2 BGR pixels, the red of the first 2 pixels of the bottom row is saturated
+    std::vector<unsigned char> data(width * height * 3, 10);
+    data[2] = 255;
+    data[5] = 255;
+
+    // Empty
+    DirectShowCamera::Frame frame;
+    EXPECT_EQ(frame.getStatistics(), nullptr) << "Fail: Frame::getStatistics() of an empty frame";
+
+    // None
+    frame.ImportData(
+        (long)data.size(),
+        width,
+        height,
+        MEDIASUBTYPE_RGB24,
+        DirectShowCamera::FrameSettings(),
+        [&data](unsigned char* frameData, unsigned long& frameIndex)
+        {
+            memcpy(frameData, data.data(), data.size());
+            frameIndex = 1;
+        }
+    );
+    EXPECT_EQ(frame.getStatistics(), nullptr) << "Fail: Frame::getStatistics() in FrameStatisticsMode::None";
+
+    // Not decoded
+    frame.getFrameSettings().Statistics = DirectShowCamera::FrameStatisticsMode::Full;
+    auto statistics = frame.getStatistics();
+    ASSERT_NE(statistics, nullptr) << "Fail: Frame::getStatistics() without decoding";
+    EXPECT_EQ(statistics->NumOfPixels, width * height) << "Fail: Frame::getStatistics() number of pixels";
+    EXPECT_EQ(statistics->NumOfSaturatedPixels, 2) << "Fail: Frame::getStatistics() number of saturated pixels";
+    EXPECT_EQ(statistics->Maxs[2], 255) << "Fail: Frame::getStatistics() maximum of red";
+    EXPECT_EQ(statistics->Histograms[0][10], (unsigned int)(width * height)) << "Fail: Frame::getStatistics() histogram of blue";
+    EXPECT_DOUBLE_EQ(statistics->Means[2], (10.0 * 6 + 255.0 * 2) / 8) << "Fail: Frame::getStatistics() mean of red";
+
+    // Decoded
+    int numOfBytes = 0;
+    frame.getFrameData(numOfBytes);
+    statistics = frame.getStatistics();
+    EXPECT_EQ(frame.getStatistics(), statistics) << "Fail: Frame::getStatistics() after Frame::getFrameData() is decoded again";
+    DirectShowCamera::Frame copiedFrame = frame;
+    EXPECT_EQ(copiedFrame.getStatistics(), statistics) << "Fail: Frame::getStatistics() of a copied frame";
+
+    // Binning, the 4 pixels of 2 x 2 blocks
+    frame.getFrameSettings().Binning = 2;
+    statistics = frame.getStatistics();
+    ASSERT_NE(statistics, nullptr) << "Fail: Frame::getStatistics() with a binning of 2";
+    EXPECT_EQ(statistics->NumOfPixels, 2) << "Fail: Frame::getStatistics() number of pixels with a binning of 2";
+    EXPECT_EQ(statistics->NumOfSaturatedPixels, 0) << "Fail: Frame::getStatistics() number of saturated pixels with a binning of 2";
+
+    // Modified
+    frame.getFrameSettings().Binning = 1;
+    frame.getFrameDataPtr(numOfBytes)[8] = 255;
+    statistics = frame.getStatistics();
+    EXPECT_EQ(statistics->NumOfSaturatedPixels, 3) << "Fail: Frame::getStatistics() of a modified frame";
+    EXPECT_EQ(copiedFrame.getStatistics()->NumOfSaturatedPixels, 2) << "Fail: Frame::getStatistics() of a copied frame after the source is modified";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame06
+ * <b>Title:</b> Test Frame tensor
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Decode a frame into the planes of a letterbox float tensor
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Decode a 4 x 2 RGB24 frame with a binning of 2 into a 4 x 4 tensor of R, G, B planes
+ *   2. Decode the frame into a tensor without data
+ * <b>Expected Result:</b>
+ *   1. The binning is ignored. The frame is in the middle 2 rows of each plane, normalized by the mean and the standard deviation. The top and bottom rows are padded.
+ *   2. Throw std::invalid_argument
+ * </pre>
+ */
+TEST(TestFrame, TestTensor)
+{
+    const int width = 4;
+    const int height = 2;
+
+    // 4 x 2 BGR pixels
+    std::vector<unsigned char> data(width * height * 3);
+    for (int i = 0; i < width * height; i++)
+    {
+        data[i * 3] = 10;
+        data[i * 3 + 1] = 20;
+        data[i * 3 + 2] = 30;
+    }
+
+    DirectShowCamera::Frame frame;
+    DirectShowCamera::FrameSettings frameSettings;
+    frameSettings.Binning = 2;
+    frame.ImportData(
+        (long)data.size(),
+        width,
+        height,
+        MEDIASUBTYPE_RGB24,
+        frameSettings,
+        [&data](unsigned char* frameData, unsigned long& frameIndex)
+        {
+            memcpy(frameData, data.data(), data.size());
+            frameIndex = 1;
+        }
+    );
+
+    // Letterbox
+    std::vector<float> tensor(3 * 4 * 4);
+    DirectShowCamera::TensorDestination destination;
+    destination.Data = tensor.data();
+    destination.Width = 4;
+    destination.Height = 4;
+    destination.Mean = { 0.5f, 0.4f, 0.3f };
+    destination.Std = { 0.25f, 0.5f, 1.0f };
+    frame.getTensor(destination);
+
+    const double samples[3] = { 30, 20, 10 };
+    for (int p = 0; p < 3; p++)
+    {
+        for (int y = 0; y < 4; y++)
+        {
+            const double sample = y == 0 || y == 3 ? 0.0 : samples[p] / 255.0;
+            const double expected = (sample - destination.Mean[p]) / destination.Std[p];
+            for (int x = 0; x < 4; x++)
+            {
+                EXPECT_NEAR(tensor[(p * 4 + y) * 4 + x], expected, 1e-5) << "Fail: Frame::getTensor() plane " << p << " at (" << x << ", " << y << ")";
+            }
+        }
+    }
+
+    // No data
+    destination.Data = nullptr;
+    EXPECT_THROW(frame.getTensor(destination), std::invalid_argument) << "Fail: Frame::getTensor() without data";
+}
+
+/**
+ * @brief
+ * <pre>
+ * <b>TestID:</b> frame07
+ * <b>Title:</b> Test copying a const Frame in multiple threads
+ * </pre>
+ *
+ * @details
+ * <pre>
+ * <b>Description:</b>
+ *   Copy the same const frame in multiple threads at the same time
+ * <b>Precondition:</b>
+ * <b>Assumption:</b>
+ * <b>Test Steps:</b>
+ *   1. Import a frame and copy the const frame 1000 times in each of 8 threads
+ *   2. Release the copies and modify the source through the non-const getFrameDataPtr()
+ * <b>Expected Result:</b>
+ *   1. Every copy shares the data pointer of the source and has the source pixels. The source is unchanged.
+ *   2. The data is not copied as no other frame shares it
+ * </pre>
+ */
+TEST(TestFrame, TestConcurrentCopy)
+{
+    const int width = 4;
+    const int height = 2;
+    const int frameSize = width * height * 3;
+    const int numOfThreads = 8;
+    const int numOfCopies = 1000;
+
+    DirectShowCamera::Frame frame;
+    frame.ImportData(
+        frameSize,
+        width,
+        height,
+        MEDIASUBTYPE_RGB24,
+        DirectShowCamera::FrameSettings(),
+        [](unsigned char* data, unsigned long& frameIndex)
+        {
+            memset(data, 1, frameSize);
+            frameIndex = 1;
+        }
+    );
+    const DirectShowCamera::Frame& constFrame = frame;
+    int numOfBytes = 0;
+    const unsigned char* data = constFrame.getFrameDataPtr(numOfBytes);
+
+    // Copy
+    std::vector<int> numOfErrors(numOfThreads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numOfThreads; t++)
+    {
+        threads.emplace_back(
+            [&constFrame, &numOfErrors, data, t]()
+            {
+                for (int i = 0; i < numOfCopies; i++)
+                {
+                    const DirectShowCamera::Frame copiedFrame = constFrame;
+                    int numOfCopiedBytes = 0;
+                    const unsigned char* copiedData = copiedFrame.getFrameDataPtr(numOfCopiedBytes);
+                    if (copiedData != data || numOfCopiedBytes != frameSize || copiedData[frameSize - 1] != 1 || copiedFrame.getFrameIndex() != 1) numOfErrors[t]++;
+                }
+            }
+        );
+    }
+    for (auto& thread : threads) thread.join();
+    for (int t = 0; t < numOfThreads; t++)
+    {
+        EXPECT_EQ(numOfErrors[t], 0) << "Fail: Copies of a const frame in thread " << t;
+    }
+    EXPECT_EQ(constFrame.getFrameDataPtr(numOfBytes), data) << "Fail: Source frame data is changed by the copies";
+    EXPECT_EQ(numOfBytes, frameSize) << "Fail: Source frame size is changed by the copies";
+
+    // Modify
+    EXPECT_EQ(frame.getFrameDataPtr(numOfBytes), data) << "Fail: Frame data is copied after the copies are released";
+}